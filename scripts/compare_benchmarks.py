@@ -0,0 +1,71 @@
+"""Compares two result files of the duckpgq benchmarks and reports the regressions.
+
+The result files are the tab separated output of the DuckDB benchmark runner (make duckpgq_benchmark), one line per
+run with the benchmark name, the run number and the timing in seconds.
+
+    python3 scripts/compare_benchmarks.py -b <baseline.tsv> -c <current.tsv> [-t <threshold>]
+
+Exits with 1 when the median timing of a benchmark grew by more than the threshold, 0.1 by default.
+"""
+import csv
+import getopt
+import statistics
+import sys
+
+
+def read_timings(fpath):
+    timings = {}
+    with open(fpath, newline='') as f:
+        for row in csv.reader(f, delimiter='\t'):
+            if len(row) < 3 or row[0] == 'name':
+                continue
+            try:
+                timing = float(row[2])
+            except ValueError:
+                # A failed or timed out run
+                continue
+            timings.setdefault(row[0], []).append(timing)
+    return {name: statistics.median(runs) for name, runs in timings.items()}
+
+
+def main(argv):
+    baseline = ''
+    current = ''
+    threshold = 0.1
+    opts, args = getopt.getopt(argv, "hb:c:t:", ["baseline=", "current=", "threshold="])
+    for opt, arg in opts:
+        if opt == '-h':
+            print('compare_benchmarks.py -b <baseline.tsv> -c <current.tsv> [-t <threshold>]')
+            sys.exit()
+        elif opt in ("-b", "--baseline"):
+            baseline = arg
+        elif opt in ("-c", "--current"):
+            current = arg
+        elif opt in ("-t", "--threshold"):
+            threshold = float(arg)
+    if not baseline or not current:
+        print('compare_benchmarks.py -b <baseline.tsv> -c <current.tsv> [-t <threshold>]')
+        sys.exit(2)
+
+    old = read_timings(baseline)
+    new = read_timings(current)
+    regressions = 0
+    print('{:<48} {:>10} {:>10} {:>8}'.format('benchmark', 'baseline', 'current', 'change'))
+    for name in sorted(set(old) | set(new)):
+        if name not in old or name not in new:
+            print('{:<48} {:>10} {:>10}'.format(name, '%.4f' % old[name] if name in old else '-',
+                                                '%.4f' % new[name] if name in new else '-'))
+            continue
+        change = new[name] / old[name] - 1 if old[name] > 0 else 0
+        flag = ''
+        if change > threshold:
+            flag = '  REGRESSION'
+            regressions += 1
+        print('{:<48} {:>10.4f} {:>10.4f} {:>+7.1%}{}'.format(name, old[name], new[name], change, flag))
+    if regressions > 0:
+        print('%d benchmark(s) regressed by more than %.0f%%' % (regressions, threshold * 100))
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
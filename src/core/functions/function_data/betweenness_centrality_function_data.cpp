@@ -0,0 +1,62 @@
+#include "duckpgq/core/functions/function_data/betweenness_centrality_function_data.hpp"
+
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+BetweennessCentralityFunctionData::BetweennessCentralityFunctionData(ClientContext &context, int32_t csr_id,
+                                                                     int64_t samples)
+    : context(context), csr_id(csr_id), samples(samples) {
+}
+
+// betweenness_centrality(csr_id, rowid[, samples])
+unique_ptr<FunctionData> BetweennessCentralityFunctionData::BetweennessCentralityBind(
+    ClientContext &context, ScalarFunction &bound_function, vector<unique_ptr<Expression>> &arguments) {
+	if (!arguments[0]->IsFoldable()) {
+		throw InvalidInputException("Id must be constant.");
+	}
+	int32_t csr_id = ExpressionExecutor::EvaluateScalar(context, *arguments[0]).GetValue<int32_t>();
+	auto duckpgq_state = GetDuckPGQState(context);
+	duckpgq_state->csr_to_delete.insert(csr_id);
+	duckpgq_state->MergeCSRDelta(context, csr_id);
+
+	int64_t samples = 0;
+	if (arguments.size() == 3) {
+		if (!arguments[2]->IsFoldable()) {
+			throw InvalidInputException("The number of betweenness centrality samples must be constant.");
+		}
+		auto samples_value = ExpressionExecutor::EvaluateScalar(context, *arguments[2]);
+		if (!samples_value.IsNull()) {
+			samples = samples_value.GetValue<int64_t>();
+			if (samples <= 0) {
+				throw InvalidInputException("betweenness_centrality samples must be positive, got %d", samples);
+			}
+		}
+	}
+	return make_uniq<BetweennessCentralityFunctionData>(context, csr_id, samples);
+}
+
+unique_ptr<FunctionData> BetweennessCentralityFunctionData::Copy() const {
+	auto result = make_uniq<BetweennessCentralityFunctionData>(context, csr_id, samples);
+	if (once.IsDone()) {
+		result->centrality = centrality;
+		result->once.MarkDone();
+	}
+	return std::move(result);
+}
+
+bool BetweennessCentralityFunctionData::Equals(const FunctionData &other_p) const {
+	auto &other = other_p.Cast<BetweennessCentralityFunctionData>();
+	if (csr_id != other.csr_id) {
+		return false;
+	}
+	if (samples != other.samples) {
+		return false;
+	}
+	if (once.IsDone() != other.once.IsDone()) {
+		return false;
+	}
+	return true;
+}
+
+} // namespace duckdb
@@ -4,10 +4,7 @@
 
 namespace duckdb {
 
-unique_ptr<FunctionData>
-CheapestPathLengthFunctionData::CheapestPathLengthBind(ClientContext &context, ScalarFunction &bound_function,
-                                                       vector<unique_ptr<Expression>> &arguments) {
-
+static int32_t BindWeightedCSR(ClientContext &context, vector<unique_ptr<Expression>> &arguments, CSR *&csr) {
 	if (!arguments[0]->IsFoldable()) {
 		throw InvalidInputException("Id must be constant.");
 	}
@@ -15,13 +12,20 @@ CheapestPathLengthFunctionData::CheapestPathLengthBind(ClientContext &context, S
 	auto duckpgq_state = GetDuckPGQState(context);
 
 	int32_t csr_id = ExpressionExecutor::EvaluateScalar(context, *arguments[0]).GetValue<int32_t>();
-	CSR *csr = duckpgq_state->GetCSR(csr_id);
+	csr = duckpgq_state->GetCSR(csr_id);
 	duckpgq_state->csr_to_delete.insert(csr_id);
 
 	if (!(csr->initialized_v && csr->initialized_e && csr->initialized_w)) {
 		throw ConstraintException("Need to initialize CSR before doing cheapest path");
 	}
+	return csr_id;
+}
 
+unique_ptr<FunctionData>
+CheapestPathLengthFunctionData::CheapestPathLengthBind(ClientContext &context, ScalarFunction &bound_function,
+                                                       vector<unique_ptr<Expression>> &arguments) {
+	CSR *csr;
+	auto csr_id = BindWeightedCSR(context, arguments, csr);
 	if (csr->w.empty()) {
 		bound_function.return_type = LogicalType::DOUBLE;
 	} else {
@@ -31,6 +35,14 @@ CheapestPathLengthFunctionData::CheapestPathLengthBind(ClientContext &context, S
 	return make_uniq<CheapestPathLengthFunctionData>(context, csr_id);
 }
 
+unique_ptr<FunctionData> CheapestPathLengthFunctionData::CheapestPathBind(ClientContext &context,
+                                                                         ScalarFunction &bound_function,
+                                                                         vector<unique_ptr<Expression>> &arguments) {
+	CSR *csr;
+	auto csr_id = BindWeightedCSR(context, arguments, csr);
+	return make_uniq<CheapestPathLengthFunctionData>(context, csr_id);
+}
+
 unique_ptr<FunctionData> CheapestPathLengthFunctionData::Copy() const {
 	return make_uniq<CheapestPathLengthFunctionData>(context, csr_id);
 }
@@ -0,0 +1,72 @@
+#include "duckpgq/core/functions/function_data/community_detection_function_data.hpp"
+
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+CommunityDetectionFunctionData::CommunityDetectionFunctionData(ClientContext &context, int32_t csr_id,
+                                                               int64_t max_iterations, double_t resolution)
+    : context(context), csr_id(csr_id), max_iterations(max_iterations), resolution(resolution) {
+}
+
+unique_ptr<FunctionData>
+CommunityDetectionFunctionData::CommunityDetectionBind(ClientContext &context, ScalarFunction &bound_function,
+                                                       vector<unique_ptr<Expression>> &arguments) {
+	if (!arguments[0]->IsFoldable()) {
+		throw InvalidInputException("Id must be constant.");
+	}
+	for (idx_t i = 2; i < arguments.size(); i++) {
+		if (!arguments[i]->IsFoldable()) {
+			throw InvalidInputException("The %s parameters must be constant.", bound_function.name);
+		}
+	}
+	int32_t csr_id = ExpressionExecutor::EvaluateScalar(context, *arguments[0]).GetValue<int32_t>();
+	auto duckpgq_state = GetDuckPGQState(context);
+	duckpgq_state->csr_to_delete.insert(csr_id);
+	duckpgq_state->MergeCSRDelta(context, csr_id);
+
+	auto max_iterations = DEFAULT_MAX_ITERATIONS;
+	auto resolution = DEFAULT_RESOLUTION;
+	if (bound_function.name == "louvain" && arguments.size() == 4) {
+		resolution = ExpressionExecutor::EvaluateScalar(context, *arguments[2]).GetValue<double_t>();
+		max_iterations = ExpressionExecutor::EvaluateScalar(context, *arguments[3]).GetValue<int64_t>();
+	} else if (arguments.size() == 3) {
+		max_iterations = ExpressionExecutor::EvaluateScalar(context, *arguments[2]).GetValue<int64_t>();
+	}
+	if (max_iterations <= 0) {
+		throw InvalidInputException("%s max_iterations must be positive, got %d", bound_function.name,
+		                            max_iterations);
+	}
+	if (resolution <= 0) {
+		throw InvalidInputException("louvain resolution must be positive, got %f", resolution);
+	}
+	return make_uniq<CommunityDetectionFunctionData>(context, csr_id, max_iterations, resolution);
+}
+
+unique_ptr<FunctionData> CommunityDetectionFunctionData::Copy() const {
+	auto result = make_uniq<CommunityDetectionFunctionData>(context, csr_id, max_iterations, resolution);
+	if (once.IsDone()) {
+		result->community = community;
+		result->once.MarkDone();
+	}
+	return std::move(result);
+}
+
+bool CommunityDetectionFunctionData::Equals(const FunctionData &other_p) const {
+	auto &other = other_p.Cast<CommunityDetectionFunctionData>();
+	if (csr_id != other.csr_id) {
+		return false;
+	}
+	if (max_iterations != other.max_iterations) {
+		return false;
+	}
+	if (resolution != other.resolution) {
+		return false;
+	}
+	if (once.IsDone() != other.once.IsDone()) {
+		return false;
+	}
+	return true;
+}
+
+} // namespace duckdb
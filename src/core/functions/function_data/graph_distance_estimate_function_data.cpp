@@ -0,0 +1,38 @@
+#include "duckpgq/core/functions/function_data/graph_distance_estimate_function_data.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+unique_ptr<FunctionData> GraphDistanceEstimateFunctionData::Copy() const {
+	return make_uniq<GraphDistanceEstimateFunctionData>(context, pg_name, edge_label, directed);
+}
+
+bool GraphDistanceEstimateFunctionData::Equals(const FunctionData &other_p) const {
+	auto &other = other_p.Cast<GraphDistanceEstimateFunctionData>();
+	return other.pg_name == pg_name && other.edge_label == edge_label && other.directed == directed;
+}
+
+unique_ptr<FunctionData>
+GraphDistanceEstimateFunctionData::GraphDistanceEstimateBind(ClientContext &context, ScalarFunction &bound_function,
+                                                             vector<unique_ptr<Expression>> &arguments) {
+	if (!arguments[0]->IsFoldable() || !arguments[1]->IsFoldable() ||
+	    (arguments.size() > 4 && !arguments[4]->IsFoldable())) {
+		throw InvalidInputException("The property graph, edge label and direction of graph_distance_estimate must be "
+		                            "constant");
+	}
+	auto pg_name = StringUtil::Lower(ExpressionExecutor::EvaluateScalar(context, *arguments[0]).GetValue<string>());
+	auto edge_label = StringUtil::Lower(ExpressionExecutor::EvaluateScalar(context, *arguments[1]).GetValue<string>());
+	auto directed = arguments.size() < 5 || ExpressionExecutor::EvaluateScalar(context, *arguments[4]).GetValue<bool>();
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
+	auto edge_pg_entry = pg_info->GetTableByLabel(edge_label, true, false);
+	if (edge_pg_entry->is_vertex_table) {
+		throw Exception(ExceptionType::INVALID, edge_label + " is a vertex table, expected an edge table");
+	}
+	return make_uniq<GraphDistanceEstimateFunctionData>(context, pg_name, edge_pg_entry->main_label, directed);
+}
+
+} // namespace duckdb
@@ -15,9 +15,10 @@ bool IterativeLengthFunctionData::Equals(const FunctionData &other_p) const {
 	return other.csr_id == csr_id;
 }
 
-unique_ptr<FunctionData> IterativeLengthFunctionData::IterativeLengthBind(ClientContext &context,
-                                                                          ScalarFunction &bound_function,
-                                                                          vector<unique_ptr<Expression>> &arguments) {
+//! Registers [arguments]'s CSR for deletion at the end of the query. Binding runs before any kernel executes, so the
+//! delta of an incrementally refreshed CSR is merged here for the kernels that do not read through it.
+static unique_ptr<FunctionData> BindCSR(ClientContext &context, vector<unique_ptr<Expression>> &arguments,
+                                        bool merge_delta) {
 	if (!arguments[0]->IsFoldable()) {
 		throw InvalidInputException("Id must be constant.");
 	}
@@ -25,8 +26,23 @@ unique_ptr<FunctionData> IterativeLengthFunctionData::IterativeLengthBind(Client
 	int32_t csr_id = ExpressionExecutor::EvaluateScalar(context, *arguments[0]).GetValue<int32_t>();
 	auto duckpgq_state = GetDuckPGQState(context);
 	duckpgq_state->csr_to_delete.insert(csr_id);
+	if (merge_delta) {
+		duckpgq_state->MergeCSRDelta(context, csr_id);
+	}
 
 	return make_uniq<IterativeLengthFunctionData>(context, csr_id);
 }
 
+unique_ptr<FunctionData> IterativeLengthFunctionData::IterativeLengthBind(ClientContext &context,
+                                                                          ScalarFunction &bound_function,
+                                                                          vector<unique_ptr<Expression>> &arguments) {
+	return BindCSR(context, arguments, true);
+}
+
+unique_ptr<FunctionData> IterativeLengthFunctionData::DeltaAwareBind(ClientContext &context,
+                                                                     ScalarFunction &bound_function,
+                                                                     vector<unique_ptr<Expression>> &arguments) {
+	return BindCSR(context, arguments, false);
+}
+
 } // namespace duckdb
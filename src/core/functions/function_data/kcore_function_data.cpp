@@ -0,0 +1,41 @@
+#include "duckpgq/core/functions/function_data/kcore_function_data.hpp"
+
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+KCoreFunctionData::KCoreFunctionData(ClientContext &context, int32_t csr_id) : context(context), csr_id(csr_id) {
+}
+
+unique_ptr<FunctionData> KCoreFunctionData::KCoreBind(ClientContext &context, ScalarFunction &bound_function,
+                                                      vector<unique_ptr<Expression>> &arguments) {
+	if (!arguments[0]->IsFoldable()) {
+		throw InvalidInputException("Id must be constant.");
+	}
+	int32_t csr_id = ExpressionExecutor::EvaluateScalar(context, *arguments[0]).GetValue<int32_t>();
+	auto duckpgq_state = GetDuckPGQState(context);
+	duckpgq_state->csr_to_delete.insert(csr_id);
+	return make_uniq<KCoreFunctionData>(context, csr_id);
+}
+
+unique_ptr<FunctionData> KCoreFunctionData::Copy() const {
+	auto result = make_uniq<KCoreFunctionData>(context, csr_id);
+	if (once.IsDone()) {
+		result->core = core;
+		result->once.MarkDone();
+	}
+	return std::move(result);
+}
+
+bool KCoreFunctionData::Equals(const FunctionData &other_p) const {
+	auto &other = other_p.Cast<KCoreFunctionData>();
+	if (csr_id != other.csr_id) {
+		return false;
+	}
+	if (once.IsDone() != other.once.IsDone()) {
+		return false;
+	}
+	return true;
+}
+
+} // namespace duckdb
@@ -5,9 +5,11 @@
 namespace duckdb {
 
 // Constructor
-PageRankFunctionData::PageRankFunctionData(ClientContext &ctx, int32_t csr)
-    : context(ctx), csr_id(csr), damping_factor(0.85), convergence_threshold(1e-6), iteration_count(0),
-      state_initialized(false), converged(false) {
+PageRankFunctionData::PageRankFunctionData(ClientContext &ctx, int32_t csr, double_t damping, double_t threshold,
+                                           int64_t iterations, string key)
+    : context(ctx), csr_id(csr), damping_factor(damping), convergence_threshold(threshold),
+      max_iterations(iterations), warm_start_key(std::move(key)), iteration_count(0), state_initialized(false),
+      converged(false) {
 }
 
 unique_ptr<FunctionData> PageRankFunctionData::PageRankBind(ClientContext &context, ScalarFunction &bound_function,
@@ -19,21 +21,81 @@ unique_ptr<FunctionData> PageRankFunctionData::PageRankBind(ClientContext &conte
 	int32_t csr_id = ExpressionExecutor::EvaluateScalar(context, *arguments[0]).GetValue<int32_t>();
 	auto duckpgq_state = GetDuckPGQState(context);
 	duckpgq_state->csr_to_delete.insert(csr_id);
+	duckpgq_state->MergeCSRDelta(context, csr_id);
 
-	return make_uniq<PageRankFunctionData>(context, csr_id);
+	if (arguments.size() == 2) {
+		return make_uniq<PageRankFunctionData>(context, csr_id);
+	}
+	for (idx_t i = 2; i < arguments.size(); i++) {
+		if (!arguments[i]->IsFoldable()) {
+			throw InvalidInputException("The PageRank parameters must be constant.");
+		}
+	}
+	auto damping_factor = ExpressionExecutor::EvaluateScalar(context, *arguments[2]).GetValue<double_t>();
+	auto convergence_threshold = ExpressionExecutor::EvaluateScalar(context, *arguments[3]).GetValue<double_t>();
+	auto max_iterations = ExpressionExecutor::EvaluateScalar(context, *arguments[4]).GetValue<int64_t>();
+	auto warm_start_key = ExpressionExecutor::EvaluateScalar(context, *arguments[5]).GetValue<string>();
+	if (damping_factor < 0 || damping_factor >= 1) {
+		throw InvalidInputException("PageRank damping must be in [0, 1), got %f", damping_factor);
+	}
+	if (convergence_threshold <= 0) {
+		throw InvalidInputException("PageRank tolerance must be positive, got %f", convergence_threshold);
+	}
+	if (max_iterations <= 0) {
+		throw InvalidInputException("PageRank max_iterations must be positive, got %d", max_iterations);
+	}
+	return make_uniq<PageRankFunctionData>(context, csr_id, damping_factor, convergence_threshold, max_iterations,
+	                                       warm_start_key);
+}
+
+// personalized_pagerank(csr_id, seed, k, damping, tolerance)
+unique_ptr<FunctionData> PageRankFunctionData::PersonalizedPageRankBind(ClientContext &context,
+                                                                        ScalarFunction &bound_function,
+                                                                        vector<unique_ptr<Expression>> &arguments) {
+	if (!arguments[0]->IsFoldable()) {
+		throw InvalidInputException("Id must be constant.");
+	}
+	for (idx_t i = 2; i < arguments.size(); i++) {
+		if (!arguments[i]->IsFoldable()) {
+			throw InvalidInputException("The personalized PageRank parameters must be constant.");
+		}
+	}
+	int32_t csr_id = ExpressionExecutor::EvaluateScalar(context, *arguments[0]).GetValue<int32_t>();
+	auto duckpgq_state = GetDuckPGQState(context);
+	duckpgq_state->csr_to_delete.insert(csr_id);
+	duckpgq_state->MergeCSRDelta(context, csr_id);
+
+	auto top_k = ExpressionExecutor::EvaluateScalar(context, *arguments[2]).GetValue<int64_t>();
+	auto damping_factor = ExpressionExecutor::EvaluateScalar(context, *arguments[3]).GetValue<double_t>();
+	auto convergence_threshold = ExpressionExecutor::EvaluateScalar(context, *arguments[4]).GetValue<double_t>();
+	if (top_k <= 0) {
+		throw InvalidInputException("personalized_pagerank k must be positive, got %d", top_k);
+	}
+	if (damping_factor < 0 || damping_factor >= 1) {
+		throw InvalidInputException("PageRank damping must be in [0, 1), got %f", damping_factor);
+	}
+	if (convergence_threshold <= 0) {
+		throw InvalidInputException("PageRank tolerance must be positive, got %f", convergence_threshold);
+	}
+	auto result = make_uniq<PageRankFunctionData>(context, csr_id, damping_factor, convergence_threshold);
+	result->top_k = top_k;
+	return std::move(result);
 }
 
 // Copy method
 unique_ptr<FunctionData> PageRankFunctionData::Copy() const {
-	auto result = make_uniq<PageRankFunctionData>(context, csr_id);
+	auto result =
+	    make_uniq<PageRankFunctionData>(context, csr_id, damping_factor, convergence_threshold, max_iterations,
+	                                    warm_start_key);
 	result->rank = rank;           // Deep copy of rank vector
 	result->temp_rank = temp_rank; // Deep copy of temp_rank vector
-	result->damping_factor = damping_factor;
-	result->convergence_threshold = convergence_threshold;
+	result->top_k = top_k;
 	result->iteration_count = iteration_count;
 	result->state_initialized = state_initialized;
 	result->converged = converged;
-	// Note: state_lock is not copied as mutexes are not copyable
+	if (once.IsDone()) {
+		result->once.MarkDone();
+	}
 	return std::move(result);
 }
 
@@ -55,6 +117,15 @@ bool PageRankFunctionData::Equals(const FunctionData &other_p) const {
 	if (convergence_threshold != other.convergence_threshold) {
 		return false;
 	}
+	if (max_iterations != other.max_iterations) {
+		return false;
+	}
+	if (warm_start_key != other.warm_start_key) {
+		return false;
+	}
+	if (top_k != other.top_k) {
+		return false;
+	}
 	if (iteration_count != other.iteration_count) {
 		return false;
 	}
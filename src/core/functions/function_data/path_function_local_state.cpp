@@ -0,0 +1,129 @@
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+#include "duckdb/execution/expression_executor_state.hpp"
+
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+void EdgeFilter::Initialize(Vector &edges, idx_t count) {
+	initialized = true;
+	UnifiedVectorFormat list_data;
+	edges.ToUnifiedFormat(count, list_data);
+	auto list_index = list_data.sel->get_index(0);
+	if (!list_data.validity.RowIsValid(list_index)) {
+		return;
+	}
+	auto &entry = UnifiedVectorFormat::GetData<list_entry_t>(list_data)[list_index];
+	UnifiedVectorFormat id_data;
+	ListVector::GetEntry(edges).ToUnifiedFormat(ListVector::GetListSize(edges), id_data);
+	auto ids = UnifiedVectorFormat::GetData<int64_t>(id_data);
+	int64_t max_id = -1;
+	for (auto i = entry.offset; i < entry.offset + entry.length; i++) {
+		auto id_index = id_data.sel->get_index(i);
+		if (id_data.validity.RowIsValid(id_index)) {
+			max_id = MaxValue<int64_t>(max_id, ids[id_index]);
+		}
+	}
+	size = static_cast<idx_t>(max_id + 1);
+	bitmap = make_uniq<DuckPGQBitmap>(size);
+	for (auto i = entry.offset; i < entry.offset + entry.length; i++) {
+		auto id_index = id_data.sel->get_index(i);
+		if (id_data.validity.RowIsValid(id_index) && ids[id_index] >= 0) {
+			bitmap->set(static_cast<idx_t>(ids[id_index]));
+		}
+	}
+}
+
+void EdgeFilter::InitializeLabels(Vector &mask, idx_t count, const CSR &csr) {
+	initialized = true;
+	UnifiedVectorFormat mask_data;
+	mask.ToUnifiedFormat(count, mask_data);
+	auto mask_index = mask_data.sel->get_index(0);
+	if (!mask_data.validity.RowIsValid(mask_index)) {
+		throw InvalidInputException("The label mask of a path-finding function cannot be NULL");
+	}
+	label_mask = UnifiedVectorFormat::GetData<uint64_t>(mask_data)[mask_index];
+	// An empty label set falls through to the empty rowid bitmap, which lets no edge pass
+	labels = csr.IsLabeled() ? csr.edge_labels.data() : nullptr;
+}
+
+void EdgeFilter::InitializeAsOf(Vector &as_of_vector, idx_t count, const CSR &csr) {
+	initialized = true;
+	temporal_index = csr.GetTemporalIndex();
+	if (!temporal_index) {
+		throw InvalidInputException("No temporal index found for the CSR, build it first with PRAGMA "
+		                            "create_temporal_index");
+	}
+	auto timestamp = as_of_vector.GetType().id() == LogicalTypeId::TIMESTAMP;
+	if (timestamp != temporal_index->IsTimestamp()) {
+		throw InvalidInputException("The as-of argument has to be a %s to compare it to the validity intervals",
+		                            temporal_index->IsTimestamp() ? "TIMESTAMP" : "BIGINT");
+	}
+	UnifiedVectorFormat as_of_data;
+	as_of_vector.ToUnifiedFormat(count, as_of_data);
+	auto as_of_index = as_of_data.sel->get_index(0);
+	if (!as_of_data.validity.RowIsValid(as_of_index)) {
+		throw InvalidInputException("The as-of argument of a path-finding function cannot be NULL");
+	}
+	as_of = timestamp ? UnifiedVectorFormat::GetData<timestamp_t>(as_of_data)[as_of_index].value
+	                  : UnifiedVectorFormat::GetData<int64_t>(as_of_data)[as_of_index];
+}
+
+void EdgeFilter::InitializeArgument(Vector &argument, idx_t count, const CSR &csr) {
+	switch (argument.GetType().id()) {
+	case LogicalTypeId::UBIGINT:
+		InitializeLabels(argument, count, csr);
+		break;
+	case LogicalTypeId::TIMESTAMP:
+	case LogicalTypeId::BIGINT:
+		InitializeAsOf(argument, count, csr);
+		break;
+	default:
+		Initialize(argument, count);
+		break;
+	}
+}
+
+unique_ptr<FunctionLocalState> PathFunctionLocalState::Init(ExpressionState &state, const BoundFunctionExpression &expr,
+                                                            FunctionData *bind_data) {
+	return make_uniq<PathFunctionLocalState>();
+}
+
+PathFunctionLocalState &PathFunctionLocalState::Get(ExpressionState &state) {
+	return ExecuteFunctionState::GetFunctionState(state)->Cast<PathFunctionLocalState>();
+}
+
+CSR &PathFunctionLocalState::Bind(ClientContext &context, int32_t csr_id, bool load_partitions) {
+	if (csr) {
+		return *csr;
+	}
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto csr_entry = duckpgq_state->csr_list.find(csr_id);
+	if (csr_entry == duckpgq_state->csr_list.end()) {
+		throw ConstraintException("CSR not found with ID %d", csr_id);
+	}
+	if (!csr_entry->second->initialized_v) {
+		throw ConstraintException("Need to initialize CSR before doing path-finding");
+	}
+	v_size = static_cast<int64_t>(csr_entry->second->VertexCount());
+	if (load_partitions) {
+		csr_entry->second->LoadPartitions(context);
+	}
+	duckpgq_state->csr_to_delete.insert(csr_id);
+	metrics = TraversalMetrics::Get(context);
+	// Holding a reference keeps the CSR alive for the rest of the query without looking it up again
+	csr = csr_entry->second;
+	return *csr;
+}
+
+const EdgeFilter *PathFunctionLocalState::GetEdgeFilter(DataChunk &args, idx_t column, const CSR &csr) {
+	if (args.ColumnCount() <= column) {
+		return nullptr;
+	}
+	if (!edge_filter.IsInitialized()) {
+		edge_filter.InitializeArgument(args.data[column], args.size(), csr);
+	}
+	return &edge_filter;
+}
+
+} // namespace duckdb
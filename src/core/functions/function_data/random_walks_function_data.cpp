@@ -0,0 +1,81 @@
+#include "duckpgq/core/functions/function_data/random_walks_function_data.hpp"
+
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+RandomWalksFunctionData::RandomWalksFunctionData(ClientContext &context, int32_t csr_id, idx_t walks_per_node,
+                                                 RandomWalkParameters parameters, uint64_t seed)
+    : context(context), csr_id(csr_id), walks_per_node(walks_per_node), parameters(parameters), seed(seed) {
+}
+
+unique_ptr<FunctionData> RandomWalksFunctionData::RandomWalksBind(ClientContext &context,
+                                                                  ScalarFunction &bound_function,
+                                                                  vector<unique_ptr<Expression>> &arguments) {
+	if (!arguments[0]->IsFoldable()) {
+		throw InvalidInputException("Id must be constant.");
+	}
+	for (idx_t i = 2; i < arguments.size(); i++) {
+		if (!arguments[i]->IsFoldable()) {
+			throw InvalidInputException("The random_walks parameters must be constant.");
+		}
+	}
+	int32_t csr_id = ExpressionExecutor::EvaluateScalar(context, *arguments[0]).GetValue<int32_t>();
+	auto duckpgq_state = GetDuckPGQState(context);
+	duckpgq_state->csr_to_delete.insert(csr_id);
+	duckpgq_state->MergeCSRDelta(context, csr_id);
+
+	auto walk_length = ExpressionExecutor::EvaluateScalar(context, *arguments[2]).GetValue<int64_t>();
+	auto walks_per_node = ExpressionExecutor::EvaluateScalar(context, *arguments[3]).GetValue<int64_t>();
+	if (walk_length <= 0) {
+		throw InvalidInputException("random_walks walk_length must be positive, got %d", walk_length);
+	}
+	if (walks_per_node <= 0) {
+		throw InvalidInputException("random_walks walks_per_node must be positive, got %d", walks_per_node);
+	}
+	RandomWalkParameters parameters {static_cast<idx_t>(walk_length), 1, 1};
+	if (arguments.size() > 4) {
+		parameters.p = ExpressionExecutor::EvaluateScalar(context, *arguments[4]).GetValue<double_t>();
+		parameters.q = ExpressionExecutor::EvaluateScalar(context, *arguments[5]).GetValue<double_t>();
+	}
+	if (parameters.p <= 0 || parameters.q <= 0) {
+		throw InvalidInputException("random_walks p and q must be positive, got %f and %f", parameters.p,
+		                            parameters.q);
+	}
+	uint64_t seed = 0;
+	if (arguments.size() > 6) {
+		seed = ExpressionExecutor::EvaluateScalar(context, *arguments[6]).GetValue<int64_t>();
+	}
+	return make_uniq<RandomWalksFunctionData>(context, csr_id, static_cast<idx_t>(walks_per_node), parameters, seed);
+}
+
+unique_ptr<FunctionData> RandomWalksFunctionData::Copy() const {
+	auto result = make_uniq<RandomWalksFunctionData>(context, csr_id, walks_per_node, parameters, seed);
+	if (once.IsDone()) {
+		result->alias_tables = alias_tables;
+		result->once.MarkDone();
+	}
+	return std::move(result);
+}
+
+bool RandomWalksFunctionData::Equals(const FunctionData &other_p) const {
+	auto &other = other_p.Cast<RandomWalksFunctionData>();
+	if (csr_id != other.csr_id) {
+		return false;
+	}
+	if (walks_per_node != other.walks_per_node || parameters.length != other.parameters.length) {
+		return false;
+	}
+	if (parameters.p != other.parameters.p || parameters.q != other.parameters.q) {
+		return false;
+	}
+	if (seed != other.seed) {
+		return false;
+	}
+	if (once.IsDone() != other.once.IsDone()) {
+		return false;
+	}
+	return true;
+}
+
+} // namespace duckdb
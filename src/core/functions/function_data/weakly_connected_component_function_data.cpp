@@ -6,8 +6,6 @@ namespace duckdb {
 
 WeaklyConnectedComponentFunctionData::WeaklyConnectedComponentFunctionData(ClientContext &context, int32_t csr_id)
     : context(context), csr_id(csr_id) {
-	state_converged = false; // Initialize state
-	state_initialized = false;
 }
 
 unique_ptr<FunctionData> WeaklyConnectedComponentFunctionData::WeaklyConnectedComponentBind(
@@ -33,7 +31,7 @@ bool WeaklyConnectedComponentFunctionData::Equals(const FunctionData &other_p) c
 	if (csr_id != other.csr_id) {
 		return false;
 	}
-	if (state_converged != other.state_converged) {
+	if (once.IsDone() != other.once.IsDone()) {
 		return false;
 	}
 	return true;
@@ -0,0 +1,225 @@
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/iterative_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+//! Enumerates all shortest paths from a source to a destination over the outgoing edges of a CSR. A BFS from the
+//! source numbers the depths up to the one of the destination, then every depth is walked back up to mark the
+//! vertices with an edge to a marked vertex one depth further, starting from the destination. A depth-first walk
+//! along the edges to marked vertices one depth further then only takes steps that end at the destination, so it
+//! emits one path per leaf and holds no more than the path it is on.
+template <class ID_T>
+class AllShortestPaths {
+public:
+	AllShortestPaths(CSR &csr, idx_t vertex_count)
+	    : ranges(csr.GetRanges()), e(csr.GetNeighbors<ID_T>()), depth(vertex_count, -1), on_path(vertex_count, false) {
+	}
+
+	//! Calls [emit] with the CSR offsets of the edges of every shortest path from [source] to [destination] until it
+	//! returns false
+	template <class EMIT>
+	void Run(int64_t source, int64_t destination, EMIT &&emit) {
+		Reset();
+		if (!Search(source, destination)) {
+			return;
+		}
+		offsets.clear();
+		calls.clear();
+		calls.emplace_back(source, ranges.begin[source]);
+		while (!calls.empty()) {
+			auto vertex = calls.back().first;
+			if (vertex == destination) {
+				if (!emit(offsets)) {
+					return;
+				}
+				Return();
+				continue;
+			}
+			auto &offset = calls.back().second;
+			while (offset < ranges.end[vertex] && !Descends(vertex, Target(offset))) {
+				offset++;
+			}
+			if (offset == ranges.end[vertex]) {
+				Return();
+				continue;
+			}
+			auto step = offset++;
+			offsets.push_back(step);
+			calls.emplace_back(Target(step), ranges.begin[Target(step)]);
+		}
+	}
+
+	int64_t Target(int64_t offset) const {
+		return static_cast<int64_t>(e[offset]);
+	}
+
+private:
+	bool Descends(int64_t vertex, int64_t target) const {
+		return depth[target] == depth[vertex] + 1 && on_path[target];
+	}
+	void Return() {
+		calls.pop_back();
+		if (!offsets.empty()) {
+			offsets.pop_back();
+		}
+	}
+
+	//! Numbers the depths up to the one of [destination] and marks the vertices on a shortest path to it
+	bool Search(int64_t source, int64_t destination) {
+		touched.assign(1, source);
+		depth[source] = 0;
+		// Every vertex of the depth before the one of the destination is reached before the destination is
+		for (idx_t head = 0; head < touched.size() && depth[destination] < 0; head++) {
+			auto vertex = touched[head];
+			for (auto offset = ranges.begin[vertex]; offset < ranges.end[vertex]; offset++) {
+				auto neighbor = Target(offset);
+				if (depth[neighbor] < 0) {
+					depth[neighbor] = depth[vertex] + 1;
+					touched.push_back(neighbor);
+				}
+			}
+		}
+		if (depth[destination] < 0) {
+			return false;
+		}
+		// The vertices come out of the BFS by increasing depth, walking them backwards visits every depth after the
+		// one below it
+		on_path[destination] = true;
+		for (auto i = touched.size(); i-- > 0;) {
+			auto vertex = touched[i];
+			if (depth[vertex] >= depth[destination]) {
+				continue;
+			}
+			for (auto offset = ranges.begin[vertex]; offset < ranges.end[vertex]; offset++) {
+				if (Descends(vertex, Target(offset))) {
+					on_path[vertex] = true;
+					break;
+				}
+			}
+		}
+		return true;
+	}
+
+	void Reset() {
+		for (auto vertex : touched) {
+			depth[vertex] = -1;
+			on_path[vertex] = false;
+		}
+		touched.clear();
+	}
+
+	CSRRanges ranges;
+	const vector<ID_T> &e;
+	vector<int64_t> depth;
+	vector<bool> on_path;
+	//! The vertices the last search reached, by increasing depth
+	vector<int64_t> touched;
+	//! The vertices of the walk with the offset of the next edge each of them tries, and the edges between them
+	vector<pair<int64_t, int64_t>> calls;
+	vector<int64_t> offsets;
+};
+
+//! Writes the paths of every row straight into the nested lists of [result], growing them as paths are found, so
+//! that no path is stored anywhere else. At most [max_paths] paths are returned per row.
+template <class ID_T>
+static void AllShortestPathsInternal(CSR &csr, int64_t v_size, idx_t count, const UnifiedVectorFormat &vdata_src,
+                                     const int64_t *src_data, const UnifiedVectorFormat &vdata_dst,
+                                     const int64_t *dst_data, idx_t max_paths, Vector &result) {
+	auto result_data = FlatVector::GetData<list_entry_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	auto &paths = ListVector::GetEntry(result);
+	AllShortestPaths<ID_T> search(csr, static_cast<idx_t>(v_size));
+	idx_t path_count = 0;
+	idx_t id_count = 0;
+	for (idx_t row = 0; row < count; row++) {
+		result_data[row].offset = path_count;
+		result_data[row].length = 0;
+		auto src_pos = vdata_src.sel->get_index(row);
+		auto dst_pos = vdata_dst.sel->get_index(row);
+		if (!vdata_src.validity.RowIsValid(src_pos) || !vdata_dst.validity.RowIsValid(dst_pos)) {
+			result_validity.SetInvalid(row);
+			continue;
+		}
+		auto source = src_data[src_pos];
+		auto destination = dst_data[dst_pos];
+		if (source < 0 || source >= v_size || destination < 0 || destination >= v_size) {
+			continue;
+		}
+		search.Run(source, destination, [&](const vector<int64_t> &offsets) {
+			ListVector::Reserve(result, path_count + 1);
+			ListVector::Reserve(paths, id_count + 2 * offsets.size() + 1);
+			auto path_data = FlatVector::GetData<list_entry_t>(paths);
+			auto id_data = FlatVector::GetData<int64_t>(ListVector::GetEntry(paths));
+			path_data[path_count].offset = id_count;
+			path_data[path_count].length = 2 * offsets.size() + 1;
+			id_data[id_count++] = csr.ExternalId(source);
+			for (auto offset : offsets) {
+				id_data[id_count++] = csr.edge_ids[offset];
+				id_data[id_count++] = csr.ExternalId(search.Target(offset));
+			}
+			path_count++;
+			return ++result_data[row].length < max_paths;
+		});
+	}
+	ListVector::SetListSize(paths, id_count);
+	ListVector::SetListSize(result, path_count);
+}
+
+static void AllShortestPathsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
+	// The variant with five arguments caps the number of paths of a row
+	auto max_paths = NumericLimits<idx_t>::Maximum();
+	if (args.ColumnCount() > 4) {
+		UnifiedVectorFormat vdata_max;
+		args.data[4].ToUnifiedFormat(args.size(), vdata_max);
+		auto max_pos = vdata_max.sel->get_index(0);
+		if (!vdata_max.validity.RowIsValid(max_pos) || UnifiedVectorFormat::GetData<int64_t>(vdata_max)[max_pos] < 1) {
+			throw InvalidInputException("all_shortest_paths needs a positive maximum number of paths");
+		}
+		max_paths = static_cast<idx_t>(UnifiedVectorFormat::GetData<int64_t>(vdata_max)[max_pos]);
+	}
+
+	auto &local_state = PathFunctionLocalState::Get(state);
+	auto &csr = local_state.Bind(info.context, info.csr_id, true);
+	auto v_size = local_state.VertexCount();
+
+	UnifiedVectorFormat vdata_src;
+	UnifiedVectorFormat vdata_dst;
+	args.data[2].ToUnifiedFormat(args.size(), vdata_src);
+	args.data[3].ToUnifiedFormat(args.size(), vdata_dst);
+	auto src_data = csr.InternalIds(vdata_src, args.size(), local_state.source_ids);
+	auto dst_data = csr.InternalIds(vdata_dst, args.size(), local_state.target_ids);
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	if (csr.compact) {
+		AllShortestPathsInternal<int32_t>(csr, v_size, args.size(), vdata_src, src_data, vdata_dst, dst_data,
+		                                  max_paths, result);
+	} else {
+		AllShortestPathsInternal<int64_t>(csr, v_size, args.size(), vdata_src, src_data, vdata_dst, dst_data,
+		                                  max_paths, result);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterAllShortestPathsScalarFunction(ExtensionLoader &loader) {
+	ScalarFunctionSet set("all_shortest_paths");
+	// csr_id, vertex count, source, destination
+	ScalarFunction function({LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
+	                        LogicalType::LIST(LogicalType::LIST(LogicalType::BIGINT)), AllShortestPathsFunction,
+	                        IterativeLengthFunctionData::IterativeLengthBind);
+	function.init_local_state = PathFunctionLocalState::Init;
+	set.AddFunction(function);
+	// and the maximum number of paths of a row
+	function.arguments.push_back(LogicalType::BIGINT);
+	set.AddFunction(function);
+	loader.RegisterFunction(set);
+}
+
+} // namespace duckdb
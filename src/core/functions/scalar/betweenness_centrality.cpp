@@ -0,0 +1,322 @@
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/betweenness_centrality_function_data.hpp"
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/compressed_sparse_row.hpp>
+#include <duckpgq/core/utils/duckpgq_parallel.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+#include <duckpgq/core/utils/lane_set.hpp>
+#include <duckpgq/core/utils/memory_reservation.hpp>
+
+#include <numeric>
+#include <random>
+
+namespace duckdb {
+
+//! The arrays of the searches of one thread, allocated once and reused by all of its batches. Every batch resets
+//! the entries it set, so the arrays are only swept once.
+template <idx_t LANES>
+struct BrandesScratch {
+	//! Bytes of the arrays per vertex of the graph
+	static constexpr idx_t VERTEX_BYTES =
+	    2 * sizeof(LaneBitset<LANES>) + 2 * LANES * sizeof(double_t) + sizeof(double_t);
+
+	void Prepare(ClientContext &context, idx_t vertex_count) {
+		memory.Resize(context, vertex_count * VERTEX_BYTES);
+		seen.assign(vertex_count, LaneBitset<LANES>());
+		next.assign(vertex_count, LaneBitset<LANES>());
+		sigma.assign(vertex_count * LANES, 0.0);
+		delta.assign(vertex_count * LANES, 0.0);
+		centrality.assign(vertex_count, 0.0);
+	}
+
+	//! The lanes that reached vertex i
+	vector<LaneBitset<LANES>> seen;
+	//! The lanes that reach vertex i in the running BFS step, or that reached it at the depth below the one the
+	//! dependencies are accumulated for
+	vector<LaneBitset<LANES>> next;
+	//! Number of shortest paths from the source of lane l to vertex i at [i * LANES + l]
+	vector<double_t> sigma;
+	//! Dependency of the source of lane l on vertex i at [i * LANES + l]
+	vector<double_t> delta;
+	//! The vertices at every depth, each with the lanes that reached it at that depth
+	vector<vector<pair<int64_t, LaneBitset<LANES>>>> levels;
+	vector<int64_t> touched;
+	//! The dependencies of all batches of the thread
+	vector<double_t> centrality;
+	MemoryReservation memory;
+};
+
+//! Brandes' algorithm for the [count] sources, one per lane. The forward phase is a multi-source BFS that also counts
+//! the shortest paths of every lane: a vertex reached by a lane for the first time adds the counts of all of its
+//! predecessors in the frontier of that lane. The backward phase walks the depths back up, every vertex pulling the
+//! dependencies of its successors one depth below it, and adds them to the centrality of the vertex.
+template <idx_t LANES, class ID_T>
+static void BrandesBatch(const CSRRanges &ranges, const vector<ID_T> &e, const int64_t *sources, idx_t count,
+                         BrandesScratch<LANES> &scratch) {
+	auto &seen = scratch.seen;
+	auto &next = scratch.next;
+	auto &sigma = scratch.sigma;
+	auto &delta = scratch.delta;
+	auto &levels = scratch.levels;
+	auto &touched = scratch.touched;
+	if (levels.empty()) {
+		levels.emplace_back();
+	}
+	levels[0].clear();
+	for (idx_t lane = 0; lane < count; lane++) {
+		auto source = sources[lane];
+		seen[source].set(lane);
+		sigma[source * LANES + lane] = 1;
+		LaneBitset<LANES> lanes;
+		lanes.set(lane);
+		levels[0].emplace_back(source, lanes);
+	}
+
+	idx_t depth = 0;
+	while (true) {
+		if (levels.size() <= depth + 1) {
+			levels.emplace_back();
+		}
+		auto &current = levels[depth];
+		auto &upcoming = levels[depth + 1];
+		upcoming.clear();
+		touched.clear();
+		for (auto &entry : current) {
+			auto u = entry.first;
+			for (auto offset = ranges.begin[u]; offset < ranges.end[u]; offset++) {
+				auto w = static_cast<int64_t>(e[offset]);
+				auto fresh = entry.second;
+				fresh.AndNot(seen[w]);
+				if (fresh.none()) {
+					continue;
+				}
+				if (next[w].none()) {
+					touched.push_back(w);
+				}
+				next[w] |= fresh;
+				fresh.ForEach([&](idx_t lane) { sigma[w * LANES + lane] += sigma[u * LANES + lane]; });
+			}
+		}
+		if (touched.empty()) {
+			break;
+		}
+		for (auto w : touched) {
+			seen[w] |= next[w];
+			upcoming.emplace_back(w, next[w]);
+			next[w] = 0;
+		}
+		depth++;
+	}
+
+	for (auto d = depth; d-- > 0;) {
+		for (auto &entry : levels[d + 1]) {
+			next[entry.first] = entry.second;
+		}
+		for (auto &entry : levels[d]) {
+			auto u = entry.first;
+			for (auto offset = ranges.begin[u]; offset < ranges.end[u]; offset++) {
+				auto w = static_cast<int64_t>(e[offset]);
+				auto lanes = entry.second & next[w];
+				lanes.ForEach([&](idx_t lane) {
+					delta[u * LANES + lane] +=
+					    sigma[u * LANES + lane] / sigma[w * LANES + lane] * (1 + delta[w * LANES + lane]);
+				});
+			}
+		}
+		for (auto &entry : levels[d + 1]) {
+			next[entry.first] = 0;
+		}
+	}
+
+	// A source does not lie on its own paths
+	for (idx_t d = 0; d <= depth; d++) {
+		for (auto &entry : levels[d]) {
+			auto w = entry.first;
+			entry.second.ForEach([&](idx_t lane) {
+				if (d > 0) {
+					scratch.centrality[w] += delta[w * LANES + lane];
+				}
+				sigma[w * LANES + lane] = 0;
+				delta[w * LANES + lane] = 0;
+			});
+			seen[w] = 0;
+		}
+	}
+}
+
+//! Sums the dependencies of all [sources] into [centrality]. The sources are split into batches of LANES, which run
+//! in waves of up to [slot_count] batches. Every slot sums into its own array and the arrays are added up in a fixed
+//! order, so the result does not depend on the scheduling.
+template <idx_t LANES, class ID_T>
+static void BetweennessCentrality(ClientContext &context, CSR &csr, const vector<int64_t> &sources,
+                                  idx_t slot_count, vector<double_t> &centrality) {
+	auto vertex_count = csr.VertexCount();
+	auto ranges = csr.GetRanges();
+	auto &e = csr.GetNeighbors<ID_T>();
+	auto batch_count = (sources.size() + LANES - 1) / LANES;
+	slot_count = MinValue<idx_t>(slot_count, batch_count);
+	vector<unique_ptr<BrandesScratch<LANES>>> scratch;
+	for (idx_t slot = 0; slot < slot_count; slot++) {
+		scratch.push_back(make_uniq<BrandesScratch<LANES>>());
+		scratch.back()->Prepare(context, vertex_count);
+	}
+	for (idx_t wave_begin = 0; wave_begin < batch_count; wave_begin += slot_count) {
+		auto wave_size = MinValue<idx_t>(slot_count, batch_count - wave_begin);
+		ParallelFor(context, wave_size, 1, [&](idx_t begin, idx_t end) {
+			for (auto slot = begin; slot < end; slot++) {
+				auto first = (wave_begin + slot) * LANES;
+				BrandesBatch<LANES, ID_T>(ranges, e, sources.data() + first,
+				                          MinValue<idx_t>(LANES, sources.size() - first), *scratch[slot]);
+			}
+		});
+	}
+	centrality.assign(vertex_count, 0.0);
+	for (auto &slot : scratch) {
+		for (idx_t i = 0; i < vertex_count; i++) {
+			centrality[i] += slot->centrality[i];
+		}
+	}
+}
+
+static idx_t BrandesVertexBytes(idx_t lanes) {
+	switch (lanes) {
+	case 64:
+		return BrandesScratch<64>::VERTEX_BYTES;
+	case 128:
+		return BrandesScratch<128>::VERTEX_BYTES;
+	case 256:
+		return BrandesScratch<256>::VERTEX_BYTES;
+	default:
+		return BrandesScratch<LANE_LIMIT>::VERTEX_BYTES;
+	}
+}
+
+template <class ID_T>
+static void BetweennessCentralityLanes(ClientContext &context, CSR &csr, const vector<int64_t> &sources,
+                                       vector<double_t> &centrality) {
+	// Narrower batches when there are too few sources to give every thread a full batch
+	auto threads = MaxValue<idx_t>(static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads()), 1);
+	auto lanes = SelectLaneCount((sources.size() + threads - 1) / threads);
+	// Every slot holds the path counts and dependencies of its lanes for all vertices. While the slots do not fit
+	// in the memory left to the query the batches get narrower, and at 64 lanes there are fewer slots.
+	auto &buffer_manager = BufferManager::GetBufferManager(context);
+	auto max_memory = buffer_manager.GetQueryMaxMemory();
+	auto used_memory = buffer_manager.GetUsedMemory();
+	auto available = max_memory > used_memory ? max_memory - used_memory : 0;
+	auto vertex_count = MaxValue<idx_t>(csr.VertexCount(), 1);
+	auto slot_bytes = [&](idx_t lane_count) {
+		return vertex_count * BrandesVertexBytes(lane_count);
+	};
+	while (lanes > 64 && threads * slot_bytes(lanes) > available) {
+		lanes /= 2;
+	}
+	auto slot_count = MaxValue<idx_t>(MinValue<idx_t>(threads, available / slot_bytes(lanes)), 1);
+	switch (lanes) {
+	case 64:
+		return BetweennessCentrality<64, ID_T>(context, csr, sources, slot_count, centrality);
+	case 128:
+		return BetweennessCentrality<128, ID_T>(context, csr, sources, slot_count, centrality);
+	case 256:
+		return BetweennessCentrality<256, ID_T>(context, csr, sources, slot_count, centrality);
+	default:
+		return BetweennessCentrality<LANE_LIMIT, ID_T>(context, csr, sources, slot_count, centrality);
+	}
+}
+
+//! All vertices, or a uniform sample of [samples] distinct vertices in increasing order. The seed is fixed so that
+//! repeated runs return the same estimate.
+static vector<int64_t> SelectSources(idx_t vertex_count, int64_t samples) {
+	vector<int64_t> sources(vertex_count);
+	std::iota(sources.begin(), sources.end(), 0);
+	if (samples == 0 || static_cast<idx_t>(samples) >= vertex_count) {
+		return sources;
+	}
+	auto sample_count = static_cast<idx_t>(samples);
+	std::mt19937_64 random(vertex_count);
+	for (idx_t i = 0; i < sample_count; i++) {
+		std::swap(sources[i], sources[i + random() % (vertex_count - i)]);
+	}
+	sources.resize(sample_count);
+	std::sort(sources.begin(), sources.end());
+	return sources;
+}
+
+static void BetweennessCentralityFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<BetweennessCentralityFunctionData>();
+	auto duckpgq_state = GetDuckPGQState(info.context);
+
+	auto csr_entry = duckpgq_state->csr_list.find(info.csr_id);
+	if (csr_entry == duckpgq_state->csr_list.end()) {
+		throw ConstraintException("CSR not found. Is the graph populated?");
+	}
+
+	if (!(csr_entry->second->initialized_v && csr_entry->second->initialized_e)) {
+		throw ConstraintException("Need to initialize CSR before computing betweenness centrality.");
+	}
+
+	auto &csr = *csr_entry->second;
+	csr.LoadPartitions(info.context);
+	auto vertex_count = static_cast<int64_t>(csr.VertexCount());
+
+	// The threads that arrive while the centrality is computed work on its batches instead of waiting
+	info.once.Run([&]() {
+		auto sources = SelectSources(vertex_count, info.samples);
+		if (csr.compact) {
+			BetweennessCentralityLanes<int32_t>(info.context, csr, sources, info.centrality);
+		} else {
+			BetweennessCentralityLanes<int64_t>(info.context, csr, sources, info.centrality);
+		}
+		// A sample estimates the sum over all sources
+		if (!sources.empty() && sources.size() < static_cast<idx_t>(vertex_count)) {
+			auto scale = static_cast<double_t>(vertex_count) / static_cast<double_t>(sources.size());
+			for (auto &centrality : info.centrality) {
+				centrality *= scale;
+			}
+		}
+	});
+
+	auto &src = args.data[1];
+	UnifiedVectorFormat vdata_src;
+	src.ToUnifiedFormat(args.size(), vdata_src);
+	auto src_data = UnifiedVectorFormat::GetData<int64_t>(vdata_src);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<double_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	for (idx_t i = 0; i < args.size(); i++) {
+		auto id_pos = vdata_src.sel->get_index(i);
+		if (!vdata_src.validity.RowIsValid(id_pos)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		auto node_id = csr.InternalId(src_data[id_pos]);
+		if (node_id < 0 || node_id >= vertex_count) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		result_data[i] = info.centrality[node_id];
+	}
+
+	duckpgq_state->csr_to_delete.insert(info.csr_id);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterBetweennessCentralityScalarFunction(ExtensionLoader &loader) {
+	ScalarFunctionSet set("betweenness_centrality");
+	set.AddFunction(ScalarFunction({LogicalType::INTEGER, LogicalType::BIGINT}, LogicalType::DOUBLE,
+	                               BetweennessCentralityFunction,
+	                               BetweennessCentralityFunctionData::BetweennessCentralityBind));
+	// Number of sampled sources
+	set.AddFunction(ScalarFunction({LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT},
+	                               LogicalType::DOUBLE, BetweennessCentralityFunction,
+	                               BetweennessCentralityFunctionData::BetweennessCentralityBind));
+	loader.RegisterFunction(set);
+}
+
+} // namespace duckdb
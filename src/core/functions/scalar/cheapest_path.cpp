@@ -0,0 +1,98 @@
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/cheapest_path_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+#include "duckpgq/core/utils/weighted_path.hpp"
+
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+#include <algorithm>
+
+namespace duckdb {
+
+template <class T>
+static void TemplatedCheapestPath(ClientContext &context, CSR &csr, const vector<T> &weights, idx_t count,
+                                  const UnifiedVectorFormat &vdata_src, const int64_t *src_data,
+                                  const UnifiedVectorFormat &vdata_target, const int64_t *target_data,
+                                  Vector &result) {
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<list_entry_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+
+	// The searches run on several threads, the paths are appended to the result once they are all done
+	vector<vector<int64_t>> paths(count);
+	vector<uint8_t> found(count, 0);
+	MSBFSSourceGroups groups;
+	groups.Initialize(count, *vdata_src.sel, vdata_src.validity, src_data);
+	WeightedPathSearchGroups<T>(context, csr, weights, true, groups, vdata_target, target_data,
+	                            [&](const WeightedPathSearch<T> &search, idx_t row, int64_t target) {
+		                            found[row] = search.GetPath(target, paths[row]);
+	                            });
+
+	// The list child vector is grown once for all paths of the chunk, which are then copied into it
+	idx_t total_len = 0;
+	for (idx_t i = 0; i < count; i++) {
+		if (found[i]) {
+			total_len += paths[i].size();
+		}
+	}
+	ListVector::Reserve(result, total_len);
+	auto path_data = FlatVector::GetData<int64_t>(ListVector::GetEntry(result));
+	idx_t offset = 0;
+	for (idx_t i = 0; i < count; i++) {
+		if (!found[i]) {
+			// No source, no target or no path
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		csr.ExternalPathIds(paths[i]);
+		std::copy(paths[i].begin(), paths[i].end(), path_data + offset);
+		result_data[i].length = paths[i].size();
+		result_data[i].offset = offset;
+		offset += paths[i].size();
+	}
+	ListVector::SetListSize(result, total_len);
+}
+
+static void CheapestPathFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<CheapestPathLengthFunctionData>();
+	auto &local_state = PathFunctionLocalState::Get(state);
+	CSR *csr = &local_state.Bind(info.context, info.csr_id);
+	if (csr->GetWeightStatistics().min < 0) {
+		throw InvalidInputException("cheapest_path does not support negative edge weights");
+	}
+
+	UnifiedVectorFormat vdata_src, vdata_target;
+	args.data[2].ToUnifiedFormat(args.size(), vdata_src);
+	args.data[3].ToUnifiedFormat(args.size(), vdata_target);
+	auto src_data = csr->InternalIds(vdata_src, args.size(), local_state.source_ids);
+	auto target_data = csr->InternalIds(vdata_target, args.size(), local_state.target_ids);
+
+	auto narrow_weights = csr->GetNarrowWeights();
+	if (narrow_weights) {
+		TemplatedCheapestPath<int32_t>(info.context, *csr, *narrow_weights, args.size(), vdata_src, src_data,
+		                               vdata_target, target_data, result);
+	} else if (csr->w.empty()) {
+		TemplatedCheapestPath<double>(info.context, *csr, csr->w_double, args.size(), vdata_src, src_data,
+		                              vdata_target, target_data, result);
+	} else {
+		TemplatedCheapestPath<int64_t>(info.context, *csr, csr->w, args.size(), vdata_src, src_data, vdata_target,
+		                               target_data, result);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterCheapestPathScalarFunction(ExtensionLoader &loader) {
+	ScalarFunction function(
+	    "cheapest_path", {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
+	    LogicalType::LIST(LogicalType::BIGINT), CheapestPathFunction, CheapestPathLengthFunctionData::CheapestPathBind);
+	function.init_local_state = PathFunctionLocalState::Init;
+	loader.RegisterFunction(function);
+}
+
+} // namespace duckdb
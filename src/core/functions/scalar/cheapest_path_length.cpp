@@ -2,135 +2,202 @@
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckpgq/common.hpp"
 #include "duckpgq/core/functions/function_data/cheapest_path_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
 #include <duckpgq/core/functions/scalar.hpp>
 #include <duckpgq_extension.hpp>
 
 #include <duckpgq/core/utils/duckpgq_utils.hpp>
+#include "duckpgq/core/utils/weighted_path.hpp"
 
 namespace duckdb {
 
-template <typename T, int16_t lane_limit>
-static int16_t InitialiseBellmanFord(const DataChunk &args, int64_t input_size, const UnifiedVectorFormat &vdata_src,
-                                     const int64_t *src_data, idx_t result_size, vector<vector<T>> &dists) {
-	dists.resize(input_size, std::vector<T>(lane_limit, std::numeric_limits<T>::max() / 2));
-
-	int16_t lanes = 0;
-	for (idx_t i = result_size; i < args.size() && lanes < lane_limit; i++) {
-		auto src_index = vdata_src.sel->get_index(i);
-		if (vdata_src.validity.RowIsValid(src_index)) {
-			const int64_t &src_entry = src_data[src_index];
-			dists[src_entry][lanes] = 0;
-			lanes++;
-		}
-	}
-	return lanes;
-}
+//! The values of the result for distances of type T, BIGINT for the int32_t distances of narrow weights as well
+template <typename T>
+using CheapestPathLengthResult = typename std::conditional<std::is_integral<T>::value, int64_t, double>::type;
 
+//! Distance of the vertices a lane has not reached
 template <typename T>
-int64_t UpdateOneLane(T &n_dist, T v_dist, T weight) {
-	T new_dist = v_dist + weight;
-	bool better = new_dist < n_dist;
-	T min = better ? new_dist : n_dist;
-	n_dist = min;
-	return better;
+static constexpr T BellmanFordUnreached() {
+	return std::numeric_limits<T>::max();
 }
 
-template <typename T>
-bool UpdateLanes(vector<vector<T>> &dists, T v, T n, T weight) {
-	std::vector<T> &v_dists = dists[v];
-	std::vector<T> &n_dists = dists[n];
-	size_t num_lanes = dists[v].size();
-	size_t lane_idx = 0;
-	bool xor_diff = false;
-	while (lane_idx < num_lanes) {
-		xor_diff |= UpdateOneLane<T>(n_dists[lane_idx], v_dists[lane_idx], weight);
-		++lane_idx;
+//! Relaxes the edge (v, n) of [weight] in every lane at once. The distances of a vertex are LANES consecutive entries,
+//! so the loop has a fixed trip count over two contiguous rows and compiles to vector min and add instructions.
+template <typename T, idx_t LANES>
+static bool UpdateLanes(const T *v_dists, T *n_dists, T weight) {
+	bool changed = false;
+	for (idx_t lane = 0; lane < LANES; lane++) {
+		auto candidate = v_dists[lane] + weight;
+		// An unreached lane stays unreached, whatever the sign of the weight
+		auto better = v_dists[lane] != BellmanFordUnreached<T>() && candidate < n_dists[lane];
+		n_dists[lane] = better ? candidate : n_dists[lane];
+		changed |= better;
 	}
-	return xor_diff;
+	return changed;
 }
 
-template <typename T, int16_t lane_limit>
-int16_t TemplatedBatchBellmanFord(CSR *csr, DataChunk &args, int64_t input_size, UnifiedVectorFormat &vdata_src,
-                                  int64_t *src_data, const UnifiedVectorFormat &vdata_target, int64_t *target_data,
-                                  const std::vector<T> &weight_array, int16_t result_size, T *result_data,
-                                  ValidityMask &result_validity) {
-	vector<vector<T>> dists;
-	int16_t curr_batch_size =
-	    InitialiseBellmanFord<T, lane_limit>(args, input_size, vdata_src, src_data, result_size, dists);
-	bool changed = true;
-	while (changed) {
-		changed = false;
-		//! For every v in the input
-		for (int64_t v = 0; v < input_size; v++) {
-			//! Loop through all the n neighbours of v
-			for (auto index = (int64_t)csr->v[v]; index < (int64_t)csr->v[v + 1]; index++) {
-				//! Get weight of (v,n)
-				changed = UpdateLanes<T>(dists, v, csr->e[index], weight_array[index]) | changed;
-			}
+//! The arrays of the Bellman-Ford batches of one call, allocated by the first batch and reused by the others
+template <typename T>
+struct BellmanFordScratch {
+	//! The distance of lane l to vertex v at [v * LANES + l]
+	vector<T> dists;
+	//! The vertices whose distance changed in any lane in the last round, and the ones of the round being run
+	vector<int64_t> active;
+	vector<int64_t> next_active;
+	vector<bool> queued;
+	MemoryReservation memory;
+};
+
+//! Runs one batch of Bellman-Ford searches, one group of rows with the same source per lane, starting at group
+//! [first_group]. Every round only relaxes the edges of the vertices whose distance changed in the round before, and
+//! the searches end when no distance changes. The rounds are counted in [counters]. Returns the number of groups of
+//! the batch.
+template <typename T, idx_t LANES>
+static idx_t TemplatedBatchBellmanFord(ClientContext &context, CSR &csr, const vector<T> &weights, int64_t v_size,
+                                       const MSBFSSourceGroups &groups, idx_t first_group,
+                                       const UnifiedVectorFormat &vdata_target, const int64_t *target_data,
+                                       BellmanFordScratch<T> &scratch, CheapestPathLengthResult<T> *result_data,
+                                       ValidityMask &result_validity, TraversalCounters &counters) {
+	auto vertex_count = static_cast<idx_t>(v_size);
+	auto &dists = scratch.dists;
+	if (dists.size() < vertex_count * LANES) {
+		// The first batch is the widest, the others use the start of its array
+		auto allocated = vertex_count * (LANES * sizeof(T) + sizeof(int64_t));
+		scratch.memory.Resize(context, allocated);
+		counters.scratch_bytes += allocated;
+		dists.resize(vertex_count * LANES);
+		scratch.queued.assign(vertex_count, false);
+	}
+	std::fill(dists.begin(), dists.begin() + static_cast<int64_t>(vertex_count * LANES), BellmanFordUnreached<T>());
+	auto batch_size = MinValue<idx_t>(LANES, groups.GroupCount() - first_group);
+	auto &active = scratch.active;
+	auto &next_active = scratch.next_active;
+	active.clear();
+	for (idx_t lane = 0; lane < batch_size; lane++) {
+		auto source = groups.sources[first_group + lane];
+		if (source < 0 || source >= v_size) {
+			continue;
+		}
+		dists[source * LANES + lane] = 0;
+		if (!scratch.queued[source]) {
+			scratch.queued[source] = true;
+			active.push_back(source);
 		}
 	}
-	for (idx_t i = result_size; i < (idx_t)(result_size + curr_batch_size); i++) {
-		auto target_index = vdata_target.sel->get_index(i);
-		if (!vdata_target.validity.RowIsValid(target_index)) {
-			result_validity.SetInvalid(i);
+
+	auto ranges = csr.GetRanges();
+	int64_t rounds = 0;
+	while (!active.empty()) {
+		// A shortest path has fewer edges than there are vertices, any change after that comes from a negative cycle
+		if (rounds++ == v_size) {
+			throw InvalidInputException("cheapest_path_length does not support negative cycles");
+		}
+		counters.iterations++;
+		counters.active_lanes += batch_size;
+		for (auto v : active) {
+			scratch.queued[v] = false;
+			counters.edges += static_cast<idx_t>(ranges.end[v] - ranges.begin[v]);
 		}
+		next_active.clear();
+		for (auto v : active) {
+			for (auto index = ranges.begin[v]; index < ranges.end[v]; index++) {
+				int64_t n = csr.compact ? csr.e_compact[index] : csr.e[index];
+				if (UpdateLanes<T, LANES>(&dists[v * LANES], &dists[n * LANES], weights[index]) && !scratch.queued[n]) {
+					scratch.queued[n] = true;
+					next_active.push_back(n);
+				}
+			}
+		}
+		active.swap(next_active);
+	}
 
-		const auto &target_entry = target_data[target_index];
-		auto resulting_distance = dists[target_entry][i % lane_limit];
+	for (idx_t lane = 0; lane < batch_size; lane++) {
+		auto group = first_group + lane;
+		for (auto i = groups.offsets[group]; i < groups.offsets[group + 1]; i++) {
+			auto row = groups.rows[i];
+			auto target_index = vdata_target.sel->get_index(row);
+			auto target = target_data[target_index];
+			if (!vdata_target.validity.RowIsValid(target_index) || target < 0 || target >= v_size ||
+			    dists[target * LANES + lane] == BellmanFordUnreached<T>()) {
+				result_validity.SetInvalid(row);
+			} else {
+				result_data[row] = dists[target * LANES + lane];
+			}
+		}
+	}
+	return batch_size;
+}
 
-		if (resulting_distance == std::numeric_limits<T>::max() / 2) {
+template <typename T>
+void TemplatedBellmanFord(ClientContext &context, CSR &csr, const vector<T> &weights, int64_t v_size, idx_t count,
+                          const UnifiedVectorFormat &vdata_src, const int64_t *src_data,
+                          const UnifiedVectorFormat &vdata_target, const int64_t *target_data, Vector &result,
+                          TraversalCounters &counters) {
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<CheapestPathLengthResult<T>>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	for (idx_t i = 0; i < count; i++) {
+		if (!vdata_src.validity.RowIsValid(vdata_src.sel->get_index(i))) {
 			result_validity.SetInvalid(i);
+		}
+	}
+
+	MSBFSSourceGroups groups;
+	groups.Initialize(count, *vdata_src.sel, vdata_src.validity, src_data);
+	BellmanFordScratch<T> scratch;
+	idx_t done = 0;
+	while (done < groups.GroupCount()) {
+		auto remaining = groups.GroupCount() - done;
+		if (remaining >= 256) {
+			done += TemplatedBatchBellmanFord<T, 256>(context, csr, weights, v_size, groups, done, vdata_target,
+			                                          target_data, scratch, result_data, result_validity, counters);
+		} else if (remaining >= 128) {
+			done += TemplatedBatchBellmanFord<T, 128>(context, csr, weights, v_size, groups, done, vdata_target,
+			                                          target_data, scratch, result_data, result_validity, counters);
+		} else if (remaining >= 64) {
+			done += TemplatedBatchBellmanFord<T, 64>(context, csr, weights, v_size, groups, done, vdata_target,
+			                                         target_data, scratch, result_data, result_validity, counters);
+		} else if (remaining >= 16) {
+			done += TemplatedBatchBellmanFord<T, 16>(context, csr, weights, v_size, groups, done, vdata_target,
+			                                         target_data, scratch, result_data, result_validity, counters);
+		} else if (remaining >= 8) {
+			done += TemplatedBatchBellmanFord<T, 8>(context, csr, weights, v_size, groups, done, vdata_target,
+			                                        target_data, scratch, result_data, result_validity, counters);
+		} else if (remaining >= 4) {
+			done += TemplatedBatchBellmanFord<T, 4>(context, csr, weights, v_size, groups, done, vdata_target,
+			                                        target_data, scratch, result_data, result_validity, counters);
+		} else if (remaining >= 2) {
+			done += TemplatedBatchBellmanFord<T, 2>(context, csr, weights, v_size, groups, done, vdata_target,
+			                                        target_data, scratch, result_data, result_validity, counters);
 		} else {
-			result_data[i] = resulting_distance;
+			done += TemplatedBatchBellmanFord<T, 1>(context, csr, weights, v_size, groups, done, vdata_target,
+			                                        target_data, scratch, result_data, result_validity, counters);
 		}
 	}
-	dists.clear();
-	return curr_batch_size;
 }
 
-template <typename T>
-void TemplatedBellmanFord(CSR *csr, DataChunk &args, int64_t input_size, Vector &result, UnifiedVectorFormat &vdata_src,
-                          int64_t *src_data, const UnifiedVectorFormat &vdata_target, int64_t *target_data,
-                          const std::vector<T> &weight_array) {
-	idx_t result_size = 0;
+template <class T>
+static void TemplatedCheapestPathLength(ClientContext &context, CSR &csr, const vector<T> &weights, idx_t count,
+                                        const UnifiedVectorFormat &vdata_src, const int64_t *src_data,
+                                        const UnifiedVectorFormat &vdata_target, const int64_t *target_data,
+                                        Vector &result) {
 	result.SetVectorType(VectorType::FLAT_VECTOR);
-	auto result_data = FlatVector::GetData<T>(result);
+	auto result_data = FlatVector::GetData<CheapestPathLengthResult<T>>(result);
 	auto &result_validity = FlatVector::Validity(result);
-	vector<vector<T>> final_dists(input_size, std::vector<T>(args.size(), std::numeric_limits<T>::max() / 2));
-
-	while (result_size < args.size()) {
-		if ((args.size() - result_size) / 256 >= 1) {
-			result_size +=
-			    TemplatedBatchBellmanFord<T, 256>(csr, args, input_size, vdata_src, src_data, vdata_target, target_data,
-			                                      weight_array, result_size, result_data, result_validity);
-		} else if ((args.size() - result_size) / 128 >= 1) {
-			result_size +=
-			    TemplatedBatchBellmanFord<T, 128>(csr, args, input_size, vdata_src, src_data, vdata_target, target_data,
-			                                      weight_array, result_size, result_data, result_validity);
-		} else if ((args.size() - result_size) / 64 >= 1) {
-			result_size +=
-			    TemplatedBatchBellmanFord<T, 64>(csr, args, input_size, vdata_src, src_data, vdata_target, target_data,
-			                                     weight_array, result_size, result_data, result_validity);
-		} else if ((args.size() - result_size) / 16 >= 1) {
-			result_size +=
-			    TemplatedBatchBellmanFord<T, 16>(csr, args, input_size, vdata_src, src_data, vdata_target, target_data,
-			                                     weight_array, result_size, result_data, result_validity);
-		} else if ((args.size() - result_size) / 8 >= 1) {
-			result_size +=
-			    TemplatedBatchBellmanFord<T, 8>(csr, args, input_size, vdata_src, src_data, vdata_target, target_data,
-			                                    weight_array, result_size, result_data, result_validity);
-		} else if ((args.size() - result_size) / 4 >= 1) {
-			result_size +=
-			    TemplatedBatchBellmanFord<T, 4>(csr, args, input_size, vdata_src, src_data, vdata_target, target_data,
-			                                    weight_array, result_size, result_data, result_validity);
-		} else if ((args.size() - result_size) / 2 >= 1) {
-			result_size +=
-			    TemplatedBatchBellmanFord<T, 2>(csr, args, input_size, vdata_src, src_data, vdata_target, target_data,
-			                                    weight_array, result_size, result_data, result_validity);
-		} else {
-			result_size +=
-			    TemplatedBatchBellmanFord<T, 1>(csr, args, input_size, vdata_src, src_data, vdata_target, target_data,
-			                                    weight_array, result_size, result_data, result_validity);
+	for (idx_t i = 0; i < count; i++) {
+		result_data[i] = WeightedPathSearch<T>::UNREACHED;
+	}
+
+	MSBFSSourceGroups groups;
+	groups.Initialize(count, *vdata_src.sel, vdata_src.validity, src_data);
+	WeightedPathSearchGroups<T>(context, csr, weights, false, groups, vdata_target, target_data,
+	                            [&](const WeightedPathSearch<T> &search, idx_t row, int64_t target) {
+		                            result_data[row] = search.Distance(target);
+	                            });
+	// Rows without a source, without a target or without a path are NULL
+	for (idx_t i = 0; i < count; i++) {
+		if (result_data[i] == WeightedPathSearch<T>::UNREACHED) {
+			result_validity.SetInvalid(i);
 		}
 	}
 }
@@ -138,36 +205,54 @@ void TemplatedBellmanFord(CSR *csr, DataChunk &args, int64_t input_size, Vector
 static void CheapestPathLengthFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
 	auto &info = func_expr.bind_info->Cast<CheapestPathLengthFunctionData>();
-	int64_t input_size = args.data[1].GetValue(0).GetValue<int64_t>();
-	auto duckpgq_state = GetDuckPGQState(info.context);
-
-	CSR *csr = duckpgq_state->GetCSR(info.csr_id);
+	auto &local_state = PathFunctionLocalState::Get(state);
+	CSR *csr = &local_state.Bind(info.context, info.csr_id);
+	auto input_size = local_state.VertexCount();
+	TraversalMetricsScope metrics(local_state.Metrics(), TraversalKernel::CHEAPEST_PATH_LENGTH);
 	auto &src = args.data[2];
 
 	UnifiedVectorFormat vdata_src, vdata_target;
 	src.ToUnifiedFormat(args.size(), vdata_src);
 
-	auto src_data = reinterpret_cast<int64_t *>(vdata_src.data);
+	auto src_data = csr->InternalIds(vdata_src, args.size(), local_state.source_ids);
 
 	auto &target = args.data[3];
 	target.ToUnifiedFormat(args.size(), vdata_target);
-	auto target_data = reinterpret_cast<int64_t *>(vdata_target.data);
-	if (csr->w.empty()) {
-		TemplatedBellmanFord<double>(csr, args, input_size, result, vdata_src, src_data, vdata_target, target_data,
-		                             csr->w_double);
+	auto target_data = csr->InternalIds(vdata_target, args.size(), local_state.target_ids);
+	// Integer weights are searched on 32 bits when all distances fit, which halves the traffic of the relaxations
+	auto narrow_weights = csr->GetNarrowWeights();
+	if (csr->GetWeightStatistics().min < 0) {
+		// Dijkstra and delta-stepping need non-negative weights
+		if (narrow_weights) {
+			TemplatedBellmanFord<int32_t>(info.context, *csr, *narrow_weights, input_size, args.size(), vdata_src,
+			                              src_data, vdata_target, target_data, result, metrics.counters);
+		} else if (csr->w.empty()) {
+			TemplatedBellmanFord<double>(info.context, *csr, csr->w_double, input_size, args.size(), vdata_src,
+			                             src_data, vdata_target, target_data, result, metrics.counters);
+		} else {
+			TemplatedBellmanFord<int64_t>(info.context, *csr, csr->w, input_size, args.size(), vdata_src,
+			                              src_data, vdata_target, target_data, result, metrics.counters);
+		}
+	} else if (narrow_weights) {
+		TemplatedCheapestPathLength<int32_t>(info.context, *csr, *narrow_weights, args.size(), vdata_src, src_data,
+		                                     vdata_target, target_data, result);
+	} else if (csr->w.empty()) {
+		TemplatedCheapestPathLength<double>(info.context, *csr, csr->w_double, args.size(), vdata_src, src_data,
+		                                    vdata_target, target_data, result);
 	} else {
-		TemplatedBellmanFord<int64_t>(csr, args, input_size, result, vdata_src, src_data, vdata_target, target_data,
-		                              csr->w);
+		TemplatedCheapestPathLength<int64_t>(info.context, *csr, csr->w, args.size(), vdata_src, src_data,
+		                                     vdata_target, target_data, result);
 	}
-	duckpgq_state->csr_to_delete.insert(info.csr_id);
 }
 //------------------------------------------------------------------------------
 // Register functions
 //------------------------------------------------------------------------------
 void CoreScalarFunctions::RegisterCheapestPathLengthScalarFunction(ExtensionLoader &loader) {
-	loader.RegisterFunction(ScalarFunction(
+	ScalarFunction function(
 	    "cheapest_path_length", {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
-	    LogicalType::ANY, CheapestPathLengthFunction, CheapestPathLengthFunctionData::CheapestPathLengthBind));
+	    LogicalType::ANY, CheapestPathLengthFunction, CheapestPathLengthFunctionData::CheapestPathLengthBind);
+	function.init_local_state = PathFunctionLocalState::Init;
+	loader.RegisterFunction(function);
 }
 
 } // namespace duckdb
@@ -0,0 +1,448 @@
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/community_detection_function_data.hpp"
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/compressed_sparse_row.hpp>
+#include <duckpgq/core/utils/duckpgq_parallel.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+#include <duckpgq/core/utils/memory_reservation.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
+namespace duckdb {
+
+//! Vertices per task of the parallel passes
+static constexpr idx_t COMMUNITY_PARTITION_SIZE = 4096;
+
+//! The weight of every adjacency entry of a CSR: w or w_double if the CSR has weights, 1 otherwise
+struct EdgeWeights {
+	explicit EdgeWeights(const CSR &csr)
+	    : w(csr.w.empty() ? nullptr : csr.w.data()), w_double(csr.w_double.empty() ? nullptr : csr.w_double.data()) {
+	}
+	double_t operator()(int64_t offset) const {
+		if (w) {
+			return static_cast<double_t>(w[offset]);
+		}
+		return w_double ? w_double[offset] : 1.0;
+	}
+
+	const int64_t *w;
+	const double_t *w_double;
+};
+
+//! Relabels every community by its smallest vertex, so that the labels do not depend on the order of the updates.
+//! The labels must be vertex ids.
+static void LabelBySmallestVertex(vector<int64_t> &community) {
+	vector<int64_t> smallest(community.size(), -1);
+	for (idx_t i = 0; i < community.size(); i++) {
+		auto &label = smallest[community[i]];
+		if (label < 0) {
+			label = static_cast<int64_t>(i);
+		}
+		community[i] = label;
+	}
+}
+
+//! A pseudo-random but fixed order of the labels of every pass, the tie-break of label propagation. Always taking the
+//! smallest label lets a single label flood a graph of weakly connected dense parts.
+static uint64_t TieBreakRank(int64_t label, int64_t iteration) {
+	auto x = static_cast<uint64_t>(label) ^ (static_cast<uint64_t>(iteration) * 0x9E3779B97F4A7C15ULL);
+	x ^= x >> 33;
+	x *= 0xFF51AFD7ED558CCDULL;
+	x ^= x >> 33;
+	return x;
+}
+
+//! Asynchronous label propagation (Raghavan et al.): every vertex takes the label with the largest weight among its
+//! neighbors, ties are broken in favor of its current label and otherwise by TieBreakRank. The threads update the
+//! labels in place, so later vertices of a pass already see the new labels, until a pass changes no label or
+//! [max_iterations] passes ran.
+template <class ID_T>
+static void LabelPropagation(ClientContext &context, CSR &csr, int64_t max_iterations, vector<int64_t> &community) {
+	auto vertex_count = csr.VertexCount();
+	auto *v = reinterpret_cast<int64_t *>(csr.v.get());
+	auto &e = csr.GetNeighbors<ID_T>();
+	EdgeWeights weights(csr);
+	auto labels = make_uniq<std::atomic<int64_t>[]>(vertex_count);
+	for (idx_t i = 0; i < vertex_count; i++) {
+		labels[i].store(static_cast<int64_t>(i), std::memory_order_relaxed);
+	}
+	for (int64_t iteration = 0; iteration < max_iterations; iteration++) {
+		std::atomic<idx_t> changes(0);
+		ParallelFor(context, vertex_count, COMMUNITY_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+			std::unordered_map<int64_t, double_t> label_weights;
+			idx_t local_changes = 0;
+			for (idx_t i = begin; i < end; i++) {
+				label_weights.clear();
+				for (auto offset = v[i]; offset < v[i + 1]; offset++) {
+					auto neighbor = static_cast<idx_t>(e[offset]);
+					if (neighbor != i) {
+						label_weights[labels[neighbor].load(std::memory_order_relaxed)] += weights(offset);
+					}
+				}
+				if (label_weights.empty()) {
+					continue;
+				}
+				auto current = labels[i].load(std::memory_order_relaxed);
+				auto best = current;
+				auto entry = label_weights.find(current);
+				auto best_weight = entry == label_weights.end() ? -NumericLimits<double_t>::Maximum() : entry->second;
+				for (auto &candidate : label_weights) {
+					if (candidate.second > best_weight ||
+					    (candidate.second == best_weight && best != current &&
+					     TieBreakRank(candidate.first, iteration) < TieBreakRank(best, iteration))) {
+						best = candidate.first;
+						best_weight = candidate.second;
+					}
+				}
+				if (best != current) {
+					labels[i].store(best, std::memory_order_relaxed);
+					local_changes++;
+				}
+			}
+			changes += local_changes;
+		});
+		if (changes == 0) {
+			break;
+		}
+	}
+	community.resize(vertex_count);
+	for (idx_t i = 0; i < vertex_count; i++) {
+		community[i] = labels[i].load(std::memory_order_relaxed);
+	}
+	LabelBySmallestVertex(community);
+}
+
+//! The graph of one Louvain level, symmetric and weighted. The vertices of a level are the communities of the level
+//! below, two of them are connected by the sum of the weights between their members and the weights within a
+//! community become a self loop.
+struct LouvainGraph {
+	idx_t VertexCount() const {
+		return offsets.size() - 1;
+	}
+
+	vector<int64_t> offsets;
+	vector<int64_t> targets;
+	vector<double_t> weights;
+	MemoryReservation memory;
+};
+
+static void AtomicAdd(std::atomic<double_t> &target, double_t value) {
+	auto current = target.load(std::memory_order_relaxed);
+	while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+	}
+}
+
+template <class ID_T>
+static unique_ptr<LouvainGraph> CopyLouvainGraph(ClientContext &context, CSR &csr) {
+	auto vertex_count = csr.VertexCount();
+	auto *v = reinterpret_cast<int64_t *>(csr.v.get());
+	auto &e = csr.GetNeighbors<ID_T>();
+	auto edge_count = static_cast<idx_t>(v[vertex_count]);
+	EdgeWeights weights(csr);
+	auto result = make_uniq<LouvainGraph>();
+	result->memory.Resize(context, (vertex_count + 1) * sizeof(int64_t) +
+	                                   edge_count * (sizeof(int64_t) + sizeof(double_t)));
+	result->offsets.assign(v, v + vertex_count + 1);
+	result->targets.resize(edge_count);
+	result->weights.resize(edge_count);
+	ParallelFor(context, edge_count, COMMUNITY_PARTITION_SIZE * 16, [&](idx_t begin, idx_t end) {
+		for (auto offset = begin; offset < end; offset++) {
+			result->targets[offset] = static_cast<int64_t>(e[offset]);
+			result->weights[offset] = weights(static_cast<int64_t>(offset));
+		}
+	});
+	return result;
+}
+
+//! The local moving phase of a Louvain level. Every vertex moves to the neighboring community that increases the
+//! modularity the most, with the weights towards the neighboring communities summed in a hashmap of the task. The
+//! community totals are updated with atomics and the threads move their vertices concurrently. Two singletons never
+//! move into each other's community in the same pass, only the one with the larger id moves (Lu et al.). Returns
+//! whether any vertex moved, [community] holds the community of every vertex, a vertex id.
+static bool LouvainMove(ClientContext &context, const LouvainGraph &graph, double_t resolution,
+                        int64_t max_iterations, vector<int64_t> &community) {
+	auto vertex_count = graph.VertexCount();
+	vector<double_t> degree(vertex_count);
+	ParallelFor(context, vertex_count, COMMUNITY_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		for (idx_t i = begin; i < end; i++) {
+			double_t sum = 0;
+			for (auto offset = graph.offsets[i]; offset < graph.offsets[i + 1]; offset++) {
+				sum += graph.weights[offset];
+			}
+			degree[i] = sum;
+		}
+	});
+	double_t total_weight = 0;
+	for (auto weight : degree) {
+		total_weight += weight;
+	}
+	community.resize(vertex_count);
+	std::iota(community.begin(), community.end(), 0);
+	if (total_weight <= 0) {
+		return false;
+	}
+
+	auto labels = make_uniq<std::atomic<int64_t>[]>(vertex_count);
+	auto totals = make_uniq<std::atomic<double_t>[]>(vertex_count);
+	auto sizes = make_uniq<std::atomic<int64_t>[]>(vertex_count);
+	for (idx_t i = 0; i < vertex_count; i++) {
+		labels[i].store(static_cast<int64_t>(i), std::memory_order_relaxed);
+		totals[i].store(degree[i], std::memory_order_relaxed);
+		sizes[i].store(1, std::memory_order_relaxed);
+	}
+	bool moved = false;
+	for (int64_t iteration = 0; iteration < max_iterations; iteration++) {
+		std::atomic<idx_t> moves(0);
+		ParallelFor(context, vertex_count, COMMUNITY_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+			std::unordered_map<int64_t, double_t> links;
+			idx_t local_moves = 0;
+			for (idx_t i = begin; i < end; i++) {
+				links.clear();
+				for (auto offset = graph.offsets[i]; offset < graph.offsets[i + 1]; offset++) {
+					auto neighbor = static_cast<idx_t>(graph.targets[offset]);
+					if (neighbor != i) {
+						links[labels[neighbor].load(std::memory_order_relaxed)] += graph.weights[offset];
+					}
+				}
+				auto current = labels[i].load(std::memory_order_relaxed);
+				auto scale = resolution * degree[i] / total_weight;
+				// The gain of joining a community, up to the terms that are the same for all of them
+				auto gain = [&](int64_t target, double_t link_weight) {
+					auto target_total = totals[target].load(std::memory_order_relaxed);
+					if (target == current) {
+						target_total -= degree[i];
+					}
+					return link_weight - scale * target_total;
+				};
+				auto entry = links.find(current);
+				auto best = current;
+				auto best_gain = gain(current, entry == links.end() ? 0.0 : entry->second);
+				for (auto &candidate : links) {
+					if (candidate.first == current) {
+						continue;
+					}
+					auto candidate_gain = gain(candidate.first, candidate.second);
+					if (candidate_gain > best_gain ||
+					    (candidate_gain == best_gain && best != current && candidate.first < best)) {
+						best = candidate.first;
+						best_gain = candidate_gain;
+					}
+				}
+				if (best == current) {
+					continue;
+				}
+				if (sizes[current].load(std::memory_order_relaxed) == 1 &&
+				    sizes[best].load(std::memory_order_relaxed) == 1 && best > current) {
+					continue;
+				}
+				AtomicAdd(totals[current], -degree[i]);
+				AtomicAdd(totals[best], degree[i]);
+				sizes[current].fetch_sub(1, std::memory_order_relaxed);
+				sizes[best].fetch_add(1, std::memory_order_relaxed);
+				labels[i].store(best, std::memory_order_relaxed);
+				local_moves++;
+			}
+			moves += local_moves;
+		});
+		if (moves == 0) {
+			break;
+		}
+		moved = true;
+	}
+	for (idx_t i = 0; i < vertex_count; i++) {
+		community[i] = labels[i].load(std::memory_order_relaxed);
+	}
+	return moved;
+}
+
+//! Numbers the communities from 0 in the order of their first vertex, returns the number of communities
+static idx_t RenumberCommunities(vector<int64_t> &community) {
+	vector<int64_t> number(community.size(), -1);
+	int64_t count = 0;
+	for (auto &label : community) {
+		if (number[label] < 0) {
+			number[label] = count++;
+		}
+		label = number[label];
+	}
+	return static_cast<idx_t>(count);
+}
+
+//! The graph of the next level with one vertex per community of [graph]. The edges of every community are summed in
+//! a hashmap of the task and sorted by target, so the graph does not depend on the scheduling.
+static unique_ptr<LouvainGraph> AggregateLouvainGraph(ClientContext &context, const LouvainGraph &graph,
+                                                      const vector<int64_t> &community, idx_t community_count) {
+	auto vertex_count = graph.VertexCount();
+	vector<idx_t> member_offsets(community_count + 1, 0);
+	for (auto label : community) {
+		member_offsets[label + 1]++;
+	}
+	for (idx_t c = 0; c < community_count; c++) {
+		member_offsets[c + 1] += member_offsets[c];
+	}
+	vector<int64_t> members(vertex_count);
+	vector<idx_t> position(member_offsets.begin(), member_offsets.end() - 1);
+	for (idx_t i = 0; i < vertex_count; i++) {
+		members[position[community[i]]++] = static_cast<int64_t>(i);
+	}
+
+	vector<vector<pair<int64_t, double_t>>> links(community_count);
+	ParallelFor(context, community_count, COMMUNITY_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		std::unordered_map<int64_t, double_t> sums;
+		for (auto c = begin; c < end; c++) {
+			sums.clear();
+			for (auto m = member_offsets[c]; m < member_offsets[c + 1]; m++) {
+				auto member = members[m];
+				for (auto offset = graph.offsets[member]; offset < graph.offsets[member + 1]; offset++) {
+					sums[community[graph.targets[offset]]] += graph.weights[offset];
+				}
+			}
+			links[c].assign(sums.begin(), sums.end());
+			std::sort(links[c].begin(), links[c].end());
+		}
+	});
+
+	auto result = make_uniq<LouvainGraph>();
+	result->offsets.resize(community_count + 1);
+	result->offsets[0] = 0;
+	for (idx_t c = 0; c < community_count; c++) {
+		result->offsets[c + 1] = result->offsets[c] + static_cast<int64_t>(links[c].size());
+	}
+	auto edge_count = static_cast<idx_t>(result->offsets[community_count]);
+	result->memory.Resize(context, (community_count + 1) * sizeof(int64_t) +
+	                                   edge_count * (sizeof(int64_t) + sizeof(double_t)));
+	result->targets.resize(edge_count);
+	result->weights.resize(edge_count);
+	for (idx_t c = 0; c < community_count; c++) {
+		auto offset = result->offsets[c];
+		for (auto &link : links[c]) {
+			result->targets[offset] = link.first;
+			result->weights[offset] = link.second;
+			offset++;
+		}
+	}
+	return result;
+}
+
+//! Louvain (Blondel et al.): the local moving phase groups the vertices of a level into communities, which become the
+//! vertices of the next level, until a level moves no vertex. Every vertex ends up in the community its level-0 vertex
+//! belongs to at the last level.
+template <class ID_T>
+static void Louvain(ClientContext &context, CSR &csr, double_t resolution, int64_t max_iterations,
+                    vector<int64_t> &community) {
+	auto vertex_count = csr.VertexCount();
+	community.resize(vertex_count);
+	std::iota(community.begin(), community.end(), 0);
+	auto graph = CopyLouvainGraph<ID_T>(context, csr);
+	vector<int64_t> level_community;
+	while (LouvainMove(context, *graph, resolution, max_iterations, level_community)) {
+		auto community_count = RenumberCommunities(level_community);
+		ParallelFor(context, vertex_count, COMMUNITY_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+			for (idx_t i = begin; i < end; i++) {
+				community[i] = level_community[community[i]];
+			}
+		});
+		if (community_count == graph->VertexCount()) {
+			break;
+		}
+		graph = AggregateLouvainGraph(context, *graph, level_community, community_count);
+	}
+	LabelBySmallestVertex(community);
+}
+
+template <void (*COMPUTE_COMPACT)(ClientContext &, CSR &, CommunityDetectionFunctionData &),
+          void (*COMPUTE)(ClientContext &, CSR &, CommunityDetectionFunctionData &)>
+static void CommunityDetectionFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<CommunityDetectionFunctionData>();
+	auto duckpgq_state = GetDuckPGQState(info.context);
+
+	auto csr_entry = duckpgq_state->csr_list.find(info.csr_id);
+	if (csr_entry == duckpgq_state->csr_list.end()) {
+		throw ConstraintException("CSR not found. Is the graph populated?");
+	}
+
+	if (!(csr_entry->second->initialized_v && csr_entry->second->initialized_e)) {
+		throw ConstraintException("Need to initialize CSR before detecting communities.");
+	}
+
+	auto &csr = *csr_entry->second;
+	csr.LoadPartitions(info.context);
+	auto vertex_count = static_cast<int64_t>(csr.VertexCount());
+
+	// The threads that arrive while the communities are detected work on its passes instead of waiting
+	info.once.Run([&]() {
+		if (csr.compact) {
+			COMPUTE_COMPACT(info.context, csr, info);
+		} else {
+			COMPUTE(info.context, csr, info);
+		}
+	});
+
+	auto &src = args.data[1];
+	UnifiedVectorFormat vdata_src;
+	src.ToUnifiedFormat(args.size(), vdata_src);
+	auto src_data = UnifiedVectorFormat::GetData<int64_t>(vdata_src);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<int64_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	for (idx_t i = 0; i < args.size(); i++) {
+		auto id_pos = vdata_src.sel->get_index(i);
+		if (!vdata_src.validity.RowIsValid(id_pos)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		auto node_id = csr.InternalId(src_data[id_pos]);
+		if (node_id < 0 || node_id >= vertex_count) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		// Communities are labeled by the rowid of one of their vertices
+		result_data[i] = csr.ExternalId(info.community[node_id]);
+	}
+
+	duckpgq_state->csr_to_delete.insert(info.csr_id);
+}
+
+template <class ID_T>
+static void ComputeLabelPropagation(ClientContext &context, CSR &csr, CommunityDetectionFunctionData &info) {
+	LabelPropagation<ID_T>(context, csr, info.max_iterations, info.community);
+}
+
+template <class ID_T>
+static void ComputeLouvain(ClientContext &context, CSR &csr, CommunityDetectionFunctionData &info) {
+	Louvain<ID_T>(context, csr, info.resolution, info.max_iterations, info.community);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterCommunityDetectionScalarFunctions(ExtensionLoader &loader) {
+	ScalarFunctionSet label_propagation("label_propagation");
+	ScalarFunction label_propagation_function(
+	    {LogicalType::INTEGER, LogicalType::BIGINT}, LogicalType::BIGINT,
+	    CommunityDetectionFunction<ComputeLabelPropagation<int32_t>, ComputeLabelPropagation<int64_t>>,
+	    CommunityDetectionFunctionData::CommunityDetectionBind);
+	label_propagation.AddFunction(label_propagation_function);
+	// Maximum number of passes
+	label_propagation_function.arguments.push_back(LogicalType::BIGINT);
+	label_propagation.AddFunction(label_propagation_function);
+	loader.RegisterFunction(label_propagation);
+
+	ScalarFunctionSet louvain("louvain");
+	ScalarFunction louvain_function({LogicalType::INTEGER, LogicalType::BIGINT}, LogicalType::BIGINT,
+	                                CommunityDetectionFunction<ComputeLouvain<int32_t>, ComputeLouvain<int64_t>>,
+	                                CommunityDetectionFunctionData::CommunityDetectionBind);
+	louvain.AddFunction(louvain_function);
+	// Resolution and maximum number of passes of every level
+	louvain_function.arguments.push_back(LogicalType::DOUBLE);
+	louvain_function.arguments.push_back(LogicalType::BIGINT);
+	louvain.AddFunction(louvain_function);
+	loader.RegisterFunction(louvain);
+}
+
+} // namespace duckdb
@@ -3,15 +3,19 @@
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckpgq/common.hpp"
 #include "duckpgq/core/utils/compressed_sparse_row.hpp"
+#include "duckpgq/core/utils/partitioned_csr.hpp"
 #include <cmath>
 #include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/duckpgq_parallel.hpp>
 #include <duckpgq/core/utils/duckpgq_utils.hpp>
+#include <duckpgq/core/utils/traversal_metrics.hpp>
 #include <duckpgq_extension.hpp>
+#include <algorithm>
 #include <mutex>
 
 namespace duckdb {
 
-static void CsrInitializeVertex(DuckPGQState &context, int32_t id, int64_t v_size) {
+static void CsrInitializeVertex(ClientContext &client_context, DuckPGQState &context, int32_t id, int64_t v_size) {
 	lock_guard<mutex> csr_init_lock(context.csr_lock);
 
 	auto csr_entry = context.csr_list.find(id);
@@ -21,7 +25,9 @@ static void CsrInitializeVertex(DuckPGQState &context, int32_t id, int64_t v_siz
 		}
 	}
 	try {
-		auto csr = make_uniq<CSR>();
+		auto csr = make_shared_ptr<CSR>();
+		csr->build_start = std::chrono::steady_clock::now();
+		csr->ReserveMemory(client_context, (v_size + 2) * sizeof(std::atomic<int64_t>));
 		// extra 2 spaces required for CSR padding
 		// data contains a vector of elements so will need an anonymous function to
 		// apply the first element id is repeated across, can I access the value
@@ -40,33 +46,90 @@ static void CsrInitializeVertex(DuckPGQState &context, int32_t id, int64_t v_siz
 	}
 }
 
-static void CsrInitializeEdge(DuckPGQState &context, int32_t id, int64_t v_size, int64_t e_size) {
+//! Number of entries of v a task of PrefixSum scans
+static constexpr idx_t PREFIX_SUM_BLOCK_SIZE = 1 << 16;
+
+//! Replaces the first [count] entries of [v] by their inclusive prefix sums. The blocks of the array are summed in
+//! parallel, a serial scan over the block sums gives the offset of every block and a second parallel pass scans the
+//! blocks from their offsets.
+static void PrefixSum(ClientContext &context, atomic<int64_t> *v, idx_t count) {
+	auto block_count = (count + PREFIX_SUM_BLOCK_SIZE - 1) / PREFIX_SUM_BLOCK_SIZE;
+	vector<int64_t> block_offsets(block_count + 1, 0);
+	ParallelFor(context, block_count, 1, [&](idx_t begin, idx_t end) {
+		for (auto block = begin; block < end; block++) {
+			int64_t sum = 0;
+			auto block_end = MinValue<idx_t>((block + 1) * PREFIX_SUM_BLOCK_SIZE, count);
+			for (auto i = block * PREFIX_SUM_BLOCK_SIZE; i < block_end; i++) {
+				sum += v[i].load(std::memory_order_relaxed);
+			}
+			block_offsets[block + 1] = sum;
+		}
+	});
+	for (idx_t block = 0; block < block_count; block++) {
+		block_offsets[block + 1] += block_offsets[block];
+	}
+	ParallelFor(context, block_count, 1, [&](idx_t begin, idx_t end) {
+		for (auto block = begin; block < end; block++) {
+			auto sum = block_offsets[block];
+			auto block_end = MinValue<idx_t>((block + 1) * PREFIX_SUM_BLOCK_SIZE, count);
+			for (auto i = block * PREFIX_SUM_BLOCK_SIZE; i < block_end; i++) {
+				sum += v[i].load(std::memory_order_relaxed);
+				v[i].store(sum, std::memory_order_relaxed);
+			}
+		}
+	});
+}
+
+//! [edges_per_partition] > 0 stores the edges in CSRPartitions instead of e and edge_ids, [labeled] allocates a label
+//! id per edge and [symmetric] inserts every edge under both endpoints
+static void CsrInitializeEdge(ClientContext &client_context, DuckPGQState &context, int32_t id, int64_t v_size,
+                              int64_t e_size, idx_t edges_per_partition, bool labeled, bool symmetric) {
 	const lock_guard<mutex> csr_init_lock(context.csr_lock);
 
 	auto csr_entry = context.csr_list.find(id);
 	if (csr_entry->second->initialized_e) {
 		return;
 	}
+	csr_entry->second->symmetric = symmetric;
+	PrefixSum(client_context, csr_entry->second->v.get(), static_cast<idx_t>(v_size) + 2);
+	if (edges_per_partition > 0) {
+		csr_entry->second->Partition(client_context, edges_per_partition);
+		csr_entry->second->initialized_e = true;
+		return;
+	}
+	csr_entry->second->ReserveMemory(client_context,
+	                                 e_size * (2 * sizeof(int64_t) + (labeled ? sizeof(uint8_t) : 0)));
 	try {
 		csr_entry->second->e.resize(e_size, 0);
 		csr_entry->second->edge_ids.resize(e_size, 0);
+		if (labeled) {
+			csr_entry->second->edge_labels.resize(e_size, 0);
+		}
 	} catch (std::bad_alloc const &) {
 		throw Exception(ExceptionType::INTERNAL, "Unable to initialize vector of size for csr edge table "
 		                                         "representation");
 	}
-	for (auto i = 1; i < v_size + 2; i++) {
-		csr_entry->second->v[i] += csr_entry->second->v[i - 1];
-	}
 	csr_entry->second->initialized_e = true;
 }
 
-static void CsrInitializeWeight(DuckPGQState &context, int32_t id, int64_t e_size, PhysicalType weight_type) {
+static idx_t GetCSRPartitionSize(ClientContext &context) {
+	Value partition_size;
+	if (!context.TryGetCurrentSetting("duckpgq_csr_partition_size", partition_size) || partition_size.IsNull()) {
+		return 0;
+	}
+	auto result = partition_size.GetValue<int64_t>();
+	return result < 0 ? 0 : static_cast<idx_t>(result);
+}
+
+static void CsrInitializeWeight(ClientContext &client_context, DuckPGQState &context, int32_t id, int64_t e_size,
+                                PhysicalType weight_type) {
 	const lock_guard<mutex> csr_init_lock(context.csr_lock);
 	auto csr_entry = context.csr_list.find(id);
 
 	if (csr_entry->second->initialized_w) {
 		return;
 	}
+	csr_entry->second->ReserveMemory(client_context, e_size * sizeof(int64_t));
 	try {
 		if (weight_type == PhysicalType::INT64) {
 			csr_entry->second->w.resize(e_size, 0);
@@ -92,11 +155,11 @@ static void CreateCsrVertexFunction(DataChunk &args, ExpressionState &state, Vec
 	auto csr_entry = duckpgq_state->csr_list.find(info.id);
 
 	if (csr_entry == duckpgq_state->csr_list.end()) {
-		CsrInitializeVertex(*duckpgq_state, info.id, input_size);
+		CsrInitializeVertex(info.context, *duckpgq_state, info.id, input_size);
 		csr_entry = duckpgq_state->csr_list.find(info.id);
 	} else {
 		if (!csr_entry->second->initialized_v) {
-			CsrInitializeVertex(*duckpgq_state, info.id, input_size);
+			CsrInitializeVertex(info.context, *duckpgq_state, info.id, input_size);
 		}
 	}
 
@@ -109,6 +172,186 @@ static void CreateCsrVertexFunction(DataChunk &args, ExpressionState &state, Vec
 	                                                   });
 }
 
+// Counts the edges of one chunk into the degrees of their sources, v[source + 2], which CsrInitializeEdge turns into
+// the list offsets. The rows are sorted by source first, so every distinct source of the chunk takes a single
+// fetch_add. The optional argument 3 is the key of the edge: a row where it is NULL is a vertex without edges, which
+// only makes sure the CSR exists. Returns the number of edges counted by a row.
+static void CreateCsrDegreeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<CSRFunctionData>();
+
+	auto duckpgq_state = GetDuckPGQState(info.context);
+	auto csr_entry = duckpgq_state->csr_list.find(info.id);
+	if (csr_entry == duckpgq_state->csr_list.end() || !csr_entry->second->initialized_v) {
+		CsrInitializeVertex(info.context, *duckpgq_state, info.id, args.data[1].GetValue(0).GetValue<int64_t>());
+		csr_entry = duckpgq_state->csr_list.find(info.id);
+	}
+	auto &csr = *csr_entry->second;
+
+	auto count = args.size();
+	UnifiedVectorFormat vertex_data, key_data;
+	args.data[2].ToUnifiedFormat(count, vertex_data);
+	auto keyed = args.ColumnCount() > 3;
+	if (keyed) {
+		args.data[3].ToUnifiedFormat(count, key_data);
+	}
+	auto vertices = UnifiedVectorFormat::GetData<int64_t>(vertex_data);
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<int64_t>(result);
+
+	vector<int64_t> sources;
+	sources.reserve(count);
+	for (idx_t i = 0; i < count; i++) {
+		auto vertex_idx = vertex_data.sel->get_index(i);
+		result_data[i] = 0;
+		if (!vertex_data.validity.RowIsValid(vertex_idx) ||
+		    (keyed && !key_data.validity.RowIsValid(key_data.sel->get_index(i)))) {
+			continue;
+		}
+		auto vertex = vertices[vertex_idx];
+		if (vertex < 0 || static_cast<idx_t>(vertex) + 2 >= csr.vsize) {
+			continue;
+		}
+		sources.push_back(vertex);
+		result_data[i] = 1;
+	}
+	std::sort(sources.begin(), sources.end());
+	idx_t run_start = 0;
+	while (run_start < sources.size()) {
+		idx_t run_end = run_start + 1;
+		while (run_end < sources.size() && sources[run_end] == sources[run_start]) {
+			run_end++;
+		}
+		csr.v[sources[run_start] + 2].fetch_add(static_cast<int64_t>(run_end - run_start));
+		run_start = run_end;
+	}
+}
+
+//! Adds the build of [csr], from its first create_csr_vertex call until it was finalized, to the TraversalMetrics
+static void RecordCSRBuild(ClientContext &context, const CSR &csr) {
+	TraversalCounters counters;
+	counters.calls = 1;
+	counters.edges = csr.EdgeCount();
+	auto elapsed = std::chrono::steady_clock::now() - csr.build_start;
+	counters.microseconds = static_cast<idx_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+	TraversalMetrics::Get(context)->Add(TraversalKernel::CSR_BUILD, counters);
+}
+
+// Inserts the edges of one chunk. Instead of an atomic increment per edge, the edges are grouped by source first,
+// so every distinct source of the chunk reserves its range in the adjacency list with a single fetch_add. The
+// optional argument 7 is either the weight or, for a labeled CSR, the label id of the edge. A symmetric CSR also
+// inserts every row from its destination to its source in the same pass, except for self loops.
+template <class W>
+static void InsertEdges(CSR &csr, ClientContext &context, DataChunk &args, vector<W> *weights, Vector &result) {
+	auto count = args.size();
+	auto labeled = csr.IsLabeled();
+	UnifiedVectorFormat src_data, dst_data, edge_data, weight_data;
+	args.data[4].ToUnifiedFormat(count, src_data);
+	args.data[5].ToUnifiedFormat(count, dst_data);
+	args.data[6].ToUnifiedFormat(count, edge_data);
+	if (weights || labeled) {
+		args.data[7].ToUnifiedFormat(count, weight_data);
+	}
+	auto src = UnifiedVectorFormat::GetData<int64_t>(src_data);
+	auto dst = UnifiedVectorFormat::GetData<int64_t>(dst_data);
+	auto edge_ids = UnifiedVectorFormat::GetData<int64_t>(edge_data);
+	auto weight_values = weights ? UnifiedVectorFormat::GetData<W>(weight_data) : nullptr;
+	auto label_values = labeled ? UnifiedVectorFormat::GetData<uint8_t>(weight_data) : nullptr;
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<int32_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+
+	// An entry is a row shifted left by one, with the lowest bit set for the row inserted from its destination
+	auto row_of = [](idx_t entry) {
+		return entry >> 1;
+	};
+	auto source_of = [&](idx_t entry) {
+		auto row = row_of(entry);
+		return (entry & 1) ? dst[dst_data.sel->get_index(row)] : src[src_data.sel->get_index(row)];
+	};
+	auto target_of = [&](idx_t entry) {
+		auto row = row_of(entry);
+		return (entry & 1) ? src[src_data.sel->get_index(row)] : dst[dst_data.sel->get_index(row)];
+	};
+
+	// Entries ordered by source, rows with a NULL are not inserted
+	vector<idx_t> order;
+	order.reserve(csr.symmetric ? 2 * count : count);
+	for (idx_t i = 0; i < count; i++) {
+		auto src_idx = src_data.sel->get_index(i);
+		auto dst_idx = dst_data.sel->get_index(i);
+		auto edge_idx = edge_data.sel->get_index(i);
+		bool valid = src_data.validity.RowIsValid(src_idx) && dst_data.validity.RowIsValid(dst_idx) &&
+		             edge_data.validity.RowIsValid(edge_idx);
+		if (weights || labeled) {
+			valid = valid && weight_data.validity.RowIsValid(weight_data.sel->get_index(i));
+		}
+		if (!valid) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		order.push_back(i << 1);
+		result_data[i] = 0;
+		if (csr.symmetric && src[src_idx] != dst[dst_idx]) {
+			order.push_back((i << 1) | 1);
+		}
+	}
+	std::sort(order.begin(), order.end(), [&](idx_t a, idx_t b) { return source_of(a) < source_of(b); });
+
+	// The runs are in source order, consecutive runs mostly fall into the same partition
+	auto partitions = csr.GetPartitions();
+	unique_ptr<CSRPartitionHandle> partition_handle;
+	idx_t pinned_partition = DConstants::INVALID_INDEX;
+	idx_t run_start = 0;
+	while (run_start < order.size()) {
+		auto source = source_of(order[run_start]);
+		idx_t run_end = run_start + 1;
+		while (run_end < order.size() && source_of(order[run_end]) == source) {
+			run_end++;
+		}
+		auto pos = csr.v[source + 1].fetch_add(static_cast<int64_t>(run_end - run_start));
+		if (partitions) {
+			auto partition = partitions->PartitionOf(source);
+			if (partition != pinned_partition) {
+				partition_handle = make_uniq<CSRPartitionHandle>(partitions->Pin(partition));
+				pinned_partition = partition;
+			}
+			for (idx_t i = run_start; i < run_end; i++, pos++) {
+				auto row = row_of(order[i]);
+				partition_handle->SetEdge(pos, target_of(order[i]), edge_ids[edge_data.sel->get_index(row)]);
+				result_data[row]++;
+			}
+			run_start = run_end;
+			continue;
+		}
+		for (idx_t i = run_start; i < run_end; i++, pos++) {
+			auto row = row_of(order[i]);
+			csr.e[pos] = target_of(order[i]);
+			csr.edge_ids[pos] = edge_ids[edge_data.sel->get_index(row)];
+			if (labeled) {
+				csr.edge_labels[pos] = label_values[weight_data.sel->get_index(row)];
+			}
+			if (weights) {
+				auto weight = weight_values[weight_data.sel->get_index(row)];
+				(*weights)[pos] = weight;
+				result_data[row] = static_cast<int32_t>(weight);
+			} else {
+				// The number of adjacency entries of the row
+				result_data[row]++;
+			}
+		}
+		run_start = run_end;
+	}
+	auto inserted = csr.inserted_edges.fetch_add(static_cast<int64_t>(order.size())) + order.size();
+	partition_handle.reset();
+	if (inserted == csr.EdgeCount()) {
+		// This thread inserted the last edge, every other thread is done writing
+		csr.Finalize(context);
+		RecordCSRBuild(context, csr);
+	}
+}
+
 static void CreateCsrEdgeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
 	auto &info = func_expr.bind_info->Cast<CSRFunctionData>();
@@ -126,45 +369,48 @@ static void CreateCsrEdgeFunction(DataChunk &args, ExpressionState &state, Vecto
 
 	auto csr_entry = duckpgq_state->csr_list.find(info.id);
 	if (!csr_entry->second->initialized_e) {
-		CsrInitializeEdge(*duckpgq_state, info.id, vertex_size, edge_size);
+		// Only unweighted CSRs are partitioned, the kernels on weighted and labeled ones index the weights and labels
+		// by CSR offset
+		auto edges_per_partition =
+		    info.weight_type == LogicalType::SQLNULL && !info.labeled ? GetCSRPartitionSize(info.context) : 0;
+		CsrInitializeEdge(info.context, *duckpgq_state, info.id, vertex_size, edge_size, edges_per_partition,
+		                  info.labeled, info.symmetric);
 	}
+	auto &csr = *csr_entry->second;
 	if (info.weight_type == LogicalType::SQLNULL) {
-		TernaryExecutor::Execute<int64_t, int64_t, int64_t, int32_t>(
-		    args.data[4], args.data[5], args.data[6], result, args.size(),
-		    [&](int64_t src, int64_t dst, int64_t edge_id) {
-			    auto pos = ++csr_entry->second->v[src + 1];
-			    csr_entry->second->e[(int64_t)pos - 1] = dst;
-			    csr_entry->second->edge_ids[(int64_t)pos - 1] = edge_id;
-			    return 1;
-		    });
+		InsertEdges<int64_t>(csr, info.context, args, nullptr, result);
 		return;
 	}
 	auto weight_type = args.data[7].GetType().InternalType();
-	if (!csr_entry->second->initialized_w) {
-		CsrInitializeWeight(*duckpgq_state, info.id, edge_size, weight_type);
+	if (!csr.initialized_w) {
+		CsrInitializeWeight(info.context, *duckpgq_state, info.id, edge_size, weight_type);
 	}
 	if (weight_type == PhysicalType::INT64) {
-		QuaternaryExecutor::Execute<int64_t, int64_t, int64_t, int64_t, int32_t>(
-		    args.data[4], args.data[5], args.data[6], args.data[7], result, args.size(),
-		    [&](int64_t src, int64_t dst, int64_t edge_id, int64_t weight) {
-			    auto pos = ++csr_entry->second->v[src + 1];
-			    csr_entry->second->e[(int64_t)pos - 1] = dst;
-			    csr_entry->second->edge_ids[(int64_t)pos - 1] = edge_id;
-			    csr_entry->second->w[(int64_t)pos - 1] = weight;
-			    return weight;
-		    });
+		InsertEdges<int64_t>(csr, info.context, args, &csr.w, result);
 		return;
 	}
+	InsertEdges<double_t>(csr, info.context, args, &csr.w_double, result);
+}
 
-	QuaternaryExecutor::Execute<int64_t, int64_t, int64_t, double_t, int32_t>(
-	    args.data[4], args.data[5], args.data[6], args.data[7], result, args.size(),
-	    [&](int64_t src, int64_t dst, int64_t edge_id, double_t weight) {
-		    auto pos = ++csr_entry->second->v[src + 1];
-		    csr_entry->second->e[(int64_t)pos - 1] = dst;
-		    csr_entry->second->edge_ids[(int64_t)pos - 1] = edge_id;
-		    csr_entry->second->w_double[(int64_t)pos - 1] = weight;
-		    return weight;
-	    });
+// Installs the CSR of the incoming edges of CSR [id] under the id in argument 1, for the path-finding functions that
+// follow the edges backwards. The reverse is kept with the CSR, so a cached CSR brings its reverse along. Argument 2
+// only orders the call after the edges of the CSR have been inserted.
+static void CreateCsrReverseFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<CSRFunctionData>();
+	auto duckpgq_state = GetDuckPGQState(info.context);
+	auto reverse_id = args.data[1].GetValue(0).GetValue<int32_t>();
+	{
+		lock_guard<mutex> csr_lock(duckpgq_state->csr_lock);
+		auto csr_entry = duckpgq_state->csr_list.find(info.id);
+		// A graph without edges has no CSR, neither direction
+		if (csr_entry != duckpgq_state->csr_list.end()) {
+			duckpgq_state->csr_list[reverse_id] = csr_entry->second->GetReverseCSR(info.context);
+			duckpgq_state->csr_to_delete.insert(reverse_id);
+		}
+	}
+	result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	ConstantVector::GetData<int64_t>(result)[0] = 0;
 }
 
 ScalarFunctionSet GetCSRVertexFunction() {
@@ -177,6 +423,19 @@ ScalarFunctionSet GetCSRVertexFunction() {
 	return set;
 }
 
+ScalarFunctionSet GetCSRDegreeFunction() {
+	ScalarFunctionSet set("create_csr_degree");
+	// csr_id, vertex size, source rowid of an edge
+	set.AddFunction(ScalarFunction("create_csr_degree",
+	                               {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT},
+	                               LogicalType::BIGINT, CreateCsrDegreeFunction, CSRFunctionData::CSRBind));
+	// and the key of the edge, NULL for a vertex without edges
+	set.AddFunction(ScalarFunction("create_csr_degree",
+	                               {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::ANY},
+	                               LogicalType::BIGINT, CreateCsrDegreeFunction, CSRFunctionData::CSRBind));
+	return set;
+}
+
 ScalarFunctionSet GetCSREdgeFunction() {
 	ScalarFunctionSet set("create_csr_edge");
 	/* 1. CSR ID
@@ -186,7 +445,7 @@ ScalarFunctionSet GetCSREdgeFunction() {
 	 * 4. source rowid
 	 * 5. destination rowid
 	 * 6. edge rowid
-	 * 7. <optional> edge weight (INT OR DOUBLE)
+	 * 7. <optional> edge weight (INT OR DOUBLE) or label id (UTINYINT)
 	 */
 
 	//! No edge weight
@@ -199,6 +458,12 @@ ScalarFunctionSet GetCSREdgeFunction() {
 	                                LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
 	                               LogicalType::INTEGER, CreateCsrEdgeFunction, CSRFunctionData::CSREdgeBind));
 
+	//! Label id of the edge
+	set.AddFunction(ScalarFunction({LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT,
+	                                LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT,
+	                                LogicalType::UTINYINT},
+	                               LogicalType::INTEGER, CreateCsrEdgeFunction, CSRFunctionData::CSREdgeBind));
+
 	//! Double for edge weight
 	set.AddFunction(ScalarFunction({LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT,
 	                                LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::DOUBLE},
@@ -207,12 +472,26 @@ ScalarFunctionSet GetCSREdgeFunction() {
 	return set;
 }
 
+//! create_csr_edge without weights for an undirected CSR, every row is inserted under both of its endpoints
+ScalarFunction GetCSRUndirectedEdgeFunction() {
+	return ScalarFunction("create_csr_undirected_edge",
+	                      {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT,
+	                       LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
+	                      LogicalType::INTEGER, CreateCsrEdgeFunction, CSRFunctionData::CSRUndirectedEdgeBind);
+}
+
 //------------------------------------------------------------------------------
 // Register functions
 //------------------------------------------------------------------------------
 void CoreScalarFunctions::RegisterCSRCreationScalarFunctions(ExtensionLoader &loader) {
 	loader.RegisterFunction(GetCSREdgeFunction());
+	loader.RegisterFunction(GetCSRUndirectedEdgeFunction());
 	loader.RegisterFunction(GetCSRVertexFunction());
+	loader.RegisterFunction(GetCSRDegreeFunction());
+	// csr_id, id of the reverse, a value computed from the CSR
+	loader.RegisterFunction(ScalarFunction("create_csr_reverse",
+	                                       {LogicalType::INTEGER, LogicalType::INTEGER, LogicalType::BIGINT},
+	                                       LogicalType::BIGINT, CreateCsrReverseFunction, CSRFunctionData::CSRBind));
 }
 
 } // namespace duckdb
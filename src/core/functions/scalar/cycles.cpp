@@ -0,0 +1,174 @@
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/iterative_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+#include <algorithm>
+
+namespace duckdb {
+
+//! Enumerates the closed walks of a fixed number of edges from one source with Generic Join, binding the vertices
+//! in the order v0, v1, ..., v(k-1). Every vertex but the last one only has to be adjacent to its predecessor and is
+//! expanded along the outgoing edges. The last one closes the cycle, so it is the intersection of the outgoing list
+//! of v(k-2) with the incoming list of v0, which is found by merging the two sorted lists instead of joining the
+//! edge table once more.
+template <class ID_T>
+class CycleJoin {
+public:
+	CycleJoin(CSR &csr, CSR &reverse, idx_t length)
+	    : ranges(csr.GetRanges()), e(csr.GetNeighbors<ID_T>()), edge_ids(csr.edge_ids),
+	      rv(reinterpret_cast<int64_t *>(reverse.v.get())), re(reverse.GetNeighbors<ID_T>()),
+	      reverse_edge_ids(reverse.edge_ids), sorted(csr.sorted), length(length) {
+	}
+
+	//! Appends the cycles through [source] to [cycles], each as v0, e0, v1, e1, ..., v(k-1), e(k-1) where e(k-1)
+	//! leads back to v0
+	void Run(int64_t source, vector<int64_t> &cycles) {
+		walk.clear();
+		walk.push_back(source);
+		Expand(source, cycles);
+	}
+
+private:
+	void Expand(int64_t vertex, vector<int64_t> &cycles) {
+		// walk holds v0, e0, ..., vertex, the cycle is closed from v(k-2)
+		if (walk.size() == 2 * length - 3) {
+			Close(vertex, cycles);
+			return;
+		}
+		for (auto offset = ranges.begin[vertex]; offset < ranges.end[vertex]; offset++) {
+			auto neighbor = static_cast<int64_t>(e[offset]);
+			walk.push_back(edge_ids[offset]);
+			walk.push_back(neighbor);
+			Expand(neighbor, cycles);
+			walk.resize(walk.size() - 2);
+		}
+	}
+
+	void Close(int64_t vertex, vector<int64_t> &cycles) {
+		auto source = walk[0];
+		outgoing.clear();
+		for (auto offset = ranges.begin[vertex]; offset < ranges.end[vertex]; offset++) {
+			outgoing.emplace_back(static_cast<int64_t>(e[offset]), edge_ids[offset]);
+		}
+		if (!sorted) {
+			std::sort(outgoing.begin(), outgoing.end());
+		}
+		// Incoming lists are in source order, the reverse CSR is built by a counting sort over the sources
+		idx_t i = 0;
+		auto j = rv[source];
+		while (i < outgoing.size() && j < rv[source + 1]) {
+			auto neighbor = outgoing[i].first;
+			auto incoming = static_cast<int64_t>(re[j]);
+			if (neighbor < incoming) {
+				i++;
+				continue;
+			}
+			if (incoming < neighbor) {
+				j++;
+				continue;
+			}
+			// Every pair of parallel edges into and out of the common neighbor closes a cycle
+			auto i_end = i;
+			while (i_end < outgoing.size() && outgoing[i_end].first == neighbor) {
+				i_end++;
+			}
+			auto j_end = j;
+			while (j_end < rv[source + 1] && static_cast<int64_t>(re[j_end]) == neighbor) {
+				j_end++;
+			}
+			for (auto out = i; out < i_end; out++) {
+				for (auto in = j; in < j_end; in++) {
+					cycles.insert(cycles.end(), walk.begin(), walk.end());
+					cycles.push_back(outgoing[out].second);
+					cycles.push_back(neighbor);
+					cycles.push_back(reverse_edge_ids[in]);
+				}
+			}
+			i = i_end;
+			j = j_end;
+		}
+	}
+
+	CSRRanges ranges;
+	const vector<ID_T> &e;
+	const vector<int64_t> &edge_ids;
+	const int64_t *rv;
+	const vector<ID_T> &re;
+	const vector<int64_t> &reverse_edge_ids;
+	bool sorted;
+	idx_t length;
+	vector<int64_t> walk;
+	vector<pair<int64_t, int64_t>> outgoing;
+};
+
+template <class ID_T>
+static void CyclesInternal(ClientContext &context, CSR &csr, int64_t v_size, idx_t count,
+                           const UnifiedVectorFormat &vdata_src, const int64_t *src_data, idx_t length,
+                           vector<int64_t> &cycles, vector<idx_t> &row_offsets, ValidityMask &result_validity) {
+	CycleJoin<ID_T> join(csr, csr.GetReverse(context), length);
+	row_offsets.assign(1, 0);
+	for (idx_t row = 0; row < count; row++) {
+		auto src_pos = vdata_src.sel->get_index(row);
+		if (!vdata_src.validity.RowIsValid(src_pos)) {
+			result_validity.SetInvalid(row);
+		} else if (src_data[src_pos] >= 0 && src_data[src_pos] < v_size) {
+			join.Run(src_data[src_pos], cycles);
+		}
+		row_offsets.push_back(cycles.size());
+	}
+}
+
+static void CyclesFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
+	UnifiedVectorFormat vdata_src;
+	UnifiedVectorFormat vdata_length;
+	args.data[2].ToUnifiedFormat(args.size(), vdata_src);
+	args.data[3].ToUnifiedFormat(args.size(), vdata_length);
+	auto length_pos = vdata_length.sel->get_index(0);
+	if (!vdata_length.validity.RowIsValid(length_pos) ||
+	    UnifiedVectorFormat::GetData<int32_t>(vdata_length)[length_pos] < 2) {
+		throw InvalidInputException("cycles needs a cycle length of at least 2");
+	}
+	auto length = static_cast<idx_t>(UnifiedVectorFormat::GetData<int32_t>(vdata_length)[length_pos]);
+
+	auto &local_state = PathFunctionLocalState::Get(state);
+	auto &csr = local_state.Bind(info.context, info.csr_id, true);
+	auto v_size = local_state.VertexCount();
+	auto src_data = csr.InternalIds(vdata_src, args.size(), local_state.source_ids);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto &result_validity = FlatVector::Validity(result);
+	vector<int64_t> cycles;
+	vector<idx_t> row_offsets;
+	if (csr.compact) {
+		CyclesInternal<int32_t>(info.context, csr, v_size, args.size(), vdata_src, src_data, length, cycles,
+		                        row_offsets, result_validity);
+	} else {
+		CyclesInternal<int64_t>(info.context, csr, v_size, args.size(), vdata_src, src_data, length, cycles,
+		                        row_offsets, result_validity);
+	}
+	csr.ExternalPathIds(cycles);
+
+	// Every cycle is a list of 2 * length ids, every row the list of its cycles
+	SetNestedListResult(result, args.size(), cycles, 2 * length, row_offsets);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterCyclesScalarFunction(ExtensionLoader &loader) {
+	// csr_id, vertex count, source, cycle length
+	ScalarFunction function("cycles",
+	                        {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::INTEGER},
+	                        LogicalType::LIST(LogicalType::LIST(LogicalType::BIGINT)), CyclesFunction,
+	                        IterativeLengthFunctionData::IterativeLengthBind);
+	function.init_local_state = PathFunctionLocalState::Init;
+	loader.RegisterFunction(function);
+}
+
+} // namespace duckdb
@@ -0,0 +1,114 @@
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/iterative_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+//! Enumerates the walks of a fixed number of hops from one source by following the adjacency lists of the CSR, the
+//! lowering of a chain of fixed-length MATCH hops that needs no join with the edge table
+template <class ID_T>
+class HopExpansion {
+public:
+	HopExpansion(CSR &csr, idx_t hops)
+	    : csr(csr), ranges(csr.GetRanges()), e(csr.GetNeighbors<ID_T>()), edge_ids(csr.edge_ids), hops(hops) {
+	}
+
+	//! Appends the walks from [source] to [walks], each as v0, e0, v1, ..., e(k-1), vk with external vertex ids
+	void Run(int64_t source, vector<int64_t> &walks) {
+		walk.clear();
+		walk.push_back(source);
+		Expand(source, walks);
+	}
+
+private:
+	void Expand(int64_t vertex, vector<int64_t> &walks) {
+		if (walk.size() == 2 * hops + 1) {
+			for (idx_t i = 0; i < walk.size(); i++) {
+				walks.push_back(i % 2 == 0 ? csr.ExternalId(walk[i]) : walk[i]);
+			}
+			return;
+		}
+		for (auto offset = ranges.begin[vertex]; offset < ranges.end[vertex]; offset++) {
+			auto neighbor = static_cast<int64_t>(e[offset]);
+			walk.push_back(edge_ids[offset]);
+			walk.push_back(neighbor);
+			Expand(neighbor, walks);
+			walk.resize(walk.size() - 2);
+		}
+	}
+
+	CSR &csr;
+	CSRRanges ranges;
+	const vector<ID_T> &e;
+	const vector<int64_t> &edge_ids;
+	idx_t hops;
+	vector<int64_t> walk;
+};
+
+template <class ID_T>
+static void ExpandInternal(CSR &csr, int64_t v_size, idx_t count, const UnifiedVectorFormat &vdata_src,
+                           const int64_t *src_data, idx_t hops, vector<int64_t> &walks, vector<idx_t> &row_offsets,
+                           ValidityMask &result_validity) {
+	HopExpansion<ID_T> expansion(csr, hops);
+	row_offsets.assign(1, 0);
+	for (idx_t row = 0; row < count; row++) {
+		auto src_pos = vdata_src.sel->get_index(row);
+		if (!vdata_src.validity.RowIsValid(src_pos)) {
+			result_validity.SetInvalid(row);
+		} else if (src_data[src_pos] >= 0 && src_data[src_pos] < v_size) {
+			expansion.Run(src_data[src_pos], walks);
+		}
+		row_offsets.push_back(walks.size());
+	}
+}
+
+static void ExpandFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
+	UnifiedVectorFormat vdata_src;
+	UnifiedVectorFormat vdata_hops;
+	args.data[2].ToUnifiedFormat(args.size(), vdata_src);
+	args.data[3].ToUnifiedFormat(args.size(), vdata_hops);
+	auto hops_pos = vdata_hops.sel->get_index(0);
+	if (!vdata_hops.validity.RowIsValid(hops_pos) || UnifiedVectorFormat::GetData<int32_t>(vdata_hops)[hops_pos] < 1) {
+		throw InvalidInputException("expand needs at least 1 hop");
+	}
+	auto hops = static_cast<idx_t>(UnifiedVectorFormat::GetData<int32_t>(vdata_hops)[hops_pos]);
+
+	auto &local_state = PathFunctionLocalState::Get(state);
+	auto &csr = local_state.Bind(info.context, info.csr_id, true);
+	auto v_size = local_state.VertexCount();
+	auto src_data = csr.InternalIds(vdata_src, args.size(), local_state.source_ids);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto &result_validity = FlatVector::Validity(result);
+	vector<int64_t> walks;
+	vector<idx_t> row_offsets;
+	if (csr.compact) {
+		ExpandInternal<int32_t>(csr, v_size, args.size(), vdata_src, src_data, hops, walks, row_offsets,
+		                        result_validity);
+	} else {
+		ExpandInternal<int64_t>(csr, v_size, args.size(), vdata_src, src_data, hops, walks, row_offsets,
+		                        result_validity);
+	}
+	SetNestedListResult(result, args.size(), walks, 2 * hops + 1, row_offsets);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterExpandScalarFunction(ExtensionLoader &loader) {
+	// csr_id, vertex count, source, number of hops
+	ScalarFunction function("expand",
+	                        {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::INTEGER},
+	                        LogicalType::LIST(LogicalType::LIST(LogicalType::BIGINT)), ExpandFunction,
+	                        IterativeLengthFunctionData::DeltaAwareBind);
+	function.init_local_state = PathFunctionLocalState::Init;
+	loader.RegisterFunction(function);
+}
+
+} // namespace duckdb
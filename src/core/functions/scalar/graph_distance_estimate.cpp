@@ -0,0 +1,85 @@
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/graph_distance_estimate_function_data.hpp"
+#include "duckpgq/core/utils/csr_distance_index.hpp"
+
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+static LogicalType GraphDistanceEstimateType() {
+	child_list_t<LogicalType> children;
+	children.push_back(make_pair("lower", LogicalType::BIGINT));
+	children.push_back(make_pair("upper", LogicalType::BIGINT));
+	return LogicalType::STRUCT(children);
+}
+
+//! Bounds of the hop distance between the rowids [source] and [destination] from the landmarks of the distance index.
+//! NULL if the landmarks prove that there is no path, the upper bound is NULL if no landmark lies on a path between
+//! them.
+static void GraphDistanceEstimateFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &info = state.expr.Cast<BoundFunctionExpression>().bind_info->Cast<GraphDistanceEstimateFunctionData>();
+	auto duckpgq_state = GetDuckPGQState(info.context);
+	auto csr = duckpgq_state->GetCachedCSR(info.pg_name, info.edge_label, info.directed, "");
+	shared_ptr<const CSRDistanceIndex> index;
+	if (csr) {
+		index = csr->GetDistanceIndex();
+	}
+	if (!index) {
+		throw InvalidInputException("No distance index found for %s in property graph %s, build it first with PRAGMA "
+		                            "create_distance_index",
+		                            info.edge_label, info.pg_name);
+	}
+
+	UnifiedVectorFormat vdata_src;
+	UnifiedVectorFormat vdata_dst;
+	args.data[2].ToUnifiedFormat(args.size(), vdata_src);
+	args.data[3].ToUnifiedFormat(args.size(), vdata_dst);
+	auto src_data = UnifiedVectorFormat::GetData<int64_t>(vdata_src);
+	auto dst_data = UnifiedVectorFormat::GetData<int64_t>(vdata_dst);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto &result_validity = FlatVector::Validity(result);
+	auto &entries = StructVector::GetEntries(result);
+	auto lower_data = FlatVector::GetData<int64_t>(*entries[0]);
+	auto upper_data = FlatVector::GetData<int64_t>(*entries[1]);
+	auto &upper_validity = FlatVector::Validity(*entries[1]);
+	for (idx_t i = 0; i < args.size(); i++) {
+		auto src_pos = vdata_src.sel->get_index(i);
+		auto dst_pos = vdata_dst.sel->get_index(i);
+		if (!vdata_src.validity.RowIsValid(src_pos) || !vdata_dst.validity.RowIsValid(dst_pos)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		auto bounds = index->EstimateDistance(csr->InternalId(src_data[src_pos]), csr->InternalId(dst_data[dst_pos]));
+		if (bounds.unreachable) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		lower_data[i] = bounds.lower;
+		if (bounds.upper == DISTANCE_INDEX_UNREACHABLE) {
+			upper_validity.SetInvalid(i);
+		} else {
+			upper_data[i] = bounds.upper;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterGraphDistanceEstimateScalarFunction(ExtensionLoader &loader) {
+	ScalarFunctionSet set("graph_distance_estimate");
+	// property graph, edge label, source rowid, destination rowid
+	ScalarFunction function({LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BIGINT, LogicalType::BIGINT},
+	                        GraphDistanceEstimateType(), GraphDistanceEstimateFunction,
+	                        GraphDistanceEstimateFunctionData::GraphDistanceEstimateBind);
+	set.AddFunction(function);
+	// and whether the edges are directed
+	function.arguments.push_back(LogicalType::BOOLEAN);
+	set.AddFunction(function);
+	loader.RegisterFunction(set);
+}
+
+} // namespace duckdb
@@ -3,55 +3,94 @@
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckpgq/common.hpp"
 #include "duckpgq/core/functions/function_data/iterative_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+#include "duckpgq/core/utils/csr_distance_index.hpp"
+#include "duckpgq/core/utils/msbfs_engine.hpp"
 
 #include <duckpgq/core/functions/scalar.hpp>
 #include <duckpgq/core/utils/duckpgq_utils.hpp>
 
 namespace duckdb {
 
-static bool IterativeLength(int64_t v_size, int64_t *v, vector<int64_t> &e, vector<std::bitset<LANE_LIMIT>> &seen,
-                            vector<std::bitset<LANE_LIMIT>> &visit, vector<std::bitset<LANE_LIMIT>> &next) {
-	bool change = false;
-	for (auto i = 0; i < v_size; i++) {
-		next[i] = 0;
+//! The hooks of the path length searches: a lane answers the rows of its group as their destinations are reached
+//! and is refilled with the next group once all of them are answered. A search stops after [upper] steps, its rows
+//! whose destination is further away have no path.
+struct IterativeLengthVisitor : public MSBFSVisitor {
+	IterativeLengthVisitor(MSBFSSourceGroups &groups, const UnifiedVectorFormat &vdata_dst, const int64_t *dst_data,
+	                       int64_t upper, int64_t *result_data, ValidityMask &result_validity)
+	    : groups(groups), vdata_dst(vdata_dst), dst_data(dst_data), upper(upper), result_data(result_data),
+	      result_validity(result_validity), pending_end(groups.offsets.begin() + 1, groups.offsets.end()) {
 	}
-	for (auto i = 0; i < v_size; i++) {
-		if (visit[i].any()) {
-			for (auto offset = v[i]; offset < v[i + 1]; offset++) {
-				auto n = e[offset];
-				next[n] = next[n] | visit[i];
+
+	int64_t Target(idx_t search_num) const {
+		return dst_data[vdata_dst.sel->get_index(search_num)];
+	}
+
+	//! Answers the rows whose destination is the source, paths of length 0 do not require a search
+	bool StartGroup(int64_t group) {
+		auto source = groups.sources[group];
+		auto &end = pending_end[group];
+		for (auto i = groups.offsets[group]; i < end;) {
+			if (Target(groups.rows[i]) == source) {
+				result_data[groups.rows[i]] = 0;
+				std::swap(groups.rows[i], groups.rows[--end]);
+			} else {
+				i++;
 			}
 		}
+		return end > groups.offsets[group];
 	}
-	for (auto i = 0; i < v_size; i++) {
-		next[i] = next[i] & ~seen[i];
-		seen[i] = seen[i] | next[i];
-		change |= next[i].any();
+
+	//! Answers the rows whose destination was reached, without changes anymore or at the upper bound any still
+	//! pending rows have no path
+	template <idx_t LANES>
+	bool LaneFinished(int64_t group, idx_t lane, int64_t depth, bool change, const vector<LaneBitset<LANES>> &seen) {
+		auto &end = pending_end[group];
+		for (auto i = groups.offsets[group]; i < end;) {
+			auto search_num = groups.rows[i];
+			if (seen[Target(search_num)][lane]) {
+				result_data[search_num] = depth; /* found after this many steps = path length */
+			} else if (!change || depth >= upper) {
+				result_validity.SetInvalid(search_num);
+				result_data[search_num] = (int64_t)-1; /* no path */
+			} else {
+				i++;
+				continue;
+			}
+			std::swap(groups.rows[i], groups.rows[--end]);
+		}
+		return end == groups.offsets[group];
 	}
-	return change;
-}
+
+	//! The rows of a group are reordered so that the ones still to be answered come first
+	MSBFSSourceGroups &groups;
+	const UnifiedVectorFormat &vdata_dst;
+	const int64_t *dst_data;
+	int64_t upper;
+	int64_t *result_data;
+	ValidityMask &result_validity;
+	//! End of the rows of every group that are still to be answered
+	vector<idx_t> pending_end;
+};
 
 static void IterativeLengthFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
 	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
-	auto duckpgq_state = GetDuckPGQState(info.context);
-
-	D_ASSERT(duckpgq_state->csr_list[info.csr_id]);
-
-	if (info.csr_id + 1 > duckpgq_state->csr_list.size()) {
-		throw ConstraintException("Invalid ID");
-	}
-	auto csr_entry = duckpgq_state->csr_list.find(info.csr_id);
-	if (csr_entry == duckpgq_state->csr_list.end()) {
-		throw ConstraintException("Need to initialize CSR before doing shortest path");
-	}
-
-	if (!csr_entry->second->initialized_v) {
-		throw ConstraintException("Need to initialize CSR before doing shortest path");
+	// The variant with five arguments bounds the path length
+	auto upper = NumericLimits<int64_t>::Maximum();
+	if (args.ColumnCount() > 4) {
+		UnifiedVectorFormat vdata_upper;
+		args.data[4].ToUnifiedFormat(args.size(), vdata_upper);
+		auto upper_pos = vdata_upper.sel->get_index(0);
+		if (!vdata_upper.validity.RowIsValid(upper_pos)) {
+			throw InvalidInputException("The upper bound of iterativelength cannot be NULL");
+		}
+		upper = UnifiedVectorFormat::GetData<int64_t>(vdata_upper)[upper_pos];
 	}
-	int64_t v_size = args.data[1].GetValue(0).GetValue<int64_t>();
-	int64_t *v = reinterpret_cast<int64_t *>(duckpgq_state->csr_list[info.csr_id]->v.get());
-	vector<int64_t> &e = duckpgq_state->csr_list[info.csr_id]->e;
+	auto &local_state = PathFunctionLocalState::Get(state);
+	auto &csr = local_state.Bind(info.context, info.csr_id);
+	auto v_size = local_state.VertexCount();
+	TraversalMetricsScope metrics(local_state.Metrics(), TraversalKernel::ITERATIVE_LENGTH);
 
 	// get src and dst vectors for searches
 	auto &src = args.data[2];
@@ -60,8 +99,8 @@ static void IterativeLengthFunction(DataChunk &args, ExpressionState &state, Vec
 	UnifiedVectorFormat vdata_dst;
 	src.ToUnifiedFormat(args.size(), vdata_src);
 	dst.ToUnifiedFormat(args.size(), vdata_dst);
-	auto src_data = reinterpret_cast<int64_t *>(vdata_src.data);
-	auto dst_data = reinterpret_cast<int64_t *>(vdata_dst.data);
+	auto src_data = csr.InternalIds(vdata_src, args.size(), local_state.source_ids);
+	auto dst_data = csr.InternalIds(vdata_dst, args.size(), local_state.target_ids);
 
 	ValidityMask &result_validity = FlatVector::Validity(result);
 
@@ -69,87 +108,54 @@ static void IterativeLengthFunction(DataChunk &args, ExpressionState &state, Vec
 	result.SetVectorType(VectorType::FLAT_VECTOR);
 	auto result_data = FlatVector::GetData<int64_t>(result);
 
-	// create temp SIMD arrays
-	vector<std::bitset<LANE_LIMIT>> seen(v_size);
-	vector<std::bitset<LANE_LIMIT>> visit1(v_size);
-	vector<std::bitset<LANE_LIMIT>> visit2(v_size);
-
-	// maps lane to search number
-	int64_t lane_to_num[LANE_LIMIT];
-	for (int64_t lane = 0; lane < LANE_LIMIT; lane++) {
-		lane_to_num[lane] = -1; // inactive
+	// A distance index answers a row with a merge of two labels instead of a search
+	auto distance_index = csr.GetDistanceIndex();
+	if (distance_index && distance_index->IsExact()) {
+		IndexedPathLengths(*distance_index, args.size(), vdata_src, src_data, vdata_dst, dst_data, upper, result_data,
+		                   result_validity);
+		return;
 	}
 
-	int64_t started_searches = 0;
-	while (started_searches < args.size()) {
-
-		// empty visit vectors
-		for (auto i = 0; i < v_size; i++) {
-			seen[i] = 0;
-			visit1[i] = 0;
-		}
-
-		// add search jobs to free lanes
-		uint64_t active = 0;
-		for (int64_t lane = 0; lane < LANE_LIMIT; lane++) {
-			lane_to_num[lane] = -1;
-			while (started_searches < args.size()) {
-				int64_t search_num = started_searches++;
-				auto src_pos = vdata_src.sel->get_index(search_num);
-				auto dst_pos = vdata_dst.sel->get_index(search_num);
-				if (!vdata_src.validity.RowIsValid(src_pos)) {
-					result_validity.SetInvalid(search_num);
-					result_data[search_num] = -1; /* no path */
-				} else if (src_data[src_pos] == dst_data[dst_pos]) {
-					result_data[search_num] = 0; // path of length 0 does not require a search
-				} else {
-					visit1[src_data[src_pos]][lane] = true;
-					lane_to_num[lane] = search_num; // active lane
-					active++;
-					break;
-				}
-			}
+	// searches without a source have no path, all others are grouped by source
+	for (idx_t search_num = 0; search_num < args.size(); search_num++) {
+		if (!vdata_src.validity.RowIsValid(vdata_src.sel->get_index(search_num))) {
+			result_validity.SetInvalid(search_num);
+			result_data[search_num] = -1; /* no path */
 		}
-
-		// make passes while a lane is still active
-		for (int64_t iter = 1; active; iter++) {
-			if (!IterativeLength(v_size, v, e, seen, (iter & 1) ? visit1 : visit2, (iter & 1) ? visit2 : visit1)) {
-				break;
-			}
-			// detect lanes that finished
-			for (int64_t lane = 0; lane < LANE_LIMIT; lane++) {
-				int64_t search_num = lane_to_num[lane];
-				if (search_num >= 0) { // active lane
-					auto dst_pos = vdata_dst.sel->get_index(search_num);
-					if (seen[dst_data[dst_pos]][lane]) {
-						result_data[search_num] = iter; /* found at iter => iter = path length */
-						lane_to_num[lane] = -1;         // mark inactive
-						active--;
-					}
-				}
-			}
-		}
-
-		// no changes anymore: any still active searches have no path
-		for (int64_t lane = 0; lane < LANE_LIMIT; lane++) {
-			int64_t search_num = lane_to_num[lane];
-			if (search_num >= 0) { // active lane
-				result_validity.SetInvalid(search_num);
-				result_data[search_num] = (int64_t)-1; /* no path */
-				lane_to_num[lane] = -1;                // mark inactive
+	}
+	MSBFSSourceGroups groups;
+	groups.Initialize(args.size(), *vdata_src.sel, vdata_src.validity, src_data);
+	for (idx_t group = 0; group < groups.GroupCount(); group++) {
+		// sources outside of the CSR get no lane and have no path
+		if (groups.sources[group] < 0 || groups.sources[group] >= v_size) {
+			for (auto i = groups.offsets[group]; i < groups.offsets[group + 1]; i++) {
+				result_validity.SetInvalid(groups.rows[i]);
+				result_data[groups.rows[i]] = -1;
 			}
 		}
 	}
-	duckpgq_state->csr_to_delete.insert(info.csr_id);
+
+	// One lane per distinct source, a lane whose rows are all answered is refilled with the next group right away
+	IterativeLengthVisitor visitor(groups, vdata_dst, dst_data, upper, result_data, result_validity);
+	RunMSBFSBatches<MSBFSTermination::LANE_REFILL, false>(info.context, csr, v_size, local_state.scratch, groups, 0,
+	                                                       visitor, &metrics.counters);
 }
 
 //------------------------------------------------------------------------------
 // Register functions
 //------------------------------------------------------------------------------
 void CoreScalarFunctions::RegisterIterativeLengthScalarFunction(ExtensionLoader &loader) {
-	loader.RegisterFunction(ScalarFunction(
-	    "iterativelength", {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
-	    LogicalType::BIGINT, IterativeLengthFunction, IterativeLengthFunctionData::IterativeLengthBind));
+	ScalarFunctionSet set("iterativelength");
+	// csr_id, vertex count, source, destination
+	ScalarFunction function({LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
+	                        LogicalType::BIGINT, IterativeLengthFunction,
+	                        IterativeLengthFunctionData::DeltaAwareBind);
+	function.init_local_state = PathFunctionLocalState::Init;
+	set.AddFunction(function);
+	// and the upper bound of the path length
+	function.arguments.push_back(LogicalType::BIGINT);
+	set.AddFunction(function);
+	loader.RegisterFunction(set);
 }
 
 } // namespace duckdb
@@ -3,6 +3,8 @@
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckpgq/common.hpp"
 #include "duckpgq/core/functions/function_data/iterative_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+#include "duckpgq/core/utils/msbfs.hpp"
 #include <duckpgq_extension.hpp>
 
 #include <duckpgq/core/functions/scalar.hpp>
@@ -10,36 +12,54 @@
 
 namespace duckdb {
 
-static bool IterativeLength2(int64_t v_size, int64_t *V, vector<int64_t> &E, vector<std::bitset<LANE_LIMIT>> &seen,
-                             vector<std::bitset<LANE_LIMIT>> &visit, vector<std::bitset<LANE_LIMIT>> &next) {
-	std::bitset<LANE_LIMIT> change;
-	for (auto v = 0; v < v_size; v++) {
-		seen[v] |= visit[v];
-		next[v] = 0;
+template <class ID_T>
+static bool IterativeLength2(int64_t v_size, int64_t *V, vector<ID_T> &E, vector<LaneSet> &seen, vector<LaneSet> &visit,
+                             vector<LaneSet> &next, MSBFSFrontierList &frontier_list) {
+	frontier_list.ClearNext(v_size, next);
+	bool sparse = frontier_list.IsSparse(v_size);
+	if (sparse) {
+		for (auto v : frontier_list.Current()) {
+			seen[v] |= visit[v];
+		}
+	} else {
+		for (auto v = 0; v < v_size; v++) {
+			seen[v] |= visit[v];
+		}
 	}
-	for (auto v = 0; v < v_size; v++) {
-		if (visit[v].any()) {
-			for (auto e = V[v]; e < V[v + 1]; e++) {
-				auto n = E[e];
-				auto unseen = visit[v] & ~seen[n];
-				next[n] |= unseen;
-				change |= unseen;
+	bool change = false;
+	auto expand = [&](int64_t v) {
+		for (auto e = V[v]; e < V[v + 1]; e++) {
+			auto n = E[e];
+			auto unseen = visit[v] & ~seen[n];
+			if (unseen.any() && next[n].none()) {
+				frontier_list.AddNext(n);
+				change = true;
+			}
+			next[n] |= unseen;
+		}
+	};
+	if (sparse) {
+		for (auto v : frontier_list.Current()) {
+			expand(v);
+		}
+	} else {
+		for (auto v = 0; v < v_size; v++) {
+			if (visit[v].any()) {
+				expand(v);
 			}
 		}
 	}
-	return change.any();
+	frontier_list.Advance();
+	return change;
 }
 
 static void IterativeLength2Function(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
 	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
-
-	auto duckpgq_state = GetDuckPGQState(info.context);
-
-	D_ASSERT(duckpgq_state->csr_list[info.csr_id]);
-	int64_t v_size = args.data[1].GetValue(0).GetValue<int64_t>();
-	int64_t *v = reinterpret_cast<int64_t *>(duckpgq_state->csr_list[info.csr_id]->v.get());
-	vector<int64_t> &e = duckpgq_state->csr_list[info.csr_id]->e;
+	auto &local_state = PathFunctionLocalState::Get(state);
+	auto &csr = local_state.Bind(info.context, info.csr_id, true);
+	auto v_size = local_state.VertexCount();
+	int64_t *v = reinterpret_cast<int64_t *>(csr.v.get());
 
 	// get src and dst vectors for searches
 	auto &src = args.data[2];
@@ -48,8 +68,8 @@ static void IterativeLength2Function(DataChunk &args, ExpressionState &state, Ve
 	UnifiedVectorFormat vdata_dst;
 	src.ToUnifiedFormat(args.size(), vdata_src);
 	dst.ToUnifiedFormat(args.size(), vdata_dst);
-	auto src_data = reinterpret_cast<int64_t *>(vdata_src.data);
-	auto dst_data = reinterpret_cast<int64_t *>(vdata_dst.data);
+	auto src_data = csr.InternalIds(vdata_src, args.size(), local_state.source_ids);
+	auto dst_data = csr.InternalIds(vdata_dst, args.size(), local_state.target_ids);
 
 	// create result vector
 	result.SetVectorType(VectorType::FLAT_VECTOR);
@@ -57,10 +77,13 @@ static void IterativeLength2Function(DataChunk &args, ExpressionState &state, Ve
 
 	ValidityMask &result_validity = FlatVector::Validity(result);
 
-	// create temp SIMD arrays
-	vector<std::bitset<LANE_LIMIT>> seen(v_size);
-	vector<std::bitset<LANE_LIMIT>> visit1(v_size);
-	vector<std::bitset<LANE_LIMIT>> visit2(v_size);
+	// create temp SIMD arrays, counted against memory_limit
+	MemoryReservation memory;
+	memory.Resize(info.context, 3 * v_size * sizeof(LaneSet));
+	vector<LaneSet> seen(v_size);
+	vector<LaneSet> visit1(v_size);
+	vector<LaneSet> visit2(v_size);
+	MSBFSFrontierList frontier_list;
 
 	// maps lane to search number
 	int64_t lane_to_num[LANE_LIMIT];
@@ -100,8 +123,13 @@ static void IterativeLength2Function(DataChunk &args, ExpressionState &state, Ve
 		}
 
 		// make passes while a lane is still active
+		frontier_list.Initialize(v_size, v, visit1);
 		for (int64_t iter = 1; active; iter++) {
-			if (!IterativeLength2(v_size, v, e, seen, (iter & 1) ? visit1 : visit2, (iter & 1) ? visit2 : visit1)) {
+			auto &visit = (iter & 1) ? visit1 : visit2;
+			auto &next = (iter & 1) ? visit2 : visit1;
+			bool change = csr.compact ? IterativeLength2(v_size, v, csr.e_compact, seen, visit, next, frontier_list)
+			                          : IterativeLength2(v_size, v, csr.e, seen, visit, next, frontier_list);
+			if (!change) {
 				break;
 			}
 			// detect lanes that finished
@@ -127,16 +155,17 @@ static void IterativeLength2Function(DataChunk &args, ExpressionState &state, Ve
 			}
 		}
 	}
-	duckpgq_state->csr_to_delete.insert(info.csr_id);
 }
 
 //------------------------------------------------------------------------------
 // Register functions
 //------------------------------------------------------------------------------
 void CoreScalarFunctions::RegisterIterativeLength2ScalarFunction(ExtensionLoader &loader) {
-	loader.RegisterFunction(ScalarFunction(
+	ScalarFunction function(
 	    "iterativelength2", {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
-	    LogicalType::BIGINT, IterativeLength2Function, IterativeLengthFunctionData::IterativeLengthBind));
+	    LogicalType::BIGINT, IterativeLength2Function, IterativeLengthFunctionData::IterativeLengthBind);
+	function.init_local_state = PathFunctionLocalState::Init;
+	loader.RegisterFunction(function);
 }
 
 } // namespace duckdb
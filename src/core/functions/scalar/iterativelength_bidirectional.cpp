@@ -3,103 +3,66 @@
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckpgq/common.hpp"
 #include "duckpgq/core/functions/function_data/iterative_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+#include "duckpgq/core/utils/csr_distance_index.hpp"
+#include "duckpgq/core/utils/msbfs.hpp"
 
 #include <duckpgq/core/functions/scalar.hpp>
 #include <duckpgq/core/utils/duckpgq_utils.hpp>
 
 namespace duckdb {
 
-static bool IterativeLengthBidirectional(int64_t v_size, int64_t *V, vector<int64_t> &E,
-                                         vector<std::bitset<LANE_LIMIT>> &seen, vector<std::bitset<LANE_LIMIT>> &visit,
-                                         vector<std::bitset<LANE_LIMIT>> &next) {
-	bool change = false;
-	for (auto v = 0; v < v_size; v++) {
-		next[v] = 0;
-	}
-	for (auto v = 0; v < v_size; v++) {
-		if (visit[v].any()) {
-			for (auto e = V[v]; e < V[v + 1]; e++) {
-				auto n = E[e];
-				next[n] = next[n] | visit[v];
-			}
-		}
-	}
-	for (auto v = 0; v < v_size; v++) {
-		next[v] = next[v] & ~seen[v];
-		seen[v] = seen[v] | next[v];
-		change |= next[v].any();
-	}
-	return change;
-}
-static std::bitset<LANE_LIMIT> InterSectFronteers(int64_t v_size, vector<std::bitset<LANE_LIMIT>> &src_seen,
-                                                  vector<std::bitset<LANE_LIMIT>> &dst_seen) {
-	std::bitset<LANE_LIMIT> result;
-	for (auto v = 0; v < v_size; v++) {
-		result |= src_seen[v] & dst_seen[v];
-	}
-	return result;
-}
-
-static void IterativeLengthBidirectionalFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
-	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
-
-	auto duckpgq_state = GetDuckPGQState(info.context);
-
-	D_ASSERT(duckpgq_state->csr_list[info.csr_id]);
-	int64_t v_size = args.data[1].GetValue(0).GetValue<int64_t>();
-	int64_t *v = reinterpret_cast<int64_t *>(duckpgq_state->csr_list[info.csr_id]->v.get());
-	vector<int64_t> &e = duckpgq_state->csr_list[info.csr_id]->e;
-
-	// get src and dst vectors for searches
-	auto &src = args.data[2];
-	auto &dst = args.data[3];
-	UnifiedVectorFormat vdata_src;
-	UnifiedVectorFormat vdata_dst;
-	src.ToUnifiedFormat(args.size(), vdata_src);
-	dst.ToUnifiedFormat(args.size(), vdata_dst);
-	auto src_data = vdata_src.data;
-	auto dst_data = vdata_dst.data;
-
-	// create result vector
-	result.SetVectorType(VectorType::FLAT_VECTOR);
-	ValidityMask &result_validity = FlatVector::Validity(result);
-	auto result_data = FlatVector::GetData<int64_t>(result);
-
-	// create temp SIMD arrays
-	vector<std::bitset<LANE_LIMIT>> src_seen(v_size);
-	vector<std::bitset<LANE_LIMIT>> src_visit1(v_size);
-	vector<std::bitset<LANE_LIMIT>> src_visit2(v_size);
-	vector<std::bitset<LANE_LIMIT>> dst_seen(v_size);
-	vector<std::bitset<LANE_LIMIT>> dst_visit1(v_size);
-	vector<std::bitset<LANE_LIMIT>> dst_visit2(v_size);
+//! Runs the searches of rows [0, count) in batches of LANES. Every search expands from both ends, the source side
+//! along the outgoing edges of [csr] and the destination side along the incoming edges of its reverse CSR. Each step
+//! expands the side whose frontier has fewer edges, and a search ends at the step in which the two sides first reach
+//! a common vertex. The arrays of the two sides are the ones of [src_scratch] and [dst_scratch], reused across the
+//! batches and chunks of the thread.
+template <idx_t LANES>
+static void IterativeLengthBidirectionalBatches(ClientContext &context, CSR &csr, int64_t v_size, idx_t count,
+                                                const UnifiedVectorFormat &vdata_src, const int64_t *src_data,
+                                                const UnifiedVectorFormat &vdata_dst, const int64_t *dst_data,
+                                                MSBFSScratch &src_scratch, MSBFSScratch &dst_scratch,
+                                                int64_t *result_data, ValidityMask &result_validity) {
+	auto &reverse = csr.GetReverse(context);
+	auto &src_buffers = src_scratch.Get<LANES>();
+	auto &dst_buffers = dst_scratch.Get<LANES>();
+	auto &src_seen = src_buffers.seen;
+	auto &src_visit1 = src_buffers.visit1;
+	auto &src_visit2 = src_buffers.visit2;
+	auto &dst_seen = dst_buffers.seen;
+	auto &dst_visit1 = dst_buffers.visit1;
+	auto &dst_visit2 = dst_buffers.visit2;
+	auto &src_frontier_list = src_buffers.frontier_list;
+	auto &dst_frontier_list = dst_buffers.frontier_list;
 
 	// maps lane to search number
-	int64_t lane_to_num[LANE_LIMIT];
-	for (int64_t lane = 0; lane < LANE_LIMIT; lane++) {
+	int64_t lane_to_num[LANES];
+	for (idx_t lane = 0; lane < LANES; lane++) {
 		lane_to_num[lane] = -1; // inactive
 	}
 
-	int64_t started_searches = 0;
-	while (started_searches < args.size()) {
-
-		// empty visit vectors
-		for (auto i = 0; i < v_size; i++) {
-			src_seen[i] = 0;
-			dst_seen[i] = 0;
-			src_visit1[i] = 0;
-			dst_visit1[i] = 0;
-		}
+	idx_t started_searches = 0;
+	vector<int64_t> src_sources;
+	vector<int64_t> dst_sources;
+	while (started_searches < count) {
+		// only the vertices the previous batch visited are cleared
+		src_buffers.Prepare(context, v_size, false);
+		dst_buffers.Prepare(context, v_size, false);
+		src_sources.clear();
+		dst_sources.clear();
 
 		// add search jobs to free lanes
-		uint64_t active = 0;
-		for (int64_t lane = 0; lane < LANE_LIMIT; lane++) {
+		LaneBitset<LANES> active_lanes;
+		for (idx_t lane = 0; lane < LANES; lane++) {
 			lane_to_num[lane] = -1;
-			while (started_searches < args.size()) {
-				int64_t search_num = started_searches++;
+			while (started_searches < count) {
+				auto search_num = started_searches++;
 				auto src_pos = vdata_src.sel->get_index(search_num);
 				auto dst_pos = vdata_dst.sel->get_index(search_num);
-				if (!vdata_src.validity.RowIsValid(src_pos)) {
+				if (!vdata_src.validity.RowIsValid(src_pos) || !vdata_dst.validity.RowIsValid(dst_pos) ||
+				    src_data[src_pos] < 0 || src_data[src_pos] >= v_size || dst_data[dst_pos] < 0 ||
+				    dst_data[dst_pos] >= v_size) {
+					// ends outside of the CSR get no lane and have no path
 					result_validity.SetInvalid(search_num);
 					result_data[search_num] = -1; // no path
 				} else if (src_data[src_pos] == dst_data[dst_pos]) {
@@ -109,58 +72,123 @@ static void IterativeLengthBidirectionalFunction(DataChunk &args, ExpressionStat
 					dst_visit1[dst_data[dst_pos]][lane] = true;
 					src_seen[src_data[src_pos]][lane] = true;
 					dst_seen[dst_data[dst_pos]][lane] = true;
-					lane_to_num[lane] = search_num; // active lane
-					active++;
+					src_sources.push_back(src_data[src_pos]);
+					dst_sources.push_back(dst_data[dst_pos]);
+					lane_to_num[lane] = static_cast<int64_t>(search_num); // active lane
+					active_lanes[lane] = true;
 					break;
 				}
 			}
 		}
 
-		// make passes while a lane is still active
-		for (int64_t iter = 0; active; iter++) {
-			if (!IterativeLengthBidirectional(v_size, v, e, (iter & 1) ? dst_seen : src_seen,
-			                                  (iter & 2)   ? (iter & 1) ? dst_visit2 : src_visit2
-			                                  : (iter & 1) ? dst_visit1
-			                                               : src_visit1,
-			                                  (iter & 2)   ? (iter & 1) ? dst_visit1 : src_visit1
-			                                  : (iter & 1) ? dst_visit2
-			                                               : src_visit2)) {
+		// make passes while a lane is still active, expanding the side whose frontier has fewer edges. Both sides pick
+		// their own BFS direction for every step.
+		BFSDirectionPolicy src_policy(v_size, csr.EdgeCount());
+		BFSDirectionPolicy dst_policy(v_size, reverse.EdgeCount());
+		auto src_frontier = src_frontier_list.Initialize(v_size, csr.GetRanges(), src_sources);
+		auto dst_frontier = dst_frontier_list.Initialize(v_size, reverse.GetRanges(), dst_sources);
+		int64_t src_depth = 0;
+		int64_t dst_depth = 0;
+		while (active_lanes.any()) {
+			bool forward = src_frontier.edge_count <= dst_frontier.edge_count;
+			auto &depth = forward ? src_depth : dst_depth;
+			auto &visit1 = forward ? src_visit1 : dst_visit1;
+			auto &visit2 = forward ? src_visit2 : dst_visit2;
+			auto &visit = (depth & 1) ? visit2 : visit1;
+			auto &next = (depth & 1) ? visit1 : visit2;
+			auto &frontier_list = forward ? src_frontier_list : dst_frontier_list;
+			// a side that reaches no new vertex ends all searches that have not met yet
+			if (!MSBFSStep(context, forward ? csr : reverse, forward ? src_policy : dst_policy, v_size, active_lanes,
+			               forward ? src_seen : dst_seen, visit, next, forward ? src_frontier : dst_frontier,
+			               frontier_list)) {
 				break;
 			}
-			std::bitset<LANE_LIMIT> done = InterSectFronteers(v_size, src_seen, dst_seen);
-			// detect lanes that finished
-			for (int64_t lane = 0; lane < LANE_LIMIT; lane++) {
-				if (done[lane]) {
-					int64_t search_num = lane_to_num[lane];
-					if (search_num >= 0) {
-						result_data[search_num] = iter + 1; /* found at iter => iter = path length */
-						lane_to_num[lane] = -1;             // mark inactive
-						active--;
-					}
-				}
+			depth++;
+			// new meetings can only happen at the vertices this side has just reached
+			auto &other_seen = forward ? dst_seen : src_seen;
+			LaneBitset<LANES> met;
+			for (auto n : frontier_list.Current()) {
+				met |= next[n] & other_seen[n];
 			}
+			(met & active_lanes).ForEach([&](idx_t lane) {
+				result_data[lane_to_num[lane]] = src_depth + dst_depth;
+				lane_to_num[lane] = -1; // mark inactive
+				active_lanes[lane] = false;
+			});
 		}
 		// no changes anymore: any still active searches have no path
-		for (int64_t lane = 0; lane < LANE_LIMIT; lane++) {
-			int64_t search_num = lane_to_num[lane];
-			if (search_num >= 0) {
-				result_validity.SetInvalid(search_num);
-				result_data[search_num] = (int64_t)-1; /* no path */
-				lane_to_num[lane] = -1;                // mark inactive
-			}
-		}
+		active_lanes.ForEach([&](idx_t lane) {
+			result_validity.SetInvalid(lane_to_num[lane]);
+			result_data[lane_to_num[lane]] = -1; /* no path */
+			lane_to_num[lane] = -1;              // mark inactive
+		});
+	}
+}
+
+static void IterativeLengthBidirectionalFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
+	auto &local_state = PathFunctionLocalState::Get(state);
+	auto &csr = local_state.Bind(info.context, info.csr_id);
+	auto v_size = local_state.VertexCount();
+
+	// get src and dst vectors for searches
+	auto &src = args.data[2];
+	auto &dst = args.data[3];
+	UnifiedVectorFormat vdata_src;
+	UnifiedVectorFormat vdata_dst;
+	src.ToUnifiedFormat(args.size(), vdata_src);
+	dst.ToUnifiedFormat(args.size(), vdata_dst);
+	auto src_data = csr.InternalIds(vdata_src, args.size(), local_state.source_ids);
+	auto dst_data = csr.InternalIds(vdata_dst, args.size(), local_state.target_ids);
+
+	// create result vector
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	ValidityMask &result_validity = FlatVector::Validity(result);
+	auto result_data = FlatVector::GetData<int64_t>(result);
+
+	// Point-to-point queries are what the distance index is for, neither side has to be searched
+	auto distance_index = csr.GetDistanceIndex();
+	if (distance_index && distance_index->IsExact()) {
+		IndexedPathLengths(*distance_index, args.size(), vdata_src, src_data, vdata_dst, dst_data,
+		                   NumericLimits<int64_t>::Maximum(), result_data, result_validity);
+		return;
+	}
+
+	switch (SelectLaneCount(args.size())) {
+	case 64:
+		IterativeLengthBidirectionalBatches<64>(info.context, csr, v_size, args.size(), vdata_src, src_data, vdata_dst,
+		                                        dst_data, local_state.scratch, local_state.reverse_scratch, result_data,
+		                                        result_validity);
+		break;
+	case 128:
+		IterativeLengthBidirectionalBatches<128>(info.context, csr, v_size, args.size(), vdata_src, src_data,
+		                                         vdata_dst, dst_data, local_state.scratch, local_state.reverse_scratch,
+		                                         result_data, result_validity);
+		break;
+	case 256:
+		IterativeLengthBidirectionalBatches<256>(info.context, csr, v_size, args.size(), vdata_src, src_data,
+		                                         vdata_dst, dst_data, local_state.scratch, local_state.reverse_scratch,
+		                                         result_data, result_validity);
+		break;
+	default:
+		IterativeLengthBidirectionalBatches<LANE_LIMIT>(info.context, csr, v_size, args.size(), vdata_src, src_data,
+		                                                vdata_dst, dst_data, local_state.scratch,
+		                                                local_state.reverse_scratch, result_data, result_validity);
+		break;
 	}
-	duckpgq_state->csr_to_delete.insert(info.csr_id);
 }
 
 //------------------------------------------------------------------------------
 // Register functions
 //------------------------------------------------------------------------------
 void CoreScalarFunctions::RegisterIterativeLengthBidirectionalScalarFunction(ExtensionLoader &loader) {
-	loader.RegisterFunction(ScalarFunction(
-	    "iterativelengthbidirectional",
-	    {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT}, LogicalType::BIGINT,
-	    IterativeLengthBidirectionalFunction, IterativeLengthFunctionData::IterativeLengthBind));
+	ScalarFunction function("iterativelengthbidirectional",
+	                        {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
+	                        LogicalType::BIGINT, IterativeLengthBidirectionalFunction,
+	                        IterativeLengthFunctionData::IterativeLengthBind);
+	function.init_local_state = PathFunctionLocalState::Init;
+	loader.RegisterFunction(function);
 }
 
 } // namespace duckdb
@@ -0,0 +1,199 @@
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/iterative_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+#include <algorithm>
+#include <set>
+
+namespace duckdb {
+
+//! Yen's algorithm over the outgoing edges of a CSR: the k shortest simple paths from a source to a destination, in
+//! order of their length. Every path after the first one leaves a path found before at one of its vertices, the spur,
+//! and reaches the destination by a breadth-first search that avoids the root up to the spur and the edges the found
+//! paths with the same root take from it. The candidates are kept ordered by length, so the search stops as soon as
+//! k paths are found or no candidate is left. A path is stored as the CSR offsets of its edges.
+template <class ID_T>
+class KShortestPaths {
+public:
+	KShortestPaths(CSR &csr, idx_t vertex_count)
+	    : ranges(csr.GetRanges()), e(csr.GetNeighbors<ID_T>()), reached(vertex_count, false),
+	      banned_vertex(vertex_count, false), parent(vertex_count), parent_offset(vertex_count) {
+	}
+
+	//! Finds up to [k] paths from [source] to [destination], shortest first
+	void Run(int64_t source, int64_t destination, idx_t k, vector<vector<int64_t>> &paths) {
+		paths.clear();
+		candidates.clear();
+		vector<int64_t> path;
+		if (!Search(source, destination, path)) {
+			return;
+		}
+		paths.push_back(std::move(path));
+		vector<int64_t> vertices;
+		while (paths.size() < k) {
+			auto last = paths.back();
+			vertices.assign(1, source);
+			for (auto offset : last) {
+				vertices.push_back(Target(offset));
+			}
+			for (idx_t i = 0; i < last.size(); i++) {
+				for (auto &found : paths) {
+					if (found.size() > i && std::equal(last.begin(), last.begin() + i, found.begin())) {
+						banned_edge.insert(found[i]);
+					}
+				}
+				if (Search(vertices[i], destination, path)) {
+					vector<int64_t> candidate(last.begin(), last.begin() + i);
+					candidate.insert(candidate.end(), path.begin(), path.end());
+					candidates.emplace(candidate.size(), std::move(candidate));
+				}
+				banned_edge.clear();
+				// The spur is part of the root of the next spur
+				banned_vertex[vertices[i]] = true;
+			}
+			for (auto vertex : vertices) {
+				banned_vertex[vertex] = false;
+			}
+			if (candidates.empty()) {
+				break;
+			}
+			paths.push_back(candidates.begin()->second);
+			candidates.erase(candidates.begin());
+		}
+	}
+
+	int64_t Target(int64_t offset) const {
+		return static_cast<int64_t>(e[offset]);
+	}
+
+private:
+	//! Breadth-first search from [source] to [destination] that skips the banned vertices and edges
+	bool Search(int64_t source, int64_t destination, vector<int64_t> &path) {
+		path.clear();
+		for (auto vertex : touched) {
+			reached[vertex] = false;
+		}
+		touched.assign(1, source);
+		reached[source] = true;
+		for (idx_t head = 0; head < touched.size() && !reached[destination]; head++) {
+			auto vertex = touched[head];
+			for (auto offset = ranges.begin[vertex]; offset < ranges.end[vertex]; offset++) {
+				auto neighbor = Target(offset);
+				if (reached[neighbor] || banned_vertex[neighbor] || banned_edge.count(offset)) {
+					continue;
+				}
+				reached[neighbor] = true;
+				parent[neighbor] = vertex;
+				parent_offset[neighbor] = offset;
+				touched.push_back(neighbor);
+			}
+		}
+		if (!reached[destination]) {
+			return false;
+		}
+		for (auto vertex = destination; vertex != source; vertex = parent[vertex]) {
+			path.push_back(parent_offset[vertex]);
+		}
+		std::reverse(path.begin(), path.end());
+		return true;
+	}
+
+	CSRRanges ranges;
+	const vector<ID_T> &e;
+	vector<bool> reached;
+	vector<bool> banned_vertex;
+	unordered_set<int64_t> banned_edge;
+	vector<int64_t> parent;
+	vector<int64_t> parent_offset;
+	//! The vertices the last search reached
+	vector<int64_t> touched;
+	//! Paths by number of edges, then by offsets, which also drops the candidates found twice
+	std::set<std::pair<idx_t, vector<int64_t>>> candidates;
+};
+
+template <class ID_T>
+static void KShortestPathsInternal(CSR &csr, int64_t v_size, idx_t count, const UnifiedVectorFormat &vdata_src,
+                                   const int64_t *src_data, const UnifiedVectorFormat &vdata_dst,
+                                   const int64_t *dst_data, idx_t k, Vector &result) {
+	auto &result_validity = FlatVector::Validity(result);
+	KShortestPaths<ID_T> search(csr, v_size);
+	vector<vector<int64_t>> found;
+	vector<int64_t> paths;
+	vector<idx_t> path_offsets(1, 0);
+	vector<idx_t> row_offsets(1, 0);
+	for (idx_t row = 0; row < count; row++) {
+		auto src_pos = vdata_src.sel->get_index(row);
+		auto dst_pos = vdata_dst.sel->get_index(row);
+		if (!vdata_src.validity.RowIsValid(src_pos) || !vdata_dst.validity.RowIsValid(dst_pos)) {
+			result_validity.SetInvalid(row);
+			row_offsets.push_back(path_offsets.size() - 1);
+			continue;
+		}
+		auto source = src_data[src_pos];
+		auto destination = dst_data[dst_pos];
+		if (source >= 0 && source < v_size && destination >= 0 && destination < v_size) {
+			search.Run(source, destination, k, found);
+			for (auto &path : found) {
+				paths.push_back(csr.ExternalId(source));
+				for (auto offset : path) {
+					paths.push_back(csr.edge_ids[offset]);
+					paths.push_back(csr.ExternalId(search.Target(offset)));
+				}
+				path_offsets.push_back(paths.size());
+			}
+		}
+		row_offsets.push_back(path_offsets.size() - 1);
+	}
+	SetNestedListResult(result, count, paths, path_offsets, row_offsets);
+}
+
+static void KShortestPathsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
+	UnifiedVectorFormat vdata_k;
+	args.data[4].ToUnifiedFormat(args.size(), vdata_k);
+	auto k_pos = vdata_k.sel->get_index(0);
+	if (!vdata_k.validity.RowIsValid(k_pos) || UnifiedVectorFormat::GetData<int64_t>(vdata_k)[k_pos] < 1) {
+		throw InvalidInputException("k_shortest_paths needs at least 1 path");
+	}
+	auto k = static_cast<idx_t>(UnifiedVectorFormat::GetData<int64_t>(vdata_k)[k_pos]);
+
+	auto &local_state = PathFunctionLocalState::Get(state);
+	auto &csr = local_state.Bind(info.context, info.csr_id, true);
+	auto v_size = local_state.VertexCount();
+
+	UnifiedVectorFormat vdata_src;
+	UnifiedVectorFormat vdata_dst;
+	args.data[2].ToUnifiedFormat(args.size(), vdata_src);
+	args.data[3].ToUnifiedFormat(args.size(), vdata_dst);
+	auto src_data = csr.InternalIds(vdata_src, args.size(), local_state.source_ids);
+	auto dst_data = csr.InternalIds(vdata_dst, args.size(), local_state.target_ids);
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	if (csr.compact) {
+		KShortestPathsInternal<int32_t>(csr, v_size, args.size(), vdata_src, src_data, vdata_dst, dst_data, k,
+		                                result);
+	} else {
+		KShortestPathsInternal<int64_t>(csr, v_size, args.size(), vdata_src, src_data, vdata_dst, dst_data, k,
+		                                result);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterKShortestPathsScalarFunction(ExtensionLoader &loader) {
+	// csr_id, vertex count, source, destination, number of paths
+	ScalarFunction function("k_shortest_paths",
+	                        {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT,
+	                         LogicalType::BIGINT},
+	                        LogicalType::LIST(LogicalType::LIST(LogicalType::BIGINT)), KShortestPathsFunction,
+	                        IterativeLengthFunctionData::DeltaAwareBind);
+	function.init_local_state = PathFunctionLocalState::Init;
+	loader.RegisterFunction(function);
+}
+
+} // namespace duckdb
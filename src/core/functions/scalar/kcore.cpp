@@ -0,0 +1,96 @@
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/kcore_function_data.hpp"
+#include "duckpgq/core/utils/csr_kcore.hpp"
+
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+//! The core number of the vertex with rowid in argument 1, the CSR must hold every edge in both directions
+static void KCoreFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<KCoreFunctionData>();
+	auto duckpgq_state = GetDuckPGQState(info.context);
+
+	auto csr_entry = duckpgq_state->csr_list.find(info.csr_id);
+	if (csr_entry == duckpgq_state->csr_list.end()) {
+		throw ConstraintException("CSR not found. Is the graph populated?");
+	}
+
+	if (!(csr_entry->second->initialized_v && csr_entry->second->initialized_e)) {
+		throw ConstraintException("Need to initialize CSR before computing core numbers.");
+	}
+
+	auto &csr = *csr_entry->second;
+	csr.LoadPartitions(info.context);
+	auto vertex_count = static_cast<int64_t>(csr.VertexCount());
+
+	info.once.Run([&]() { KCoreDecomposition(info.context, csr, info.core); });
+
+	auto &src = args.data[1];
+	UnifiedVectorFormat vdata_src;
+	src.ToUnifiedFormat(args.size(), vdata_src);
+	auto src_data = UnifiedVectorFormat::GetData<int64_t>(vdata_src);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<int64_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	for (idx_t i = 0; i < args.size(); i++) {
+		auto id_pos = vdata_src.sel->get_index(i);
+		if (!vdata_src.validity.RowIsValid(id_pos)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		auto node_id = csr.InternalId(src_data[id_pos]);
+		if (node_id < 0 || node_id >= vertex_count) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		result_data[i] = info.core[node_id];
+	}
+
+	duckpgq_state->csr_to_delete.insert(info.csr_id);
+}
+
+// Installs the CSR of the k-core of CSR [id] under the id in argument 1, with k in argument 2, so that any function
+// that takes a csr_id runs on the pruned graph. Vertices outside the k-core keep their ids without edges. Argument 3
+// only orders the call after the edges of the CSR have been inserted.
+static void CreateCsrKCoreFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<CSRFunctionData>();
+	auto duckpgq_state = GetDuckPGQState(info.context);
+	auto kcore_id = args.data[1].GetValue(0).GetValue<int32_t>();
+	auto k = args.data[2].GetValue(0).GetValue<int64_t>();
+	{
+		lock_guard<mutex> csr_lock(duckpgq_state->csr_lock);
+		auto csr_entry = duckpgq_state->csr_list.find(info.id);
+		// A graph without edges has no CSR, and no k-core either
+		if (csr_entry != duckpgq_state->csr_list.end()) {
+			auto &csr = *csr_entry->second;
+			csr.LoadPartitions(info.context);
+			vector<int64_t> core;
+			KCoreDecomposition(info.context, csr, core);
+			duckpgq_state->csr_list[kcore_id] = BuildKCoreCSR(info.context, csr, core, k);
+			duckpgq_state->csr_to_delete.insert(kcore_id);
+		}
+	}
+	result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	ConstantVector::GetData<int64_t>(result)[0] = 0;
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterKCoreScalarFunctions(ExtensionLoader &loader) {
+	// csr_id, rowid
+	loader.RegisterFunction(ScalarFunction("kcore", {LogicalType::INTEGER, LogicalType::BIGINT}, LogicalType::BIGINT,
+	                                       KCoreFunction, KCoreFunctionData::KCoreBind));
+	// csr_id, id of the k-core CSR, k, a value computed from the CSR
+	loader.RegisterFunction(ScalarFunction(
+	    "create_csr_kcore", {LogicalType::INTEGER, LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT},
+	    LogicalType::BIGINT, CreateCsrKCoreFunction, CSRFunctionData::CSRBind));
+}
+
+} // namespace duckdb
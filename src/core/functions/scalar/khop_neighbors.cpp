@@ -0,0 +1,152 @@
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/iterative_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+#include "duckpgq/core/utils/msbfs_engine.hpp"
+#include "duckpgq/core/utils/single_source_bfs.hpp"
+
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+static LogicalType KHopNeighborsType() {
+	child_list_t<LogicalType> children;
+	children.push_back(make_pair("vertex", LogicalType::BIGINT));
+	children.push_back(make_pair("depth", LogicalType::BIGINT));
+	return LogicalType::LIST(LogicalType::STRUCT(children));
+}
+
+//! The hooks of the k-hop searches: every step appends the vertices it reached for the first time to the neighbors of
+//! their lanes, so the neighbors of a source come out by increasing depth and no depth array is needed
+struct KHopNeighborsVisitor : public MSBFSVisitor {
+	explicit KHopNeighborsVisitor(vector<vector<std::pair<int64_t, int64_t>>> &neighbors) : neighbors(neighbors) {
+	}
+
+	template <idx_t LANES>
+	void Reached(const int64_t *lane_to_group, int64_t vertex, const LaneBitset<LANES> &lanes, int64_t depth) {
+		lanes.ForEach([&](idx_t lane) { neighbors[lane_to_group[lane]].emplace_back(vertex, depth); });
+	}
+
+	vector<vector<std::pair<int64_t, int64_t>>> &neighbors;
+};
+
+//! The neighbors of all groups, from batches of multi-source searches of at most [k] steps
+static void KHopNeighborsSearch(ClientContext &context, CSR &csr, int64_t v_size, MSBFSScratch &scratch,
+                                const MSBFSSourceGroups &groups, int64_t k,
+                                vector<vector<std::pair<int64_t, int64_t>>> &neighbors) {
+	// Every source reaches itself at depth 0
+	for (idx_t group = 0; group < groups.GroupCount(); group++) {
+		auto source = groups.sources[group];
+		if (source >= 0 && source < v_size) {
+			neighbors[group].emplace_back(source, 0);
+		}
+	}
+	KHopNeighborsVisitor visitor(neighbors);
+	RunMSBFSBatches<MSBFSTermination::DEPTH_BOUND, false>(context, csr, v_size, scratch, groups, k, visitor);
+}
+
+//! Runs one search per group that only follows the edges [filter] allows, which the multi-source steps cannot test
+template <class ID_T>
+static void KHopNeighborsFiltered(CSR &csr, int64_t v_size, const MSBFSSourceGroups &groups, int64_t k,
+                                  const EdgeFilter &filter, vector<vector<std::pair<int64_t, int64_t>>> &neighbors) {
+	SingleSourceBFS<ID_T, EdgeFilter, false> bfs(csr, v_size, filter);
+	for (idx_t group = 0; group < groups.GroupCount(); group++) {
+		auto source = groups.sources[group];
+		if (source < 0 || source >= v_size) {
+			continue;
+		}
+		bfs.Run(source, k);
+		for (auto vertex : bfs.Reached()) {
+			neighbors[group].emplace_back(vertex, bfs.Depth(vertex));
+		}
+	}
+}
+
+static void KHopNeighborsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
+	UnifiedVectorFormat vdata_src;
+	UnifiedVectorFormat vdata_k;
+	args.data[2].ToUnifiedFormat(args.size(), vdata_src);
+	args.data[3].ToUnifiedFormat(args.size(), vdata_k);
+	auto k_pos = vdata_k.sel->get_index(0);
+	if (!vdata_k.validity.RowIsValid(k_pos) || UnifiedVectorFormat::GetData<int64_t>(vdata_k)[k_pos] < 0) {
+		throw InvalidInputException("khop_neighbors needs a non-negative number of hops");
+	}
+	auto k = UnifiedVectorFormat::GetData<int64_t>(vdata_k)[k_pos];
+
+	auto &local_state = PathFunctionLocalState::Get(state);
+	auto &csr = local_state.Bind(info.context, info.csr_id, true);
+	auto v_size = local_state.VertexCount();
+	auto src_data = csr.InternalIds(vdata_src, args.size(), local_state.source_ids);
+
+	// Rows without a source are NULL, the others share one lane per distinct source
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<list_entry_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	for (idx_t row = 0; row < args.size(); row++) {
+		if (!vdata_src.validity.RowIsValid(vdata_src.sel->get_index(row))) {
+			result_validity.SetInvalid(row);
+		}
+		result_data[row].offset = 0;
+		result_data[row].length = 0;
+	}
+	MSBFSSourceGroups groups;
+	groups.Initialize(args.size(), *vdata_src.sel, vdata_src.validity, src_data);
+	vector<vector<std::pair<int64_t, int64_t>>> neighbors(groups.GroupCount());
+	// The edge predicate, the optional constant argument 4
+	auto filter = local_state.GetEdgeFilter(args, 4, csr);
+	if (filter && csr.compact) {
+		KHopNeighborsFiltered<int32_t>(csr, v_size, groups, k, *filter, neighbors);
+	} else if (filter) {
+		KHopNeighborsFiltered<int64_t>(csr, v_size, groups, k, *filter, neighbors);
+	} else {
+		KHopNeighborsSearch(info.context, csr, v_size, local_state.scratch, groups, k, neighbors);
+	}
+
+	idx_t total_size = 0;
+	for (idx_t group = 0; group < groups.GroupCount(); group++) {
+		total_size += neighbors[group].size() * (groups.offsets[group + 1] - groups.offsets[group]);
+	}
+	ListVector::Reserve(result, total_size);
+	auto &entries = StructVector::GetEntries(ListVector::GetEntry(result));
+	auto vertex_data = FlatVector::GetData<int64_t>(*entries[0]);
+	auto depth_data = FlatVector::GetData<int64_t>(*entries[1]);
+	idx_t offset = 0;
+	for (idx_t group = 0; group < groups.GroupCount(); group++) {
+		for (auto i = groups.offsets[group]; i < groups.offsets[group + 1]; i++) {
+			auto row = groups.rows[i];
+			result_data[row].offset = offset;
+			result_data[row].length = neighbors[group].size();
+			for (auto &entry : neighbors[group]) {
+				vertex_data[offset] = csr.ExternalId(entry.first);
+				depth_data[offset] = entry.second;
+				offset++;
+			}
+		}
+	}
+	ListVector::SetListSize(result, offset);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterKHopNeighborsScalarFunction(ExtensionLoader &loader) {
+	// csr_id, vertex count, source, number of hops[, edge filter]
+	ScalarFunctionSet set("khop_neighbors");
+	ScalarFunction function("khop_neighbors",
+	                        {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
+	                        KHopNeighborsType(), KHopNeighborsFunction,
+	                        IterativeLengthFunctionData::DeltaAwareBind);
+	function.init_local_state = PathFunctionLocalState::Init;
+	set.AddFunction(function);
+	function.arguments.emplace_back();
+	for (auto &filter_type : EdgeFilter::ArgumentTypes()) {
+		function.arguments.back() = filter_type;
+		set.AddFunction(function);
+	}
+	loader.RegisterFunction(set);
+}
+
+} // namespace duckdb
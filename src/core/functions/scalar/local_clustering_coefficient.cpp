@@ -1,13 +1,31 @@
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckpgq/common.hpp"
 #include "duckpgq/core/functions/function_data/local_clustering_coefficient_function_data.hpp"
-#include "duckpgq/core/utils/duckpgq_bitmap.hpp"
+#include "duckpgq/core/utils/csr_triangles.hpp"
 #include "duckpgq/core/utils/duckpgq_utils.hpp"
 
 #include <duckpgq/core/functions/scalar.hpp>
 
 namespace duckdb {
 
+//! Local clustering coefficient of every vertex, from the triangles through it and its number of distinct neighbors
+static void ComputeLocalClusteringCoefficients(ClientContext &context, CSR &csr, vector<float> &coefficients) {
+	vector<int64_t> triangles;
+	vector<int64_t> degrees;
+	CountTriangles(context, csr, &triangles);
+	CountSimpleDegrees(context, csr, degrees);
+	coefficients.resize(degrees.size());
+	for (idx_t i = 0; i < degrees.size(); i++) {
+		if (degrees[i] < 2) {
+			coefficients[i] = static_cast<float>(0.0);
+			continue;
+		}
+		// Every triangle connects two pairs of neighbors in the adjacency lists of both endpoints
+		const float num_edges_float = static_cast<float>(degrees[i]);
+		coefficients[i] = static_cast<float>(2 * triangles[i]) / (num_edges_float * (num_edges_float - 1.0f));
+	}
+}
+
 static void LocalClusteringCoefficientFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
 	auto &info = func_expr.bind_info->Cast<LocalClusteringCoefficientFunctionData>();
@@ -21,9 +39,9 @@ static void LocalClusteringCoefficientFunction(DataChunk &args, ExpressionState
 	if (!(csr_entry->second->initialized_v && csr_entry->second->initialized_e)) {
 		throw ConstraintException("Need to initialize CSR before doing local clustering coefficient.");
 	}
-	int64_t *v = reinterpret_cast<int64_t *>(duckpgq_state->csr_list[info.csr_id]->v.get());
-	vector<int64_t> &e = duckpgq_state->csr_list[info.csr_id]->e;
-	size_t v_size = duckpgq_state->csr_list[info.csr_id]->vsize;
+	auto &csr = *csr_entry->second;
+	csr.LoadPartitions(info.context);
+	auto vertex_count = static_cast<int64_t>(csr.vsize - 2);
 	// get src and dst vectors for searches
 	auto &src = args.data[1];
 	UnifiedVectorFormat vdata_src;
@@ -35,38 +53,20 @@ static void LocalClusteringCoefficientFunction(DataChunk &args, ExpressionState
 	result.SetVectorType(VectorType::FLAT_VECTOR);
 	auto result_data = FlatVector::GetData<float>(result);
 
-	DuckPGQBitmap neighbors(v_size);
+	info.once.Run([&]() { ComputeLocalClusteringCoefficients(info.context, csr, info.coefficients); });
 
 	for (idx_t n = 0; n < args.size(); n++) {
 		auto src_sel = vdata_src.sel->get_index(n);
 		if (!vdata_src.validity.RowIsValid(src_sel)) {
 			result_validity.SetInvalid(n);
-		}
-		int64_t src_node = src_data[src_sel];
-		int64_t number_of_edges = v[src_node + 1] - v[src_node];
-		if (number_of_edges < 2) {
-			result_data[n] = static_cast<float>(0.0);
 			continue;
 		}
-		neighbors.reset();
-		for (int64_t offset = v[src_node]; offset < v[src_node + 1]; offset++) {
-			neighbors.set(e[offset]);
-		}
-
-		// Count connections between neighbors
-		int64_t count = 0;
-		for (int64_t offset = v[src_node]; offset < v[src_node + 1]; offset++) {
-			int64_t neighbor = e[offset];
-			for (int64_t offset2 = v[neighbor]; offset2 < v[neighbor + 1]; offset2++) {
-				int is_connected = neighbors.test(e[offset2]);
-				count += is_connected; // Add 1 if connected, 0 otherwise
-			}
+		int64_t src_node = csr.InternalId(src_data[src_sel]);
+		if (src_node < 0 || src_node >= vertex_count) {
+			result_validity.SetInvalid(n);
+			continue;
 		}
-
-		const float num_edges_float = static_cast<float>(number_of_edges);
-		float local_result = static_cast<float>(count) / (num_edges_float * (num_edges_float - 1.0f));
-
-		result_data[n] = local_result;
+		result_data[n] = info.coefficients[src_node];
 	}
 	duckpgq_state->csr_to_delete.insert(info.csr_id);
 }
@@ -1,13 +1,197 @@
+#include "duckdb/parallel/task_scheduler.hpp"
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckpgq/common.hpp"
 #include "duckpgq/core/functions/function_data/pagerank_function_data.hpp"
 #include <duckpgq/core/functions/scalar.hpp>
 #include <duckpgq/core/functions/table/pagerank.hpp>
+#include <duckpgq/core/utils/csr_algebra.hpp>
+#include <duckpgq/core/utils/csr_blocks.hpp>
 #include <duckpgq/core/utils/duckpgq_bitmap.hpp>
+#include <duckpgq/core/utils/duckpgq_parallel.hpp>
 #include <duckpgq/core/utils/duckpgq_utils.hpp>
+#include <duckpgq/core/utils/partitioned_csr.hpp>
+#include <duckpgq/core/utils/traversal_metrics.hpp>
 
 namespace duckdb {
 
+//! Vertices per partition of the PageRank iterations
+static constexpr idx_t PAGERANK_PARTITION_SIZE = 8192;
+
+//! Sets the ranks the iterations start from: the cached ranks of the warm start key if there are any, otherwise the
+//! uniform vector. Vertices that were added since the ranks were cached start from 1 / n and the vector is scaled
+//! back to a sum of one.
+static void InitializeRanks(DuckPGQState &duckpgq_state, PageRankFunctionData &info, idx_t vertex_count) {
+	auto uniform_rank = 1.0 / static_cast<double_t>(vertex_count);
+	info.rank.assign(vertex_count, uniform_rank);
+	info.temp_rank.assign(vertex_count, 0.0);
+	info.iteration_count = 0;
+	info.converged = false;
+	info.state_initialized = true;
+	if (info.warm_start_key.empty()) {
+		return;
+	}
+	lock_guard<mutex> guard(duckpgq_state.pagerank_cache_lock);
+	auto entry = duckpgq_state.pagerank_cache.find(info.warm_start_key);
+	if (entry == duckpgq_state.pagerank_cache.end()) {
+		return;
+	}
+	auto &cached_rank = entry->second;
+	double_t total = 0;
+	for (idx_t i = 0; i < vertex_count; i++) {
+		if (i < cached_rank.size()) {
+			info.rank[i] = cached_rank[i];
+		}
+		total += info.rank[i];
+	}
+	if (total <= 0) {
+		info.rank.assign(vertex_count, uniform_rank);
+		return;
+	}
+	for (auto &rank : info.rank) {
+		rank /= total;
+	}
+}
+
+//! Sums the [contribution] of the incoming edges of every vertex into [incoming] for a partitioned CSR, which has
+//! no reverse CSR to pull from. The partitions are pushed in waves of one partition per thread, each of which
+//! buffers its (destination, contribution) pairs by destination range. The ranges then add up the buffers of the
+//! wave in partition order, so every sum is taken in ascending source order like the pull over the reverse CSR.
+static void PushContributions(ClientContext &context, const CSRPartitions &partitions, const int64_t *v,
+                              const vector<double_t> &contribution, vector<double_t> &incoming) {
+	auto vertex_count = incoming.size();
+	auto threads = MaxValue<idx_t>(static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads()), 1);
+	auto range_count = MaxValue<idx_t>(MinValue<idx_t>(threads, vertex_count), 1);
+	auto range_size = (vertex_count + range_count - 1) / range_count;
+	vector<vector<vector<pair<int64_t, double_t>>>> pushed(threads,
+	                                                       vector<vector<pair<int64_t, double_t>>>(range_count));
+	std::fill(incoming.begin(), incoming.end(), 0.0);
+	MemoryReservation memory;
+	for (idx_t wave_begin = 0; wave_begin < partitions.Count(); wave_begin += threads) {
+		auto wave_size = MinValue<idx_t>(threads, partitions.Count() - wave_begin);
+		idx_t wave_edges = 0;
+		for (idx_t w = 0; w < wave_size; w++) {
+			wave_edges += partitions.Get(wave_begin + w).EdgeCount();
+		}
+		memory.Resize(context, wave_edges * sizeof(pair<int64_t, double_t>));
+		ParallelFor(context, wave_size, 1, [&](idx_t begin, idx_t end) {
+			for (auto w = begin; w < end; w++) {
+				auto &buffers = pushed[w];
+				for (auto &buffer : buffers) {
+					buffer.clear();
+				}
+				auto &partition = partitions.Get(wave_begin + w);
+				auto handle = partitions.Pin(wave_begin + w);
+				for (auto i = partition.vertex_begin; i < partition.vertex_end; i++) {
+					for (auto offset = v[i]; offset < v[i + 1]; offset++) {
+						auto n = handle.Neighbor(offset);
+						buffers[static_cast<idx_t>(n) / range_size].emplace_back(n, contribution[i]);
+					}
+				}
+			}
+		});
+		ParallelFor(context, range_count, 1, [&](idx_t begin, idx_t end) {
+			for (auto r = begin; r < end; r++) {
+				for (idx_t w = 0; w < wave_size; w++) {
+					for (auto &message : pushed[w][r]) {
+						incoming[message.first] += message.second;
+					}
+				}
+			}
+		});
+	}
+}
+
+//! Runs the power iteration from [info.rank] until the largest change of a rank drops below the convergence
+//! threshold or max_iterations is reached. Every iteration pulls the contributions of the incoming edges as the
+//! product of the reverse adjacency matrix and the contributions over the plus-times semiring, see MxV, so every sum
+//! is written by a single task, no atomics are needed and a vertex with millions of in-edges does not hold up the
+//! others. The pass over the ranks then computes the contributions and the dangling mass of the next iteration. A
+//! partitioned CSR pushes the contributions from its partitions instead, see PushContributions. The iterations are
+//! counted in [counters].
+template <class ID_T>
+static void PageRankIterations(ClientContext &context, CSR &csr, PageRankFunctionData &info,
+                               TraversalCounters &counters) {
+	auto vertex_count = csr.vsize - 2;
+	auto n = static_cast<double_t>(vertex_count);
+	auto *v = reinterpret_cast<int64_t *>(csr.v.get());
+	auto partitions = csr.GetPartitions();
+	// The contributions of the incoming edges of every vertex: the reverse adjacency matrix times the contributions
+	vector<double_t> incoming(vertex_count, 0.0);
+	unique_ptr<CSRMatrix<PlusTimesSemiring<double_t>, ID_T>> in_matrix;
+	shared_ptr<const CSRBlocks> in_blocks;
+	if (!partitions) {
+		auto &reverse = csr.GetReverse(context);
+		in_matrix = make_uniq<CSRMatrix<PlusTimesSemiring<double_t>, ID_T>>(reverse);
+		in_blocks = reverse.GetBlocks(CSRBlockEdges(context, reverse.EdgeCount()));
+	}
+
+	auto partition_count = (vertex_count + PAGERANK_PARTITION_SIZE - 1) / PAGERANK_PARTITION_SIZE;
+	vector<double_t> partition_dangling(partition_count, 0.0);
+	vector<double_t> partition_delta(partition_count, 0.0);
+	// The rank every vertex sends over each of its outgoing edges, vertices without outgoing edges are dangling and
+	// spread their rank over all vertices
+	vector<double_t> contribution(vertex_count, 0.0);
+	vector<double_t> next_contribution(vertex_count, 0.0);
+	counters.scratch_bytes += (3 * vertex_count + 2 * partition_count) * sizeof(double_t);
+
+	auto contribute = [&](idx_t i, double_t rank, vector<double_t> &target, double_t &dangling) {
+		auto degree = v[i + 1] - v[i];
+		if (degree > 0) {
+			target[i] = rank / static_cast<double_t>(degree);
+		} else {
+			target[i] = 0;
+			dangling += rank;
+		}
+	};
+	ParallelFor(context, vertex_count, PAGERANK_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		double_t dangling = 0;
+		for (idx_t i = begin; i < end; i++) {
+			contribute(i, info.rank[i], contribution, dangling);
+		}
+		partition_dangling[begin / PAGERANK_PARTITION_SIZE] = dangling;
+	});
+
+	auto base_rank = (1 - info.damping_factor) / n;
+	while (info.iteration_count < info.max_iterations) {
+		double_t total_dangling_rank = 0.0;
+		for (auto dangling : partition_dangling) {
+			total_dangling_rank += dangling;
+		}
+		auto correction_factor = total_dangling_rank / n;
+		if (partitions) {
+			PushContributions(context, *partitions, v, contribution, incoming);
+		} else {
+			MxV(context, *in_matrix, *in_blocks, contribution, incoming);
+		}
+		ParallelFor(context, vertex_count, PAGERANK_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+			double_t dangling = 0;
+			double_t max_delta = 0;
+			for (idx_t i = begin; i < end; i++) {
+				auto new_rank = base_rank + info.damping_factor * (incoming[i] + correction_factor);
+				max_delta = MaxValue<double_t>(max_delta, std::abs(new_rank - info.rank[i]));
+				info.temp_rank[i] = new_rank;
+				contribute(i, new_rank, next_contribution, dangling);
+			}
+			partition_dangling[begin / PAGERANK_PARTITION_SIZE] = dangling;
+			partition_delta[begin / PAGERANK_PARTITION_SIZE] = max_delta;
+		});
+
+		info.rank.swap(info.temp_rank);
+		contribution.swap(next_contribution);
+		info.iteration_count++;
+		counters.iterations++;
+		counters.edges += csr.EdgeCount();
+		double_t max_delta = 0.0;
+		for (auto delta : partition_delta) {
+			max_delta = MaxValue<double_t>(max_delta, delta);
+		}
+		if (max_delta < info.convergence_threshold) {
+			break;
+		}
+	}
+	info.converged = true;
+}
+
 static void PageRankFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
 	auto &info = func_expr.bind_info->Cast<PageRankFunctionData>();
@@ -23,67 +207,28 @@ static void PageRankFunction(DataChunk &args, ExpressionState &state, Vector &re
 		throw ConstraintException("Need to initialize CSR before running PageRank.");
 	}
 
-	auto *v = reinterpret_cast<int64_t *>(duckpgq_state->csr_list[info.csr_id]->v.get());
-	vector<int64_t> &e = duckpgq_state->csr_list[info.csr_id]->e;
-	size_t v_size = duckpgq_state->csr_list[info.csr_id]->vsize;
-
-	// State initialization (only once)
-	if (!info.state_initialized) {
-		info.rank.resize(v_size, 1.0 / static_cast<double>(v_size)); // Initial rank for each node
-		info.temp_rank.resize(v_size,
-		                      0.0);        // Temporary storage for ranks during iteration
-		info.damping_factor = 0.85;        // Typical damping factor
-		info.convergence_threshold = 1e-6; // Convergence threshold
-		info.state_initialized = true;
-		info.converged = false;
-		info.iteration_count = 0;
-	}
-
-	// Check if already converged
-	if (!info.converged) {
-		std::lock_guard<std::mutex> guard(info.state_lock); // Thread safety
-
-		// Double-check after acquiring lock to avoid race condition
-		if (!info.converged) {
-			bool continue_iteration = true;
-			while (continue_iteration) {
-				fill(info.temp_rank.begin(), info.temp_rank.end(), 0.0);
-
-				double total_dangling_rank = 0.0; // For dangling nodes
-
-				for (size_t i = 0; i < v_size; i++) {
-					auto start_edge = v[i];
-					auto end_edge = (i + 1 < v_size) ? v[i + 1] : e.size(); // Adjust end_edge
-					auto edge_count = end_edge - start_edge;
-					if (edge_count > 0) {
-						double rank_contrib = info.rank[i] / static_cast<double>(edge_count);
-						for (int64_t j = start_edge; j < end_edge; j++) {
-							int64_t neighbor = e[j];
-							info.temp_rank[neighbor] += rank_contrib;
-						}
-					} else {
-						total_dangling_rank += info.rank[i];
-					}
-				}
-
-				// Apply damping factor and handle dangling node ranks
-				double correction_factor = total_dangling_rank / static_cast<double>(v_size);
-				double base_rank = (1 - info.damping_factor) / static_cast<double>(v_size);
-				double max_delta = 0.0;
-				for (size_t i = 0; i < v_size; i++) {
-					info.temp_rank[i] = base_rank + info.damping_factor * (info.temp_rank[i] + correction_factor);
-					max_delta = std::max(max_delta, std::abs(info.temp_rank[i] - info.rank[i]));
-				}
+	auto &csr = *csr_entry->second;
+	// The last two entries of v only delimit the adjacency lists and are not vertices
+	auto vertex_count = static_cast<int64_t>(csr.vsize - 2);
 
-				info.rank.swap(info.temp_rank);
-				info.iteration_count++;
-				if (max_delta < info.convergence_threshold) {
-					info.converged = true;
-					continue_iteration = false;
-				}
-			}
+	// The threads that arrive while the ranks are computed work on the iterations instead of waiting
+	info.once.Run([&]() {
+		if (vertex_count == 0) {
+			return;
 		}
-	}
+		auto traversal_metrics = TraversalMetrics::Get(info.context);
+		TraversalMetricsScope metrics(*traversal_metrics, TraversalKernel::PAGERANK);
+		InitializeRanks(*duckpgq_state, info, vertex_count);
+		if (csr.compact) {
+			PageRankIterations<int32_t>(info.context, csr, info, metrics.counters);
+		} else {
+			PageRankIterations<int64_t>(info.context, csr, info, metrics.counters);
+		}
+		if (!info.warm_start_key.empty()) {
+			lock_guard<mutex> cache_guard(duckpgq_state->pagerank_cache_lock);
+			duckpgq_state->pagerank_cache[info.warm_start_key] = info.rank;
+		}
+	});
 
 	// Get the source vector for the current DataChunk
 	auto &src = args.data[1];
@@ -103,8 +248,8 @@ static void PageRankFunction(DataChunk &args, ExpressionState &state, Vector &re
 			result_validity.SetInvalid(i);
 			continue; // Skip invalid rows
 		}
-		auto node_id = src_data[id_pos];
-		if (node_id < 0 || node_id >= v_size) {
+		auto node_id = csr.InternalId(src_data[id_pos]);
+		if (node_id < 0 || node_id >= vertex_count) {
 			result_validity.SetInvalid(i);
 			continue;
 		}
@@ -118,8 +263,14 @@ static void PageRankFunction(DataChunk &args, ExpressionState &state, Vector &re
 // Register functions
 //------------------------------------------------------------------------------
 void CoreScalarFunctions::RegisterPageRankScalarFunction(ExtensionLoader &loader) {
-	loader.RegisterFunction(ScalarFunction("pagerank", {LogicalType::INTEGER, LogicalType::BIGINT}, LogicalType::DOUBLE,
-	                                       PageRankFunction, PageRankFunctionData::PageRankBind));
+	ScalarFunctionSet set("pagerank");
+	set.AddFunction(ScalarFunction({LogicalType::INTEGER, LogicalType::BIGINT}, LogicalType::DOUBLE, PageRankFunction,
+	                               PageRankFunctionData::PageRankBind));
+	// Damping factor, convergence threshold, maximum number of iterations and warm start key
+	set.AddFunction(ScalarFunction({LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::DOUBLE,
+	                                LogicalType::DOUBLE, LogicalType::BIGINT, LogicalType::VARCHAR},
+	                               LogicalType::DOUBLE, PageRankFunction, PageRankFunctionData::PageRankBind));
+	loader.RegisterFunction(set);
 }
 
 } // namespace duckdb
@@ -0,0 +1,103 @@
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/pagerank_function_data.hpp"
+#include "duckpgq/core/utils/msbfs.hpp"
+#include "duckpgq/core/utils/personalized_pagerank.hpp"
+
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/duckpgq_parallel.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+static LogicalType PersonalizedPageRankType() {
+	child_list_t<LogicalType> children;
+	children.push_back(make_pair("vertex", LogicalType::BIGINT));
+	children.push_back(make_pair("score", LogicalType::DOUBLE));
+	return LogicalType::LIST(LogicalType::STRUCT(children));
+}
+
+static void PersonalizedPageRankFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<PageRankFunctionData>();
+	auto duckpgq_state = GetDuckPGQState(info.context);
+	auto &csr = *duckpgq_state->GetCSR(info.csr_id);
+	csr.LoadPartitions(info.context);
+	auto vertex_count = static_cast<int64_t>(csr.vsize - 2);
+
+	UnifiedVectorFormat vdata_seed;
+	args.data[1].ToUnifiedFormat(args.size(), vdata_seed);
+	vector<int64_t> seed_ids;
+	auto seed_data = csr.InternalIds(vdata_seed, args.size(), seed_ids);
+
+	// Rows with the same seed share one push, the way the BFS kernels share a lane between them
+	MSBFSSourceGroups groups;
+	groups.Initialize(args.size(), *vdata_seed.sel, vdata_seed.validity, seed_data);
+	vector<vector<std::pair<int64_t, double>>> top(groups.GroupCount());
+	auto thread_count = static_cast<idx_t>(TaskScheduler::GetScheduler(info.context).NumberOfThreads());
+	auto morsel_size = MaxValue<idx_t>(1, (groups.GroupCount() + thread_count - 1) / thread_count);
+	ParallelFor(info.context, groups.GroupCount(), morsel_size, [&](idx_t begin, idx_t end) {
+		PersonalizedPageRankPush push(csr, info.damping_factor, info.convergence_threshold);
+		for (idx_t group = begin; group < end; group++) {
+			auto seed = groups.sources[group];
+			if (seed < 0 || seed >= vertex_count) {
+				continue;
+			}
+			push.Run(seed);
+			push.TopK(static_cast<idx_t>(info.top_k), top[group]);
+		}
+	});
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<list_entry_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	idx_t total_size = 0;
+	for (idx_t group = 0; group < groups.GroupCount(); group++) {
+		total_size += top[group].size() * (groups.offsets[group + 1] - groups.offsets[group]);
+	}
+	ListVector::Reserve(result, total_size);
+	auto &entries = StructVector::GetEntries(ListVector::GetEntry(result));
+	auto vertex_data = FlatVector::GetData<int64_t>(*entries[0]);
+	auto score_data = FlatVector::GetData<double>(*entries[1]);
+
+	for (idx_t i = 0; i < args.size(); i++) {
+		result_validity.SetInvalid(i);
+	}
+	idx_t offset = 0;
+	for (idx_t group = 0; group < groups.GroupCount(); group++) {
+		auto &group_top = top[group];
+		if (group_top.empty()) {
+			// Seeds outside of the graph stay NULL
+			continue;
+		}
+		for (auto i = groups.offsets[group]; i < groups.offsets[group + 1]; i++) {
+			auto row = groups.rows[i];
+			result_validity.SetValid(row);
+			result_data[row].offset = offset;
+			result_data[row].length = group_top.size();
+			for (auto &entry : group_top) {
+				vertex_data[offset] = csr.ExternalId(entry.first);
+				score_data[offset] = entry.second;
+				offset++;
+			}
+		}
+	}
+	ListVector::SetListSize(result, offset);
+	duckpgq_state->csr_to_delete.insert(info.csr_id);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterPersonalizedPageRankScalarFunction(ExtensionLoader &loader) {
+	// csr_id, seed, k, damping factor, tolerance
+	loader.RegisterFunction(ScalarFunction("personalized_pagerank",
+	                                       {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT,
+	                                        LogicalType::DOUBLE, LogicalType::DOUBLE},
+	                                       PersonalizedPageRankType(), PersonalizedPageRankFunction,
+	                                       PageRankFunctionData::PersonalizedPageRankBind));
+}
+
+} // namespace duckdb
@@ -0,0 +1,105 @@
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/random_walks_function_data.hpp"
+
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+//! The walks_per_node random walks from the vertex with rowid in argument 1, every walk a list of the rowids of its
+//! vertices starting with the vertex itself. The walks are written straight into the child vectors of the result.
+static void RandomWalksFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<RandomWalksFunctionData>();
+	auto duckpgq_state = GetDuckPGQState(info.context);
+
+	auto csr_entry = duckpgq_state->csr_list.find(info.csr_id);
+	if (csr_entry == duckpgq_state->csr_list.end()) {
+		throw ConstraintException("CSR not found. Is the graph populated?");
+	}
+
+	if (!(csr_entry->second->initialized_v && csr_entry->second->initialized_e)) {
+		throw ConstraintException("Need to initialize CSR before generating random walks.");
+	}
+
+	auto &csr = *csr_entry->second;
+	csr.LoadPartitions(info.context);
+	auto vertex_count = static_cast<int64_t>(csr.VertexCount());
+
+	info.once.Run([&]() {
+		if (csr.initialized_w) {
+			info.alias_tables = make_shared_ptr<CSRAliasTables>(info.context, csr);
+		}
+	});
+
+	auto &src = args.data[1];
+	UnifiedVectorFormat vdata_src;
+	src.ToUnifiedFormat(args.size(), vdata_src);
+	auto src_data = UnifiedVectorFormat::GetData<int64_t>(vdata_src);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<list_entry_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	ListVector::Reserve(result, args.size() * info.walks_per_node);
+	auto &walks = ListVector::GetEntry(result);
+	auto walk_data = FlatVector::GetData<list_entry_t>(walks);
+	ListVector::Reserve(walks, args.size() * info.walks_per_node * info.parameters.length);
+	auto vertex_data = FlatVector::GetData<int64_t>(ListVector::GetEntry(walks));
+
+	idx_t walk_count = 0;
+	idx_t walk_vertex_count = 0;
+	for (idx_t i = 0; i < args.size(); i++) {
+		result_data[i].offset = walk_count;
+		result_data[i].length = 0;
+		auto id_pos = vdata_src.sel->get_index(i);
+		if (!vdata_src.validity.RowIsValid(id_pos)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		auto source = csr.InternalId(src_data[id_pos]);
+		if (source < 0 || source >= vertex_count) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		result_data[i].length = info.walks_per_node;
+		for (idx_t walk = 0; walk < info.walks_per_node; walk++) {
+			RandomWalkGenerator random(info.seed, src_data[id_pos], walk);
+			auto walk_vertices = vertex_data + walk_vertex_count;
+			auto length = RandomWalk(csr, info.alias_tables.get(), info.parameters, source, random, walk_vertices);
+			for (idx_t step = 0; step < length; step++) {
+				walk_vertices[step] = csr.ExternalId(walk_vertices[step]);
+			}
+			walk_data[walk_count].offset = walk_vertex_count;
+			walk_data[walk_count].length = length;
+			walk_count++;
+			walk_vertex_count += length;
+		}
+	}
+	ListVector::SetListSize(walks, walk_vertex_count);
+	ListVector::SetListSize(result, walk_count);
+
+	duckpgq_state->csr_to_delete.insert(info.csr_id);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterRandomWalksScalarFunction(ExtensionLoader &loader) {
+	ScalarFunctionSet set("random_walks");
+	// csr_id, rowid, walk length, walks per vertex
+	ScalarFunction function({LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
+	                        LogicalType::LIST(LogicalType::LIST(LogicalType::BIGINT)), RandomWalksFunction,
+	                        RandomWalksFunctionData::RandomWalksBind);
+	set.AddFunction(function);
+	// node2vec return and in-out parameters p and q
+	function.arguments.push_back(LogicalType::DOUBLE);
+	function.arguments.push_back(LogicalType::DOUBLE);
+	set.AddFunction(function);
+	// and the seed of the walks
+	function.arguments.push_back(LogicalType::BIGINT);
+	set.AddFunction(function);
+	loader.RegisterFunction(set);
+}
+
+} // namespace duckdb
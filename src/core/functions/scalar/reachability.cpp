@@ -3,148 +3,81 @@
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckpgq/common.hpp"
 #include "duckpgq/core/functions/function_data/iterative_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+#include "duckpgq/core/utils/csr_reachability_index.hpp"
+#include "duckpgq/core/utils/msbfs_engine.hpp"
 #include <duckpgq_extension.hpp>
 
 #include <duckpgq/core/functions/scalar.hpp>
 #include <duckpgq/core/utils/duckpgq_utils.hpp>
+#include <duckpgq/core/utils/lane_set.hpp>
 
 namespace duckdb {
 
 typedef enum { NO_ARRAY, ARRAY, INTERMEDIATE } msbfs_modes_t;
 
-static int16_t InitialiseBfs(idx_t curr_batch, idx_t size, data_ptr_t src_data, const SelectionVector *src_sel,
-                             const ValidityMask &src_validity, vector<std::bitset<LANE_LIMIT>> &seen,
-                             vector<std::bitset<LANE_LIMIT>> &visit, vector<std::bitset<LANE_LIMIT>> &visit_next,
-                             unordered_map<int64_t, pair<int16_t, vector<idx_t>>> &lane_map) {
-	int16_t lanes = 0;
-	int16_t curr_batch_size = 0;
-
-	for (idx_t i = curr_batch; i < size && lanes < LANE_LIMIT; i++) {
-		auto src_index = src_sel->get_index(i);
-
-		if (src_validity.RowIsValid(src_index)) {
-			auto src_entry = src_data[src_index];
-			auto entry = lane_map.find(src_entry);
-			if (entry == lane_map.end()) {
-				lane_map[src_entry].first = lanes;
-				seen[src_entry][lanes] = true;
-				visit[src_entry][lanes] = true;
-				lanes++;
-			}
-			lane_map[src_entry].second.push_back(i);
-			curr_batch_size++;
-		}
-	}
-	return curr_batch_size;
-}
-
-static bool BfsWithoutArrayVariant(bool exit_early, CSR *csr, int64_t input_size, vector<std::bitset<LANE_LIMIT>> &seen,
-                                   vector<std::bitset<LANE_LIMIT>> &visit, vector<std::bitset<LANE_LIMIT>> &visit_next,
+template <idx_t LANES, class ID_T>
+static bool BfsWithoutArrayVariant(bool exit_early, CSR *csr, int64_t input_size, vector<LaneBitset<LANES>> &seen,
+                                   vector<LaneBitset<LANES>> &visit, vector<LaneBitset<LANES>> &visit_next,
                                    vector<int64_t> &visit_list) {
+	auto &e = csr->GetNeighbors<ID_T>();
+	auto ranges = csr->GetRanges();
 	for (int64_t i = 0; i < input_size; i++) {
 		if (!visit[i].any()) {
 			continue;
 		}
 
-		for (auto index = (int64_t)csr->v[i]; index < csr->v[i + 1]; index++) {
-			auto n = csr->e[index];
+		for (auto index = ranges.begin[i]; index < ranges.end[i]; index++) {
+			auto n = e[index];
 			visit_next[n] = visit_next[n] | visit[i];
 		}
 	}
 
-	for (int64_t i = 0; i < input_size; i++) {
-		if (visit_next[i].none()) {
-			continue;
-		}
-		visit_next[i] = visit_next[i] & ~seen[i];
-		seen[i] = seen[i] | visit_next[i];
-		if (exit_early && visit_next[i].any()) {
-			exit_early = false;
-		}
-		if (visit_next[i].any()) {
-			visit_list.push_back(i);
-		}
-	}
-	return exit_early;
-}
-
-static bool BfsWithoutArray(bool exit_early, CSR *csr, int64_t input_size, vector<std::bitset<LANE_LIMIT>> &seen,
-                            vector<std::bitset<LANE_LIMIT>> &visit, vector<std::bitset<LANE_LIMIT>> &visit_next) {
-	for (int64_t i = 0; i < input_size; i++) {
-		if (!visit[i].any()) {
-			continue;
-		}
-
-		for (auto index = (int64_t)csr->v[i]; index < (int64_t)csr->v[i + 1]; index++) {
-			auto n = csr->e[index];
-			visit_next[n] = visit_next[n] | visit[i];
-		}
-	}
-
-	for (int64_t i = 0; i < input_size; i++) {
-		if (visit_next[i].none()) {
-			continue;
-		}
-		visit_next[i] = visit_next[i] & ~seen[i];
-		seen[i] = seen[i] | visit_next[i];
-		if (exit_early && visit_next[i].any()) {
-			exit_early = false;
-		}
-	}
-	return exit_early;
+	auto list_size = visit_list.size();
+	LaneBitset<LANES>::UpdateFrontierRange(visit_next, seen, 0, static_cast<idx_t>(input_size), visit_list);
+	return exit_early && visit_list.size() == list_size;
 }
 
+template <idx_t LANES, class ID_T>
 static pair<bool, size_t> BfsTempStateVariant(bool exit_early, CSR *csr, int64_t input_size,
-                                              vector<std::bitset<LANE_LIMIT>> &seen,
-                                              vector<std::bitset<LANE_LIMIT>> &visit,
-                                              vector<std::bitset<LANE_LIMIT>> &visit_next) {
-	size_t num_nodes_to_visit = 0;
+                                              vector<LaneBitset<LANES>> &seen, vector<LaneBitset<LANES>> &visit,
+                                              vector<LaneBitset<LANES>> &visit_next) {
+	auto &e = csr->GetNeighbors<ID_T>();
+	auto ranges = csr->GetRanges();
 	for (int64_t i = 0; i < input_size; i++) {
 		if (!visit[i].any()) {
 			continue;
 		}
 
-		for (auto index = (int64_t)csr->v[i]; index < (int64_t)csr->v[i + 1]; index++) {
-			auto n = csr->e[index];
+		for (auto index = ranges.begin[i]; index < ranges.end[i]; index++) {
+			auto n = e[index];
 			visit_next[n] = visit_next[n] | visit[i];
 		}
 	}
 
-	for (int64_t i = 0; i < input_size; i++) {
-		if (visit_next[i].none()) {
-			continue;
-		}
-		visit_next[i] = visit_next[i] & ~seen[i];
-		seen[i] = seen[i] | visit_next[i];
-		if (exit_early && visit_next[i].any()) {
-			exit_early = false;
-		}
-		if (visit_next[i].any()) {
-			num_nodes_to_visit++;
-		}
-	}
-	return pair<bool, size_t>(exit_early, num_nodes_to_visit);
+	vector<int64_t> reached;
+	LaneBitset<LANES>::UpdateFrontierRange(visit_next, seen, 0, static_cast<idx_t>(input_size), reached);
+	return pair<bool, size_t>(exit_early && reached.empty(), reached.size());
 }
 
-static bool BfsWithArrayVariant(bool exit_early, CSR *csr, vector<std::bitset<LANE_LIMIT>> &seen,
-                                vector<std::bitset<LANE_LIMIT>> &visit, vector<std::bitset<LANE_LIMIT>> &visit_next,
+template <idx_t LANES, class ID_T>
+static bool BfsWithArrayVariant(bool exit_early, CSR *csr, vector<LaneBitset<LANES>> &seen,
+                                vector<LaneBitset<LANES>> &visit, vector<LaneBitset<LANES>> &visit_next,
                                 vector<int64_t> &visit_list) {
+	auto &e = csr->GetNeighbors<ID_T>();
+	auto ranges = csr->GetRanges();
 	unordered_set<int64_t> neighbours_set;
 	for (int64_t i : visit_list) {
-		for (auto index = (int64_t)csr->v[i]; index < (int64_t)csr->v[i + 1]; index++) {
-			auto n = csr->e[index];
+		for (auto index = ranges.begin[i]; index < ranges.end[i]; index++) {
+			auto n = e[index];
 			visit_next[n] = visit_next[n] | visit[i];
 			neighbours_set.insert(n);
 		}
 	}
 	visit_list.clear();
 	for (int64_t i : neighbours_set) {
-		visit_next[i] = visit_next[i] & ~seen[i];
-		seen[i] = seen[i] | visit_next[i];
-		if (exit_early && visit_next[i].any()) {
+		if (LaneBitset<LANES>::UpdateFrontier(visit_next[i], seen[i])) {
 			exit_early = false;
-		}
-		if (visit_next[i].any()) {
 			visit_list.push_back(i);
 		}
 	}
@@ -162,105 +95,220 @@ static int FindMode(int mode, size_t visit_list_len, size_t visit_limit, size_t
 	return mode;
 }
 
-static void ReachabilityFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
-	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
-
-	bool is_variant = args.data[1].GetValue(0).GetValue<bool>();
-	int64_t input_size = args.data[2].GetValue(0).GetValue<int64_t>();
-
+//! Runs the searches of the variant that switches between sweeping all vertices and following a visit list
+template <idx_t LANES, class ID_T>
+static void ReachabilityExecute(ClientContext &context, CSR *csr, int64_t input_size,
+                                PathFunctionLocalState &local_state, DataChunk &args, Vector &result) {
 	auto &src = args.data[3];
 
 	UnifiedVectorFormat vdata_src, vdata_target;
 	src.ToUnifiedFormat(args.size(), vdata_src);
 
-	auto src_data = vdata_src.data;
+	auto src_data = csr->InternalIds(vdata_src, args.size(), local_state.source_ids);
 
 	auto &target = args.data[4];
 	target.ToUnifiedFormat(args.size(), vdata_target);
-	auto target_data = vdata_target.data;
+	auto target_data = csr->InternalIds(vdata_target, args.size(), local_state.target_ids);
 
-	idx_t result_size = 0;
 	vector<int64_t> visit_list;
 	size_t visit_limit = input_size / VISIT_SIZE_DIVISOR;
 	size_t num_nodes_to_visit = 0;
 	result.SetVectorType(VectorType::FLAT_VECTOR);
 
 	auto result_data = FlatVector::GetData<bool>(result);
-	auto duckpgq_state = GetDuckPGQState(info.context);
 
-	CSR *csr = duckpgq_state->GetCSR(info.csr_id);
-
-	while (result_size < args.size()) {
-		vector<std::bitset<LANE_LIMIT>> seen(input_size);
-		vector<std::bitset<LANE_LIMIT>> visit(input_size);
-		vector<std::bitset<LANE_LIMIT>> visit_next(input_size);
+	// Every lane answers the rows of one distinct source, rows without a source are unreachable
+	MSBFSSourceGroups groups;
+	groups.Initialize(args.size(), *vdata_src.sel, vdata_src.validity, src_data);
+	for (idx_t i = 0; i < args.size(); i++) {
+		if (!vdata_src.validity.RowIsValid(vdata_src.sel->get_index(i))) {
+			result_data[i] = false;
+		}
+	}
 
-		//! mapping of src_value ->  (bfs_num/lane, vector of indices in src_data)
-		unordered_map<int64_t, pair<int16_t, vector<idx_t>>> lane_map;
-		auto curr_batch_size = InitialiseBfs(result_size, args.size(), src_data, vdata_src.sel, vdata_src.validity,
-		                                     seen, visit, visit_next, lane_map);
+	// The arrays of the thread's earlier batches are reused, counted against memory_limit while the query runs
+	auto &buffers = local_state.scratch.Get<LANES>();
+	auto &seen = buffers.seen;
+	auto &visit = buffers.visit1;
+	auto &visit_next = buffers.visit2;
+	for (idx_t batch_begin = 0; batch_begin < groups.GroupCount(); batch_begin += LANES) {
+		auto batch_end = MinValue<idx_t>(batch_begin + LANES, groups.GroupCount());
+		buffers.Prepare(context, input_size, false);
+		// The steps below sweep all vertices, so the next batch may as well reset all of them
+		buffers.TouchAll();
+		for (auto group = batch_begin; group < batch_end; group++) {
+			auto source = groups.sources[group];
+			seen[source][group - batch_begin] = true;
+			visit[source][group - batch_begin] = true;
+		}
+		visit_list.clear();
+		num_nodes_to_visit = 0;
 		int mode = 0;
 		bool exit_early = false;
 		while (!exit_early) {
 			exit_early = true;
-			if (is_variant) {
-				mode = FindMode(mode, visit_list.size(), visit_limit, num_nodes_to_visit);
-				switch (mode) {
-				case 1:
-					exit_early = BfsWithArrayVariant(exit_early, csr, seen, visit, visit_next, visit_list);
-					break;
-				case 0:
-					exit_early =
-					    BfsWithoutArrayVariant(exit_early, csr, input_size, seen, visit, visit_next, visit_list);
-					break;
-				case 2: {
-					auto return_pair = BfsTempStateVariant(exit_early, csr, input_size, seen, visit, visit_next);
-					exit_early = return_pair.first;
-					num_nodes_to_visit = return_pair.second;
-					break;
-				}
-				default:
-					throw Exception(ExceptionType::INTERNAL, "Unknown reachability mode encountered");
-				}
-			} else {
-				exit_early = BfsWithoutArray(exit_early, csr, input_size, seen, visit, visit_next);
+			mode = FindMode(mode, visit_list.size(), visit_limit, num_nodes_to_visit);
+			switch (mode) {
+			case 1:
+				exit_early = BfsWithArrayVariant<LANES, ID_T>(exit_early, csr, seen, visit, visit_next, visit_list);
+				break;
+			case 0:
+				exit_early = BfsWithoutArrayVariant<LANES, ID_T>(exit_early, csr, input_size, seen, visit, visit_next,
+				                                                 visit_list);
+				break;
+			case 2: {
+				auto return_pair =
+				    BfsTempStateVariant<LANES, ID_T>(exit_early, csr, input_size, seen, visit, visit_next);
+				exit_early = return_pair.first;
+				num_nodes_to_visit = return_pair.second;
+				break;
+			}
+			default:
+				throw Exception(ExceptionType::INTERNAL, "Unknown reachability mode encountered");
 			}
 
-			visit = visit_next;
+			visit.swap(visit_next);
 			for (auto i = 0; i < input_size; i++) {
 				visit_next[i] = 0;
 			}
 		}
 
-		for (const auto &iter : lane_map) {
-			auto value = iter.first;
-			auto bfs_num = iter.second.first;
-			auto pos = iter.second.second;
-			for (auto index : pos) {
+		for (auto group = batch_begin; group < batch_end; group++) {
+			auto lane = group - batch_begin;
+			for (auto i = groups.offsets[group]; i < groups.offsets[group + 1]; i++) {
+				auto index = groups.rows[i];
 				auto target_index = vdata_target.sel->get_index(index);
-				if (seen[target_data[target_index]][bfs_num] && seen[value][bfs_num]) {
-					// if(is_bit_set(seen[target_data[index]], bfs_num) &
-					// is_bit_set(seen[value], bfs_num) ) {
-					result_data[index] = true;
-				} else {
-					result_data[index] = false;
-				}
+				result_data[index] = seen[target_data[target_index]][lane];
+			}
+		}
+	}
+}
+
+template <idx_t LANES>
+static void ReachabilityLanes(ClientContext &context, CSR &csr, int64_t input_size, PathFunctionLocalState &local_state,
+                              DataChunk &args, Vector &result) {
+	if (csr.compact) {
+		ReachabilityExecute<LANES, int32_t>(context, &csr, input_size, local_state, args, result);
+	} else {
+		ReachabilityExecute<LANES, int64_t>(context, &csr, input_size, local_state, args, result);
+	}
+}
+
+//! The hooks of the exhaustive searches: once a batch is done, every row is answered from whether the lane of its
+//! source has seen its target
+struct ReachabilityVisitor : public MSBFSVisitor {
+	ReachabilityVisitor(const MSBFSSourceGroups &groups, const UnifiedVectorFormat &vdata_target,
+	                    const int64_t *target_data, bool *result_data)
+	    : groups(groups), vdata_target(vdata_target), target_data(target_data), result_data(result_data) {
+	}
+
+	template <idx_t LANES>
+	void FinishBatch(MSBFSScratchBuffers<LANES> &buffers, const int64_t *lane_to_group) {
+		for (idx_t lane = 0; lane < LANES; lane++) {
+			auto group = lane_to_group[lane];
+			if (group == -1) {
+				continue;
+			}
+			for (auto i = groups.offsets[group]; i < groups.offsets[group + 1]; i++) {
+				auto index = groups.rows[i];
+				result_data[index] = buffers.seen[target_data[vdata_target.sel->get_index(index)]][lane];
 			}
 		}
-		result_size = result_size + curr_batch_size;
 	}
-	duckpgq_state->csr_to_delete.insert(info.csr_id);
+
+	const MSBFSSourceGroups &groups;
+	const UnifiedVectorFormat &vdata_target;
+	const int64_t *target_data;
+	bool *result_data;
+};
+
+//! Runs the searches of the distinct sources until they reach no new vertex, over the shared multi-source steps
+static void ReachabilitySearch(ClientContext &context, CSR &csr, int64_t input_size,
+                               PathFunctionLocalState &local_state, DataChunk &args, Vector &result) {
+	UnifiedVectorFormat vdata_src;
+	UnifiedVectorFormat vdata_target;
+	args.data[3].ToUnifiedFormat(args.size(), vdata_src);
+	args.data[4].ToUnifiedFormat(args.size(), vdata_target);
+	auto src_data = csr.InternalIds(vdata_src, args.size(), local_state.source_ids);
+	auto target_data = csr.InternalIds(vdata_target, args.size(), local_state.target_ids);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<bool>(result);
+	// Rows without a source, or with one outside of the CSR, are unreachable
+	for (idx_t i = 0; i < args.size(); i++) {
+		result_data[i] = false;
+	}
+	MSBFSSourceGroups groups;
+	groups.Initialize(args.size(), *vdata_src.sel, vdata_src.validity, src_data);
+	ReachabilityVisitor visitor(groups, vdata_target, target_data, result_data);
+	RunMSBFSBatches<MSBFSTermination::EXHAUST, false>(context, csr, input_size, local_state.scratch, groups, 0,
+	                                                   visitor);
+}
+
+//! Answers every row from the reachability index of the CSR instead of running the searches
+static void ReachabilityFromIndex(const CSRReachabilityIndex &index, CSR &csr, PathFunctionLocalState &local_state,
+                                  DataChunk &args, Vector &result) {
+	UnifiedVectorFormat vdata_src;
+	UnifiedVectorFormat vdata_target;
+	args.data[3].ToUnifiedFormat(args.size(), vdata_src);
+	args.data[4].ToUnifiedFormat(args.size(), vdata_target);
+	auto src_data = csr.InternalIds(vdata_src, args.size(), local_state.source_ids);
+	auto target_data = csr.InternalIds(vdata_target, args.size(), local_state.target_ids);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<bool>(result);
+	for (idx_t i = 0; i < args.size(); i++) {
+		auto src_index = vdata_src.sel->get_index(i);
+		auto target_index = vdata_target.sel->get_index(i);
+		result_data[i] = vdata_src.validity.RowIsValid(src_index) && vdata_target.validity.RowIsValid(target_index) &&
+		                 index.Reachable(src_data[src_index], target_data[target_index],
+		                                 local_state.reachability_search);
+	}
+}
+
+static void ReachabilityFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &info = state.expr.Cast<BoundFunctionExpression>().bind_info->Cast<IterativeLengthFunctionData>();
+	auto &local_state = PathFunctionLocalState::Get(state);
+	auto &csr = local_state.Bind(info.context, info.csr_id, true);
+	auto input_size = local_state.VertexCount();
+	auto reachability_index = csr.GetReachabilityIndex();
+	if (reachability_index) {
+		ReachabilityFromIndex(*reachability_index, csr, local_state, args, result);
+		return;
+	}
+	UnifiedVectorFormat vdata_variant;
+	args.data[1].ToUnifiedFormat(args.size(), vdata_variant);
+	if (!UnifiedVectorFormat::GetData<bool>(vdata_variant)[vdata_variant.sel->get_index(0)]) {
+		ReachabilitySearch(info.context, csr, input_size, local_state, args, result);
+		return;
+	}
+	// Every lane runs the search of one distinct source, so a chunk never needs more lanes than it has rows
+	switch (SelectLaneCount(args.size())) {
+	case 64:
+		ReachabilityLanes<64>(info.context, csr, input_size, local_state, args, result);
+		break;
+	case 128:
+		ReachabilityLanes<128>(info.context, csr, input_size, local_state, args, result);
+		break;
+	case 256:
+		ReachabilityLanes<256>(info.context, csr, input_size, local_state, args, result);
+		break;
+	default:
+		ReachabilityLanes<LANE_LIMIT>(info.context, csr, input_size, local_state, args, result);
+		break;
+	}
 }
 
 //------------------------------------------------------------------------------
 // Register functions
 //------------------------------------------------------------------------------
 void CoreScalarFunctions::RegisterReachabilityScalarFunction(ExtensionLoader &loader) {
-	loader.RegisterFunction(ScalarFunction(
+	ScalarFunction function(
 	    "reachability",
 	    {LogicalType::INTEGER, LogicalType::BOOLEAN, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
-	    LogicalType::BOOLEAN, ReachabilityFunction, IterativeLengthFunctionData::IterativeLengthBind));
+	    LogicalType::BOOLEAN, ReachabilityFunction, IterativeLengthFunctionData::DeltaAwareBind);
+	function.init_local_state = PathFunctionLocalState::Init;
+	loader.RegisterFunction(function);
 }
 
 } // namespace duckdb
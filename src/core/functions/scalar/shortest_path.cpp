@@ -2,218 +2,179 @@
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckpgq/common.hpp"
 #include "duckpgq/core/functions/function_data/iterative_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+#include "duckpgq/core/utils/msbfs_engine.hpp"
 
 #include <duckpgq/core/functions/scalar.hpp>
 #include <duckpgq/core/utils/duckpgq_utils.hpp>
 
 namespace duckdb {
 
-static bool IterativeLength(int64_t v_size, int64_t *V, vector<int64_t> &E, vector<int64_t> &edge_ids,
-                            vector<std::vector<int64_t>> &parents_v, vector<std::vector<int64_t>> &parents_e,
-                            vector<std::bitset<LANE_LIMIT>> &seen, vector<std::bitset<LANE_LIMIT>> &visit,
-                            vector<std::bitset<LANE_LIMIT>> &next) {
-	bool change = false;
-	for (auto v = 0; v < v_size; v++) {
-		next[v] = 0;
-	}
-	//! Keep track of edge id through which the node was reached
-	for (auto v = 0; v < v_size; v++) {
-		if (visit[v].any()) {
-			for (auto e = V[v]; e < V[v + 1]; e++) {
-				auto n = E[e];
-				auto edge_id = edge_ids[e];
-				next[n] = next[n] | visit[v];
-				for (auto l = 0; l < LANE_LIMIT; l++) {
-					parents_v[n][l] = ((parents_v[n][l] == -1) && visit[v][l]) ? v : parents_v[n][l];
-					parents_e[n][l] = ((parents_e[n][l] == -1) && visit[v][l]) ? edge_id : parents_e[n][l];
-				}
+//! Walks back from [dst] to the source of [lane] over the incoming edges of [reverse], picking at every step the
+//! first in-neighbor one level closer to the source. The reverse CSR lists the incoming edges by increasing source,
+//! so this yields the parent a top-down step would have recorded. The alternating vertex and edge ids from the source
+//! to [dst] are written from the back into the 2 * depth + 1 entries at [path], which have been reserved in the list
+//! child vector before.
+template <idx_t LANES, class ID_T>
+static bool ReconstructPath(CSR &reverse, const vector<uint32_t> &depth, idx_t lane, int64_t dst, int64_t *path) {
+	auto *rv = reinterpret_cast<int64_t *>(reverse.v.get());
+	auto &re = reverse.GetNeighbors<ID_T>();
+	auto n = dst;
+	auto level = depth[n * LANES + lane];
+	path[2 * level] = n;
+	while (level > 0) {
+		int64_t parent = -1;
+		for (auto e = rv[n]; e < rv[n + 1]; e++) {
+			if (depth[re[e] * LANES + lane] == level - 1) {
+				parent = re[e];
+				path[2 * level - 1] = reverse.edge_ids[e];
+				break;
 			}
 		}
+		if (parent == -1) {
+			return false;
+		}
+		level--;
+		path[2 * level] = parent;
+		n = parent;
 	}
-
-	for (auto v = 0; v < v_size; v++) {
-		next[v] = next[v] & ~seen[v];
-		seen[v] = seen[v] | next[v];
-		change |= next[v].any();
-	}
-	return change;
+	return true;
 }
 
-static void ShortestPathFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
-	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
-	auto duckpgq_state = GetDuckPGQState(info.context);
-
-	D_ASSERT(duckpgq_state->csr_list[info.csr_id]);
-	auto csr_entry = duckpgq_state->csr_list.find(info.csr_id);
-	if (csr_entry == duckpgq_state->csr_list.end()) {
-		throw ConstraintException("Invalid ID");
-	}
-	auto &csr = csr_entry->second;
-
-	if (!csr->initialized_v) {
-		throw ConstraintException("Need to initialize CSR before doing shortest path");
+//! The hooks of the shortest path searches: a lane stops once it has seen the targets of all rows of its group. Instead
+//! of a parent vertex and edge per vertex and lane, only the BFS depth is kept and the paths are walked back over the
+//! reverse CSR once the searches of a batch are done.
+struct ShortestPathVisitor : public MSBFSVisitor {
+	ShortestPathVisitor(ClientContext &context, CSR &csr, const MSBFSSourceGroups &groups,
+	                    const UnifiedVectorFormat &vdata_dst, const int64_t *dst_data, Vector &result)
+	    : context(context), csr(csr), groups(groups), vdata_dst(vdata_dst), dst_data(dst_data), result(result) {
 	}
-	int64_t v_size = args.data[1].GetValue(0).GetValue<int64_t>();
-
-	auto *v = reinterpret_cast<int64_t *>(csr->v.get());
-	vector<int64_t> &e = csr->e;
-	vector<int64_t> &edge_ids = csr->edge_ids;
-
-	auto &src = args.data[2];
-	auto &target = args.data[3];
-
-	UnifiedVectorFormat vdata_src, vdata_dst;
-	src.ToUnifiedFormat(args.size(), vdata_src);
-	target.ToUnifiedFormat(args.size(), vdata_dst);
-
-	auto src_data = reinterpret_cast<int64_t *>(vdata_src.data);
-	auto dst_data = reinterpret_cast<int64_t *>(vdata_dst.data);
 
-	result.SetVectorType(VectorType::FLAT_VECTOR);
-	auto result_data = FlatVector::GetData<list_entry_t>(result);
-	ValidityMask &result_validity = FlatVector::Validity(result);
-
-	// create temp SIMD arrays
-	vector<std::bitset<LANE_LIMIT>> seen(v_size);
-	vector<std::bitset<LANE_LIMIT>> visit1(v_size);
-	vector<std::bitset<LANE_LIMIT>> visit2(v_size);
-	vector<std::vector<int64_t>> parents_v(v_size, std::vector<int64_t>(LANE_LIMIT, -1));
-	vector<std::vector<int64_t>> parents_e(v_size, std::vector<int64_t>(LANE_LIMIT, -1));
-
-	// maps lane to search number
-	int64_t lane_to_num[LANE_LIMIT];
-	for (int64_t lane = 0; lane < LANE_LIMIT; lane++) {
-		lane_to_num[lane] = -1; // inactive
+	int64_t Target(idx_t search_num) const {
+		return dst_data[vdata_dst.sel->get_index(search_num)];
 	}
-	uint64_t total_len = 0;
-
-	int64_t started_searches = 0;
-	while (started_searches < args.size()) {
-
-		// empty visit vectors
-		for (auto i = 0; i < v_size; i++) {
-			seen[i] = 0;
-			visit1[i] = 0;
-			for (auto j = 0; j < LANE_LIMIT; j++) {
-				parents_v[i][j] = -1;
-				parents_e[i][j] = -1;
-			}
-		}
 
-		// add search jobs to free lanes
-		uint64_t active = 0;
-		for (int64_t lane = 0; lane < LANE_LIMIT; lane++) {
-			lane_to_num[lane] = -1;
-			while (started_searches < args.size()) {
-				int64_t search_num = started_searches++;
-				auto src_pos = vdata_src.sel->get_index(search_num);
-				if (!vdata_src.validity.RowIsValid(src_pos)) {
-					result_validity.SetInvalid(search_num);
-				} else {
-					visit1[src_data[src_pos]][lane] = true;
-					parents_v[src_data[src_pos]][lane] = src_data[src_pos]; // Mark source with source id
-					parents_e[src_data[src_pos]][lane] = -2; // Mark the source with -2, there is no incoming edge for
-					                                         // the source.
-					lane_to_num[lane] = search_num;          // active lane
-					active++;
-					break;
-				}
+	template <idx_t LANES>
+	bool TargetsSeen(int64_t group, idx_t lane, const vector<LaneBitset<LANES>> &seen) {
+		for (auto i = groups.offsets[group]; i < groups.offsets[group + 1]; i++) {
+			if (!seen[Target(groups.rows[i])][lane]) {
+				return false;
 			}
 		}
+		return true;
+	}
 
-		//! make passes while a lane is still active
-		for (int64_t iter = 1; active; iter++) {
-			//! Perform one step of bfs exploration
-			if (!IterativeLength(v_size, v, e, edge_ids, parents_v, parents_e, seen, (iter & 1) ? visit1 : visit2,
-			                     (iter & 1) ? visit2 : visit1)) {
-				break;
+	//! Appends the paths of all rows of the batch to [result]. The depths give the length of every path, so the list
+	//! child vector is grown once per batch and the paths are written into it in place.
+	template <idx_t LANES>
+	void FinishBatch(MSBFSScratchBuffers<LANES> &buffers, const int64_t *lane_to_group) {
+		auto &depth = buffers.depth;
+		idx_t batch_len = 0;
+		for (idx_t lane = 0; lane < LANES; lane++) {
+			auto group = lane_to_group[lane];
+			if (group == -1) { // empty lanes
+				continue;
 			}
-			int64_t finished_searches = 0;
-			// detect lanes that finished
-			for (int64_t lane = 0; lane < LANE_LIMIT; lane++) {
-				int64_t search_num = lane_to_num[lane];
-				if (search_num >= 0) { // active lane
-					//! Check if dst for a source has been seen
-					auto dst_pos = vdata_dst.sel->get_index(search_num);
-					if (seen[dst_data[dst_pos]][lane]) {
-						finished_searches++;
-					}
+			for (auto i = groups.offsets[group]; i < groups.offsets[group + 1]; i++) {
+				auto level = depth[Target(groups.rows[i]) * LANES + lane];
+				if (level != MSBFS_UNREACHED) {
+					batch_len += 2 * level + 1;
 				}
 			}
-			if (finished_searches == LANE_LIMIT) {
-				break;
-			}
 		}
-		//! Reconstruct the paths
-		for (int64_t lane = 0; lane < LANE_LIMIT; lane++) {
-			int64_t search_num = lane_to_num[lane];
-			if (search_num == -1) { // empty lanes
-				continue;
-			}
-
-			//! Searches that have stopped have found a path
-			auto src_pos = vdata_src.sel->get_index(search_num);
-			auto dst_pos = vdata_dst.sel->get_index(search_num);
-			if (src_data[src_pos] == dst_data[dst_pos]) { // Source == destination
-				unique_ptr<Vector> output = make_uniq<Vector>(LogicalType::LIST(LogicalType::BIGINT));
-				ListVector::PushBack(*output, src_data[src_pos]);
-				ListVector::Append(result, ListVector::GetEntry(*output), ListVector::GetListSize(*output));
-				result_data[search_num].length = ListVector::GetListSize(*output);
-				result_data[search_num].offset = total_len;
-				total_len += result_data[search_num].length;
+		ListVector::Reserve(result, total_len + batch_len);
+		auto result_data = FlatVector::GetData<list_entry_t>(result);
+		auto &result_validity = FlatVector::Validity(result);
+		auto path_data = FlatVector::GetData<int64_t>(ListVector::GetEntry(result));
+		auto &reverse = csr.GetReverse(context);
+		for (idx_t lane = 0; lane < LANES; lane++) {
+			auto group = lane_to_group[lane];
+			if (group == -1) { // empty lanes
 				continue;
 			}
-			std::vector<int64_t> output_vector;
-			std::vector<int64_t> output_edge;
-			auto source_v = src_data[src_pos]; // Take the source
-
-			auto parent_vertex = parents_v[dst_data[dst_pos]][lane]; // Take the parent vertex of the destination vertex
-			auto parent_edge = parents_e[dst_data[dst_pos]][lane];   // Take the parent edge of the destination vertex
-
-			output_vector.push_back(dst_data[dst_pos]); // Add destination vertex
-			output_vector.push_back(parent_edge);
-			while (parent_vertex != source_v) { // Continue adding vertices until we
-				                                // have reached the source vertex
-				//! -1 is used to signify no parent
-				if (parent_vertex == -1 || parent_vertex == parents_v[parent_vertex][lane]) {
+			for (auto i = groups.offsets[group]; i < groups.offsets[group + 1]; i++) {
+				auto search_num = groups.rows[i];
+				auto dst = Target(search_num);
+				auto level = depth[dst * LANES + lane];
+				auto path = path_data + total_len;
+				bool found = level != MSBFS_UNREACHED &&
+				             (csr.compact ? ReconstructPath<LANES, int32_t>(reverse, depth, lane, dst, path)
+				                          : ReconstructPath<LANES, int64_t>(reverse, depth, lane, dst, path));
+				if (!found) {
 					result_validity.SetInvalid(search_num);
-					break;
+					continue;
 				}
-				output_vector.push_back(parent_vertex);
-				parent_edge = parents_e[parent_vertex][lane];
-				parent_vertex = parents_v[parent_vertex][lane];
-				output_vector.push_back(parent_edge);
+				result_data[search_num].length = 2 * level + 1;
+				result_data[search_num].offset = total_len;
+				csr.ExternalPathIds(path, result_data[search_num].length);
+				total_len += result_data[search_num].length;
 			}
+		}
+		ListVector::SetListSize(result, total_len);
+	}
 
-			if (!result_validity.RowIsValid(search_num)) {
-				continue;
-			}
-			output_vector.push_back(source_v);
-			std::reverse(output_vector.begin(), output_vector.end());
-			auto output = make_uniq<Vector>(LogicalType::LIST(LogicalType::BIGINT));
-			for (auto val : output_vector) {
-				Value value_to_insert = val;
-				ListVector::PushBack(*output, value_to_insert);
-			}
+	ClientContext &context;
+	CSR &csr;
+	const MSBFSSourceGroups &groups;
+	const UnifiedVectorFormat &vdata_dst;
+	const int64_t *dst_data;
+	Vector &result;
+	//! Entries of the list child vector written so far
+	idx_t total_len = 0;
+};
+
+static void ShortestPathFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
+	auto &local_state = PathFunctionLocalState::Get(state);
+	auto csr = &local_state.Bind(info.context, info.csr_id);
+	auto v_size = local_state.VertexCount();
+	TraversalMetricsScope metrics(local_state.Metrics(), TraversalKernel::SHORTEST_PATH);
+
+	auto &src = args.data[2];
+	auto &target = args.data[3];
 
-			result_data[search_num].length = ListVector::GetListSize(*output);
-			result_data[search_num].offset = total_len;
-			ListVector::Append(result, ListVector::GetEntry(*output), ListVector::GetListSize(*output));
-			total_len += result_data[search_num].length;
+	UnifiedVectorFormat vdata_src, vdata_dst;
+	src.ToUnifiedFormat(args.size(), vdata_src);
+	target.ToUnifiedFormat(args.size(), vdata_dst);
+
+	auto src_data = csr->InternalIds(vdata_src, args.size(), local_state.source_ids);
+	auto dst_data = csr->InternalIds(vdata_dst, args.size(), local_state.target_ids);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	// searches without a source have no path, all others are grouped by source
+	auto &result_validity = FlatVector::Validity(result);
+	for (idx_t search_num = 0; search_num < args.size(); search_num++) {
+		if (!vdata_src.validity.RowIsValid(vdata_src.sel->get_index(search_num))) {
+			result_validity.SetInvalid(search_num);
 		}
 	}
-	duckpgq_state->csr_to_delete.insert(info.csr_id);
+	MSBFSSourceGroups groups;
+	groups.Initialize(args.size(), *vdata_src.sel, vdata_src.validity, src_data);
+	for (idx_t group = 0; group < groups.GroupCount(); group++) {
+		// sources outside of the CSR get no lane and have no path
+		if (groups.sources[group] < 0 || groups.sources[group] >= v_size) {
+			for (auto i = groups.offsets[group]; i < groups.offsets[group + 1]; i++) {
+				result_validity.SetInvalid(groups.rows[i]);
+			}
+		}
+	}
+
+	// One lane per distinct source, the searches stop once they have reached all targets of their rows
+	ShortestPathVisitor visitor(info.context, *csr, groups, vdata_dst, dst_data, result);
+	RunMSBFSBatches<MSBFSTermination::TARGET_HIT, true>(info.context, *csr, v_size, local_state.scratch, groups, 0,
+	                                                     visitor, &metrics.counters);
 }
 
 //------------------------------------------------------------------------------
 // Register functions
 //------------------------------------------------------------------------------
 void CoreScalarFunctions::RegisterShortestPathScalarFunction(ExtensionLoader &loader) {
-	loader.RegisterFunction(ScalarFunction(
+	ScalarFunction function(
 	    "shortestpath", {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
-	    LogicalType::LIST(LogicalType::BIGINT), ShortestPathFunction,
-	    IterativeLengthFunctionData::IterativeLengthBind));
+	    LogicalType::LIST(LogicalType::BIGINT), ShortestPathFunction, IterativeLengthFunctionData::IterativeLengthBind);
+	function.init_local_state = PathFunctionLocalState::Init;
+	loader.RegisterFunction(function);
 }
 
 } // namespace duckdb
@@ -0,0 +1,256 @@
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/iterative_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+#include "duckpgq/core/utils/msbfs.hpp"
+
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+//! The vertices one BFS depth of a batch reached, each with the lanes that reached it at that depth and the number
+//! of shortest paths of every lane. Only the counts of two consecutive depths are alive at any time, so the counters
+//! take LANES entries per vertex of the frontier rather than per vertex of the graph.
+template <idx_t LANES>
+struct PathCountLevel {
+	void Initialize(idx_t vertex_count) {
+		slot.assign(vertex_count, -1);
+	}
+	//! The entry of [vertex], added if it has none yet
+	idx_t Entry(int64_t vertex) {
+		if (slot[vertex] < 0) {
+			slot[vertex] = static_cast<int64_t>(vertices.size());
+			vertices.push_back(vertex);
+			lanes.emplace_back();
+			counts.resize(counts.size() + LANES, 0);
+		}
+		return static_cast<idx_t>(slot[vertex]);
+	}
+	void Clear() {
+		for (auto vertex : vertices) {
+			slot[vertex] = -1;
+		}
+		vertices.clear();
+		lanes.clear();
+		counts.clear();
+	}
+
+	//! The entry of every vertex of the level, -1 for the others
+	vector<int64_t> slot;
+	vector<int64_t> vertices;
+	vector<LaneBitset<LANES>> lanes;
+	//! Number of shortest paths of lane l to the vertex of entry i at [i * LANES + l], saturated at the largest
+	//! uint64_t
+	vector<uint64_t> counts;
+};
+
+//! Counts the shortest paths of the searches of [groups], one group of rows with the same source per lane and LANES
+//! lanes at a time. Every depth is a top-down step: a vertex reached by a lane for the first time adds the counts of
+//! all of its predecessors in the frontier of that lane, so its count is final once the step is done and the rows
+//! whose destination it is are answered right away. A lane stops once all of its rows are answered.
+template <idx_t LANES, class ID_T>
+static void ShortestPathCountBatches(ClientContext &context, CSR &csr, int64_t v_size, MSBFSScratch &scratch,
+                                     MSBFSSourceGroups &groups, const UnifiedVectorFormat &vdata_dst,
+                                     const int64_t *dst_data, int64_t *result_data, ValidityMask &result_validity) {
+	auto &buffers = scratch.Get<LANES>();
+	auto ranges = csr.GetRanges();
+	auto &e = csr.GetNeighbors<ID_T>();
+	PathCountLevel<LANES> current;
+	PathCountLevel<LANES> upcoming;
+	current.Initialize(static_cast<idx_t>(v_size));
+	upcoming.Initialize(static_cast<idx_t>(v_size));
+	// The vertices with a lane set in seen, which is reset from them after every batch
+	vector<int64_t> touched;
+	int64_t lane_to_group[LANES];
+	idx_t lane_pending_end[LANES];
+
+	auto answer = [&](idx_t row, uint64_t count) {
+		result_data[row] = static_cast<int64_t>(MinValue<uint64_t>(count, NumericLimits<int64_t>::Maximum()));
+	};
+	auto no_path = [&](idx_t row) {
+		result_validity.SetInvalid(row);
+		result_data[row] = 0;
+	};
+
+	idx_t started_groups = 0;
+	while (started_groups < groups.GroupCount()) {
+		// The arrays are left without lanes by every batch, Prepare only sizes them on the first one
+		buffers.Prepare(context, v_size, false);
+		auto &seen = buffers.seen;
+		LaneBitset<LANES> active;
+		for (idx_t lane = 0; lane < LANES && started_groups < groups.GroupCount(); lane++) {
+			auto group = started_groups++;
+			auto source = groups.sources[group];
+			lane_to_group[lane] = static_cast<int64_t>(group);
+			// A path of length 0 is the only shortest path to the source itself
+			auto &pending_end = lane_pending_end[lane];
+			pending_end = groups.offsets[group + 1];
+			for (auto i = groups.offsets[group]; i < pending_end;) {
+				auto row = groups.rows[i];
+				auto dst_pos = vdata_dst.sel->get_index(row);
+				auto destination = dst_data[dst_pos];
+				if (!vdata_dst.validity.RowIsValid(dst_pos) || source < 0 || source >= v_size || destination < 0 ||
+				    destination >= v_size) {
+					no_path(row);
+				} else if (destination == source) {
+					answer(row, 1);
+				} else {
+					i++;
+					continue;
+				}
+				std::swap(groups.rows[i], groups.rows[--pending_end]);
+			}
+			if (pending_end == groups.offsets[group]) {
+				continue;
+			}
+			auto entry = current.Entry(source);
+			current.lanes[entry].set(lane);
+			current.counts[entry * LANES + lane] = 1;
+			if (seen[source].none()) {
+				touched.push_back(source);
+			}
+			seen[source].set(lane);
+			active.set(lane);
+		}
+
+		while (active.any()) {
+			LaneBitset<LANES> reached;
+			for (idx_t i = 0; i < current.vertices.size(); i++) {
+				auto u = current.vertices[i];
+				auto lanes = current.lanes[i] & active;
+				if (lanes.none()) {
+					continue;
+				}
+				for (auto offset = ranges.begin[u]; offset < ranges.end[u]; offset++) {
+					auto w = static_cast<int64_t>(e[offset]);
+					auto fresh = lanes;
+					fresh.AndNot(seen[w]);
+					if (fresh.none()) {
+						continue;
+					}
+					auto entry = upcoming.Entry(w);
+					upcoming.lanes[entry] |= fresh;
+					reached |= fresh;
+					fresh.ForEach([&](idx_t lane) {
+						auto &count = upcoming.counts[entry * LANES + lane];
+						auto sum = count + current.counts[i * LANES + lane];
+						count = sum < count ? NumericLimits<uint64_t>::Maximum() : sum;
+					});
+				}
+			}
+			for (idx_t i = 0; i < upcoming.vertices.size(); i++) {
+				auto w = upcoming.vertices[i];
+				if (seen[w].none()) {
+					touched.push_back(w);
+				}
+				seen[w] |= upcoming.lanes[i];
+			}
+			auto searching = active;
+			searching.ForEach([&](idx_t lane) {
+				auto group = lane_to_group[lane];
+				auto &pending_end = lane_pending_end[lane];
+				for (auto i = groups.offsets[group]; i < pending_end;) {
+					auto row = groups.rows[i];
+					auto destination = dst_data[vdata_dst.sel->get_index(row)];
+					auto entry = upcoming.slot[destination];
+					if (entry >= 0 && upcoming.lanes[entry][lane]) {
+						answer(row, upcoming.counts[entry * LANES + lane]);
+					} else if (!reached[lane]) {
+						// The search of the lane has reached every vertex it can
+						no_path(row);
+					} else {
+						i++;
+						continue;
+					}
+					std::swap(groups.rows[i], groups.rows[--pending_end]);
+				}
+				if (pending_end == groups.offsets[group]) {
+					active[lane] = false;
+				}
+			});
+			current.Clear();
+			std::swap(current, upcoming);
+		}
+		current.Clear();
+		for (auto vertex : touched) {
+			seen[vertex] = 0;
+		}
+		touched.clear();
+	}
+}
+
+template <idx_t LANES>
+static void ShortestPathCountLanes(ClientContext &context, CSR &csr, int64_t v_size, MSBFSScratch &scratch,
+                                   MSBFSSourceGroups &groups, const UnifiedVectorFormat &vdata_dst,
+                                   const int64_t *dst_data, int64_t *result_data, ValidityMask &result_validity) {
+	if (csr.compact) {
+		ShortestPathCountBatches<LANES, int32_t>(context, csr, v_size, scratch, groups, vdata_dst, dst_data,
+		                                         result_data, result_validity);
+	} else {
+		ShortestPathCountBatches<LANES, int64_t>(context, csr, v_size, scratch, groups, vdata_dst, dst_data,
+		                                         result_data, result_validity);
+	}
+}
+
+static void ShortestPathCountFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
+	auto &local_state = PathFunctionLocalState::Get(state);
+	auto &csr = local_state.Bind(info.context, info.csr_id, true);
+	auto v_size = local_state.VertexCount();
+
+	UnifiedVectorFormat vdata_src;
+	UnifiedVectorFormat vdata_dst;
+	args.data[2].ToUnifiedFormat(args.size(), vdata_src);
+	args.data[3].ToUnifiedFormat(args.size(), vdata_dst);
+	auto src_data = csr.InternalIds(vdata_src, args.size(), local_state.source_ids);
+	auto dst_data = csr.InternalIds(vdata_dst, args.size(), local_state.target_ids);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<int64_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	for (idx_t row = 0; row < args.size(); row++) {
+		if (!vdata_src.validity.RowIsValid(vdata_src.sel->get_index(row))) {
+			result_validity.SetInvalid(row);
+			result_data[row] = 0;
+		}
+	}
+	MSBFSSourceGroups groups;
+	groups.Initialize(args.size(), *vdata_src.sel, vdata_src.validity, src_data);
+	auto &scratch = local_state.scratch;
+
+	switch (SelectLaneCount(groups.GroupCount())) {
+	case 64:
+		ShortestPathCountLanes<64>(info.context, csr, v_size, scratch, groups, vdata_dst, dst_data, result_data,
+		                           result_validity);
+		break;
+	case 128:
+		ShortestPathCountLanes<128>(info.context, csr, v_size, scratch, groups, vdata_dst, dst_data, result_data,
+		                            result_validity);
+		break;
+	case 256:
+		ShortestPathCountLanes<256>(info.context, csr, v_size, scratch, groups, vdata_dst, dst_data, result_data,
+		                            result_validity);
+		break;
+	default:
+		ShortestPathCountLanes<LANE_LIMIT>(info.context, csr, v_size, scratch, groups, vdata_dst, dst_data,
+		                                   result_data, result_validity);
+		break;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterShortestPathCountScalarFunction(ExtensionLoader &loader) {
+	// csr_id, vertex count, source, destination
+	ScalarFunction function("shortest_path_count",
+	                        {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT},
+	                        LogicalType::BIGINT, ShortestPathCountFunction,
+	                        IterativeLengthFunctionData::IterativeLengthBind);
+	function.init_local_state = PathFunctionLocalState::Init;
+	loader.RegisterFunction(function);
+}
+
+} // namespace duckdb
@@ -0,0 +1,193 @@
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/iterative_length_function_data.hpp"
+#include "duckpgq/core/functions/function_data/path_function_local_state.hpp"
+#include "duckpgq/core/utils/csr_algebra.hpp"
+#include "duckpgq/core/utils/single_source_bfs.hpp"
+
+#include <duckpgq/core/functions/scalar.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+#include <algorithm>
+
+namespace duckdb {
+
+//! The bounds of the path length, constant arguments 3 and 4
+static void GetPathLengthBounds(DataChunk &args, int64_t &lower, int64_t &upper) {
+	UnifiedVectorFormat vdata_lower;
+	UnifiedVectorFormat vdata_upper;
+	args.data[3].ToUnifiedFormat(args.size(), vdata_lower);
+	args.data[4].ToUnifiedFormat(args.size(), vdata_upper);
+	auto lower_pos = vdata_lower.sel->get_index(0);
+	auto upper_pos = vdata_upper.sel->get_index(0);
+	if (!vdata_lower.validity.RowIsValid(lower_pos) || !vdata_upper.validity.RowIsValid(upper_pos)) {
+		throw InvalidInputException("The path length bounds cannot be NULL");
+	}
+	lower = UnifiedVectorFormat::GetData<int32_t>(vdata_lower)[lower_pos];
+	upper = UnifiedVectorFormat::GetData<int32_t>(vdata_upper)[upper_pos];
+}
+
+//! Answers every row with the targets [bfs] reaches from its source at a distance in [lower, upper]
+template <class SEARCH>
+static void ReachableTargetsInternal(CSR &csr, SEARCH &bfs, int64_t v_size, idx_t count,
+                                     const UnifiedVectorFormat &vdata_src, const int64_t *src_data, int64_t lower,
+                                     int64_t upper, Vector &result) {
+	auto result_data = FlatVector::GetData<list_entry_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	vector<int64_t> targets;
+	idx_t total_len = 0;
+	for (idx_t row = 0; row < count; row++) {
+		auto src_pos = vdata_src.sel->get_index(row);
+		if (!vdata_src.validity.RowIsValid(src_pos)) {
+			result_validity.SetInvalid(row);
+			continue;
+		}
+		auto source = src_data[src_pos];
+		targets.clear();
+		if (source >= 0 && source < v_size) {
+			bfs.Run(source, upper);
+			for (auto vertex : bfs.Reached()) {
+				if (bfs.Depth(vertex) >= lower) {
+					targets.push_back(csr.ExternalId(vertex));
+				}
+			}
+		}
+		result_data[row].offset = total_len;
+		result_data[row].length = targets.size();
+		ListVector::Reserve(result, total_len + targets.size());
+		auto target_data = FlatVector::GetData<int64_t>(ListVector::GetEntry(result));
+		std::copy(targets.begin(), targets.end(), target_data + total_len);
+		total_len += targets.size();
+		ListVector::SetListSize(result, total_len);
+	}
+}
+
+static void ReachableTargetsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
+	int64_t lower;
+	int64_t upper;
+	GetPathLengthBounds(args, lower, upper);
+	auto &local_state = PathFunctionLocalState::Get(state);
+	auto &csr = local_state.Bind(info.context, info.csr_id, true);
+	auto v_size = local_state.VertexCount();
+
+	UnifiedVectorFormat vdata_src;
+	args.data[2].ToUnifiedFormat(args.size(), vdata_src);
+	auto src_data = csr.InternalIds(vdata_src, args.size(), local_state.source_ids);
+	// The edge predicate, the optional constant argument 5
+	auto filter = local_state.GetEdgeFilter(args, 5, csr);
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	// Searches without an edge predicate push their frontiers through the boolean products of the sparse algebra
+	if (csr.compact && filter) {
+		SingleSourceBFS<int32_t, EdgeFilter, false> bfs(csr, v_size, *filter);
+		ReachableTargetsInternal(csr, bfs, v_size, args.size(), vdata_src, src_data, lower, upper, result);
+	} else if (csr.compact) {
+		BooleanFrontierBFS<int32_t> bfs(csr, v_size);
+		ReachableTargetsInternal(csr, bfs, v_size, args.size(), vdata_src, src_data, lower, upper, result);
+	} else if (filter) {
+		SingleSourceBFS<int64_t, EdgeFilter, false> bfs(csr, v_size, *filter);
+		ReachableTargetsInternal(csr, bfs, v_size, args.size(), vdata_src, src_data, lower, upper, result);
+	} else {
+		BooleanFrontierBFS<int64_t> bfs(csr, v_size);
+		ReachableTargetsInternal(csr, bfs, v_size, args.size(), vdata_src, src_data, lower, upper, result);
+	}
+}
+
+template <class ID_T, class FILTER>
+static void ShortestPathTargetsInternal(CSR &csr, int64_t v_size, idx_t count, const UnifiedVectorFormat &vdata_src,
+                                        const int64_t *src_data, int64_t lower, int64_t upper, const FILTER &filter,
+                                        Vector &result) {
+	auto &result_validity = FlatVector::Validity(result);
+	SingleSourceBFS<ID_T, FILTER, true> bfs(csr, v_size, filter);
+	vector<int64_t> paths;
+	vector<idx_t> path_offsets(1, 0);
+	vector<idx_t> row_offsets(1, 0);
+	vector<int64_t> path;
+	for (idx_t row = 0; row < count; row++) {
+		auto src_pos = vdata_src.sel->get_index(row);
+		if (!vdata_src.validity.RowIsValid(src_pos)) {
+			result_validity.SetInvalid(row);
+		} else if (src_data[src_pos] >= 0 && src_data[src_pos] < v_size) {
+			bfs.Run(src_data[src_pos], upper);
+			for (auto vertex : bfs.Reached()) {
+				if (bfs.Depth(vertex) < lower) {
+					continue;
+				}
+				path.clear();
+				bfs.AppendPath(vertex, path);
+				csr.ExternalPathIds(path);
+				paths.insert(paths.end(), path.begin(), path.end());
+				path_offsets.push_back(paths.size());
+			}
+		}
+		row_offsets.push_back(path_offsets.size() - 1);
+	}
+	SetNestedListResult(result, count, paths, path_offsets, row_offsets);
+}
+
+static void ShortestPathTargetsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<IterativeLengthFunctionData>();
+	int64_t lower;
+	int64_t upper;
+	GetPathLengthBounds(args, lower, upper);
+	auto &local_state = PathFunctionLocalState::Get(state);
+	auto &csr = local_state.Bind(info.context, info.csr_id, true);
+	auto v_size = local_state.VertexCount();
+
+	UnifiedVectorFormat vdata_src;
+	args.data[2].ToUnifiedFormat(args.size(), vdata_src);
+	auto src_data = csr.InternalIds(vdata_src, args.size(), local_state.source_ids);
+	// The edge predicate, the optional constant argument 5
+	auto filter = local_state.GetEdgeFilter(args, 5, csr);
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	// Searches without an edge predicate are instantiated without the test of the filter
+	NoEdgeFilter no_filter;
+	if (csr.compact && filter) {
+		ShortestPathTargetsInternal<int32_t>(csr, v_size, args.size(), vdata_src, src_data, lower, upper, *filter,
+		                                     result);
+	} else if (csr.compact) {
+		ShortestPathTargetsInternal<int32_t>(csr, v_size, args.size(), vdata_src, src_data, lower, upper, no_filter,
+		                                     result);
+	} else if (filter) {
+		ShortestPathTargetsInternal<int64_t>(csr, v_size, args.size(), vdata_src, src_data, lower, upper, *filter,
+		                                     result);
+	} else {
+		ShortestPathTargetsInternal<int64_t>(csr, v_size, args.size(), vdata_src, src_data, lower, upper, no_filter,
+		                                     result);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+//! Registers [function] once as it is and once with every type of edge filter appended: the rowids of the edges that
+//! pass an edge predicate, the mask of the edge labels a labeled CSR is traversed over, or the point in time the
+//! edges of a CSR with a temporal index are taken as of
+static void RegisterWithEdgeFilter(ExtensionLoader &loader, ScalarFunction function) {
+	ScalarFunctionSet set(function.name);
+	function.init_local_state = PathFunctionLocalState::Init;
+	set.AddFunction(function);
+	function.arguments.emplace_back();
+	for (auto &filter_type : EdgeFilter::ArgumentTypes()) {
+		function.arguments.back() = filter_type;
+		set.AddFunction(function);
+	}
+	loader.RegisterFunction(set);
+}
+
+void CoreScalarFunctions::RegisterShortestPathTargetsScalarFunctions(ExtensionLoader &loader) {
+	// csr_id, vertex count, source, lower and upper bound of the path length
+	vector<LogicalType> arguments {LogicalType::INTEGER, LogicalType::BIGINT, LogicalType::BIGINT,
+	                               LogicalType::INTEGER, LogicalType::INTEGER};
+	RegisterWithEdgeFilter(loader, ScalarFunction("reachable_targets", arguments,
+	                                              LogicalType::LIST(LogicalType::BIGINT), ReachableTargetsFunction,
+	                                              IterativeLengthFunctionData::DeltaAwareBind));
+	RegisterWithEdgeFilter(loader, ScalarFunction("shortestpath_targets", arguments,
+	                                              LogicalType::LIST(LogicalType::LIST(LogicalType::BIGINT)),
+	                                              ShortestPathTargetsFunction,
+	                                              IterativeLengthFunctionData::DeltaAwareBind));
+}
+
+} // namespace duckdb
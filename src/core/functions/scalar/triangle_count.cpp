@@ -0,0 +1,68 @@
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/functions/function_data/local_clustering_coefficient_function_data.hpp"
+#include "duckpgq/core/utils/csr_triangles.hpp"
+#include "duckpgq/core/utils/duckpgq_utils.hpp"
+
+#include <duckpgq/core/functions/scalar.hpp>
+
+namespace duckdb {
+
+static CSR &GetUndirectedCSR(LocalClusteringCoefficientFunctionData &info) {
+	auto duckpgq_state = GetDuckPGQState(info.context);
+	auto csr_entry = duckpgq_state->csr_list.find(info.csr_id);
+	if (csr_entry == duckpgq_state->csr_list.end()) {
+		throw ConstraintException("CSR not found. Is the graph populated?");
+	}
+	if (!(csr_entry->second->initialized_v && csr_entry->second->initialized_e)) {
+		throw ConstraintException("Need to initialize CSR before counting triangles.");
+	}
+	duckpgq_state->csr_to_delete.insert(info.csr_id);
+	csr_entry->second->LoadPartitions(info.context);
+	return *csr_entry->second;
+}
+
+//! Number of triangles of the graph
+static double_t TriangleCount(ClientContext &context, CSR &csr) {
+	return static_cast<double_t>(CountTriangles(context, csr));
+}
+
+//! Closed triplets over all connected triplets, every triangle closes three of them
+static double_t GlobalClusteringCoefficient(ClientContext &context, CSR &csr) {
+	vector<int64_t> degrees;
+	CountSimpleDegrees(context, csr, degrees);
+	double_t triplets = 0;
+	for (auto degree : degrees) {
+		triplets += static_cast<double_t>(degree) * static_cast<double_t>(degree - 1) / 2;
+	}
+	if (triplets == 0) {
+		return 0;
+	}
+	return 3 * static_cast<double_t>(CountTriangles(context, csr)) / triplets;
+}
+
+//! The second argument only makes the call depend on the CSR CTE, every row receives the value of the whole graph
+template <class T, double_t (*COMPUTE)(ClientContext &, CSR &)>
+static void GraphTriangleFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &info = func_expr.bind_info->Cast<LocalClusteringCoefficientFunctionData>();
+	auto &csr = GetUndirectedCSR(info);
+	info.once.Run([&]() { info.graph_result = COMPUTE(info.context, csr); });
+	result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	ConstantVector::GetData<T>(result)[0] = static_cast<T>(info.graph_result);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterTriangleCountScalarFunctions(ExtensionLoader &loader) {
+	loader.RegisterFunction(ScalarFunction("triangle_count", {LogicalType::INTEGER, LogicalType::BIGINT},
+	                                       LogicalType::BIGINT, GraphTriangleFunction<int64_t, TriangleCount>,
+	                                       LocalClusteringCoefficientFunctionData::LocalClusteringCoefficientBind));
+	loader.RegisterFunction(ScalarFunction(
+	    "global_clustering_coefficient", {LogicalType::INTEGER, LogicalType::BIGINT}, LogicalType::DOUBLE,
+	    GraphTriangleFunction<double_t, GlobalClusteringCoefficient>,
+	    LocalClusteringCoefficientFunctionData::LocalClusteringCoefficientBind));
+}
+
+} // namespace duckdb
@@ -5,32 +5,114 @@
 #include <duckpgq/core/functions/scalar.hpp>
 #include <duckpgq/core/functions/table/weakly_connected_component.hpp>
 #include <duckpgq/core/utils/duckpgq_bitmap.hpp>
+#include <duckpgq/core/utils/duckpgq_parallel.hpp>
 #include <duckpgq/core/utils/duckpgq_utils.hpp>
 #include <atomic>
+#include <random>
 #include <vector>
 
 namespace duckdb {
 
-// Helper function to find the root of a node with path compression
-const static int64_t FindTreeRoot(std::vector<int64_t> &forest, int64_t node) {
-	while (true) {
-		int64_t parent = forest[node];
-		if (parent == node) {
-			return node; // Found the root
+//! Vertices per task of the parallel passes
+static constexpr idx_t WCC_PARTITION_SIZE = 8192;
+//! Number of neighbors every vertex links to before the largest component is sampled
+static constexpr int64_t WCC_NEIGHBOR_ROUNDS = 2;
+static constexpr idx_t WCC_SAMPLE_COUNT = 1024;
+
+// Lock-free union: the root with the larger id is hooked below the smaller one, so every component ends up rooted
+// at its smallest vertex, whatever the order in which the threads link the edges
+static void Link(std::atomic<int64_t> *component, int64_t u, int64_t v) {
+	auto p1 = component[u].load(std::memory_order_relaxed);
+	auto p2 = component[v].load(std::memory_order_relaxed);
+	while (p1 != p2) {
+		auto high = MaxValue<int64_t>(p1, p2);
+		auto low = MinValue<int64_t>(p1, p2);
+		auto p_high = component[high].load(std::memory_order_relaxed);
+		if (p_high == low) {
+			break;
+		}
+		if (p_high == high && component[high].compare_exchange_strong(p_high, low)) {
+			break;
 		}
-		forest[node] = forest[parent];
-		node = parent;
+		p1 = component[component[high].load(std::memory_order_relaxed)].load(std::memory_order_relaxed);
+		p2 = component[low].load(std::memory_order_relaxed);
 	}
 }
 
-// Helper function to link two nodes in the same connected component
-const static void Link(std::vector<int64_t> &forest, int64_t nodeA, int64_t nodeB) {
-	int64_t rootA = FindTreeRoot(forest, nodeA);
-	int64_t rootB = FindTreeRoot(forest, nodeB);
+// Points every vertex in [begin, end) directly at the root of its tree
+static void Compress(std::atomic<int64_t> *component, idx_t begin, idx_t end) {
+	for (idx_t i = begin; i < end; i++) {
+		auto parent = component[i].load(std::memory_order_relaxed);
+		while (parent != component[parent].load(std::memory_order_relaxed)) {
+			parent = component[parent].load(std::memory_order_relaxed);
+		}
+		component[i].store(parent, std::memory_order_relaxed);
+	}
+}
 
-	if (rootA != rootB) {
-		forest[rootA] = rootB;
+// The root most of a sample of vertices point at, once the neighbor rounds have merged the large components
+static int64_t SampleFrequentComponent(std::atomic<int64_t> *component, idx_t vertex_count) {
+	std::mt19937_64 random(vertex_count);
+	std::unordered_map<int64_t, idx_t> counts;
+	int64_t result = 0;
+	idx_t result_count = 0;
+	for (idx_t i = 0; i < WCC_SAMPLE_COUNT; i++) {
+		auto root = component[random() % vertex_count].load(std::memory_order_relaxed);
+		auto count = ++counts[root];
+		if (count > result_count) {
+			result = root;
+			result_count = count;
+		}
 	}
+	return result;
+}
+
+// Afforest (Sutton et al.): link every vertex to its first neighbors, find the component that has most likely
+// absorbed a large part of the graph, then link the remaining edges of the vertices outside of it. Skipping the
+// vertices of that component is only correct for the symmetric CSR the table function builds.
+template <class ID_T>
+static void Afforest(ClientContext &context, CSR &csr, vector<int64_t> &labels) {
+	auto vertex_count = csr.vsize - 2;
+	auto *v = reinterpret_cast<int64_t *>(csr.v.get());
+	auto &e = csr.GetNeighbors<ID_T>();
+	auto component = make_uniq<std::atomic<int64_t>[]>(vertex_count);
+	ParallelFor(context, vertex_count, WCC_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		for (idx_t i = begin; i < end; i++) {
+			component[i].store(static_cast<int64_t>(i), std::memory_order_relaxed);
+		}
+	});
+	for (int64_t round = 0; round < WCC_NEIGHBOR_ROUNDS; round++) {
+		ParallelFor(context, vertex_count, WCC_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+			for (idx_t i = begin; i < end; i++) {
+				if (v[i] + round < v[i + 1]) {
+					Link(component.get(), static_cast<int64_t>(i), static_cast<int64_t>(e[v[i] + round]));
+				}
+			}
+		});
+		ParallelFor(context, vertex_count, WCC_PARTITION_SIZE,
+		            [&](idx_t begin, idx_t end) { Compress(component.get(), begin, end); });
+	}
+
+	auto frequent_component = SampleFrequentComponent(component.get(), vertex_count);
+	ParallelFor(context, vertex_count, WCC_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		for (idx_t i = begin; i < end; i++) {
+			if (component[i].load(std::memory_order_relaxed) == frequent_component) {
+				continue;
+			}
+			for (auto edge_idx = v[i] + WCC_NEIGHBOR_ROUNDS; edge_idx < v[i + 1]; edge_idx++) {
+				Link(component.get(), static_cast<int64_t>(i), static_cast<int64_t>(e[edge_idx]));
+			}
+		}
+	});
+
+	// Flatten the forest once, every row is then answered with a single lookup
+	labels.resize(vertex_count);
+	ParallelFor(context, vertex_count, WCC_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		Compress(component.get(), begin, end);
+		for (idx_t i = begin; i < end; i++) {
+			labels[i] = component[i].load(std::memory_order_relaxed);
+		}
+	});
 }
 
 static void WeaklyConnectedComponentFunction(DataChunk &args, ExpressionState &state, Vector &result) {
@@ -47,10 +129,10 @@ static void WeaklyConnectedComponentFunction(DataChunk &args, ExpressionState &s
 		throw ConstraintException("Need to initialize CSR before doing weakly connected components.");
 	}
 
-	// Retrieve CSR data
-	int64_t *v = reinterpret_cast<int64_t *>(duckpgq_state->csr_list[info.csr_id]->v.get());
-	vector<int64_t> &e = duckpgq_state->csr_list[info.csr_id]->e;
-	size_t v_size = duckpgq_state->csr_list[info.csr_id]->vsize;
+	auto &csr = *csr_entry->second;
+	csr.LoadPartitions(info.context);
+	// The last two entries of v only delimit the adjacency lists and are not vertices
+	auto vertex_count = static_cast<int64_t>(csr.vsize - 2);
 
 	// Get source vector for searches
 	auto &src = args.data[1];
@@ -63,32 +145,14 @@ static void WeaklyConnectedComponentFunction(DataChunk &args, ExpressionState &s
 	result.SetVectorType(VectorType::FLAT_VECTOR);
 	auto result_data = FlatVector::GetData<int64_t>(result);
 
-	if (!info.state_initialized) {
-		std::lock_guard<std::mutex> guard(info.initialize_lock); // Thread safety
-		if (!info.state_converged) {
-			info.forest.resize(v_size);
-			info.state_initialized = true; // Initialize state
-		}
-	}
-
-	// Check if already converged
-	if (!info.state_converged) {
-		std::lock_guard<std::mutex> guard(info.wcc_lock); // Thread safety
-		if (!info.state_converged) {
-			// Initialize the forest for connected components
-			for (int64_t i = 0; i < v_size - 1; ++i) {
-				info.forest[i] = i; // Each node points to itself
-			}
-			// Process edges to link nodes
-			for (int64_t i = 0; i < v_size - 1; i++) {
-				for (int64_t edge_idx = v[i]; edge_idx < v[i + 1]; edge_idx++) {
-					int64_t neighbor = e[edge_idx];
-					Link(info.forest, i, neighbor);
-				}
-			}
-			info.state_converged = true;
+	// The threads that arrive while the forest is built work on its passes instead of waiting
+	info.once.Run([&]() {
+		if (vertex_count > 0 && csr.compact) {
+			Afforest<int32_t>(info.context, csr, info.forest);
+		} else if (vertex_count > 0) {
+			Afforest<int64_t>(info.context, csr, info.forest);
 		}
-	}
+	});
 	// Assign component IDs for the source nodes
 	for (size_t i = 0; i < args.size(); i++) {
 		auto id_pos = vdata_src.sel->get_index(i);
@@ -96,9 +160,10 @@ static void WeaklyConnectedComponentFunction(DataChunk &args, ExpressionState &s
 			result_validity.SetInvalid(i);
 			continue;
 		}
-		int64_t src_node = src_data[id_pos];
-		if (src_node >= 0 && src_node < v_size) {
-			result_data[i] = FindTreeRoot(info.forest, src_node); // Assign component ID to the result
+		int64_t src_node = csr.InternalId(src_data[id_pos]);
+		if (src_node >= 0 && src_node < vertex_count) {
+			// Components are labeled by the rowid of one of their vertices
+			result_data[i] = csr.ExternalId(info.forest[src_node]);
 		} else {
 			result_validity.SetInvalid(i);
 		}
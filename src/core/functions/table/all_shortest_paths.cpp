@@ -0,0 +1,132 @@
+#include "duckpgq/core/functions/table/all_shortest_paths.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/parser/expression/conjunction_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+
+#include <duckpgq/core/functions/table.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+static Value ListArgument(const Value &argument) {
+	if (argument.type().id() != LogicalTypeId::LIST) {
+		return Value::LIST({argument});
+	}
+	return argument;
+}
+
+static unique_ptr<ParsedExpression> ListContains(const Value &list, const string &column, const string &table) {
+	vector<unique_ptr<ParsedExpression>> children;
+	children.push_back(make_uniq<ConstantExpression>(list));
+	children.push_back(make_uniq<ColumnRefExpression>(column, table));
+	return make_uniq<FunctionExpression>("list_contains", std::move(children));
+}
+
+// WITH csr_cte AS (...)
+// SELECT __s.<key> AS source, __d.<key> AS destination, <function>(0, NULL::BIGINT, __x.temp + __s.rowid, __d.rowid)
+// FROM <vertex table> __s, <vertex table> __d, (SELECT count(csr_cte.temp) * 0 AS temp FROM csr_cte) __x
+// WHERE list_contains(<sources>, __s.<key>) AND list_contains(<destinations>, __d.<key>)
+static unique_ptr<SelectNode> CreatePairSelectNode(ClientContext &context, TableFunctionBindInput &input,
+                                                   const string &function_name) {
+	auto pg_name = StringUtil::Lower(StringValue::Get(input.inputs[0]));
+	auto node_table = StringUtil::Lower(StringValue::Get(input.inputs[1]));
+	auto edge_table = StringUtil::Lower(StringValue::Get(input.inputs[2]));
+	auto sources = ListArgument(input.inputs[3]);
+	auto destinations = ListArgument(input.inputs[4]);
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
+	auto edge_pg_entry = ValidateSourceNodeAndEdgeTable(pg_info, node_table, edge_table);
+	auto &vertex_key = edge_pg_entry->source_pk[0];
+
+	auto select_node = make_uniq<SelectNode>();
+	auto source_column = make_uniq<ColumnRefExpression>(vertex_key, "__s");
+	source_column->alias = "source";
+	select_node->select_list.push_back(std::move(source_column));
+	auto destination_column = make_uniq<ColumnRefExpression>(vertex_key, "__d");
+	destination_column->alias = "destination";
+	select_node->select_list.push_back(std::move(destination_column));
+
+	vector<unique_ptr<ParsedExpression>> source_children;
+	source_children.push_back(make_uniq<ColumnRefExpression>("temp", "__x"));
+	source_children.push_back(make_uniq<ColumnRefExpression>("rowid", "__s"));
+	vector<unique_ptr<ParsedExpression>> function_children;
+	function_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
+	function_children.push_back(CreateVertexCountArgument());
+	function_children.push_back(make_uniq<FunctionExpression>("add", std::move(source_children)));
+	function_children.push_back(make_uniq<ColumnRefExpression>("rowid", "__d"));
+	select_node->select_list.push_back(make_uniq<FunctionExpression>(function_name, std::move(function_children)));
+
+	auto vertex_join_ref = make_uniq<JoinRef>(JoinRefType::CROSS);
+	vertex_join_ref->left = edge_pg_entry->source_pg_table->CreateBaseTableRef("__s");
+	vertex_join_ref->right = edge_pg_entry->source_pg_table->CreateBaseTableRef("__d");
+	auto cross_join_ref = make_uniq<JoinRef>(JoinRefType::CROSS);
+	cross_join_ref->left = std::move(vertex_join_ref);
+	cross_join_ref->right = CreateCountCTESubquery();
+	select_node->from_table = std::move(cross_join_ref);
+
+	select_node->where_clause =
+	    make_uniq<ConjunctionExpression>(ExpressionType::CONJUNCTION_AND, ListContains(sources, vertex_key, "__s"),
+	                                     ListContains(destinations, vertex_key, "__d"));
+	select_node->cte_map.map["csr_cte"] = CreateDirectedCSRCTE(context, pg_name, edge_pg_entry, "src", "edge", "dst");
+	return select_node;
+}
+
+static unique_ptr<TableRef> CreateSubqueryRef(unique_ptr<SelectNode> select_node, const string &alias) {
+	auto subquery = make_uniq<SelectStatement>();
+	subquery->node = std::move(select_node);
+	auto result = make_uniq<SubqueryRef>(std::move(subquery));
+	result->alias = alias;
+	return std::move(result);
+}
+
+// SELECT __p.source, __p.destination, __p.path, len(__p.path) // 2 AS path_length
+// FROM (<pair select node with unnest(all_shortest_paths(...)) AS path>) __p
+unique_ptr<TableRef> AllShortestPathsFunction::AllShortestPathsBindReplace(ClientContext &context,
+                                                                           TableFunctionBindInput &input) {
+	auto pair_select_node = CreatePairSelectNode(context, input, "all_shortest_paths");
+	vector<unique_ptr<ParsedExpression>> unnest_children;
+	unnest_children.push_back(std::move(pair_select_node->select_list.back()));
+	auto unnest_function = make_uniq<FunctionExpression>("unnest", std::move(unnest_children));
+	unnest_function->alias = "path";
+	pair_select_node->select_list.back() = std::move(unnest_function);
+
+	auto pair_subquery = make_uniq<SelectStatement>();
+	pair_subquery->node = std::move(pair_select_node);
+
+	auto select_node = make_uniq<SelectNode>();
+	select_node->select_list.push_back(make_uniq<ColumnRefExpression>("source", "__p"));
+	select_node->select_list.push_back(make_uniq<ColumnRefExpression>("destination", "__p"));
+	select_node->select_list.push_back(make_uniq<ColumnRefExpression>("path", "__p"));
+	vector<unique_ptr<ParsedExpression>> len_children;
+	len_children.push_back(make_uniq<ColumnRefExpression>("path", "__p"));
+	vector<unique_ptr<ParsedExpression>> div_children;
+	div_children.push_back(make_uniq<FunctionExpression>("len", std::move(len_children)));
+	div_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(2)));
+	auto path_length = make_uniq<FunctionExpression>("//", std::move(div_children));
+	path_length->alias = "path_length";
+	select_node->select_list.push_back(std::move(path_length));
+	select_node->from_table = make_uniq<SubqueryRef>(std::move(pair_subquery), "__p");
+	return CreateSubqueryRef(std::move(select_node), "all_shortest_paths");
+}
+
+unique_ptr<TableRef> ShortestPathCountFunction::ShortestPathCountBindReplace(ClientContext &context,
+                                                                             TableFunctionBindInput &input) {
+	auto select_node = CreatePairSelectNode(context, input, "shortest_path_count");
+	select_node->select_list.back()->alias = "path_count";
+	return CreateSubqueryRef(std::move(select_node), "shortest_path_count");
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterAllShortestPathsTableFunctions(ExtensionLoader &loader) {
+	loader.RegisterFunction(AllShortestPathsFunction());
+	loader.RegisterFunction(ShortestPathCountFunction());
+}
+
+} // namespace duckdb
@@ -0,0 +1,56 @@
+#include "duckpgq/core/functions/table/betweenness_centrality.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+
+#include <duckpgq/core/functions/table.hpp>
+#include <duckpgq/core/utils/compressed_sparse_row.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+unique_ptr<TableRef>
+BetweennessCentralityFunction::BetweennessCentralityBindReplace(ClientContext &context,
+                                                                TableFunctionBindInput &input) {
+	auto pg_name = StringUtil::Lower(StringValue::Get(input.inputs[0]));
+	auto node_table = StringUtil::Lower(StringValue::Get(input.inputs[1]));
+	auto edge_table = StringUtil::Lower(StringValue::Get(input.inputs[2]));
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
+	auto edge_pg_entry = ValidateSourceNodeAndEdgeTable(pg_info, node_table, edge_table);
+
+	vector<Value> extra_arguments;
+	if (input.inputs.size() > 3 && !input.inputs[3].IsNull()) {
+		auto samples = input.inputs[3].GetValue<int64_t>();
+		if (samples <= 0) {
+			throw InvalidInputException("betweenness_centrality samples must be positive, got %d", samples);
+		}
+		extra_arguments.push_back(Value::BIGINT(samples));
+	}
+	auto select_node =
+	    CreateSelectNode(edge_pg_entry, "betweenness_centrality", "betweenness_centrality", extra_arguments);
+
+	select_node->cte_map.map["csr_cte"] = CreateDirectedCSRCTE(context, pg_name, edge_pg_entry, "src", "edge", "dst");
+
+	auto subquery = make_uniq<SelectStatement>();
+	subquery->node = std::move(select_node);
+
+	auto result = make_uniq<SubqueryRef>(std::move(subquery));
+	result->alias = "betweenness_centrality";
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterBetweennessCentralityTableFunction(ExtensionLoader &loader) {
+	TableFunctionSet set("betweenness_centrality");
+	BetweennessCentralityFunction function;
+	set.AddFunction(function);
+	// Number of sampled source vertices
+	function.arguments.push_back(LogicalType::BIGINT);
+	set.AddFunction(function);
+	loader.RegisterFunction(set);
+}
+
+} // namespace duckdb
@@ -0,0 +1,73 @@
+#include "duckpgq/core/functions/table/community_detection.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+
+#include <duckpgq/core/functions/function_data/community_detection_function_data.hpp>
+#include <duckpgq/core/functions/table.hpp>
+#include <duckpgq/core/utils/compressed_sparse_row.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+// WITH csr_cte AS (<undirected CSR>)
+// SELECT <source key>, __x.temp + <function_name>(0, rowid, <parameters>) AS community FROM <vertex table>, __x
+static unique_ptr<TableRef> CreateCommunityDetectionQuery(ClientContext &context, TableFunctionBindInput &input,
+                                                          const string &function_name,
+                                                          const vector<Value> &parameters) {
+	auto pg_name = StringUtil::Lower(StringValue::Get(input.inputs[0]));
+	auto node_table = StringUtil::Lower(StringValue::Get(input.inputs[1]));
+	auto edge_table = StringUtil::Lower(StringValue::Get(input.inputs[2]));
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
+	auto edge_pg_entry = ValidateSourceNodeAndEdgeTable(pg_info, node_table, edge_table);
+
+	auto select_node = CreateSelectNode(edge_pg_entry, function_name, "community", parameters);
+
+	select_node->cte_map.map["csr_cte"] = CreateUndirectedCSRCTE(context, pg_name, edge_pg_entry, select_node);
+
+	auto subquery = make_uniq<SelectStatement>();
+	subquery->node = std::move(select_node);
+
+	auto result = make_uniq<SubqueryRef>(std::move(subquery));
+	result->alias = function_name;
+	return std::move(result);
+}
+
+unique_ptr<TableRef> LabelPropagationFunction::LabelPropagationBindReplace(ClientContext &context,
+                                                                           TableFunctionBindInput &input) {
+	auto max_iterations = CommunityDetectionFunctionData::DEFAULT_MAX_ITERATIONS;
+	for (auto &parameter : input.named_parameters) {
+		if (!parameter.second.IsNull() && parameter.first == "max_iterations") {
+			max_iterations = parameter.second.GetValue<int64_t>();
+		}
+	}
+	return CreateCommunityDetectionQuery(context, input, "label_propagation", {Value::BIGINT(max_iterations)});
+}
+
+unique_ptr<TableRef> LouvainFunction::LouvainBindReplace(ClientContext &context, TableFunctionBindInput &input) {
+	auto resolution = CommunityDetectionFunctionData::DEFAULT_RESOLUTION;
+	auto max_iterations = CommunityDetectionFunctionData::DEFAULT_MAX_ITERATIONS;
+	for (auto &parameter : input.named_parameters) {
+		if (parameter.second.IsNull()) {
+			continue;
+		}
+		if (parameter.first == "resolution") {
+			resolution = parameter.second.GetValue<double>();
+		} else if (parameter.first == "max_iterations") {
+			max_iterations = parameter.second.GetValue<int64_t>();
+		}
+	}
+	return CreateCommunityDetectionQuery(context, input, "louvain",
+	                                     {Value::DOUBLE(resolution), Value::BIGINT(max_iterations)});
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterCommunityDetectionTableFunctions(ExtensionLoader &loader) {
+	loader.RegisterFunction(LabelPropagationFunction());
+	loader.RegisterFunction(LouvainFunction());
+}
+
+} // namespace duckdb
@@ -6,6 +6,8 @@
 #include <duckpgq/core/functions/table.hpp>
 #include <duckpgq/core/utils/duckpgq_utils.hpp>
 #include "duckdb/main/connection_manager.hpp"
+#include <duckpgq/core/utils/shared_csr_store.hpp>
+#include "duckpgq_extension_callback.hpp"
 #include <duckpgq/core/parser/duckpgq_parser.hpp>
 #include "duckdb/catalog/catalog_entry/view_catalog_entry.hpp"
 #include "duckdb/catalog/catalog.hpp"
@@ -164,9 +166,7 @@ unique_ptr<FunctionData> CreatePropertyGraphFunction::CreatePropertyGraphBind(Cl
 	}
 	auto statement = dynamic_cast<CreateStatement *>(duckpgq_parse_data->statement.get());
 	auto info = dynamic_cast<CreatePropertyGraphInfo *>(statement->info.get());
-	auto pg_table = duckpgq_state->registered_property_graphs.find(info->property_graph_name);
-
-	if (pg_table != duckpgq_state->registered_property_graphs.end() &&
+	if (duckpgq_state->FindPropertyGraph(info->property_graph_name) &&
 	    info->on_conflict == OnCreateConflict::ERROR_ON_CONFLICT) {
 		throw Exception(ExceptionType::INVALID,
 		                "Property graph table with name " + info->property_graph_name + " already exists");
@@ -272,10 +272,8 @@ void CreatePropertyGraphFunction::CreatePropertyGraphFunc(ClientContext &context
 	auto pg_info = bind_data.create_pg_info;
 	auto duckpgq_state = GetDuckPGQState(context);
 
-	for (auto &local_client_context : ConnectionManager::Get(*context.db).GetConnectionList()) {
-		auto local_state = GetDuckPGQState(*local_client_context);
-		local_state->registered_property_graphs[pg_info->property_graph_name] = pg_info->Copy();
-	}
+	// Every connection sees the new graph from its next use of the property graphs on
+	duckpgq_state->property_graph_metadata->RegisterPropertyGraph(pg_info->Copy());
 
 	duckpgq_state->InitializeInternalTable(context);
 	auto new_conn = make_shared_ptr<Connection>(*context.db);
@@ -404,6 +402,14 @@ void CreatePropertyGraphFunction::CreatePropertyGraphFunc(ClientContext &context
 	if (insert_query->HasError()) {
 		throw TransactionException(insert_query->GetError());
 	}
+	if (SharedCSRStore::IsPrebuildEnabled(context)) {
+		// The directed CSRs, which most path-finding queries traverse
+		vector<CSRPrebuildRequest> requests;
+		for (const auto &e_table : pg_info->edge_tables) {
+			requests.push_back({pg_info->property_graph_name, e_table->main_label, true});
+		}
+		SharedCSRStore::SchedulePrebuild(context, requests, duckpgq_state->commit_state->prebuild_tasks);
+	}
 }
 
 //------------------------------------------------------------------------------
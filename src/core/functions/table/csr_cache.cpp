@@ -0,0 +1,113 @@
+#include "duckpgq/core/functions/table/csr_cache.hpp"
+#include <duckpgq/core/functions/table.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+unique_ptr<FunctionData> CSRCacheFunction::CSRCacheBind(ClientContext &context, TableFunctionBindInput &input,
+                                                        vector<LogicalType> &return_types, vector<string> &names) {
+	names.emplace_back("property_graph");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("edge_label");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("directed");
+	return_types.emplace_back(LogicalType::BOOLEAN);
+	names.emplace_back("weight_column");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("vertex_count");
+	return_types.emplace_back(LogicalType::BIGINT);
+	names.emplace_back("edge_count");
+	return_types.emplace_back(LogicalType::BIGINT);
+	names.emplace_back("memory_usage");
+	return_types.emplace_back(LogicalType::BIGINT);
+	names.emplace_back("hits");
+	return_types.emplace_back(LogicalType::BIGINT);
+	names.emplace_back("pinned");
+	return_types.emplace_back(LogicalType::BOOLEAN);
+	names.emplace_back("shared");
+	return_types.emplace_back(LogicalType::BOOLEAN);
+	names.emplace_back("distance_index");
+	return_types.emplace_back(LogicalType::BOOLEAN);
+	names.emplace_back("reachability_index");
+	return_types.emplace_back(LogicalType::BOOLEAN);
+	return make_uniq<TableFunctionData>();
+}
+
+unique_ptr<GlobalTableFunctionState> CSRCacheFunction::CSRCacheInit(ClientContext &context,
+                                                                    TableFunctionInitInput &input) {
+	auto result = make_uniq<CSRCacheGlobalData>();
+	auto duckpgq_state = GetDuckPGQState(context);
+	lock_guard<mutex> guard(duckpgq_state->csr_cache_lock);
+	for (auto &cache_entry : duckpgq_state->csr_cache) {
+		auto &entry = cache_entry.second;
+		CSRCacheRow row;
+		row.pg_name = entry.pg_name;
+		row.edge_label = entry.edge_label;
+		row.directed = entry.directed;
+		row.weight_column = entry.weight_column;
+		row.vertex_count = static_cast<int64_t>(entry.csr->VertexCount());
+		row.edge_count = static_cast<int64_t>(entry.csr->EdgeCount());
+		row.memory_usage = static_cast<int64_t>(entry.csr->GetMemoryUsage());
+		row.hits = static_cast<int64_t>(entry.hits);
+		row.pinned = entry.pinned;
+		row.shared = false;
+		row.distance_index = entry.csr->GetDistanceIndex() != nullptr;
+		row.reachability_index = entry.csr->GetReachabilityIndex() != nullptr;
+		result->rows.push_back(std::move(row));
+	}
+	// The CSRs shared by all connections
+	auto shared_csr_store = ObjectCache::GetObjectCache(context).Get<SharedCSRStore>(SharedCSRStore::ObjectType());
+	if (!shared_csr_store) {
+		return std::move(result);
+	}
+	auto shared_entries = shared_csr_store->Entries();
+	for (auto &shared_entry : *shared_entries) {
+		auto &entry = *shared_entry.second;
+		CSRCacheRow row;
+		row.pg_name = entry.pg_name;
+		row.edge_label = entry.edge_label;
+		row.directed = entry.directed;
+		row.weight_column = entry.weight_column;
+		row.vertex_count = static_cast<int64_t>(entry.csr->VertexCount());
+		row.edge_count = static_cast<int64_t>(entry.csr->EdgeCount());
+		row.memory_usage = static_cast<int64_t>(entry.csr->GetMemoryUsage());
+		row.hits = static_cast<int64_t>(entry.hits.load());
+		row.pinned = false;
+		row.shared = true;
+		row.distance_index = entry.csr->GetDistanceIndex() != nullptr;
+		row.reachability_index = entry.csr->GetReachabilityIndex() != nullptr;
+		result->rows.push_back(std::move(row));
+	}
+	return std::move(result);
+}
+
+void CSRCacheFunction::CSRCacheFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &data = data_p.global_state->Cast<CSRCacheGlobalData>();
+	idx_t count = 0;
+	while (data.offset < data.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &row = data.rows[data.offset++];
+		output.SetValue(0, count, Value(row.pg_name));
+		output.SetValue(1, count, Value(row.edge_label));
+		output.SetValue(2, count, Value::BOOLEAN(row.directed));
+		output.SetValue(3, count, row.weight_column.empty() ? Value() : Value(row.weight_column));
+		output.SetValue(4, count, Value::BIGINT(row.vertex_count));
+		output.SetValue(5, count, Value::BIGINT(row.edge_count));
+		output.SetValue(6, count, Value::BIGINT(row.memory_usage));
+		output.SetValue(7, count, Value::BIGINT(row.hits));
+		output.SetValue(8, count, Value::BOOLEAN(row.pinned));
+		output.SetValue(9, count, Value::BOOLEAN(row.shared));
+		output.SetValue(10, count, Value::BOOLEAN(row.distance_index));
+		output.SetValue(11, count, Value::BOOLEAN(row.reachability_index));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterCSRCacheTableFunction(ExtensionLoader &loader) {
+	loader.RegisterFunction(CSRCacheFunction());
+}
+
+} // namespace duckdb
@@ -25,11 +25,10 @@ unique_ptr<FunctionData> DescribePropertyGraphFunction::DescribePropertyGraphBin
 	auto select_node = dynamic_cast<SelectNode *>(statement->node.get());
 	auto show_ref = dynamic_cast<ShowRef *>(select_node->from_table.get());
 
-	auto pg_table = duckpgq_state->registered_property_graphs.find(show_ref->table_name);
-	if (pg_table == duckpgq_state->registered_property_graphs.end()) {
+	auto property_graph = duckpgq_state->FindPropertyGraph(show_ref->table_name);
+	if (!property_graph) {
 		throw Exception(ExceptionType::INVALID, "Property graph " + show_ref->table_name + " does not exist.");
 	}
-	auto property_graph = dynamic_cast<CreatePropertyGraphInfo *>(pg_table->second.get());
 	names.emplace_back("property_graph");
 	return_types.emplace_back(LogicalType::VARCHAR);
 	names.emplace_back("table_name");
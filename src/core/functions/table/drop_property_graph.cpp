@@ -37,20 +37,20 @@ void DropPropertyGraphFunction::DropPropertyGraphFunc(ClientContext &context, Ta
 	auto pg_info = bind_data.drop_pg_info;
 	auto duckpgq_state = GetDuckPGQState(context);
 
-	auto registered_pg = duckpgq_state->registered_property_graphs.find(pg_info->property_graph_name);
-	if (registered_pg == duckpgq_state->registered_property_graphs.end()) {
+	if (!duckpgq_state->FindPropertyGraph(pg_info->property_graph_name)) {
 		if (pg_info->missing_ok) {
 			return; // Do nothing
 		}
 		throw BinderException("Property graph %s does not exist.", pg_info->property_graph_name);
 	}
 
+	duckpgq_state->property_graph_metadata->DropPropertyGraph(pg_info->property_graph_name);
 	for (auto &connection : ConnectionManager::Get(*context.db).GetConnectionList()) {
 		auto local_state = connection->registered_state->Get<DuckPGQState>("duckpgq");
 		if (!local_state) {
 			continue;
 		}
-		local_state->registered_property_graphs.erase(pg_info->property_graph_name);
+		local_state->UnpinCSRs(pg_info->property_graph_name, "");
 	}
 
 	auto new_conn = make_shared_ptr<Connection>(*context.db);
@@ -0,0 +1,67 @@
+#include "duckpgq/core/functions/table/duckpgq_metrics.hpp"
+#include <duckpgq/core/functions/table.hpp>
+
+namespace duckdb {
+
+unique_ptr<FunctionData> DuckPGQMetricsFunction::DuckPGQMetricsBind(ClientContext &context,
+                                                                    TableFunctionBindInput &input,
+                                                                    vector<LogicalType> &return_types,
+                                                                    vector<string> &names) {
+	names.emplace_back("kernel");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("calls");
+	return_types.emplace_back(LogicalType::BIGINT);
+	names.emplace_back("iterations");
+	return_types.emplace_back(LogicalType::BIGINT);
+	names.emplace_back("edges_traversed");
+	return_types.emplace_back(LogicalType::BIGINT);
+	names.emplace_back("average_active_lanes");
+	return_types.emplace_back(LogicalType::DOUBLE);
+	names.emplace_back("scratch_bytes");
+	return_types.emplace_back(LogicalType::BIGINT);
+	names.emplace_back("microseconds");
+	return_types.emplace_back(LogicalType::BIGINT);
+	return make_uniq<TableFunctionData>();
+}
+
+unique_ptr<GlobalTableFunctionState> DuckPGQMetricsFunction::DuckPGQMetricsInit(ClientContext &context,
+                                                                                TableFunctionInitInput &input) {
+	auto result = make_uniq<DuckPGQMetricsGlobalData>();
+	auto metrics = TraversalMetrics::Get(context);
+	for (idx_t kernel = 0; kernel < TRAVERSAL_KERNEL_COUNT; kernel++) {
+		result->rows.push_back(metrics->Read(static_cast<TraversalKernel>(kernel)));
+	}
+	return std::move(result);
+}
+
+void DuckPGQMetricsFunction::DuckPGQMetricsFunc(ClientContext &context, TableFunctionInput &data_p,
+                                                DataChunk &output) {
+	auto &data = data_p.global_state->Cast<DuckPGQMetricsGlobalData>();
+	idx_t count = 0;
+	while (data.offset < data.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto kernel = static_cast<TraversalKernel>(data.offset);
+		auto &row = data.rows[data.offset++];
+		output.SetValue(0, count, Value(TraversalMetrics::KernelName(kernel)));
+		output.SetValue(1, count, Value::BIGINT(static_cast<int64_t>(row.calls)));
+		output.SetValue(2, count, Value::BIGINT(static_cast<int64_t>(row.iterations)));
+		output.SetValue(3, count, Value::BIGINT(static_cast<int64_t>(row.edges)));
+		// Only the BFS kernels run lanes
+		auto lanes = row.iterations > 0 && row.active_lanes > 0
+		                 ? Value::DOUBLE(static_cast<double>(row.active_lanes) / static_cast<double>(row.iterations))
+		                 : Value();
+		output.SetValue(4, count, lanes);
+		output.SetValue(5, count, Value::BIGINT(static_cast<int64_t>(row.scratch_bytes)));
+		output.SetValue(6, count, Value::BIGINT(static_cast<int64_t>(row.microseconds)));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterDuckPGQMetricsTableFunction(ExtensionLoader &loader) {
+	loader.RegisterFunction(DuckPGQMetricsFunction());
+}
+
+} // namespace duckdb
@@ -0,0 +1,41 @@
+#include "duckpgq/core/functions/table/kcore.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+
+#include <duckpgq/core/functions/table.hpp>
+#include <duckpgq/core/utils/compressed_sparse_row.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+// WITH csr_cte AS (<undirected CSR>)
+// SELECT <source key>, __x.temp + kcore(0, rowid) AS kcore FROM <vertex table>, __x
+unique_ptr<TableRef> KCoreFunction::KCoreBindReplace(ClientContext &context, TableFunctionBindInput &input) {
+	auto pg_name = StringUtil::Lower(StringValue::Get(input.inputs[0]));
+	auto node_table = StringUtil::Lower(StringValue::Get(input.inputs[1]));
+	auto edge_table = StringUtil::Lower(StringValue::Get(input.inputs[2]));
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
+	auto edge_pg_entry = ValidateSourceNodeAndEdgeTable(pg_info, node_table, edge_table);
+
+	auto select_node = CreateSelectNode(edge_pg_entry, "kcore", "kcore");
+
+	select_node->cte_map.map["csr_cte"] = CreateUndirectedCSRCTE(context, pg_name, edge_pg_entry, select_node);
+
+	auto subquery = make_uniq<SelectStatement>();
+	subquery->node = std::move(select_node);
+
+	auto result = make_uniq<SubqueryRef>(std::move(subquery));
+	result->alias = "kcore";
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterKCoreTableFunction(ExtensionLoader &loader) {
+	loader.RegisterFunction(KCoreFunction());
+}
+
+} // namespace duckdb
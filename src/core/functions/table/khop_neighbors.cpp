@@ -0,0 +1,136 @@
+#include "duckpgq/core/functions/table/khop_neighbors.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/parser/expression/comparison_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+
+#include <duckpgq/core/functions/table.hpp>
+#include <duckpgq/core/utils/csr_temporal_index.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+static unique_ptr<ParsedExpression> ExtractField(const string &field) {
+	vector<unique_ptr<ParsedExpression>> children;
+	children.push_back(make_uniq<ColumnRefExpression>("neighbor", "__n"));
+	children.push_back(make_uniq<ConstantExpression>(Value(field)));
+	return make_uniq<FunctionExpression>("struct_extract", std::move(children));
+}
+
+//! The as_of parameter as the TIMESTAMP or BIGINT the temporal index of the cached CSR of [edge_table] compares
+static Value GetAsOf(ClientContext &context, const string &pg_name, const shared_ptr<PropertyGraphTable> &edge_table,
+                     const Value &as_of) {
+	if (as_of.IsNull()) {
+		throw InvalidInputException("The as_of parameter of khop_neighbors cannot be NULL");
+	}
+	auto csr = GetDuckPGQState(context)->GetCachedCSR(pg_name, edge_table->main_label, true, "");
+	auto temporal_index = csr ? csr->GetTemporalIndex() : nullptr;
+	if (!temporal_index) {
+		throw InvalidInputException("No temporal index found for %s in property graph %s, build it first with PRAGMA "
+		                            "create_temporal_index",
+		                            edge_table->main_label, pg_name);
+	}
+	return as_of.CastAs(context, temporal_index->IsTimestamp() ? LogicalType::TIMESTAMP : LogicalType::BIGINT);
+}
+
+// WITH csr_cte AS (...)
+// SELECT __n.source, __t.<key>, struct_extract(__n.neighbor, 'depth') AS depth
+// FROM (SELECT __s.<key> AS source,
+//              unnest(khop_neighbors(0, NULL::BIGINT, __x.temp + __s.rowid, k[, as_of])) AS neighbor
+//       FROM <vertex table> __s, (SELECT count(csr_cte.temp) * 0 AS temp FROM csr_cte) __x
+//       WHERE list_contains(<sources>, __s.<key>)) __n
+// JOIN <vertex table> __t ON __t.rowid = struct_extract(__n.neighbor, 'vertex')
+unique_ptr<TableRef> KHopNeighborsFunction::KHopNeighborsBindReplace(ClientContext &context,
+                                                                     TableFunctionBindInput &input) {
+	auto pg_name = StringUtil::Lower(StringValue::Get(input.inputs[0]));
+	auto node_table = StringUtil::Lower(StringValue::Get(input.inputs[1]));
+	auto edge_table = StringUtil::Lower(StringValue::Get(input.inputs[2]));
+	auto sources = input.inputs[3];
+	if (sources.type().id() != LogicalTypeId::LIST) {
+		sources = Value::LIST({sources});
+	}
+	auto k = input.inputs[4].GetValue<int64_t>();
+	if (k < 0) {
+		throw InvalidInputException("khop_neighbors needs a non-negative number of hops");
+	}
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
+	auto edge_pg_entry = ValidateSourceNodeAndEdgeTable(pg_info, node_table, edge_table);
+	auto &vertex_key = edge_pg_entry->source_pk[0];
+
+	// One row per source, with the list of its neighbors
+	auto source_select_node = make_uniq<SelectNode>();
+	auto source_column = make_uniq<ColumnRefExpression>(vertex_key, "__s");
+	source_column->alias = "source";
+	source_select_node->select_list.push_back(std::move(source_column));
+
+	vector<unique_ptr<ParsedExpression>> source_children;
+	source_children.push_back(make_uniq<ColumnRefExpression>("temp", "__x"));
+	source_children.push_back(make_uniq<ColumnRefExpression>("rowid", "__s"));
+	vector<unique_ptr<ParsedExpression>> function_children;
+	function_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
+	function_children.push_back(CreateVertexCountArgument());
+	function_children.push_back(make_uniq<FunctionExpression>("add", std::move(source_children)));
+	function_children.push_back(make_uniq<ConstantExpression>(Value::BIGINT(k)));
+	auto as_of = input.named_parameters.find("as_of");
+	if (as_of != input.named_parameters.end()) {
+		function_children.push_back(
+		    make_uniq<ConstantExpression>(GetAsOf(context, pg_name, edge_pg_entry, as_of->second)));
+	}
+	vector<unique_ptr<ParsedExpression>> unnest_children;
+	unnest_children.push_back(make_uniq<FunctionExpression>("khop_neighbors", std::move(function_children)));
+	auto unnest_function = make_uniq<FunctionExpression>("unnest", std::move(unnest_children));
+	unnest_function->alias = "neighbor";
+	source_select_node->select_list.push_back(std::move(unnest_function));
+
+	auto cross_join_ref = make_uniq<JoinRef>(JoinRefType::CROSS);
+	cross_join_ref->left = edge_pg_entry->source_pg_table->CreateBaseTableRef("__s");
+	cross_join_ref->right = CreateCountCTESubquery();
+	source_select_node->from_table = std::move(cross_join_ref);
+
+	vector<unique_ptr<ParsedExpression>> contains_children;
+	contains_children.push_back(make_uniq<ConstantExpression>(sources));
+	contains_children.push_back(make_uniq<ColumnRefExpression>(vertex_key, "__s"));
+	source_select_node->where_clause = make_uniq<FunctionExpression>("list_contains", std::move(contains_children));
+
+	auto source_subquery = make_uniq<SelectStatement>();
+	source_subquery->node = std::move(source_select_node);
+
+	// One row per source and neighbor, keyed like the vertex table
+	auto select_node = make_uniq<SelectNode>();
+	select_node->select_list.push_back(make_uniq<ColumnRefExpression>("source", "__n"));
+	select_node->select_list.push_back(make_uniq<ColumnRefExpression>(vertex_key, "__t"));
+	auto depth = ExtractField("depth");
+	depth->alias = "depth";
+	select_node->select_list.push_back(std::move(depth));
+
+	auto join_ref = make_uniq<JoinRef>(JoinRefType::REGULAR);
+	join_ref->type = JoinType::INNER;
+	join_ref->left = make_uniq<SubqueryRef>(std::move(source_subquery), "__n");
+	join_ref->right = edge_pg_entry->source_pg_table->CreateBaseTableRef("__t");
+	join_ref->condition = make_uniq<ComparisonExpression>(
+	    ExpressionType::COMPARE_EQUAL, make_uniq<ColumnRefExpression>("rowid", "__t"), ExtractField("vertex"));
+	select_node->from_table = std::move(join_ref);
+
+	select_node->cte_map.map["csr_cte"] = CreateDirectedCSRCTE(context, pg_name, edge_pg_entry, "src", "edge", "dst");
+
+	auto subquery = make_uniq<SelectStatement>();
+	subquery->node = std::move(select_node);
+
+	auto result = make_uniq<SubqueryRef>(std::move(subquery));
+	result->alias = "khop_neighbors";
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterKHopNeighborsTableFunction(ExtensionLoader &loader) {
+	loader.RegisterFunction(KHopNeighborsFunction());
+}
+
+} // namespace duckdb
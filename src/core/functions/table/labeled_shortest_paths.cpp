@@ -0,0 +1,164 @@
+#include "duckpgq/core/functions/table/labeled_shortest_paths.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/parser/expression/comparison_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+
+#include <duckpgq/core/functions/table.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+//! The edge tables that connect [vertex_table] to itself, in the order of the property graph. Their positions are
+//! the label ids of the labeled CSR.
+static vector<shared_ptr<PropertyGraphTable>> GetLabeledEdgeTables(CreatePropertyGraphInfo &pg_info,
+                                                                   const shared_ptr<PropertyGraphTable> &vertex_table) {
+	vector<shared_ptr<PropertyGraphTable>> result;
+	for (auto &edge_table : pg_info.edge_tables) {
+		if (edge_table->source_reference == vertex_table->table_name &&
+		    edge_table->destination_reference == vertex_table->table_name) {
+			result.push_back(edge_table);
+		}
+	}
+	if (result.size() > CSR_LABEL_LIMIT) {
+		throw InvalidInputException("labeled_shortest_paths supports at most %d edge tables per vertex table",
+		                            CSR_LABEL_LIMIT);
+	}
+	return result;
+}
+
+//! The mask of the label ids of [labels] among [edge_tables]
+static uint64_t GetLabelMask(const vector<shared_ptr<PropertyGraphTable>> &edge_tables, const Value &labels,
+                             const string &vertex_label) {
+	uint64_t mask = 0;
+	for (auto &label : ListValue::GetChildren(labels)) {
+		if (label.IsNull()) {
+			continue;
+		}
+		auto &name = StringValue::Get(label);
+		idx_t label_id = 0;
+		while (label_id < edge_tables.size() && !StringUtil::CIEquals(edge_tables[label_id]->main_label, name)) {
+			label_id++;
+		}
+		if (label_id == edge_tables.size()) {
+			throw InvalidInputException("%s is not an edge table between the vertices of %s", name, vertex_label);
+		}
+		mask |= uint64_t(1) << label_id;
+	}
+	return mask;
+}
+
+static Value ListArgument(const Value &argument) {
+	if (argument.type().id() != LogicalTypeId::LIST) {
+		return Value::LIST({argument});
+	}
+	return argument;
+}
+
+// WITH labeled_edges_cte AS (...), csr_cte AS (...)
+// SELECT __p.source, __d.<key> AS destination, __p.path, len(__p.path) // 2 AS path_length
+// FROM (SELECT __s.<key> AS source,
+//              unnest(shortestpath_targets(0, NULL::BIGINT, __x.temp + __s.rowid, 0, <max>, <label mask>)) AS path
+//       FROM <vertex table> __s, (SELECT count(csr_cte.temp) * 0 AS temp FROM csr_cte) __x
+//       WHERE list_contains(<sources>, __s.<key>)) __p
+// JOIN <vertex table> __d ON __d.rowid = __p.path[-1]
+unique_ptr<TableRef> LabeledShortestPathsFunction::LabeledShortestPathsBindReplace(ClientContext &context,
+                                                                                   TableFunctionBindInput &input) {
+	auto pg_name = StringUtil::Lower(StringValue::Get(input.inputs[0]));
+	auto node_table = StringUtil::Lower(StringValue::Get(input.inputs[1]));
+	if (input.inputs[2].IsNull()) {
+		throw InvalidInputException("labeled_shortest_paths needs a list of edge labels");
+	}
+	auto sources = ListArgument(input.inputs[3]);
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
+	auto vertex_table = pg_info->GetTableByLabel(node_table, true, true);
+	if (!vertex_table->is_vertex_table) {
+		throw Exception(ExceptionType::INVALID, node_table + " is an edge table, expected a vertex table");
+	}
+	auto edge_tables = GetLabeledEdgeTables(*pg_info, vertex_table);
+	if (edge_tables.empty()) {
+		throw InvalidInputException("No edge table connects the vertices of %s", node_table);
+	}
+	auto label_mask = GetLabelMask(edge_tables, input.inputs[2], node_table);
+	auto &vertex_key = edge_tables[0]->source_pk[0];
+
+	auto paths_select_node = make_uniq<SelectNode>();
+	auto source_column = make_uniq<ColumnRefExpression>(vertex_key, "__s");
+	source_column->alias = "source";
+	paths_select_node->select_list.push_back(std::move(source_column));
+	vector<unique_ptr<ParsedExpression>> source_children;
+	source_children.push_back(make_uniq<ColumnRefExpression>("temp", "__x"));
+	source_children.push_back(make_uniq<ColumnRefExpression>("rowid", "__s"));
+	vector<unique_ptr<ParsedExpression>> function_children;
+	function_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
+	function_children.push_back(CreateVertexCountArgument());
+	function_children.push_back(make_uniq<FunctionExpression>("add", std::move(source_children)));
+	function_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
+	function_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(NumericLimits<int32_t>::Maximum())));
+	function_children.push_back(make_uniq<ConstantExpression>(Value::UBIGINT(label_mask)));
+	vector<unique_ptr<ParsedExpression>> unnest_children;
+	unnest_children.push_back(make_uniq<FunctionExpression>("shortestpath_targets", std::move(function_children)));
+	auto unnest_function = make_uniq<FunctionExpression>("unnest", std::move(unnest_children));
+	unnest_function->alias = "path";
+	paths_select_node->select_list.push_back(std::move(unnest_function));
+
+	auto cross_join_ref = make_uniq<JoinRef>(JoinRefType::CROSS);
+	cross_join_ref->left = vertex_table->CreateBaseTableRef("__s");
+	cross_join_ref->right = CreateCountCTESubquery();
+	paths_select_node->from_table = std::move(cross_join_ref);
+	vector<unique_ptr<ParsedExpression>> contains_children;
+	contains_children.push_back(make_uniq<ConstantExpression>(sources));
+	contains_children.push_back(make_uniq<ColumnRefExpression>(vertex_key, "__s"));
+	paths_select_node->where_clause = make_uniq<FunctionExpression>("list_contains", std::move(contains_children));
+	auto paths_statement = make_uniq<SelectStatement>();
+	paths_statement->node = std::move(paths_select_node);
+
+	auto select_node = make_uniq<SelectNode>();
+	select_node->select_list.push_back(make_uniq<ColumnRefExpression>("source", "__p"));
+	auto destination_column = make_uniq<ColumnRefExpression>(vertex_key, "__d");
+	destination_column->alias = "destination";
+	select_node->select_list.push_back(std::move(destination_column));
+	select_node->select_list.push_back(make_uniq<ColumnRefExpression>("path", "__p"));
+	vector<unique_ptr<ParsedExpression>> len_children;
+	len_children.push_back(make_uniq<ColumnRefExpression>("path", "__p"));
+	vector<unique_ptr<ParsedExpression>> div_children;
+	div_children.push_back(make_uniq<FunctionExpression>("len", std::move(len_children)));
+	div_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(2)));
+	auto path_length = make_uniq<FunctionExpression>("//", std::move(div_children));
+	path_length->alias = "path_length";
+	select_node->select_list.push_back(std::move(path_length));
+
+	auto join_ref = make_uniq<JoinRef>(JoinRefType::REGULAR);
+	join_ref->left = make_uniq<SubqueryRef>(std::move(paths_statement), "__p");
+	join_ref->right = vertex_table->CreateBaseTableRef("__d");
+	vector<unique_ptr<ParsedExpression>> last_children;
+	last_children.push_back(make_uniq<ColumnRefExpression>("path", "__p"));
+	last_children.push_back(make_uniq<ConstantExpression>(Value::BIGINT(-1)));
+	join_ref->condition =
+	    make_uniq<ComparisonExpression>(ExpressionType::COMPARE_EQUAL, make_uniq<ColumnRefExpression>("rowid", "__d"),
+	                                    make_uniq<FunctionExpression>("list_extract", std::move(last_children)));
+	select_node->from_table = std::move(join_ref);
+
+	select_node->cte_map.map["csr_cte"] = CreateLabeledCSRCTE(context, pg_name, vertex_table, edge_tables, select_node);
+
+	auto subquery = make_uniq<SelectStatement>();
+	subquery->node = std::move(select_node);
+
+	auto result = make_uniq<SubqueryRef>(std::move(subquery));
+	result->alias = "labeled_shortest_paths";
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterLabeledShortestPathsTableFunction(ExtensionLoader &loader) {
+	loader.RegisterFunction(LabeledShortestPathsFunction());
+}
+
+} // namespace duckdb
@@ -15,6 +15,8 @@
 #include "duckdb/parser/expression/comparison_expression.hpp"
 #include "duckdb/parser/expression/conjunction_expression.hpp"
 #include "duckdb/parser/expression/star_expression.hpp"
+#include "duckdb/parser/expression/subquery_expression.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
 
 #include "duckdb/parser/query_node/set_operation_node.hpp"
 
@@ -387,6 +389,126 @@ unique_ptr<ParsedExpression> PGQMatchFunction::CreateWhereClause(vector<unique_p
 	return where_clause;
 }
 
+//! Whether [expression] reads columns of [binding] only, setting [reads_binding] if it reads any
+static bool ReadsOnlyBinding(const ParsedExpression &expression, const string &binding, bool &reads_binding) {
+	if (expression.GetExpressionClass() == ExpressionClass::SUBQUERY) {
+		return false;
+	}
+	if (expression.GetExpressionClass() == ExpressionClass::COLUMN_REF) {
+		auto &column_ref = expression.Cast<ColumnRefExpression>();
+		if (column_ref.column_names.size() != 2 || !StringUtil::CIEquals(column_ref.column_names[0], binding)) {
+			return false;
+		}
+		reads_binding = true;
+		return true;
+	}
+	bool result = true;
+	ParsedExpressionIterator::EnumerateChildren(expression, [&](const ParsedExpression &child) {
+		result = result && ReadsOnlyBinding(child, binding, reads_binding);
+	});
+	return result;
+}
+
+//! Copies the conditions that only filter the vertices of [binding], which can be evaluated before the vertex table
+//! is joined with anything else
+static vector<unique_ptr<ParsedExpression>>
+CopyVertexConditions(const string &binding, const vector<unique_ptr<ParsedExpression>> &conditions) {
+	vector<unique_ptr<ParsedExpression>> result;
+	for (auto &condition : conditions) {
+		bool reads_binding = false;
+		if (condition && ReadsOnlyBinding(*condition, binding, reads_binding) && reads_binding) {
+			result.push_back(condition->Copy());
+		}
+	}
+	return result;
+}
+
+//! The CTE that builds the CSR a path-finding pattern over edges of [edge_type] traverses. Left-directed edges are
+//! followed over the reverse of the directed CSR, which is cached together with it. Edges in either direction are
+//! those of the undirected CSR.
+static unique_ptr<CommonTableExpressionInfo>
+CreatePathFindingCSRCTE(ClientContext &context, const string &pg_name, const shared_ptr<PropertyGraphTable> &edge_table,
+                        const string &prev_binding, const string &edge_binding, const string &next_binding,
+                        PGQMatchType edge_type, const unique_ptr<SelectNode> &select_node) {
+	switch (edge_type) {
+	case PGQMatchType::MATCH_EDGE_RIGHT:
+		return CreateDirectedCSRCTE(context, pg_name, edge_table, prev_binding, edge_binding, next_binding);
+	case PGQMatchType::MATCH_EDGE_LEFT:
+		return CreateReverseCSRCTE(
+		    CreateDirectedCSRCTE(context, pg_name, edge_table, prev_binding, edge_binding, next_binding));
+	default:
+		return CreateUndirectedCSRCTE(context, pg_name, edge_table, select_node);
+	}
+}
+
+//! The CSR the path-finding functions of [subpath] run on, the reverse CSR for left-directed edges
+static int32_t GetPathFindingCSRId(const SubPath *subpath) {
+	auto edge_element = reinterpret_cast<PathElement *>(subpath->path_list[0].get());
+	return edge_element->match_type == PGQMatchType::MATCH_EDGE_LEFT ? REVERSE_CSR_ID : 0;
+}
+
+//! (SELECT list(k.rowid) FROM edges k WHERE <edge_conditions>), the rowids of the edges that pass the WHERE of the
+//! edge pattern in [subpath]. The cached CSR holds all edges, the path-finding functions only follow these.
+static unique_ptr<ParsedExpression> CreateEdgeFilterSubquery(const shared_ptr<PropertyGraphTable> &edge_table,
+                                                             const SubPath *subpath) {
+	auto &edge_binding = reinterpret_cast<PathElement *>(subpath->path_list[0].get())->variable_binding;
+	auto select_node = make_uniq<SelectNode>();
+	vector<unique_ptr<ParsedExpression>> list_children;
+	list_children.push_back(make_uniq<ColumnRefExpression>("rowid", edge_binding));
+	select_node->select_list.push_back(make_uniq<FunctionExpression>("list", std::move(list_children)));
+	select_node->from_table = edge_table->CreateBaseTableRef(edge_binding);
+	select_node->where_clause = subpath->where_clause->Copy();
+	auto select_statement = make_uniq<SelectStatement>();
+	select_statement->node = std::move(select_node);
+	auto result = make_uniq<SubqueryExpression>();
+	result->subquery = std::move(select_statement);
+	result->subquery_type = SubqueryType::SCALAR;
+	return std::move(result);
+}
+
+//! SELECT unnest(<function_name>(<csr_id>, NULL::BIGINT, __x.temp + s.rowid, lower, upper[, <edge filter>])) AS
+//! <alias>, s.rowid AS src_rowid FROM src s, (SELECT count(cte1.temp) * 0 as temp from cte1) __x
+//! WHERE <source_conditions>
+//! Runs one search per source that passes the conditions and returns all targets found, instead of feeding every
+//! pair of source and destination to the path-finding function
+static unique_ptr<SelectNode> CreateSingleSourceSelectNode(const string &function_name, const string &alias,
+                                                           const shared_ptr<PropertyGraphTable> &edge_table,
+                                                           const string &src_binding, const SubPath *subpath,
+                                                           vector<unique_ptr<ParsedExpression>> &source_conditions) {
+	auto select_node = make_uniq<SelectNode>();
+	vector<unique_ptr<ParsedExpression>> source_children;
+	source_children.push_back(make_uniq<ColumnRefExpression>("temp", "__x"));
+	source_children.push_back(make_uniq<ColumnRefExpression>("rowid", src_binding));
+	vector<unique_ptr<ParsedExpression>> pathfinding_children;
+	pathfinding_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(GetPathFindingCSRId(subpath))));
+	pathfinding_children.push_back(CreateVertexCountArgument());
+	pathfinding_children.push_back(make_uniq<FunctionExpression>("add", std::move(source_children)));
+	pathfinding_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(static_cast<int32_t>(subpath->lower))));
+	pathfinding_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(static_cast<int32_t>(subpath->upper))));
+	if (subpath->where_clause) {
+		pathfinding_children.push_back(CreateEdgeFilterSubquery(edge_table, subpath));
+	}
+	vector<unique_ptr<ParsedExpression>> unnest_children;
+	unnest_children.push_back(make_uniq<FunctionExpression>(function_name, std::move(pathfinding_children)));
+	auto unnest_function = make_uniq<FunctionExpression>("unnest", std::move(unnest_children));
+	unnest_function->alias = alias;
+	select_node->select_list.push_back(std::move(unnest_function));
+	auto src_rowid = make_uniq<ColumnRefExpression>("rowid", src_binding);
+	src_rowid->alias = "src_rowid";
+	select_node->select_list.push_back(std::move(src_rowid));
+
+	auto src_tableref = edge_table->source_pg_table->CreateBaseTableRef();
+	src_tableref->alias = src_binding;
+	auto cross_join_ref = make_uniq<JoinRef>(JoinRefType::CROSS);
+	cross_join_ref->left = std::move(src_tableref);
+	cross_join_ref->right = PGQMatchFunction::CreateCountCTESubquery();
+	select_node->from_table = std::move(cross_join_ref);
+	source_conditions.erase(std::remove(source_conditions.begin(), source_conditions.end(), nullptr),
+	                        source_conditions.end());
+	select_node->where_clause = PGQMatchFunction::CreateWhereClause(source_conditions);
+	return select_node;
+}
+
 unique_ptr<CommonTableExpressionInfo>
 PGQMatchFunction::GenerateShortestPathCTE(CreatePropertyGraphInfo &pg_table, SubPath *edge_subpath,
                                           PathElement *previous_vertex_element, PathElement *next_vertex_element,
@@ -400,12 +522,11 @@ PGQMatchFunction::GenerateShortestPathCTE(CreatePropertyGraphInfo &pg_table, Sub
 
 	auto src_row_id = make_uniq<ColumnRefExpression>("rowid", previous_vertex_element->variable_binding);
 	auto dst_row_id = make_uniq<ColumnRefExpression>("rowid", next_vertex_element->variable_binding);
-	auto csr_id = make_uniq<ConstantExpression>(Value::INTEGER(0));
+	auto csr_id = make_uniq<ConstantExpression>(Value::INTEGER(GetPathFindingCSRId(edge_subpath)));
 
 	vector<unique_ptr<ParsedExpression>> pathfinding_children;
 	pathfinding_children.push_back(std::move(csr_id));
-	pathfinding_children.push_back(std::move(GetCountTable(
-	    edge_table->source_pg_table, previous_vertex_element->variable_binding, edge_table->source_pk[0])));
+	pathfinding_children.push_back(CreateVertexCountArgument());
 	pathfinding_children.push_back(std::move(src_row_id));
 	pathfinding_children.push_back(std::move(dst_row_id));
 
@@ -437,8 +558,10 @@ PGQMatchFunction::GenerateShortestPathCTE(CreatePropertyGraphInfo &pg_table, Sub
 	count_children.push_back(make_uniq<ColumnRefExpression>("temp", "cte1"));
 	auto count_function = make_uniq<FunctionExpression>("count", std::move(count_children));
 
-	path_finding_conditions.push_back(AddPathQuantifierCondition(
-	    previous_vertex_element->variable_binding, next_vertex_element->variable_binding, edge_table, edge_subpath));
+	auto path_quantifier_condition =
+	    AddPathQuantifierCondition(previous_vertex_element->variable_binding, next_vertex_element->variable_binding,
+	                               edge_table, edge_subpath, path_finding_conditions);
+	path_finding_conditions.push_back(std::move(path_quantifier_condition));
 
 	select_node->where_clause = CreateWhereClause(path_finding_conditions);
 
@@ -447,9 +570,43 @@ PGQMatchFunction::GenerateShortestPathCTE(CreatePropertyGraphInfo &pg_table, Sub
 	return cte_info;
 }
 
+unique_ptr<CommonTableExpressionInfo>
+PGQMatchFunction::GenerateSingleSourcePathCTE(CreatePropertyGraphInfo &pg_table, SubPath *edge_subpath,
+                                              PathElement *previous_vertex_element,
+                                              vector<unique_ptr<ParsedExpression>> &path_finding_conditions) {
+	auto edge_element = GetPathElement(edge_subpath->path_list[0]);
+	auto edge_table = FindGraphTable(edge_element->label, pg_table);
+
+	//! SELECT __paths.path, __paths.src_rowid, __paths.path[-1] AS dst_rowid
+	//! FROM (SELECT unnest(shortestpath_targets(...)) AS path, a.rowid AS src_rowid ...) __paths
+	auto paths_select_node =
+	    CreateSingleSourceSelectNode("shortestpath_targets", "path", edge_table,
+	                                 previous_vertex_element->variable_binding, edge_subpath, path_finding_conditions);
+	auto paths_statement = make_uniq<SelectStatement>();
+	paths_statement->node = std::move(paths_select_node);
+
+	auto select_node = make_uniq<SelectNode>();
+	select_node->from_table = make_uniq<SubqueryRef>(std::move(paths_statement), "__paths");
+	select_node->select_list.push_back(make_uniq<ColumnRefExpression>("path", "__paths"));
+	select_node->select_list.push_back(make_uniq<ColumnRefExpression>("src_rowid", "__paths"));
+	vector<unique_ptr<ParsedExpression>> last_children;
+	last_children.push_back(make_uniq<ColumnRefExpression>("path", "__paths"));
+	last_children.push_back(make_uniq<ConstantExpression>(Value::BIGINT(-1)));
+	auto dst_rowid = make_uniq<FunctionExpression>("list_extract", std::move(last_children));
+	dst_rowid->alias = "dst_rowid";
+	select_node->select_list.push_back(std::move(dst_rowid));
+
+	auto select_statement = make_uniq<SelectStatement>();
+	select_statement->node = std::move(select_node);
+	auto cte_info = make_uniq<CommonTableExpressionInfo>();
+	cte_info->query = std::move(select_statement);
+	return cte_info;
+}
+
 unique_ptr<ParsedExpression> PGQMatchFunction::CreatePathFindingFunction(
-    vector<unique_ptr<PathReference>> &path_list, CreatePropertyGraphInfo &pg_table, const string &path_variable,
-    unique_ptr<SelectNode> &final_select_node, vector<unique_ptr<ParsedExpression>> &conditions) {
+    ClientContext &context, vector<unique_ptr<PathReference>> &path_list, CreatePropertyGraphInfo &pg_table,
+    const string &path_variable, unique_ptr<SelectNode> &final_select_node,
+    vector<unique_ptr<ParsedExpression>> &conditions) {
 	// This method will return a SubqueryRef of a list of rowids
 	// For every vertex and edge element, we add the rowid to the list using
 	// list_append, or list_prepend The difficulty is that there may be a
@@ -484,33 +641,36 @@ unique_ptr<ParsedExpression> PGQMatchFunction::CreatePathFindingFunction(
 			if (edge_subpath->upper > 1) {
 				// (un)bounded shortest path
 				// Add the shortest path UDF as a CTE
+				// Only the sources are bound, every source finds all its targets in one search. The single-source
+				// functions also take the edge predicate, the destinations of a filtered traversal are filtered after.
+				auto single_source = (previous_vertex_subpath && previous_vertex_subpath->where_clause &&
+				                      !(next_vertex_subpath && next_vertex_subpath->where_clause)) ||
+				                     edge_subpath->where_clause;
 				if (previous_vertex_subpath) {
 					path_finding_conditions.push_back(std::move(previous_vertex_subpath->where_clause));
 				}
-				if (next_vertex_subpath) {
+				if (next_vertex_subpath && single_source) {
+					if (next_vertex_subpath->where_clause) {
+						conditions.push_back(std::move(next_vertex_subpath->where_clause));
+					}
+				} else if (next_vertex_subpath) {
 					path_finding_conditions.push_back(std::move(next_vertex_subpath->where_clause));
 				}
 				if (final_select_node->cte_map.map.find("cte1") == final_select_node->cte_map.map.end()) {
 					edge_element = reinterpret_cast<PathElement *>(edge_subpath->path_list[0].get());
-					if (edge_element->match_type == PGQMatchType::MATCH_EDGE_RIGHT) {
-						final_select_node->cte_map.map["cte1"] = CreateDirectedCSRCTE(
-						    FindGraphTable(edge_element->label, pg_table), previous_vertex_element->variable_binding,
-						    edge_element->variable_binding, next_vertex_element->variable_binding);
-					} else if (edge_element->match_type == PGQMatchType::MATCH_EDGE_ANY) {
-						final_select_node->cte_map.map["cte1"] =
-						    CreateUndirectedCSRCTE(FindGraphTable(edge_element->label, pg_table), final_select_node);
-					} else {
-						throw NotImplementedException("Cannot do shortest path for edge type %s",
-						                              edge_element->match_type == PGQMatchType::MATCH_EDGE_LEFT
-						                                  ? "MATCH_EDGE_LEFT"
-						                                  : "MATCH_EDGE_LEFT_RIGHT");
-					}
+					final_select_node->cte_map.map["cte1"] = CreatePathFindingCSRCTE(
+					    context, pg_table.property_graph_name, FindGraphTable(edge_element->label, pg_table),
+					    previous_vertex_element->variable_binding, edge_element->variable_binding,
+					    next_vertex_element->variable_binding, edge_element->match_type, final_select_node);
 				}
 				string shortest_path_cte_name = "shortest_path_cte";
 				if (final_select_node->cte_map.map.find(shortest_path_cte_name) ==
 				    final_select_node->cte_map.map.end()) {
-					final_select_node->cte_map.map[shortest_path_cte_name] = GenerateShortestPathCTE(
-					    pg_table, edge_subpath, previous_vertex_element, next_vertex_element, path_finding_conditions);
+					final_select_node->cte_map.map[shortest_path_cte_name] =
+					    single_source ? GenerateSingleSourcePathCTE(pg_table, edge_subpath, previous_vertex_element,
+					                                                path_finding_conditions)
+					                  : GenerateShortestPathCTE(pg_table, edge_subpath, previous_vertex_element,
+					                                            next_vertex_element, path_finding_conditions);
 					auto cte_shortest_path_ref = make_uniq<BaseTableRef>();
 					cte_shortest_path_ref->table_name = shortest_path_cte_name;
 					if (!final_select_node->from_table) {
@@ -616,22 +776,69 @@ void PGQMatchFunction::AddEdgeJoins(const shared_ptr<PropertyGraphTable> &edge_t
 	}
 }
 
+//! Whether [expression] compares a column of [binding] to a constant, possibly inside an AND
+static bool HasConstantEquality(const ParsedExpression *expression, const string &binding) {
+	if (!expression) {
+		return false;
+	}
+	if (expression->type == ExpressionType::CONJUNCTION_AND) {
+		auto conjunction = dynamic_cast<const ConjunctionExpression *>(expression);
+		for (auto &child : conjunction->children) {
+			if (HasConstantEquality(child.get(), binding)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	if (expression->type != ExpressionType::COMPARE_EQUAL) {
+		return false;
+	}
+	auto comparison = dynamic_cast<const ComparisonExpression *>(expression);
+	auto is_column = [&](const ParsedExpression *side) {
+		auto column_ref = dynamic_cast<const ColumnRefExpression *>(side);
+		return column_ref && column_ref->column_names.size() == 2 &&
+		       StringUtil::CIEquals(column_ref->column_names[0], binding);
+	};
+	auto is_constant = [](const ParsedExpression *side) {
+		return dynamic_cast<const ConstantExpression *>(side) != nullptr;
+	};
+	return (is_column(comparison->left.get()) && is_constant(comparison->right.get())) ||
+	       (is_constant(comparison->left.get()) && is_column(comparison->right.get()));
+}
+
+//! Whether [conditions] pin [binding] to a constant, so that the path-finding has a single vertex at that end
+static bool IsPinnedVertex(const string &binding, const vector<unique_ptr<ParsedExpression>> &conditions) {
+	for (auto &condition : conditions) {
+		if (HasConstantEquality(condition.get(), binding)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 unique_ptr<ParsedExpression>
 PGQMatchFunction::AddPathQuantifierCondition(const string &prev_binding, const string &next_binding,
-                                             const shared_ptr<PropertyGraphTable> &edge_table, const SubPath *subpath) {
+                                             const shared_ptr<PropertyGraphTable> &edge_table, const SubPath *subpath,
+                                             const vector<unique_ptr<ParsedExpression>> &conditions) {
 
 	auto src_row_id = make_uniq<ColumnRefExpression>("rowid", prev_binding);
 	auto dst_row_id = make_uniq<ColumnRefExpression>("rowid", next_binding);
-	auto csr_id = make_uniq<ConstantExpression>(Value::INTEGER(0));
+	auto csr_id = make_uniq<ConstantExpression>(Value::INTEGER(GetPathFindingCSRId(subpath)));
 
 	vector<unique_ptr<ParsedExpression>> pathfinding_children;
 	pathfinding_children.push_back(std::move(csr_id));
-	pathfinding_children.push_back(
-	    std::move(GetCountTable(edge_table->source_pg_table, prev_binding, edge_table->source_pk[0])));
+	pathfinding_children.push_back(CreateVertexCountArgument());
 	pathfinding_children.push_back(std::move(src_row_id));
 	pathfinding_children.push_back(std::move(dst_row_id));
 
-	auto reachability_function = make_uniq<FunctionExpression>("iterativelength", std::move(pathfinding_children));
+	// Point-to-point searches meet in the middle, which explores far fewer vertices than a search from the source
+	auto point_to_point = IsPinnedVertex(prev_binding, conditions) && IsPinnedVertex(next_binding, conditions);
+	if (!point_to_point) {
+		// The search from the source stops at the upper bound instead of exploring all that is reachable
+		pathfinding_children.push_back(make_uniq<ConstantExpression>(Value::BIGINT(subpath->upper)));
+	}
+	auto reachability_function = make_uniq<FunctionExpression>(
+	    point_to_point ? "iterativelengthbidirectional" : "iterativelength", std::move(pathfinding_children));
 
 	auto cte_col_ref = make_uniq<ColumnRefExpression>("temp", "__x");
 
@@ -647,7 +854,7 @@ PGQMatchFunction::AddPathQuantifierCondition(const string &prev_binding, const s
 	return std::move(between_expression);
 }
 
-void PGQMatchFunction::AddPathFinding(unique_ptr<SelectNode> &select_node,
+void PGQMatchFunction::AddPathFinding(ClientContext &context, unique_ptr<SelectNode> &select_node,
                                       vector<unique_ptr<ParsedExpression>> &conditions, const string &prev_binding,
                                       const string &edge_binding, const string &next_binding,
                                       const shared_ptr<PropertyGraphTable> &edge_table,
@@ -655,20 +862,42 @@ void PGQMatchFunction::AddPathFinding(unique_ptr<SelectNode> &select_node,
 	//! START
 	//! FROM (SELECT count(cte1.temp) * 0 as temp from cte1) __x
 	if (select_node->cte_map.map.find("cte1") == select_node->cte_map.map.end()) {
-		if (edge_type == PGQMatchType::MATCH_EDGE_RIGHT) {
-			select_node->cte_map.map["cte1"] =
-			    CreateDirectedCSRCTE(edge_table, prev_binding, edge_binding, next_binding);
-		} else if (edge_type == PGQMatchType::MATCH_EDGE_ANY) {
-			select_node->cte_map.map["cte1"] = CreateUndirectedCSRCTE(edge_table, select_node);
-		} else {
-			throw NotImplementedException("Cannot do shortest path for edge type %s",
-			                              edge_type == PGQMatchType::MATCH_EDGE_LEFT ? "MATCH_EDGE_LEFT"
-			                                                                         : "MATCH_EDGE_LEFT_RIGHT");
-		}
+		select_node->cte_map.map["cte1"] = CreatePathFindingCSRCTE(context, pg_table.property_graph_name, edge_table,
+		                                                           prev_binding, edge_binding, next_binding,
+		                                                           edge_type, select_node);
 	}
 	if (select_node->cte_map.map.find("shortest_path_cte") != select_node->cte_map.map.end()) {
 		return;
 	}
+	auto source_conditions = CopyVertexConditions(prev_binding, conditions);
+	// The edge predicate is only taken by the single-source functions
+	if ((!source_conditions.empty() && CopyVertexConditions(next_binding, conditions).empty()) ||
+	    subpath->where_clause) {
+		//! START
+		//! FROM (SELECT unnest(reachable_targets(...)) AS dst_rowid, a.rowid AS src_rowid ...) __reachable_<edge>
+		//! WHERE __reachable_<edge>.src_rowid = a.rowid AND __reachable_<edge>.dst_rowid = b.rowid
+		auto reachable_name = "__reachable_" + edge_binding;
+		auto reachable_statement = make_uniq<SelectStatement>();
+		reachable_statement->node = CreateSingleSourceSelectNode("reachable_targets", "dst_rowid", edge_table,
+		                                                         prev_binding, subpath, source_conditions);
+		auto reachable_ref = make_uniq<SubqueryRef>(std::move(reachable_statement), reachable_name);
+		if (select_node->from_table) {
+			auto from_join = make_uniq<JoinRef>(JoinRefType::CROSS);
+			from_join->left = std::move(select_node->from_table);
+			from_join->right = std::move(reachable_ref);
+			select_node->from_table = std::move(from_join);
+		} else {
+			select_node->from_table = std::move(reachable_ref);
+		}
+		conditions.push_back(make_uniq<ComparisonExpression>(
+		    ExpressionType::COMPARE_EQUAL, make_uniq<ColumnRefExpression>("src_rowid", reachable_name),
+		    make_uniq<ColumnRefExpression>("rowid", prev_binding)));
+		conditions.push_back(make_uniq<ComparisonExpression>(
+		    ExpressionType::COMPARE_EQUAL, make_uniq<ColumnRefExpression>("dst_rowid", reachable_name),
+		    make_uniq<ColumnRefExpression>("rowid", next_binding)));
+		//! END
+		return;
+	}
 	auto temp_cte_select_subquery = CreateCountCTESubquery();
 	if (select_node->from_table) {
 		// create a cross join since there is already something in the
@@ -684,15 +913,15 @@ void PGQMatchFunction::AddPathFinding(unique_ptr<SelectNode> &select_node,
 	//! FROM (SELECT count(cte1.temp) * 0 as temp from cte1) __x
 
 	//! START
-	//! WHERE __x.temp + iterativelength(<csr_id>, (SELECT count(c.id)
-	//!       from dst c, a.rowid, b.rowid) between lower and upper
-	conditions.push_back(AddPathQuantifierCondition(prev_binding, next_binding, edge_table, subpath));
+	//! WHERE __x.temp + iterativelength(<csr_id>, NULL::BIGINT, a.rowid, b.rowid, upper) between lower and upper
+	auto path_quantifier_condition =
+	    AddPathQuantifierCondition(prev_binding, next_binding, edge_table, subpath, conditions);
+	conditions.push_back(std::move(path_quantifier_condition));
 	//! END
-	//! WHERE __x.temp + iterativelength(<csr_id>, (SELECT count(s.id)
-	//! from src s, a.rowid, b.rowid) between lower and upper
+	//! WHERE __x.temp + iterativelength(<csr_id>, NULL::BIGINT, a.rowid, b.rowid, upper) between lower and upper
 }
 
-void PGQMatchFunction::CheckNamedSubpath(SubPath &subpath, MatchExpression &original_ref,
+void PGQMatchFunction::CheckNamedSubpath(ClientContext &context, SubPath &subpath, MatchExpression &original_ref,
                                          CreatePropertyGraphInfo &pg_table, unique_ptr<SelectNode> &final_select_node,
                                          vector<unique_ptr<ParsedExpression>> &conditions) {
 	for (idx_t idx_i = 0; idx_i < original_ref.column_list.size(); idx_i++) {
@@ -713,8 +942,8 @@ void PGQMatchFunction::CheckNamedSubpath(SubPath &subpath, MatchExpression &orig
 		if (parsed_ref->function_name == "element_id") {
 			// Check subpath name matches the column referenced in the function -->
 			// element_id(named_subpath)
-			auto shortest_path_function = CreatePathFindingFunction(subpath.path_list, pg_table, subpath.path_variable,
-			                                                        final_select_node, conditions);
+			auto shortest_path_function = CreatePathFindingFunction(
+			    context, subpath.path_list, pg_table, subpath.path_variable, final_select_node, conditions);
 
 			if (column_alias.empty()) {
 				shortest_path_function->alias = "element_id(" + subpath.path_variable + ")";
@@ -725,8 +954,8 @@ void PGQMatchFunction::CheckNamedSubpath(SubPath &subpath, MatchExpression &orig
 			original_ref.column_list.insert(original_ref.column_list.begin() + static_cast<int64_t>(idx_i),
 			                                std::move(shortest_path_function));
 		} else if (parsed_ref->function_name == "path_length") {
-			auto shortest_path_function = CreatePathFindingFunction(subpath.path_list, pg_table, subpath.path_variable,
-			                                                        final_select_node, conditions);
+			auto shortest_path_function = CreatePathFindingFunction(
+			    context, subpath.path_list, pg_table, subpath.path_variable, final_select_node, conditions);
 			auto path_len_children = vector<unique_ptr<ParsedExpression>>();
 			path_len_children.push_back(std::move(shortest_path_function));
 			auto path_len = make_uniq<FunctionExpression>("len", std::move(path_len_children));
@@ -742,8 +971,8 @@ void PGQMatchFunction::CheckNamedSubpath(SubPath &subpath, MatchExpression &orig
 			                                std::move(path_length_function));
 		} else if (parsed_ref->function_name == "vertices" || parsed_ref->function_name == "edges") {
 			auto list_slice_children = vector<unique_ptr<ParsedExpression>>();
-			auto shortest_path_function = CreatePathFindingFunction(subpath.path_list, pg_table, subpath.path_variable,
-			                                                        final_select_node, conditions);
+			auto shortest_path_function = CreatePathFindingFunction(
+			    context, subpath.path_list, pg_table, subpath.path_variable, final_select_node, conditions);
 			list_slice_children.push_back(std::move(shortest_path_function));
 
 			if (parsed_ref->function_name == "vertices") {
@@ -769,7 +998,7 @@ void PGQMatchFunction::CheckNamedSubpath(SubPath &subpath, MatchExpression &orig
 	}
 }
 
-void PGQMatchFunction::ProcessPathList(vector<unique_ptr<PathReference>> &path_list,
+void PGQMatchFunction::ProcessPathList(ClientContext &context, vector<unique_ptr<PathReference>> &path_list,
                                        vector<unique_ptr<ParsedExpression>> &conditions,
                                        unique_ptr<SelectNode> &final_select_node,
                                        case_insensitive_map_t<shared_ptr<PropertyGraphTable>> &alias_map,
@@ -782,14 +1011,14 @@ void PGQMatchFunction::ProcessPathList(vector<unique_ptr<PathReference>> &path_l
 			conditions.push_back(std::move(previous_vertex_subpath->where_clause));
 		}
 		if (!previous_vertex_subpath->path_variable.empty() && previous_vertex_subpath->path_list.size() > 1) {
-			CheckNamedSubpath(*previous_vertex_subpath, original_ref, pg_table, final_select_node, conditions);
+			CheckNamedSubpath(context, *previous_vertex_subpath, original_ref, pg_table, final_select_node, conditions);
 		}
 		if (previous_vertex_subpath->path_list.size() == 1) {
 			previous_vertex_element = GetPathElement(previous_vertex_subpath->path_list[0]);
 		} else {
 			// Add the shortest path if the name is found in the column_list
-			ProcessPathList(previous_vertex_subpath->path_list, conditions, final_select_node, alias_map, pg_table,
-			                extra_alias_counter, original_ref);
+			ProcessPathList(context, previous_vertex_subpath->path_list, conditions, final_select_node, alias_map,
+			                pg_table, extra_alias_counter, original_ref);
 			return;
 		}
 	}
@@ -821,7 +1050,8 @@ void PGQMatchFunction::ProcessPathList(vector<unique_ptr<PathReference>> &path_l
 		if (!edge_element) {
 			// We are dealing with a subpath
 			auto edge_subpath = reinterpret_cast<SubPath *>(path_list[idx_j].get());
-			if (edge_subpath->where_clause) {
+			// The path-finding functions filter the edges of a path themselves
+			if (edge_subpath->where_clause && edge_subpath->upper <= 1) {
 				conditions.push_back(std::move(edge_subpath->where_clause));
 			}
 			if (edge_subpath->path_list.size() > 1) {
@@ -832,7 +1062,7 @@ void PGQMatchFunction::ProcessPathList(vector<unique_ptr<PathReference>> &path_l
 
 			if (edge_subpath->upper > 1) {
 				// Add the path-finding
-				AddPathFinding(final_select_node, conditions, previous_vertex_element->variable_binding,
+				AddPathFinding(context, final_select_node, conditions, previous_vertex_element->variable_binding,
 				               edge_element->variable_binding, next_vertex_element->variable_binding, edge_table,
 				               pg_table, edge_subpath, edge_element->match_type);
 			} else {
@@ -864,6 +1094,181 @@ void PGQMatchFunction::ProcessPathList(vector<unique_ptr<PathReference>> &path_l
 	}
 }
 
+//! The element of a hop chain at [path_reference], which is either a path element or a subpath that only adds a
+//! WHERE to one. Returns nullptr for anything else.
+static PathElement *GetHopElement(const unique_ptr<PathReference> &path_reference) {
+	auto element = PGQMatchFunction::GetPathElement(path_reference);
+	if (element) {
+		return element;
+	}
+	auto subpath = PGQMatchFunction::GetSubPath(path_reference);
+	if (subpath->path_list.size() != 1 || !subpath->path_variable.empty() || subpath->upper > 1) {
+		return nullptr;
+	}
+	return PGQMatchFunction::GetPathElement(subpath->path_list[0]);
+}
+
+//! Collects the elements of [path_list] if it is a chain of single hops (v0)-[e0]->(v1)-...->(vk) along the edges
+//! of one [edge_table] whose source and destination are the same vertex table
+static bool GetHopChain(const vector<unique_ptr<PathReference>> &path_list, CreatePropertyGraphInfo &pg_table,
+                        vector<PathElement *> &elements, shared_ptr<PropertyGraphTable> &edge_table) {
+	if (path_list.size() % 2 == 0 || path_list.size() < 3) {
+		return false;
+	}
+	for (auto &path_reference : path_list) {
+		auto element = GetHopElement(path_reference);
+		if (!element) {
+			return false;
+		}
+		elements.push_back(element);
+	}
+	if (elements[1]->match_type != PGQMatchType::MATCH_EDGE_RIGHT) {
+		return false;
+	}
+	edge_table = PGQMatchFunction::FindGraphTable(elements[1]->label, pg_table);
+	auto &vertex_table_name = edge_table->source_pg_table->table_name;
+	if (vertex_table_name != edge_table->destination_pg_table->table_name) {
+		return false;
+	}
+	for (idx_t i = 0; i < elements.size(); i++) {
+		auto &element = *elements[i];
+		auto &table_name = PGQMatchFunction::FindGraphTable(element.label, pg_table)->table_name;
+		if (i % 2 == 0) {
+			if (element.match_type != PGQMatchType::MATCH_VERTEX || table_name != vertex_table_name) {
+				return false;
+			}
+		} else if (element.match_type != PGQMatchType::MATCH_EDGE_RIGHT || table_name != edge_table->table_name) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//! Whether the first [count] elements bind distinct variables
+static bool HasDistinctBindings(const vector<PathElement *> &elements, idx_t count) {
+	case_insensitive_set_t bindings;
+	for (idx_t i = 0; i < count; i++) {
+		if (!bindings.insert(elements[i]->variable_binding).second) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//! Binds the first [bound_count] elements of a hop chain to the walks that [walk_function] returns for every vertex
+//! of the chain's vertex table, which list the rowids of v0, e0, v1, e1, ... in pattern order
+static void AddWalkJoin(ClientContext &context, vector<unique_ptr<PathReference>> &path_list,
+                        const vector<PathElement *> &elements, const shared_ptr<PropertyGraphTable> &edge_table,
+                        const string &walk_function, idx_t bound_count,
+                        vector<unique_ptr<ParsedExpression>> &conditions, unique_ptr<SelectNode> &final_select_node,
+                        case_insensitive_map_t<shared_ptr<PropertyGraphTable>> &alias_map,
+                        CreatePropertyGraphInfo &pg_table) {
+	for (idx_t i = 0; i < elements.size(); i++) {
+		auto subpath = PGQMatchFunction::GetSubPath(path_list[i]);
+		if (subpath && subpath->where_clause) {
+			conditions.push_back(std::move(subpath->where_clause));
+		}
+		auto table = PGQMatchFunction::FindGraphTable(elements[i]->label, pg_table);
+		PGQMatchFunction::CheckInheritance(table, elements[i], conditions);
+		alias_map[elements[i]->variable_binding] = table;
+	}
+	if (final_select_node->cte_map.map.find("cte1") == final_select_node->cte_map.map.end()) {
+		final_select_node->cte_map.map["cte1"] =
+		    CreateDirectedCSRCTE(context, pg_table.property_graph_name, edge_table, elements[0]->variable_binding,
+		                         elements[1]->variable_binding, elements[2]->variable_binding);
+	}
+
+	//! START
+	//! FROM (SELECT unnest(<walk_function>(0, NULL::BIGINT, __x.temp + __walk_src.rowid, k))
+	//!       AS walk FROM src __walk_src, (SELECT count(cte1.temp) * 0 as temp from cte1) __x) __walks
+	auto walks_select_node = make_uniq<SelectNode>();
+	vector<unique_ptr<ParsedExpression>> source_children;
+	source_children.push_back(make_uniq<ColumnRefExpression>("temp", "__x"));
+	source_children.push_back(make_uniq<ColumnRefExpression>("rowid", "__walk_src"));
+	vector<unique_ptr<ParsedExpression>> walk_children;
+	walk_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
+	walk_children.push_back(CreateVertexCountArgument());
+	walk_children.push_back(make_uniq<FunctionExpression>("add", std::move(source_children)));
+	walk_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(static_cast<int32_t>(elements.size() / 2))));
+	vector<unique_ptr<ParsedExpression>> unnest_children;
+	unnest_children.push_back(make_uniq<FunctionExpression>(walk_function, std::move(walk_children)));
+	auto unnest_function = make_uniq<FunctionExpression>("unnest", std::move(unnest_children));
+	unnest_function->alias = "walk";
+	walks_select_node->select_list.push_back(std::move(unnest_function));
+
+	auto source_ref = edge_table->source_pg_table->CreateBaseTableRef();
+	source_ref->alias = "__walk_src";
+	auto walks_join_ref = make_uniq<JoinRef>(JoinRefType::CROSS);
+	walks_join_ref->left = std::move(source_ref);
+	walks_join_ref->right = PGQMatchFunction::CreateCountCTESubquery();
+	walks_select_node->from_table = std::move(walks_join_ref);
+	auto walks_statement = make_uniq<SelectStatement>();
+	walks_statement->node = std::move(walks_select_node);
+	auto walks_ref = make_uniq<SubqueryRef>(std::move(walks_statement), "__walks");
+	if (final_select_node->from_table) {
+		auto from_join = make_uniq<JoinRef>(JoinRefType::CROSS);
+		from_join->left = std::move(final_select_node->from_table);
+		from_join->right = std::move(walks_ref);
+		final_select_node->from_table = std::move(from_join);
+	} else {
+		final_select_node->from_table = std::move(walks_ref);
+	}
+	//! END
+
+	// The rowids of the walk replace the joins between the vertex and edge tables
+	for (idx_t i = 0; i < bound_count; i++) {
+		vector<unique_ptr<ParsedExpression>> extract_children;
+		extract_children.push_back(make_uniq<ColumnRefExpression>("walk", "__walks"));
+		extract_children.push_back(make_uniq<ConstantExpression>(Value::BIGINT(static_cast<int64_t>(i + 1))));
+		conditions.push_back(make_uniq<ComparisonExpression>(
+		    ExpressionType::COMPARE_EQUAL, make_uniq<ColumnRefExpression>("rowid", elements[i]->variable_binding),
+		    make_uniq<FunctionExpression>("list_extract", std::move(extract_children))));
+	}
+}
+
+bool PGQMatchFunction::AddCycleJoin(ClientContext &context, vector<unique_ptr<PathReference>> &path_list,
+                                    vector<unique_ptr<ParsedExpression>> &conditions,
+                                    unique_ptr<SelectNode> &final_select_node,
+                                    case_insensitive_map_t<shared_ptr<PropertyGraphTable>> &alias_map,
+                                    CreatePropertyGraphInfo &pg_table) {
+	// (v0)-[e0]->(v1)-[e1]->...-[e(k-1)]->(v0) has 2k + 1 elements, k >= 2
+	vector<PathElement *> elements;
+	shared_ptr<PropertyGraphTable> edge_table;
+	if (path_list.size() < 5 || !GetHopChain(path_list, pg_table, elements, edge_table)) {
+		return false;
+	}
+	// Every vertex and edge but the closing vertex is a new variable, otherwise the pattern has more than one cycle
+	if (!StringUtil::CIEquals(elements[0]->variable_binding, elements.back()->variable_binding) ||
+	    !HasDistinctBindings(elements, elements.size() - 1)) {
+		return false;
+	}
+	// The closing vertex is bound by v0
+	AddWalkJoin(context, path_list, elements, edge_table, "cycles", elements.size() - 1, conditions, final_select_node,
+	            alias_map, pg_table);
+	return true;
+}
+
+bool PGQMatchFunction::AddExpandJoin(ClientContext &context, vector<unique_ptr<PathReference>> &path_list,
+                                     vector<unique_ptr<ParsedExpression>> &conditions,
+                                     unique_ptr<SelectNode> &final_select_node,
+                                     case_insensitive_map_t<shared_ptr<PropertyGraphTable>> &alias_map,
+                                     CreatePropertyGraphInfo &pg_table) {
+	vector<PathElement *> elements;
+	shared_ptr<PropertyGraphTable> edge_table;
+	if (!GetHopChain(path_list, pg_table, elements, edge_table) ||
+	    !HasDistinctBindings(elements, elements.size())) {
+		return false;
+	}
+	// Building a CSR costs more than the joins it saves, only a cached one is expanded
+	auto duckpgq_state = GetDuckPGQState(context);
+	if (!duckpgq_state->GetCachedCSR(pg_table.property_graph_name, edge_table->main_label, true, "")) {
+		return false;
+	}
+	AddWalkJoin(context, path_list, elements, edge_table, "expand", elements.size(), conditions, final_select_node,
+	            alias_map, pg_table);
+	return true;
+}
+
 void PGQMatchFunction::PopulateGraphTableAliasMap(
     const CreatePropertyGraphInfo &pg_table, const unique_ptr<PathReference> &path_reference,
     case_insensitive_map_t<shared_ptr<PropertyGraphTable>> &alias_to_vertex_and_edge_tables) {
@@ -945,12 +1350,28 @@ void PGQMatchFunction::CheckColumnBinding(
 	}
 }
 
+//! Reads a BOOLEAN setting that is enabled by default
+static bool IsMatchSettingEnabled(ClientContext &context, const string &name) {
+	Value setting;
+	return !context.TryGetCurrentSetting(name, setting) || setting.IsNull() || setting.GetValue<bool>();
+}
+
 unique_ptr<TableRef> PGQMatchFunction::MatchBindReplace(ClientContext &context, TableFunctionBindInput &bind_input) {
 	auto duckpgq_state = GetDuckPGQState(context);
 
 	auto match_index = bind_input.inputs[0].GetValue<int32_t>();
 	auto *ref = dynamic_cast<MatchExpression *>(duckpgq_state->transform_expression[match_index].get());
 	auto *pg_table = duckpgq_state->GetPropertyGraph(ref->pg_name);
+	// The version of the property graphs was brought up to date by GetPropertyGraph
+	auto cache_key = to_string(duckpgq_state->registered_version) +
+	                 (IsMatchSettingEnabled(context, "duckpgq_cyclic_match") ? ".cyclic" : "") +
+	                 (IsMatchSettingEnabled(context, "duckpgq_csr_expand") ? ".expand" : "") + "." + ref->alias + "." +
+	                 ref->ToString();
+	auto cached_rewrite = duckpgq_state->GetCachedMatchRewrite(context, cache_key);
+	if (cached_rewrite) {
+		return cached_rewrite;
+	}
+	duckpgq_state->BeginMatchRewrite();
 
 	vector<unique_ptr<ParsedExpression>> conditions;
 
@@ -958,11 +1379,18 @@ unique_ptr<TableRef> PGQMatchFunction::MatchBindReplace(ClientContext &context,
 	case_insensitive_map_t<shared_ptr<PropertyGraphTable>> alias_map;
 
 	int32_t extra_alias_counter = 0;
-	for (idx_t idx_i = 0; idx_i < ref->path_patterns.size(); idx_i++) {
+	auto walk_join = ref->path_patterns.size() == 1 &&
+	                 ((IsMatchSettingEnabled(context, "duckpgq_cyclic_match") &&
+	                   AddCycleJoin(context, ref->path_patterns[0]->path_elements, conditions, final_select_node,
+	                                alias_map, *pg_table)) ||
+	                  (IsMatchSettingEnabled(context, "duckpgq_csr_expand") &&
+	                   AddExpandJoin(context, ref->path_patterns[0]->path_elements, conditions, final_select_node,
+	                                 alias_map, *pg_table)));
+	for (idx_t idx_i = 0; !walk_join && idx_i < ref->path_patterns.size(); idx_i++) {
 		auto &path_pattern = ref->path_patterns[idx_i];
 		// Check if the element is PathElement or a Subpath with potentially many
 		// items
-		ProcessPathList(path_pattern->path_elements, conditions, final_select_node, alias_map, *pg_table,
+		ProcessPathList(context, path_pattern->path_elements, conditions, final_select_node, alias_map, *pg_table,
 		                extra_alias_counter, *ref);
 	}
 
@@ -1070,6 +1498,7 @@ unique_ptr<TableRef> PGQMatchFunction::MatchBindReplace(ClientContext &context,
 	auto subquery = make_uniq<SelectStatement>();
 	subquery->node = std::move(final_select_node);
 	auto result = make_uniq<SubqueryRef>(std::move(subquery), ref->alias);
+	duckpgq_state->CacheMatchRewrite(context, cache_key, *result);
 	return std::move(result);
 }
 
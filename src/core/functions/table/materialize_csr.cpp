@@ -0,0 +1,82 @@
+#include "duckpgq/core/functions/table/materialize_csr.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+
+#include <duckpgq/core/functions/table.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+//! The edge table labeled [edge_label] in [pg_name]
+static shared_ptr<PropertyGraphTable> GetCSREdgeTable(ClientContext &context, const string &pg_name,
+                                                      const string &edge_label) {
+	auto pg_info = GetPropertyGraphInfo(GetDuckPGQState(context), pg_name);
+	auto edge_pg_entry = pg_info->GetTableByLabel(edge_label, true, false);
+	if (edge_pg_entry->is_vertex_table) {
+		throw Exception(ExceptionType::INVALID, edge_label + " is a vertex table, expected an edge table");
+	}
+	return edge_pg_entry;
+}
+
+// SELECT sum(csr_cte.temp)::BIGINT AS edge_count FROM csr_cte
+static unique_ptr<TableRef> CreateEdgeCountSubquery(unique_ptr<SelectNode> select_node) {
+	// The rows of the undirected CSR count for both directions of their edge
+	vector<unique_ptr<ParsedExpression>> sum_children;
+	sum_children.push_back(make_uniq<ColumnRefExpression>("temp", "csr_cte"));
+	auto edge_count = make_uniq<CastExpression>(LogicalType::BIGINT,
+	                                            make_uniq<FunctionExpression>("sum", std::move(sum_children)));
+	edge_count->alias = "edge_count";
+	select_node->select_list.push_back(std::move(edge_count));
+	select_node->from_table = CreateBaseTableRef("csr_cte");
+
+	auto subquery = make_uniq<SelectStatement>();
+	subquery->node = std::move(select_node);
+	return make_uniq<SubqueryRef>(std::move(subquery));
+}
+
+unique_ptr<TableRef> MaterializeCSRFunction::MaterializeCSRBindReplace(ClientContext &context,
+                                                                       TableFunctionBindInput &input) {
+	auto pg_name = StringUtil::Lower(StringValue::Get(input.inputs[0]));
+	auto edge_label = StringUtil::Lower(StringValue::Get(input.inputs[1]));
+	auto directed = BooleanValue::Get(input.inputs[2]);
+	auto edge_pg_entry = GetCSREdgeTable(context, pg_name, edge_label);
+
+	auto select_node = make_uniq<SelectNode>();
+	if (directed) {
+		select_node->cte_map.map["csr_cte"] = CreateDirectedCSRCTE(edge_pg_entry, "src", "edge", "dst");
+	} else {
+		select_node->cte_map.map["csr_cte"] = CreateUndirectedCSRCTE(edge_pg_entry, select_node);
+	}
+	GetDuckPGQState(context)->PinCSR(context, pg_name, edge_pg_entry->main_label, directed, "", 0);
+	return CreateEdgeCountSubquery(std::move(select_node));
+}
+
+// The edge_count is 0 if the CSR was cached already
+unique_ptr<TableRef> PrebuildCSRFunction::PrebuildCSRBindReplace(ClientContext &context,
+                                                                 TableFunctionBindInput &input) {
+	auto pg_name = StringUtil::Lower(StringValue::Get(input.inputs[0]));
+	auto edge_label = StringUtil::Lower(StringValue::Get(input.inputs[1]));
+	auto directed = BooleanValue::Get(input.inputs[2]);
+	auto edge_pg_entry = GetCSREdgeTable(context, pg_name, edge_label);
+
+	auto select_node = make_uniq<SelectNode>();
+	if (directed) {
+		select_node->cte_map.map["csr_cte"] =
+		    CreateDirectedCSRCTE(context, pg_name, edge_pg_entry, "src", "edge", "dst");
+	} else {
+		select_node->cte_map.map["csr_cte"] = CreateUndirectedCSRCTE(context, pg_name, edge_pg_entry, select_node);
+	}
+	// Published to the store at the end of the query, the connection keeps no reference to it
+	GetDuckPGQState(context)->csr_to_delete.insert(0);
+	return CreateEdgeCountSubquery(std::move(select_node));
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterMaterializeCSRTableFunction(ExtensionLoader &loader) {
+	loader.RegisterFunction(MaterializeCSRFunction());
+	loader.RegisterFunction(PrebuildCSRFunction());
+}
+
+} // namespace duckdb
@@ -2,6 +2,7 @@
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/parser/tableref/subqueryref.hpp"
 
+#include <duckpgq/core/functions/function_data/pagerank_function_data.hpp>
 #include <duckpgq/core/functions/table.hpp>
 #include <duckpgq/core/utils/duckpgq_utils.hpp>
 #include "duckdb/parser/tableref/basetableref.hpp"
@@ -18,9 +19,30 @@ unique_ptr<TableRef> PageRankFunction::PageRankBindReplace(ClientContext &contex
 	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
 	auto edge_pg_entry = ValidateSourceNodeAndEdgeTable(pg_info, node_table, edge_table);
 
-	auto select_node = CreateSelectNode(edge_pg_entry, "pagerank", "pagerank");
-
-	select_node->cte_map.map["csr_cte"] = CreateDirectedCSRCTE(edge_pg_entry, "src", "edge", "dst");
+	auto damping_factor = PageRankFunctionData::DEFAULT_DAMPING_FACTOR;
+	auto convergence_threshold = PageRankFunctionData::DEFAULT_CONVERGENCE_THRESHOLD;
+	auto max_iterations = PageRankFunctionData::DEFAULT_MAX_ITERATIONS;
+	string warm_start_key;
+	for (auto &parameter : input.named_parameters) {
+		if (parameter.second.IsNull()) {
+			continue;
+		}
+		if (parameter.first == "damping") {
+			damping_factor = parameter.second.GetValue<double>();
+		} else if (parameter.first == "tolerance") {
+			convergence_threshold = parameter.second.GetValue<double>();
+		} else if (parameter.first == "max_iterations") {
+			max_iterations = parameter.second.GetValue<int64_t>();
+		} else if (parameter.first == "warm_start" && parameter.second.GetValue<bool>()) {
+			warm_start_key = DuckPGQState::GetCSRCacheKey(pg_name, edge_pg_entry->main_label, true, "");
+		}
+	}
+
+	auto select_node = CreateSelectNode(edge_pg_entry, "pagerank", "pagerank",
+	                                    {Value::DOUBLE(damping_factor), Value::DOUBLE(convergence_threshold),
+	                                     Value::BIGINT(max_iterations), Value(warm_start_key)});
+
+	select_node->cte_map.map["csr_cte"] = CreateDirectedCSRCTE(context, pg_name, edge_pg_entry, "src", "edge", "dst");
 
 	auto subquery = make_uniq<SelectStatement>();
 	subquery->node = std::move(select_node);
@@ -0,0 +1,126 @@
+#include "duckpgq/core/functions/table/personalized_pagerank.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/parser/expression/comparison_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+
+#include <duckpgq/core/functions/function_data/pagerank_function_data.hpp>
+#include <duckpgq/core/functions/table.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+static unique_ptr<ParsedExpression> ExtractField(const string &field) {
+	vector<unique_ptr<ParsedExpression>> children;
+	children.push_back(make_uniq<ColumnRefExpression>("ppr", "__p"));
+	children.push_back(make_uniq<ConstantExpression>(Value(field)));
+	return make_uniq<FunctionExpression>("struct_extract", std::move(children));
+}
+
+// WITH csr_cte AS (...)
+// SELECT __p.seed, __t.<key>, struct_extract(__p.ppr, 'score') AS personalized_pagerank
+// FROM (SELECT __s.<key> AS seed,
+//              unnest(personalized_pagerank(0, __x.temp + __s.rowid, k, damping, tolerance)) AS ppr
+//       FROM <vertex table> __s, (SELECT count(csr_cte.temp) * 0 AS temp FROM csr_cte) __x
+//       WHERE list_contains(<seeds>, __s.<key>)) __p
+// JOIN <vertex table> __t ON __t.rowid = struct_extract(__p.ppr, 'vertex')
+unique_ptr<TableRef> PersonalizedPageRankFunction::PersonalizedPageRankBindReplace(ClientContext &context,
+                                                                                   TableFunctionBindInput &input) {
+	auto pg_name = StringUtil::Lower(StringValue::Get(input.inputs[0]));
+	auto node_table = StringUtil::Lower(StringValue::Get(input.inputs[1]));
+	auto edge_table = StringUtil::Lower(StringValue::Get(input.inputs[2]));
+	auto seeds = input.inputs[3];
+	if (seeds.type().id() != LogicalTypeId::LIST) {
+		seeds = Value::LIST({seeds});
+	}
+	auto top_k = input.inputs[4].GetValue<int64_t>();
+
+	auto damping_factor = PageRankFunctionData::DEFAULT_DAMPING_FACTOR;
+	auto convergence_threshold = PageRankFunctionData::DEFAULT_CONVERGENCE_THRESHOLD;
+	for (auto &parameter : input.named_parameters) {
+		if (parameter.second.IsNull()) {
+			continue;
+		}
+		if (parameter.first == "damping") {
+			damping_factor = parameter.second.GetValue<double>();
+		} else if (parameter.first == "tolerance") {
+			convergence_threshold = parameter.second.GetValue<double>();
+		}
+	}
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
+	auto edge_pg_entry = ValidateSourceNodeAndEdgeTable(pg_info, node_table, edge_table);
+	auto &vertex_key = edge_pg_entry->source_pk[0];
+
+	// One row per seed, with the list of its top k vertices
+	auto seed_select_node = make_uniq<SelectNode>();
+	auto seed_column = make_uniq<ColumnRefExpression>(vertex_key, "__s");
+	seed_column->alias = "seed";
+	seed_select_node->select_list.push_back(std::move(seed_column));
+
+	vector<unique_ptr<ParsedExpression>> seed_children;
+	seed_children.push_back(make_uniq<ColumnRefExpression>("temp", "__x"));
+	seed_children.push_back(make_uniq<ColumnRefExpression>("rowid", "__s"));
+	vector<unique_ptr<ParsedExpression>> function_children;
+	function_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
+	function_children.push_back(make_uniq<FunctionExpression>("add", std::move(seed_children)));
+	function_children.push_back(make_uniq<ConstantExpression>(Value::BIGINT(top_k)));
+	function_children.push_back(make_uniq<ConstantExpression>(Value::DOUBLE(damping_factor)));
+	function_children.push_back(make_uniq<ConstantExpression>(Value::DOUBLE(convergence_threshold)));
+	vector<unique_ptr<ParsedExpression>> unnest_children;
+	unnest_children.push_back(make_uniq<FunctionExpression>("personalized_pagerank", std::move(function_children)));
+	auto unnest_function = make_uniq<FunctionExpression>("unnest", std::move(unnest_children));
+	unnest_function->alias = "ppr";
+	seed_select_node->select_list.push_back(std::move(unnest_function));
+
+	auto cross_join_ref = make_uniq<JoinRef>(JoinRefType::CROSS);
+	cross_join_ref->left = edge_pg_entry->source_pg_table->CreateBaseTableRef("__s");
+	cross_join_ref->right = CreateCountCTESubquery();
+	seed_select_node->from_table = std::move(cross_join_ref);
+
+	vector<unique_ptr<ParsedExpression>> contains_children;
+	contains_children.push_back(make_uniq<ConstantExpression>(seeds));
+	contains_children.push_back(make_uniq<ColumnRefExpression>(vertex_key, "__s"));
+	seed_select_node->where_clause = make_uniq<FunctionExpression>("list_contains", std::move(contains_children));
+
+	auto seed_subquery = make_uniq<SelectStatement>();
+	seed_subquery->node = std::move(seed_select_node);
+
+	// One row per seed and vertex, keyed like the vertex table
+	auto select_node = make_uniq<SelectNode>();
+	select_node->select_list.push_back(make_uniq<ColumnRefExpression>("seed", "__p"));
+	select_node->select_list.push_back(make_uniq<ColumnRefExpression>(vertex_key, "__t"));
+	auto score = ExtractField("score");
+	score->alias = "personalized_pagerank";
+	select_node->select_list.push_back(std::move(score));
+
+	auto join_ref = make_uniq<JoinRef>(JoinRefType::REGULAR);
+	join_ref->type = JoinType::INNER;
+	join_ref->left = make_uniq<SubqueryRef>(std::move(seed_subquery), "__p");
+	join_ref->right = edge_pg_entry->source_pg_table->CreateBaseTableRef("__t");
+	join_ref->condition = make_uniq<ComparisonExpression>(
+	    ExpressionType::COMPARE_EQUAL, make_uniq<ColumnRefExpression>("rowid", "__t"), ExtractField("vertex"));
+	select_node->from_table = std::move(join_ref);
+
+	select_node->cte_map.map["csr_cte"] = CreateDirectedCSRCTE(context, pg_name, edge_pg_entry, "src", "edge", "dst");
+
+	auto subquery = make_uniq<SelectStatement>();
+	subquery->node = std::move(select_node);
+
+	auto result = make_uniq<SubqueryRef>(std::move(subquery));
+	result->alias = "personalized_pagerank";
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterPersonalizedPageRankTableFunction(ExtensionLoader &loader) {
+	loader.RegisterFunction(PersonalizedPageRankFunction());
+}
+
+} // namespace duckdb
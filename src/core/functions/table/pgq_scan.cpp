@@ -1,44 +1,47 @@
 #include "duckpgq/core/functions/table/pgq_scan.hpp"
 #include "duckdb/common/types.hpp"
+#include "duckdb/execution/partition_info.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/parser/parsed_data/create_property_graph_info.hpp"
 #include "duckdb/parser/parsed_data/create_table_function_info.hpp"
 #include "duckdb/parser/property_graph_table.hpp"
 #include "duckpgq/core/utils/compressed_sparse_row.hpp"
+#include "duckpgq/core/utils/csr_arrow_export.hpp"
 #include "duckpgq/core/utils/duckpgq_utils.hpp"
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <duckpgq/core/functions/table.hpp>
 #include <duckpgq_extension.hpp>
 
 namespace duckdb {
 
-static void ScanCSREFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
-	auto state = &data_p.global_state->Cast<CSRScanState>();
+//! Reports the vector a thread returned last as the batch index, which keeps the parallel scan in array order
+static OperatorPartitionData CSRArrayScanPartitionData(ClientContext &context, TableFunctionGetPartitionInput &input) {
+	if (input.partition_info.RequiresPartitionColumns()) {
+		throw InternalException("CSRArrayScanPartitionData: partition columns are not supported");
+	}
+	return OperatorPartitionData(input.local_state->Cast<CSRArrayScanLocalState>().batch_index);
+}
 
-	if (state->finished) {
+static void ScanCSREFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &gstate = data_p.global_state->Cast<CSRArrayScanState>();
+	auto &lstate = data_p.local_state->Cast<CSRArrayScanLocalState>();
+	idx_t offset;
+	idx_t count;
+	if (!gstate.Next(lstate.batch_index, offset, count)) {
 		output.SetCardinality(0);
 		return;
 	}
-
-	auto duckpgq_state = GetDuckPGQState(context);
-	auto csr_id = data_p.bind_data->Cast<CSRScanEData>().csr_id;
-	CSR *csr = duckpgq_state->GetCSR(csr_id);
-
-	idx_t vector_size = state->csr_e_offset + DEFAULT_STANDARD_VECTOR_SIZE <= csr->e.size()
-	                        ? DEFAULT_STANDARD_VECTOR_SIZE
-	                        : csr->e.size() - state->csr_e_offset;
-
-	output.SetCardinality(vector_size);
-	output.data[0].SetVectorType(VectorType::FLAT_VECTOR);
-	for (idx_t idx_i = 0; idx_i < vector_size; idx_i++) {
-		output.data[0].SetValue(idx_i, Value(csr->e[state->csr_e_offset + idx_i]));
-	}
-
-	if (state->csr_e_offset + vector_size >= csr->e.size()) {
-		state->finished = true;
+	auto &csr = gstate.csr;
+	auto result_data = FlatVector::GetData<int64_t>(output.data[0]);
+	if (csr.compact) {
+		auto neighbors = csr.e_compact.data() + offset;
+		std::copy(neighbors, neighbors + count, result_data);
 	} else {
-		state->csr_e_offset += vector_size;
+		memcpy(result_data, csr.e.data() + offset, count * sizeof(int64_t));
 	}
+	output.SetCardinality(count);
 }
 
 static void ScanCSRPtrFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
@@ -53,6 +56,11 @@ static void ScanCSRPtrFunction(ClientContext &context, TableFunctionInput &data_
 	auto duckpgq_state = GetDuckPGQState(context);
 	auto csr_id = data_p.bind_data->Cast<CSRScanPtrData>().csr_id;
 	CSR *csr = duckpgq_state->GetCSR(csr_id);
+	csr->LoadPartitions(context);
+	if (csr->compact) {
+		throw InvalidInputException("The edge array of a compact CSR cannot be exposed as a pointer, disable "
+		                            "duckpgq_compact_csr to use get_csr_ptr");
+	}
 	output.SetCardinality(5);
 	output.data[0].SetVectorType(VectorType::FLAT_VECTOR);
 	auto result_data = FlatVector::GetData<uint64_t>(output.data[0]);
@@ -81,75 +89,87 @@ static void ScanCSRPtrFunction(ClientContext &context, TableFunctionInput &data_
 	result_data[3] = static_cast<uint64_t>(csr->vsize);
 }
 
-static void ScanCSRVFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
-	auto state = &data_p.global_state->Cast<CSRScanState>();
-
-	if (state->finished) {
+//! One row per array of the CSR with its length. With an array name, only that array is exported into the structs
+//! at the addresses the consumer passed, which then own it.
+static void ScanCSRArrowFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &gstate = data_p.global_state->Cast<CSRScanState>();
+	if (gstate.finished) {
 		output.SetCardinality(0);
 		return;
 	}
+	gstate.finished = true;
 
+	auto &bind_data = data_p.bind_data->Cast<CSRScanArrowData>();
 	auto duckpgq_state = GetDuckPGQState(context);
-	auto csr_id = data_p.bind_data->Cast<CSRScanVData>().csr_id;
-	CSR *csr = duckpgq_state->GetCSR(csr_id);
-
-	idx_t vector_size = state->csr_v_offset + DEFAULT_STANDARD_VECTOR_SIZE <= csr->vsize
-	                        ? DEFAULT_STANDARD_VECTOR_SIZE
-	                        : csr->vsize - state->csr_v_offset;
-
-	output.SetCardinality(vector_size);
-	output.data[0].SetVectorType(VectorType::FLAT_VECTOR);
-	for (idx_t idx_i = 0; idx_i < vector_size; idx_i++) {
-		output.data[0].SetValue(idx_i, Value(csr->v[state->csr_v_offset + idx_i]));
-	}
-
-	if (state->csr_v_offset + vector_size >= csr->vsize) {
-		state->finished = true;
+	shared_ptr<CSR> csr;
+	if (bind_data.pg_name.empty()) {
+		auto csr_entry = duckpgq_state->csr_list.find(bind_data.csr_id);
+		if (csr_entry == duckpgq_state->csr_list.end()) {
+			throw ConstraintException("CSR not found with ID %d", bind_data.csr_id);
+		}
+		csr = csr_entry->second;
 	} else {
-		state->csr_v_offset += vector_size;
+		csr = duckpgq_state->GetCachedCSR(bind_data.pg_name, bind_data.edge_label, bind_data.directed, "");
+		if (!csr) {
+			throw InvalidInputException("No CSR of %s in property graph %s is cached, use PRAGMA materialize_csr to "
+			                            "build it",
+			                            bind_data.edge_label, bind_data.pg_name);
+		}
 	}
+	auto arrays = GetCSRArrowArrays(context, csr);
+	if (bind_data.array_name.empty()) {
+		output.SetCardinality(arrays.size());
+		for (idx_t row = 0; row < arrays.size(); row++) {
+			output.data[0].SetValue(row, Value(arrays[row].name));
+			output.data[1].SetValue(row, Value::BIGINT(static_cast<int64_t>(arrays[row].length)));
+		}
+		return;
+	}
+	for (auto &array : arrays) {
+		if (array.name != bind_data.array_name) {
+			continue;
+		}
+		ExportCSRArrowArray(csr, array, reinterpret_cast<ArrowArray *>(bind_data.array_address),
+		                    reinterpret_cast<ArrowSchema *>(bind_data.schema_address));
+		output.SetCardinality(1);
+		output.data[0].SetValue(0, Value(array.name));
+		output.data[1].SetValue(0, Value::BIGINT(static_cast<int64_t>(array.length)));
+		return;
+	}
+	throw InvalidInputException("The CSR has no array %s", bind_data.array_name);
 }
 
-static void ScanCSRWFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
-	auto state = &data_p.global_state->Cast<CSRScanState>();
-
-	if (state->finished) {
+static void ScanCSRVFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &gstate = data_p.global_state->Cast<CSRArrayScanState>();
+	auto &lstate = data_p.local_state->Cast<CSRArrayScanLocalState>();
+	idx_t offset;
+	idx_t count;
+	if (!gstate.Next(lstate.batch_index, offset, count)) {
 		output.SetCardinality(0);
 		return;
 	}
+	// The offsets are read as plain int64 values, as CSR::GetRanges does
+	auto offsets = reinterpret_cast<const int64_t *>(gstate.csr.v.get());
+	memcpy(FlatVector::GetData<int64_t>(output.data[0]), offsets + offset, count * sizeof(int64_t));
+	output.SetCardinality(count);
+}
 
-	auto duckpgq_state = GetDuckPGQState(context);
-	auto csr_scanw_data = data_p.bind_data->Cast<CSRScanWData>();
-	auto csr_id = csr_scanw_data.csr_id;
-	CSR *csr = duckpgq_state->GetCSR(csr_id);
-
-	size_t w_size = 0;
-	if (csr_scanw_data.is_double) {
-		w_size = csr->w_double.size();
-	} else {
-		w_size = csr->w.size();
-	}
-
-	idx_t vector_size = state->csr_w_offset + DEFAULT_STANDARD_VECTOR_SIZE <= w_size ? DEFAULT_STANDARD_VECTOR_SIZE
-	                                                                                 : w_size - state->csr_w_offset;
-
-	output.SetCardinality(vector_size);
-	output.data[0].SetVectorType(VectorType::FLAT_VECTOR);
-	if (csr_scanw_data.is_double) {
-		for (idx_t idx_i = 0; idx_i < vector_size; idx_i++) {
-			output.data[0].SetValue(idx_i, Value(csr->w_double[state->csr_w_offset + idx_i]));
-		}
-	} else {
-		for (idx_t idx_i = 0; idx_i < vector_size; idx_i++) {
-			output.data[0].SetValue(idx_i, Value(csr->w[state->csr_w_offset + idx_i]));
-		}
+static void ScanCSRWFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &gstate = data_p.global_state->Cast<CSRArrayScanState>();
+	auto &lstate = data_p.local_state->Cast<CSRArrayScanLocalState>();
+	idx_t offset;
+	idx_t count;
+	if (!gstate.Next(lstate.batch_index, offset, count)) {
+		output.SetCardinality(0);
+		return;
 	}
-
-	if (state->csr_w_offset + vector_size >= w_size) {
-		state->finished = true;
+	auto &csr = gstate.csr;
+	if (data_p.bind_data->Cast<CSRScanWData>().is_double) {
+		memcpy(FlatVector::GetData<double>(output.data[0]), csr.w_double.data() + offset, count * sizeof(double));
 	} else {
-		state->csr_w_offset += vector_size;
+		memcpy(FlatVector::GetData<int64_t>(output.data[0]), csr.w.data() + offset, count * sizeof(int64_t));
 	}
+	output.SetCardinality(count);
 }
 
 static void ScanPGVTableFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
@@ -269,14 +289,20 @@ static void ScanPGEColFunction(ClientContext &context, TableFunctionInput &data_
 // Register functions
 //------------------------------------------------------------------------------
 void CoreTableFunctions::RegisterScanTableFunctions(ExtensionLoader &loader) {
-	loader.RegisterFunction(TableFunction("get_csr_e", {LogicalType::INTEGER}, ScanCSREFunction,
-	                                      CSRScanEData::ScanCSREBind, CSRScanState::Init));
+	TableFunction csr_e("get_csr_e", {LogicalType::INTEGER}, ScanCSREFunction, CSRScanEData::ScanCSREBind,
+	                    CSRArrayScanState::InitE, CSRArrayScanLocalState::Init);
+	csr_e.get_partition_data = CSRArrayScanPartitionData;
+	loader.RegisterFunction(csr_e);
 
-	loader.RegisterFunction(TableFunction("get_csr_v", {LogicalType::INTEGER}, ScanCSRVFunction,
-	                                      CSRScanVData::ScanCSRVBind, CSRScanState::Init));
+	TableFunction csr_v("get_csr_v", {LogicalType::INTEGER}, ScanCSRVFunction, CSRScanVData::ScanCSRVBind,
+	                    CSRArrayScanState::InitV, CSRArrayScanLocalState::Init);
+	csr_v.get_partition_data = CSRArrayScanPartitionData;
+	loader.RegisterFunction(csr_v);
 
-	loader.RegisterFunction(TableFunction("get_csr_w", {LogicalType::INTEGER}, ScanCSRWFunction,
-	                                      CSRScanWData::ScanCSRWBind, CSRScanState::Init));
+	TableFunction csr_w("get_csr_w", {LogicalType::INTEGER}, ScanCSRWFunction, CSRScanWData::ScanCSRWBind,
+	                    CSRArrayScanState::InitW, CSRArrayScanLocalState::Init);
+	csr_w.get_partition_data = CSRArrayScanPartitionData;
+	loader.RegisterFunction(csr_w);
 
 	loader.RegisterFunction(TableFunction("get_pg_vtablenames", {LogicalType::VARCHAR}, ScanPGVTableFunction,
 	                                      PGScanVTableData::ScanPGVTableBind, CSRScanState::Init));
@@ -287,6 +313,21 @@ void CoreTableFunctions::RegisterScanTableFunctions(ExtensionLoader &loader) {
 	loader.RegisterFunction(TableFunction("get_csr_ptr", {LogicalType::INTEGER}, ScanCSRPtrFunction,
 	                                      CSRScanPtrData::ScanCSRPtrBind, CSRScanState::Init));
 
+	TableFunctionSet csr_arrow_set("get_csr_arrow");
+	vector<vector<LogicalType>> csr_arguments {{LogicalType::INTEGER},
+	                                           {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BOOLEAN}};
+	for (auto &arguments : csr_arguments) {
+		csr_arrow_set.AddFunction(TableFunction(arguments, ScanCSRArrowFunction, CSRScanArrowData::ScanCSRArrowBind,
+		                                        CSRScanState::Init));
+		// the array name and the addresses of the ArrowArray and the ArrowSchema to export it into
+		arguments.push_back(LogicalType::VARCHAR);
+		arguments.push_back(LogicalType::UBIGINT);
+		arguments.push_back(LogicalType::UBIGINT);
+		csr_arrow_set.AddFunction(TableFunction(arguments, ScanCSRArrowFunction, CSRScanArrowData::ScanCSRArrowBind,
+		                                        CSRScanState::Init));
+	}
+	loader.RegisterFunction(csr_arrow_set);
+
 	loader.RegisterFunction(TableFunction("get_pg_etablenames", {LogicalType::VARCHAR}, ScanPGETableFunction,
 	                                      PGScanETableData::ScanPGETableBind, CSRScanState::Init));
 
@@ -0,0 +1,91 @@
+#include "duckpgq/core/functions/table/random_walks.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+
+#include <duckpgq/core/functions/table.hpp>
+#include <duckpgq/core/utils/compressed_sparse_row.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+// WITH csr_cte AS (<undirected CSR>)
+// SELECT __s.<key>, unnest(random_walks(0, __x.temp + __s.rowid, walk_length, walks_per_node, p, q, seed)) AS walk
+// FROM <vertex table> __s, (SELECT count(csr_cte.temp) * 0 AS temp FROM csr_cte) __x
+unique_ptr<TableRef> RandomWalksFunction::RandomWalksBindReplace(ClientContext &context,
+                                                                 TableFunctionBindInput &input) {
+	auto pg_name = StringUtil::Lower(StringValue::Get(input.inputs[0]));
+	auto node_table = StringUtil::Lower(StringValue::Get(input.inputs[1]));
+	auto edge_table = StringUtil::Lower(StringValue::Get(input.inputs[2]));
+	auto walk_length = input.inputs[3].GetValue<int64_t>();
+	auto walks_per_node = input.inputs[4].GetValue<int64_t>();
+	double p = 1;
+	double q = 1;
+	if (input.inputs.size() > 6) {
+		p = input.inputs[5].GetValue<double>();
+		q = input.inputs[6].GetValue<double>();
+	}
+	int64_t seed = 0;
+	for (auto &parameter : input.named_parameters) {
+		if (!parameter.second.IsNull() && parameter.first == "seed") {
+			seed = parameter.second.GetValue<int64_t>();
+		}
+	}
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
+	auto edge_pg_entry = ValidateSourceNodeAndEdgeTable(pg_info, node_table, edge_table);
+
+	auto select_node = make_uniq<SelectNode>();
+	select_node->select_list.push_back(make_uniq<ColumnRefExpression>(edge_pg_entry->source_pk[0], "__s"));
+
+	vector<unique_ptr<ParsedExpression>> source_children;
+	source_children.push_back(make_uniq<ColumnRefExpression>("temp", "__x"));
+	source_children.push_back(make_uniq<ColumnRefExpression>("rowid", "__s"));
+	vector<unique_ptr<ParsedExpression>> function_children;
+	function_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
+	function_children.push_back(make_uniq<FunctionExpression>("add", std::move(source_children)));
+	function_children.push_back(make_uniq<ConstantExpression>(Value::BIGINT(walk_length)));
+	function_children.push_back(make_uniq<ConstantExpression>(Value::BIGINT(walks_per_node)));
+	function_children.push_back(make_uniq<ConstantExpression>(Value::DOUBLE(p)));
+	function_children.push_back(make_uniq<ConstantExpression>(Value::DOUBLE(q)));
+	function_children.push_back(make_uniq<ConstantExpression>(Value::BIGINT(seed)));
+	vector<unique_ptr<ParsedExpression>> unnest_children;
+	unnest_children.push_back(make_uniq<FunctionExpression>("random_walks", std::move(function_children)));
+	auto unnest_function = make_uniq<FunctionExpression>("unnest", std::move(unnest_children));
+	unnest_function->alias = "walk";
+	select_node->select_list.push_back(std::move(unnest_function));
+
+	auto cross_join_ref = make_uniq<JoinRef>(JoinRefType::CROSS);
+	cross_join_ref->left = edge_pg_entry->source_pg_table->CreateBaseTableRef("__s");
+	cross_join_ref->right = CreateCountCTESubquery();
+	select_node->from_table = std::move(cross_join_ref);
+
+	select_node->cte_map.map["csr_cte"] = CreateUndirectedCSRCTE(context, pg_name, edge_pg_entry, select_node);
+
+	auto subquery = make_uniq<SelectStatement>();
+	subquery->node = std::move(select_node);
+
+	auto result = make_uniq<SubqueryRef>(std::move(subquery));
+	result->alias = "random_walks";
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterRandomWalksTableFunction(ExtensionLoader &loader) {
+	TableFunctionSet set("random_walks");
+	RandomWalksFunction function;
+	set.AddFunction(function);
+	// node2vec return and in-out parameters p and q
+	function.arguments.push_back(LogicalType::DOUBLE);
+	function.arguments.push_back(LogicalType::DOUBLE);
+	set.AddFunction(function);
+	loader.RegisterFunction(set);
+}
+
+} // namespace duckdb
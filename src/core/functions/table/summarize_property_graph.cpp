@@ -8,9 +8,11 @@
 #include "duckdb/parser/group_by_node.hpp"
 #include "duckdb/parser/query_node/select_node.hpp"
 #include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/tableref/emptytableref.hpp"
 #include "duckdb/parser/tableref/showref.hpp"
 #include "duckdb/parser/tableref/subqueryref.hpp"
 #include <duckpgq/core/functions/table.hpp>
+#include <duckpgq/core/utils/csr_degree_summary.hpp>
 #include <duckpgq/core/utils/duckpgq_utils.hpp>
 
 namespace duckdb {
@@ -258,6 +260,87 @@ SummarizePropertyGraphFunction::CreateEdgeTableCTE(shared_ptr<PropertyGraphTable
 	return cte_info;
 }
 
+static unique_ptr<ParsedExpression> GetConstantExpression(const Value &value, const string &alias) {
+	auto result = make_uniq<ConstantExpression>(value);
+	result->alias = alias;
+	return std::move(result);
+}
+
+//! (SELECT count(*) FROM <table>) - <unique_count>, the vertices of the table without an edge
+static unique_ptr<ParsedExpression> GetIsolatedCount(const string &catalog, const string &schema, const string &table,
+                                                     idx_t unique_count, const string &alias) {
+	auto select_node = make_uniq<SelectNode>();
+	vector<unique_ptr<ParsedExpression>> count_children;
+	select_node->select_list.push_back(make_uniq<FunctionExpression>("count_star", std::move(count_children)));
+	select_node->from_table = make_uniq<BaseTableRef>(TableDescription(catalog, schema, table));
+	auto select_statement = make_uniq<SelectStatement>();
+	select_statement->node = std::move(select_node);
+	auto count_subquery = make_uniq<SubqueryExpression>();
+	count_subquery->subquery_type = SubqueryType::SCALAR;
+	count_subquery->subquery = std::move(select_statement);
+	vector<unique_ptr<ParsedExpression>> children;
+	children.push_back(std::move(count_subquery));
+	children.push_back(make_uniq<ConstantExpression>(Value::BIGINT(static_cast<int64_t>(unique_count))));
+	auto result = make_uniq<FunctionExpression>("-", std::move(children));
+	result->alias = alias;
+	return std::move(result);
+}
+
+//! The degree columns of [summary] with the suffix [direction], NULL if no vertex has an edge in that direction
+static void AddDegreeSummaryColumns(SelectNode &select_node, const CSRDegreeSummary &summary, const string &direction) {
+	auto empty = summary.vertex_count == 0;
+	auto degree_value = [&](idx_t degree) {
+		return empty ? Value(LogicalType::BIGINT) : Value::BIGINT(static_cast<int64_t>(degree));
+	};
+	select_node.select_list.push_back(GetConstantExpression(
+	    empty ? Value(LogicalType::DOUBLE) : Value::DOUBLE(summary.average), "avg_" + direction));
+	select_node.select_list.push_back(GetConstantExpression(degree_value(summary.min), "min_" + direction));
+	select_node.select_list.push_back(GetConstantExpression(degree_value(summary.max), "max_" + direction));
+	select_node.select_list.push_back(GetConstantExpression(degree_value(summary.q25), "q25_" + direction));
+	select_node.select_list.push_back(GetConstantExpression(degree_value(summary.q50), "q50_" + direction));
+	select_node.select_list.push_back(GetConstantExpression(degree_value(summary.q75), "q75_" + direction));
+}
+
+unique_ptr<CommonTableExpressionInfo>
+SummarizePropertyGraphFunction::CreateEdgeTableCSRCTE(ClientContext &context,
+                                                      const shared_ptr<PropertyGraphTable> &edge_table, CSR &csr) {
+	CSRDegreeSummary out_degrees;
+	CSRDegreeSummary in_degrees;
+	SummarizeCSRDegrees(context, csr,
+	                    edge_table->source_pg_table->table_name == edge_table->destination_pg_table->table_name,
+	                    out_degrees, in_degrees);
+
+	auto select_node = make_uniq<SelectNode>();
+	select_node->select_list.push_back(GetTableNameConstantExpression(edge_table->table_name, "table_name"));
+	select_node->select_list.push_back(IsVertexTableConstantExpression(false, "is_vertex_table"));
+	select_node->select_list.push_back(GetTableNameConstantExpression(edge_table->source_reference, "source_table"));
+	select_node->select_list.push_back(
+	    GetTableNameConstantExpression(edge_table->destination_reference, "destination_table"));
+	select_node->select_list.push_back(GetConstantNullExpressionWithAlias("vertex_count"));
+	select_node->select_list.push_back(
+	    GetConstantExpression(Value::BIGINT(static_cast<int64_t>(csr.EdgeCount())), "edge_count"));
+	select_node->select_list.push_back(
+	    GetConstantExpression(Value::BIGINT(static_cast<int64_t>(out_degrees.vertex_count)), "unique_source_count"));
+	select_node->select_list.push_back(GetConstantExpression(
+	    Value::BIGINT(static_cast<int64_t>(in_degrees.vertex_count)), "unique_destination_count"));
+	select_node->select_list.push_back(GetIsolatedCount(edge_table->source_catalog, edge_table->source_schema,
+	                                                    edge_table->source_reference, out_degrees.vertex_count,
+	                                                    "isolated_sources"));
+	select_node->select_list.push_back(GetIsolatedCount(edge_table->destination_catalog,
+	                                                    edge_table->destination_schema,
+	                                                    edge_table->destination_reference, in_degrees.vertex_count,
+	                                                    "isolated_destinations"));
+	AddDegreeSummaryColumns(*select_node, in_degrees, "in_degree");
+	AddDegreeSummaryColumns(*select_node, out_degrees, "out_degree");
+	select_node->from_table = make_uniq<EmptyTableRef>();
+
+	auto cte_info = make_uniq<CommonTableExpressionInfo>();
+	auto select_statement = make_uniq<SelectStatement>();
+	select_statement->node = std::move(select_node);
+	cte_info->query = std::move(select_statement);
+	return cte_info;
+}
+
 unique_ptr<TableRef>
 SummarizePropertyGraphFunction::HandleSingleVertexTable(const shared_ptr<PropertyGraphTable> &vertex_table,
                                                         const string &stat_table_alias) {
@@ -305,6 +388,12 @@ SummarizePropertyGraphFunction::SummarizePropertyGraphBindReplace(ClientContext
 
 	string property_graph = bind_input.inputs[0].GetValue<string>();
 	auto pg_info = duckpgq_state->GetPropertyGraph(property_graph);
+	auto use_csr = false;
+	for (auto &parameter : bind_input.named_parameters) {
+		if (parameter.first == "csr" && !parameter.second.IsNull()) {
+			use_csr = parameter.second.GetValue<bool>();
+		}
+	}
 
 	if (pg_info->vertex_tables.size() == 1 && pg_info->edge_tables.empty()) {
 		// Special case where we don't want to create a union across the different
@@ -326,7 +415,14 @@ SummarizePropertyGraphFunction::SummarizePropertyGraphBindReplace(ClientContext
 		string stat_table_alias = edge_table->source_reference + "_" + edge_table->table_name + "_" +
 		                          edge_table->destination_reference + "_stats";
 		auto inner_select_node = CreateInnerSelectStatNode(stat_table_alias);
-		inner_select_node->cte_map.map.insert(stat_table_alias, CreateEdgeTableCTE(edge_table));
+		shared_ptr<CSR> csr;
+		if (use_csr) {
+			// A cached CSR that went stale by a write is brought up to date first, or dropped
+			duckpgq_state->RefreshCachedCSR(context, property_graph, edge_table);
+			csr = duckpgq_state->FindCachedCSR(property_graph, edge_table->main_label, true, "");
+		}
+		inner_select_node->cte_map.map.insert(stat_table_alias, csr ? CreateEdgeTableCSRCTE(context, edge_table, *csr)
+		                                                            : CreateEdgeTableCTE(edge_table));
 		AddToUnionNode(final_union_node, inner_select_node);
 	}
 
@@ -0,0 +1,66 @@
+#include "duckpgq/core/functions/table/triangle_count.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+
+#include <duckpgq/core/functions/table.hpp>
+#include <duckpgq/core/utils/compressed_sparse_row.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+// WITH csr_cte AS (...)
+// SELECT <function_name>(0, __x.temp) AS <function_name>
+// FROM (SELECT count(csr_cte.temp) * 0 AS temp FROM csr_cte) __x
+static unique_ptr<TableRef> CreateGraphTriangleQuery(ClientContext &context, TableFunctionBindInput &input,
+                                                     const string &function_name) {
+	auto pg_name = StringUtil::Lower(StringValue::Get(input.inputs[0]));
+	auto node_label = StringUtil::Lower(StringValue::Get(input.inputs[1]));
+	auto edge_label = StringUtil::Lower(StringValue::Get(input.inputs[2]));
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
+	auto edge_pg_entry = ValidateSourceNodeAndEdgeTable(pg_info, node_label, edge_label);
+
+	auto select_node = make_uniq<SelectNode>();
+	vector<unique_ptr<ParsedExpression>> function_children;
+	function_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
+	function_children.push_back(make_uniq<ColumnRefExpression>("temp", "__x"));
+	auto function = make_uniq<FunctionExpression>(function_name, std::move(function_children));
+	function->alias = function_name;
+	select_node->select_list.push_back(std::move(function));
+	select_node->from_table = CreateCountCTESubquery();
+
+	select_node->cte_map.map["csr_cte"] = CreateUndirectedCSRCTE(context, pg_name, edge_pg_entry, select_node);
+
+	auto subquery = make_uniq<SelectStatement>();
+	subquery->node = std::move(select_node);
+
+	auto result = make_uniq<SubqueryRef>(std::move(subquery));
+	result->alias = function_name;
+	return std::move(result);
+}
+
+unique_ptr<TableRef> TriangleCountFunction::TriangleCountBindReplace(ClientContext &context,
+                                                                     TableFunctionBindInput &input) {
+	return CreateGraphTriangleQuery(context, input, "triangle_count");
+}
+
+unique_ptr<TableRef>
+GlobalClusteringCoefficientFunction::GlobalClusteringCoefficientBindReplace(ClientContext &context,
+                                                                            TableFunctionBindInput &input) {
+	return CreateGraphTriangleQuery(context, input, "global_clustering_coefficient");
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterTriangleCountTableFunctions(ExtensionLoader &loader) {
+	loader.RegisterFunction(TriangleCountFunction());
+	loader.RegisterFunction(GlobalClusteringCoefficientFunction());
+}
+
+} // namespace duckdb
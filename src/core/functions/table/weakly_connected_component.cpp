@@ -22,7 +22,7 @@ WeaklyConnectedComponentFunction::WeaklyConnectedComponentBindReplace(ClientCont
 
 	auto select_node = CreateSelectNode(edge_pg_entry, "weakly_connected_component", "componentId");
 
-	select_node->cte_map.map["csr_cte"] = CreateUndirectedCSRCTE(edge_pg_entry, select_node);
+	select_node->cte_map.map["csr_cte"] = CreateUndirectedCSRCTE(context, pg_name, edge_pg_entry, select_node);
 
 	auto subquery = make_uniq<SelectStatement>();
 	subquery->node = std::move(select_node);
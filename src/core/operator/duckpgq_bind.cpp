@@ -17,7 +17,13 @@ BoundStatement duckpgq_bind(ClientContext &context, Binder &binder, OperatorExte
 	auto duckpgq_binder = Binder::CreateBinder(context, &binder);
 	auto duckpgq_parse_data = dynamic_cast<DuckPGQParseData *>(duckpgq_state->parse_data.get());
 	if (duckpgq_parse_data) {
-		return duckpgq_binder->Bind(*(duckpgq_parse_data->statement));
+		auto bound_statement = duckpgq_binder->Bind(*(duckpgq_parse_data->statement));
+		if (duckpgq_state->match_uses_csr) {
+			// The plan reads the CSRs the rewrite installed for this query only, a prepared statement rebinds and with
+			// that reuses the cached rewrite for every execution
+			binder.SetAlwaysRequireRebind();
+		}
+		return bound_statement;
 	}
 	throw;
 }
@@ -24,14 +24,46 @@
 
 namespace duckdb {
 
+unique_ptr<SQLStatement> DuckPGQParserExtensionInfo::GetParsedStatement(const string &query) {
+	lock_guard<mutex> guard(parse_cache_lock);
+	auto entry = parse_cache.find(query);
+	if (entry == parse_cache.end()) {
+		return nullptr;
+	}
+	entry->second.last_used = ++parse_cache_clock;
+	return entry->second.statement->Copy();
+}
+
+void DuckPGQParserExtensionInfo::CacheParsedStatement(const string &query, const SQLStatement &statement) {
+	lock_guard<mutex> guard(parse_cache_lock);
+	while (parse_cache.size() >= PARSE_CACHE_CAPACITY) {
+		auto lru_entry = parse_cache.begin();
+		for (auto it = parse_cache.begin(); it != parse_cache.end(); it++) {
+			if (it->second.last_used < lru_entry->second.last_used) {
+				lru_entry = it;
+			}
+		}
+		parse_cache.erase(lru_entry);
+	}
+	auto &entry = parse_cache[query];
+	entry.statement = statement.Copy();
+	entry.last_used = ++parse_cache_clock;
+}
+
 ParserExtensionParseResult duckpgq_parse(ParserExtensionInfo *info, const std::string &query) {
-	Parser parser;
-	parser.ParseQuery((query[0] == '-') ? query.substr(1, query.length()) : query);
-	if (parser.statements.size() != 1) {
-		throw Exception(ExceptionType::PARSER, "More than one statement detected, please only give one.");
+	auto &parser_info = dynamic_cast<DuckPGQParserExtensionInfo &>(*info);
+	auto statement = parser_info.GetParsedStatement(query);
+	if (!statement) {
+		Parser parser;
+		parser.ParseQuery((query[0] == '-') ? query.substr(1, query.length()) : query);
+		if (parser.statements.size() != 1) {
+			throw Exception(ExceptionType::PARSER, "More than one statement detected, please only give one.");
+		}
+		statement = std::move(parser.statements[0]);
+		parser_info.CacheParsedStatement(query, *statement);
 	}
 	return ParserExtensionParseResult(
-	    make_uniq_base<ParserExtensionParseData, DuckPGQParseData>(std::move(parser.statements[0])));
+	    make_uniq_base<ParserExtensionParseData, DuckPGQParseData>(std::move(statement)));
 }
 
 void duckpgq_find_match_function(TableRef *table_ref, DuckPGQState &duckpgq_state) {
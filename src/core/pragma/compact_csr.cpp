@@ -0,0 +1,15 @@
+#include "duckdb/main/config.hpp"
+#include <duckpgq/core/pragma/duckpgq_pragma.hpp>
+
+namespace duckdb {
+
+void CorePGQPragma::RegisterCompactCSR(ExtensionLoader &loader) {
+	// PRAGMA duckpgq_compact_csr = true is rewritten by DuckDB into SET duckpgq_compact_csr = true
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption("duckpgq_compact_csr",
+	                          "Store CSR neighbor ids with 32 bits when every vertex id fits, halving the size of the "
+	                          "edge array",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+}
+
+} // namespace duckdb
@@ -3,6 +3,92 @@
 
 namespace duckdb {
 
+//! The optional outputs of create_vertex_table, set with its named parameters
+struct CreateVertexTableOptions {
+	//! Order in which the dense ids are assigned: 'none' keeps the order of the aggregate, 'degree' numbers the
+	//! vertices by decreasing degree and then by id
+	string vertex_order = "none";
+	string dense_id_column;
+	string degree_column;
+	string remapped_edge_table;
+
+	bool CSRReady() const {
+		return vertex_order != "none" || !dense_id_column.empty() || !degree_column.empty() ||
+		       !remapped_edge_table.empty();
+	}
+};
+
+static CreateVertexTableOptions GetCreateVertexTableOptions(const FunctionParameters &parameters) {
+	CreateVertexTableOptions options;
+	for (auto &parameter : parameters.named_parameters) {
+		auto value = parameter.second.GetValue<string>();
+		if (parameter.first == "vertex_order") {
+			options.vertex_order = StringUtil::Lower(value);
+			if (options.vertex_order != "none" && options.vertex_order != "degree") {
+				throw InvalidInputException("Unknown vertex_order '%s' for PRAGMA create_vertex_table, expected 'none' "
+				                            "or 'degree'",
+				                            value);
+			}
+		} else if (parameter.first == "dense_id") {
+			options.dense_id_column = value;
+		} else if (parameter.first == "degree") {
+			options.degree_column = value;
+		} else if (parameter.first == "edge_table") {
+			options.remapped_edge_table = value;
+		}
+	}
+	if (!options.remapped_edge_table.empty() && options.dense_id_column.empty()) {
+		throw InvalidInputException("PRAGMA create_vertex_table needs a dense_id column to remap the edges to");
+	}
+	return options;
+}
+
+// CREATE TABLE <vertex table> AS
+// SELECT <id>, __dense_id AS <dense id>, __degree AS <degree> FROM (
+//     SELECT <id>, __degree, row_number() OVER (<ORDER BY __degree DESC, <id>>) - 1 AS __dense_id FROM (
+//         SELECT <id>, count(*) AS __degree FROM (SELECT <src> AS <id> FROM <edges> UNION ALL
+//                                                  SELECT <dst> AS <id> FROM <edges>) GROUP BY <id>))
+// ORDER BY __dense_id
+// The distinct ids and their degrees come from one parallel hash aggregate. The rows are stored in the order of the
+// dense ids, so the dense id of every vertex is also its rowid, the vertex id of the CSR.
+static string CreateCSRReadyVertexTable(const string &edge_table, const string &source_column,
+                                        const string &destination_column, const string &vertex_table_name,
+                                        const string &id_column_name, const CreateVertexTableOptions &options) {
+	auto endpoints = "SELECT " + source_column + " AS " + id_column_name + " FROM " + edge_table + " UNION ALL " +
+	                 "SELECT " + destination_column + " AS " + id_column_name + " FROM " + edge_table;
+	auto degrees =
+	    "SELECT " + id_column_name + ", count(*) AS __degree FROM (" + endpoints + ") GROUP BY " + id_column_name;
+	auto window = options.vertex_order == "degree" ? "ORDER BY __degree DESC, " + id_column_name : string();
+	auto dense_ids = "SELECT " + id_column_name + ", __degree, row_number() OVER (" + window +
+	                 ") - 1 AS __dense_id FROM (" + degrees + ")";
+
+	auto select_list = id_column_name;
+	if (!options.dense_id_column.empty()) {
+		select_list += ", __dense_id AS " + options.dense_id_column;
+	}
+	if (!options.degree_column.empty()) {
+		select_list += ", __degree AS " + options.degree_column;
+	}
+	return "CREATE TABLE " + vertex_table_name + " AS SELECT " + select_list + " FROM (" + dense_ids +
+	       ") ORDER BY __dense_id";
+}
+
+// CREATE TABLE <remapped edge table> AS
+// SELECT __e.* REPLACE (__s.<dense id> AS <src>, __d.<dense id> AS <dst>)
+// FROM <edges> __e JOIN <vertex table> __s ON __e.<src> = __s.<id> JOIN <vertex table> __d ON __e.<dst> = __d.<id>
+// ORDER BY __s.<dense id>, __d.<dense id>
+// The edges are stored grouped by source like the adjacency lists of the CSR
+static string CreateRemappedEdgeTable(const string &edge_table, const string &source_column,
+                                      const string &destination_column, const string &vertex_table_name,
+                                      const string &id_column_name, const CreateVertexTableOptions &options) {
+	auto &dense_id = options.dense_id_column;
+	return "CREATE TABLE " + options.remapped_edge_table + " AS SELECT __e.* REPLACE (__s." + dense_id + " AS " +
+	       source_column + ", __d." + dense_id + " AS " + destination_column + ") FROM " + edge_table + " __e JOIN " +
+	       vertex_table_name + " __s ON __e." + source_column + " = __s." + id_column_name + " JOIN " +
+	       vertex_table_name + " __d ON __e." + destination_column + " = __d." + id_column_name + " ORDER BY __s." +
+	       dense_id + ", __d." + dense_id;
+}
+
 static string PragmaCreateVertexTable(ClientContext &context, const FunctionParameters &parameters) {
 	if (parameters.values.size() != 5) {
 		throw InvalidInputException("PRAGMA create_vertex_table requires exactly five parameters: edge_table, "
@@ -15,6 +101,17 @@ static string PragmaCreateVertexTable(ClientContext &context, const FunctionPara
 	string vertex_table_name = parameters.values[3].GetValue<string>();
 	string id_column_name = parameters.values[4].GetValue<string>();
 
+	auto options = GetCreateVertexTableOptions(parameters);
+	if (options.CSRReady()) {
+		auto result_query = CreateCSRReadyVertexTable(edge_table, source_column, destination_column,
+		                                              vertex_table_name, id_column_name, options);
+		if (!options.remapped_edge_table.empty()) {
+			result_query += "; " + CreateRemappedEdgeTable(edge_table, source_column, destination_column,
+			                                               vertex_table_name, id_column_name, options);
+		}
+		return result_query;
+	}
+
 	auto result_query = "CREATE TABLE " + vertex_table_name + " AS " + "SELECT DISTINCT " + id_column_name + " FROM " +
 	                    "(SELECT " + source_column + " AS " + id_column_name + " FROM " + edge_table + " UNION ALL " +
 	                    "SELECT " + destination_column + " AS " + id_column_name + " FROM " + edge_table + ")";
@@ -32,6 +129,11 @@ void CorePGQPragma::RegisterCreateVertexTable(ExtensionLoader &loader) {
 	                                                  LogicalType::VARCHAR, // Vertex table name
 	                                                  LogicalType::VARCHAR  // ID column name
 	                                              });
+	// Optional outputs that make the vertex table ready for CSR construction
+	pragma_func.named_parameters["vertex_order"] = LogicalType::VARCHAR;
+	pragma_func.named_parameters["dense_id"] = LogicalType::VARCHAR;
+	pragma_func.named_parameters["degree"] = LogicalType::VARCHAR;
+	pragma_func.named_parameters["edge_table"] = LogicalType::VARCHAR;
 
 	// Register the pragma function
 	loader.RegisterFunction(pragma_func);
@@ -0,0 +1,22 @@
+#include "duckdb/main/config.hpp"
+#include <duckpgq/core/pragma/duckpgq_pragma.hpp>
+
+namespace duckdb {
+
+void CorePGQPragma::RegisterCSRCacheSize(ExtensionLoader &loader) {
+	// PRAGMA duckpgq_csr_cache_size = <n> is rewritten by DuckDB into SET duckpgq_csr_cache_size = <n>
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption("duckpgq_csr_cache_size",
+	                          "Maximum number of CSRs kept alive across path-finding queries, 0 disables the cache",
+	                          LogicalType::BIGINT, Value::BIGINT(4));
+	config.AddExtensionOption("duckpgq_shared_csr_cache",
+	                          "Share the cached CSRs between all connections of the database instead of caching them "
+	                          "per connection, up to duckpgq_csr_cache_size of them",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+	config.AddExtensionOption("duckpgq_csr_prebuild",
+	                          "Build the CSRs of a new property graph, and rebuild the shared CSRs a write dropped, "
+	                          "on a background connection into the shared CSR cache",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+}
+
+} // namespace duckdb
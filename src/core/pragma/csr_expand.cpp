@@ -0,0 +1,15 @@
+#include "duckdb/main/config.hpp"
+#include <duckpgq/core/pragma/duckpgq_pragma.hpp>
+
+namespace duckdb {
+
+void CorePGQPragma::RegisterCSRExpand(ExtensionLoader &loader) {
+	// PRAGMA duckpgq_csr_expand = false is rewritten by DuckDB into SET duckpgq_csr_expand = false
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption("duckpgq_csr_expand",
+	                          "Answer MATCH patterns that chain single hops over one edge table by expanding its "
+	                          "cached CSR instead of joining the edge table once per hop",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(true));
+}
+
+} // namespace duckdb
@@ -0,0 +1,74 @@
+#include "duckdb/function/pragma_function.hpp"
+#include <duckpgq/core/pragma/duckpgq_pragma.hpp>
+#include <duckpgq/core/utils/csr_snapshot.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+static shared_ptr<PropertyGraphTable> GetSnapshotEdgeTable(const shared_ptr<DuckPGQState> &duckpgq_state,
+                                                           const string &pg_name, const string &edge_label) {
+	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
+	auto edge_pg_entry = pg_info->GetTableByLabel(edge_label, true, false);
+	if (edge_pg_entry->is_vertex_table) {
+		throw Exception(ExceptionType::INVALID, edge_label + " is a vertex table, expected an edge table");
+	}
+	return edge_pg_entry;
+}
+
+static void PragmaSaveCSR(ClientContext &context, const FunctionParameters &parameters) {
+	auto pg_name = StringUtil::Lower(parameters.values[0].GetValue<string>());
+	auto edge_label = StringUtil::Lower(parameters.values[1].GetValue<string>());
+	auto path = parameters.values[2].GetValue<string>();
+	auto directed = parameters.values.size() < 4 || parameters.values[3].GetValue<bool>();
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto edge_pg_entry = GetSnapshotEdgeTable(duckpgq_state, pg_name, edge_label);
+	auto csr = duckpgq_state->GetCachedCSR(pg_name, edge_pg_entry->main_label, directed, "");
+	if (!csr) {
+		throw InvalidInputException("No CSR found for %s in property graph %s, build it first with PRAGMA "
+		                            "materialize_csr",
+		                            edge_label, pg_name);
+	}
+	// Snapshots hold the plain arrays without a delta
+	csr->LoadPartitions(context);
+	csr->ReserveMemory(context, csr->MergeMemoryUsage());
+	csr->MergeDelta();
+	WriteCSRSnapshot(context, *csr, path, CSRSnapshotFingerprint::Compute(context, edge_pg_entry));
+}
+
+static void PragmaLoadCSR(ClientContext &context, const FunctionParameters &parameters) {
+	auto pg_name = StringUtil::Lower(parameters.values[0].GetValue<string>());
+	auto edge_label = StringUtil::Lower(parameters.values[1].GetValue<string>());
+	auto path = parameters.values[2].GetValue<string>();
+	auto directed = parameters.values.size() < 4 || parameters.values[3].GetValue<bool>();
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto edge_pg_entry = GetSnapshotEdgeTable(duckpgq_state, pg_name, edge_label);
+	auto csr = ReadCSRSnapshot(context, path, CSRSnapshotFingerprint::Compute(context, edge_pg_entry));
+	duckpgq_state->AddPinnedCSR(pg_name, edge_pg_entry->main_label, directed, "", std::move(csr));
+}
+
+static PragmaFunctionSet GetSnapshotPragmaSet(const string &name, pragma_function_t function) {
+	PragmaFunctionSet set(name);
+	set.AddFunction(PragmaFunction::PragmaCall(name, function,
+	                                           {
+	                                               LogicalType::VARCHAR, // Property graph
+	                                               LogicalType::VARCHAR, // Edge label
+	                                               LogicalType::VARCHAR  // File path
+	                                           }));
+	set.AddFunction(PragmaFunction::PragmaCall(name, function,
+	                                           {
+	                                               LogicalType::VARCHAR, // Property graph
+	                                               LogicalType::VARCHAR, // Edge label
+	                                               LogicalType::VARCHAR, // File path
+	                                               LogicalType::BOOLEAN  // Directed
+	                                           }));
+	return set;
+}
+
+void CorePGQPragma::RegisterCSRSnapshot(ExtensionLoader &loader) {
+	loader.RegisterFunction(GetSnapshotPragmaSet("save_csr", PragmaSaveCSR));
+	loader.RegisterFunction(GetSnapshotPragmaSet("load_csr", PragmaLoadCSR));
+}
+
+} // namespace duckdb
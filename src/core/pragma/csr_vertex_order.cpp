@@ -0,0 +1,15 @@
+#include "duckdb/main/config.hpp"
+#include <duckpgq/core/pragma/duckpgq_pragma.hpp>
+
+namespace duckdb {
+
+void CorePGQPragma::RegisterCSRVertexOrder(ExtensionLoader &loader) {
+	// PRAGMA duckpgq_csr_vertex_order = 'degree' is rewritten by DuckDB into SET duckpgq_csr_vertex_order = 'degree'
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption("duckpgq_csr_vertex_order",
+	                          "Order in which the vertices of a CSR are renumbered when it is built: 'none' keeps the "
+	                          "rowids, 'degree' sorts by decreasing out-degree, 'rcm' uses Reverse Cuthill-McKee",
+	                          LogicalType::VARCHAR, Value("none"));
+}
+
+} // namespace duckdb
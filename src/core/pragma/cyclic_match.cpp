@@ -0,0 +1,15 @@
+#include "duckdb/main/config.hpp"
+#include <duckpgq/core/pragma/duckpgq_pragma.hpp>
+
+namespace duckdb {
+
+void CorePGQPragma::RegisterCyclicMatch(ExtensionLoader &loader) {
+	// PRAGMA duckpgq_cyclic_match = false is rewritten by DuckDB into SET duckpgq_cyclic_match = false
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption("duckpgq_cyclic_match",
+	                          "Answer MATCH patterns that form a single directed cycle with a worst-case optimal join "
+	                          "over the CSR instead of one binary join per edge",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(true));
+}
+
+} // namespace duckdb
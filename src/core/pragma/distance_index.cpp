@@ -0,0 +1,86 @@
+#include "duckdb/function/pragma_function.hpp"
+#include <duckpgq/core/pragma/duckpgq_pragma.hpp>
+#include <duckpgq/core/utils/csr_distance_index.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+//! The cached unweighted CSR of [edge_label] the distance index is built on
+static shared_ptr<CSR> GetDistanceIndexCSR(ClientContext &context, const FunctionParameters &parameters) {
+	auto pg_name = StringUtil::Lower(parameters.values[0].GetValue<string>());
+	auto edge_label = StringUtil::Lower(parameters.values[1].GetValue<string>());
+	auto directed = parameters.values.size() < 3 || parameters.values[2].GetValue<bool>();
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
+	auto edge_pg_entry = pg_info->GetTableByLabel(edge_label, true, false);
+	if (edge_pg_entry->is_vertex_table) {
+		throw Exception(ExceptionType::INVALID, edge_label + " is a vertex table, expected an edge table");
+	}
+	auto csr = duckpgq_state->GetCachedCSR(pg_name, edge_pg_entry->main_label, directed, "");
+	if (!csr) {
+		throw InvalidInputException("No CSR found for %s in property graph %s, build it first with PRAGMA "
+		                            "materialize_csr",
+		                            edge_label, pg_name);
+	}
+	return csr;
+}
+
+static void PragmaCreateDistanceIndex(ClientContext &context, const FunctionParameters &parameters) {
+	bool exact = true;
+	idx_t landmark_count = DISTANCE_INDEX_DEFAULT_LANDMARKS;
+	for (auto &parameter : parameters.named_parameters) {
+		if (parameter.first == "exact") {
+			exact = parameter.second.GetValue<bool>();
+		} else if (parameter.first == "landmarks") {
+			auto landmarks = parameter.second.GetValue<int64_t>();
+			if (landmarks < 0) {
+				throw InvalidInputException("The number of landmarks of a distance index cannot be negative");
+			}
+			landmark_count = static_cast<idx_t>(landmarks);
+		}
+	}
+	auto csr = GetDistanceIndexCSR(context, parameters);
+	// The searches of the build read the plain arrays
+	csr->LoadPartitions(context);
+	csr->ReserveMemory(context, csr->MergeMemoryUsage());
+	csr->MergeDelta();
+	csr->SetDistanceIndex(make_shared_ptr<CSRDistanceIndex>(context, *csr, exact, landmark_count));
+}
+
+static void PragmaDropDistanceIndex(ClientContext &context, const FunctionParameters &parameters) {
+	GetDistanceIndexCSR(context, parameters)->SetDistanceIndex(nullptr);
+}
+
+static PragmaFunctionSet GetDistanceIndexPragmaSet(const string &name, pragma_function_t function,
+                                                   bool build_options) {
+	PragmaFunctionSet set(name);
+	vector<PragmaFunction> functions;
+	functions.push_back(PragmaFunction::PragmaCall(name, function,
+	                                               {
+	                                                   LogicalType::VARCHAR, // Property graph
+	                                                   LogicalType::VARCHAR  // Edge label
+	                                               }));
+	functions.push_back(PragmaFunction::PragmaCall(name, function,
+	                                               {
+	                                                   LogicalType::VARCHAR, // Property graph
+	                                                   LogicalType::VARCHAR, // Edge label
+	                                                   LogicalType::BOOLEAN  // Directed
+	                                               }));
+	for (auto &pragma : functions) {
+		if (build_options) {
+			// Without the exact labeling only the landmarks of graph_distance_estimate are built
+			pragma.named_parameters["exact"] = LogicalType::BOOLEAN;
+			pragma.named_parameters["landmarks"] = LogicalType::BIGINT;
+		}
+		set.AddFunction(pragma);
+	}
+	return set;
+}
+
+void CorePGQPragma::RegisterDistanceIndex(ExtensionLoader &loader) {
+	loader.RegisterFunction(GetDistanceIndexPragmaSet("create_distance_index", PragmaCreateDistanceIndex, true));
+	loader.RegisterFunction(GetDistanceIndexPragmaSet("drop_distance_index", PragmaDropDistanceIndex, false));
+}
+
+} // namespace duckdb
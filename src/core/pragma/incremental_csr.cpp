@@ -0,0 +1,19 @@
+#include "duckdb/main/config.hpp"
+#include <duckpgq/core/pragma/duckpgq_pragma.hpp>
+
+namespace duckdb {
+
+void CorePGQPragma::RegisterIncrementalCSR(ExtensionLoader &loader) {
+	// PRAGMA duckpgq_incremental_csr = true is rewritten by DuckDB into SET duckpgq_incremental_csr = true
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption("duckpgq_incremental_csr",
+	                          "Keep cached directed CSRs across writes and apply the changed edges to them instead of "
+	                          "rebuilding them",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+	config.AddExtensionOption("duckpgq_csr_delta_ratio",
+	                          "Fraction of the edges of an incremental CSR that its rewritten adjacency lists may hold "
+	                          "before the refresh that finds them merges them into the CSR",
+	                          LogicalType::DOUBLE, Value::DOUBLE(0.1));
+}
+
+} // namespace duckdb
@@ -0,0 +1,15 @@
+#include "duckdb/main/config.hpp"
+#include <duckpgq/core/pragma/duckpgq_pragma.hpp>
+
+namespace duckdb {
+
+void CorePGQPragma::RegisterMatchCacheSize(ExtensionLoader &loader) {
+	// PRAGMA duckpgq_match_cache_size = <n> is rewritten by DuckDB into SET duckpgq_match_cache_size = <n>
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption("duckpgq_match_cache_size",
+	                          "Maximum number of rewritten MATCH patterns a connection reuses across queries, 0 "
+	                          "disables the cache",
+	                          LogicalType::BIGINT, Value::BIGINT(64));
+}
+
+} // namespace duckdb
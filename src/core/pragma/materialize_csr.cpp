@@ -0,0 +1,46 @@
+#include "duckdb/function/pragma_function.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+#include <duckpgq/core/pragma/duckpgq_pragma.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+static string PragmaMaterializeCSR(ClientContext &context, const FunctionParameters &parameters) {
+	auto pg_name = parameters.values[0].GetValue<string>();
+	auto edge_label = parameters.values[1].GetValue<string>();
+	// Path-finding over directed edges is the common case, undirected CSRs have to be requested explicitly
+	auto directed = parameters.values.size() < 3 || parameters.values[2].GetValue<bool>();
+	return "SELECT * FROM duckpgq_materialize_csr(" + KeywordHelper::WriteQuoted(pg_name, '\'') + ", " +
+	       KeywordHelper::WriteQuoted(edge_label, '\'') + ", " + (directed ? "true" : "false") + ")";
+}
+
+static void PragmaDropMaterializedCSR(ClientContext &context, const FunctionParameters &parameters) {
+	auto pg_name = parameters.values[0].GetValue<string>();
+	auto edge_label = parameters.values[1].GetValue<string>();
+	auto duckpgq_state = GetDuckPGQState(context);
+	duckpgq_state->UnpinCSRs(pg_name, edge_label);
+}
+
+void CorePGQPragma::RegisterMaterializeCSR(ExtensionLoader &loader) {
+	PragmaFunctionSet materialize_set("materialize_csr");
+	materialize_set.AddFunction(PragmaFunction::PragmaCall("materialize_csr", PragmaMaterializeCSR,
+	                                                       {
+	                                                           LogicalType::VARCHAR, // Property graph
+	                                                           LogicalType::VARCHAR  // Edge label
+	                                                       }));
+	materialize_set.AddFunction(PragmaFunction::PragmaCall("materialize_csr", PragmaMaterializeCSR,
+	                                                       {
+	                                                           LogicalType::VARCHAR, // Property graph
+	                                                           LogicalType::VARCHAR, // Edge label
+	                                                           LogicalType::BOOLEAN  // Directed
+	                                                       }));
+	loader.RegisterFunction(materialize_set);
+
+	loader.RegisterFunction(PragmaFunction::PragmaCall("drop_materialized_csr", PragmaDropMaterializedCSR,
+	                                                   {
+	                                                       LogicalType::VARCHAR, // Property graph
+	                                                       LogicalType::VARCHAR  // Edge label
+	                                                   }));
+}
+
+} // namespace duckdb
@@ -0,0 +1,15 @@
+#include "duckdb/main/config.hpp"
+#include <duckpgq/core/pragma/duckpgq_pragma.hpp>
+
+namespace duckdb {
+
+void CorePGQPragma::RegisterPartitionedCSR(ExtensionLoader &loader) {
+	// PRAGMA duckpgq_csr_partition_size = 1000000 is rewritten by DuckDB into SET duckpgq_csr_partition_size = 1000000
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption("duckpgq_csr_partition_size",
+	                          "Number of edges per partition of unweighted CSRs, whose partitions are kept in "
+	                          "buffer-managed blocks that can be spilled to disk. 0 keeps CSRs in memory",
+	                          LogicalType::BIGINT, Value::BIGINT(0));
+}
+
+} // namespace duckdb
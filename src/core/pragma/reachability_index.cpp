@@ -0,0 +1,73 @@
+#include "duckdb/function/pragma_function.hpp"
+#include <duckpgq/core/pragma/duckpgq_pragma.hpp>
+#include <duckpgq/core/utils/csr_reachability_index.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+//! The CSR the reachability index is built on, the cached unweighted CSR of [edge_label] or the CSR under [csr_id]
+static shared_ptr<CSR> GetReachabilityIndexCSR(ClientContext &context, const FunctionParameters &parameters) {
+	if (parameters.values.size() == 1) {
+		auto csr_id = parameters.values[0].GetValue<int32_t>();
+		auto duckpgq_state = GetDuckPGQState(context);
+		auto csr_entry = duckpgq_state->csr_list.find(csr_id);
+		if (csr_entry == duckpgq_state->csr_list.end()) {
+			throw ConstraintException("CSR not found with ID %d", csr_id);
+		}
+		return csr_entry->second;
+	}
+	auto pg_name = StringUtil::Lower(parameters.values[0].GetValue<string>());
+	auto edge_label = StringUtil::Lower(parameters.values[1].GetValue<string>());
+	auto directed = parameters.values.size() < 3 || parameters.values[2].GetValue<bool>();
+
+	auto duckpgq_state = GetDuckPGQState(context);
+	auto pg_info = GetPropertyGraphInfo(duckpgq_state, pg_name);
+	auto edge_pg_entry = pg_info->GetTableByLabel(edge_label, true, false);
+	if (edge_pg_entry->is_vertex_table) {
+		throw Exception(ExceptionType::INVALID, edge_label + " is a vertex table, expected an edge table");
+	}
+	auto csr = duckpgq_state->GetCachedCSR(pg_name, edge_pg_entry->main_label, directed, "");
+	if (!csr) {
+		throw InvalidInputException("No CSR found for %s in property graph %s, build it first with PRAGMA "
+		                            "materialize_csr",
+		                            edge_label, pg_name);
+	}
+	return csr;
+}
+
+static void PragmaCreateReachabilityIndex(ClientContext &context, const FunctionParameters &parameters) {
+	auto csr = GetReachabilityIndexCSR(context, parameters);
+	// The condensation reads the plain arrays
+	csr->LoadPartitions(context);
+	csr->ReserveMemory(context, csr->MergeMemoryUsage());
+	csr->MergeDelta();
+	csr->SetReachabilityIndex(make_shared_ptr<CSRReachabilityIndex>(context, *csr));
+}
+
+static void PragmaDropReachabilityIndex(ClientContext &context, const FunctionParameters &parameters) {
+	GetReachabilityIndexCSR(context, parameters)->SetReachabilityIndex(nullptr);
+}
+
+static PragmaFunctionSet GetReachabilityIndexPragmaSet(const string &name, pragma_function_t function) {
+	PragmaFunctionSet set(name);
+	set.AddFunction(PragmaFunction::PragmaCall(name, function, {LogicalType::INTEGER})); // CSR id
+	set.AddFunction(PragmaFunction::PragmaCall(name, function,
+	                                           {
+	                                               LogicalType::VARCHAR, // Property graph
+	                                               LogicalType::VARCHAR  // Edge label
+	                                           }));
+	set.AddFunction(PragmaFunction::PragmaCall(name, function,
+	                                           {
+	                                               LogicalType::VARCHAR, // Property graph
+	                                               LogicalType::VARCHAR, // Edge label
+	                                               LogicalType::BOOLEAN  // Directed
+	                                           }));
+	return set;
+}
+
+void CorePGQPragma::RegisterReachabilityIndex(ExtensionLoader &loader) {
+	loader.RegisterFunction(GetReachabilityIndexPragmaSet("create_reachability_index", PragmaCreateReachabilityIndex));
+	loader.RegisterFunction(GetReachabilityIndexPragmaSet("drop_reachability_index", PragmaDropReachabilityIndex));
+}
+
+} // namespace duckdb
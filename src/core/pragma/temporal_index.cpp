@@ -0,0 +1,162 @@
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/function/pragma_function.hpp"
+#include "duckdb/main/connection.hpp"
+#include <duckpgq/core/pragma/duckpgq_pragma.hpp>
+#include <duckpgq/core/utils/csr_temporal_index.hpp>
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+#include <limits>
+
+namespace duckdb {
+
+static shared_ptr<PropertyGraphTable> GetTemporalIndexEdgeTable(ClientContext &context,
+                                                                const FunctionParameters &parameters) {
+	auto pg_name = StringUtil::Lower(parameters.values[0].GetValue<string>());
+	auto edge_label = StringUtil::Lower(parameters.values[1].GetValue<string>());
+	auto pg_info = GetPropertyGraphInfo(GetDuckPGQState(context), pg_name);
+	auto edge_pg_entry = pg_info->GetTableByLabel(edge_label, true, false);
+	if (edge_pg_entry->is_vertex_table) {
+		throw Exception(ExceptionType::INVALID, edge_label + " is a vertex table, expected an edge table");
+	}
+	return edge_pg_entry;
+}
+
+//! The cached unweighted CSR of [edge_table] the temporal index is kept on
+static shared_ptr<CSR> GetTemporalIndexCSR(ClientContext &context, const FunctionParameters &parameters,
+                                           const shared_ptr<PropertyGraphTable> &edge_table, bool directed) {
+	auto pg_name = StringUtil::Lower(parameters.values[0].GetValue<string>());
+	auto csr = GetDuckPGQState(context)->GetCachedCSR(pg_name, edge_table->main_label, directed, "");
+	if (!csr) {
+		throw InvalidInputException("No CSR found for %s in property graph %s, build it first with PRAGMA "
+		                            "materialize_csr",
+		                            parameters.values[1].GetValue<string>(), pg_name);
+	}
+	return csr;
+}
+
+//! Whether the bounds of type [type] are compared as timestamps, throws if they are neither timestamps nor integers
+static bool IsTimestampBound(const LogicalType &type, const string &column) {
+	switch (type.id()) {
+	case LogicalTypeId::DATE:
+	case LogicalTypeId::TIMESTAMP:
+	case LogicalTypeId::TIMESTAMP_SEC:
+	case LogicalTypeId::TIMESTAMP_MS:
+	case LogicalTypeId::TIMESTAMP_NS:
+	case LogicalTypeId::TIMESTAMP_TZ:
+		return true;
+	default:
+		if (type.IsIntegral()) {
+			return false;
+		}
+		throw InvalidInputException("The validity bound %s of a temporal index has to be a date, a timestamp or an "
+		                            "integer, not %s",
+		                            column, type.ToString());
+	}
+}
+
+//! Reads the bounds of every edge by rowid into [from] and [to], as microseconds since the epoch or as BIGINT.
+//! Returns whether they are timestamps.
+static bool ReadValidityIntervals(ClientContext &context, const shared_ptr<PropertyGraphTable> &edge_table,
+                                  const string &from_column, const string &to_column, vector<int64_t> &from,
+                                  vector<int64_t> &to) {
+	Connection connection(*context.db);
+	auto result = connection.Query("SELECT rowid, " + KeywordHelper::WriteOptionallyQuoted(from_column) + ", " +
+	                               KeywordHelper::WriteOptionallyQuoted(to_column) + " FROM " +
+	                               edge_table->CreateBaseTableRef()->ToString());
+	if (result->HasError()) {
+		result->ThrowError();
+	}
+	auto timestamps = IsTimestampBound(result->types[1], from_column);
+	if (IsTimestampBound(result->types[2], to_column) != timestamps) {
+		throw InvalidInputException("The validity bounds %s and %s of a temporal index have to be both timestamps or "
+		                            "both integers",
+		                            from_column, to_column);
+	}
+	auto key_type = timestamps ? LogicalType::TIMESTAMP : LogicalType::BIGINT;
+	while (true) {
+		auto chunk = result->Fetch();
+		if (!chunk || chunk->size() == 0) {
+			break;
+		}
+		auto count = chunk->size();
+		UnifiedVectorFormat rowid_data;
+		chunk->data[0].ToUnifiedFormat(count, rowid_data);
+		auto rowids = UnifiedVectorFormat::GetData<int64_t>(rowid_data);
+		for (idx_t bound = 0; bound < 2; bound++) {
+			// A NULL bound leaves the interval open on its side
+			auto &bounds = bound == 0 ? from : to;
+			auto open = bound == 0 ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
+			auto empty = bound == 0 ? std::numeric_limits<int64_t>::max() : std::numeric_limits<int64_t>::min();
+			Vector keys(key_type, count);
+			VectorOperations::Cast(context, chunk->data[bound + 1], keys, count);
+			UnifiedVectorFormat key_data;
+			keys.ToUnifiedFormat(count, key_data);
+			auto values = UnifiedVectorFormat::GetData<int64_t>(key_data);
+			for (idx_t row = 0; row < count; row++) {
+				auto rowid = static_cast<idx_t>(rowids[rowid_data.sel->get_index(row)]);
+				if (rowid >= bounds.size()) {
+					// The rows deleted before the build leave gaps whose intervals are empty
+					bounds.resize(rowid + 1, empty);
+				}
+				auto key_index = key_data.sel->get_index(row);
+				bounds[rowid] = key_data.validity.RowIsValid(key_index) ? values[key_index] : open;
+			}
+		}
+	}
+	return timestamps;
+}
+
+static void PragmaCreateTemporalIndex(ClientContext &context, const FunctionParameters &parameters) {
+	auto from_column = parameters.values[2].GetValue<string>();
+	auto to_column = parameters.values[3].GetValue<string>();
+	auto directed = parameters.values.size() < 5 || parameters.values[4].GetValue<bool>();
+	auto edge_table = GetTemporalIndexEdgeTable(context, parameters);
+	auto csr = GetTemporalIndexCSR(context, parameters, edge_table, directed);
+
+	vector<int64_t> from;
+	vector<int64_t> to;
+	auto timestamps = ReadValidityIntervals(context, edge_table, from_column, to_column, from, to);
+	// The intervals are stored by offset of the plain arrays
+	csr->LoadPartitions(context);
+	csr->ReserveMemory(context, csr->MergeMemoryUsage());
+	csr->MergeDelta();
+	csr->SetTemporalIndex(make_shared_ptr<CSRTemporalIndex>(context, *csr, from, to, timestamps));
+}
+
+static void PragmaDropTemporalIndex(ClientContext &context, const FunctionParameters &parameters) {
+	auto directed = parameters.values.size() < 3 || parameters.values[2].GetValue<bool>();
+	auto edge_table = GetTemporalIndexEdgeTable(context, parameters);
+	GetTemporalIndexCSR(context, parameters, edge_table, directed)->SetTemporalIndex(nullptr);
+}
+
+void CorePGQPragma::RegisterTemporalIndex(ExtensionLoader &loader) {
+	PragmaFunctionSet create_set("create_temporal_index");
+	vector<LogicalType> create_arguments {
+	    LogicalType::VARCHAR, // Property graph
+	    LogicalType::VARCHAR, // Edge label
+	    LogicalType::VARCHAR, // Valid from column
+	    LogicalType::VARCHAR  // Valid to column
+	};
+	create_set.AddFunction(PragmaFunction::PragmaCall("create_temporal_index", PragmaCreateTemporalIndex,
+	                                                  create_arguments));
+	create_arguments.push_back(LogicalType::BOOLEAN); // Directed
+	create_set.AddFunction(PragmaFunction::PragmaCall("create_temporal_index", PragmaCreateTemporalIndex,
+	                                                  create_arguments));
+	loader.RegisterFunction(create_set);
+
+	PragmaFunctionSet drop_set("drop_temporal_index");
+	drop_set.AddFunction(PragmaFunction::PragmaCall("drop_temporal_index", PragmaDropTemporalIndex,
+	                                                {
+	                                                    LogicalType::VARCHAR, // Property graph
+	                                                    LogicalType::VARCHAR  // Edge label
+	                                                }));
+	drop_set.AddFunction(PragmaFunction::PragmaCall("drop_temporal_index", PragmaDropTemporalIndex,
+	                                                {
+	                                                    LogicalType::VARCHAR, // Property graph
+	                                                    LogicalType::VARCHAR, // Edge label
+	                                                    LogicalType::BOOLEAN  // Directed
+	                                                }));
+	loader.RegisterFunction(drop_set);
+}
+
+} // namespace duckdb
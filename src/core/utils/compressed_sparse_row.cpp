@@ -1,12 +1,22 @@
 #include "duckpgq/core/utils/compressed_sparse_row.hpp"
+#include "duckpgq/core/utils/csr_blocks.hpp"
+#include "duckpgq/core/utils/csr_distance_index.hpp"
+#include "duckpgq/core/utils/csr_reachability_index.hpp"
+#include "duckpgq/core/utils/csr_temporal_index.hpp"
+#include "duckpgq/core/utils/partitioned_csr.hpp"
 #include "duckdb/common/string.hpp"
+#include "duckdb/common/string_util.hpp"
+#include <algorithm>
+#include <cmath>
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/parser/expression/comparison_expression.hpp"
 #include "duckdb/parser/expression/constant_expression.hpp"
 #include "duckdb/parser/expression/star_expression.hpp"
+#include "duckdb/parser/expression/operator_expression.hpp"
 #include "duckdb/parser/tableref/basetableref.hpp"
 #include "duckdb/parser/tableref/subqueryref.hpp"
 
+#include <duckpgq/core/utils/duckpgq_parallel.hpp>
 #include <duckpgq/core/utils/duckpgq_utils.hpp>
 
 namespace duckdb {
@@ -30,7 +40,7 @@ string CSR::ToString() const {
 		for (size_t i = 0; i < vsize - 2; i++) {
 			result << "  Node " << i << " connects to: ";
 			for (size_t j = v[i].load(); j < v[i + 1].load(); j++) {
-				result << e[j] << " ";
+				result << (compact ? e_compact[j] : e[j]) << " ";
 			}
 			result << "\n";
 		}
@@ -56,17 +66,647 @@ string CSR::ToString() const {
 	return result.str();
 }
 
-CSRFunctionData::CSRFunctionData(ClientContext &context, int32_t id, const LogicalType &weight_type)
-    : context(context), id(id), weight_type(weight_type) {
+bool CSR::IsComplete() const {
+	return initialized_v && initialized_e && inserted_edges.load() == static_cast<int64_t>(NeighborArraySize());
+}
+
+idx_t CSR::GetMemoryUsage() const {
+	auto result = ArrayMemoryUsage();
+	auto csr_partitions = GetPartitions();
+	if (csr_partitions) {
+		result += csr_partitions->GetMemoryUsage();
+	}
+	if (reverse) {
+		result += reverse->GetMemoryUsage();
+	}
+	auto index = GetDistanceIndex();
+	if (index) {
+		result += index->GetMemoryUsage();
+	}
+	auto reachability = GetReachabilityIndex();
+	if (reachability) {
+		result += reachability->GetMemoryUsage();
+	}
+	auto temporal = GetTemporalIndex();
+	if (temporal) {
+		result += temporal->GetMemoryUsage();
+	}
+	lock_guard<mutex> guard(weight_statistics_lock);
+	if (narrow_weights) {
+		result += narrow_weights->capacity() * sizeof(int32_t);
+	}
+	return result;
+}
+
+idx_t CSR::ArrayMemoryUsage() const {
+	idx_t result = vsize * sizeof(atomic<int64_t>);
+	result += e.capacity() * sizeof(int64_t);
+	result += e_compact.capacity() * sizeof(int32_t);
+	result += edge_ids.capacity() * sizeof(int64_t);
+	result += edge_labels.capacity() * sizeof(uint8_t);
+	result += w.capacity() * sizeof(int64_t);
+	result += w_double.capacity() * sizeof(double);
+	result += (internal_id.capacity() + external_id.capacity()) * sizeof(int64_t);
+	if (delta) {
+		result += (delta->begin.capacity() + delta->end.capacity()) * sizeof(int64_t);
+	}
+	return result;
+}
+
+void CSR::ReserveMemory(ClientContext &context, idx_t extra) {
+	memory.Resize(context, ArrayMemoryUsage() + extra);
+}
+
+template <class W>
+static void SortAdjacencyList(CSR &csr, int64_t begin, int64_t end, vector<W> &weights, vector<idx_t> &order,
+                              vector<int64_t> &buffer, vector<W> &weight_buffer) {
+	bool is_sorted = true;
+	for (int64_t i = begin + 1; i < end && is_sorted; i++) {
+		is_sorted = csr.e[i - 1] < csr.e[i] || (csr.e[i - 1] == csr.e[i] && csr.edge_ids[i - 1] <= csr.edge_ids[i]);
+	}
+	if (is_sorted) {
+		return;
+	}
+	auto degree = static_cast<idx_t>(end - begin);
+	order.resize(degree);
+	for (idx_t i = 0; i < degree; i++) {
+		order[i] = begin + i;
+	}
+	std::sort(order.begin(), order.end(), [&](idx_t a, idx_t b) {
+		return csr.e[a] < csr.e[b] || (csr.e[a] == csr.e[b] && csr.edge_ids[a] < csr.edge_ids[b]);
+	});
+	buffer.resize(degree);
+	for (idx_t i = 0; i < degree; i++) {
+		buffer[i] = csr.e[order[i]];
+	}
+	std::copy(buffer.begin(), buffer.end(), csr.e.begin() + begin);
+	for (idx_t i = 0; i < degree; i++) {
+		buffer[i] = csr.edge_ids[order[i]];
+	}
+	std::copy(buffer.begin(), buffer.end(), csr.edge_ids.begin() + begin);
+	if (csr.IsLabeled()) {
+		for (idx_t i = 0; i < degree; i++) {
+			buffer[i] = csr.edge_labels[order[i]];
+		}
+		std::copy(buffer.begin(), buffer.end(), csr.edge_labels.begin() + begin);
+	}
+	if (!weights.empty()) {
+		weight_buffer.resize(degree);
+		for (idx_t i = 0; i < degree; i++) {
+			weight_buffer[i] = weights[order[i]];
+		}
+		std::copy(weight_buffer.begin(), weight_buffer.end(), weights.begin() + begin);
+	}
+}
+
+void CSR::SortAdjacencyLists(ClientContext &context) {
+	D_ASSERT(!compact);
+	ParallelFor(context, vsize - 2, 8192, [&](idx_t begin, idx_t end) {
+		vector<idx_t> order;
+		vector<int64_t> buffer;
+		vector<int64_t> weight_buffer;
+		vector<double> weight_double_buffer;
+		for (idx_t i = begin; i < end; i++) {
+			auto start_edge = v[i].load();
+			auto end_edge = v[i + 1].load();
+			if (end_edge - start_edge < 2) {
+				continue;
+			}
+			if (!w_double.empty()) {
+				SortAdjacencyList<double>(*this, start_edge, end_edge, w_double, order, buffer, weight_double_buffer);
+			} else {
+				SortAdjacencyList<int64_t>(*this, start_edge, end_edge, w, order, buffer, weight_buffer);
+			}
+		}
+	});
+	sorted = true;
+}
+
+static CSRVertexOrder GetCSRVertexOrder(ClientContext &context) {
+	Value order_setting;
+	if (!context.TryGetCurrentSetting("duckpgq_csr_vertex_order", order_setting) || order_setting.IsNull()) {
+		return CSRVertexOrder::NONE;
+	}
+	auto order = StringUtil::Lower(order_setting.ToString());
+	if (order == "none") {
+		return CSRVertexOrder::NONE;
+	}
+	if (order == "degree") {
+		return CSRVertexOrder::DEGREE;
+	}
+	if (order == "rcm") {
+		return CSRVertexOrder::RCM;
+	}
+	throw InvalidInputException("Unknown duckpgq_csr_vertex_order '%s', expected 'none', 'degree' or 'rcm'",
+	                            order_setting.ToString());
+}
+
+void CSR::Finalize(ClientContext &context) {
+	if (GetPartitions()) {
+		// Sorting would pin every partition, LoadPartitions sorts the lists if a kernel needs them in memory
+		return;
+	}
+	Relabel(context, GetCSRVertexOrder(context));
+	SortAdjacencyLists(context);
+	Value compact_setting;
+	if (context.TryGetCurrentSetting("duckpgq_compact_csr", compact_setting) && !compact_setting.IsNull() &&
+	    compact_setting.GetValue<bool>() && !compact) {
+		// e and e_compact exist side by side while the neighbors are copied
+		ReserveMemory(context, e.size() * sizeof(int32_t));
+		Compact();
+	}
+	ReserveMemory(context);
+}
+
+//! Vertices by decreasing out-degree, vertices of equal degree keep their relative order
+static vector<int64_t> DegreeOrder(const int64_t *v, idx_t vertex_count) {
+	vector<int64_t> order(vertex_count);
+	for (idx_t i = 0; i < vertex_count; i++) {
+		order[i] = static_cast<int64_t>(i);
+	}
+	std::stable_sort(order.begin(), order.end(),
+	                 [&](int64_t a, int64_t b) { return v[a + 1] - v[a] > v[b + 1] - v[b]; });
+	return order;
+}
+
+//! Reverse Cuthill-McKee over the outgoing edges. Every BFS starts at the unvisited vertex of lowest degree and
+//! appends the unvisited neighbors of a vertex in increasing degree, the concatenated BFS orders are reversed.
+static vector<int64_t> RCMOrder(const int64_t *v, const vector<int64_t> &e, idx_t vertex_count) {
+	auto degree = [&](int64_t vertex) {
+		return v[vertex + 1] - v[vertex];
+	};
+	auto by_degree = [&](int64_t a, int64_t b) {
+		return degree(a) < degree(b) || (degree(a) == degree(b) && a < b);
+	};
+	vector<int64_t> starts(vertex_count);
+	for (idx_t i = 0; i < vertex_count; i++) {
+		starts[i] = static_cast<int64_t>(i);
+	}
+	std::sort(starts.begin(), starts.end(), by_degree);
+
+	vector<int64_t> order;
+	order.reserve(vertex_count);
+	vector<uint8_t> visited(vertex_count, 0);
+	for (auto start : starts) {
+		if (visited[start]) {
+			continue;
+		}
+		visited[start] = 1;
+		auto head = order.size();
+		order.push_back(start);
+		while (head < order.size()) {
+			auto vertex = order[head++];
+			auto first_new = order.size();
+			for (auto offset = v[vertex]; offset < v[vertex + 1]; offset++) {
+				auto neighbor = e[offset];
+				if (!visited[neighbor]) {
+					visited[neighbor] = 1;
+					order.push_back(neighbor);
+				}
+			}
+			std::sort(order.begin() + static_cast<int64_t>(first_new), order.end(), by_degree);
+		}
+	}
+	std::reverse(order.begin(), order.end());
+	return order;
+}
+
+void CSR::Relabel(ClientContext &context, CSRVertexOrder order) {
+	D_ASSERT(!delta && !GetPartitions());
+	auto vertex_count = vsize - 2;
+	if (order == CSRVertexOrder::NONE || vertex_count == 0 || compact || IsRelabeled()) {
+		return;
+	}
+	auto old_v = reinterpret_cast<int64_t *>(v.get());
+	// The order and both mappings, then the new arrays next to the old ones until they replace them
+	auto weight_size = w.size() * sizeof(int64_t) + w_double.size() * sizeof(double);
+	ReserveMemory(context, 3 * vertex_count * sizeof(int64_t));
+	external_id = order == CSRVertexOrder::DEGREE ? DegreeOrder(old_v, vertex_count) : RCMOrder(old_v, e, vertex_count);
+	internal_id.resize(vertex_count);
+	for (idx_t i = 0; i < vertex_count; i++) {
+		internal_id[external_id[i]] = static_cast<int64_t>(i);
+	}
+	ReserveMemory(context, vsize * sizeof(atomic<int64_t>) + e.size() * 2 * sizeof(int64_t) + weight_size +
+	                           edge_labels.size() * sizeof(uint8_t));
+
+	auto new_v = make_uniq<atomic<int64_t>[]>(vsize);
+	int64_t offset = 0;
+	for (idx_t i = 0; i < vertex_count; i++) {
+		new_v[i] = offset;
+		auto vertex = external_id[i];
+		offset += old_v[vertex + 1] - old_v[vertex];
+	}
+	new_v[vertex_count] = offset;
+	new_v[vertex_count + 1] = offset;
+
+	vector<int64_t> new_e(e.size());
+	vector<int64_t> new_edge_ids(edge_ids.size());
+	vector<uint8_t> new_edge_labels(edge_labels.size());
+	vector<int64_t> new_w(w.size());
+	vector<double> new_w_double(w_double.size());
+	ParallelFor(context, vertex_count, 8192, [&](idx_t begin, idx_t end) {
+		for (idx_t i = begin; i < end; i++) {
+			auto vertex = external_id[i];
+			auto target = new_v[i].load();
+			for (auto source = old_v[vertex]; source < old_v[vertex + 1]; source++, target++) {
+				new_e[target] = internal_id[e[source]];
+				new_edge_ids[target] = edge_ids[source];
+				if (!edge_labels.empty()) {
+					new_edge_labels[target] = edge_labels[source];
+				}
+				if (!w.empty()) {
+					new_w[target] = w[source];
+				}
+				if (!w_double.empty()) {
+					new_w_double[target] = w_double[source];
+				}
+			}
+		}
+	});
+	v = std::move(new_v);
+	e = std::move(new_e);
+	edge_ids = std::move(new_edge_ids);
+	edge_labels = std::move(new_edge_labels);
+	w = std::move(new_w);
+	w_double = std::move(new_w_double);
+	sorted = false;
+	ReserveMemory(context);
+}
+
+const int64_t *CSR::InternalIds(const UnifiedVectorFormat &format, idx_t count, vector<int64_t> &buffer) const {
+	auto data = reinterpret_cast<const int64_t *>(format.data);
+	if (!IsRelabeled()) {
+		return data;
+	}
+	idx_t size = 0;
+	for (idx_t i = 0; i < count; i++) {
+		size = MaxValue<idx_t>(size, format.sel->get_index(i) + 1);
+	}
+	buffer.resize(size);
+	for (idx_t i = 0; i < count; i++) {
+		auto index = format.sel->get_index(i);
+		if (format.validity.RowIsValid(index)) {
+			buffer[index] = InternalId(data[index]);
+		}
+	}
+	return buffer.data();
+}
+
+template <class ID_T>
+static void BuildReverse(ClientContext &context, CSR &forward, vector<ID_T> &forward_e, CSR &reverse,
+                         vector<ID_T> &reverse_e) {
+	auto vertex_count = forward.VertexCount();
+	auto ranges = forward.GetRanges();
+	reverse.ReserveMemory(context, (vertex_count + 2) * sizeof(atomic<int64_t>) +
+	                                   forward.EdgeCount() * (sizeof(ID_T) + sizeof(int64_t) + sizeof(uint8_t)) +
+	                                   (forward.internal_id.size() + forward.external_id.size()) * sizeof(int64_t));
+	reverse.vsize = vertex_count + 2;
+	reverse.v = make_uniq<std::atomic<int64_t>[]>(reverse.vsize);
+	for (idx_t i = 0; i < reverse.vsize; i++) {
+		reverse.v[i] = 0;
+	}
+	// Counting sort on the destination, reverse.v[d + 1] ends up as the start of the incoming list of d
+	for (idx_t src = 0; src < vertex_count; src++) {
+		for (auto offset = ranges.begin[src]; offset < ranges.end[src]; offset++) {
+			reverse.v[forward_e[offset] + 2]++;
+		}
+	}
+	for (idx_t i = 2; i < reverse.vsize; i++) {
+		reverse.v[i] += reverse.v[i - 1];
+	}
+	auto edge_count = static_cast<idx_t>(reverse.v[reverse.vsize - 1].load());
+	reverse_e.resize(edge_count);
+	reverse.edge_ids.resize(edge_count);
+	reverse.edge_labels.resize(forward.IsLabeled() ? edge_count : 0);
+	for (idx_t src = 0; src < vertex_count; src++) {
+		for (auto offset = ranges.begin[src]; offset < ranges.end[src]; offset++) {
+			auto pos = reverse.v[forward_e[offset] + 1]++;
+			reverse_e[pos] = static_cast<ID_T>(src);
+			reverse.edge_ids[pos] = forward.edge_ids[offset];
+			if (forward.IsLabeled()) {
+				reverse.edge_labels[pos] = forward.edge_labels[offset];
+			}
+		}
+	}
+	// Both CSRs use the same vertex ids, so kernels that run on the reverse translate their arguments the same way
+	reverse.internal_id = forward.internal_id;
+	reverse.external_id = forward.external_id;
+	reverse.initialized_v = true;
+	reverse.initialized_e = true;
+	reverse.inserted_edges = static_cast<int64_t>(edge_count);
+	// Sources are visited in increasing order
+	reverse.sorted = true;
+}
+
+CSR &CSR::GetReverse(ClientContext &context) {
+	return *GetReverseCSR(context);
+}
+
+shared_ptr<CSR> CSR::GetReverseCSR(ClientContext &context) {
+	// The reverse CSR is built from all edges at once
+	LoadPartitions(context);
+	lock_guard<mutex> guard(reverse_lock);
+	if (!reverse) {
+		D_ASSERT(IsComplete());
+		auto result = make_shared_ptr<CSR>();
+		if (compact) {
+			result->compact = true;
+			BuildReverse<int32_t>(context, *this, e_compact, *result, result->e_compact);
+		} else {
+			BuildReverse<int64_t>(context, *this, e, *result, result->e);
+		}
+		reverse = std::move(result);
+	}
+	return reverse;
+}
+
+void CSR::ResetReverse() {
+	lock_guard<mutex> guard(reverse_lock);
+	reverse.reset();
+}
+
+void CSR::ResetBlocks() {
+	lock_guard<mutex> guard(blocks_lock);
+	blocks.reset();
+}
+
+shared_ptr<const CSRBlocks> CSR::GetBlocks(idx_t block_edges) {
+	lock_guard<mutex> guard(blocks_lock);
+	if (!blocks || blocks->block_edges != block_edges) {
+		blocks = make_shared_ptr<CSRBlocks>(GetRanges(), VertexCount(), block_edges);
+	}
+	return blocks;
+}
+
+shared_ptr<const CSRDistanceIndex> CSR::GetDistanceIndex() const {
+	lock_guard<mutex> guard(distance_index_lock);
+	return distance_index;
+}
+
+void CSR::SetDistanceIndex(shared_ptr<const CSRDistanceIndex> index) {
+	lock_guard<mutex> guard(distance_index_lock);
+	distance_index = std::move(index);
+}
+
+shared_ptr<const CSRReachabilityIndex> CSR::GetReachabilityIndex() const {
+	lock_guard<mutex> guard(distance_index_lock);
+	return reachability_index;
+}
+
+void CSR::SetReachabilityIndex(shared_ptr<const CSRReachabilityIndex> index) {
+	lock_guard<mutex> guard(distance_index_lock);
+	reachability_index = std::move(index);
+}
+
+shared_ptr<const CSRTemporalIndex> CSR::GetTemporalIndex() const {
+	lock_guard<mutex> guard(distance_index_lock);
+	return temporal_index;
+}
+
+void CSR::SetTemporalIndex(shared_ptr<const CSRTemporalIndex> index) {
+	lock_guard<mutex> guard(distance_index_lock);
+	temporal_index = std::move(index);
+}
+
+CSRRanges CSR::GetRanges() const {
+	if (delta) {
+		return CSRRanges(delta->begin.data(), delta->end.data());
+	}
+	return CSRRanges(reinterpret_cast<const int64_t *>(v.get()));
+}
+
+idx_t CSR::DeltaSize() const {
+	return delta ? NeighborArraySize() - delta->base_edge_count : 0;
+}
+
+template <class ID_T>
+static void AppendAdjacencyList(vector<ID_T> &e, vector<int64_t> &edge_ids, const vector<int64_t> &neighbors,
+                                const vector<int64_t> &neighbor_edge_ids, idx_t begin, idx_t end) {
+	for (auto i = begin; i < end; i++) {
+		e.push_back(static_cast<ID_T>(neighbors[i]));
+		edge_ids.push_back(neighbor_edge_ids[i]);
+	}
+}
+
+void CSR::ApplyDelta(ClientContext &context, idx_t vertex_count, const vector<int64_t> &vertices,
+                     const vector<idx_t> &list_offsets, const vector<int64_t> &neighbors,
+                     const vector<int64_t> &neighbor_edge_ids) {
+	D_ASSERT(w.empty() && w_double.empty());
+	lock_guard<mutex> guard(delta_lock);
+	ReserveMemory(context, neighbors.size() * ((compact ? sizeof(int32_t) : sizeof(int64_t)) + sizeof(int64_t)) +
+	                           2 * vertex_count * sizeof(int64_t));
+	auto base_vertex_count = vsize - 2;
+	auto base_edge_count = delta ? delta->base_edge_count : NeighborArraySize();
+	if (compact) {
+		e_compact.resize(base_edge_count);
+	} else {
+		e.resize(base_edge_count);
+	}
+	edge_ids.resize(base_edge_count);
+	ResetReverse();
+	ResetBlocks();
+	SetDistanceIndex(nullptr);
+	SetReachabilityIndex(nullptr);
+	SetTemporalIndex(nullptr);
+	if (vertices.empty() && vertex_count == base_vertex_count) {
+		delta.reset();
+		inserted_edges = static_cast<int64_t>(base_edge_count);
+		ReserveMemory(context);
+		return;
+	}
+
+	auto result = make_uniq<CSRDelta>();
+	result->vertex_count = vertex_count;
+	result->base_edge_count = base_edge_count;
+	result->edge_count = base_edge_count;
+	result->begin.assign(vertex_count, 0);
+	result->end.assign(vertex_count, 0);
+	for (idx_t i = 0; i < MinValue<idx_t>(vertex_count, base_vertex_count); i++) {
+		result->begin[i] = v[i].load();
+		result->end[i] = v[i + 1].load();
+	}
+	for (idx_t i = 0; i < vertices.size(); i++) {
+		auto vertex = vertices[i];
+		D_ASSERT(vertex >= 0 && static_cast<idx_t>(vertex) < vertex_count);
+		result->edge_count -= result->end[vertex] - result->begin[vertex];
+		result->begin[vertex] = static_cast<int64_t>(NeighborArraySize());
+		if (compact) {
+			AppendAdjacencyList<int32_t>(e_compact, edge_ids, neighbors, neighbor_edge_ids, list_offsets[i],
+			                             list_offsets[i + 1]);
+		} else {
+			AppendAdjacencyList<int64_t>(e, edge_ids, neighbors, neighbor_edge_ids, list_offsets[i],
+			                             list_offsets[i + 1]);
+		}
+		result->end[vertex] = static_cast<int64_t>(NeighborArraySize());
+		result->edge_count += list_offsets[i + 1] - list_offsets[i];
+	}
+	inserted_edges = static_cast<int64_t>(NeighborArraySize());
+	delta = std::move(result);
+	ReserveMemory(context);
+}
+
+template <class ID_T>
+static void MergeNeighbors(const CSRRanges &ranges, idx_t vertex_count, idx_t edge_count, vector<ID_T> &e,
+                           vector<int64_t> &edge_ids, std::atomic<int64_t> *new_v) {
+	vector<ID_T> new_e;
+	vector<int64_t> new_edge_ids;
+	new_e.reserve(edge_count);
+	new_edge_ids.reserve(edge_count);
+	for (idx_t i = 0; i < vertex_count; i++) {
+		new_v[i] = static_cast<int64_t>(new_e.size());
+		for (auto offset = ranges.begin[i]; offset < ranges.end[i]; offset++) {
+			new_e.push_back(e[offset]);
+			new_edge_ids.push_back(edge_ids[offset]);
+		}
+	}
+	// The last two entries delimit the adjacency lists
+	new_v[vertex_count] = static_cast<int64_t>(new_e.size());
+	new_v[vertex_count + 1] = static_cast<int64_t>(new_e.size());
+	e.swap(new_e);
+	edge_ids.swap(new_edge_ids);
+}
+
+void CSR::MergeDelta() {
+	lock_guard<mutex> guard(delta_lock);
+	if (!delta) {
+		return;
+	}
+	auto vertex_count = delta->vertex_count;
+	auto new_v = make_uniq<std::atomic<int64_t>[]>(vertex_count + 2);
+	if (compact) {
+		MergeNeighbors<int32_t>(GetRanges(), vertex_count, delta->edge_count, e_compact, edge_ids, new_v.get());
+	} else {
+		MergeNeighbors<int64_t>(GetRanges(), vertex_count, delta->edge_count, e, edge_ids, new_v.get());
+	}
+	v = std::move(new_v);
+	vsize = vertex_count + 2;
+	inserted_edges = static_cast<int64_t>(NeighborArraySize());
+	delta.reset();
+	ResetReverse();
+	ResetBlocks();
+	memory.Shrink(ArrayMemoryUsage());
+}
+
+idx_t CSR::MergeMemoryUsage() const {
+	if (!delta) {
+		return 0;
+	}
+	return (delta->vertex_count + 2) * sizeof(atomic<int64_t>) +
+	       delta->edge_count * ((compact ? sizeof(int32_t) : sizeof(int64_t)) + sizeof(int64_t));
+}
+
+template <class W>
+static CSRWeightStatistics ComputeWeightStatistics(const vector<W> &weights) {
+	CSRWeightStatistics result;
+	if (weights.empty()) {
+		return result;
+	}
+	double sum = 0;
+	result.min = static_cast<double>(weights[0]);
+	result.max = result.min;
+	for (auto weight : weights) {
+		auto value = static_cast<double>(weight);
+		result.min = MinValue<double>(result.min, value);
+		result.max = MaxValue<double>(result.max, value);
+		sum += value;
+	}
+	result.mean = sum / static_cast<double>(weights.size());
+	return result;
+}
+
+const CSRWeightStatistics &CSR::GetWeightStatistics() {
+	lock_guard<mutex> guard(weight_statistics_lock);
+	if (!weight_statistics) {
+		D_ASSERT(IsComplete());
+		weight_statistics = make_uniq<CSRWeightStatistics>(w_double.empty() ? ComputeWeightStatistics(w)
+		                                                                      : ComputeWeightStatistics(w_double));
+	}
+	return *weight_statistics;
+}
+
+shared_ptr<const vector<int32_t>> CSR::GetNarrowWeights() {
+	auto &statistics = GetWeightStatistics();
+	lock_guard<mutex> guard(weight_statistics_lock);
+	if (!narrow_weights_checked) {
+		narrow_weights_checked = true;
+		// A path without cycles has fewer edges than there are vertices, and the searches add one more weight to a
+		// distance before they compare it
+		auto largest = MaxValue<double>(std::abs(statistics.min), std::abs(statistics.max)) *
+		               static_cast<double>(VertexCount());
+		if (!w.empty() && largest < static_cast<double>(NumericLimits<int32_t>::Maximum())) {
+			narrow_weights = make_shared_ptr<vector<int32_t>>(w.begin(), w.end());
+		}
+	}
+	return narrow_weights;
+}
+
+void CSR::Partition(ClientContext &context, idx_t edges_per_partition) {
+	D_ASSERT(w.empty() && w_double.empty() && e.empty());
+	lock_guard<mutex> guard(partitions_lock);
+	// Until the edges are inserted, v[i + 1] is the offset of the adjacency list of vertex i
+	partitions = make_shared_ptr<CSRPartitions>(context, v.get() + 1, vsize - 2, edges_per_partition);
+	partitioned_edges = partitions->EdgeCount();
+}
+
+shared_ptr<CSRPartitions> CSR::GetPartitions() const {
+	lock_guard<mutex> guard(partitions_lock);
+	return partitions;
+}
+
+void CSR::LoadPartitions(ClientContext &context) {
+	lock_guard<mutex> guard(partitions_lock);
+	if (!partitions) {
+		return;
+	}
+	auto edge_count = partitions->EdgeCount();
+	ReserveMemory(context, edge_count * 2 * sizeof(int64_t));
+	e.resize(edge_count);
+	edge_ids.resize(edge_count);
+	ParallelFor(context, partitions->Count(), 1, [&](idx_t begin, idx_t end) {
+		for (auto p = begin; p < end; p++) {
+			auto &partition = partitions->Get(p);
+			auto handle = partitions->Pin(p);
+			for (auto offset = partition.edge_begin; offset < partition.edge_end; offset++) {
+				e[offset] = handle.Neighbor(offset);
+				edge_ids[offset] = handle.EdgeId(offset);
+			}
+		}
+	});
+	SortAdjacencyLists(context);
+	// A kernel reading the partitions keeps their blocks alive
+	partitions.reset();
+	partitioned_edges = 0;
+}
+
+idx_t CSR::EdgeCount() const {
+	return delta ? delta->edge_count : NeighborArraySize();
+}
+
+void CSR::Compact() {
+	if (compact || vsize - 2 > static_cast<idx_t>(NumericLimits<int32_t>::Maximum())) {
+		return;
+	}
+	e_compact.resize(e.size());
+	for (idx_t i = 0; i < e.size(); i++) {
+		e_compact[i] = static_cast<int32_t>(e[i]);
+	}
+	vector<int64_t>().swap(e);
+	compact = true;
+}
+
+CSRFunctionData::CSRFunctionData(ClientContext &context, int32_t id, const LogicalType &weight_type, bool labeled,
+                                 bool symmetric)
+    : context(context), id(id), weight_type(weight_type), labeled(labeled), symmetric(symmetric) {
 }
 
 unique_ptr<FunctionData> CSRFunctionData::Copy() const {
-	return make_uniq<CSRFunctionData>(context, id, weight_type);
+	return make_uniq<CSRFunctionData>(context, id, weight_type, labeled, symmetric);
 }
 
 bool CSRFunctionData::Equals(const FunctionData &other_p) const {
 	auto &other = dynamic_cast<const CSRFunctionData &>(other_p);
-	return id == other.id && weight_type == other.weight_type;
+	return id == other.id && weight_type == other.weight_type && labeled == other.labeled &&
+	       symmetric == other.symmetric;
 }
 
 unique_ptr<FunctionData> CSRFunctionData::CSRVertexBind(ClientContext &context, ScalarFunction &bound_function,
@@ -89,6 +729,9 @@ unique_ptr<FunctionData> CSRFunctionData::CSREdgeBind(ClientContext &context, Sc
 		throw InvalidInputException("Id must be constant.");
 	}
 	Value id = ExpressionExecutor::EvaluateScalar(context, *arguments[0]);
+	if (arguments.size() == 8 && arguments[7]->return_type == LogicalType::UTINYINT) {
+		return make_uniq<CSRFunctionData>(context, id.GetValue<int32_t>(), LogicalType::SQLNULL, true);
+	}
 	if (arguments.size() == 8) {
 		return make_uniq<CSRFunctionData>(context, id.GetValue<int32_t>(), arguments[7]->return_type);
 	}
@@ -96,6 +739,15 @@ unique_ptr<FunctionData> CSRFunctionData::CSREdgeBind(ClientContext &context, Sc
 	return make_uniq<CSRFunctionData>(context, id.GetValue<int32_t>(), logical_type);
 }
 
+unique_ptr<FunctionData> CSRFunctionData::CSRUndirectedEdgeBind(ClientContext &context, ScalarFunction &bound_function,
+                                                               vector<unique_ptr<Expression>> &arguments) {
+	if (!arguments[0]->IsFoldable()) {
+		throw InvalidInputException("Id must be constant.");
+	}
+	Value id = ExpressionExecutor::EvaluateScalar(context, *arguments[0]);
+	return make_uniq<CSRFunctionData>(context, id.GetValue<int32_t>(), LogicalType::SQLNULL, false, true);
+}
+
 unique_ptr<FunctionData> CSRFunctionData::CSRBind(ClientContext &context, ScalarFunction &bound_function,
                                                   vector<unique_ptr<Expression>> &arguments) {
 	if (!arguments[0]->IsFoldable()) {
@@ -163,6 +815,33 @@ unique_ptr<SubqueryExpression> GetCountTable(const shared_ptr<PropertyGraphTable
 	return result;
 }
 
+unique_ptr<SubqueryExpression> GetRowidBound(const shared_ptr<PropertyGraphTable> &table, const string &table_alias) {
+	auto select_node = make_uniq<SelectNode>();
+	select_node->from_table = table->CreateBaseTableRef(table_alias);
+
+	vector<unique_ptr<ParsedExpression>> max_children;
+	max_children.push_back(make_uniq<ColumnRefExpression>("rowid", table_alias));
+	vector<unique_ptr<ParsedExpression>> add_children;
+	add_children.push_back(make_uniq<FunctionExpression>("max", std::move(max_children)));
+	add_children.push_back(make_uniq<ConstantExpression>(Value::BIGINT(1)));
+	vector<unique_ptr<ParsedExpression>> coalesce_children;
+	coalesce_children.push_back(make_uniq<FunctionExpression>("add", std::move(add_children)));
+	coalesce_children.push_back(make_uniq<ConstantExpression>(Value::BIGINT(0)));
+	select_node->select_list.push_back(
+	    make_uniq<OperatorExpression>(ExpressionType::OPERATOR_COALESCE, std::move(coalesce_children)));
+
+	auto select_statement = make_uniq<SelectStatement>();
+	select_statement->node = std::move(select_node);
+	auto result = make_uniq<SubqueryExpression>();
+	result->subquery = std::move(select_statement);
+	result->subquery_type = SubqueryType::SCALAR;
+	return result;
+}
+
+unique_ptr<ParsedExpression> CreateVertexCountArgument() {
+	return make_uniq<ConstantExpression>(Value(LogicalType::BIGINT));
+}
+
 unique_ptr<JoinRef> GetJoinRef(const shared_ptr<PropertyGraphTable> &edge_table, const string &edge_binding,
                                const string &prev_binding, const string &next_binding) {
 	auto first_join_ref = make_uniq<JoinRef>(JoinRefType::REGULAR);
@@ -187,141 +866,76 @@ unique_ptr<JoinRef> GetJoinRef(const shared_ptr<PropertyGraphTable> &edge_table,
 	return first_join_ref;
 }
 
+// SELECT sum(create_csr_degree(0, <rowid bound>, <prev>.rowid, <edge>.<source fk>)) FROM <vertex table> <prev>
+// LEFT JOIN <edge table> ON ..., which counts the out-degrees straight into the CSR without a GROUP BY. The vertices
+// without edges still create the CSR.
 unique_ptr<SubqueryExpression> CreateDirectedCSRVertexSubquery(const shared_ptr<PropertyGraphTable> &edge_table,
                                                                const string &prev_binding) {
-	auto count_create_vertex_expr = GetCountTable(edge_table->source_pg_table, prev_binding, edge_table->source_pk[0]);
-
-	vector<unique_ptr<ParsedExpression>> csr_vertex_children;
-	csr_vertex_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
-	csr_vertex_children.push_back(std::move(count_create_vertex_expr));
-	csr_vertex_children.push_back(make_uniq<ColumnRefExpression>("dense_id", "sub"));
-	csr_vertex_children.push_back(make_uniq<ColumnRefExpression>("cnt", "sub"));
-	auto create_vertex_function = make_uniq<FunctionExpression>("create_csr_vertex", std::move(csr_vertex_children));
-
+	vector<unique_ptr<ParsedExpression>> csr_degree_children;
+	csr_degree_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
+	csr_degree_children.push_back(GetRowidBound(edge_table->source_pg_table, prev_binding));
+	csr_degree_children.push_back(make_uniq<ColumnRefExpression>("rowid", prev_binding));
+	csr_degree_children.push_back(make_uniq<ColumnRefExpression>(edge_table->source_fk[0], edge_table->table_name));
 	vector<unique_ptr<ParsedExpression>> sum_children;
-	sum_children.push_back(std::move(create_vertex_function));
-	auto sum_function = make_uniq<FunctionExpression>("sum", std::move(sum_children));
-
-	auto inner_select_statement = make_uniq<SelectStatement>();
-	auto inner_select_node = make_uniq<SelectNode>();
-
-	inner_select_node->select_list.emplace_back(CreateColumnRefExpression("rowid", prev_binding, "dense_id"));
-	auto edge_src_colref = make_uniq<ColumnRefExpression>(edge_table->source_fk[0], edge_table->table_name);
-	vector<unique_ptr<ParsedExpression>> count_children;
-	count_children.push_back(std::move(edge_src_colref));
-	auto count_function = make_uniq<FunctionExpression>("count", std::move(count_children));
-	count_function->alias = "cnt";
-	inner_select_node->select_list.emplace_back(std::move(count_function));
+	sum_children.push_back(make_uniq<FunctionExpression>("create_csr_degree", std::move(csr_degree_children)));
 
 	auto left_join_ref = make_uniq<JoinRef>(JoinRefType::REGULAR);
 	left_join_ref->type = JoinType::LEFT;
 	left_join_ref->left = edge_table->source_pg_table->CreateBaseTableRef(prev_binding);
 	left_join_ref->right = edge_table->CreateBaseTableRef(edge_table->table_name_alias);
-
-	auto join_condition = make_uniq<ComparisonExpression>(
+	left_join_ref->condition = make_uniq<ComparisonExpression>(
 	    ExpressionType::COMPARE_EQUAL, make_uniq<ColumnRefExpression>(edge_table->source_fk[0], edge_table->table_name),
 	    make_uniq<ColumnRefExpression>(edge_table->source_pk[0], prev_binding));
-	left_join_ref->condition = std::move(join_condition);
-	inner_select_node->from_table = std::move(left_join_ref);
-
-	auto dense_id_colref = make_uniq<ColumnRefExpression>("dense_id");
-	inner_select_node->groups.group_expressions.push_back(std::move(dense_id_colref));
-	GroupingSet grouping_set = {0};
-	inner_select_node->groups.grouping_sets.push_back(grouping_set);
-
-	inner_select_statement->node = std::move(inner_select_node);
-
-	auto inner_from_subquery = make_uniq<SubqueryRef>(std::move(inner_select_statement), "sub");
-
-	auto cast_select_node = make_uniq<SelectNode>();
-	cast_select_node->from_table = std::move(inner_from_subquery);
-	cast_select_node->select_list.push_back(std::move(sum_function));
 
-	auto cast_select_stmt = make_uniq<SelectStatement>();
-	cast_select_stmt->node = std::move(cast_select_node);
-
-	auto cast_subquery_expr = make_uniq<SubqueryExpression>();
-	cast_subquery_expr->subquery = std::move(cast_select_stmt);
-	cast_subquery_expr->subquery_type = SubqueryType::SCALAR;
-
-	return cast_subquery_expr;
+	auto sum_select_node = make_uniq<SelectNode>();
+	sum_select_node->from_table = std::move(left_join_ref);
+	sum_select_node->select_list.push_back(make_uniq<FunctionExpression>("sum", std::move(sum_children)));
+	auto sum_select_statement = make_uniq<SelectStatement>();
+	sum_select_statement->node = std::move(sum_select_node);
+	auto result = make_uniq<SubqueryExpression>();
+	result->subquery = std::move(sum_select_statement);
+	result->subquery_type = SubqueryType::SCALAR;
+	return result;
 }
 
-// Helper function to create CSR Vertex Subquery
+// SELECT sum(create_csr_degree(0, <rowid bound>, dense_id)) FROM (SELECT src AS dense_id FROM undirected_edges_cte
+// UNION ALL SELECT dst FROM undirected_edges_cte WHERE src <> dst), every edge counts for both endpoints and a self
+// loop once
 unique_ptr<SubqueryExpression> CreateUndirectedCSRVertexSubquery(const shared_ptr<PropertyGraphTable> &edge_table,
                                                                  const string &binding) {
-	auto count_create_vertex_expr = GetCountTable(edge_table->source_pg_table, binding, edge_table->source_pk[0]);
-
-	vector<unique_ptr<ParsedExpression>> csr_vertex_children;
-	csr_vertex_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
-	csr_vertex_children.push_back(std::move(count_create_vertex_expr));
-	csr_vertex_children.push_back(make_uniq<ColumnRefExpression>("dense_id", "sub"));
-	csr_vertex_children.push_back(make_uniq<ColumnRefExpression>("cnt", "sub"));
-
-	auto create_vertex_function = make_uniq<FunctionExpression>("create_csr_vertex", std::move(csr_vertex_children));
+	vector<unique_ptr<ParsedExpression>> csr_degree_children;
+	csr_degree_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
+	csr_degree_children.push_back(GetRowidBound(edge_table->source_pg_table, binding));
+	csr_degree_children.push_back(make_uniq<ColumnRefExpression>("dense_id"));
 	vector<unique_ptr<ParsedExpression>> sum_children;
-	sum_children.push_back(std::move(create_vertex_function));
-	auto sum_function = make_uniq<FunctionExpression>("sum", std::move(sum_children));
-
-	vector<unique_ptr<ParsedExpression>> multiply_csr_vertex_children;
-	auto two_constant = make_uniq<ConstantExpression>(Value::INTEGER(2));
-	multiply_csr_vertex_children.push_back(std::move(two_constant));
-	multiply_csr_vertex_children.push_back(std::move(sum_function));
-
-	auto multiply_function = make_uniq<FunctionExpression>("multiply", std::move(multiply_csr_vertex_children));
-
-	auto inner_select_statement = make_uniq<SelectStatement>();
-	auto inner_select_node = make_uniq<SelectNode>();
-
-	auto dense_id_ref = make_uniq<ColumnRefExpression>("dense_id");
-
-	auto count_create_inner_expr = make_uniq<SubqueryExpression>();
-	count_create_inner_expr->subquery_type = SubqueryType::SCALAR;
-	auto outgoing_edges_ref = make_uniq<ColumnRefExpression>("outgoing_edges");
-	vector<unique_ptr<ParsedExpression>> inner_count_children;
-	inner_count_children.push_back(std::move(outgoing_edges_ref));
-	auto inner_count_function = make_uniq<FunctionExpression>("count", std::move(inner_count_children));
-	inner_count_function->alias = "cnt";
-
-	inner_select_node->select_list.push_back(std::move(dense_id_ref));
-	inner_select_node->select_list.push_back(std::move(inner_count_function));
-
-	auto dense_id_colref = make_uniq<ColumnRefExpression>("dense_id");
-	inner_select_node->groups.group_expressions.push_back(std::move(dense_id_colref));
-	GroupingSet grouping_set = {0};
-	inner_select_node->groups.grouping_sets.push_back(grouping_set);
-
-	unique_ptr<SelectNode> unique_edges_select_node, unique_edges_select_node_reverse;
-
-	SetupSelectNode(unique_edges_select_node, edge_table, false);
-	SetupSelectNode(unique_edges_select_node_reverse, edge_table, true);
-
-	auto union_all_node = make_uniq<SetOperationNode>();
-	union_all_node->setop_type = SetOperationType::UNION_BY_NAME;
-	union_all_node->children.push_back(std::move(unique_edges_select_node));
-	union_all_node->children.push_back(std::move(unique_edges_select_node_reverse));
-
-	auto subquery_select_statement = make_uniq<SelectStatement>();
-	subquery_select_statement->node = std::move(union_all_node);
-	auto unique_edges_subquery = make_uniq<SubqueryRef>(std::move(subquery_select_statement), "unique_edges");
-
-	inner_select_node->from_table = std::move(unique_edges_subquery);
-	inner_select_statement->node = std::move(inner_select_node);
-
-	auto inner_from_subquery = make_uniq<SubqueryRef>(std::move(inner_select_statement), "sub");
-
-	auto cast_select_node = make_uniq<SelectNode>();
-	cast_select_node->from_table = std::move(inner_from_subquery);
-	cast_select_node->select_list.push_back(std::move(multiply_function));
-
-	auto cast_select_stmt = make_uniq<SelectStatement>();
-	cast_select_stmt->node = std::move(cast_select_node);
-
-	auto cast_subquery_expr = make_uniq<SubqueryExpression>();
-	cast_subquery_expr->subquery = std::move(cast_select_stmt);
-	cast_subquery_expr->subquery_type = SubqueryType::SCALAR;
-
-	return cast_subquery_expr;
+	sum_children.push_back(make_uniq<FunctionExpression>("create_csr_degree", std::move(csr_degree_children)));
+
+	auto src_select_node = make_uniq<SelectNode>();
+	src_select_node->select_list.push_back(CreateColumnRefExpression("src", "", "dense_id"));
+	src_select_node->from_table = CreateBaseTableRef("undirected_edges_cte");
+	auto dst_select_node = make_uniq<SelectNode>();
+	dst_select_node->select_list.push_back(CreateColumnRefExpression("dst", "", "dense_id"));
+	dst_select_node->from_table = CreateBaseTableRef("undirected_edges_cte");
+	dst_select_node->where_clause =
+	    make_uniq<ComparisonExpression>(ExpressionType::COMPARE_NOTEQUAL, make_uniq<ColumnRefExpression>("src"),
+	                                    make_uniq<ColumnRefExpression>("dst"));
+	auto endpoints_node = make_uniq<SetOperationNode>();
+	endpoints_node->setop_type = SetOperationType::UNION;
+	endpoints_node->setop_all = true;
+	endpoints_node->children.push_back(std::move(src_select_node));
+	endpoints_node->children.push_back(std::move(dst_select_node));
+	auto endpoints_statement = make_uniq<SelectStatement>();
+	endpoints_statement->node = std::move(endpoints_node);
+
+	auto sum_select_node = make_uniq<SelectNode>();
+	sum_select_node->from_table = make_uniq<SubqueryRef>(std::move(endpoints_statement), "endpoints");
+	sum_select_node->select_list.push_back(make_uniq<FunctionExpression>("sum", std::move(sum_children)));
+	auto sum_select_statement = make_uniq<SelectStatement>();
+	sum_select_statement->node = std::move(sum_select_node);
+	auto result = make_uniq<SubqueryExpression>();
+	result->subquery = std::move(sum_select_statement);
+	result->subquery_type = SubqueryType::SCALAR;
+	return result;
 }
 
 // Helper function to create outer select edges node
@@ -402,16 +1016,48 @@ unique_ptr<CommonTableExpressionInfo> MakeEdgesCTE(const shared_ptr<PropertyGrap
 	return result;
 }
 
-// Function to create the CTE for the Undirected CSR
+// SELECT src, dst, any_value(edges) AS edge FROM (SELECT least(src, dst) AS src, greatest(src, dst) AS dst, edges
+// FROM edges_cte) GROUP BY src, dst, every pair of adjacent vertices once no matter the direction of its edges
+static unique_ptr<CommonTableExpressionInfo> MakeUndirectedEdgesCTE() {
+	auto pair_select_node = make_uniq<SelectNode>();
+	const char *bounds[] = {"least", "greatest"};
+	const char *aliases[] = {"src", "dst"};
+	for (idx_t i = 0; i < 2; i++) {
+		vector<unique_ptr<ParsedExpression>> bound_children;
+		bound_children.push_back(make_uniq<ColumnRefExpression>("src"));
+		bound_children.push_back(make_uniq<ColumnRefExpression>("dst"));
+		auto bound_function = make_uniq<FunctionExpression>(bounds[i], std::move(bound_children));
+		bound_function->alias = aliases[i];
+		pair_select_node->select_list.push_back(std::move(bound_function));
+	}
+	pair_select_node->select_list.push_back(make_uniq<ColumnRefExpression>("edges"));
+	pair_select_node->from_table = CreateBaseTableRef("edges_cte");
+	auto pair_select_statement = make_uniq<SelectStatement>();
+	pair_select_statement->node = std::move(pair_select_node);
+
+	auto select_node = CreateOuterSelectEdgesNode();
+	select_node->from_table = make_uniq<SubqueryRef>(std::move(pair_select_statement));
+	auto select_statement = make_uniq<SelectStatement>();
+	select_statement->node = std::move(select_node);
+	auto info = make_uniq<CommonTableExpressionInfo>();
+	info->query = std::move(select_statement);
+	return info;
+}
+
+// Function to create the CTE for the Undirected CSR. Every pair of adjacent vertices is read once and
+// create_csr_undirected_edge writes it into the adjacency lists of both, instead of joining the edges in both
+// directions and building from the union
 unique_ptr<CommonTableExpressionInfo> CreateUndirectedCSRCTE(const shared_ptr<PropertyGraphTable> &edge_table,
                                                              const unique_ptr<SelectNode> &select_node) {
 	if (select_node->cte_map.map.find("edges_cte") == select_node->cte_map.map.end()) {
 		select_node->cte_map.map["edges_cte"] = MakeEdgesCTE(edge_table);
 	}
+	if (select_node->cte_map.map.find("undirected_edges_cte") == select_node->cte_map.map.end()) {
+		select_node->cte_map.map["undirected_edges_cte"] = MakeUndirectedEdgesCTE();
+	}
 
 	auto csr_edge_id_constant = make_uniq<ConstantExpression>(Value::INTEGER(0));
-	auto count_create_edge_select =
-	    GetCountTable(edge_table->source_pg_table, edge_table->source_reference, edge_table->source_pk[0]);
+	auto count_create_edge_select = GetRowidBound(edge_table->source_pg_table, edge_table->source_reference);
 
 	auto count_edges_subquery = GetCountUndirectedEdgeTable();
 
@@ -432,38 +1078,10 @@ unique_ptr<CommonTableExpressionInfo> CreateUndirectedCSRCTE(const shared_ptr<Pr
 	csr_edge_children.push_back(std::move(dst_rowid_colref));
 	csr_edge_children.push_back(std::move(edge_rowid_colref));
 
-	auto create_csr_edge_function = make_uniq<FunctionExpression>("create_csr_edge", std::move(csr_edge_children));
+	auto create_csr_edge_function =
+	    make_uniq<FunctionExpression>("create_csr_undirected_edge", std::move(csr_edge_children));
 	auto outer_select_node = CreateOuterSelectNode(std::move(create_csr_edge_function));
-
-	auto outer_select_edges_node = CreateOuterSelectEdgesNode();
-
-	auto outer_union_all_node = make_uniq<SetOperationNode>();
-	outer_union_all_node->setop_all = true;
-	outer_union_all_node->setop_type = SetOperationType::UNION;
-
-	auto src_dst_select_node = make_uniq<SelectNode>();
-
-	src_dst_select_node->from_table = std::move(CreateBaseTableRef("edges_cte"));
-	src_dst_select_node->select_list.push_back(make_uniq<ColumnRefExpression>("src"));
-	src_dst_select_node->select_list.push_back(make_uniq<ColumnRefExpression>("dst"));
-	src_dst_select_node->select_list.push_back(make_uniq<ColumnRefExpression>("edges"));
-
-	auto dst_src_select_node = make_uniq<SelectNode>();
-	dst_src_select_node->from_table = std::move(CreateBaseTableRef("edges_cte"));
-	dst_src_select_node->select_list.push_back(make_uniq<ColumnRefExpression>("dst"));
-	dst_src_select_node->select_list.push_back(make_uniq<ColumnRefExpression>("src"));
-	dst_src_select_node->select_list.push_back(make_uniq<ColumnRefExpression>("edges"));
-
-	outer_union_all_node->children.push_back(std::move(src_dst_select_node));
-	outer_union_all_node->children.push_back(std::move(dst_src_select_node));
-
-	auto outer_union_select_statement = make_uniq<SelectStatement>();
-	outer_union_select_statement->node = std::move(outer_union_all_node);
-	outer_select_edges_node->from_table = make_uniq<SubqueryRef>(std::move(outer_union_select_statement));
-
-	auto outer_select_edges_select_statement = make_uniq<SelectStatement>();
-	outer_select_edges_select_statement->node = std::move(outer_select_edges_node);
-	outer_select_node->from_table = make_uniq<SubqueryRef>(std::move(outer_select_edges_select_statement));
+	outer_select_node->from_table = CreateBaseTableRef("undirected_edges_cte");
 
 	auto outer_select_statement = make_uniq<SelectStatement>();
 	outer_select_statement->node = std::move(outer_select_node);
@@ -472,6 +1090,8 @@ unique_ptr<CommonTableExpressionInfo> CreateUndirectedCSRCTE(const shared_ptr<Pr
 	return info;
 }
 
+// SELECT 2 * count(*) - count_if(src = dst) FROM undirected_edges_cte, the number of adjacency entries of the
+// undirected CSR
 unique_ptr<SubqueryExpression> GetCountUndirectedEdgeTable() {
 	auto count_edges_select_statement = make_uniq<SelectStatement>();
 	auto count_edges_select_node = make_uniq<SelectNode>();
@@ -482,29 +1102,17 @@ unique_ptr<SubqueryExpression> GetCountUndirectedEdgeTable() {
 	multiply_children.push_back(std::move(constant_two));
 	multiply_children.push_back(std::move(count_function));
 	auto multiply_function = make_uniq<FunctionExpression>("multiply", std::move(multiply_children));
-	count_edges_select_node->select_list.emplace_back(std::move(multiply_function));
-
-	auto inner_select_statement = make_uniq<SelectStatement>();
-
-	auto src_dst_select_node = make_uniq<SelectNode>();
-	src_dst_select_node->select_list.emplace_back(CreateColumnRefExpression("src"));
-	src_dst_select_node->select_list.emplace_back(CreateColumnRefExpression("dst"));
-
-	src_dst_select_node->from_table = std::move(CreateBaseTableRef("edges_cte"));
 
-	auto dst_src_select_node = make_uniq<SelectNode>();
-	dst_src_select_node->select_list.emplace_back(CreateColumnRefExpression("dst", "", "src"));
-	dst_src_select_node->select_list.emplace_back(CreateColumnRefExpression("src", "", "dst"));
-	dst_src_select_node->from_table = CreateBaseTableRef("edges_cte");
+	vector<unique_ptr<ParsedExpression>> count_if_children;
+	count_if_children.push_back(make_uniq<ComparisonExpression>(
+	    ExpressionType::COMPARE_EQUAL, make_uniq<ColumnRefExpression>("src"), make_uniq<ColumnRefExpression>("dst")));
+	vector<unique_ptr<ParsedExpression>> subtract_children;
+	subtract_children.push_back(std::move(multiply_function));
+	subtract_children.push_back(make_uniq<FunctionExpression>("count_if", std::move(count_if_children)));
+	count_edges_select_node->select_list.emplace_back(
+	    make_uniq<FunctionExpression>("subtract", std::move(subtract_children)));
 
-	auto union_by_name_node = make_uniq<SetOperationNode>();
-	union_by_name_node->setop_all = false;
-	union_by_name_node->setop_type = SetOperationType::UNION_BY_NAME;
-	union_by_name_node->children.push_back(std::move(src_dst_select_node));
-	union_by_name_node->children.push_back(std::move(dst_src_select_node));
-	inner_select_statement->node = std::move(union_by_name_node);
-	auto inner_from_subquery = make_uniq<SubqueryRef>(std::move(inner_select_statement));
-	count_edges_select_node->from_table = std::move(inner_from_subquery);
+	count_edges_select_node->from_table = CreateBaseTableRef("undirected_edges_cte");
 	count_edges_select_statement->node = std::move(count_edges_select_node);
 	auto result = make_uniq<SubqueryExpression>();
 	result->subquery = std::move(count_edges_select_statement);
@@ -545,7 +1153,7 @@ unique_ptr<CommonTableExpressionInfo> CreateDirectedCSRCTE(const shared_ptr<Prop
                                                            const string &prev_binding, const string &edge_binding,
                                                            const string &next_binding) {
 	auto csr_edge_id_constant = make_uniq<ConstantExpression>(Value::INTEGER(0));
-	auto count_create_edge_select = GetCountTable(edge_table->source_pg_table, prev_binding, edge_table->source_pk[0]);
+	auto count_create_edge_select = GetRowidBound(edge_table->source_pg_table, prev_binding);
 
 	auto cast_subquery_expr = CreateDirectedCSRVertexSubquery(edge_table, prev_binding);
 	auto count_edge_table = GetCountEdgeTable(edge_table); // Count the number of edges
@@ -578,6 +1186,172 @@ unique_ptr<CommonTableExpressionInfo> CreateDirectedCSRCTE(const shared_ptr<Prop
 	return info;
 }
 
+unique_ptr<CommonTableExpressionInfo> CreateUndirectedCSRCTE(ClientContext &context, const string &pg_name,
+                                                             const shared_ptr<PropertyGraphTable> &edge_table,
+                                                             const unique_ptr<SelectNode> &select_node) {
+	auto duckpgq_state = GetDuckPGQState(context);
+	if (duckpgq_state->UseCachedCSR(context, pg_name, edge_table->main_label, false, "", 0)) {
+		return CreateCachedCSRCTE();
+	}
+	duckpgq_state->CacheCSROnQueryEnd(context, pg_name, edge_table->main_label, false, "", 0);
+	return CreateUndirectedCSRCTE(edge_table, select_node);
+}
+
+unique_ptr<CommonTableExpressionInfo> CreateDirectedCSRCTE(ClientContext &context, const string &pg_name,
+                                                           const shared_ptr<PropertyGraphTable> &edge_table,
+                                                           const string &prev_binding, const string &edge_binding,
+                                                           const string &next_binding) {
+	auto duckpgq_state = GetDuckPGQState(context);
+	duckpgq_state->RefreshCachedCSR(context, pg_name, edge_table);
+	if (duckpgq_state->UseCachedCSR(context, pg_name, edge_table->main_label, true, "", 0)) {
+		return CreateCachedCSRCTE();
+	}
+	duckpgq_state->CacheCSROnQueryEnd(context, pg_name, edge_table->main_label, true, "", 0);
+	return CreateDirectedCSRCTE(edge_table, prev_binding, edge_binding, next_binding);
+}
+
+unique_ptr<CommonTableExpressionInfo> CreateReverseCSRCTE(unique_ptr<CommonTableExpressionInfo> forward) {
+	vector<unique_ptr<ParsedExpression>> count_children;
+	count_children.push_back(make_uniq<ColumnRefExpression>("temp", "__forward"));
+	vector<unique_ptr<ParsedExpression>> reverse_children;
+	reverse_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
+	reverse_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(REVERSE_CSR_ID)));
+	reverse_children.push_back(make_uniq<FunctionExpression>("count", std::move(count_children)));
+	auto select_node =
+	    CreateOuterSelectNode(make_uniq<FunctionExpression>("create_csr_reverse", std::move(reverse_children)));
+	select_node->from_table = make_uniq<SubqueryRef>(std::move(forward->query), "__forward");
+	auto select_statement = make_uniq<SelectStatement>();
+	select_statement->node = std::move(select_node);
+	auto info = make_uniq<CommonTableExpressionInfo>();
+	info->query = std::move(select_statement);
+	return info;
+}
+
+// SELECT src.rowid AS src, dst.rowid AS dst, e.rowid AS edge, <label>::UTINYINT AS edge_label FROM <edge table> e
+// ... for every edge table, combined with UNION ALL
+static unique_ptr<SelectStatement>
+CreateLabeledEdgesStatement(const vector<shared_ptr<PropertyGraphTable>> &edge_tables) {
+	auto union_node = make_uniq<SetOperationNode>();
+	union_node->setop_type = SetOperationType::UNION;
+	union_node->setop_all = true;
+	for (idx_t label = 0; label < edge_tables.size(); label++) {
+		auto edges_node = make_uniq<SelectNode>();
+		edges_node->select_list.push_back(CreateColumnRefExpression("rowid", "__src", "src"));
+		edges_node->select_list.push_back(CreateColumnRefExpression("rowid", "__dst", "dst"));
+		edges_node->select_list.push_back(CreateColumnRefExpression("rowid", "__e", "edge"));
+		auto label_constant = make_uniq<ConstantExpression>(Value::UTINYINT(static_cast<uint8_t>(label)));
+		label_constant->alias = "edge_label";
+		edges_node->select_list.push_back(std::move(label_constant));
+		edges_node->from_table = GetJoinRef(edge_tables[label], "__e", "__src", "__dst");
+		union_node->children.push_back(std::move(edges_node));
+	}
+	auto result = make_uniq<SelectStatement>();
+	if (union_node->children.size() == 1) {
+		result->node = std::move(union_node->children[0]);
+	} else {
+		result->node = std::move(union_node);
+	}
+	return result;
+}
+
+// SELECT sum(create_csr_degree(0, <rowid bound>, v.rowid, labeled_edges_cte.src)) FROM <vertex table> v
+// LEFT JOIN labeled_edges_cte ON ...
+static unique_ptr<SubqueryExpression>
+CreateLabeledCSRVertexSubquery(const shared_ptr<PropertyGraphTable> &vertex_table) {
+	vector<unique_ptr<ParsedExpression>> csr_degree_children;
+	csr_degree_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
+	csr_degree_children.push_back(GetRowidBound(vertex_table, "__v"));
+	csr_degree_children.push_back(make_uniq<ColumnRefExpression>("rowid", "__v"));
+	csr_degree_children.push_back(make_uniq<ColumnRefExpression>("src", "labeled_edges_cte"));
+	vector<unique_ptr<ParsedExpression>> sum_children;
+	sum_children.push_back(make_uniq<FunctionExpression>("create_csr_degree", std::move(csr_degree_children)));
+
+	auto left_join_ref = make_uniq<JoinRef>(JoinRefType::REGULAR);
+	left_join_ref->type = JoinType::LEFT;
+	left_join_ref->left = vertex_table->CreateBaseTableRef("__v");
+	left_join_ref->right = CreateBaseTableRef("labeled_edges_cte");
+	left_join_ref->condition = make_uniq<ComparisonExpression>(
+	    ExpressionType::COMPARE_EQUAL, make_uniq<ColumnRefExpression>("src", "labeled_edges_cte"),
+	    make_uniq<ColumnRefExpression>("rowid", "__v"));
+
+	auto sum_select_node = make_uniq<SelectNode>();
+	sum_select_node->from_table = std::move(left_join_ref);
+	sum_select_node->select_list.push_back(make_uniq<FunctionExpression>("sum", std::move(sum_children)));
+	auto sum_select_statement = make_uniq<SelectStatement>();
+	sum_select_statement->node = std::move(sum_select_node);
+	auto result = make_uniq<SubqueryExpression>();
+	result->subquery = std::move(sum_select_statement);
+	result->subquery_type = SubqueryType::SCALAR;
+	return result;
+}
+
+unique_ptr<CommonTableExpressionInfo> CreateLabeledCSRCTE(ClientContext &context, const string &pg_name,
+                                                          const shared_ptr<PropertyGraphTable> &vertex_table,
+                                                          const vector<shared_ptr<PropertyGraphTable>> &edge_tables,
+                                                          const unique_ptr<SelectNode> &select_node) {
+	D_ASSERT(!edge_tables.empty() && edge_tables.size() <= CSR_LABEL_LIMIT);
+	vector<string> labels;
+	for (auto &edge_table : edge_tables) {
+		labels.push_back(edge_table->main_label);
+	}
+	auto cache_label = StringUtil::Join(labels, "|");
+	auto duckpgq_state = GetDuckPGQState(context);
+	if (duckpgq_state->UseCachedCSR(context, pg_name, cache_label, true, "", 0)) {
+		return CreateCachedCSRCTE();
+	}
+	duckpgq_state->CacheCSROnQueryEnd(context, pg_name, cache_label, true, "", 0);
+	if (select_node->cte_map.map.find("labeled_edges_cte") == select_node->cte_map.map.end()) {
+		auto edges_info = make_uniq<CommonTableExpressionInfo>();
+		edges_info->query = CreateLabeledEdgesStatement(edge_tables);
+		select_node->cte_map.map["labeled_edges_cte"] = std::move(edges_info);
+	}
+
+	// The number of edges is the sum of the degrees, vertices an edge refers to that do not exist drop the edge
+	auto count_select_node = make_uniq<SelectNode>();
+	count_select_node->from_table = CreateBaseTableRef("labeled_edges_cte");
+	vector<unique_ptr<ParsedExpression>> count_children;
+	count_select_node->select_list.push_back(make_uniq<FunctionExpression>("count", std::move(count_children)));
+	auto count_select_statement = make_uniq<SelectStatement>();
+	count_select_statement->node = std::move(count_select_node);
+	auto count_edges_subquery = make_uniq<SubqueryExpression>();
+	count_edges_subquery->subquery = std::move(count_select_statement);
+	count_edges_subquery->subquery_type = SubqueryType::SCALAR;
+
+	vector<unique_ptr<ParsedExpression>> csr_edge_children;
+	csr_edge_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
+	csr_edge_children.push_back(GetRowidBound(vertex_table, "__v"));
+	csr_edge_children.push_back(
+	    make_uniq<CastExpression>(LogicalType::BIGINT, CreateLabeledCSRVertexSubquery(vertex_table)));
+	csr_edge_children.push_back(std::move(count_edges_subquery));
+	csr_edge_children.push_back(make_uniq<ColumnRefExpression>("src"));
+	csr_edge_children.push_back(make_uniq<ColumnRefExpression>("dst"));
+	csr_edge_children.push_back(make_uniq<ColumnRefExpression>("edge"));
+	csr_edge_children.push_back(make_uniq<ColumnRefExpression>("edge_label"));
+	auto outer_select_node =
+	    CreateOuterSelectNode(make_uniq<FunctionExpression>("create_csr_edge", std::move(csr_edge_children)));
+	outer_select_node->from_table = CreateBaseTableRef("labeled_edges_cte");
+
+	auto outer_select_statement = make_uniq<SelectStatement>();
+	outer_select_statement->node = std::move(outer_select_node);
+	auto info = make_uniq<CommonTableExpressionInfo>();
+	info->query = std::move(outer_select_statement);
+	return info;
+}
+
+// The CSR is already present in the csr_list, so the CTE only has to produce
+// SELECT 0::INTEGER AS temp
+unique_ptr<CommonTableExpressionInfo> CreateCachedCSRCTE() {
+	auto select_node = make_uniq<SelectNode>();
+	auto zero = make_uniq<ConstantExpression>(Value::INTEGER(0));
+	zero->alias = "temp";
+	select_node->select_list.push_back(std::move(zero));
+	auto select_statement = make_uniq<SelectStatement>();
+	select_statement->node = std::move(select_node);
+	auto info = make_uniq<CommonTableExpressionInfo>();
+	info->query = std::move(select_statement);
+	return info;
+}
+
 // Function to create a subquery for counting with CTE
 unique_ptr<SubqueryRef> CreateCountCTESubquery() {
 	auto temp_cte_select_node = make_uniq<SelectNode>();
@@ -0,0 +1,110 @@
+#include "duckpgq/core/utils/csr_arrow_export.hpp"
+
+namespace duckdb {
+
+// v is exported as the int64 array it is stored as, one atomic per offset
+static_assert(sizeof(atomic<int64_t>) == sizeof(int64_t), "atomic<int64_t> must have the layout of int64_t");
+
+//! The private data of an exported ArrowArray, the CSR stays alive until the consumer releases the array
+struct CSRArrowArrayData {
+	explicit CSRArrowArrayData(shared_ptr<CSR> csr_p) : csr(std::move(csr_p)) {
+		csr->arrow_exports++;
+	}
+	~CSRArrowArrayData() {
+		csr->arrow_exports--;
+	}
+
+	shared_ptr<CSR> csr;
+	//! The validity buffer, always nullptr since the arrays have no NULLs, and the data buffer
+	const void *buffers[2];
+};
+
+static void ReleaseCSRArrowArray(ArrowArray *array) {
+	if (!array || !array->release) {
+		return;
+	}
+	delete reinterpret_cast<CSRArrowArrayData *>(array->private_data);
+	array->release = nullptr;
+}
+
+static void ReleaseCSRArrowSchema(ArrowSchema *schema) {
+	if (!schema || !schema->release) {
+		return;
+	}
+	delete reinterpret_cast<string *>(schema->private_data);
+	schema->release = nullptr;
+}
+
+//! Appends the array [name] of [length] values of the Arrow [format] at [data] to [result]
+static void AddCSRArrowArray(vector<CSRArrowArray> &result, const string &name, const char *format, const void *data,
+                             idx_t length) {
+	CSRArrowArray array;
+	array.name = name;
+	array.format = format;
+	array.data = data;
+	array.length = length;
+	result.push_back(std::move(array));
+}
+
+vector<CSRArrowArray> GetCSRArrowArrays(ClientContext &context, const shared_ptr<CSR> &csr) {
+	if (!csr->IsComplete()) {
+		throw InvalidInputException("The CSR cannot be exported before all its edges are inserted");
+	}
+	csr->LoadPartitions(context);
+	if (csr->delta) {
+		csr->ReserveMemory(context, csr->MergeMemoryUsage());
+		csr->MergeDelta();
+	}
+	auto edge_count = csr->EdgeCount();
+	vector<CSRArrowArray> result;
+	AddCSRArrowArray(result, "v", "l", csr->v.get(), csr->vsize - 1);
+	if (csr->compact) {
+		AddCSRArrowArray(result, "e", "i", csr->e_compact.data(), edge_count);
+	} else {
+		AddCSRArrowArray(result, "e", "l", csr->e.data(), edge_count);
+	}
+	if (csr->edge_ids.size() >= edge_count) {
+		AddCSRArrowArray(result, "edge_ids", "l", csr->edge_ids.data(), edge_count);
+	}
+	if (!csr->w.empty()) {
+		AddCSRArrowArray(result, "w", "l", csr->w.data(), edge_count);
+	} else if (!csr->w_double.empty()) {
+		AddCSRArrowArray(result, "w", "g", csr->w_double.data(), edge_count);
+	}
+	if (csr->IsRelabeled()) {
+		AddCSRArrowArray(result, "external_id", "l", csr->external_id.data(), csr->external_id.size());
+	}
+	return result;
+}
+
+void ExportCSRArrowArray(const shared_ptr<CSR> &csr, const CSRArrowArray &array, ArrowArray *out_array,
+                         ArrowSchema *out_schema) {
+	// Arrow expects a valid data buffer even for an empty array
+	static const int64_t EMPTY_BUFFER = 0;
+	auto array_data = new CSRArrowArrayData(csr);
+	array_data->buffers[0] = nullptr;
+	array_data->buffers[1] = array.data ? array.data : &EMPTY_BUFFER;
+	out_array->length = static_cast<int64_t>(array.length);
+	out_array->null_count = 0;
+	out_array->offset = 0;
+	out_array->n_buffers = 2;
+	out_array->n_children = 0;
+	out_array->buffers = array_data->buffers;
+	out_array->children = nullptr;
+	out_array->dictionary = nullptr;
+	out_array->private_data = array_data;
+	out_array->release = ReleaseCSRArrowArray;
+
+	auto schema_name = new string(array.name);
+	out_schema->format = array.format;
+	out_schema->name = schema_name->c_str();
+	out_schema->metadata = nullptr;
+	out_schema->flags = 0;
+	out_schema->n_children = 0;
+	out_schema->children = nullptr;
+	out_schema->dictionary = nullptr;
+	out_schema->private_data = schema_name;
+	out_schema->release = ReleaseCSRArrowSchema;
+}
+
+} // namespace duckdb
@@ -0,0 +1,66 @@
+#include "duckpgq/core/utils/csr_blocks.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+CSRBlocks::CSRBlocks(const CSRRanges &ranges, idx_t vertex_count, idx_t block_edges_p)
+    : block_edges(MaxValue<idx_t>(block_edges_p, 1)) {
+	auto limit = static_cast<int64_t>(block_edges);
+	CSRBlock current;
+	int64_t current_edges = 0;
+	for (int64_t i = 0; i < static_cast<int64_t>(vertex_count); i++) {
+		auto degree = ranges.end[i] - ranges.begin[i];
+		if (degree > limit) {
+			if (current.vertex_end > current.vertex_begin) {
+				blocks.push_back(current);
+			}
+			CSRHub hub {i, blocks.size(), 0};
+			for (auto offset = ranges.begin[i]; offset < ranges.end[i]; offset += limit) {
+				CSRBlock slice;
+				slice.vertex_begin = i;
+				slice.vertex_end = i + 1;
+				slice.offset_begin = offset;
+				slice.offset_end = MinValue<int64_t>(offset + limit, ranges.end[i]);
+				blocks.push_back(slice);
+			}
+			hub.block_end = blocks.size();
+			hubs.push_back(hub);
+			current = CSRBlock();
+			current.vertex_begin = i + 1;
+			current.vertex_end = i + 1;
+			current_edges = 0;
+			continue;
+		}
+		// Every vertex costs a little even without edges, so that blocks of empty lists stay bounded too
+		current.vertex_end = i + 1;
+		current_edges += degree + 1;
+		if (current_edges >= limit) {
+			blocks.push_back(current);
+			current = CSRBlock();
+			current.vertex_begin = i + 1;
+			current.vertex_end = i + 1;
+			current_edges = 0;
+		}
+	}
+	if (current.vertex_end > current.vertex_begin) {
+		blocks.push_back(current);
+	}
+}
+
+const CSRHub *CSRBlocks::FindHub(int64_t vertex) const {
+	auto entry = std::lower_bound(hubs.begin(), hubs.end(), vertex,
+	                              [](const CSRHub &hub, int64_t value) { return hub.vertex < value; });
+	if (entry == hubs.end() || entry->vertex != vertex) {
+		return nullptr;
+	}
+	return &*entry;
+}
+
+idx_t CSRBlockEdges(ClientContext &context, idx_t edge_count) {
+	auto threads = MaxValue<idx_t>(static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads()), 1);
+	return MaxValue<idx_t>(CSR_BLOCK_MIN_EDGES, (edge_count + threads * 4 - 1) / (threads * 4));
+}
+
+} // namespace duckdb
@@ -0,0 +1,148 @@
+#include "duckpgq/core/utils/csr_degree_summary.hpp"
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
+
+namespace duckdb {
+
+//! Degrees below 2^EXACT_BITS have a bucket of their own, every further power of two is split into 64 buckets
+static constexpr idx_t EXACT_BITS = 7;
+static constexpr idx_t SUB_BUCKETS = idx_t(1) << (EXACT_BITS - 1);
+static constexpr idx_t SKETCH_BUCKET_COUNT = SUB_BUCKETS * (64 - EXACT_BITS + 2);
+//! Vertices per task of the degree pass
+static constexpr idx_t DEGREE_SUMMARY_PARTITION_SIZE = 65536;
+
+DegreeSketch::DegreeSketch() : buckets(SKETCH_BUCKET_COUNT, 0) {
+}
+
+idx_t DegreeSketch::BucketOf(idx_t degree) {
+	if (degree < (idx_t(1) << EXACT_BITS)) {
+		return degree;
+	}
+	// The shift keeps the EXACT_BITS leading bits, whose value lies in [SUB_BUCKETS, 2 * SUB_BUCKETS)
+	auto shift = (63 - static_cast<idx_t>(__builtin_clzll(degree))) - (EXACT_BITS - 1);
+	return SUB_BUCKETS * shift + (degree >> shift);
+}
+
+idx_t DegreeSketch::LowerBound(idx_t bucket) {
+	if (bucket < (idx_t(1) << EXACT_BITS)) {
+		return bucket;
+	}
+	auto shift = bucket / SUB_BUCKETS - 1;
+	return (bucket - SUB_BUCKETS * shift) << shift;
+}
+
+void DegreeSketch::Merge(const DegreeSketch &other) {
+	for (idx_t i = 0; i < buckets.size(); i++) {
+		buckets[i] += other.buckets[i];
+	}
+	count += other.count;
+}
+
+idx_t DegreeSketch::Quantile(double q) const {
+	if (count == 0) {
+		return 0;
+	}
+	auto rank = static_cast<idx_t>(static_cast<double>(count - 1) * q);
+	idx_t seen = 0;
+	for (idx_t i = 0; i < buckets.size(); i++) {
+		seen += buckets[i];
+		if (seen > rank) {
+			return LowerBound(i);
+		}
+	}
+	return LowerBound(buckets.size() - 1);
+}
+
+//! The running totals of one task of the degree pass
+struct DegreeAccumulator {
+	DegreeSketch sketch;
+	idx_t min = NumericLimits<idx_t>::Maximum();
+	idx_t max = 0;
+	idx_t sum = 0;
+
+	void Add(idx_t degree) {
+		if (degree == 0) {
+			return;
+		}
+		sketch.Add(degree);
+		min = MinValue<idx_t>(min, degree);
+		max = MaxValue<idx_t>(max, degree);
+		sum += degree;
+	}
+	void Merge(const DegreeAccumulator &other) {
+		sketch.Merge(other.sketch);
+		min = MinValue<idx_t>(min, other.min);
+		max = MaxValue<idx_t>(max, other.max);
+		sum += other.sum;
+	}
+	CSRDegreeSummary Summary() const {
+		CSRDegreeSummary result;
+		result.vertex_count = sketch.Count();
+		if (result.vertex_count == 0) {
+			return result;
+		}
+		result.min = min;
+		result.max = max;
+		result.average = static_cast<double>(sum) / static_cast<double>(result.vertex_count);
+		// The quantiles cannot leave the range of the degrees, which the sketch only knows up to its buckets
+		result.q25 = MaxValue<idx_t>(sketch.Quantile(0.25), min);
+		result.q50 = MaxValue<idx_t>(sketch.Quantile(0.5), min);
+		result.q75 = MaxValue<idx_t>(sketch.Quantile(0.75), min);
+		return result;
+	}
+};
+
+//! Summarizes the lengths of the first [vertex_count] lists of [ranges] on the TaskScheduler threads. Every task adds
+//! its vertices to a sketch of its own, which are merged once the task is done.
+static CSRDegreeSummary SummarizeListLengths(ClientContext &context, const CSRRanges &ranges, idx_t vertex_count) {
+	DegreeAccumulator result;
+	mutex lock;
+	ParallelFor(context, vertex_count, DEGREE_SUMMARY_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		DegreeAccumulator local;
+		for (auto i = begin; i < end; i++) {
+			local.Add(static_cast<idx_t>(ranges.end[i] - ranges.begin[i]));
+		}
+		lock_guard<mutex> guard(lock);
+		result.Merge(local);
+	});
+	return result.Summary();
+}
+
+template <class ID_T>
+static void CountInDegrees(CSR &csr, vector<idx_t> &in_degrees) {
+	auto ranges = csr.GetRanges();
+	auto &e = csr.GetNeighbors<ID_T>();
+	for (idx_t i = 0; i < csr.VertexCount(); i++) {
+		for (auto offset = ranges.begin[i]; offset < ranges.end[i]; offset++) {
+			auto neighbor = static_cast<idx_t>(e[offset]);
+			if (neighbor >= in_degrees.size()) {
+				in_degrees.resize(neighbor + 1, 0);
+			}
+			in_degrees[neighbor]++;
+		}
+	}
+}
+
+void SummarizeCSRDegrees(ClientContext &context, CSR &csr, bool same_vertex_table, CSRDegreeSummary &out_degrees,
+                         CSRDegreeSummary &in_degrees) {
+	// The out-degrees are in v, the lists of a partitioned CSR are only loaded for the in-degrees
+	out_degrees = SummarizeListLengths(context, csr.GetRanges(), csr.VertexCount());
+	if (same_vertex_table) {
+		auto &reverse = csr.GetReverse(context);
+		in_degrees = SummarizeListLengths(context, reverse.GetRanges(), reverse.VertexCount());
+		return;
+	}
+	csr.LoadPartitions(context);
+	vector<idx_t> counts;
+	if (csr.compact) {
+		CountInDegrees<int32_t>(csr, counts);
+	} else {
+		CountInDegrees<int64_t>(csr, counts);
+	}
+	DegreeAccumulator accumulator;
+	for (auto in_degree : counts) {
+		accumulator.Add(in_degree);
+	}
+	in_degrees = accumulator.Summary();
+}
+
+} // namespace duckdb
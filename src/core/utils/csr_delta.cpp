@@ -0,0 +1,180 @@
+#include "duckpgq/core/utils/csr_delta.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+//! A row of the edge table that is not in the base arrays with the same endpoints
+struct CSRDeltaEdge {
+	int64_t src;
+	int64_t dst;
+	int64_t edge_id;
+
+	bool operator<(const CSRDeltaEdge &other) const {
+		if (src != other.src) {
+			return src < other.src;
+		}
+		return dst < other.dst || (dst == other.dst && edge_id < other.edge_id);
+	}
+};
+
+static string KeyHash(const string &column) {
+	return "hash(CAST(" + KeywordHelper::WriteOptionallyQuoted(column) + " AS VARCHAR))";
+}
+
+//! Runs [query] and calls [row] with the flattened columns of every chunk, returns false if the query failed
+template <class FUNC>
+static bool ScanQuery(Connection &connection, const string &query, FUNC row) {
+	auto result = connection.Query(query);
+	if (result->HasError()) {
+		return false;
+	}
+	while (auto chunk = result->Fetch()) {
+		chunk->Flatten();
+		for (idx_t i = 0; i < chunk->size(); i++) {
+			row(*chunk, i);
+		}
+	}
+	return true;
+}
+
+template <class ID_T>
+static int64_t NeighborAt(CSR &csr, int64_t offset) {
+	return static_cast<int64_t>(csr.GetNeighbors<ID_T>()[offset]);
+}
+
+bool RefreshCSRDelta(ClientContext &context, const shared_ptr<PropertyGraphTable> &edge_table, CSR &csr) {
+	D_ASSERT(csr.w.empty() && csr.w_double.empty());
+	// The delta rewrites adjacency lists into e and reads rowids, partitioned and relabeled CSRs are rebuilt instead
+	if (csr.GetPartitions() || csr.IsRelabeled() || edge_table->source_pg_table != edge_table->destination_pg_table ||
+	    edge_table->source_pk[0] != edge_table->destination_pk[0]) {
+		return false;
+	}
+	Connection connection(*context.db);
+	auto base_vertex_count = static_cast<int64_t>(csr.vsize - 2);
+	auto v = reinterpret_cast<const int64_t *>(csr.v.get());
+	auto base_edge_count = csr.delta ? csr.delta->base_edge_count : static_cast<idx_t>(v[base_vertex_count]);
+
+	// The vertex ids of the CSR are the rowids of the vertex table. Deleted rows leave ids without edges, the ids of
+	// the CSR are compared with the current rowids of both endpoints, so rowids that moved are caught as well.
+	auto &vertex_key = edge_table->source_pk[0];
+	auto vertex_table = edge_table->source_pg_table->CreateBaseTableRef()->ToString();
+	unordered_map<uint64_t, int64_t> vertex_of_key;
+	int64_t max_rowid = -1;
+	bool unique_keys = true;
+	auto scanned = ScanQuery(connection,
+	                         "SELECT rowid, " + KeyHash(vertex_key) + " FROM " + vertex_table + " WHERE " +
+	                             KeywordHelper::WriteOptionallyQuoted(vertex_key) + " IS NOT NULL",
+	                         [&](DataChunk &chunk, idx_t i) {
+		                         auto rowid = FlatVector::GetData<int64_t>(chunk.data[0])[i];
+		                         auto key = FlatVector::GetData<uint64_t>(chunk.data[1])[i];
+		                         unique_keys &= vertex_of_key.emplace(key, rowid).second;
+		                         max_rowid = MaxValue<int64_t>(max_rowid, rowid);
+	                         });
+	auto vertex_count = max_rowid + 1;
+	if (!scanned || !unique_keys || vertex_count < base_vertex_count ||
+	    (csr.compact && vertex_count > NumericLimits<int32_t>::Maximum())) {
+		return false;
+	}
+
+	// Position of every edge row in the base arrays
+	int64_t max_edge_id = -1;
+	for (idx_t offset = 0; offset < base_edge_count; offset++) {
+		max_edge_id = MaxValue<int64_t>(max_edge_id, csr.edge_ids[offset]);
+	}
+	vector<int64_t> offset_of_edge(max_edge_id + 1, -1);
+	for (idx_t offset = 0; offset < base_edge_count; offset++) {
+		offset_of_edge[csr.edge_ids[offset]] = static_cast<int64_t>(offset);
+	}
+	auto source_of = [&](int64_t offset) {
+		return static_cast<int64_t>(std::upper_bound(v, v + base_vertex_count, offset) - v) - 1;
+	};
+	auto neighbor_of = [&](int64_t offset) {
+		return csr.compact ? NeighborAt<int32_t>(csr, offset) : NeighborAt<int64_t>(csr, offset);
+	};
+
+	// Base edges whose row still exists with the same endpoints are kept, all other rows are inserted
+	vector<bool> kept(base_edge_count, false);
+	vector<CSRDeltaEdge> inserted;
+	auto edge_source = edge_table->source_fk[0];
+	auto edge_destination = edge_table->destination_fk[0];
+	scanned = ScanQuery(
+	    connection,
+	    "SELECT rowid, " + KeyHash(edge_source) + ", " + KeyHash(edge_destination) + " FROM " +
+	        edge_table->CreateBaseTableRef()->ToString() + " WHERE " +
+	        KeywordHelper::WriteOptionallyQuoted(edge_source) + " IS NOT NULL AND " +
+	        KeywordHelper::WriteOptionallyQuoted(edge_destination) + " IS NOT NULL",
+	    [&](DataChunk &chunk, idx_t i) {
+		    auto edge_id = FlatVector::GetData<int64_t>(chunk.data[0])[i];
+		    auto src = vertex_of_key.find(FlatVector::GetData<uint64_t>(chunk.data[1])[i]);
+		    auto dst = vertex_of_key.find(FlatVector::GetData<uint64_t>(chunk.data[2])[i]);
+		    // Rows without both endpoints are dropped by the join that builds the CSR as well
+		    if (src == vertex_of_key.end() || dst == vertex_of_key.end()) {
+			    return;
+		    }
+		    if (edge_id <= max_edge_id && offset_of_edge[edge_id] >= 0) {
+			    auto offset = offset_of_edge[edge_id];
+			    if (source_of(offset) == src->second && neighbor_of(offset) == dst->second) {
+				    kept[offset] = true;
+				    return;
+			    }
+		    }
+		    inserted.push_back({src->second, dst->second, edge_id});
+	    });
+	if (!scanned) {
+		return false;
+	}
+	std::sort(inserted.begin(), inserted.end());
+
+	// Rewrite the lists of the vertices that lost or gained an edge, in the order a sorted CSR keeps them in
+	vector<int64_t> vertices;
+	vector<idx_t> list_offsets(1, 0);
+	vector<int64_t> neighbors;
+	vector<int64_t> neighbor_edge_ids;
+	idx_t next_insert = 0;
+	for (int64_t vertex = 0; vertex < vertex_count; vertex++) {
+		auto insert_end = next_insert;
+		while (insert_end < inserted.size() && inserted[insert_end].src == vertex) {
+			insert_end++;
+		}
+		int64_t base_begin = vertex < base_vertex_count ? v[vertex] : 0;
+		int64_t base_end = vertex < base_vertex_count ? v[vertex + 1] : 0;
+		bool changed = insert_end > next_insert;
+		for (auto offset = base_begin; offset < base_end && !changed; offset++) {
+			changed = !kept[offset];
+		}
+		if (!changed) {
+			continue;
+		}
+		auto offset = base_begin;
+		while (offset < base_end || next_insert < insert_end) {
+			if (offset < base_end && !kept[offset]) {
+				offset++;
+				continue;
+			}
+			bool take_base = next_insert == insert_end;
+			if (offset < base_end && !take_base) {
+				auto base_neighbor = neighbor_of(offset);
+				auto &insert = inserted[next_insert];
+				take_base = !csr.sorted || base_neighbor < insert.dst ||
+				            (base_neighbor == insert.dst && csr.edge_ids[offset] < insert.edge_id);
+			}
+			if (offset < base_end && take_base) {
+				neighbors.push_back(neighbor_of(offset));
+				neighbor_edge_ids.push_back(csr.edge_ids[offset]);
+				offset++;
+			} else {
+				neighbors.push_back(inserted[next_insert].dst);
+				neighbor_edge_ids.push_back(inserted[next_insert].edge_id);
+				next_insert++;
+			}
+		}
+		vertices.push_back(vertex);
+		list_offsets.push_back(neighbors.size());
+	}
+	csr.ApplyDelta(context, static_cast<idx_t>(vertex_count), vertices, list_offsets, neighbors, neighbor_edge_ids);
+	return true;
+}
+
+} // namespace duckdb
@@ -0,0 +1,297 @@
+#include "duckpgq/core/utils/csr_distance_index.hpp"
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+//! A (rank, distance) pair of a label while the labeling is built
+struct DistanceLabelEntry {
+	uint32_t rank;
+	uint32_t distance;
+};
+
+//! Fills [distances] with the hop distance of every vertex from [source] over the lists of [ranges]
+template <class ID_T>
+static void BreadthFirstDistances(const CSRRanges &ranges, const vector<ID_T> &e, int64_t source, uint32_t *distances,
+                                  vector<int64_t> &queue) {
+	queue.clear();
+	queue.push_back(source);
+	distances[source] = 0;
+	for (idx_t head = 0; head < queue.size(); head++) {
+		auto vertex = queue[head];
+		auto next_distance = distances[vertex] + 1;
+		for (auto offset = ranges.begin[vertex]; offset < ranges.end[vertex]; offset++) {
+			auto neighbor = static_cast<int64_t>(e[offset]);
+			if (distances[neighbor] == DISTANCE_INDEX_UNREACHABLE) {
+				distances[neighbor] = next_distance;
+				queue.push_back(neighbor);
+			}
+		}
+	}
+}
+
+CSRDistanceIndex::CSRDistanceIndex(ClientContext &context, CSR &csr, bool exact_p, idx_t landmark_count)
+    : exact(exact_p), symmetric(csr.symmetric), vertex_count(csr.VertexCount()) {
+	if (vertex_count >= DISTANCE_INDEX_UNREACHABLE) {
+		throw InvalidInputException("A distance index supports graphs of fewer than 2^32 vertices");
+	}
+	auto ranges = csr.GetRanges();
+	vector<int64_t> degree(vertex_count);
+	for (idx_t i = 0; i < vertex_count; i++) {
+		degree[i] = ranges.end[i] - ranges.begin[i];
+	}
+	if (!symmetric) {
+		auto reverse_ranges = csr.GetReverse(context).GetRanges();
+		for (idx_t i = 0; i < vertex_count; i++) {
+			degree[i] += reverse_ranges.end[i] - reverse_ranges.begin[i];
+		}
+	}
+	// Hubs first, they lie on the most shortest paths and prune the later searches the most
+	vector<int64_t> order(vertex_count);
+	for (idx_t i = 0; i < vertex_count; i++) {
+		order[i] = static_cast<int64_t>(i);
+	}
+	std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) { return degree[a] > degree[b]; });
+	landmarks.assign(order.begin(), order.begin() + MinValue<idx_t>(landmark_count, vertex_count));
+
+	if (csr.compact) {
+		BuildLandmarks<int32_t>(context, csr);
+		if (exact) {
+			BuildLabels<int32_t>(context, csr, order);
+		}
+	} else {
+		BuildLandmarks<int64_t>(context, csr);
+		if (exact) {
+			BuildLabels<int64_t>(context, csr, order);
+		}
+	}
+	memory.Resize(context, GetMemoryUsage());
+}
+
+template <class ID_T>
+void CSRDistanceIndex::BuildLandmarks(ClientContext &context, CSR &csr) {
+	auto landmark_count = landmarks.size();
+	memory.Resize(context, landmark_count * vertex_count * (symmetric ? 1 : 2) * sizeof(uint32_t));
+	from_landmark.assign(landmark_count * vertex_count, DISTANCE_INDEX_UNREACHABLE);
+	to_landmark.assign(symmetric ? 0 : landmark_count * vertex_count, DISTANCE_INDEX_UNREACHABLE);
+	auto ranges = csr.GetRanges();
+	auto &e = csr.GetNeighbors<ID_T>();
+	CSR *reverse = symmetric ? nullptr : &csr.GetReverse(context);
+	// Every landmark runs its own searches, which only write its rows of the distance arrays
+	ParallelFor(context, landmark_count, 1, [&](idx_t begin, idx_t end) {
+		vector<int64_t> queue;
+		for (auto l = begin; l < end; l++) {
+			BreadthFirstDistances<ID_T>(ranges, e, landmarks[l], from_landmark.data() + l * vertex_count, queue);
+			if (reverse) {
+				BreadthFirstDistances<ID_T>(reverse->GetRanges(), reverse->GetNeighbors<ID_T>(), landmarks[l],
+				                            to_landmark.data() + l * vertex_count, queue);
+			}
+		}
+	});
+}
+
+//! Flattens the labels of all vertices into the offset, hub and distance arrays
+static void FlattenLabels(vector<vector<DistanceLabelEntry>> &labels, vector<idx_t> &offsets, vector<uint32_t> &hubs,
+                          vector<uint32_t> &distances) {
+	offsets.resize(labels.size() + 1);
+	offsets[0] = 0;
+	for (idx_t i = 0; i < labels.size(); i++) {
+		offsets[i + 1] = offsets[i] + labels[i].size();
+	}
+	hubs.reserve(offsets.back());
+	distances.reserve(offsets.back());
+	for (auto &label : labels) {
+		for (auto &entry : label) {
+			hubs.push_back(entry.rank);
+			distances.push_back(entry.distance);
+		}
+		vector<DistanceLabelEntry>().swap(label);
+	}
+}
+
+template <class ID_T>
+void CSRDistanceIndex::BuildLabels(ClientContext &context, CSR &csr, const vector<int64_t> &order) {
+	vector<vector<DistanceLabelEntry>> out_labels(vertex_count);
+	vector<vector<DistanceLabelEntry>> in_labels(symmetric ? 0 : vertex_count);
+	auto &forward_labels = symmetric ? out_labels : in_labels;
+	// Distance of the hub of the current search to or from every rank, and of every vertex from the hub
+	vector<uint32_t> hub_distance(vertex_count, DISTANCE_INDEX_UNREACHABLE);
+	vector<uint32_t> distance(vertex_count, DISTANCE_INDEX_UNREACHABLE);
+	vector<int64_t> queue;
+	idx_t label_entries = 0;
+	idx_t reserved_entries = 0;
+	auto base_memory = memory.GetSize();
+
+	// The BFS from [hub] over [ranges]. A visited vertex whose distance the labels of [query_labels] and the
+	// [hub_labels] of the hub already answer is pruned, the others get the entry of the hub in [query_labels].
+	auto pruned_search = [&](int64_t hub, uint32_t rank, const CSRRanges &ranges, const vector<ID_T> &e,
+	                         vector<vector<DistanceLabelEntry>> &hub_labels,
+	                         vector<vector<DistanceLabelEntry>> &query_labels) {
+		for (auto &entry : hub_labels[hub]) {
+			hub_distance[entry.rank] = entry.distance;
+		}
+		queue.clear();
+		queue.push_back(hub);
+		distance[hub] = 0;
+		for (idx_t head = 0; head < queue.size(); head++) {
+			auto vertex = queue[head];
+			auto vertex_distance = distance[vertex];
+			bool covered = false;
+			for (auto &entry : query_labels[vertex]) {
+				if (hub_distance[entry.rank] != DISTANCE_INDEX_UNREACHABLE &&
+				    static_cast<uint64_t>(hub_distance[entry.rank]) + entry.distance <= vertex_distance) {
+					covered = true;
+					break;
+				}
+			}
+			if (covered) {
+				continue;
+			}
+			query_labels[vertex].push_back(DistanceLabelEntry {rank, vertex_distance});
+			label_entries++;
+			for (auto offset = ranges.begin[vertex]; offset < ranges.end[vertex]; offset++) {
+				auto neighbor = static_cast<int64_t>(e[offset]);
+				if (distance[neighbor] == DISTANCE_INDEX_UNREACHABLE) {
+					distance[neighbor] = vertex_distance + 1;
+					queue.push_back(neighbor);
+				}
+			}
+		}
+		for (auto vertex : queue) {
+			distance[vertex] = DISTANCE_INDEX_UNREACHABLE;
+		}
+		for (auto &entry : hub_labels[hub]) {
+			hub_distance[entry.rank] = DISTANCE_INDEX_UNREACHABLE;
+		}
+	};
+
+	auto ranges = csr.GetRanges();
+	auto &e = csr.GetNeighbors<ID_T>();
+	CSR *reverse = symmetric ? nullptr : &csr.GetReverse(context);
+	for (idx_t rank = 0; rank < vertex_count; rank++) {
+		auto hub = order[rank];
+		// The forward search adds the hub to the in-labels of the vertices it reaches, the backward search to the
+		// out-labels of the vertices that reach it
+		pruned_search(hub, static_cast<uint32_t>(rank), ranges, e, out_labels, forward_labels);
+		if (reverse) {
+			pruned_search(hub, static_cast<uint32_t>(rank), reverse->GetRanges(), reverse->GetNeighbors<ID_T>(),
+			              in_labels, out_labels);
+		}
+		if (label_entries > reserved_entries) {
+			reserved_entries = MaxValue<idx_t>(2 * label_entries, STANDARD_VECTOR_SIZE);
+			memory.Resize(context, base_memory + reserved_entries * sizeof(DistanceLabelEntry));
+		}
+	}
+	FlattenLabels(out_labels, out_offsets, out_hubs, out_distances);
+	if (!symmetric) {
+		FlattenLabels(in_labels, in_offsets, in_hubs, in_distances);
+	}
+}
+
+idx_t CSRDistanceIndex::GetMemoryUsage() const {
+	idx_t result = landmarks.capacity() * sizeof(int64_t);
+	result += (out_offsets.capacity() + in_offsets.capacity()) * sizeof(idx_t);
+	result += (out_hubs.capacity() + out_distances.capacity() + in_hubs.capacity() + in_distances.capacity()) *
+	          sizeof(uint32_t);
+	result += (from_landmark.capacity() + to_landmark.capacity()) * sizeof(uint32_t);
+	return result;
+}
+
+int64_t CSRDistanceIndex::Distance(int64_t source, int64_t target) const {
+	D_ASSERT(exact);
+	if (source == target) {
+		return 0;
+	}
+	if (!InGraph(source) || !InGraph(target)) {
+		return -1;
+	}
+	auto &target_offsets = symmetric ? out_offsets : in_offsets;
+	auto &target_hubs = symmetric ? out_hubs : in_hubs;
+	auto &target_distances = symmetric ? out_distances : in_distances;
+	// Both labels are sorted by rank, the common hubs are found in one merge
+	auto i = out_offsets[source];
+	auto i_end = out_offsets[source + 1];
+	auto j = target_offsets[target];
+	auto j_end = target_offsets[target + 1];
+	uint64_t result = NumericLimits<uint64_t>::Maximum();
+	while (i < i_end && j < j_end) {
+		if (out_hubs[i] < target_hubs[j]) {
+			i++;
+		} else if (out_hubs[i] > target_hubs[j]) {
+			j++;
+		} else {
+			result = MinValue<uint64_t>(result, static_cast<uint64_t>(out_distances[i]) + target_distances[j]);
+			i++;
+			j++;
+		}
+	}
+	return result == NumericLimits<uint64_t>::Maximum() ? -1 : static_cast<int64_t>(result);
+}
+
+DistanceBounds CSRDistanceIndex::EstimateDistance(int64_t source, int64_t target) const {
+	DistanceBounds result;
+	if (source == target) {
+		result.upper = 0;
+		return result;
+	}
+	if (!InGraph(source) || !InGraph(target)) {
+		result.unreachable = true;
+		return result;
+	}
+	result.lower = 1;
+	auto &to_distances = symmetric ? from_landmark : to_landmark;
+	for (idx_t l = 0; l < landmarks.size(); l++) {
+		auto landmark_to_source = from_landmark[l * vertex_count + source];
+		auto landmark_to_target = from_landmark[l * vertex_count + target];
+		auto source_to_landmark = to_distances[l * vertex_count + source];
+		auto target_to_landmark = to_distances[l * vertex_count + target];
+		if (source_to_landmark != DISTANCE_INDEX_UNREACHABLE && landmark_to_target != DISTANCE_INDEX_UNREACHABLE) {
+			result.upper = static_cast<uint32_t>(
+			    MinValue<uint64_t>(result.upper, static_cast<uint64_t>(source_to_landmark) + landmark_to_target));
+		}
+		// d(l, t) <= d(l, s) + d(s, t), so a landmark that reaches the source but not the target proves that there
+		// is no path
+		if (landmark_to_source != DISTANCE_INDEX_UNREACHABLE) {
+			if (landmark_to_target == DISTANCE_INDEX_UNREACHABLE) {
+				result.unreachable = true;
+				return result;
+			}
+			if (landmark_to_target > landmark_to_source) {
+				result.lower = MaxValue<uint32_t>(result.lower, landmark_to_target - landmark_to_source);
+			}
+		}
+		// d(s, l) <= d(s, t) + d(t, l)
+		if (target_to_landmark != DISTANCE_INDEX_UNREACHABLE) {
+			if (source_to_landmark == DISTANCE_INDEX_UNREACHABLE) {
+				result.unreachable = true;
+				return result;
+			}
+			if (source_to_landmark > target_to_landmark) {
+				result.lower = MaxValue<uint32_t>(result.lower, source_to_landmark - target_to_landmark);
+			}
+		}
+	}
+	return result;
+}
+
+void IndexedPathLengths(const CSRDistanceIndex &index, idx_t count, const UnifiedVectorFormat &vdata_src,
+                        const int64_t *src_data, const UnifiedVectorFormat &vdata_dst, const int64_t *dst_data,
+                        int64_t upper, int64_t *result_data, ValidityMask &result_validity) {
+	for (idx_t row = 0; row < count; row++) {
+		auto src_pos = vdata_src.sel->get_index(row);
+		auto dst_pos = vdata_dst.sel->get_index(row);
+		int64_t distance = -1;
+		if (vdata_src.validity.RowIsValid(src_pos) && vdata_dst.validity.RowIsValid(dst_pos)) {
+			distance = index.Distance(src_data[src_pos], dst_data[dst_pos]);
+		}
+		if (distance < 0 || distance > upper) {
+			result_validity.SetInvalid(row);
+			result_data[row] = -1; /* no path */
+		} else {
+			result_data[row] = distance;
+		}
+	}
+}
+
+} // namespace duckdb
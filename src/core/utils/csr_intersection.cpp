@@ -0,0 +1,75 @@
+#include "duckpgq/core/utils/csr_intersection.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+//! Beyond this size ratio probing with galloping search beats a linear merge
+static constexpr idx_t GALLOP_RATIO = 32;
+
+//! Returns the first position in [data + begin, data + size) that is not smaller than [value]
+template <class ID_T>
+static idx_t Gallop(const ID_T *data, idx_t begin, idx_t size, ID_T value) {
+	idx_t step = 1;
+	idx_t high = begin;
+	while (high < size && data[high] < value) {
+		begin = high + 1;
+		high += step;
+		step <<= 1;
+	}
+	high = MinValue<idx_t>(high, size);
+	return static_cast<idx_t>(std::lower_bound(data + begin, data + high, value) - data);
+}
+
+template <class ID_T>
+static idx_t MergeIntersection(const ID_T *build, idx_t build_size, const ID_T *probe, idx_t probe_size) {
+	idx_t count = 0;
+	idx_t b = 0;
+	for (idx_t p = 0; p < probe_size && b < build_size; p++) {
+		while (b < build_size && build[b] < probe[p]) {
+			b++;
+		}
+		count += b < build_size && build[b] == probe[p];
+	}
+	return count;
+}
+
+template <class ID_T>
+idx_t CountSortedIntersection(const ID_T *build, idx_t build_size, const ID_T *probe, idx_t probe_size) {
+	if (build_size == 0 || probe_size == 0) {
+		return 0;
+	}
+	if (build_size > probe_size * GALLOP_RATIO) {
+		// Few probes into a long list
+		idx_t count = 0;
+		idx_t b = 0;
+		for (idx_t p = 0; p < probe_size && b < build_size; p++) {
+			b = Gallop(build, b, build_size, probe[p]);
+			count += b < build_size && build[b] == probe[p];
+		}
+		return count;
+	}
+	if (probe_size > build_size * GALLOP_RATIO) {
+		// A short build list, count the occurrences of each of its distinct values in the probe list
+		idx_t count = 0;
+		idx_t p = 0;
+		for (idx_t b = 0; b < build_size && p < probe_size; b++) {
+			if (b > 0 && build[b] == build[b - 1]) {
+				continue;
+			}
+			p = Gallop(probe, p, probe_size, build[b]);
+			auto last = Gallop<ID_T>(probe, p, probe_size, build[b] + 1);
+			count += last - p;
+			p = last;
+		}
+		return count;
+	}
+	return MergeIntersection(build, build_size, probe, probe_size);
+}
+
+template idx_t CountSortedIntersection<int32_t>(const int32_t *build, idx_t build_size, const int32_t *probe,
+                                                idx_t probe_size);
+template idx_t CountSortedIntersection<int64_t>(const int64_t *build, idx_t build_size, const int64_t *probe,
+                                                idx_t probe_size);
+
+} // namespace duckdb
@@ -0,0 +1,199 @@
+#include "duckpgq/core/utils/csr_kcore.hpp"
+
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
+#include "duckpgq/core/utils/memory_reservation.hpp"
+
+#include <atomic>
+
+namespace duckdb {
+
+//! Vertices per task of the passes over all vertices
+static constexpr idx_t KCORE_PARTITION_SIZE = 4096;
+//! Frontier vertices per task of a peeling step
+static constexpr idx_t KCORE_FRONTIER_MORSEL = 256;
+
+template <class ID_T>
+static void PeelCores(ClientContext &context, CSR &csr, vector<int64_t> &core) {
+	auto vertex_count = csr.VertexCount();
+	auto ranges = csr.GetRanges();
+	auto &e = csr.GetNeighbors<ID_T>();
+	// The degrees plus the core numbers and at most one frontier and one next level of every vertex
+	MemoryReservation memory;
+	memory.Resize(context, vertex_count * (sizeof(std::atomic<int64_t>) + 3 * sizeof(int64_t)));
+	auto degree = make_uniq<std::atomic<int64_t>[]>(vertex_count);
+	ParallelFor(context, vertex_count, KCORE_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		for (idx_t i = begin; i < end; i++) {
+			int64_t count = 0;
+			for (auto offset = ranges.begin[i]; offset < ranges.end[i]; offset++) {
+				count += static_cast<idx_t>(e[offset]) != i;
+			}
+			degree[i].store(count, std::memory_order_relaxed);
+		}
+	});
+
+	// -1 until the vertex is peeled
+	core.assign(vertex_count, -1);
+	vector<int64_t> frontier;
+	vector<int64_t> next;
+	std::mutex frontier_lock;
+	idx_t remaining = vertex_count;
+	int64_t k = 0;
+	while (remaining > 0) {
+		// Every remaining vertex has a degree above k - 1, the level starts with those of degree k. The smallest
+		// degree of the others is the next level that has any vertices.
+		frontier.clear();
+		auto min_degree = NumericLimits<int64_t>::Maximum();
+		ParallelFor(context, vertex_count, KCORE_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+			vector<int64_t> level;
+			auto level_min_degree = NumericLimits<int64_t>::Maximum();
+			for (idx_t i = begin; i < end; i++) {
+				if (core[i] >= 0) {
+					continue;
+				}
+				auto vertex_degree = degree[i].load(std::memory_order_relaxed);
+				if (vertex_degree <= k) {
+					core[i] = k;
+					level.push_back(static_cast<int64_t>(i));
+				} else {
+					level_min_degree = MinValue(level_min_degree, vertex_degree);
+				}
+			}
+			lock_guard<mutex> guard(frontier_lock);
+			frontier.insert(frontier.end(), level.begin(), level.end());
+			min_degree = MinValue(min_degree, level_min_degree);
+		});
+		if (frontier.empty()) {
+			k = min_degree;
+			continue;
+		}
+		while (!frontier.empty()) {
+			remaining -= frontier.size();
+			next.clear();
+			ParallelFor(context, frontier.size(), KCORE_FRONTIER_MORSEL, [&](idx_t begin, idx_t end) {
+				vector<int64_t> level;
+				for (auto f = begin; f < end; f++) {
+					auto vertex = frontier[f];
+					for (auto offset = ranges.begin[vertex]; offset < ranges.end[vertex]; offset++) {
+						auto neighbor = static_cast<int64_t>(e[offset]);
+						// Peeled vertices and those of the level never drop below k, so every vertex is added to a
+						// level once: by the decrement that takes its degree from k + 1 to k
+						if (neighbor == vertex || degree[neighbor].load(std::memory_order_relaxed) <= k) {
+							continue;
+						}
+						auto previous = degree[neighbor].fetch_sub(1, std::memory_order_relaxed);
+						if (previous == k + 1) {
+							level.push_back(neighbor);
+						} else if (previous <= k) {
+							// Another peeled neighbor got there first
+							degree[neighbor].fetch_add(1, std::memory_order_relaxed);
+						}
+					}
+				}
+				lock_guard<mutex> guard(frontier_lock);
+				next.insert(next.end(), level.begin(), level.end());
+			});
+			for (auto vertex : next) {
+				core[vertex] = k;
+			}
+			frontier.swap(next);
+		}
+		k++;
+	}
+}
+
+void KCoreDecomposition(ClientContext &context, CSR &csr, vector<int64_t> &core) {
+	if (csr.compact) {
+		PeelCores<int32_t>(context, csr, core);
+	} else {
+		PeelCores<int64_t>(context, csr, core);
+	}
+}
+
+template <class ID_T>
+static void PruneEdges(ClientContext &context, CSR &csr, const vector<int64_t> &core, int64_t k, CSR &result) {
+	auto vertex_count = csr.VertexCount();
+	auto ranges = csr.GetRanges();
+	auto &e = csr.GetNeighbors<ID_T>();
+	auto &result_e = result.GetNeighbors<ID_T>();
+	result.ReserveMemory(context, (vertex_count + 2) * sizeof(atomic<int64_t>));
+	result.vsize = vertex_count + 2;
+	result.v = make_uniq<std::atomic<int64_t>[]>(result.vsize);
+	// The number of kept edges of vertex i at v[i + 1], summed into the list offsets
+	result.v[0] = 0;
+	ParallelFor(context, vertex_count, KCORE_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		for (idx_t i = begin; i < end; i++) {
+			int64_t count = 0;
+			if (core[i] >= k) {
+				for (auto offset = ranges.begin[i]; offset < ranges.end[i]; offset++) {
+					count += core[e[offset]] >= k;
+				}
+			}
+			result.v[i + 1] = count;
+		}
+	});
+	for (idx_t i = 1; i <= vertex_count; i++) {
+		result.v[i] += result.v[i - 1];
+	}
+	auto edge_count = static_cast<idx_t>(result.v[vertex_count].load());
+	result.v[vertex_count + 1] = static_cast<int64_t>(edge_count);
+
+	auto weighted = !csr.w.empty();
+	auto double_weighted = !csr.w_double.empty();
+	result.ReserveMemory(context,
+	                     edge_count * (sizeof(ID_T) + sizeof(int64_t) + (csr.IsLabeled() ? sizeof(uint8_t) : 0) +
+	                                   (weighted ? sizeof(int64_t) : 0) + (double_weighted ? sizeof(double) : 0)) +
+	                         (csr.internal_id.size() + csr.external_id.size()) * sizeof(int64_t));
+	result_e.resize(edge_count);
+	result.edge_ids.resize(edge_count);
+	result.edge_labels.resize(csr.IsLabeled() ? edge_count : 0);
+	result.w.resize(weighted ? edge_count : 0);
+	result.w_double.resize(double_weighted ? edge_count : 0);
+	ParallelFor(context, vertex_count, KCORE_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		for (idx_t i = begin; i < end; i++) {
+			auto position = result.v[i].load(std::memory_order_relaxed);
+			if (core[i] < k) {
+				continue;
+			}
+			for (auto offset = ranges.begin[i]; offset < ranges.end[i]; offset++) {
+				if (core[e[offset]] < k) {
+					continue;
+				}
+				result_e[position] = e[offset];
+				result.edge_ids[position] = csr.edge_ids[offset];
+				if (csr.IsLabeled()) {
+					result.edge_labels[position] = csr.edge_labels[offset];
+				}
+				if (weighted) {
+					result.w[position] = csr.w[offset];
+				}
+				if (double_weighted) {
+					result.w_double[position] = csr.w_double[offset];
+				}
+				position++;
+			}
+		}
+	});
+	result.internal_id = csr.internal_id;
+	result.external_id = csr.external_id;
+	result.initialized_v = true;
+	result.initialized_e = true;
+	result.initialized_w = csr.initialized_w;
+	result.inserted_edges = static_cast<int64_t>(edge_count);
+	// Removing edges keeps the order of every list, and removes every edge of a symmetric CSR in both directions
+	result.sorted = csr.sorted;
+	result.symmetric = csr.symmetric;
+}
+
+shared_ptr<CSR> BuildKCoreCSR(ClientContext &context, CSR &csr, const vector<int64_t> &core, int64_t k) {
+	D_ASSERT(core.size() == csr.VertexCount());
+	auto result = make_shared_ptr<CSR>();
+	result->compact = csr.compact;
+	if (csr.compact) {
+		PruneEdges<int32_t>(context, csr, core, k, *result);
+	} else {
+		PruneEdges<int64_t>(context, csr, core, k, *result);
+	}
+	return result;
+}
+
+} // namespace duckdb
@@ -0,0 +1,148 @@
+#include "duckpgq/core/utils/csr_random_walk.hpp"
+
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+//! Vertices per task of the alias table build
+static constexpr idx_t ALIAS_TABLE_PARTITION_SIZE = 4096;
+
+CSRAliasTables::CSRAliasTables(ClientContext &context, CSR &csr) {
+	auto vertex_count = csr.VertexCount();
+	auto ranges = csr.GetRanges();
+	// The weights are indexed by CSR offset like the tables
+	auto edge_count = csr.w.size() + csr.w_double.size();
+	memory.Resize(context, edge_count * (sizeof(double_t) + sizeof(uint32_t)));
+	probability.resize(edge_count);
+	alias.resize(edge_count);
+	auto int_weights = csr.w.empty() ? nullptr : csr.w.data();
+	auto double_weights = csr.w_double.empty() ? nullptr : csr.w_double.data();
+	ParallelFor(context, vertex_count, ALIAS_TABLE_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		vector<double_t> scaled;
+		vector<uint32_t> small;
+		vector<uint32_t> large;
+		for (idx_t i = begin; i < end; i++) {
+			auto list_begin = ranges.begin[i];
+			auto degree = static_cast<idx_t>(ranges.end[i] - list_begin);
+			if (degree > NumericLimits<uint32_t>::Maximum()) {
+				throw InvalidInputException("Weighted random walks support vertices of fewer than 2^32 edges");
+			}
+			scaled.resize(degree);
+			double_t total = 0;
+			for (idx_t j = 0; j < degree; j++) {
+				auto offset = list_begin + static_cast<int64_t>(j);
+				scaled[j] = int_weights ? static_cast<double_t>(int_weights[offset]) : double_weights[offset];
+				if (scaled[j] < 0) {
+					throw InvalidInputException("Random walks need non-negative edge weights");
+				}
+				total += scaled[j];
+			}
+			// A list without weight is walked uniformly
+			for (idx_t j = 0; j < degree; j++) {
+				scaled[j] = total > 0 ? scaled[j] * static_cast<double_t>(degree) / total : 1;
+			}
+			small.clear();
+			large.clear();
+			for (uint32_t j = 0; j < degree; j++) {
+				(scaled[j] < 1 ? small : large).push_back(j);
+			}
+			while (!small.empty() && !large.empty()) {
+				auto less = small.back();
+				small.pop_back();
+				auto more = large.back();
+				probability[list_begin + less] = scaled[less];
+				alias[list_begin + less] = more;
+				// The larger entry fills up the rest of the column of the smaller one
+				scaled[more] = (scaled[more] + scaled[less]) - 1;
+				if (scaled[more] < 1) {
+					large.pop_back();
+					small.push_back(more);
+				}
+			}
+			// Left over by rounding, these columns are full
+			for (auto j : large) {
+				probability[list_begin + j] = 1;
+				alias[list_begin + j] = j;
+			}
+			for (auto j : small) {
+				probability[list_begin + j] = 1;
+				alias[list_begin + j] = j;
+			}
+		}
+	});
+}
+
+//! Whether [target] is in the adjacency list of [vertex]
+template <class ID_T>
+static bool HasNeighbor(const CSR &csr, const CSRRanges &ranges, const vector<ID_T> &e, int64_t vertex,
+                        int64_t target) {
+	auto list_begin = e.begin() + ranges.begin[vertex];
+	auto list_end = e.begin() + ranges.end[vertex];
+	if (csr.sorted) {
+		return std::binary_search(list_begin, list_end, static_cast<ID_T>(target));
+	}
+	return std::find(list_begin, list_end, static_cast<ID_T>(target)) != list_end;
+}
+
+template <class ID_T>
+static idx_t Walk(CSR &csr, const CSRAliasTables *alias_tables, const RandomWalkParameters &parameters,
+                  int64_t source, RandomWalkGenerator &random, int64_t *walk) {
+	auto ranges = csr.GetRanges();
+	auto &e = csr.GetNeighbors<ID_T>();
+	// The bias of a step, relative to the largest bias, for the rejection sampling
+	auto max_bias = MaxValue(1.0, MaxValue(1 / parameters.p, 1 / parameters.q));
+	auto return_bias = 1 / parameters.p / max_bias;
+	auto stay_bias = 1 / max_bias;
+	auto out_bias = 1 / parameters.q / max_bias;
+
+	auto draw = [&](int64_t vertex) {
+		auto list_begin = ranges.begin[vertex];
+		auto index = random.NextIndex(static_cast<idx_t>(ranges.end[vertex] - list_begin));
+		auto offset = list_begin + static_cast<int64_t>(index);
+		if (alias_tables && random.NextDouble() >= alias_tables->probability[offset]) {
+			offset = list_begin + alias_tables->alias[offset];
+		}
+		return static_cast<int64_t>(e[offset]);
+	};
+
+	walk[0] = source;
+	idx_t length = 1;
+	while (length < parameters.length) {
+		auto vertex = walk[length - 1];
+		if (ranges.begin[vertex] == ranges.end[vertex]) {
+			break;
+		}
+		auto next = draw(vertex);
+		if (parameters.SecondOrder() && length > 1) {
+			auto previous = walk[length - 2];
+			while (true) {
+				double_t bias;
+				if (next == previous) {
+					bias = return_bias;
+				} else if (HasNeighbor(csr, ranges, e, previous, next)) {
+					bias = stay_bias;
+				} else {
+					bias = out_bias;
+				}
+				if (random.NextDouble() < bias) {
+					break;
+				}
+				next = draw(vertex);
+			}
+		}
+		walk[length++] = next;
+	}
+	return length;
+}
+
+idx_t RandomWalk(CSR &csr, const CSRAliasTables *alias_tables, const RandomWalkParameters &parameters,
+                 int64_t source, RandomWalkGenerator &random, int64_t *walk) {
+	if (csr.compact) {
+		return Walk<int32_t>(csr, alias_tables, parameters, source, random, walk);
+	}
+	return Walk<int64_t>(csr, alias_tables, parameters, source, random, walk);
+}
+
+} // namespace duckdb
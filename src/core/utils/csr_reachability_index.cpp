@@ -0,0 +1,257 @@
+#include "duckpgq/core/utils/csr_reachability_index.hpp"
+
+#include <algorithm>
+#include <random>
+
+namespace duckdb {
+
+//! Marks a vertex Tarjan's algorithm has not reached yet
+static constexpr uint32_t REACHABILITY_UNVISITED = NumericLimits<uint32_t>::Maximum();
+
+CSRReachabilityIndex::CSRReachabilityIndex(ClientContext &context, CSR &csr) {
+	auto vertex_count = csr.VertexCount();
+	if (vertex_count >= REACHABILITY_UNVISITED) {
+		throw InvalidInputException("A reachability index supports graphs of fewer than 2^32 vertices");
+	}
+	// The component ids plus the discovery and lowlink numbers and the stacks of Tarjan's algorithm
+	memory.Resize(context, vertex_count * (4 * sizeof(uint32_t) + sizeof(uint8_t)));
+	if (csr.compact) {
+		BuildComponents<int32_t>(csr);
+	} else {
+		BuildComponents<int64_t>(csr);
+	}
+	memory.Resize(context, component.capacity() * sizeof(uint32_t) + csr.EdgeCount() * sizeof(uint32_t));
+	if (csr.compact) {
+		BuildDAG<int32_t>(csr);
+	} else {
+		BuildDAG<int64_t>(csr);
+	}
+	memory.Resize(context, GetMemoryUsage() + 2 * ComponentCount() * REACHABILITY_INDEX_TRAVERSALS * sizeof(uint32_t));
+	BuildIntervals();
+	memory.Resize(context, GetMemoryUsage());
+}
+
+//! An iterative Tarjan's algorithm, a component gets its id once every component it reaches has one
+template <class ID_T>
+void CSRReachabilityIndex::BuildComponents(CSR &csr) {
+	auto vertex_count = csr.VertexCount();
+	auto ranges = csr.GetRanges();
+	auto &e = csr.GetNeighbors<ID_T>();
+	component.assign(vertex_count, REACHABILITY_UNVISITED);
+	vector<uint32_t> discovery(vertex_count, REACHABILITY_UNVISITED);
+	vector<uint32_t> lowlink(vertex_count);
+	vector<uint8_t> on_stack(vertex_count, 0);
+	vector<uint32_t> scc_stack;
+	// The vertex of every open call and the offset of the next neighbor it visits
+	vector<pair<uint32_t, int64_t>> calls;
+	uint32_t discovered = 0;
+	uint32_t component_count = 0;
+	auto open = [&](uint32_t vertex) {
+		discovery[vertex] = lowlink[vertex] = discovered++;
+		scc_stack.push_back(vertex);
+		on_stack[vertex] = 1;
+		calls.emplace_back(vertex, ranges.begin[vertex]);
+	};
+	for (uint32_t root = 0; root < vertex_count; root++) {
+		if (discovery[root] != REACHABILITY_UNVISITED) {
+			continue;
+		}
+		open(root);
+		while (!calls.empty()) {
+			auto vertex = calls.back().first;
+			auto &offset = calls.back().second;
+			if (offset < ranges.end[vertex]) {
+				auto neighbor = static_cast<uint32_t>(e[offset++]);
+				if (discovery[neighbor] == REACHABILITY_UNVISITED) {
+					open(neighbor);
+				} else if (on_stack[neighbor]) {
+					lowlink[vertex] = MinValue<uint32_t>(lowlink[vertex], discovery[neighbor]);
+				}
+				continue;
+			}
+			if (lowlink[vertex] == discovery[vertex]) {
+				uint32_t member;
+				do {
+					member = scc_stack.back();
+					scc_stack.pop_back();
+					on_stack[member] = 0;
+					component[member] = component_count;
+				} while (member != vertex);
+				component_count++;
+			}
+			calls.pop_back();
+			if (!calls.empty()) {
+				auto parent = calls.back().first;
+				lowlink[parent] = MinValue<uint32_t>(lowlink[parent], lowlink[vertex]);
+			}
+		}
+	}
+	dag_offsets.assign(component_count + 1, 0);
+}
+
+template <class ID_T>
+void CSRReachabilityIndex::BuildDAG(CSR &csr) {
+	auto vertex_count = csr.VertexCount();
+	auto ranges = csr.GetRanges();
+	auto &e = csr.GetNeighbors<ID_T>();
+	auto component_count = ComponentCount();
+	// Counting sort of the edges between components on their source component
+	for (idx_t vertex = 0; vertex < vertex_count; vertex++) {
+		for (auto offset = ranges.begin[vertex]; offset < ranges.end[vertex]; offset++) {
+			if (component[vertex] != component[e[offset]]) {
+				dag_offsets[component[vertex] + 1]++;
+			}
+		}
+	}
+	for (idx_t c = 0; c < component_count; c++) {
+		dag_offsets[c + 1] += dag_offsets[c];
+	}
+	dag_edges.resize(dag_offsets[component_count]);
+	vector<idx_t> position(dag_offsets.begin(), dag_offsets.end() - 1);
+	for (idx_t vertex = 0; vertex < vertex_count; vertex++) {
+		for (auto offset = ranges.begin[vertex]; offset < ranges.end[vertex]; offset++) {
+			auto target = component[e[offset]];
+			if (component[vertex] != target) {
+				dag_edges[position[component[vertex]]++] = target;
+			}
+		}
+	}
+	// Parallel edges between two components are kept once
+	idx_t write = 0;
+	idx_t list_begin = 0;
+	for (idx_t c = 0; c < component_count; c++) {
+		auto list_end = dag_offsets[c + 1];
+		std::sort(dag_edges.begin() + static_cast<int64_t>(list_begin),
+		          dag_edges.begin() + static_cast<int64_t>(list_end));
+		dag_offsets[c] = write;
+		for (auto i = list_begin; i < list_end; i++) {
+			if (i == list_begin || dag_edges[i] != dag_edges[i - 1]) {
+				dag_edges[write++] = dag_edges[i];
+			}
+		}
+		list_begin = list_end;
+	}
+	dag_offsets[component_count] = write;
+	dag_edges.resize(write);
+	dag_edges.shrink_to_fit();
+}
+
+//! A component of an open call of the interval traversal, its successors are visited as a rotation of the list that
+//! starts at [rotation]
+struct IntervalCall {
+	uint32_t component;
+	idx_t step;
+	idx_t rotation;
+};
+
+void CSRReachabilityIndex::BuildIntervals() {
+	auto component_count = ComponentCount();
+	low.assign(component_count * REACHABILITY_INDEX_TRAVERSALS, 0);
+	post.assign(component_count * REACHABILITY_INDEX_TRAVERSALS, 0);
+	// The traversals start from the components in different random orders and visit the successors from different
+	// random positions, so that they cut different pairs. The seed is fixed to build the same index every time.
+	std::mt19937_64 random(component_count);
+	vector<uint32_t> roots(component_count);
+	vector<uint8_t> visited(component_count);
+	vector<IntervalCall> calls;
+	for (idx_t traversal = 0; traversal < REACHABILITY_INDEX_TRAVERSALS; traversal++) {
+		for (uint32_t c = 0; c < component_count; c++) {
+			roots[c] = c;
+		}
+		std::shuffle(roots.begin(), roots.end(), random);
+		std::fill(visited.begin(), visited.end(), 0);
+		uint32_t rank = 0;
+		auto interval = [&](uint32_t c) {
+			return c * REACHABILITY_INDEX_TRAVERSALS + traversal;
+		};
+		auto open = [&](uint32_t c) {
+			visited[c] = 1;
+			low[interval(c)] = NumericLimits<uint32_t>::Maximum();
+			calls.push_back(IntervalCall {c, 0, static_cast<idx_t>(random())});
+		};
+		for (auto root : roots) {
+			if (visited[root]) {
+				continue;
+			}
+			open(root);
+			while (!calls.empty()) {
+				auto &call = calls.back();
+				auto c = call.component;
+				auto degree = dag_offsets[c + 1] - dag_offsets[c];
+				if (call.step < degree) {
+					auto successor = dag_edges[dag_offsets[c] + (call.rotation + call.step) % degree];
+					call.step++;
+					if (!visited[successor]) {
+						open(successor);
+					} else {
+						// Finished already, the DAG has no cycles
+						low[interval(c)] = MinValue<uint32_t>(low[interval(c)], low[interval(successor)]);
+					}
+					continue;
+				}
+				post[interval(c)] = ++rank;
+				low[interval(c)] = MinValue<uint32_t>(low[interval(c)], rank);
+				calls.pop_back();
+				if (!calls.empty()) {
+					auto parent = calls.back().component;
+					low[interval(parent)] = MinValue<uint32_t>(low[interval(parent)], low[interval(c)]);
+				}
+			}
+		}
+	}
+}
+
+idx_t CSRReachabilityIndex::GetMemoryUsage() const {
+	idx_t result = (component.capacity() + dag_edges.capacity() + low.capacity() + post.capacity()) * sizeof(uint32_t);
+	result += dag_offsets.capacity() * sizeof(idx_t);
+	return result;
+}
+
+bool CSRReachabilityIndex::Reachable(int64_t source, int64_t target, ReachabilitySearch &search) const {
+	if (source == target) {
+		return true;
+	}
+	if (source < 0 || target < 0 || static_cast<idx_t>(source) >= VertexCount() ||
+	    static_cast<idx_t>(target) >= VertexCount()) {
+		return false;
+	}
+	auto source_component = component[source];
+	auto target_component = component[target];
+	if (source_component == target_component) {
+		return true;
+	}
+	// Edges of the DAG lead to lower component ids
+	if (target_component > source_component || !Contains(source_component, target_component)) {
+		return false;
+	}
+	if (search.visited.size() != ComponentCount()) {
+		search.visited.assign(ComponentCount(), 0);
+		search.epoch = 0;
+	}
+	if (++search.epoch == 0) {
+		std::fill(search.visited.begin(), search.visited.end(), 0);
+		search.epoch = 1;
+	}
+	search.stack.clear();
+	search.stack.push_back(source_component);
+	search.visited[source_component] = search.epoch;
+	while (!search.stack.empty()) {
+		auto c = search.stack.back();
+		search.stack.pop_back();
+		for (auto i = dag_offsets[c]; i < dag_offsets[c + 1]; i++) {
+			auto successor = dag_edges[i];
+			if (successor == target_component) {
+				return true;
+			}
+			if (successor < target_component || search.visited[successor] == search.epoch ||
+			    !Contains(successor, target_component)) {
+				continue;
+			}
+			search.visited[successor] = search.epoch;
+			search.stack.push_back(successor);
+		}
+	}
+	return false;
+}
+
+} // namespace duckdb
@@ -0,0 +1,192 @@
+#include "duckpgq/core/utils/csr_snapshot.hpp"
+#include "duckdb/common/checksum.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+
+namespace duckdb {
+
+static constexpr const char CSR_SNAPSHOT_MAGIC[8] = {'D', 'P', 'G', 'Q', 'C', 'S', 'R', '\0'};
+
+enum class CSRSnapshotWeightType : uint32_t { UNWEIGHTED = 0, INT64 = 1, DOUBLE = 2 };
+
+struct CSRSnapshotHeader {
+	char magic[8];
+	uint32_t version;
+	CSRSnapshotWeightType weight_type;
+	uint64_t vsize;
+	uint64_t esize;
+	CSRSnapshotFingerprint fingerprint;
+	//! Checksum over all arrays following the header
+	uint64_t checksum;
+};
+
+static void ComputeTableFingerprint(Connection &connection, const string &table, const vector<string> &columns,
+                                    int64_t &rows, uint64_t &hash) {
+	string hash_arguments = "rowid";
+	for (auto &column : columns) {
+		hash_arguments += ", " + KeywordHelper::WriteOptionallyQuoted(column);
+	}
+	auto result = connection.Query("SELECT count(*)::BIGINT, coalesce(bit_xor(hash(" + hash_arguments +
+	                               ")), 0)::UBIGINT FROM " + table);
+	if (result->HasError()) {
+		result->ThrowError();
+	}
+	rows = result->GetValue(0, 0).GetValue<int64_t>();
+	hash = result->GetValue(1, 0).GetValue<uint64_t>();
+}
+
+CSRSnapshotFingerprint CSRSnapshotFingerprint::Compute(ClientContext &context,
+                                                       const shared_ptr<PropertyGraphTable> &edge_table) {
+	CSRSnapshotFingerprint result;
+	Connection connection(*context.db);
+	auto source_table = edge_table->source_pg_table->CreateBaseTableRef()->ToString();
+	ComputeTableFingerprint(connection, source_table, edge_table->source_pk, result.vertex_rows, result.vertex_hash);
+	// The destination keys are resolved against their own vertex table, which differs from the source one for edges
+	// between two vertex tables
+	auto destination_table = edge_table->destination_pg_table->CreateBaseTableRef()->ToString();
+	if (destination_table == source_table && edge_table->destination_pk == edge_table->source_pk) {
+		result.destination_rows = result.vertex_rows;
+		result.destination_hash = result.vertex_hash;
+	} else {
+		ComputeTableFingerprint(connection, destination_table, edge_table->destination_pk, result.destination_rows,
+		                        result.destination_hash);
+	}
+	vector<string> edge_columns = edge_table->source_fk;
+	edge_columns.insert(edge_columns.end(), edge_table->destination_fk.begin(), edge_table->destination_fk.end());
+	ComputeTableFingerprint(connection, edge_table->CreateBaseTableRef()->ToString(), edge_columns,
+	                        result.edge_rows, result.edge_hash);
+	return result;
+}
+
+static uint64_t ChecksumArray(uint64_t checksum, const void *data, idx_t size) {
+	if (size == 0) {
+		return checksum;
+	}
+	return checksum ^ Checksum(reinterpret_cast<uint8_t *>(const_cast<void *>(data)), size);
+}
+
+void WriteCSRSnapshot(ClientContext &context, const CSR &csr, const string &path,
+                      const CSRSnapshotFingerprint &fingerprint) {
+	if (!csr.IsComplete()) {
+		throw InvalidInputException("Cannot write a snapshot of a CSR that has not been fully built");
+	}
+	if (csr.IsRelabeled()) {
+		// Loading a snapshot runs Finalize, which renumbers the vertices again
+		throw InvalidInputException("Cannot write a snapshot of a CSR with renumbered vertices, set "
+		                            "duckpgq_csr_vertex_order to 'none' before building it");
+	}
+	vector<int64_t> v(csr.vsize);
+	for (idx_t i = 0; i < csr.vsize; i++) {
+		v[i] = csr.v[i].load();
+	}
+	// Snapshots always store 64-bit neighbor ids
+	vector<int64_t> widened_e;
+	if (csr.compact) {
+		widened_e.assign(csr.e_compact.begin(), csr.e_compact.end());
+	}
+	auto &e = csr.compact ? widened_e : csr.e;
+
+	CSRSnapshotHeader header;
+	memcpy(header.magic, CSR_SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = CSR_SNAPSHOT_VERSION;
+	header.weight_type = !csr.w.empty()          ? CSRSnapshotWeightType::INT64
+	                     : !csr.w_double.empty() ? CSRSnapshotWeightType::DOUBLE
+	                                             : CSRSnapshotWeightType::UNWEIGHTED;
+	header.vsize = csr.vsize;
+	header.esize = e.size();
+	header.fingerprint = fingerprint;
+	header.checksum = ChecksumArray(0, v.data(), v.size() * sizeof(int64_t));
+	header.checksum = ChecksumArray(header.checksum, e.data(), e.size() * sizeof(int64_t));
+	header.checksum = ChecksumArray(header.checksum, csr.edge_ids.data(), csr.edge_ids.size() * sizeof(int64_t));
+	header.checksum = ChecksumArray(header.checksum, csr.w.data(), csr.w.size() * sizeof(int64_t));
+	header.checksum = ChecksumArray(header.checksum, csr.w_double.data(), csr.w_double.size() * sizeof(double));
+
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+	handle->Write(&header, sizeof(header));
+	handle->Write(v.data(), v.size() * sizeof(int64_t));
+	handle->Write(const_cast<int64_t *>(e.data()), e.size() * sizeof(int64_t));
+	handle->Write(const_cast<int64_t *>(csr.edge_ids.data()), csr.edge_ids.size() * sizeof(int64_t));
+	if (header.weight_type == CSRSnapshotWeightType::INT64) {
+		handle->Write(const_cast<int64_t *>(csr.w.data()), csr.w.size() * sizeof(int64_t));
+	} else if (header.weight_type == CSRSnapshotWeightType::DOUBLE) {
+		handle->Write(const_cast<double *>(csr.w_double.data()), csr.w_double.size() * sizeof(double));
+	}
+	handle->Sync();
+}
+
+static void ReadExact(FileHandle &handle, void *buffer, idx_t size, const string &path) {
+	if (size == 0) {
+		return;
+	}
+	if (handle.Read(buffer, size) != static_cast<int64_t>(size)) {
+		throw IOException("CSR snapshot %s is truncated", path);
+	}
+}
+
+shared_ptr<CSR> ReadCSRSnapshot(ClientContext &context, const string &path,
+                                const CSRSnapshotFingerprint &expected_fingerprint) {
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+
+	CSRSnapshotHeader header;
+	ReadExact(*handle, &header, sizeof(header), path);
+	if (memcmp(header.magic, CSR_SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+		throw IOException("%s is not a CSR snapshot", path);
+	}
+	if (header.version != CSR_SNAPSHOT_VERSION) {
+		throw IOException("CSR snapshot %s has version %d, expected version %d", path, header.version,
+		                  CSR_SNAPSHOT_VERSION);
+	}
+	if (!(header.fingerprint == expected_fingerprint)) {
+		throw InvalidInputException("CSR snapshot %s does not match the current contents of the vertex and edge "
+		                            "tables, rebuild it with PRAGMA save_csr",
+		                            path);
+	}
+	auto expected_size = sizeof(header) + (header.vsize + 2 * header.esize) * sizeof(int64_t) +
+	                     (header.weight_type == CSRSnapshotWeightType::UNWEIGHTED ? 0 : header.esize * 8);
+	if (static_cast<idx_t>(handle->GetFileSize()) != expected_size) {
+		throw IOException("CSR snapshot %s has an unexpected size", path);
+	}
+
+	auto csr = make_shared_ptr<CSR>();
+	// The arrays of the file and the copy of v that is converted to atomics
+	csr->ReserveMemory(context, expected_size - sizeof(header) + header.vsize * sizeof(std::atomic<int64_t>));
+	vector<int64_t> v(header.vsize);
+	ReadExact(*handle, v.data(), v.size() * sizeof(int64_t), path);
+	csr->e.resize(header.esize);
+	ReadExact(*handle, csr->e.data(), csr->e.size() * sizeof(int64_t), path);
+	csr->edge_ids.resize(header.esize);
+	ReadExact(*handle, csr->edge_ids.data(), csr->edge_ids.size() * sizeof(int64_t), path);
+	if (header.weight_type == CSRSnapshotWeightType::INT64) {
+		csr->w.resize(header.esize);
+		ReadExact(*handle, csr->w.data(), csr->w.size() * sizeof(int64_t), path);
+	} else if (header.weight_type == CSRSnapshotWeightType::DOUBLE) {
+		csr->w_double.resize(header.esize);
+		ReadExact(*handle, csr->w_double.data(), csr->w_double.size() * sizeof(double), path);
+	}
+
+	auto checksum = ChecksumArray(0, v.data(), v.size() * sizeof(int64_t));
+	checksum = ChecksumArray(checksum, csr->e.data(), csr->e.size() * sizeof(int64_t));
+	checksum = ChecksumArray(checksum, csr->edge_ids.data(), csr->edge_ids.size() * sizeof(int64_t));
+	checksum = ChecksumArray(checksum, csr->w.data(), csr->w.size() * sizeof(int64_t));
+	checksum = ChecksumArray(checksum, csr->w_double.data(), csr->w_double.size() * sizeof(double));
+	if (checksum != header.checksum) {
+		throw IOException("CSR snapshot %s is corrupt, checksum mismatch", path);
+	}
+
+	csr->v = make_uniq<std::atomic<int64_t>[]>(header.vsize);
+	for (idx_t i = 0; i < header.vsize; i++) {
+		csr->v[i] = v[i];
+	}
+	csr->vsize = header.vsize;
+	csr->initialized_v = true;
+	csr->initialized_e = true;
+	csr->initialized_w = header.weight_type != CSRSnapshotWeightType::UNWEIGHTED;
+	csr->inserted_edges = static_cast<int64_t>(header.esize);
+	// Snapshots of sorted CSRs only pay for the check here
+	csr->Finalize(context);
+	return csr;
+}
+
+} // namespace duckdb
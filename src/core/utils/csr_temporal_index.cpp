@@ -0,0 +1,32 @@
+#include "duckpgq/core/utils/csr_temporal_index.hpp"
+
+#include <limits>
+
+namespace duckdb {
+
+CSRTemporalIndex::CSRTemporalIndex(ClientContext &context, const CSR &csr, const vector<int64_t> &from,
+                                   const vector<int64_t> &to, bool timestamps)
+    : timestamps(timestamps) {
+	D_ASSERT(from.size() == to.size());
+	auto entry_count = csr.edge_ids.size();
+	memory.Resize(context, 2 * entry_count * sizeof(int64_t));
+	valid_from.resize(entry_count);
+	valid_to.resize(entry_count);
+	for (idx_t offset = 0; offset < entry_count; offset++) {
+		auto edge = csr.edge_ids[offset];
+		if (edge >= 0 && static_cast<idx_t>(edge) < from.size()) {
+			valid_from[offset] = from[edge];
+			valid_to[offset] = to[edge];
+		} else {
+			// An empty interval
+			valid_from[offset] = std::numeric_limits<int64_t>::max();
+			valid_to[offset] = std::numeric_limits<int64_t>::min();
+		}
+	}
+}
+
+idx_t CSRTemporalIndex::GetMemoryUsage() const {
+	return (valid_from.capacity() + valid_to.capacity()) * sizeof(int64_t);
+}
+
+} // namespace duckdb
@@ -0,0 +1,160 @@
+#include "duckpgq/core/utils/csr_triangles.hpp"
+#include "duckpgq/core/utils/csr_intersection.hpp"
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+//! Vertices per task, small because the work per vertex is skewed
+static constexpr idx_t TRIANGLE_PARTITION_SIZE = 1024;
+
+template <class ID_T>
+static void CountSimpleDegreesInternal(ClientContext &context, CSR &csr, vector<int64_t> &degrees) {
+	auto vertex_count = csr.vsize - 2;
+	auto *v = reinterpret_cast<int64_t *>(csr.v.get());
+	auto &e = csr.GetNeighbors<ID_T>();
+	degrees.resize(vertex_count);
+	ParallelFor(context, vertex_count, TRIANGLE_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		vector<ID_T> neighbors;
+		for (idx_t i = begin; i < end; i++) {
+			neighbors.assign(e.begin() + v[i], e.begin() + v[i + 1]);
+			if (!csr.sorted) {
+				std::sort(neighbors.begin(), neighbors.end());
+			}
+			int64_t degree = 0;
+			for (idx_t j = 0; j < neighbors.size(); j++) {
+				if (static_cast<idx_t>(neighbors[j]) != i && (j == 0 || neighbors[j] != neighbors[j - 1])) {
+					degree++;
+				}
+			}
+			degrees[i] = degree;
+		}
+	});
+}
+
+void CountSimpleDegrees(ClientContext &context, CSR &csr, vector<int64_t> &degrees) {
+	if (csr.compact) {
+		CountSimpleDegreesInternal<int32_t>(context, csr, degrees);
+	} else {
+		CountSimpleDegreesInternal<int64_t>(context, csr, degrees);
+	}
+}
+
+template <class ID_T>
+static idx_t CountTrianglesInternal(ClientContext &context, CSR &csr, vector<int64_t> *vertex_triangles) {
+	auto vertex_count = csr.vsize - 2;
+	auto *v = reinterpret_cast<int64_t *>(csr.v.get());
+	auto &e = csr.GetNeighbors<ID_T>();
+	auto partition_count = (vertex_count + TRIANGLE_PARTITION_SIZE - 1) / TRIANGLE_PARTITION_SIZE;
+	auto precedes = [&](idx_t a, idx_t b) {
+		auto degree_a = v[a + 1] - v[a];
+		auto degree_b = v[b + 1] - v[b];
+		return degree_a < degree_b || (degree_a == degree_b && a < b);
+	};
+
+	// Oriented CSR, every list sorted by vertex id
+	vector<int64_t> oriented_v(vertex_count + 1, 0);
+	ParallelFor(context, vertex_count, TRIANGLE_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		for (idx_t i = begin; i < end; i++) {
+			int64_t count = 0;
+			for (auto offset = v[i]; offset < v[i + 1]; offset++) {
+				count += precedes(i, static_cast<idx_t>(e[offset])) ? 1 : 0;
+			}
+			oriented_v[i + 1] = count;
+		}
+	});
+	for (idx_t i = 0; i < vertex_count; i++) {
+		oriented_v[i + 1] += oriented_v[i];
+	}
+	vector<ID_T> oriented_e(static_cast<idx_t>(oriented_v[vertex_count]));
+	// Number of distinct entries of every oriented list, parallel edges leave unused slots at the end of the list
+	vector<idx_t> sizes(vertex_count);
+	ParallelFor(context, vertex_count, TRIANGLE_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		for (idx_t i = begin; i < end; i++) {
+			auto position = oriented_v[i];
+			for (auto offset = v[i]; offset < v[i + 1]; offset++) {
+				if (precedes(i, static_cast<idx_t>(e[offset]))) {
+					oriented_e[position++] = e[offset];
+				}
+			}
+			auto list_begin = oriented_e.begin() + oriented_v[i];
+			if (!csr.sorted) {
+				std::sort(list_begin, oriented_e.begin() + position);
+			}
+			sizes[i] = static_cast<idx_t>(std::unique(list_begin, oriented_e.begin() + position) - list_begin);
+		}
+	});
+
+	vector<idx_t> partition_triangles(partition_count, 0);
+	unique_ptr<std::atomic<int64_t>[]> triangles_of;
+	if (vertex_triangles) {
+		triangles_of = make_uniq<std::atomic<int64_t>[]>(vertex_count);
+		for (idx_t i = 0; i < vertex_count; i++) {
+			triangles_of[i].store(0, std::memory_order_relaxed);
+		}
+	}
+	ParallelFor(context, vertex_count, TRIANGLE_PARTITION_SIZE, [&](idx_t begin, idx_t end) {
+		idx_t total = 0;
+		for (idx_t u = begin; u < end; u++) {
+			auto *u_list = oriented_e.data() + oriented_v[u];
+			for (idx_t j = 0; j < sizes[u]; j++) {
+				auto w = static_cast<idx_t>(u_list[j]);
+				auto *w_list = oriented_e.data() + oriented_v[w];
+				if (!vertex_triangles) {
+					total += CountSortedIntersection(u_list, sizes[u], w_list, sizes[w]);
+					continue;
+				}
+				// Every common vertex closes a triangle u, w, x
+				idx_t a = 0;
+				idx_t b = 0;
+				int64_t found = 0;
+				while (a < sizes[u] && b < sizes[w]) {
+					if (u_list[a] < w_list[b]) {
+						a++;
+					} else if (w_list[b] < u_list[a]) {
+						b++;
+					} else {
+						triangles_of[static_cast<idx_t>(u_list[a])].fetch_add(1, std::memory_order_relaxed);
+						found++;
+						a++;
+						b++;
+					}
+				}
+				if (found > 0) {
+					triangles_of[u].fetch_add(found, std::memory_order_relaxed);
+					triangles_of[w].fetch_add(found, std::memory_order_relaxed);
+					total += static_cast<idx_t>(found);
+				}
+			}
+		}
+		partition_triangles[begin / TRIANGLE_PARTITION_SIZE] = total;
+	});
+
+	if (vertex_triangles) {
+		vertex_triangles->resize(vertex_count);
+		for (idx_t i = 0; i < vertex_count; i++) {
+			(*vertex_triangles)[i] = triangles_of[i].load(std::memory_order_relaxed);
+		}
+	}
+	idx_t result = 0;
+	for (auto triangles : partition_triangles) {
+		result += triangles;
+	}
+	return result;
+}
+
+idx_t CountTriangles(ClientContext &context, CSR &csr, vector<int64_t> *vertex_triangles) {
+	if (csr.vsize <= 2) {
+		if (vertex_triangles) {
+			vertex_triangles->clear();
+		}
+		return 0;
+	}
+	if (csr.compact) {
+		return CountTrianglesInternal<int32_t>(context, csr, vertex_triangles);
+	}
+	return CountTrianglesInternal<int64_t>(context, csr, vertex_triangles);
+}
+
+} // namespace duckdb
@@ -0,0 +1,163 @@
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
+#include "duckdb/parallel/task_executor.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+
+namespace duckdb {
+
+class ParallelForTask : public BaseExecutorTask {
+public:
+	ParallelForTask(TaskExecutor &executor, idx_t begin, idx_t end,
+	                const std::function<void(idx_t begin, idx_t end)> &function)
+	    : BaseExecutorTask(executor), begin(begin), end(end), function(function) {
+	}
+
+	void ExecuteTask() override {
+		function(begin, end);
+	}
+
+private:
+	idx_t begin;
+	idx_t end;
+	const std::function<void(idx_t begin, idx_t end)> &function;
+};
+
+//! The computation that the thread runs, its ParallelFor passes are shared with the threads that wait for it
+static thread_local ParallelOnce *computing_once = nullptr;
+
+void ParallelFor(ClientContext &context, idx_t count, idx_t morsel_size,
+                 const std::function<void(idx_t begin, idx_t end)> &function) {
+	if (count == 0) {
+		return;
+	}
+	auto &scheduler = TaskScheduler::GetScheduler(context);
+	if (count <= morsel_size || scheduler.NumberOfThreads() <= 1) {
+		function(0, count);
+		return;
+	}
+	if (computing_once) {
+		computing_once->RunPass(context, count, morsel_size, function);
+		return;
+	}
+	TaskExecutor executor(context);
+	for (idx_t begin = 0; begin < count; begin += morsel_size) {
+		auto end = MinValue<idx_t>(begin + morsel_size, count);
+		executor.ScheduleTask(make_uniq<ParallelForTask>(executor, begin, end, function));
+	}
+	executor.WorkOnTasks();
+}
+
+struct ParallelOncePass {
+	ParallelOncePass(idx_t count, idx_t morsel_size, const std::function<void(idx_t begin, idx_t end)> &function)
+	    : count(count), morsel_size(morsel_size), morsel_count((count + morsel_size - 1) / morsel_size),
+	      function(function) {
+	}
+
+	bool Exhausted() const {
+		return next_morsel.load(std::memory_order_relaxed) >= morsel_count;
+	}
+	//! Runs morsels until none is left
+	void Work() {
+		for (auto morsel = next_morsel.fetch_add(1); morsel < morsel_count; morsel = next_morsel.fetch_add(1)) {
+			auto begin = morsel * morsel_size;
+			function(begin, MinValue<idx_t>(begin + morsel_size, count));
+		}
+	}
+
+	idx_t count;
+	idx_t morsel_size;
+	idx_t morsel_count;
+	const std::function<void(idx_t begin, idx_t end)> &function;
+	std::atomic<idx_t> next_morsel {0};
+	//! The waiting threads working on the pass and the first exception one of them threw, guarded by the lock of
+	//! the ParallelOnce
+	idx_t helpers = 0;
+	std::exception_ptr error;
+};
+
+void ParallelOnce::RunPass(ClientContext &context, idx_t count, idx_t morsel_size,
+                           const std::function<void(idx_t begin, idx_t end)> &function) {
+	ParallelOncePass current(count, morsel_size, function);
+	{
+		lock_guard<mutex> guard(lock);
+		pass = &current;
+	}
+	changed.notify_all();
+	// A ParallelFor within a morsel runs on its own
+	computing_once = nullptr;
+	std::exception_ptr pass_error;
+	try {
+		auto thread_count = static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+		ParallelFor(context, thread_count, 1, [&](idx_t, idx_t) { current.Work(); });
+	} catch (...) {
+		pass_error = std::current_exception();
+	}
+	computing_once = this;
+	std::unique_lock<mutex> guard(lock);
+	pass = nullptr;
+	changed.wait(guard, [&]() { return current.helpers == 0; });
+	if (!pass_error) {
+		pass_error = current.error;
+	}
+	guard.unlock();
+	if (pass_error) {
+		std::rethrow_exception(pass_error);
+	}
+}
+
+void ParallelOnce::Run(const std::function<void()> &compute) {
+	if (IsDone()) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+		return;
+	}
+	std::unique_lock<mutex> guard(lock);
+	if (!started) {
+		started = true;
+		guard.unlock();
+		auto previous_once = computing_once;
+		computing_once = this;
+		std::exception_ptr compute_error;
+		try {
+			compute();
+		} catch (...) {
+			compute_error = std::current_exception();
+		}
+		computing_once = previous_once;
+		guard.lock();
+		error = compute_error;
+		done.store(true, std::memory_order_release);
+		guard.unlock();
+		changed.notify_all();
+		if (compute_error) {
+			std::rethrow_exception(compute_error);
+		}
+		return;
+	}
+	while (!done.load(std::memory_order_relaxed)) {
+		if (!pass || pass->Exhausted()) {
+			changed.wait(guard);
+			continue;
+		}
+		auto &current = *pass;
+		current.helpers++;
+		guard.unlock();
+		std::exception_ptr helper_error;
+		try {
+			current.Work();
+		} catch (...) {
+			helper_error = std::current_exception();
+		}
+		guard.lock();
+		if (helper_error && !current.error) {
+			current.error = helper_error;
+		}
+		current.helpers--;
+		changed.notify_all();
+	}
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+} // namespace duckdb
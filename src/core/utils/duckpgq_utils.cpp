@@ -1,5 +1,6 @@
 #include "duckpgq/core/utils/duckpgq_utils.hpp"
 #include "duckpgq/common.hpp"
+#include "duckpgq_extension_callback.hpp"
 #include "duckdb/parser/statement/copy_statement.hpp"
 
 #include "duckpgq/core/functions/table/describe_property_graph.hpp"
@@ -23,19 +24,21 @@ shared_ptr<DuckPGQState> GetDuckPGQState(ClientContext &context, bool throw_not_
 	}
 	shared_ptr<DuckPGQState> state = make_shared_ptr<DuckPGQState>();
 	context.registered_state->Insert("duckpgq", state);
-	state->InitializeInternalTable(context);
-	auto connection = make_shared_ptr<Connection>(*context.db);
-	state->RetrievePropertyGraphs(connection);
+	// Connections opened before the extension was loaded did not get the commit state from the callback
+	state->commit_state = context.registered_state->GetOrCreate<DuckPGQCommitState>("duckpgq_commit");
+	// Only the first connection of the database reads the property graphs
+	state->property_graph_metadata = PropertyGraphMetadata::Get(context);
+	state->property_graph_metadata->EnsureLoaded(context);
 	return state;
 }
 
 // Function to get PropertyGraphInfo from DuckPGQState
 CreatePropertyGraphInfo *GetPropertyGraphInfo(const shared_ptr<DuckPGQState> &duckpgq_state, const string &pg_name) {
-	auto property_graph = duckpgq_state->registered_property_graphs.find(pg_name);
-	if (property_graph == duckpgq_state->registered_property_graphs.end()) {
+	auto property_graph = duckpgq_state->FindPropertyGraph(pg_name);
+	if (!property_graph) {
 		throw Exception(ExceptionType::INVALID, "Property graph " + pg_name + " not found");
 	}
-	return dynamic_cast<CreatePropertyGraphInfo *>(property_graph->second.get());
+	return property_graph;
 }
 
 // Function to validate the source node and edge table
@@ -59,7 +62,8 @@ shared_ptr<PropertyGraphTable> ValidateSourceNodeAndEdgeTable(CreatePropertyGrap
 
 // Function to create the SELECT node
 unique_ptr<SelectNode> CreateSelectNode(const shared_ptr<PropertyGraphTable> &edge_pg_entry,
-                                        const string &function_name, const string &function_alias) {
+                                        const string &function_name, const string &function_alias,
+                                        const vector<Value> &extra_arguments) {
 	auto select_node = make_uniq<SelectNode>();
 	std::vector<unique_ptr<ParsedExpression>> select_expression;
 
@@ -71,6 +75,9 @@ unique_ptr<SelectNode> CreateSelectNode(const shared_ptr<PropertyGraphTable> &ed
 	vector<unique_ptr<ParsedExpression>> function_children;
 	function_children.push_back(make_uniq<ConstantExpression>(Value::INTEGER(0)));
 	function_children.push_back(make_uniq<ColumnRefExpression>("rowid", edge_pg_entry->source_reference));
+	for (auto &argument : extra_arguments) {
+		function_children.push_back(make_uniq<ConstantExpression>(argument));
+	}
 	auto function = make_uniq<FunctionExpression>(function_name, std::move(function_children));
 
 	std::vector<unique_ptr<ParsedExpression>> addition_children;
@@ -118,4 +125,41 @@ unique_ptr<ColumnRefExpression> CreateColumnRefExpression(const string &column_n
 	return column_ref;
 }
 
+void SetNestedListResult(Vector &result, idx_t count, const vector<int64_t> &ids, idx_t list_size,
+                         const vector<idx_t> &row_offsets) {
+	vector<idx_t> list_offsets;
+	list_offsets.reserve(ids.size() / list_size + 1);
+	for (idx_t offset = 0; offset <= ids.size(); offset += list_size) {
+		list_offsets.push_back(offset);
+	}
+	vector<idx_t> row_list_offsets;
+	row_list_offsets.reserve(count + 1);
+	for (auto offset : row_offsets) {
+		row_list_offsets.push_back(offset / list_size);
+	}
+	SetNestedListResult(result, count, ids, list_offsets, row_list_offsets);
+}
+
+void SetNestedListResult(Vector &result, idx_t count, const vector<int64_t> &ids, const vector<idx_t> &list_offsets,
+                         const vector<idx_t> &row_offsets) {
+	auto list_count = list_offsets.size() - 1;
+	ListVector::Reserve(result, list_count);
+	auto &list_vector = ListVector::GetEntry(result);
+	ListVector::Reserve(list_vector, ids.size());
+	auto result_data = FlatVector::GetData<list_entry_t>(result);
+	auto list_data = FlatVector::GetData<list_entry_t>(list_vector);
+	auto id_data = FlatVector::GetData<int64_t>(ListVector::GetEntry(list_vector));
+	std::copy(ids.begin(), ids.end(), id_data);
+	for (idx_t list = 0; list < list_count; list++) {
+		list_data[list].offset = list_offsets[list];
+		list_data[list].length = list_offsets[list + 1] - list_offsets[list];
+	}
+	for (idx_t row = 0; row < count; row++) {
+		result_data[row].offset = row_offsets[row];
+		result_data[row].length = row_offsets[row + 1] - row_offsets[row];
+	}
+	ListVector::SetListSize(list_vector, ids.size());
+	ListVector::SetListSize(result, list_count);
+}
+
 } // namespace duckdb
@@ -0,0 +1,101 @@
+#include "duckpgq/core/utils/lane_set.hpp"
+
+// GCC and Clang compile functions for a wider x86-64 instruction set than the rest of the build with the target
+// attribute, the CPU features are checked before one of them is called. A build for AVX-512 has nothing wider.
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__) && !defined(__AVX512F__)
+#define DUCKPGQ_LANE_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace duckdb {
+
+#ifdef DUCKPGQ_LANE_DISPATCH
+
+//! UpdateFrontier of the words [i, word_count) of a vertex, 256 bits at a time and then one word at a time. Returns
+//! whether any of them has a lane left in [next].
+__attribute__((target("avx2"))) static bool UpdateFrontierWordsAVX2(uint64_t *next, uint64_t *seen, idx_t i,
+                                                                   idx_t word_count) {
+	auto result = _mm256_setzero_si256();
+	for (; i + 4 <= word_count; i += 4) {
+		auto next_words = reinterpret_cast<__m256i *>(next + i);
+		auto seen_words = reinterpret_cast<__m256i *>(seen + i);
+		auto seen_chunk = _mm256_loadu_si256(seen_words);
+		auto fresh = _mm256_andnot_si256(seen_chunk, _mm256_loadu_si256(next_words));
+		_mm256_storeu_si256(next_words, fresh);
+		_mm256_storeu_si256(seen_words, _mm256_or_si256(seen_chunk, fresh));
+		result = _mm256_or_si256(result, fresh);
+	}
+	uint64_t rest = 0;
+	for (; i < word_count; i++) {
+		auto fresh = next[i] & ~seen[i];
+		next[i] = fresh;
+		seen[i] |= fresh;
+		rest |= fresh;
+	}
+	return rest != 0 || !_mm256_testz_si256(result, result);
+}
+
+#ifndef __AVX2__
+__attribute__((target("avx2"))) static void UpdateFrontierRangeAVX2(uint64_t *next, uint64_t *seen,
+                                                                    idx_t word_count, idx_t begin, idx_t end,
+                                                                    vector<int64_t> &reached) {
+	for (auto vertex = begin; vertex < end; vertex++) {
+		if (UpdateFrontierWordsAVX2(next + vertex * word_count, seen + vertex * word_count, 0, word_count)) {
+			reached.push_back(static_cast<int64_t>(vertex));
+		}
+	}
+}
+#endif
+
+__attribute__((target("avx512f,avx2"))) static void UpdateFrontierRangeAVX512(uint64_t *next, uint64_t *seen,
+                                                                              idx_t word_count, idx_t begin,
+                                                                              idx_t end, vector<int64_t> &reached) {
+	for (auto vertex = begin; vertex < end; vertex++) {
+		auto vertex_next = next + vertex * word_count;
+		auto vertex_seen = seen + vertex * word_count;
+		auto result = _mm512_setzero_si512();
+		idx_t i = 0;
+		for (; i + 8 <= word_count; i += 8) {
+			// seen | next is the new seen, its lanes that were not in seen yet are the new next
+			auto seen_chunk = _mm512_loadu_si512(vertex_seen + i);
+			auto merged = _mm512_or_si512(seen_chunk, _mm512_loadu_si512(vertex_next + i));
+			auto fresh = _mm512_xor_si512(merged, seen_chunk);
+			_mm512_storeu_si512(vertex_next + i, fresh);
+			_mm512_storeu_si512(vertex_seen + i, merged);
+			result = _mm512_or_si512(result, fresh);
+		}
+		// Lane sets of fewer than 512 lanes are left to the 256-bit registers
+		auto rest = UpdateFrontierWordsAVX2(vertex_next, vertex_seen, i, word_count);
+		if (rest || _mm512_test_epi64_mask(result, result) != 0) {
+			reached.push_back(static_cast<int64_t>(vertex));
+		}
+	}
+}
+
+static lane_update_frontier_range_t SelectLaneUpdateFrontierRange() {
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) {
+		return UpdateFrontierRangeAVX512;
+	}
+#ifndef __AVX2__
+	if (__builtin_cpu_supports("avx2")) {
+		return UpdateFrontierRangeAVX2;
+	}
+#endif
+	return nullptr;
+}
+
+lane_update_frontier_range_t GetLaneUpdateFrontierRange() {
+	static const lane_update_frontier_range_t kernel = SelectLaneUpdateFrontierRange();
+	return kernel;
+}
+
+#else
+
+lane_update_frontier_range_t GetLaneUpdateFrontierRange() {
+	return nullptr;
+}
+
+#endif
+
+} // namespace duckdb
@@ -0,0 +1,51 @@
+#include "duckpgq/core/utils/memory_reservation.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+#include <duckpgq/core/utils/duckpgq_utils.hpp>
+
+namespace duckdb {
+
+MemoryReservation::~MemoryReservation() {
+	Shrink(0);
+}
+
+void MemoryReservation::Resize(ClientContext &context, idx_t new_size) {
+	lock_guard<mutex> guard(lock);
+	if (!buffer_manager) {
+		buffer_manager = &BufferManager::GetBufferManager(context);
+		database = context.db;
+	}
+	if (new_size <= size) {
+		buffer_manager->FreeReservedMemory(size - new_size);
+		size = new_size;
+		return;
+	}
+	while (true) {
+		try {
+			buffer_manager->ReserveMemory(new_size - size);
+			break;
+		} catch (OutOfMemoryException &) {
+			// The cached CSRs are not part of the buffer pool, so it cannot evict them itself
+			if (!GetDuckPGQState(context)->EvictCachedCSR()) {
+				throw;
+			}
+		}
+	}
+	size = new_size;
+}
+
+void MemoryReservation::Shrink(idx_t new_size) {
+	lock_guard<mutex> guard(lock);
+	if (!buffer_manager || new_size >= size) {
+		return;
+	}
+	// The BufferManager is gone once the database has been closed
+	auto db = database.lock();
+	if (db) {
+		buffer_manager->FreeReservedMemory(size - new_size);
+	}
+	size = new_size;
+}
+
+} // namespace duckdb
@@ -0,0 +1,489 @@
+#include "duckpgq/core/utils/msbfs.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckpgq/core/utils/csr_blocks.hpp"
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
+#include "duckpgq/core/utils/partitioned_csr.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+void MSBFSFrontierList::Reset() {
+	current.clear();
+	upcoming.clear();
+	stale.clear();
+	stale_valid = false;
+}
+
+BFSFrontier MSBFSFrontierList::Initialize(int64_t v_size, const CSRRanges &ranges, const vector<int64_t> &sources) {
+	BFSFrontier frontier;
+	Reset();
+	SetVisitedLimit(v_size);
+	current.assign(sources.begin(), sources.end());
+	std::sort(current.begin(), current.end());
+	current.erase(std::unique(current.begin(), current.end()), current.end());
+	for (auto i : current) {
+		frontier.vertex_count++;
+		frontier.edge_count += ranges.end[i] - ranges.begin[i];
+	}
+	// The caller guarantees that the vector the first step writes into holds no lanes
+	stale_valid = true;
+	AddVisited(current);
+	return frontier;
+}
+
+void MSBFSFrontierList::AddVisited(const vector<int64_t> &vertices, idx_t begin) {
+	if (visited_all) {
+		return;
+	}
+	if (visited.size() + vertices.size() - begin > visited_limit) {
+		visited_all = true;
+		visited.clear();
+		return;
+	}
+	visited.insert(visited.end(), vertices.begin() + begin, vertices.end());
+}
+
+void MSBFSFrontierList::Advance() {
+	// Sparse steps add vertices in the order they are reached, keep the frontier in vertex order
+	if (!std::is_sorted(upcoming.begin(), upcoming.end())) {
+		std::sort(upcoming.begin(), upcoming.end());
+	}
+	// The vector that held the current frontier is written by the next step
+	std::swap(stale, current);
+	std::swap(current, upcoming);
+	upcoming.clear();
+	stale_valid = true;
+	AddVisited(current);
+}
+
+void MSBFSFrontierList::Extend(const CSRRanges &ranges, const vector<int64_t> &vertices, BFSFrontier &frontier) {
+	// upcoming is empty between two steps
+	upcoming.assign(vertices.begin(), vertices.end());
+	std::sort(upcoming.begin(), upcoming.end());
+	upcoming.erase(std::unique(upcoming.begin(), upcoming.end()), upcoming.end());
+	auto current_size = current.size();
+	for (auto vertex : upcoming) {
+		if (!std::binary_search(current.begin(), current.begin() + current_size, vertex)) {
+			current.push_back(vertex);
+			frontier.vertex_count++;
+			frontier.edge_count += ranges.end[vertex] - ranges.begin[vertex];
+		}
+	}
+	upcoming.clear();
+	AddVisited(current, current_size);
+	std::inplace_merge(current.begin(), current.begin() + current_size, current.end());
+}
+
+void MSBFSSourceGroups::Initialize(idx_t count, const SelectionVector &sel, const ValidityMask &validity,
+                                   const int64_t *src_data) {
+	sources.clear();
+	unordered_map<int64_t, idx_t> group_of_source;
+	vector<idx_t> row_group(count, DConstants::INVALID_INDEX);
+	offsets.assign(1, 0);
+	for (idx_t row = 0; row < count; row++) {
+		auto src_pos = sel.get_index(row);
+		if (!validity.RowIsValid(src_pos)) {
+			continue;
+		}
+		auto entry = group_of_source.emplace(src_data[src_pos], sources.size());
+		if (entry.second) {
+			sources.push_back(src_data[src_pos]);
+			offsets.push_back(0);
+		}
+		row_group[row] = entry.first->second;
+		offsets[entry.first->second + 1]++;
+	}
+	for (idx_t group = 0; group < sources.size(); group++) {
+		offsets[group + 1] += offsets[group];
+	}
+	// Counting sort of the rows by group, keeping the row order within a group
+	rows.resize(offsets.back());
+	vector<idx_t> position(offsets.begin(), offsets.end() - 1);
+	for (idx_t row = 0; row < count; row++) {
+		if (row_group[row] != DConstants::INVALID_INDEX) {
+			rows[position[row_group[row]]++] = row;
+		}
+	}
+}
+
+//! Moves the lanes of [next] that are not in [seen] yet into [seen] for the vertices in [begin, end). [reached]
+//! receives the vertices that have a lane left in [next], the returned frontier counts them.
+template <idx_t LANES>
+static BFSFrontier MSBFSUpdateRange(idx_t begin, idx_t end, const CSRRanges &ranges, vector<LaneBitset<LANES>> &seen,
+                                    vector<LaneBitset<LANES>> &next, vector<int64_t> &reached) {
+	BFSFrontier frontier;
+	auto reached_begin = reached.size();
+	LaneBitset<LANES>::UpdateFrontierRange(next, seen, begin, end, reached);
+	for (auto it = reached.begin() + static_cast<std::ptrdiff_t>(reached_begin); it != reached.end(); ++it) {
+		frontier.vertex_count++;
+		frontier.edge_count += ranges.end[*it] - ranges.begin[*it];
+	}
+	return frontier;
+}
+
+//! Bottom-up step of the vertices in [begin, end), see MSBFSBottomUp
+template <idx_t LANES, class ID_T>
+static BFSFrontier MSBFSBottomUpRange(idx_t begin, idx_t end, const CSRRanges &ranges, const int64_t *rv,
+                                      const vector<ID_T> &re, const LaneBitset<LANES> &active,
+                                      vector<LaneBitset<LANES>> &seen, const vector<LaneBitset<LANES>> &visit,
+                                      vector<LaneBitset<LANES>> &next, vector<int64_t> &reached) {
+	BFSFrontier frontier;
+	for (auto i = begin; i < end; i++) {
+		next[i] = 0;
+		auto unseen = active & ~seen[i];
+		if (unseen.none()) {
+			continue;
+		}
+		LaneBitset<LANES> found;
+		for (auto offset = rv[i]; offset < rv[i + 1]; offset++) {
+			found |= visit[re[offset]];
+			if ((found & unseen) == unseen) {
+				break;
+			}
+		}
+		next[i] = found & unseen;
+		if (next[i].any()) {
+			seen[i] |= next[i];
+			frontier.vertex_count++;
+			frontier.edge_count += ranges.end[i] - ranges.begin[i];
+			reached.push_back(i);
+		}
+	}
+	return frontier;
+}
+
+//! Pushes [visit] along the outgoing edges
+template <idx_t LANES, class ID_T>
+static bool MSBFSTopDown(int64_t v_size, const CSRRanges &ranges, const vector<ID_T> &e,
+                         vector<LaneBitset<LANES>> &seen, const vector<LaneBitset<LANES>> &visit,
+                         vector<LaneBitset<LANES>> &next, BFSFrontier &frontier, MSBFSFrontierList &frontier_list) {
+	bool change = false;
+	frontier = BFSFrontier();
+	frontier_list.ClearNext(v_size, next);
+	if (frontier_list.IsSparse(v_size)) {
+		auto &touched = frontier_list.touched;
+		touched.clear();
+		for (auto i : frontier_list.Current()) {
+			for (auto offset = ranges.begin[i]; offset < ranges.end[i]; offset++) {
+				auto n = e[offset];
+				if (next[n].none()) {
+					touched.push_back(n);
+				}
+				next[n] = next[n] | visit[i];
+			}
+		}
+		for (auto n : touched) {
+			if (LaneBitset<LANES>::UpdateFrontier(next[n], seen[n])) {
+				change = true;
+				frontier.vertex_count++;
+				frontier.edge_count += ranges.end[n] - ranges.begin[n];
+				frontier_list.AddNext(n);
+			}
+		}
+		frontier_list.Advance();
+		return change;
+	}
+	for (auto i = 0; i < v_size; i++) {
+		if (visit[i].any()) {
+			for (auto offset = ranges.begin[i]; offset < ranges.end[i]; offset++) {
+				auto n = e[offset];
+				next[n] = next[n] | visit[i];
+			}
+		}
+	}
+	auto &reached = frontier_list.touched;
+	reached.clear();
+	frontier = MSBFSUpdateRange(0, v_size, ranges, seen, next, reached);
+	frontier_list.AddNext(reached);
+	frontier_list.Advance();
+	return frontier.vertex_count > 0;
+}
+
+//! Every vertex pulls [visit] from its incoming edges ([rv], [re]) and stops as soon as all of its unseen [active]
+//! lanes have been reached
+template <idx_t LANES, class ID_T>
+static bool MSBFSBottomUp(int64_t v_size, const CSRRanges &ranges, const int64_t *rv, const vector<ID_T> &re,
+                          const LaneBitset<LANES> &active, vector<LaneBitset<LANES>> &seen,
+                          const vector<LaneBitset<LANES>> &visit, vector<LaneBitset<LANES>> &next,
+                          BFSFrontier &frontier, MSBFSFrontierList &frontier_list) {
+	auto &reached = frontier_list.touched;
+	reached.clear();
+	frontier = MSBFSBottomUpRange(0, v_size, ranges, rv, re, active, seen, visit, next, reached);
+	frontier_list.AddNext(reached);
+	frontier_list.Advance();
+	return frontier.vertex_count > 0;
+}
+
+//! Splits the vertices into at most a few partitions per thread for the parallel steps. Returns 0 if a step over
+//! [v_size] vertices is better run on the calling thread.
+static idx_t MSBFSPartitionSize(ClientContext &context, int64_t v_size) {
+	auto threads = static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+	auto vertex_count = static_cast<idx_t>(v_size);
+	if (threads <= 1 || vertex_count < 2 * MSBFS_PARALLEL_MIN_PARTITION) {
+		return 0;
+	}
+	auto partition_count = MinValue<idx_t>(threads * 4, vertex_count / MSBFS_PARALLEL_MIN_PARTITION);
+	return (vertex_count + partition_count - 1) / partition_count;
+}
+
+//! Concatenates the frontiers of the partitions in vertex order
+static bool MSBFSMergePartitions(const vector<BFSFrontier> &partition_frontiers,
+                                 const vector<vector<int64_t>> &partition_reached, BFSFrontier &frontier,
+                                 MSBFSFrontierList &frontier_list) {
+	frontier = BFSFrontier();
+	for (idx_t p = 0; p < partition_frontiers.size(); p++) {
+		frontier.vertex_count += partition_frontiers[p].vertex_count;
+		frontier.edge_count += partition_frontiers[p].edge_count;
+		frontier_list.AddNext(partition_reached[p]);
+	}
+	frontier_list.Advance();
+	return frontier.vertex_count > 0;
+}
+
+//! MSBFSTopDown over a dense frontier using the TaskScheduler threads. Every block of [blocks] buffers the
+//! (destination, source) pairs of its outgoing edges by destination partition, then every destination partition
+//! merges the buffers addressed to it, so no two threads write the same vertex. The blocks hold about the same
+//! number of edges and split the lists of hubs, so a single high-degree vertex does not keep one thread busy. The
+//! buffers hold a pair per edge of [frontier] and are counted against memory_limit while the step runs.
+template <idx_t LANES, class ID_T>
+static bool MSBFSTopDownParallel(ClientContext &context, const CSRBlocks &blocks, idx_t partition_size,
+                                 int64_t v_size, const CSRRanges &ranges, const vector<ID_T> &e,
+                                 vector<LaneBitset<LANES>> &seen, const vector<LaneBitset<LANES>> &visit,
+                                 vector<LaneBitset<LANES>> &next, BFSFrontier &frontier,
+                                 MSBFSFrontierList &frontier_list) {
+	auto vertex_count = static_cast<idx_t>(v_size);
+	auto partition_count = (vertex_count + partition_size - 1) / partition_size;
+	MemoryReservation memory;
+	memory.Resize(context, frontier.edge_count * sizeof(pair<int64_t, int64_t>));
+	// pushed[b][p] holds the edges of block b that end in destination partition p
+	vector<vector<vector<pair<int64_t, int64_t>>>> pushed(blocks.blocks.size());
+	ParallelFor(context, blocks.blocks.size(), 1, [&](idx_t begin, idx_t end) {
+		for (auto b = begin; b < end; b++) {
+			auto &buffers = pushed[b];
+			buffers.resize(partition_count);
+			blocks.ForEachList(blocks.blocks[b], ranges, [&](int64_t i, int64_t list_begin, int64_t list_end) {
+				if (i >= v_size || visit[i].none()) {
+					return;
+				}
+				for (auto offset = list_begin; offset < list_end; offset++) {
+					auto n = static_cast<int64_t>(e[offset]);
+					buffers[n / partition_size].emplace_back(n, i);
+				}
+			});
+		}
+	});
+	vector<BFSFrontier> partition_frontiers(partition_count);
+	vector<vector<int64_t>> partition_reached(partition_count);
+	ParallelFor(context, partition_count, 1, [&](idx_t begin, idx_t end) {
+		for (auto partition = begin; partition < end; partition++) {
+			auto vertex_begin = partition * partition_size;
+			auto vertex_end = MinValue<idx_t>(vertex_begin + partition_size, vertex_count);
+			for (auto i = vertex_begin; i < vertex_end; i++) {
+				next[i] = 0;
+			}
+			for (auto &buffers : pushed) {
+				for (auto &edge : buffers[partition]) {
+					next[edge.first] |= visit[edge.second];
+				}
+			}
+			partition_frontiers[partition] =
+			    MSBFSUpdateRange(vertex_begin, vertex_end, ranges, seen, next, partition_reached[partition]);
+		}
+	});
+	return MSBFSMergePartitions(partition_frontiers, partition_reached, frontier, frontier_list);
+}
+
+//! MSBFSBottomUp using the TaskScheduler threads, every vertex only writes its own entries
+template <idx_t LANES, class ID_T>
+static bool MSBFSBottomUpParallel(ClientContext &context, idx_t partition_size, int64_t v_size, const CSRRanges &ranges,
+                                  const int64_t *rv, const vector<ID_T> &re, const LaneBitset<LANES> &active,
+                                  vector<LaneBitset<LANES>> &seen, const vector<LaneBitset<LANES>> &visit,
+                                  vector<LaneBitset<LANES>> &next, BFSFrontier &frontier,
+                                  MSBFSFrontierList &frontier_list) {
+	auto vertex_count = static_cast<idx_t>(v_size);
+	auto partition_count = (vertex_count + partition_size - 1) / partition_size;
+	vector<BFSFrontier> partition_frontiers(partition_count);
+	vector<vector<int64_t>> partition_reached(partition_count);
+	ParallelFor(context, partition_count, 1, [&](idx_t begin, idx_t end) {
+		for (auto partition = begin; partition < end; partition++) {
+			auto vertex_begin = partition * partition_size;
+			auto vertex_end = MinValue<idx_t>(vertex_begin + partition_size, vertex_count);
+			partition_frontiers[partition] = MSBFSBottomUpRange(vertex_begin, vertex_end, ranges, rv, re, active, seen,
+			                                                    visit, next, partition_reached[partition]);
+		}
+	});
+	return MSBFSMergePartitions(partition_frontiers, partition_reached, frontier, frontier_list);
+}
+
+//! MSBFSTopDown on a CSR whose adjacency lists are stored in [partitions]. Only the partitions that hold a vertex of
+//! the frontier are pinned, and at most one per thread at a time, so the edges never have to fit in memory at once.
+//! Dense frontiers are pushed in waves of one partition per thread, each of which buffers the (destination, source)
+//! pairs of its edges by destination range like MSBFSTopDownParallel.
+template <idx_t LANES>
+static bool MSBFSTopDownPartitioned(ClientContext &context, const CSRPartitions &partitions, int64_t v_size,
+                                    const CSRRanges &ranges, vector<LaneBitset<LANES>> &seen,
+                                    const vector<LaneBitset<LANES>> &visit, vector<LaneBitset<LANES>> &next,
+                                    BFSFrontier &frontier, MSBFSFrontierList &frontier_list) {
+	frontier = BFSFrontier();
+	frontier_list.ClearNext(v_size, next);
+	if (frontier_list.IsSparse(v_size)) {
+		// The frontier is in vertex order, so its vertices in one partition are next to each other
+		auto &current = frontier_list.Current();
+		auto &touched = frontier_list.touched;
+		touched.clear();
+		auto it = current.begin();
+		while (it != current.end()) {
+			auto partition = partitions.PartitionOf(*it);
+			auto vertex_end = static_cast<int64_t>(partitions.Get(partition).vertex_end);
+			auto slice_end = std::lower_bound(it, current.end(), vertex_end);
+			auto handle = partitions.Pin(partition);
+			for (; it != slice_end; ++it) {
+				auto i = *it;
+				for (auto offset = ranges.begin[i]; offset < ranges.end[i]; offset++) {
+					auto n = handle.Neighbor(offset);
+					if (next[n].none()) {
+						touched.push_back(n);
+					}
+					next[n] = next[n] | visit[i];
+				}
+			}
+		}
+		bool change = false;
+		for (auto n : touched) {
+			if (LaneBitset<LANES>::UpdateFrontier(next[n], seen[n])) {
+				change = true;
+				frontier.vertex_count++;
+				frontier.edge_count += ranges.end[n] - ranges.begin[n];
+				frontier_list.AddNext(n);
+			}
+		}
+		frontier_list.Advance();
+		return change;
+	}
+	vector<idx_t> pending;
+	for (idx_t p = 0; p < partitions.Count(); p++) {
+		auto &partition = partitions.Get(p);
+		for (auto i = partition.vertex_begin; i < partition.vertex_end; i++) {
+			if (visit[i].any() && ranges.end[i] > ranges.begin[i]) {
+				pending.push_back(p);
+				break;
+			}
+		}
+	}
+	auto vertex_count = static_cast<idx_t>(v_size);
+	auto threads = MaxValue<idx_t>(static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads()), 1);
+	auto range_count = MaxValue<idx_t>(MinValue<idx_t>(threads, vertex_count), 1);
+	auto range_size = (vertex_count + range_count - 1) / range_count;
+	// pushed[w][r] holds the edges of the w-th partition of the wave that end in destination range r
+	vector<vector<vector<pair<int64_t, int64_t>>>> pushed(threads, vector<vector<pair<int64_t, int64_t>>>(range_count));
+	MemoryReservation memory;
+	for (idx_t wave_begin = 0; wave_begin < pending.size(); wave_begin += threads) {
+		auto wave_size = MinValue<idx_t>(threads, pending.size() - wave_begin);
+		idx_t wave_edges = 0;
+		for (idx_t w = 0; w < wave_size; w++) {
+			wave_edges += partitions.Get(pending[wave_begin + w]).EdgeCount();
+		}
+		memory.Resize(context, wave_edges * sizeof(pair<int64_t, int64_t>));
+		ParallelFor(context, wave_size, 1, [&](idx_t begin, idx_t end) {
+			for (auto w = begin; w < end; w++) {
+				auto &buffers = pushed[w];
+				for (auto &buffer : buffers) {
+					buffer.clear();
+				}
+				auto &partition = partitions.Get(pending[wave_begin + w]);
+				auto handle = partitions.Pin(pending[wave_begin + w]);
+				for (auto i = partition.vertex_begin; i < partition.vertex_end; i++) {
+					if (visit[i].none()) {
+						continue;
+					}
+					for (auto offset = ranges.begin[i]; offset < ranges.end[i]; offset++) {
+						auto n = handle.Neighbor(offset);
+						buffers[static_cast<idx_t>(n) / range_size].emplace_back(n, static_cast<int64_t>(i));
+					}
+				}
+			}
+		});
+		ParallelFor(context, range_count, 1, [&](idx_t begin, idx_t end) {
+			for (auto r = begin; r < end; r++) {
+				for (idx_t w = 0; w < wave_size; w++) {
+					for (auto &edge : pushed[w][r]) {
+						next[edge.first] |= visit[edge.second];
+					}
+				}
+			}
+		});
+	}
+	auto &reached = frontier_list.touched;
+	reached.clear();
+	frontier = MSBFSUpdateRange(0, vertex_count, ranges, seen, next, reached);
+	frontier_list.AddNext(reached);
+	frontier_list.Advance();
+	return frontier.vertex_count > 0;
+}
+
+template <idx_t LANES, class ID_T>
+static bool MSBFSStepInternal(ClientContext &context, CSR &csr, BFSDirection direction, int64_t v_size,
+                              const LaneBitset<LANES> &active, vector<LaneBitset<LANES>> &seen,
+                              const vector<LaneBitset<LANES>> &visit, vector<LaneBitset<LANES>> &next,
+                              BFSFrontier &frontier, MSBFSFrontierList &frontier_list) {
+	auto ranges = csr.GetRanges();
+	auto partition_size = MSBFSPartitionSize(context, v_size);
+	if (direction == BFSDirection::TOP_DOWN) {
+		auto &e = csr.GetNeighbors<ID_T>();
+		// Sparse frontiers are too small to be worth splitting
+		if (partition_size == 0 || frontier_list.IsSparse(v_size)) {
+			return MSBFSTopDown<LANES, ID_T>(v_size, ranges, e, seen, visit, next, frontier, frontier_list);
+		}
+		auto blocks = csr.GetBlocks(CSRBlockEdges(context, csr.EdgeCount()));
+		return MSBFSTopDownParallel<LANES, ID_T>(context, *blocks, partition_size, v_size, ranges, e, seen, visit,
+		                                         next, frontier, frontier_list);
+	}
+	auto &reverse = csr.GetReverse(context);
+	auto rv = reinterpret_cast<int64_t *>(reverse.v.get());
+	auto &re = reverse.GetNeighbors<ID_T>();
+	if (partition_size == 0) {
+		return MSBFSBottomUp<LANES, ID_T>(v_size, ranges, rv, re, active, seen, visit, next, frontier,
+		                                  frontier_list);
+	}
+	return MSBFSBottomUpParallel<LANES, ID_T>(context, partition_size, v_size, ranges, rv, re, active, seen, visit,
+	                                          next, frontier, frontier_list);
+}
+
+template <idx_t LANES>
+bool MSBFSStep(ClientContext &context, CSR &csr, BFSDirectionPolicy &policy, int64_t v_size,
+               const LaneBitset<LANES> &active, vector<LaneBitset<LANES>> &seen, const vector<LaneBitset<LANES>> &visit,
+               vector<LaneBitset<LANES>> &next, BFSFrontier &frontier, MSBFSFrontierList &frontier_list) {
+	auto direction = policy.Next(frontier);
+	auto partitions = csr.GetPartitions();
+	if (partitions) {
+		// Bottom-up steps need the reverse CSR, which is built in memory
+		return MSBFSTopDownPartitioned<LANES>(context, *partitions, v_size, csr.GetRanges(), seen, visit, next,
+		                                      frontier, frontier_list);
+	}
+	if (csr.compact) {
+		return MSBFSStepInternal<LANES, int32_t>(context, csr, direction, v_size, active, seen, visit, next,
+		                                         frontier, frontier_list);
+	}
+	return MSBFSStepInternal<LANES, int64_t>(context, csr, direction, v_size, active, seen, visit, next, frontier,
+	                                         frontier_list);
+}
+
+template bool MSBFSStep<64>(ClientContext &context, CSR &csr, BFSDirectionPolicy &policy, int64_t v_size,
+                            const LaneBitset<64> &active, vector<LaneBitset<64>> &seen,
+                            const vector<LaneBitset<64>> &visit, vector<LaneBitset<64>> &next, BFSFrontier &frontier,
+                            MSBFSFrontierList &frontier_list);
+template bool MSBFSStep<128>(ClientContext &context, CSR &csr, BFSDirectionPolicy &policy, int64_t v_size,
+                             const LaneBitset<128> &active, vector<LaneBitset<128>> &seen,
+                             const vector<LaneBitset<128>> &visit, vector<LaneBitset<128>> &next, BFSFrontier &frontier,
+                             MSBFSFrontierList &frontier_list);
+template bool MSBFSStep<256>(ClientContext &context, CSR &csr, BFSDirectionPolicy &policy, int64_t v_size,
+                             const LaneBitset<256> &active, vector<LaneBitset<256>> &seen,
+                             const vector<LaneBitset<256>> &visit, vector<LaneBitset<256>> &next, BFSFrontier &frontier,
+                             MSBFSFrontierList &frontier_list);
+template bool MSBFSStep<LANE_LIMIT>(ClientContext &context, CSR &csr, BFSDirectionPolicy &policy, int64_t v_size,
+                                    const LaneBitset<LANE_LIMIT> &active, vector<LaneBitset<LANE_LIMIT>> &seen,
+                                    const vector<LaneBitset<LANE_LIMIT>> &visit, vector<LaneBitset<LANE_LIMIT>> &next,
+                                    BFSFrontier &frontier, MSBFSFrontierList &frontier_list);
+
+} // namespace duckdb
@@ -0,0 +1,61 @@
+#include "duckpgq/core/utils/partitioned_csr.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+CSRPartitionHandle::CSRPartitionHandle(BufferHandle handle_p, const CSRPartition &partition)
+    : handle(std::move(handle_p)), edge_begin(partition.edge_begin) {
+	if (handle.IsValid()) {
+		neighbors = reinterpret_cast<int64_t *>(handle.Ptr());
+		edge_ids = neighbors + partition.EdgeCount();
+	}
+}
+
+CSRPartitions::CSRPartitions(ClientContext &context, const std::atomic<int64_t> *starts, idx_t vertex_count,
+                             idx_t edges_per_partition)
+    : buffer_manager(BufferManager::GetBufferManager(context)) {
+	D_ASSERT(edges_per_partition > 0);
+	idx_t vertex = 0;
+	while (vertex < vertex_count) {
+		CSRPartition partition;
+		partition.vertex_begin = vertex;
+		partition.edge_begin = starts[vertex].load();
+		// Always take at least one vertex, which may have more edges than edges_per_partition
+		vertex++;
+		while (vertex < vertex_count &&
+		       static_cast<idx_t>(starts[vertex + 1].load() - partition.edge_begin) <= edges_per_partition) {
+			vertex++;
+		}
+		partition.vertex_end = vertex;
+		partition.edge_end = starts[vertex].load();
+		if (partition.EdgeCount() > 0) {
+			// Not destroyable, the BufferManager writes the block to the temporary directory when it is evicted
+			auto handle = buffer_manager.Allocate(MemoryTag::EXTENSION, partition.EdgeCount() * 2 * sizeof(int64_t),
+			                                      false);
+			partition.block = handle.GetBlockHandle();
+		}
+		partitions.push_back(std::move(partition));
+	}
+	edge_count = vertex_count == 0 ? 0 : static_cast<idx_t>(starts[vertex_count].load());
+}
+
+idx_t CSRPartitions::PartitionOf(int64_t vertex) const {
+	auto entry = std::upper_bound(
+	    partitions.begin(), partitions.end(), static_cast<idx_t>(vertex),
+	    [](idx_t target, const CSRPartition &partition) { return target < partition.vertex_end; });
+	D_ASSERT(entry != partitions.end());
+	return static_cast<idx_t>(entry - partitions.begin());
+}
+
+CSRPartitionHandle CSRPartitions::Pin(idx_t partition) const {
+	auto &entry = partitions[partition];
+	if (!entry.block) {
+		return CSRPartitionHandle(BufferHandle(), entry);
+	}
+	auto block = entry.block;
+	return CSRPartitionHandle(buffer_manager.Pin(block), entry);
+}
+
+} // namespace duckdb
@@ -0,0 +1,81 @@
+#include "duckpgq/core/utils/personalized_pagerank.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+PersonalizedPageRankPush::PersonalizedPageRankPush(CSR &csr_p, double damping_p, double tolerance_p)
+    : csr(csr_p), v(reinterpret_cast<const int64_t *>(csr_p.v.get())), damping(damping_p), tolerance(tolerance_p),
+      estimate(csr_p.vsize - 2, 0.0), residual(csr_p.vsize - 2, 0.0), queued(csr_p.vsize - 2, 0) {
+}
+
+void PersonalizedPageRankPush::AddResidual(int64_t vertex, double value) {
+	if (value <= 0) {
+		return;
+	}
+	if (residual[vertex] == 0 && estimate[vertex] == 0) {
+		touched.push_back(vertex);
+	}
+	residual[vertex] += value;
+	if (!queued[vertex] && residual[vertex] > tolerance * static_cast<double>(MaxValue<int64_t>(Degree(vertex), 1))) {
+		queued[vertex] = 1;
+		queue.push_back(vertex);
+	}
+}
+
+template <class ID_T>
+void PersonalizedPageRankPush::RunInternal(int64_t seed) {
+	auto &e = csr.GetNeighbors<ID_T>();
+	AddResidual(seed, 1.0);
+	// FIFO order, without compaction the queue holds every push of the seed
+	for (idx_t head = 0; head < queue.size(); head++) {
+		auto vertex = queue[head];
+		queued[vertex] = 0;
+		auto mass = residual[vertex];
+		residual[vertex] = 0;
+		estimate[vertex] += (1 - damping) * mass;
+		auto degree = Degree(vertex);
+		if (degree == 0) {
+			AddResidual(seed, damping * mass);
+			continue;
+		}
+		auto share = damping * mass / static_cast<double>(degree);
+		for (auto offset = v[vertex]; offset < v[vertex + 1]; offset++) {
+			AddResidual(static_cast<int64_t>(e[offset]), share);
+		}
+	}
+	queue.clear();
+}
+
+void PersonalizedPageRankPush::Run(int64_t seed) {
+	for (auto vertex : touched) {
+		estimate[vertex] = 0;
+		residual[vertex] = 0;
+	}
+	touched.clear();
+	if (csr.compact) {
+		RunInternal<int32_t>(seed);
+	} else {
+		RunInternal<int64_t>(seed);
+	}
+}
+
+void PersonalizedPageRankPush::TopK(idx_t k, vector<std::pair<int64_t, double>> &result) const {
+	result.clear();
+	for (auto vertex : touched) {
+		if (estimate[vertex] > 0) {
+			result.emplace_back(vertex, estimate[vertex]);
+		}
+	}
+	auto greater = [](const std::pair<int64_t, double> &a, const std::pair<int64_t, double> &b) {
+		return a.second > b.second || (a.second == b.second && a.first < b.first);
+	};
+	if (k < result.size()) {
+		std::partial_sort(result.begin(), result.begin() + static_cast<int64_t>(k), result.end(), greater);
+		result.resize(k);
+	} else {
+		std::sort(result.begin(), result.end(), greater);
+	}
+}
+
+} // namespace duckdb
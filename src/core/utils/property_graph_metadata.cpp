@@ -0,0 +1,194 @@
+#include "duckpgq/core/utils/property_graph_metadata.hpp"
+#include "duckdb/main/connection.hpp"
+
+#include <duckpgq_state.hpp>
+
+namespace duckdb {
+
+shared_ptr<PropertyGraphMetadata> PropertyGraphMetadata::Get(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<PropertyGraphMetadata>(ObjectType());
+}
+
+void PropertyGraphMetadata::EnsureLoaded(ClientContext &context) {
+	lock_guard<mutex> guard(lock);
+	if (loaded) {
+		return;
+	}
+	DuckPGQState::InitializeInternalTable(context);
+	Connection connection(*context.db);
+	// The vertex tables of a graph are registered before the edge tables that reference them
+	auto result = connection.Query("SELECT * FROM __duckpgq_internal ORDER BY NOT is_vertex_table");
+	if (result->HasError()) {
+		throw TransactionException(result->GetError());
+	}
+	for (idx_t row = 0; row < result->RowCount(); row++) {
+		unparsed_rows[result->GetValue(0, row).GetValue<string>()].push_back(row);
+	}
+	if (!unparsed_rows.empty()) {
+		internal_rows = std::move(result);
+	}
+	loaded = true;
+}
+
+unique_ptr<CreateInfo> PropertyGraphMetadata::CopyPropertyGraph(const string &pg_name) {
+	lock_guard<mutex> guard(lock);
+	auto unparsed = unparsed_rows.find(pg_name);
+	if (unparsed != unparsed_rows.end()) {
+		auto rows = std::move(unparsed->second);
+		unparsed_rows.erase(unparsed);
+		ParsePropertyGraph(pg_name, rows);
+		if (unparsed_rows.empty()) {
+			internal_rows.reset();
+		}
+	}
+	auto entry = property_graphs.find(pg_name);
+	if (entry == property_graphs.end()) {
+		return nullptr;
+	}
+	return entry->second->Copy();
+}
+
+void PropertyGraphMetadata::RegisterPropertyGraph(unique_ptr<CreateInfo> info) {
+	lock_guard<mutex> guard(lock);
+	auto &pg_name = info->Cast<CreatePropertyGraphInfo>().property_graph_name;
+	unparsed_rows.erase(pg_name);
+	property_graphs[pg_name] = std::move(info);
+	version++;
+}
+
+void PropertyGraphMetadata::DropPropertyGraph(const string &pg_name) {
+	lock_guard<mutex> guard(lock);
+	unparsed_rows.erase(pg_name);
+	property_graphs.erase(pg_name);
+	version++;
+}
+
+bool PropertyGraphMetadata::UsesTable(const string &table_name) {
+	lock_guard<mutex> guard(lock);
+	for (auto &graph : property_graphs) {
+		auto &pg_info = graph.second->Cast<CreatePropertyGraphInfo>();
+		for (auto &table : pg_info.vertex_tables) {
+			if (StringUtil::CIEquals(table->table_name, table_name)) {
+				return true;
+			}
+		}
+		for (auto &table : pg_info.edge_tables) {
+			if (StringUtil::CIEquals(table->table_name, table_name)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void PropertyGraphMetadata::ParsePropertyGraph(const string &pg_name, const vector<idx_t> &rows) {
+	auto &result = *internal_rows;
+	auto column_count = result.ColumnCount();
+	for (auto row : rows) {
+		auto table = make_shared_ptr<PropertyGraphTable>();
+
+		// Extract and validate common properties
+		table->table_name = result.GetValue(1, row).GetValue<string>();
+		table->main_label = result.GetValue(2, row).GetValue<string>();
+		table->is_vertex_table = result.GetValue(3, row).GetValue<bool>();
+
+		// Handle discriminator and sub-labels
+		const auto &discriminator = result.GetValue(10, row).GetValue<string>();
+		if (discriminator != "NULL") {
+			table->discriminator = discriminator;
+			auto sublabels = ListValue::GetChildren(result.GetValue(11, row));
+			for (const auto &sublabel : sublabels) {
+				table->sub_labels.push_back(sublabel.GetValue<string>());
+			}
+		}
+
+		// Extract catalog and schema names
+		if (column_count > 12) {
+			table->catalog_name = result.GetValue(12, row).GetValue<string>();
+			table->schema_name = result.GetValue(13, row).GetValue<string>();
+		} else {
+			table->catalog_name = "";
+			table->schema_name = DEFAULT_SCHEMA;
+		}
+		if (column_count > 14) {
+			table->source_catalog = result.GetValue(14, row).GetValue<string>();
+			table->source_schema = result.GetValue(15, row).GetValue<string>();
+			table->destination_catalog = result.GetValue(16, row).GetValue<string>();
+			table->destination_schema = result.GetValue(17, row).GetValue<string>();
+		} else {
+			table->source_catalog = "";
+			table->schema_name = DEFAULT_SCHEMA;
+			table->destination_catalog = "";
+			table->destination_schema = DEFAULT_SCHEMA;
+		}
+		if (column_count > 18) {
+			// read properties
+			auto properties = ListValue::GetChildren(result.GetValue(18, row));
+			for (const auto &property : properties) {
+				table->column_names.push_back(property.GetValue<string>());
+			}
+			auto column_aliases = ListValue::GetChildren(result.GetValue(19, row));
+			for (const auto &alias : column_aliases) {
+				table->column_aliases.push_back(alias.GetValue<string>());
+			}
+		} else {
+			table->all_columns = true;
+		}
+
+		// Additional edge-specific handling
+		if (!table->is_vertex_table) {
+			ParseEdgeSpecificFields(row, *table);
+		}
+
+		RegisterPropertyGraphTable(table, pg_name, table->is_vertex_table);
+	}
+}
+
+void PropertyGraphMetadata::ParseEdgeSpecificFields(idx_t row, PropertyGraphTable &table) {
+	auto &result = *internal_rows;
+	table.source_reference = result.GetValue(4, row).GetValue<string>();
+	ExtractListValues(result.GetValue(5, row), table.source_pk);
+	ExtractListValues(result.GetValue(6, row), table.source_fk);
+	table.destination_reference = result.GetValue(7, row).GetValue<string>();
+	ExtractListValues(result.GetValue(8, row), table.destination_pk);
+	ExtractListValues(result.GetValue(9, row), table.destination_fk);
+}
+
+void PropertyGraphMetadata::ExtractListValues(const Value &list_value, vector<string> &output) {
+	auto children = ListValue::GetChildren(list_value);
+	output.reserve(output.size() + children.size());
+	for (const auto &child : children) {
+		output.push_back(child.GetValue<string>());
+	}
+}
+
+void PropertyGraphMetadata::RegisterPropertyGraphTable(const shared_ptr<PropertyGraphTable> &table,
+                                                       const string &graph_name, bool is_vertex) {
+	// Ensure the property graph exists in the registry
+	if (property_graphs.find(graph_name) == property_graphs.end()) {
+		property_graphs[graph_name] = make_uniq<CreatePropertyGraphInfo>(graph_name);
+	}
+
+	auto &pg_info = property_graphs[graph_name]->Cast<CreatePropertyGraphInfo>();
+	pg_info.label_map[table->main_label] = table;
+
+	if (!table->discriminator.empty()) {
+		for (const auto &label : table->sub_labels) {
+			pg_info.label_map[label] = table;
+		}
+	}
+
+	if (is_vertex) {
+		pg_info.vertex_tables.push_back(table);
+	} else {
+		table->source_pg_table =
+		    pg_info.GetTableByName(table->source_catalog, table->source_schema, table->source_reference);
+		D_ASSERT(table->source_pg_table);
+		table->destination_pg_table =
+		    pg_info.GetTableByName(table->destination_catalog, table->destination_schema, table->destination_reference);
+		D_ASSERT(table->destination_pg_table);
+		pg_info.edge_tables.push_back(table);
+	}
+}
+
+} // namespace duckdb
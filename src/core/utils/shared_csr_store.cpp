@@ -0,0 +1,232 @@
+#include "duckpgq/core/utils/shared_csr_store.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/parallel/task.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+shared_ptr<SharedCSRStore> SharedCSRStore::Get(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<SharedCSRStore>(ObjectType());
+}
+
+shared_ptr<CSR> SharedCSRStore::Lookup(const string &key) {
+	auto current = std::atomic_load(&entries);
+	auto entry = current->find(key);
+	if (entry == current->end()) {
+		return nullptr;
+	}
+	entry->second->last_used = ++clock;
+	entry->second->hits++;
+	return entry->second->csr;
+}
+
+SharedCSRStore::EntryMap SharedCSRStore::CopyEntries() const {
+	return *std::atomic_load(&entries);
+}
+
+void SharedCSRStore::Swap(EntryMap new_entries) {
+	std::atomic_store(&entries, std::shared_ptr<const EntryMap>(std::make_shared<EntryMap>(std::move(new_entries))));
+}
+
+void SharedCSRStore::Publish(const string &key, shared_ptr<SharedCSREntry> entry, idx_t capacity,
+                             idx_t built_generation) {
+	lock_guard<mutex> guard(write_lock);
+	// A write committed while the CSR was built, Clear holds the lock to increment the generation
+	if (built_generation != generation) {
+		return;
+	}
+	auto new_entries = CopyEntries();
+	entry->last_used = ++clock;
+	new_entries[key] = std::move(entry);
+	while (new_entries.size() > capacity) {
+		auto lru_entry = new_entries.end();
+		for (auto it = new_entries.begin(); it != new_entries.end(); it++) {
+			// A CSR that a query still uses would stay in memory anyway
+			if (it->second->csr.use_count() > 1) {
+				continue;
+			}
+			if (lru_entry == new_entries.end() || it->second->last_used < lru_entry->second->last_used) {
+				lru_entry = it;
+			}
+		}
+		if (lru_entry == new_entries.end()) {
+			break;
+		}
+		new_entries.erase(lru_entry);
+	}
+	Swap(std::move(new_entries));
+}
+
+void SharedCSRStore::Clear() {
+	lock_guard<mutex> guard(write_lock);
+	generation++;
+	Swap(EntryMap());
+}
+
+bool SharedCSRStore::EvictLeastRecentlyUsed() {
+	// Called while a reservation waits for memory, a writer that holds the lock may be the one waiting
+	std::unique_lock<mutex> guard(write_lock, std::try_to_lock);
+	if (!guard.owns_lock()) {
+		return false;
+	}
+	auto new_entries = CopyEntries();
+	auto lru_entry = new_entries.end();
+	for (auto it = new_entries.begin(); it != new_entries.end(); it++) {
+		if (it->second->csr.use_count() > 1) {
+			continue;
+		}
+		if (lru_entry == new_entries.end() || it->second->last_used < lru_entry->second->last_used) {
+			lru_entry = it;
+		}
+	}
+	if (lru_entry == new_entries.end()) {
+		return false;
+	}
+	new_entries.erase(lru_entry);
+	Swap(std::move(new_entries));
+	return true;
+}
+
+std::shared_ptr<const SharedCSRStore::EntryMap> SharedCSRStore::Entries() const {
+	return std::atomic_load(&entries);
+}
+
+bool SharedCSRStore::IsPrebuildEnabled(ClientContext &context) {
+	Value prebuild;
+	return context.TryGetCurrentSetting("duckpgq_csr_prebuild", prebuild) && !prebuild.IsNull() &&
+	       prebuild.GetValue<bool>();
+}
+
+bool CSRPrebuildTaskState::Start() {
+	lock_guard<mutex> guard(lock);
+	if (status != Status::QUEUED) {
+		return false;
+	}
+	status = Status::RUNNING;
+	return true;
+}
+
+void CSRPrebuildTaskState::Finish() {
+	{
+		lock_guard<mutex> guard(lock);
+		status = Status::FINISHED;
+	}
+	finished.notify_all();
+}
+
+bool CSRPrebuildTaskState::IsQueued() {
+	lock_guard<mutex> guard(lock);
+	return status == Status::QUEUED;
+}
+
+void CSRPrebuildTaskState::WithdrawOrWait() {
+	std::unique_lock<mutex> guard(lock);
+	if (status == Status::QUEUED) {
+		// Its requests stay queued for the next task
+		status = Status::FINISHED;
+		return;
+	}
+	finished.wait(guard, [&]() { return status == Status::FINISHED; });
+}
+
+CSRPrebuildTasks::~CSRPrebuildTasks() {
+	for (auto &task : tasks) {
+		task->WithdrawOrWait();
+	}
+}
+
+class CSRPrebuildTask : public Task {
+public:
+	CSRPrebuildTask(shared_ptr<SharedCSRStore> store_p, DatabaseInstance &db,
+	                shared_ptr<CSRPrebuildTaskState> state_p)
+	    : store(std::move(store_p)), db(db), state(std::move(state_p)) {
+	}
+
+	TaskExecutionResult Execute(TaskExecutionMode mode) override {
+		// Once withdrawn, the database may be closing
+		if (!state->Start()) {
+			return TaskExecutionResult::TASK_FINISHED;
+		}
+		try {
+			store->RunPrebuilds(db);
+		} catch (std::exception &) {
+			// The queries that need the CSRs build them instead
+		}
+		state->Finish();
+		return TaskExecutionResult::TASK_FINISHED;
+	}
+
+private:
+	shared_ptr<SharedCSRStore> store;
+	DatabaseInstance &db;
+	shared_ptr<CSRPrebuildTaskState> state;
+};
+
+void SharedCSRStore::SchedulePrebuild(ClientContext &context, const vector<CSRPrebuildRequest> &requests,
+                                      CSRPrebuildTasks &tasks) {
+	if (requests.empty()) {
+		return;
+	}
+	auto store = Get(context);
+	{
+		lock_guard<mutex> guard(store->prebuild_lock);
+		for (auto &request : requests) {
+			auto queued = std::find_if(store->prebuild_queue.begin(), store->prebuild_queue.end(),
+			                           [&](const CSRPrebuildRequest &other) {
+				                           return other.pg_name == request.pg_name &&
+				                                  other.edge_label == request.edge_label &&
+				                                  other.directed == request.directed;
+			                           });
+			if (queued == store->prebuild_queue.end()) {
+				store->prebuild_queue.push_back(request);
+			}
+		}
+		// A task takes the queue under the lock once it started, so a burst of writes is followed by a single build
+		if (!tasks.tasks.empty() && tasks.tasks.back()->IsQueued()) {
+			return;
+		}
+	}
+	auto &scheduler = TaskScheduler::GetScheduler(context);
+	if (scheduler.NumberOfThreads() <= 1) {
+		// There is no thread to run the task, the connection builds the CSRs itself
+		store->RunPrebuilds(*context.db);
+		return;
+	}
+	tasks.tasks.erase(std::remove_if(tasks.tasks.begin(), tasks.tasks.end(),
+	                                 [](const shared_ptr<CSRPrebuildTaskState> &task) {
+		                                 lock_guard<mutex> guard(task->lock);
+		                                 return task->status == CSRPrebuildTaskState::Status::FINISHED;
+	                                 }),
+	                  tasks.tasks.end());
+	if (!tasks.producer) {
+		tasks.producer = scheduler.CreateProducer();
+	}
+	auto state = make_shared_ptr<CSRPrebuildTaskState>();
+	tasks.tasks.push_back(state);
+	scheduler.ScheduleTask(*tasks.producer, make_shared_ptr<CSRPrebuildTask>(store, *context.db, std::move(state)));
+}
+
+void SharedCSRStore::RunPrebuilds(DatabaseInstance &db) {
+	Connection connection(db);
+	connection.Query("SET SESSION duckpgq_shared_csr_cache = true");
+	while (true) {
+		vector<CSRPrebuildRequest> requests;
+		{
+			lock_guard<mutex> guard(prebuild_lock);
+			if (prebuild_queue.empty()) {
+				return;
+			}
+			requests.swap(prebuild_queue);
+		}
+		for (auto &request : requests) {
+			// Fails if the property graph was dropped in the meantime, its next query builds the CSR instead
+			connection.Query("SELECT * FROM duckpgq_prebuild_csr(" + KeywordHelper::WriteQuoted(request.pg_name, '\'') +
+			                 ", " + KeywordHelper::WriteQuoted(request.edge_label, '\'') + ", " +
+			                 (request.directed ? "true" : "false") + ")");
+		}
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,59 @@
+#include "duckpgq/core/utils/traversal_metrics.hpp"
+
+namespace duckdb {
+
+shared_ptr<TraversalMetrics> TraversalMetrics::Get(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<TraversalMetrics>(ObjectType());
+}
+
+string TraversalMetrics::KernelName(TraversalKernel kernel) {
+	switch (kernel) {
+	case TraversalKernel::CSR_BUILD:
+		return "csr_build";
+	case TraversalKernel::ITERATIVE_LENGTH:
+		return "iterativelength";
+	case TraversalKernel::SHORTEST_PATH:
+		return "shortestpath";
+	case TraversalKernel::CHEAPEST_PATH_LENGTH:
+		return "cheapest_path_length";
+	case TraversalKernel::PAGERANK:
+		return "pagerank";
+	default:
+		throw InternalException("Unknown traversal kernel");
+	}
+}
+
+void TraversalMetrics::Add(TraversalKernel kernel, const TraversalCounters &counters) {
+	auto &entry = kernels[static_cast<idx_t>(kernel)];
+	entry.calls += counters.calls;
+	entry.iterations += counters.iterations;
+	entry.edges += counters.edges;
+	entry.active_lanes += counters.active_lanes;
+	entry.scratch_bytes += counters.scratch_bytes;
+	entry.microseconds += counters.microseconds;
+}
+
+TraversalCounters TraversalMetrics::Read(TraversalKernel kernel) const {
+	auto &entry = kernels[static_cast<idx_t>(kernel)];
+	TraversalCounters result;
+	result.calls = entry.calls.load();
+	result.iterations = entry.iterations.load();
+	result.edges = entry.edges.load();
+	result.active_lanes = entry.active_lanes.load();
+	result.scratch_bytes = entry.scratch_bytes.load();
+	result.microseconds = entry.microseconds.load();
+	return result;
+}
+
+TraversalMetricsScope::TraversalMetricsScope(TraversalMetrics &metrics, TraversalKernel kernel)
+    : metrics(metrics), kernel(kernel), start(std::chrono::steady_clock::now()) {
+	counters.calls = 1;
+}
+
+TraversalMetricsScope::~TraversalMetricsScope() {
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	counters.microseconds = static_cast<idx_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+	metrics.Add(kernel, counters);
+}
+
+} // namespace duckdb
@@ -0,0 +1,483 @@
+#include "duckpgq/core/utils/weighted_path.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
+#include "duckpgq/core/utils/memory_reservation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace duckdb {
+
+RadixHeap::RadixHeap(idx_t vertex_count)
+    : buckets(BUCKET_COUNT), keys(vertex_count), positions(vertex_count, DConstants::INVALID_INDEX),
+      bucket_of(vertex_count) {
+}
+
+idx_t RadixHeap::BucketOf(uint64_t key) const {
+	if (key == last) {
+		return 0;
+	}
+	return 64 - static_cast<idx_t>(__builtin_clzll(key ^ last));
+}
+
+void RadixHeap::Insert(int64_t vertex, uint64_t key) {
+	auto bucket = BucketOf(key);
+	keys[vertex] = key;
+	bucket_of[vertex] = static_cast<uint8_t>(bucket);
+	positions[vertex] = buckets[bucket].size();
+	buckets[bucket].push_back(vertex);
+}
+
+void RadixHeap::Remove(int64_t vertex) {
+	auto &bucket = buckets[bucket_of[vertex]];
+	auto position = positions[vertex];
+	auto moved = bucket.back();
+	bucket[position] = moved;
+	positions[moved] = position;
+	bucket.pop_back();
+	positions[vertex] = DConstants::INVALID_INDEX;
+}
+
+void RadixHeap::Push(int64_t vertex, uint64_t key) {
+	D_ASSERT(key >= last);
+	if (positions[vertex] != DConstants::INVALID_INDEX) {
+		if (key >= keys[vertex]) {
+			return;
+		}
+		Remove(vertex);
+	} else {
+		size++;
+	}
+	Insert(vertex, key);
+}
+
+int64_t RadixHeap::Pop() {
+	D_ASSERT(size > 0);
+	if (buckets[0].empty()) {
+		// Move the smallest key to last, the keys of the first non-empty bucket all move to lower buckets
+		idx_t bucket = 1;
+		while (buckets[bucket].empty()) {
+			bucket++;
+		}
+		redistribute.swap(buckets[bucket]);
+		last = keys[redistribute[0]];
+		for (auto vertex : redistribute) {
+			last = MinValue<uint64_t>(last, keys[vertex]);
+		}
+		for (auto vertex : redistribute) {
+			Insert(vertex, keys[vertex]);
+		}
+		redistribute.clear();
+	}
+	auto vertex = buckets[0].back();
+	buckets[0].pop_back();
+	positions[vertex] = DConstants::INVALID_INDEX;
+	size--;
+	return vertex;
+}
+
+void RadixHeap::Clear() {
+	for (auto &bucket : buckets) {
+		for (auto vertex : bucket) {
+			positions[vertex] = DConstants::INVALID_INDEX;
+		}
+		bucket.clear();
+	}
+	last = 0;
+	size = 0;
+}
+
+static uint64_t RadixKey(int32_t value) {
+	return static_cast<uint64_t>(value);
+}
+
+static uint64_t RadixKey(int64_t value) {
+	return static_cast<uint64_t>(value);
+}
+
+static uint64_t RadixKey(double value) {
+	// The bit patterns of non-negative doubles are ordered like their values, -0.0 is mapped to 0
+	if (value == 0) {
+		return 0;
+	}
+	uint64_t key;
+	memcpy(&key, &value, sizeof(key));
+	return key;
+}
+
+//! The bucket width is at least max weight / DELTA_STEPPING_MAX_BUCKET_SPAN, which bounds the number of buckets
+static constexpr double DELTA_STEPPING_MAX_BUCKET_SPAN = 4096;
+
+template <class T>
+static T BucketWidth(const CSRWeightStatistics &statistics);
+
+template <>
+int32_t BucketWidth<int32_t>(const CSRWeightStatistics &statistics) {
+	auto width = MaxValue<double>(statistics.mean, statistics.max / DELTA_STEPPING_MAX_BUCKET_SPAN);
+	return MaxValue<int32_t>(1, static_cast<int32_t>(std::ceil(width)));
+}
+
+template <>
+int64_t BucketWidth<int64_t>(const CSRWeightStatistics &statistics) {
+	auto width = MaxValue<double>(statistics.mean, statistics.max / DELTA_STEPPING_MAX_BUCKET_SPAN);
+	return MaxValue<int64_t>(1, static_cast<int64_t>(std::ceil(width)));
+}
+
+template <>
+double BucketWidth<double>(const CSRWeightStatistics &statistics) {
+	auto width = MaxValue<double>(statistics.mean, statistics.max / DELTA_STEPPING_MAX_BUCKET_SPAN);
+	return width > 0 ? width : 1;
+}
+
+template <class T>
+constexpr T WeightedPathSearch<T>::UNREACHED;
+
+template <class T>
+WeightedPathSearch<T>::WeightedPathSearch(CSR &csr, const vector<T> &weights, const CSRWeightStatistics &statistics,
+                                          bool track_paths)
+    : csr(csr), weights(weights), v(reinterpret_cast<int64_t *>(csr.v.get())), vertex_count(csr.vsize - 2),
+      delta(BucketWidth<T>(statistics)), bucket_span(BucketOf(static_cast<T>(statistics.max)) + 2),
+      track_paths(track_paths), distance(vertex_count, UNREACHED), is_target(vertex_count, 0) {
+	D_ASSERT(statistics.min >= 0);
+	if (track_paths) {
+		parent_edge.resize(vertex_count);
+	}
+}
+
+template <class T>
+idx_t WeightedPathSearch<T>::MemoryUsage(idx_t vertex_count, bool track_paths, bool delta_stepping) {
+	// distance and is_target, the parent edges and either the settled flags and rounds of delta-stepping or the
+	// keys, positions and buckets of the radix heap
+	idx_t per_vertex = sizeof(T) + sizeof(uint8_t);
+	if (track_paths) {
+		per_vertex += sizeof(int64_t);
+	}
+	if (delta_stepping) {
+		per_vertex += sizeof(uint8_t) + sizeof(idx_t);
+	} else {
+		per_vertex += sizeof(uint64_t) + sizeof(idx_t) + sizeof(uint8_t);
+	}
+	return vertex_count * per_vertex;
+}
+
+template <class T>
+bool WeightedPathSearch<T>::GetPath(int64_t target, vector<int64_t> &path) const {
+	D_ASSERT(track_paths);
+	path.clear();
+	if (distance[target] == UNREACHED) {
+		return false;
+	}
+	auto vertex = target;
+	path.push_back(vertex);
+	while (vertex != source) {
+		auto edge = parent_edge[vertex];
+		path.push_back(csr.edge_ids[edge]);
+		// The edge at CSR offset [edge] leaves the last vertex whose adjacency list starts at or before it
+		vertex = std::upper_bound(v, v + vertex_count + 1, edge) - v - 1;
+		path.push_back(vertex);
+	}
+	std::reverse(path.begin(), path.end());
+	return true;
+}
+
+template <class T>
+void WeightedPathSearch<T>::Reset() {
+	if (reset_all) {
+		std::fill(distance.begin(), distance.end(), UNREACHED);
+		reset_all = false;
+	} else {
+		for (auto vertex : touched) {
+			distance[vertex] = UNREACHED;
+		}
+	}
+	touched.clear();
+	for (auto target : targets) {
+		is_target[target] = 0;
+	}
+	targets.clear();
+}
+
+template <class T>
+void WeightedPathSearch<T>::MarkTargets(const vector<int64_t> &targets_p) {
+	for (auto target : targets_p) {
+		if (!is_target[target]) {
+			is_target[target] = 1;
+			targets.push_back(target);
+		}
+	}
+	remaining_targets = targets.size();
+}
+
+template <class T>
+void WeightedPathSearch<T>::Dijkstra(int64_t source_p, const vector<int64_t> &targets_p) {
+	Reset();
+	MarkTargets(targets_p);
+	source = source_p;
+	if (remaining_targets == 0) {
+		return;
+	}
+	if (csr.compact) {
+		DijkstraInternal<int32_t>();
+	} else {
+		DijkstraInternal<int64_t>();
+	}
+}
+
+template <class T>
+template <class ID_T>
+void WeightedPathSearch<T>::DijkstraInternal() {
+	auto &e = csr.GetNeighbors<ID_T>();
+	if (!heap) {
+		heap = make_uniq<RadixHeap>(vertex_count);
+	}
+	distance[source] = 0;
+	touched.push_back(source);
+	heap->Push(source, RadixKey(distance[source]));
+	while (!heap->Empty()) {
+		auto vertex = heap->Pop();
+		// The distance of a popped vertex is final
+		if (is_target[vertex] && --remaining_targets == 0) {
+			break;
+		}
+		for (auto index = v[vertex]; index < v[vertex + 1]; index++) {
+			auto neighbor = static_cast<int64_t>(e[index]);
+			auto new_distance = distance[vertex] + weights[index];
+			if (new_distance < distance[neighbor]) {
+				if (distance[neighbor] == UNREACHED) {
+					touched.push_back(neighbor);
+				}
+				Improve(neighbor, new_distance, index);
+				heap->Push(neighbor, RadixKey(new_distance));
+			}
+		}
+	}
+	heap->Clear();
+}
+
+template <class T>
+void WeightedPathSearch<T>::DeltaStepping(ClientContext &context, int64_t source_p,
+                                          const vector<int64_t> &targets_p) {
+	Reset();
+	MarkTargets(targets_p);
+	source = source_p;
+	if (remaining_targets == 0) {
+		return;
+	}
+	if (csr.compact) {
+		DeltaSteppingInternal<int32_t>(context);
+	} else {
+		DeltaSteppingInternal<int64_t>(context);
+	}
+}
+
+template <class T>
+void WeightedPathSearch<T>::Enqueue(int64_t vertex) {
+	buckets[BucketOf(distance[vertex]) % bucket_span].push_back(vertex);
+	queued++;
+}
+
+template <class T>
+template <class ID_T>
+void WeightedPathSearch<T>::DeltaSteppingInternal(ClientContext &context) {
+	// Distances are set from several threads, the next search resets all of them
+	reset_all = true;
+	settled.assign(vertex_count, 0);
+	round_of.resize(vertex_count, 0);
+	buckets.resize(bucket_span);
+	for (auto &bucket : buckets) {
+		bucket.clear();
+	}
+	queued = 0;
+
+	distance[source] = 0;
+	Enqueue(source);
+	vector<int64_t> frontier;
+	vector<int64_t> bucket_settled;
+	// Tentative distances lie within bucket_span buckets of the current one, so the buckets form a ring
+	for (idx_t bucket = 0; queued > 0; bucket++) {
+		auto &slot = buckets[bucket % bucket_span];
+		if (slot.empty()) {
+			continue;
+		}
+		bucket_settled.clear();
+		// Light edges can put vertices back into the current bucket
+		while (!slot.empty()) {
+			frontier.clear();
+			frontier.swap(slot);
+			queued -= frontier.size();
+			round++;
+			idx_t kept = 0;
+			for (auto vertex : frontier) {
+				// Skip vertices queued more than once and entries left behind by a shorter distance
+				if (BucketOf(distance[vertex]) != bucket || round_of[vertex] == round) {
+					continue;
+				}
+				round_of[vertex] = round;
+				frontier[kept++] = vertex;
+				if (!settled[vertex]) {
+					settled[vertex] = 1;
+					bucket_settled.push_back(vertex);
+					remaining_targets -= is_target[vertex];
+				}
+			}
+			frontier.resize(kept);
+			Relax<ID_T>(context, frontier, true);
+		}
+		// The distances of all vertices in the bucket are final now
+		if (remaining_targets == 0) {
+			break;
+		}
+		Relax<ID_T>(context, bucket_settled, false);
+	}
+}
+
+template <class T>
+template <class ID_T>
+void WeightedPathSearch<T>::Relax(ClientContext &context, const vector<int64_t> &vertices, bool light) {
+	auto &e = csr.GetNeighbors<ID_T>();
+	auto thread_count = static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+	if (thread_count <= 1 || vertices.size() < DELTA_STEPPING_PARALLEL_MIN_FRONTIER) {
+		for (auto vertex : vertices) {
+			for (auto index = v[vertex]; index < v[vertex + 1]; index++) {
+				if ((weights[index] <= delta) != light) {
+					continue;
+				}
+				auto neighbor = static_cast<int64_t>(e[index]);
+				auto new_distance = distance[vertex] + weights[index];
+				if (new_distance < distance[neighbor]) {
+					Improve(neighbor, new_distance, index);
+					Enqueue(neighbor);
+				}
+			}
+		}
+		return;
+	}
+	// Chunks of [vertices] collect their relaxations per destination partition, then every partition applies the
+	// relaxations of its vertices, so that no distance is written by two threads
+	auto partition_count = thread_count * 4;
+	auto chunk_size = (vertices.size() + partition_count - 1) / partition_count;
+	auto partition_size = (vertex_count + partition_count - 1) / partition_count;
+	requests.resize(partition_count);
+	improved.resize(partition_count);
+	ParallelFor(context, partition_count, 1, [&](idx_t begin, idx_t end) {
+		for (idx_t chunk = begin; chunk < end; chunk++) {
+			auto &chunk_requests = requests[chunk];
+			chunk_requests.resize(partition_count);
+			for (auto &partition_requests : chunk_requests) {
+				partition_requests.clear();
+			}
+			auto chunk_end = MinValue<idx_t>((chunk + 1) * chunk_size, vertices.size());
+			for (auto i = chunk * chunk_size; i < chunk_end; i++) {
+				auto vertex = vertices[i];
+				for (auto index = v[vertex]; index < v[vertex + 1]; index++) {
+					if ((weights[index] <= delta) != light) {
+						continue;
+					}
+					auto neighbor = static_cast<int64_t>(e[index]);
+					auto new_distance = distance[vertex] + weights[index];
+					if (new_distance < distance[neighbor]) {
+						chunk_requests[neighbor / partition_size].push_back({neighbor, new_distance, index});
+					}
+				}
+			}
+		}
+	});
+	ParallelFor(context, partition_count, 1, [&](idx_t begin, idx_t end) {
+		for (idx_t partition = begin; partition < end; partition++) {
+			auto &partition_improved = improved[partition];
+			partition_improved.clear();
+			for (idx_t chunk = 0; chunk < partition_count; chunk++) {
+				for (auto &request : requests[chunk][partition]) {
+					if (request.distance < distance[request.vertex]) {
+						Improve(request.vertex, request.distance, request.edge);
+						partition_improved.push_back(request.vertex);
+					}
+				}
+			}
+		}
+	});
+	for (auto &partition_improved : improved) {
+		for (auto vertex : partition_improved) {
+			Enqueue(vertex);
+		}
+	}
+}
+
+template <class T>
+void WeightedPathSearchGroups(ClientContext &context, CSR &csr, const vector<T> &weights, bool track_paths,
+                              const MSBFSSourceGroups &groups, const UnifiedVectorFormat &vdata_target,
+                              const int64_t *target_data,
+                              const std::function<void(const WeightedPathSearch<T> &search, idx_t row,
+                                                       int64_t target)> &row_done) {
+	auto &statistics = csr.GetWeightStatistics();
+	auto search_group = [&](WeightedPathSearch<T> &search, idx_t group, bool delta_stepping,
+	                        vector<int64_t> &targets) {
+		targets.clear();
+		for (auto i = groups.offsets[group]; i < groups.offsets[group + 1]; i++) {
+			auto target_pos = vdata_target.sel->get_index(groups.rows[i]);
+			if (vdata_target.validity.RowIsValid(target_pos)) {
+				targets.push_back(target_data[target_pos]);
+			}
+		}
+		if (delta_stepping) {
+			search.DeltaStepping(context, groups.sources[group], targets);
+		} else {
+			search.Dijkstra(groups.sources[group], targets);
+		}
+		for (auto i = groups.offsets[group]; i < groups.offsets[group + 1]; i++) {
+			auto row = groups.rows[i];
+			auto target_pos = vdata_target.sel->get_index(row);
+			if (vdata_target.validity.RowIsValid(target_pos)) {
+				row_done(search, row, target_data[target_pos]);
+			}
+		}
+	};
+
+	auto thread_count = static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+	auto vertex_count = static_cast<idx_t>(csr.vsize - 2);
+	if (thread_count > 1 && groups.GroupCount() < thread_count && vertex_count >= DELTA_STEPPING_MIN_VERTICES) {
+		// Too few sources to keep the threads busy, every search is parallel instead
+		MemoryReservation memory;
+		memory.Resize(context, WeightedPathSearch<T>::MemoryUsage(vertex_count, track_paths, true));
+		WeightedPathSearch<T> search(csr, weights, statistics, track_paths);
+		vector<int64_t> targets;
+		for (idx_t group = 0; group < groups.GroupCount(); group++) {
+			search_group(search, group, true, targets);
+		}
+		return;
+	}
+	// One sequential Dijkstra per source, the sources are spread across the threads. Every morsel has its own search,
+	// reserved here for as many as run at the same time.
+	auto morsel_size = MaxValue<idx_t>(1, (groups.GroupCount() + thread_count - 1) / thread_count);
+	auto concurrent_searches = MinValue<idx_t>(thread_count, (groups.GroupCount() + morsel_size - 1) / morsel_size);
+	MemoryReservation memory;
+	memory.Resize(context,
+	              concurrent_searches * WeightedPathSearch<T>::MemoryUsage(vertex_count, track_paths, false));
+	ParallelFor(context, groups.GroupCount(), morsel_size, [&](idx_t begin, idx_t end) {
+		WeightedPathSearch<T> search(csr, weights, statistics, track_paths);
+		vector<int64_t> targets;
+		for (idx_t group = begin; group < end; group++) {
+			search_group(search, group, false, targets);
+		}
+	});
+}
+
+template class WeightedPathSearch<int32_t>;
+template class WeightedPathSearch<int64_t>;
+template class WeightedPathSearch<double>;
+
+template void WeightedPathSearchGroups<int32_t>(
+    ClientContext &context, CSR &csr, const vector<int32_t> &weights, bool track_paths, const MSBFSSourceGroups &groups,
+    const UnifiedVectorFormat &vdata_target, const int64_t *target_data,
+    const std::function<void(const WeightedPathSearch<int32_t> &search, idx_t row, int64_t target)> &row_done);
+template void WeightedPathSearchGroups<int64_t>(
+    ClientContext &context, CSR &csr, const vector<int64_t> &weights, bool track_paths, const MSBFSSourceGroups &groups,
+    const UnifiedVectorFormat &vdata_target, const int64_t *target_data,
+    const std::function<void(const WeightedPathSearch<int64_t> &search, idx_t row, int64_t target)> &row_done);
+template void WeightedPathSearchGroups<double>(
+    ClientContext &context, CSR &csr, const vector<double> &weights, bool track_paths, const MSBFSSourceGroups &groups,
+    const UnifiedVectorFormat &vdata_target, const int64_t *target_data,
+    const std::function<void(const WeightedPathSearch<double> &search, idx_t row, int64_t target)> &row_done);
+
+} // namespace duckdb
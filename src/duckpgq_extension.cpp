@@ -5,11 +5,14 @@
 #include "duckpgq/core/module.hpp"
 #include <duckpgq_extension_callback.hpp>
 #include "duckdb/main/connection_manager.hpp"
+#include "duckdb/main/config.hpp"
 
 namespace duckdb {
 
 static void LoadInternal(ExtensionLoader &loader) {
 	CoreModule::Register(loader);
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.extension_callbacks.push_back(make_uniq<DuckpgqExtensionCallback>());
 }
 
 void DuckpgqExtension::Load(ExtensionLoader &loader) {
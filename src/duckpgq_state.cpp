@@ -1,4 +1,14 @@
 #include "duckpgq_state.hpp"
+#include "duckpgq_extension_callback.hpp"
+#include "duckdb/main/connection_manager.hpp"
+#include "duckdb/main/prepared_statement_data.hpp"
+#include "duckdb/parser/statement/delete_statement.hpp"
+#include "duckdb/parser/statement/insert_statement.hpp"
+#include "duckdb/parser/statement/update_statement.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include "duckdb/transaction/meta_transaction.hpp"
+#include "duckpgq/core/utils/csr_delta.hpp"
 
 namespace duckdb {
 
@@ -31,150 +41,569 @@ void DuckPGQState::InitializeInternalTable(ClientContext &context) {
 	}
 }
 
-void DuckPGQState::RetrievePropertyGraphs(const shared_ptr<Connection> &connection) {
-	// Retrieve and process vertex property graphs
-	auto vertex_property_graphs = connection->Query("SELECT * FROM __duckpgq_internal WHERE is_vertex_table");
-	ProcessPropertyGraphs(vertex_property_graphs, true);
-
-	// Retrieve and process edge property graphs
-	auto edge_property_graphs = connection->Query("SELECT * FROM __duckpgq_internal WHERE NOT is_vertex_table");
-	ProcessPropertyGraphs(edge_property_graphs, false);
+void DuckPGQState::QueryEnd() {
+	parse_data.reset();
+	transform_expression.clear();
+	match_index = 0; // Reset the index
+	retired_property_graphs.clear();
+	match_csr_lookups.reset();
+	match_uses_csr = false;
+	if (!csr_cache_pending.empty() || csr_cache.size() > csr_cache_capacity + pinned_csr_keys.size()) {
+		lock_guard<mutex> guard(csr_cache_lock);
+		for (auto &pending : csr_cache_pending) {
+			auto csr_entry = csr_list.find(pending.first);
+			// Only fully built CSRs are cached, a query that failed halfway leaves a partial CSR behind
+			if (csr_entry == csr_list.end() || !csr_entry->second->IsComplete()) {
+				continue;
+			}
+			auto &entry = pending.second;
+			// A write committed since the transaction that built the CSR started, its snapshot may miss it
+			if (entry.epoch != commit_state->commit_epoch) {
+				continue;
+			}
+			auto key = GetCSRCacheKey(entry.pg_name, entry.edge_label, entry.directed, entry.weight_column);
+			if (entry.shared && shared_csr_store) {
+				auto shared_entry = make_shared_ptr<SharedCSREntry>();
+				shared_entry->pg_name = entry.pg_name;
+				shared_entry->edge_label = entry.edge_label;
+				shared_entry->directed = entry.directed;
+				shared_entry->weight_column = entry.weight_column;
+				shared_entry->csr = csr_entry->second;
+				shared_csr_store->Publish(key, std::move(shared_entry), csr_cache_capacity, entry.shared_generation);
+				continue;
+			}
+			entry.csr = csr_entry->second;
+			entry.last_used = ++csr_cache_clock;
+			csr_cache[key] = std::move(entry);
+		}
+		idx_t pinned_count = 0;
+		for (auto &entry : csr_cache) {
+			pinned_count += entry.second.pinned ? 1 : 0;
+		}
+		while (csr_cache.size() - pinned_count > csr_cache_capacity) {
+			auto lru_entry = csr_cache.end();
+			for (auto it = csr_cache.begin(); it != csr_cache.end(); it++) {
+				if (!it->second.pinned &&
+				    (lru_entry == csr_cache.end() || it->second.last_used < lru_entry->second.last_used)) {
+					lru_entry = it;
+				}
+			}
+			csr_cache.erase(lru_entry);
+		}
+		csr_cache_pending.clear();
+	}
+	for (const auto &csr_id : csr_to_delete) {
+		csr_list.erase(csr_id);
+	}
+	csr_to_delete.clear();
 }
 
-void DuckPGQState::ProcessPropertyGraphs(unique_ptr<MaterializedQueryResult> &property_graphs, bool is_vertex) {
-	if (!property_graphs || property_graphs->type != QueryResultType::MATERIALIZED_RESULT) {
-		throw std::runtime_error("Failed to fetch property graphs or invalid result type.");
+bool DuckPGQState::EvictCachedCSR() {
+	// The cache lock is held while a cached CSR is refreshed, whose reservation then fails without eviction
+	std::unique_lock<mutex> guard(csr_cache_lock, std::try_to_lock);
+	if (!guard.owns_lock()) {
+		return false;
 	}
+	auto lru_entry = csr_cache.end();
+	for (auto it = csr_cache.begin(); it != csr_cache.end(); it++) {
+		// The CSRs of the running query are also referenced by csr_list
+		if (it->second.pinned || it->second.csr.use_count() > 1) {
+			continue;
+		}
+		if (lru_entry == csr_cache.end() || it->second.last_used < lru_entry->second.last_used) {
+			lru_entry = it;
+		}
+	}
+	if (lru_entry == csr_cache.end()) {
+		return shared_csr_store && shared_csr_store->EvictLeastRecentlyUsed();
+	}
+	csr_cache.erase(lru_entry);
+	return true;
+}
 
-	auto &materialized_result = property_graphs->Cast<MaterializedQueryResult>();
-	auto row_count = materialized_result.RowCount();
-	if (row_count == 0) {
-		return; // No results
+void DuckPGQCommitState::TransactionBegin(MetaTransaction &transaction, ClientContext &context) {
+	transaction_epoch = commit_epoch;
+	auto shared_csr_store = ObjectCache::GetObjectCache(context).Get<SharedCSRStore>(SharedCSRStore::ObjectType());
+	transaction_shared_generation = shared_csr_store ? shared_csr_store->Generation() : 0;
+	written_tables.clear();
+	writes_unknown_tables = false;
+}
+
+void DuckPGQCommitState::RecordWrittenTable(PreparedStatementData &prepared) {
+	if (prepared.properties.IsReadOnly()) {
+		return;
+	}
+	auto statement = prepared.unbound_statement.get();
+	if (statement && statement->type == StatementType::INSERT_STATEMENT) {
+		written_tables.insert(statement->Cast<InsertStatement>().table);
+		return;
+	}
+	optional_ptr<TableRef> table;
+	if (statement && statement->type == StatementType::DELETE_STATEMENT) {
+		table = statement->Cast<DeleteStatement>().table.get();
+	} else if (statement && statement->type == StatementType::UPDATE_STATEMENT) {
+		table = statement->Cast<UpdateStatement>().table.get();
 	}
+	if (table && table->type == TableReferenceType::BASE_TABLE) {
+		written_tables.insert(table->Cast<BaseTableRef>().table_name);
+		return;
+	}
+	writes_unknown_tables = true;
+}
 
-	auto chunk = materialized_result.Fetch();
-	for (idx_t i = 0; i < row_count; i++) {
-		auto table = make_shared_ptr<PropertyGraphTable>();
+RebindQueryInfo DuckPGQCommitState::OnFinalizePrepare(ClientContext &context, PreparedStatementData &prepared_statement,
+                                                      PreparedStatementMode mode) {
+	RecordWrittenTable(prepared_statement);
+	return RebindQueryInfo::DO_NOT_REBIND;
+}
 
-		// Extract and validate common properties
-		table->table_name = chunk->GetValue(1, i).GetValue<string>();
-		table->main_label = chunk->GetValue(2, i).GetValue<string>();
-		table->is_vertex_table = chunk->GetValue(3, i).GetValue<bool>();
+RebindQueryInfo DuckPGQCommitState::OnExecutePrepared(ClientContext &context, PreparedStatementCallbackInfo &info,
+                                                      RebindQueryInfo current_rebind) {
+	RecordWrittenTable(info.prepared_statement);
+	return current_rebind;
+}
 
-		// Handle discriminator and sub-labels
-		const auto &discriminator = chunk->GetValue(10, i).GetValue<string>();
-		if (discriminator != "NULL") {
-			table->discriminator = discriminator;
-			auto sublabels = ListValue::GetChildren(chunk->GetValue(11, i));
-			for (const auto &sublabel : sublabels) {
-				table->sub_labels.push_back(sublabel.GetValue<string>());
-			}
+bool DuckPGQCommitState::WritesPropertyGraphTables(ClientContext &context) const {
+	if (writes_unknown_tables) {
+		return true;
+	}
+	auto metadata =
+	    ObjectCache::GetObjectCache(context).Get<PropertyGraphMetadata>(PropertyGraphMetadata::ObjectType());
+	for (auto &table_name : written_tables) {
+		// Changes the property graphs themselves
+		if (StringUtil::CIEquals(table_name, "__duckpgq_internal")) {
+			return true;
 		}
+		if (metadata && metadata->UsesTable(table_name)) {
+			return true;
+		}
+	}
+	return false;
+}
 
-		// Extract catalog and schema names
-		if (chunk->ColumnCount() > 12) {
-			table->catalog_name = chunk->GetValue(12, i).GetValue<string>();
-			table->schema_name = chunk->GetValue(13, i).GetValue<string>();
-		} else {
-			table->catalog_name = "";
-			table->schema_name = DEFAULT_SCHEMA;
-		}
-		if (chunk->ColumnCount() > 14) {
-			table->source_catalog = chunk->GetValue(14, i).GetValue<string>();
-			table->source_schema = chunk->GetValue(15, i).GetValue<string>();
-			table->destination_catalog = chunk->GetValue(16, i).GetValue<string>();
-			table->destination_schema = chunk->GetValue(17, i).GetValue<string>();
-		} else {
-			table->source_catalog = "";
-			table->schema_name = DEFAULT_SCHEMA;
-			table->destination_catalog = "";
-			table->destination_schema = DEFAULT_SCHEMA;
-		}
-		if (chunk->ColumnCount() > 18) {
-			// read properties
-			auto properties = ListValue::GetChildren(chunk->GetValue(18, i));
-			for (const auto &property : properties) {
-				table->column_names.push_back(property.GetValue<string>());
-			}
-			auto column_aliases = ListValue::GetChildren(chunk->GetValue(19, i));
-			for (const auto &alias : column_aliases) {
-				table->column_aliases.push_back(alias.GetValue<string>());
+//! Drops or marks stale the cached CSRs of every connection and drops those of the SharedCSRStore. The epochs move
+//! first, so a CSR of an older snapshot that a query is about to cache is either refused or dropped here. Returns
+//! the dropped shared CSRs that duckpgq_csr_prebuild rebuilds, the weighted and labeled ones are left to their next
+//! query.
+static vector<CSRPrebuildRequest> InvalidateCachedCSRs(ClientContext &context) {
+	vector<CSRPrebuildRequest> requests;
+	auto connections = ConnectionManager::Get(*context.db).GetConnectionList();
+	for (auto &connection : connections) {
+		auto commit_state = connection->registered_state->Get<DuckPGQCommitState>("duckpgq_commit");
+		if (commit_state) {
+			commit_state->commit_epoch++;
+		}
+	}
+	for (auto &connection : connections) {
+		auto state = connection->registered_state->Get<DuckPGQState>("duckpgq");
+		if (state) {
+			state->MarkCSRCacheStale();
+		}
+	}
+	auto shared_csr_store = ObjectCache::GetObjectCache(context).Get<SharedCSRStore>(SharedCSRStore::ObjectType());
+	if (!shared_csr_store) {
+		return requests;
+	}
+	if (SharedCSRStore::IsPrebuildEnabled(context)) {
+		for (auto &entry : *shared_csr_store->Entries()) {
+			auto &shared_entry = *entry.second;
+			if (shared_entry.weight_column.empty() && shared_entry.edge_label.find('|') == string::npos) {
+				requests.push_back({shared_entry.pg_name, shared_entry.edge_label, shared_entry.directed});
 			}
-		} else {
-			table->all_columns = true;
 		}
+	}
+	shared_csr_store->Clear();
+	return requests;
+}
 
-		// Additional edge-specific handling
-		if (!is_vertex) {
-			PopulateEdgeSpecificFields(chunk, i, *table);
-		}
+void DuckPGQCommitState::TransactionCommit(MetaTransaction &transaction, ClientContext &context) {
+	if (!transaction.ModifiedDatabase() || !WritesPropertyGraphTables(context)) {
+		return;
+	}
+	// Called before the commit, so that no query serves a CSR without the writes once they are visible. A
+	// transaction that starts before the commit completes reads the new epoch with the old snapshot, which is why
+	// QueryEnd invalidates again after the commit.
+	prebuild_requests = InvalidateCachedCSRs(context);
+	invalidate_on_query_end = true;
+}
 
-		RegisterPropertyGraph(table, chunk->GetValue(0, i).GetValue<string>(), is_vertex);
+void DuckPGQCommitState::QueryEnd(ClientContext &context) {
+	if (!invalidate_on_query_end) {
+		return;
 	}
+	invalidate_on_query_end = false;
+	auto requests = InvalidateCachedCSRs(context);
+	requests.insert(requests.end(), prebuild_requests.begin(), prebuild_requests.end());
+	prebuild_requests.clear();
+	// The writes are committed, so the prebuild reads a snapshot that holds them
+	SharedCSRStore::SchedulePrebuild(context, requests, prebuild_tasks);
 }
 
-void DuckPGQState::PopulateEdgeSpecificFields(unique_ptr<DataChunk> &chunk, idx_t row_idx, PropertyGraphTable &table) {
-	table.source_reference = chunk->GetValue(4, row_idx).GetValue<string>();
-	ExtractListValues(chunk->GetValue(5, row_idx), table.source_pk);
-	ExtractListValues(chunk->GetValue(6, row_idx), table.source_fk);
-	table.destination_reference = chunk->GetValue(7, row_idx).GetValue<string>();
-	ExtractListValues(chunk->GetValue(8, row_idx), table.destination_pk);
-	ExtractListValues(chunk->GetValue(9, row_idx), table.destination_fk);
+string DuckPGQState::GetCSRCacheKey(const string &pg_name, const string &edge_label, bool directed,
+                                    const string &weight_column) {
+	return StringUtil::Lower(pg_name) + "." + StringUtil::Lower(edge_label) + (directed ? ".directed" : ".undirected") +
+	       "." + StringUtil::Lower(weight_column);
 }
 
-void DuckPGQState::ExtractListValues(const Value &list_value, vector<string> &output) {
-	auto children = ListValue::GetChildren(list_value);
-	output.reserve(output.size() + children.size());
-	for (const auto &child : children) {
-		output.push_back(child.GetValue<string>());
+static idx_t GetCSRCacheCapacity(ClientContext &context) {
+	Value capacity;
+	if (!context.TryGetCurrentSetting("duckpgq_csr_cache_size", capacity) || capacity.IsNull()) {
+		return 0;
 	}
+	auto result = capacity.GetValue<int64_t>();
+	return result < 0 ? 0 : static_cast<idx_t>(result);
+}
+
+static bool IsIncrementalCSREnabled(ClientContext &context) {
+	Value incremental;
+	return context.TryGetCurrentSetting("duckpgq_incremental_csr", incremental) && !incremental.IsNull() &&
+	       incremental.GetValue<bool>();
 }
 
-void DuckPGQState::RegisterPropertyGraph(const shared_ptr<PropertyGraphTable> &table, const string &graph_name,
-                                         bool is_vertex) {
-	// Ensure the property graph exists in the registry
-	if (registered_property_graphs.find(graph_name) == registered_property_graphs.end()) {
-		registered_property_graphs[graph_name] = make_uniq<CreatePropertyGraphInfo>(graph_name);
+static bool IsSharedCSRCacheEnabled(ClientContext &context) {
+	Value shared;
+	if (context.TryGetCurrentSetting("duckpgq_shared_csr_cache", shared) && !shared.IsNull() &&
+	    shared.GetValue<bool>()) {
+		return true;
 	}
+	// The CSRs built in the background are published to the store
+	return SharedCSRStore::IsPrebuildEnabled(context);
+}
+
+static double GetCSRDeltaRatio(ClientContext &context) {
+	Value ratio;
+	if (!context.TryGetCurrentSetting("duckpgq_csr_delta_ratio", ratio) || ratio.IsNull()) {
+		return 0.1;
+	}
+	return ratio.GetValue<double>();
+}
 
-	auto &pg_info = registered_property_graphs[graph_name]->Cast<CreatePropertyGraphInfo>();
-	pg_info.label_map[table->main_label] = table;
+//! The lookup of a MATCH rewrite to record
+static MatchCSRLookup CreateMatchCSRLookup(MatchCSRLookup::Kind kind, const string &pg_name, const string &edge_label,
+                                           bool directed, const string &weight_column, bool found) {
+	MatchCSRLookup lookup;
+	lookup.kind = kind;
+	lookup.pg_name = pg_name;
+	lookup.edge_label = edge_label;
+	lookup.directed = directed;
+	lookup.weight_column = weight_column;
+	lookup.found = found;
+	return lookup;
+}
+
+bool DuckPGQState::UseCachedCSR(ClientContext &context, const string &pg_name, const string &edge_label,
+                                bool directed, const string &weight_column, int32_t csr_id) {
+	auto found = InstallCachedCSR(context, pg_name, edge_label, directed, weight_column, csr_id);
+	if (match_csr_lookups) {
+		auto lookup = CreateMatchCSRLookup(MatchCSRLookup::Kind::USE, pg_name, edge_label, directed, weight_column,
+		                                   found);
+		lookup.csr_id = csr_id;
+		match_csr_lookups->push_back(std::move(lookup));
+	}
+	return found;
+}
 
-	if (!table->discriminator.empty()) {
-		for (const auto &label : table->sub_labels) {
-			pg_info.label_map[label] = table;
+bool DuckPGQState::InstallCachedCSR(ClientContext &context, const string &pg_name, const string &edge_label,
+                                    bool directed, const string &weight_column, int32_t csr_id) {
+	lock_guard<mutex> guard(csr_cache_lock);
+	csr_cache_capacity = GetCSRCacheCapacity(context);
+	// Uncommitted writes of the running transaction are not reflected by the cached CSRs
+	if (MetaTransaction::Get(context).ModifiedDatabase()) {
+		return false;
+	}
+	auto key = GetCSRCacheKey(pg_name, edge_label, directed, weight_column);
+	auto entry = csr_cache.find(key);
+	if (entry == csr_cache.end() && csr_cache_capacity > 0 && IsSharedCSRCacheEnabled(context)) {
+		// The store only holds CSRs of the latest snapshot, which an older transaction does not read
+		if (!commit_state->SnapshotIsCurrent()) {
+			return false;
+		}
+		// Another connection may have built the CSR, the lookup does not lock the store
+		shared_csr_store = SharedCSRStore::Get(context);
+		auto csr = shared_csr_store->Lookup(key);
+		if (!csr) {
+			return false;
 		}
+		csr_list[csr_id] = std::move(csr);
+		return true;
 	}
+	if (entry == csr_cache.end() || entry->second.stale || (csr_cache_capacity == 0 && !entry->second.pinned) ||
+	    entry->second.epoch != commit_state->transaction_epoch) {
+		return false;
+	}
+	entry->second.last_used = ++csr_cache_clock;
+	entry->second.hits++;
+	csr_list[csr_id] = entry->second.csr;
+	return true;
+}
 
-	if (is_vertex) {
-		pg_info.vertex_tables.push_back(table);
-	} else {
-		table->source_pg_table =
-		    pg_info.GetTableByName(table->source_catalog, table->source_schema, table->source_reference);
-		D_ASSERT(table->source_pg_table);
-		table->destination_pg_table =
-		    pg_info.GetTableByName(table->destination_catalog, table->destination_schema, table->destination_reference);
-		D_ASSERT(table->destination_pg_table);
-		pg_info.edge_tables.push_back(table);
+void DuckPGQState::CacheCSROnQueryEnd(ClientContext &context, const string &pg_name, const string &edge_label,
+                                      bool directed, const string &weight_column, int32_t csr_id) {
+	lock_guard<mutex> guard(csr_cache_lock);
+	csr_cache_capacity = GetCSRCacheCapacity(context);
+	auto pinned = pinned_csr_keys.count(GetCSRCacheKey(pg_name, edge_label, directed, weight_column)) > 0;
+	// A transaction that started before the last committed write builds the CSR from an outdated snapshot
+	if ((csr_cache_capacity == 0 && !pinned) || MetaTransaction::Get(context).ModifiedDatabase() ||
+	    !commit_state->SnapshotIsCurrent()) {
+		return;
 	}
+	CSRCacheEntry entry;
+	entry.epoch = commit_state->transaction_epoch;
+	entry.pinned = pinned;
+	entry.pg_name = pg_name;
+	entry.edge_label = edge_label;
+	entry.directed = directed;
+	entry.weight_column = weight_column;
+	entry.incremental = directed && weight_column.empty() && IsIncrementalCSREnabled(context);
+	// The CSRs in the store never change, the incremental ones are refreshed in place
+	entry.shared = !pinned && !entry.incremental && IsSharedCSRCacheEnabled(context);
+	if (entry.shared) {
+		shared_csr_store = SharedCSRStore::Get(context);
+		// A Clear between the start of the transaction and the end of the query drops the publish, also the one of a
+		// commit that ran before the CSR was planned
+		entry.shared_generation = commit_state->transaction_shared_generation;
+	}
+	csr_cache_pending[csr_id] = std::move(entry);
 }
 
-void DuckPGQState::QueryEnd() {
-	parse_data.reset();
-	transform_expression.clear();
-	match_index = 0; // Reset the index
-	for (const auto &csr_id : csr_to_delete) {
-		csr_list.erase(csr_id);
+void DuckPGQState::InvalidateCSRCache() {
+	lock_guard<mutex> guard(csr_cache_lock);
+	csr_cache.clear();
+	// A CSR that is still being built may already be outdated as well
+	csr_cache_pending.clear();
+}
+
+void DuckPGQState::MarkCSRCacheStale() {
+	lock_guard<mutex> guard(csr_cache_lock);
+	for (auto it = csr_cache.begin(); it != csr_cache.end();) {
+		if (it->second.incremental) {
+			it->second.stale = true;
+			it++;
+		} else {
+			it = csr_cache.erase(it);
+		}
+	}
+	csr_cache_pending.clear();
+}
+
+void DuckPGQState::RefreshCachedCSR(ClientContext &context, const string &pg_name,
+                                    const shared_ptr<PropertyGraphTable> &edge_table) {
+	if (match_csr_lookups) {
+		auto lookup =
+		    CreateMatchCSRLookup(MatchCSRLookup::Kind::REFRESH, pg_name, edge_table->main_label, true, "", false);
+		lookup.edge_table = edge_table;
+		match_csr_lookups->push_back(std::move(lookup));
+	}
+	lock_guard<mutex> guard(csr_cache_lock);
+	// Uncommitted writes are invisible to the connection that scans the tables, the cache is not used then anyway.
+	// A transaction that misses committed writes leaves the CSR stale for a newer one to refresh.
+	if (MetaTransaction::Get(context).ModifiedDatabase() || !commit_state->SnapshotIsCurrent()) {
+		return;
+	}
+	auto entry = csr_cache.find(GetCSRCacheKey(pg_name, edge_table->main_label, true, ""));
+	if (entry == csr_cache.end() || !entry->second.stale) {
+		return;
+	}
+	auto &csr = entry->second.csr;
+	if (csr->arrow_exports > 0 || !RefreshCSRDelta(context, edge_table, *csr)) {
+		csr_cache.erase(entry);
+		return;
+	}
+	entry->second.stale = false;
+	entry->second.epoch = commit_state->transaction_epoch;
+	if (csr->DeltaSize() > static_cast<idx_t>(GetCSRDeltaRatio(context) * static_cast<double>(csr->EdgeCount()))) {
+		// Without the memory the delta is merged by a later refresh
+		try {
+			csr->ReserveMemory(context, csr->MergeMemoryUsage());
+		} catch (OutOfMemoryException &) {
+			return;
+		}
+		csr->MergeDelta();
+	}
+}
+
+void DuckPGQState::PinCSR(ClientContext &context, const string &pg_name, const string &edge_label, bool directed,
+                          const string &weight_column, int32_t csr_id) {
+	auto key = GetCSRCacheKey(pg_name, edge_label, directed, weight_column);
+	{
+		lock_guard<mutex> guard(csr_cache_lock);
+		pinned_csr_keys.insert(key);
+		// The CSR is rebuilt, which also refreshes an entry that is already cached
+		csr_cache.erase(key);
+	}
+	CacheCSROnQueryEnd(context, pg_name, edge_label, directed, weight_column, csr_id);
+	csr_to_delete.insert(csr_id);
+}
+
+void DuckPGQState::AddPinnedCSR(const string &pg_name, const string &edge_label, bool directed,
+                                const string &weight_column, shared_ptr<CSR> csr) {
+	lock_guard<mutex> guard(csr_cache_lock);
+	auto key = GetCSRCacheKey(pg_name, edge_label, directed, weight_column);
+	CSRCacheEntry entry;
+	entry.pg_name = pg_name;
+	entry.edge_label = edge_label;
+	entry.directed = directed;
+	entry.weight_column = weight_column;
+	entry.csr = std::move(csr);
+	entry.last_used = ++csr_cache_clock;
+	entry.pinned = true;
+	entry.epoch = commit_state->transaction_epoch;
+	pinned_csr_keys.insert(key);
+	csr_cache[key] = std::move(entry);
+}
+
+shared_ptr<CSR> DuckPGQState::GetCachedCSR(const string &pg_name, const string &edge_label, bool directed,
+                                           const string &weight_column) {
+	auto csr = FindCachedCSR(pg_name, edge_label, directed, weight_column);
+	if (match_csr_lookups) {
+		match_csr_lookups->push_back(CreateMatchCSRLookup(MatchCSRLookup::Kind::PROBE, pg_name, edge_label, directed,
+		                                                  weight_column, csr != nullptr));
+	}
+	return csr;
+}
+
+shared_ptr<CSR> DuckPGQState::FindCachedCSR(const string &pg_name, const string &edge_label, bool directed,
+                                            const string &weight_column) {
+	lock_guard<mutex> guard(csr_cache_lock);
+	auto key = GetCSRCacheKey(pg_name, edge_label, directed, weight_column);
+	auto entry = csr_cache.find(key);
+	if (entry == csr_cache.end()) {
+		return shared_csr_store && commit_state->SnapshotIsCurrent() ? shared_csr_store->Lookup(key) : nullptr;
+	}
+	if (entry->second.stale || entry->second.epoch != commit_state->transaction_epoch) {
+		return nullptr;
+	}
+	return entry->second.csr;
+}
+
+void DuckPGQState::UnpinCSRs(const string &pg_name, const string &edge_label) {
+	lock_guard<mutex> guard(csr_cache_lock);
+	auto prefix = StringUtil::Lower(pg_name) + "." + (edge_label.empty() ? "" : StringUtil::Lower(edge_label) + ".");
+	for (auto it = pinned_csr_keys.begin(); it != pinned_csr_keys.end();) {
+		if (StringUtil::StartsWith(*it, prefix)) {
+			csr_cache.erase(*it);
+			it = pinned_csr_keys.erase(it);
+		} else {
+			it++;
+		}
 	}
-	csr_to_delete.clear();
+}
+
+CreatePropertyGraphInfo *DuckPGQState::FindPropertyGraph(const string &pg_name) {
+	auto version = property_graph_metadata->Version();
+	if (version != registered_version) {
+		// A property graph was created or dropped since, by any connection. The copies handed out earlier in the query
+		// stay valid until it ends.
+		for (auto &entry : registered_property_graphs) {
+			retired_property_graphs.push_back(std::move(entry.second));
+		}
+		registered_property_graphs.clear();
+		registered_version = version;
+	}
+	auto entry = registered_property_graphs.find(pg_name);
+	if (entry == registered_property_graphs.end()) {
+		auto info = property_graph_metadata->CopyPropertyGraph(pg_name);
+		if (!info) {
+			return nullptr;
+		}
+		entry = registered_property_graphs.emplace(pg_name, std::move(info)).first;
+	}
+	return &entry->second->Cast<CreatePropertyGraphInfo>();
 }
 
 CreatePropertyGraphInfo *DuckPGQState::GetPropertyGraph(const string &pg_name) {
-	auto pg_table_entry = registered_property_graphs.find(pg_name);
-	if (pg_table_entry == registered_property_graphs.end()) {
+	auto pg_info = FindPropertyGraph(pg_name);
+	if (!pg_info) {
 		throw BinderException("Property graph %s does not exist", pg_name);
 	}
-	return reinterpret_cast<CreatePropertyGraphInfo *>(pg_table_entry->second.get());
+	return pg_info;
+}
+
+static idx_t GetMatchRewriteCacheCapacity(ClientContext &context) {
+	Value capacity;
+	if (!context.TryGetCurrentSetting("duckpgq_match_cache_size", capacity) || capacity.IsNull()) {
+		return 0;
+	}
+	auto result = capacity.GetValue<int64_t>();
+	return result < 0 ? 0 : static_cast<idx_t>(result);
+}
+
+void DuckPGQState::BeginMatchRewrite() {
+	match_csr_lookups = make_uniq<vector<MatchCSRLookup>>();
+}
+
+unique_ptr<TableRef> DuckPGQState::GetCachedMatchRewrite(ClientContext &context, const string &key) {
+	if (GetMatchRewriteCacheCapacity(context) == 0) {
+		match_rewrite_cache.clear();
+		return nullptr;
+	}
+	auto entry = match_rewrite_cache.find(key);
+	if (entry == match_rewrite_cache.end()) {
+		return nullptr;
+	}
+	// The lookups repeat the side effects of the rewrite, a CSR it used is installed again
+	vector<int32_t> installed_csr_ids;
+	auto same_outcome = true;
+	for (auto &lookup : entry->second.lookups) {
+		switch (lookup.kind) {
+		case MatchCSRLookup::Kind::REFRESH:
+			RefreshCachedCSR(context, lookup.pg_name, lookup.edge_table);
+			break;
+		case MatchCSRLookup::Kind::USE:
+			same_outcome = UseCachedCSR(context, lookup.pg_name, lookup.edge_label, lookup.directed,
+			                            lookup.weight_column, lookup.csr_id) == lookup.found;
+			installed_csr_ids.push_back(lookup.csr_id);
+			break;
+		case MatchCSRLookup::Kind::PROBE:
+			same_outcome = (GetCachedCSR(lookup.pg_name, lookup.edge_label, lookup.directed, lookup.weight_column) !=
+			                nullptr) == lookup.found;
+			break;
+		}
+		if (!same_outcome) {
+			break;
+		}
+	}
+	if (!same_outcome) {
+		// The rewrite is redone, a CSR that is built again must not be built into one that was installed
+		for (auto csr_id : installed_csr_ids) {
+			csr_list.erase(csr_id);
+		}
+		match_rewrite_cache.erase(entry);
+		return nullptr;
+	}
+	match_uses_csr = match_uses_csr || !entry->second.lookups.empty();
+	entry->second.last_used = ++match_rewrite_clock;
+	return entry->second.rewrite->Copy();
+}
+
+void DuckPGQState::CacheMatchRewrite(ClientContext &context, const string &key, const TableRef &rewrite) {
+	D_ASSERT(match_csr_lookups);
+	auto lookups = std::move(*match_csr_lookups);
+	match_csr_lookups.reset();
+	match_uses_csr = match_uses_csr || !lookups.empty();
+	auto capacity = GetMatchRewriteCacheCapacity(context);
+	if (capacity == 0) {
+		return;
+	}
+	for (auto &lookup : lookups) {
+		if (lookup.kind == MatchCSRLookup::Kind::USE && !lookup.found) {
+			return;
+		}
+	}
+	while (match_rewrite_cache.size() >= capacity) {
+		auto lru_entry = match_rewrite_cache.begin();
+		for (auto it = match_rewrite_cache.begin(); it != match_rewrite_cache.end(); it++) {
+			if (it->second.last_used < lru_entry->second.last_used) {
+				lru_entry = it;
+			}
+		}
+		match_rewrite_cache.erase(lru_entry);
+	}
+	MatchRewriteCacheEntry entry;
+	entry.rewrite = rewrite.Copy();
+	entry.lookups = std::move(lookups);
+	entry.last_used = ++match_rewrite_clock;
+	match_rewrite_cache[key] = std::move(entry);
 }
 
 CSR *DuckPGQState::GetCSR(int32_t id) {
@@ -185,4 +614,14 @@ CSR *DuckPGQState::GetCSR(int32_t id) {
 	return csr_entry->second.get();
 }
 
+void DuckPGQState::MergeCSRDelta(ClientContext &context, int32_t id) {
+	auto csr_entry = csr_list.find(id);
+	if (csr_entry == csr_list.end()) {
+		return;
+	}
+	auto &csr = *csr_entry->second;
+	csr.ReserveMemory(context, csr.MergeMemoryUsage());
+	csr.MergeDelta();
+}
+
 } // namespace duckdb
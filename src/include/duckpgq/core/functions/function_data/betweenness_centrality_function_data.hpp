@@ -0,0 +1,35 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/function_data/betweenness_centrality_function_data.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckdb/main/client_context.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
+
+namespace duckdb {
+
+struct BetweennessCentralityFunctionData final : FunctionData {
+	ClientContext &context;
+	int32_t csr_id;
+	//! Number of sampled source vertices, 0 runs a search from every vertex
+	int64_t samples;
+	//! Computes the centrality once for all threads of the query
+	ParallelOnce once;
+	//! Centrality of every vertex
+	vector<double_t> centrality;
+
+	BetweennessCentralityFunctionData(ClientContext &context, int32_t csr_id, int64_t samples);
+
+	static unique_ptr<FunctionData> BetweennessCentralityBind(ClientContext &context, ScalarFunction &bound_function,
+	                                                          vector<unique_ptr<Expression>> &arguments);
+
+	unique_ptr<FunctionData> Copy() const override;
+	bool Equals(const FunctionData &other_p) const override;
+};
+
+} // namespace duckdb
@@ -20,6 +20,9 @@ struct CheapestPathLengthFunctionData final : FunctionData {
 	}
 	static unique_ptr<FunctionData> CheapestPathLengthBind(ClientContext &context, ScalarFunction &bound_function,
 	                                                       vector<unique_ptr<Expression>> &arguments);
+	//! Bind of cheapest_path, which returns the path instead of its cost
+	static unique_ptr<FunctionData> CheapestPathBind(ClientContext &context, ScalarFunction &bound_function,
+	                                                 vector<unique_ptr<Expression>> &arguments);
 
 	unique_ptr<FunctionData> Copy() const override;
 	bool Equals(const FunctionData &other_p) const override;
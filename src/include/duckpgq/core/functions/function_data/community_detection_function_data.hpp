@@ -0,0 +1,43 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/function_data/community_detection_function_data.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckdb/main/client_context.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
+
+namespace duckdb {
+
+//! The state of label_propagation and louvain
+struct CommunityDetectionFunctionData final : FunctionData {
+	static constexpr int64_t DEFAULT_MAX_ITERATIONS = 20;
+	static constexpr double_t DEFAULT_RESOLUTION = 1.0;
+
+	ClientContext &context;
+	int32_t csr_id;
+	//! Passes of label propagation, or of the local moving phase of every Louvain level
+	int64_t max_iterations;
+	//! Weight of the expected edges in the modularity Louvain optimizes, higher values give smaller communities
+	double_t resolution;
+	//! Computed for all vertices by the first call
+	ParallelOnce once;
+	//! Community of every vertex, the smallest vertex id in the community
+	vector<int64_t> community;
+
+	CommunityDetectionFunctionData(ClientContext &context, int32_t csr_id, int64_t max_iterations,
+	                               double_t resolution);
+
+	//! label_propagation(csr_id, rowid[, max_iterations]) and louvain(csr_id, rowid[, resolution, max_iterations])
+	static unique_ptr<FunctionData> CommunityDetectionBind(ClientContext &context, ScalarFunction &bound_function,
+	                                                       vector<unique_ptr<Expression>> &arguments);
+
+	unique_ptr<FunctionData> Copy() const override;
+	bool Equals(const FunctionData &other_p) const override;
+};
+
+} // namespace duckdb
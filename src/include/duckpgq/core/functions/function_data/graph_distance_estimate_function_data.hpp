@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/function_data/graph_distance_estimate_function_data.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckdb/main/client_context.hpp"
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+//! graph_distance_estimate(pg_name, edge_label, source, destination[, directed]) reads the distance index of the
+//! cached CSR of the edge table instead of a CSR built by the query
+struct GraphDistanceEstimateFunctionData final : FunctionData {
+	ClientContext &context;
+	string pg_name;
+	//! The main label of the edge table, the key of its cached CSR
+	string edge_label;
+	bool directed;
+
+	GraphDistanceEstimateFunctionData(ClientContext &context, string pg_name, string edge_label, bool directed)
+	    : context(context), pg_name(std::move(pg_name)), edge_label(std::move(edge_label)), directed(directed) {
+	}
+	static unique_ptr<FunctionData> GraphDistanceEstimateBind(ClientContext &context, ScalarFunction &bound_function,
+	                                                          vector<unique_ptr<Expression>> &arguments);
+
+	unique_ptr<FunctionData> Copy() const override;
+	bool Equals(const FunctionData &other_p) const override;
+};
+
+} // namespace duckdb
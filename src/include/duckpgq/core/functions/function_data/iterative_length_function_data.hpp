@@ -18,8 +18,12 @@ struct IterativeLengthFunctionData final : FunctionData {
 
 	IterativeLengthFunctionData(ClientContext &context, int32_t csr_id) : context(context), csr_id(csr_id) {
 	}
+	//! Binds a kernel that reads the merged arrays of an incrementally refreshed CSR
 	static unique_ptr<FunctionData> IterativeLengthBind(ClientContext &context, ScalarFunction &bound_function,
 	                                                    vector<unique_ptr<Expression>> &arguments);
+	//! Binds a kernel that reads an incrementally refreshed CSR through its delta, see CSR::GetRanges
+	static unique_ptr<FunctionData> DeltaAwareBind(ClientContext &context, ScalarFunction &bound_function,
+	                                               vector<unique_ptr<Expression>> &arguments);
 
 	unique_ptr<FunctionData> Copy() const override;
 	bool Equals(const FunctionData &other_p) const override;
@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/function_data/kcore_function_data.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckdb/main/client_context.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
+
+namespace duckdb {
+
+//! The state of kcore
+struct KCoreFunctionData final : FunctionData {
+	ClientContext &context;
+	int32_t csr_id;
+	//! Computed for all vertices by the first call
+	ParallelOnce once;
+	//! Core number of every vertex
+	vector<int64_t> core;
+
+	KCoreFunctionData(ClientContext &context, int32_t csr_id);
+
+	static unique_ptr<FunctionData> KCoreBind(ClientContext &context, ScalarFunction &bound_function,
+	                                          vector<unique_ptr<Expression>> &arguments);
+
+	unique_ptr<FunctionData> Copy() const override;
+	bool Equals(const FunctionData &other_p) const override;
+};
+
+} // namespace duckdb
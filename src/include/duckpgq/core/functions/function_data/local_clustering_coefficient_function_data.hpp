@@ -9,12 +9,18 @@
 #pragma once
 #include "duckdb/main/client_context.hpp"
 #include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
 
 namespace duckdb {
 
 struct LocalClusteringCoefficientFunctionData final : FunctionData {
 	ClientContext &context;
 	int32_t csr_id;
+	//! Computed for all vertices by the first call, in one pass over the CSR
+	ParallelOnce once;
+	vector<float> coefficients;
+	//! Result of triangle_count and global_clustering_coefficient
+	double_t graph_result = 0;
 
 	LocalClusteringCoefficientFunctionData(ClientContext &context, int32_t csr_id);
 	static unique_ptr<FunctionData> LocalClusteringCoefficientBind(ClientContext &context,
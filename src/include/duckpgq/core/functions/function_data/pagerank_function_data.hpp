@@ -9,25 +9,41 @@
 #pragma once
 #include "duckdb/main/client_context.hpp"
 #include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
 
 namespace duckdb {
 
 struct PageRankFunctionData final : FunctionData {
+	static constexpr double_t DEFAULT_DAMPING_FACTOR = 0.85;
+	static constexpr double_t DEFAULT_CONVERGENCE_THRESHOLD = 1e-6;
+	static constexpr int64_t DEFAULT_MAX_ITERATIONS = 100;
+
 	ClientContext &context;
 	int32_t csr_id;
 	vector<double_t> rank;
 	vector<double_t> temp_rank;
 	double_t damping_factor;
 	double_t convergence_threshold;
+	int64_t max_iterations;
+	//! Key of the cached ranks to start from, empty for a cold start from the uniform vector
+	string warm_start_key;
+	//! Number of vertices personalized_pagerank returns for every seed
+	int64_t top_k = 0;
 	int64_t iteration_count;
-	std::mutex state_lock; // Lock for state
+	//! Runs the iterations once for all threads of the query
+	ParallelOnce once;
 	bool state_initialized;
 	bool converged;
 
-	PageRankFunctionData(ClientContext &context, int32_t csr_id);
+	PageRankFunctionData(ClientContext &context, int32_t csr_id,
+	                     double_t damping_factor = DEFAULT_DAMPING_FACTOR,
+	                     double_t convergence_threshold = DEFAULT_CONVERGENCE_THRESHOLD,
+	                     int64_t max_iterations = DEFAULT_MAX_ITERATIONS, string warm_start_key = "");
 	PageRankFunctionData(ClientContext &context, int32_t csr_id, const vector<int64_t> &componentId);
 	static unique_ptr<FunctionData> PageRankBind(ClientContext &context, ScalarFunction &bound_function,
 	                                             vector<unique_ptr<Expression>> &arguments);
+	static unique_ptr<FunctionData> PersonalizedPageRankBind(ClientContext &context, ScalarFunction &bound_function,
+	                                                         vector<unique_ptr<Expression>> &arguments);
 
 	unique_ptr<FunctionData> Copy() const override;
 	bool Equals(const FunctionData &other_p) const override;
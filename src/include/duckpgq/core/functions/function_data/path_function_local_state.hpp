@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/function_data/path_function_local_state.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckdb/function/scalar_function.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/csr_reachability_index.hpp"
+#include "duckpgq/core/utils/csr_temporal_index.hpp"
+#include "duckpgq/core/utils/duckpgq_bitmap.hpp"
+#include "duckpgq/core/utils/msbfs.hpp"
+#include "duckpgq/core/utils/traversal_metrics.hpp"
+
+namespace duckdb {
+
+//! The edges a traversal with an edge predicate may take. The rewrites evaluate the predicate once over the edge
+//! table into a constant list of the rowids that pass, which every thread turns into a bitmap over the edge rowids
+//! on its first chunk. The cached CSR itself stays unfiltered, so it serves traversals with any predicate.
+//! Alternatively the filter is a set of edge labels of a labeled CSR, tested against the label of the adjacency entry,
+//! or a point in time, tested against the validity intervals of the temporal index of the CSR.
+class EdgeFilter {
+public:
+	//! The types of the filter argument the kernels take: a list of edge rowids, a label mask, or an as-of TIMESTAMP
+	//! or BIGINT
+	static vector<LogicalType> ArgumentTypes() {
+		return {LogicalType::LIST(LogicalType::BIGINT), LogicalType::UBIGINT, LogicalType::TIMESTAMP,
+		        LogicalType::BIGINT};
+	}
+	//! Initializes the filter from the first row of [argument], whichever of the ArgumentTypes it has
+	void InitializeArgument(Vector &argument, idx_t count, const CSR &csr);
+	//! Reads the rowid list in the first row of [edges], a NULL list lets no edge pass
+	void Initialize(Vector &edges, idx_t count);
+	//! Reads the label mask in the first row of [mask], bit i lets the edges with label id i pass. The edges of a CSR
+	//! without labels all have label id 0.
+	void InitializeLabels(Vector &mask, idx_t count, const CSR &csr);
+	//! Reads the point in time in the first row of [as_of], the edges valid at it pass. Its type has to match the
+	//! bounds of the temporal index of [csr].
+	void InitializeAsOf(Vector &as_of, idx_t count, const CSR &csr);
+	bool IsInitialized() const {
+		return initialized;
+	}
+	//! Whether the edge [edge_id] at [offset] of the neighbor array passes
+	bool Allows(int64_t offset, int64_t edge_id) const {
+		if (temporal_index) {
+			return temporal_index->Valid(offset, as_of);
+		}
+		if (label_mask) {
+			return (label_mask >> (labels ? labels[offset] : 0)) & 1;
+		}
+		return edge_id >= 0 && static_cast<idx_t>(edge_id) < size && bitmap->test(static_cast<idx_t>(edge_id));
+	}
+
+private:
+	bool initialized = false;
+	//! One more than the largest rowid that passes
+	idx_t size = 0;
+	unique_ptr<DuckPGQBitmap> bitmap;
+	uint64_t label_mask = 0;
+	const uint8_t *labels = nullptr;
+	shared_ptr<const CSRTemporalIndex> temporal_index;
+	int64_t as_of = 0;
+};
+
+//! Per-thread local state of the path-finding scalar functions. The CSR is looked up and validated on the first
+//! chunk, so later chunks skip the csr_list lookups. Also holds the BFS arrays the chunks of the query reuse.
+class PathFunctionLocalState : public FunctionLocalState {
+public:
+	static unique_ptr<FunctionLocalState> Init(ExpressionState &state, const BoundFunctionExpression &expr,
+	                                           FunctionData *bind_data);
+	//! The local state of the function [state] executes
+	static PathFunctionLocalState &Get(ExpressionState &state);
+
+	//! Looks up the CSR [csr_id] on the first call and returns it on every call. With [load_partitions] the edges of
+	//! a partitioned CSR are moved into memory first. The vertex count argument of the functions is not read, the
+	//! CSR records the number of vertices it was built for.
+	CSR &Bind(ClientContext &context, int32_t csr_id, bool load_partitions = false);
+	//! The number of vertices of the CSR, one more than the largest rowid of the vertex table
+	int64_t VertexCount() const {
+		return v_size;
+	}
+	//! The metrics of the database the kernels add their counters to, available once Bind was called
+	TraversalMetrics &Metrics() {
+		return *metrics;
+	}
+
+	MSBFSScratch scratch;
+	//! The arrays of the destination side of the bidirectional searches, whose source side uses scratch
+	MSBFSScratch reverse_scratch;
+	//! Buffers of CSR::InternalIds for the source and destination arguments
+	vector<int64_t> source_ids;
+	vector<int64_t> target_ids;
+	//! The edge predicate of the kernels that take an edge filter argument
+	EdgeFilter edge_filter;
+	//! The edge filter of the optional constant argument [column], initialized on the first chunk. nullptr if the
+	//! function was called without it.
+	const EdgeFilter *GetEdgeFilter(DataChunk &args, idx_t column, const CSR &csr);
+	//! The searches of reachability over the reachability index of the CSR
+	ReachabilitySearch reachability_search;
+
+private:
+	shared_ptr<CSR> csr;
+	int64_t v_size = 0;
+	shared_ptr<TraversalMetrics> metrics;
+};
+
+} // namespace duckdb
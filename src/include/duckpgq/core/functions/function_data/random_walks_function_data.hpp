@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/function_data/random_walks_function_data.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckdb/main/client_context.hpp"
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
+#include "duckpgq/core/utils/csr_random_walk.hpp"
+
+namespace duckdb {
+
+//! The state of random_walks
+struct RandomWalksFunctionData final : FunctionData {
+	ClientContext &context;
+	int32_t csr_id;
+	//! Number of walks from every vertex
+	idx_t walks_per_node;
+	RandomWalkParameters parameters;
+	uint64_t seed;
+	//! Built for a weighted CSR by the first call
+	ParallelOnce once;
+	shared_ptr<CSRAliasTables> alias_tables;
+
+	RandomWalksFunctionData(ClientContext &context, int32_t csr_id, idx_t walks_per_node,
+	                        RandomWalkParameters parameters, uint64_t seed);
+
+	//! random_walks(csr_id, rowid, walk_length, walks_per_node[, p, q[, seed]])
+	static unique_ptr<FunctionData> RandomWalksBind(ClientContext &context, ScalarFunction &bound_function,
+	                                                vector<unique_ptr<Expression>> &arguments);
+
+	unique_ptr<FunctionData> Copy() const override;
+	bool Equals(const FunctionData &other_p) const override;
+};
+
+} // namespace duckdb
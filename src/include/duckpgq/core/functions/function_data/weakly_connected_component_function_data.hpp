@@ -9,16 +9,16 @@
 #pragma once
 #include "duckdb/main/client_context.hpp"
 #include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
 
 namespace duckdb {
 
 struct WeaklyConnectedComponentFunctionData final : FunctionData {
 	ClientContext &context;
 	int32_t csr_id;
-	std::mutex wcc_lock;
-	std::mutex initialize_lock;
-	bool state_converged;
-	bool state_initialized;
+	//! Runs Afforest once for all threads of the query
+	ParallelOnce once;
+	//! Component of every vertex, the smallest vertex id in the component
 	vector<int64_t> forest;
 
 	WeaklyConnectedComponentFunctionData(ClientContext &context, int32_t csr_id);
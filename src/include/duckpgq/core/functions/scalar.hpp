@@ -5,33 +5,63 @@ namespace duckdb {
 
 struct CoreScalarFunctions {
 	static void Register(ExtensionLoader &loader) {
+		RegisterAllShortestPathsScalarFunction(loader);
+		RegisterBetweennessCentralityScalarFunction(loader);
+		RegisterCheapestPathScalarFunction(loader);
 		RegisterCheapestPathLengthScalarFunction(loader);
+		RegisterCommunityDetectionScalarFunctions(loader);
 		RegisterCSRCreationScalarFunctions(loader);
 		RegisterCSRDeletionScalarFunction(loader);
+		RegisterCyclesScalarFunction(loader);
+		RegisterExpandScalarFunction(loader);
 		RegisterGetCSRWTypeScalarFunction(loader);
+		RegisterGraphDistanceEstimateScalarFunction(loader);
 		RegisterIterativeLengthScalarFunction(loader);
 		RegisterIterativeLength2ScalarFunction(loader);
 		RegisterIterativeLengthBidirectionalScalarFunction(loader);
+		RegisterKCoreScalarFunctions(loader);
+		RegisterKHopNeighborsScalarFunction(loader);
+		RegisterKShortestPathsScalarFunction(loader);
 		RegisterLocalClusteringCoefficientScalarFunction(loader);
+		RegisterRandomWalksScalarFunction(loader);
 		RegisterReachabilityScalarFunction(loader);
 		RegisterShortestPathScalarFunction(loader);
+		RegisterShortestPathCountScalarFunction(loader);
+		RegisterShortestPathTargetsScalarFunctions(loader);
 		RegisterWeaklyConnectedComponentScalarFunction(loader);
 		RegisterPageRankScalarFunction(loader);
+		RegisterPersonalizedPageRankScalarFunction(loader);
+		RegisterTriangleCountScalarFunctions(loader);
 	}
 
 private:
+	static void RegisterAllShortestPathsScalarFunction(ExtensionLoader &loader);
+	static void RegisterBetweennessCentralityScalarFunction(ExtensionLoader &loader);
+	static void RegisterCheapestPathScalarFunction(ExtensionLoader &loader);
 	static void RegisterCheapestPathLengthScalarFunction(ExtensionLoader &loader);
+	static void RegisterCommunityDetectionScalarFunctions(ExtensionLoader &loader);
 	static void RegisterCSRCreationScalarFunctions(ExtensionLoader &loader);
 	static void RegisterCSRDeletionScalarFunction(ExtensionLoader &loader);
+	static void RegisterCyclesScalarFunction(ExtensionLoader &loader);
+	static void RegisterExpandScalarFunction(ExtensionLoader &loader);
 	static void RegisterGetCSRWTypeScalarFunction(ExtensionLoader &loader);
+	static void RegisterGraphDistanceEstimateScalarFunction(ExtensionLoader &loader);
 	static void RegisterIterativeLengthScalarFunction(ExtensionLoader &loader);
 	static void RegisterIterativeLength2ScalarFunction(ExtensionLoader &loader);
 	static void RegisterIterativeLengthBidirectionalScalarFunction(ExtensionLoader &loader);
+	static void RegisterKCoreScalarFunctions(ExtensionLoader &loader);
+	static void RegisterKHopNeighborsScalarFunction(ExtensionLoader &loader);
+	static void RegisterKShortestPathsScalarFunction(ExtensionLoader &loader);
 	static void RegisterLocalClusteringCoefficientScalarFunction(ExtensionLoader &loader);
+	static void RegisterRandomWalksScalarFunction(ExtensionLoader &loader);
 	static void RegisterReachabilityScalarFunction(ExtensionLoader &loader);
 	static void RegisterShortestPathScalarFunction(ExtensionLoader &loader);
+	static void RegisterShortestPathCountScalarFunction(ExtensionLoader &loader);
+	static void RegisterShortestPathTargetsScalarFunctions(ExtensionLoader &loader);
 	static void RegisterWeaklyConnectedComponentScalarFunction(ExtensionLoader &loader);
 	static void RegisterPageRankScalarFunction(ExtensionLoader &loader);
+	static void RegisterPersonalizedPageRankScalarFunction(ExtensionLoader &loader);
+	static void RegisterTriangleCountScalarFunctions(ExtensionLoader &loader);
 };
 
 } // namespace duckdb
@@ -14,6 +14,19 @@ struct CoreTableFunctions {
 		RegisterSummarizePropertyGraphTableFunction(loader);
 		RegisterWeaklyConnectedComponentTableFunction(loader);
 		RegisterPageRankTableFunction(loader);
+		RegisterPersonalizedPageRankTableFunction(loader);
+		RegisterBetweennessCentralityTableFunction(loader);
+		RegisterCommunityDetectionTableFunctions(loader);
+		RegisterKCoreTableFunction(loader);
+		RegisterKHopNeighborsTableFunction(loader);
+		RegisterKShortestPathsTableFunction(loader);
+		RegisterAllShortestPathsTableFunctions(loader);
+		RegisterLabeledShortestPathsTableFunction(loader);
+		RegisterRandomWalksTableFunction(loader);
+		RegisterTriangleCountTableFunctions(loader);
+		RegisterCSRCacheTableFunction(loader);
+		RegisterMaterializeCSRTableFunction(loader);
+		RegisterDuckPGQMetricsTableFunction(loader);
 	}
 
 private:
@@ -25,7 +38,20 @@ private:
 	static void RegisterScanTableFunctions(ExtensionLoader &loader);
 	static void RegisterWeaklyConnectedComponentTableFunction(ExtensionLoader &loader);
 	static void RegisterPageRankTableFunction(ExtensionLoader &loader);
+	static void RegisterPersonalizedPageRankTableFunction(ExtensionLoader &loader);
+	static void RegisterBetweennessCentralityTableFunction(ExtensionLoader &loader);
+	static void RegisterCommunityDetectionTableFunctions(ExtensionLoader &loader);
+	static void RegisterKCoreTableFunction(ExtensionLoader &loader);
+	static void RegisterKHopNeighborsTableFunction(ExtensionLoader &loader);
+	static void RegisterKShortestPathsTableFunction(ExtensionLoader &loader);
+	static void RegisterAllShortestPathsTableFunctions(ExtensionLoader &loader);
+	static void RegisterLabeledShortestPathsTableFunction(ExtensionLoader &loader);
+	static void RegisterRandomWalksTableFunction(ExtensionLoader &loader);
+	static void RegisterTriangleCountTableFunctions(ExtensionLoader &loader);
 	static void RegisterSummarizePropertyGraphTableFunction(ExtensionLoader &loader);
+	static void RegisterCSRCacheTableFunction(ExtensionLoader &loader);
+	static void RegisterMaterializeCSRTableFunction(ExtensionLoader &loader);
+	static void RegisterDuckPGQMetricsTableFunction(ExtensionLoader &loader);
 };
 
 } // namespace duckdb
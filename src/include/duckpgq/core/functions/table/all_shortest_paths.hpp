@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/table/all_shortest_paths.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+//! all_shortest_paths(pg, vertex_label, edge_label, sources, destinations) returns every shortest path from every
+//! source to every destination as (source, destination, path, path_length) rows, path being the alternating vertex
+//! and edge rowids like element_id. Pairs without a path have no rows.
+class AllShortestPathsFunction : public TableFunction {
+public:
+	AllShortestPathsFunction() {
+		name = "all_shortest_paths";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::ANY,
+		             LogicalType::ANY};
+		bind_replace = AllShortestPathsBindReplace;
+	}
+
+	static unique_ptr<TableRef> AllShortestPathsBindReplace(ClientContext &context, TableFunctionBindInput &input);
+};
+
+//! shortest_path_count(pg, vertex_label, edge_label, sources, destinations) returns the number of shortest paths from
+//! every source to every destination as (source, destination, path_count) rows, without enumerating them. The count
+//! is NULL for pairs without a path.
+class ShortestPathCountFunction : public TableFunction {
+public:
+	ShortestPathCountFunction() {
+		name = "shortest_path_count";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::ANY,
+		             LogicalType::ANY};
+		bind_replace = ShortestPathCountBindReplace;
+	}
+
+	static unique_ptr<TableRef> ShortestPathCountBindReplace(ClientContext &context, TableFunctionBindInput &input);
+};
+
+} // namespace duckdb
@@ -0,0 +1,29 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/table/betweenness_centrality.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+//! betweenness_centrality(pg, vertex_label, edge_label[, samples]) returns for every vertex the number of shortest
+//! paths between other vertices it lies on, every pair's paths adding up to one. With [samples] only that many
+//! source vertices are searched and the sums are scaled up to estimate the exact result.
+class BetweennessCentralityFunction : public TableFunction {
+public:
+	BetweennessCentralityFunction() {
+		name = "betweenness_centrality";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
+		bind_replace = BetweennessCentralityBindReplace;
+	}
+
+	static unique_ptr<TableRef> BetweennessCentralityBindReplace(ClientContext &context,
+	                                                             TableFunctionBindInput &input);
+};
+
+} // namespace duckdb
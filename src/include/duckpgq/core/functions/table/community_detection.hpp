@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/table/community_detection.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+//! label_propagation(pg, vertex_label, edge_label) returns the community of every vertex of the undirected graph
+//! found by asynchronous label propagation, labeled by the key of one of its vertices
+class LabelPropagationFunction : public TableFunction {
+public:
+	LabelPropagationFunction() {
+		name = "label_propagation";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
+		named_parameters["max_iterations"] = LogicalType::BIGINT;
+		bind_replace = LabelPropagationBindReplace;
+	}
+
+	static unique_ptr<TableRef> LabelPropagationBindReplace(ClientContext &context, TableFunctionBindInput &input);
+};
+
+//! louvain(pg, vertex_label, edge_label) returns the community of every vertex of the undirected graph found by the
+//! Louvain modularity optimization, labeled by the key of one of its vertices
+class LouvainFunction : public TableFunction {
+public:
+	LouvainFunction() {
+		name = "louvain";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
+		named_parameters["resolution"] = LogicalType::DOUBLE;
+		//! Passes of the local moving phase of every level
+		named_parameters["max_iterations"] = LogicalType::BIGINT;
+		bind_replace = LouvainBindReplace;
+	}
+
+	static unique_ptr<TableRef> LouvainBindReplace(ClientContext &context, TableFunctionBindInput &input);
+};
+
+} // namespace duckdb
@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/table/csr_cache.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+class CSRCacheFunction : public TableFunction {
+public:
+	CSRCacheFunction() {
+		name = "duckpgq_csr_cache";
+		bind = CSRCacheBind;
+		init_global = CSRCacheInit;
+		function = CSRCacheFunc;
+	}
+
+	struct CSRCacheRow {
+		string pg_name;
+		string edge_label;
+		bool directed;
+		string weight_column;
+		int64_t vertex_count;
+		int64_t edge_count;
+		int64_t memory_usage;
+		int64_t hits;
+		bool pinned;
+		bool shared;
+		//! PRAGMA create_distance_index built an index on the CSR
+		bool distance_index;
+		//! PRAGMA create_reachability_index built an index on the CSR
+		bool reachability_index;
+	};
+
+	struct CSRCacheGlobalData : public GlobalTableFunctionState {
+		CSRCacheGlobalData() = default;
+		vector<CSRCacheRow> rows;
+		idx_t offset = 0;
+	};
+
+	static unique_ptr<FunctionData> CSRCacheBind(ClientContext &context, TableFunctionBindInput &input,
+	                                             vector<LogicalType> &return_types, vector<string> &names);
+
+	static unique_ptr<GlobalTableFunctionState> CSRCacheInit(ClientContext &context, TableFunctionInitInput &input);
+
+	static void CSRCacheFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output);
+};
+
+} // namespace duckdb
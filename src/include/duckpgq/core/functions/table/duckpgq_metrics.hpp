@@ -0,0 +1,42 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/table/duckpgq_metrics.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckpgq/core/utils/traversal_metrics.hpp"
+
+namespace duckdb {
+
+//! duckpgq_metrics() returns one row per traversal kernel with its counters summed over all queries of the database,
+//! see TraversalMetrics. The counters only grow, the work of a query is the difference of two reads.
+class DuckPGQMetricsFunction : public TableFunction {
+public:
+	DuckPGQMetricsFunction() {
+		name = "duckpgq_metrics";
+		bind = DuckPGQMetricsBind;
+		init_global = DuckPGQMetricsInit;
+		function = DuckPGQMetricsFunc;
+	}
+
+	struct DuckPGQMetricsGlobalData : public GlobalTableFunctionState {
+		DuckPGQMetricsGlobalData() = default;
+		vector<TraversalCounters> rows;
+		idx_t offset = 0;
+	};
+
+	static unique_ptr<FunctionData> DuckPGQMetricsBind(ClientContext &context, TableFunctionBindInput &input,
+	                                                   vector<LogicalType> &return_types, vector<string> &names);
+
+	static unique_ptr<GlobalTableFunctionState> DuckPGQMetricsInit(ClientContext &context,
+	                                                               TableFunctionInitInput &input);
+
+	static void DuckPGQMetricsFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output);
+};
+
+} // namespace duckdb
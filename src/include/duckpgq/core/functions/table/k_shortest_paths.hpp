@@ -0,0 +1,29 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/table/k_shortest_paths.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+//! k_shortest_paths(pg, vertex_label, edge_label, sources, destinations, k) returns the k shortest simple paths from
+//! every source to every destination as (source, destination, path, path_length) rows, path being the alternating
+//! vertex and edge rowids like element_id. Every search stops once it found k paths.
+class KShortestPathsFunction : public TableFunction {
+public:
+	KShortestPathsFunction() {
+		name = "k_shortest_paths";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR,
+		             LogicalType::ANY,     LogicalType::ANY,     LogicalType::BIGINT};
+		bind_replace = KShortestPathsBindReplace;
+	}
+
+	static unique_ptr<TableRef> KShortestPathsBindReplace(ClientContext &context, TableFunctionBindInput &input);
+};
+
+} // namespace duckdb
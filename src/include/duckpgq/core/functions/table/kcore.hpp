@@ -0,0 +1,26 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/table/kcore.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+//! kcore(pg, vertex_label, edge_label) returns the core number of every vertex of the undirected graph
+class KCoreFunction : public TableFunction {
+public:
+	KCoreFunction() {
+		name = "kcore";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
+		bind_replace = KCoreBindReplace;
+	}
+
+	static unique_ptr<TableRef> KCoreBindReplace(ClientContext &context, TableFunctionBindInput &input);
+};
+
+} // namespace duckdb
@@ -0,0 +1,30 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/table/khop_neighbors.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+//! khop_neighbors(pg, vertex_label, edge_label, sources, k) returns for every source the vertices at most k hops
+//! away along the edges, as (source, vertex key, depth) rows. Every source reaches itself at depth 0. With as_of only
+//! the edges valid at that point in time are followed, which requires a temporal index on the cached CSR.
+class KHopNeighborsFunction : public TableFunction {
+public:
+	KHopNeighborsFunction() {
+		name = "khop_neighbors";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::ANY,
+		             LogicalType::BIGINT};
+		named_parameters["as_of"] = LogicalType::ANY;
+		bind_replace = KHopNeighborsBindReplace;
+	}
+
+	static unique_ptr<TableRef> KHopNeighborsBindReplace(ClientContext &context, TableFunctionBindInput &input);
+};
+
+} // namespace duckdb
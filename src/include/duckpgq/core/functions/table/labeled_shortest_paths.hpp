@@ -0,0 +1,31 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/table/labeled_shortest_paths.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+//! labeled_shortest_paths(pg, vertex_label, edge_labels, sources) returns a shortest path from every source to every
+//! vertex it reaches over the edges of any of [edge_labels] as (source, destination, path, path_length) rows, path
+//! being the alternating vertex and edge rowids like element_id. All edge tables between the vertex table and itself
+//! share one labeled CSR, the traversal follows the requested labels through a label mask.
+class LabeledShortestPathsFunction : public TableFunction {
+public:
+	LabeledShortestPathsFunction() {
+		name = "labeled_shortest_paths";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::LIST(LogicalType::VARCHAR),
+		             LogicalType::ANY};
+		bind_replace = LabeledShortestPathsBindReplace;
+	}
+
+	static unique_ptr<TableRef> LabeledShortestPathsBindReplace(ClientContext &context,
+	                                                             TableFunctionBindInput &input);
+};
+
+} // namespace duckdb
@@ -87,10 +87,10 @@ public:
 	static PathElement *HandleNestedSubPath(unique_ptr<PathReference> &path_reference,
 	                                        vector<unique_ptr<ParsedExpression>> &conditions, idx_t element_idx);
 
-	static unique_ptr<ParsedExpression> AddPathQuantifierCondition(const string &prev_binding,
-	                                                               const string &next_binding,
-	                                                               const shared_ptr<PropertyGraphTable> &edge_table,
-	                                                               const SubPath *subpath);
+	static unique_ptr<ParsedExpression>
+	AddPathQuantifierCondition(const string &prev_binding, const string &next_binding,
+	                           const shared_ptr<PropertyGraphTable> &edge_table, const SubPath *subpath,
+	                           const vector<unique_ptr<ParsedExpression>> &conditions);
 
 	static unique_ptr<TableRef> MatchBindReplace(ClientContext &context, TableFunctionBindInput &input);
 
@@ -104,14 +104,22 @@ public:
 	                        PathElement *next_vertex_element,
 	                        vector<unique_ptr<ParsedExpression>> &path_finding_conditions);
 
-	static unique_ptr<ParsedExpression> CreatePathFindingFunction(vector<unique_ptr<PathReference>> &path_list,
+	//! The shortest_path_cte of a pattern whose sources are filtered and whose destinations are not, with one
+	//! search per source that returns the paths to all its targets
+	static unique_ptr<CommonTableExpressionInfo>
+	GenerateSingleSourcePathCTE(CreatePropertyGraphInfo &pg_table, SubPath *edge_subpath, PathElement *path_element,
+	                            vector<unique_ptr<ParsedExpression>> &path_finding_conditions);
+
+	static unique_ptr<ParsedExpression> CreatePathFindingFunction(ClientContext &context,
+	                                                              vector<unique_ptr<PathReference>> &path_list,
 	                                                              CreatePropertyGraphInfo &pg_table,
 	                                                              const string &path_variable,
 	                                                              unique_ptr<SelectNode> &final_select_node,
 	                                                              vector<unique_ptr<ParsedExpression>> &conditions);
 
-	static void AddPathFinding(unique_ptr<SelectNode> &select_node, vector<unique_ptr<ParsedExpression>> &conditions,
-	                           const string &prev_binding, const string &edge_binding, const string &next_binding,
+	static void AddPathFinding(ClientContext &context, unique_ptr<SelectNode> &select_node,
+	                           vector<unique_ptr<ParsedExpression>> &conditions, const string &prev_binding,
+	                           const string &edge_binding, const string &next_binding,
 	                           const shared_ptr<PropertyGraphTable> &edge_table, CreatePropertyGraphInfo &pg_table,
 	                           SubPath *subpath, PGQMatchType edge_type);
 
@@ -123,14 +131,30 @@ public:
 	                         case_insensitive_map_t<shared_ptr<PropertyGraphTable>> &alias_map,
 	                         int32_t &extra_alias_counter, unique_ptr<TableRef> &from_clause);
 
-	static void ProcessPathList(vector<unique_ptr<PathReference>> &path_pattern,
+	static void ProcessPathList(ClientContext &context, vector<unique_ptr<PathReference>> &path_pattern,
 	                            vector<unique_ptr<ParsedExpression>> &conditions, unique_ptr<SelectNode> &select_node,
 	                            case_insensitive_map_t<shared_ptr<PropertyGraphTable>> &alias_map,
 	                            CreatePropertyGraphInfo &pg_table, int32_t &extra_alias_counter,
 	                            MatchExpression &original_ref);
 
-	static void CheckNamedSubpath(SubPath &subpath, MatchExpression &original_ref, CreatePropertyGraphInfo &pg_table,
-	                              unique_ptr<SelectNode> &final_select_node,
+	//! Answers a pattern that forms a single directed cycle, (a)-[e0]->(b)-[e1]->...->(a), by enumerating its
+	//! matches with the cycles() function over the CSR of the edge table. Returns false, leaving the pattern
+	//! untouched, if [path_list] is not such a cycle.
+	static bool AddCycleJoin(ClientContext &context, vector<unique_ptr<PathReference>> &path_list,
+	                         vector<unique_ptr<ParsedExpression>> &conditions, unique_ptr<SelectNode> &select_node,
+	                         case_insensitive_map_t<shared_ptr<PropertyGraphTable>> &alias_map,
+	                         CreatePropertyGraphInfo &pg_table);
+
+	//! Answers a chain of single hops, (a)-[e0]->(b)-[e1]->(c)..., with the expand() function over the cached CSR of
+	//! the edge table instead of joining the edge table once per hop. Returns false, leaving the pattern untouched,
+	//! if [path_list] is not such a chain or no CSR is cached for its edge table.
+	static bool AddExpandJoin(ClientContext &context, vector<unique_ptr<PathReference>> &path_list,
+	                          vector<unique_ptr<ParsedExpression>> &conditions, unique_ptr<SelectNode> &select_node,
+	                          case_insensitive_map_t<shared_ptr<PropertyGraphTable>> &alias_map,
+	                          CreatePropertyGraphInfo &pg_table);
+
+	static void CheckNamedSubpath(ClientContext &context, SubPath &subpath, MatchExpression &original_ref,
+	                              CreatePropertyGraphInfo &pg_table, unique_ptr<SelectNode> &final_select_node,
 	                              vector<unique_ptr<ParsedExpression>> &conditions);
 
 	// Check whether columns to query are valid against the property graph, throws
@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/table/materialize_csr.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+//! Builds the CSR of an edge table and pins it in the CSR cache, used by PRAGMA materialize_csr
+class MaterializeCSRFunction : public TableFunction {
+public:
+	MaterializeCSRFunction() {
+		name = "duckpgq_materialize_csr";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BOOLEAN};
+		bind_replace = MaterializeCSRBindReplace;
+	}
+
+	static unique_ptr<TableRef> MaterializeCSRBindReplace(ClientContext &context, TableFunctionBindInput &input);
+};
+
+//! Builds the CSR of an edge table for the shared CSR cache unless it is cached already, run by the background
+//! connection of SharedCSRStore::SchedulePrebuild
+class PrebuildCSRFunction : public TableFunction {
+public:
+	PrebuildCSRFunction() {
+		name = "duckpgq_prebuild_csr";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BOOLEAN};
+		bind_replace = PrebuildCSRBindReplace;
+	}
+
+	static unique_ptr<TableRef> PrebuildCSRBindReplace(ClientContext &context, TableFunctionBindInput &input);
+};
+
+} // namespace duckdb
@@ -15,6 +15,11 @@ public:
 	PageRankFunction() {
 		name = "pagerank";
 		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
+		named_parameters["damping"] = LogicalType::DOUBLE;
+		named_parameters["tolerance"] = LogicalType::DOUBLE;
+		named_parameters["max_iterations"] = LogicalType::BIGINT;
+		//! Start from the ranks of the last warm_start run on the same edge table and cache the new ones
+		named_parameters["warm_start"] = LogicalType::BOOLEAN;
 		bind_replace = PageRankBindReplace;
 	}
 
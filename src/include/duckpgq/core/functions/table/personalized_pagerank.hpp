@@ -0,0 +1,30 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/table/personalized_pagerank.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+//! personalized_pagerank(pg, vertex_label, edge_label, seeds, k) returns for every seed the k vertices with the
+//! highest personalized PageRank, as (seed, vertex key, score) rows
+class PersonalizedPageRankFunction : public TableFunction {
+public:
+	PersonalizedPageRankFunction() {
+		name = "personalized_pagerank";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::ANY,
+		             LogicalType::BIGINT};
+		named_parameters["damping"] = LogicalType::DOUBLE;
+		named_parameters["tolerance"] = LogicalType::DOUBLE;
+		bind_replace = PersonalizedPageRankBindReplace;
+	}
+
+	static unique_ptr<TableRef> PersonalizedPageRankBindReplace(ClientContext &context, TableFunctionBindInput &input);
+};
+
+} // namespace duckdb
@@ -46,6 +46,55 @@ public:
 	int32_t csr_id;
 };
 
+struct CSRScanArrowData : public TableFunctionData {
+public:
+	//! get_csr_arrow(csr_id) or get_csr_arrow(pg_name, edge_label, directed) for a cached CSR lists the arrays of the
+	//! CSR. With the name of an array and the addresses of an ArrowArray and an ArrowSchema the consumer allocated
+	//! appended, the array is exported into them.
+	static unique_ptr<FunctionData> ScanCSRArrowBind(ClientContext &context, TableFunctionBindInput &input,
+	                                                 vector<LogicalType> &return_types, vector<string> &names) {
+		auto result = make_uniq<CSRScanArrowData>();
+		idx_t csr_arguments = input.inputs.size() == 1 || input.inputs.size() == 4 ? 1 : 3;
+		if (csr_arguments == 1) {
+			result->csr_id = input.inputs[0].GetValue<int32_t>();
+		} else {
+			result->pg_name = input.inputs[0].GetValue<string>();
+			result->edge_label = input.inputs[1].GetValue<string>();
+			result->directed = input.inputs[2].GetValue<bool>();
+		}
+		if (input.inputs.size() > csr_arguments) {
+			for (idx_t i = csr_arguments; i < input.inputs.size(); i++) {
+				if (input.inputs[i].IsNull()) {
+					throw InvalidInputException("The array name and the struct addresses of get_csr_arrow cannot be "
+					                            "NULL");
+				}
+			}
+			result->array_name = input.inputs[csr_arguments].GetValue<string>();
+			result->array_address = input.inputs[csr_arguments + 1].GetValue<uint64_t>();
+			result->schema_address = input.inputs[csr_arguments + 2].GetValue<uint64_t>();
+			if (result->array_address == 0 || result->schema_address == 0) {
+				throw InvalidInputException("get_csr_arrow needs the addresses of an ArrowArray and an ArrowSchema to "
+				                            "export into");
+			}
+		}
+		return_types.emplace_back(LogicalType::VARCHAR);
+		names.emplace_back("name");
+		return_types.emplace_back(LogicalType::BIGINT);
+		names.emplace_back("length");
+		return std::move(result);
+	}
+
+public:
+	int32_t csr_id = 0;
+	string pg_name;
+	string edge_label;
+	bool directed = true;
+	//! The array to export, empty to list the arrays
+	string array_name;
+	uint64_t array_address = 0;
+	uint64_t schema_address = 0;
+};
+
 struct CSRScanEData : public TableFunctionData {
 public:
 	static unique_ptr<FunctionData> ScanCSREBind(ClientContext &context, TableFunctionBindInput &input,
@@ -170,18 +219,66 @@ public:
 struct CSRScanState : public GlobalTableFunctionState {
 public:
 	static unique_ptr<GlobalTableFunctionState> Init(ClientContext &context, TableFunctionInitInput &input) {
-		auto result = make_uniq<CSRScanState>();
-		result->csr_v_offset = 0;
-		result->csr_e_offset = 0;
-		result->csr_w_offset = 0;
-		return std::move(result);
+		return make_uniq<CSRScanState>();
 	}
 
 public:
 	bool finished = false;
-	idx_t csr_v_offset;
-	idx_t csr_e_offset;
-	idx_t csr_w_offset;
+};
+
+//! A parallel scan of v, e or w of a CSR. The threads claim the vectors of the array one at a time, the index of a
+//! vector is the batch index that keeps the output in the order of the array.
+struct CSRArrayScanState : public GlobalTableFunctionState {
+public:
+	CSRArrayScanState(CSR &csr, idx_t size) : csr(csr), size(size) {
+	}
+
+	static unique_ptr<GlobalTableFunctionState> InitV(ClientContext &context, TableFunctionInitInput &input) {
+		auto csr = GetDuckPGQState(context)->GetCSR(input.bind_data->Cast<CSRScanVData>().csr_id);
+		return make_uniq<CSRArrayScanState>(*csr, csr->vsize);
+	}
+	static unique_ptr<GlobalTableFunctionState> InitE(ClientContext &context, TableFunctionInitInput &input) {
+		auto csr = GetDuckPGQState(context)->GetCSR(input.bind_data->Cast<CSRScanEData>().csr_id);
+		csr->LoadPartitions(context);
+		return make_uniq<CSRArrayScanState>(*csr, csr->EdgeCount());
+	}
+	static unique_ptr<GlobalTableFunctionState> InitW(ClientContext &context, TableFunctionInitInput &input) {
+		auto &bind_data = input.bind_data->Cast<CSRScanWData>();
+		auto csr = GetDuckPGQState(context)->GetCSR(bind_data.csr_id);
+		return make_uniq<CSRArrayScanState>(*csr, bind_data.is_double ? csr->w_double.size() : csr->w.size());
+	}
+
+	idx_t MaxThreads() const override {
+		return MaxValue<idx_t>((size + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE, 1);
+	}
+
+	//! Claims the next vector of the array, returns false once the whole array has been claimed
+	bool Next(idx_t &batch_index, idx_t &offset, idx_t &count) {
+		batch_index = next_batch++;
+		offset = batch_index * STANDARD_VECTOR_SIZE;
+		if (offset >= size) {
+			return false;
+		}
+		count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, size - offset);
+		return true;
+	}
+
+public:
+	CSR &csr;
+	idx_t size;
+	atomic<idx_t> next_batch {0};
+};
+
+struct CSRArrayScanLocalState : public LocalTableFunctionState {
+public:
+	static unique_ptr<LocalTableFunctionState> Init(ExecutionContext &context, TableFunctionInitInput &input,
+	                                                GlobalTableFunctionState *global_state) {
+		return make_uniq<CSRArrayScanLocalState>();
+	}
+
+public:
+	//! The vector of the array the thread returned last
+	idx_t batch_index = 0;
 };
 
 } // namespace duckdb
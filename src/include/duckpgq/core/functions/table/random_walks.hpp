@@ -0,0 +1,32 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/table/random_walks.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+//! random_walks(pg, vertex_label, edge_label, walk_length, walks_per_node[, p, q]) returns walks_per_node random
+//! walks of at most walk_length vertices from every vertex of the undirected graph, one row per walk with the key of
+//! its start and the list of the rowids of its vertices. The node2vec parameters p and q bias the walks towards
+//! returning (small p) or moving outwards (small q), both default to 1 for uniform walks. The walks are the same for
+//! the same seed.
+class RandomWalksFunction : public TableFunction {
+public:
+	RandomWalksFunction() {
+		name = "random_walks";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BIGINT,
+		             LogicalType::BIGINT};
+		named_parameters["seed"] = LogicalType::BIGINT;
+		bind_replace = RandomWalksBindReplace;
+	}
+
+	static unique_ptr<TableRef> RandomWalksBindReplace(ClientContext &context, TableFunctionBindInput &input);
+};
+
+} // namespace duckdb
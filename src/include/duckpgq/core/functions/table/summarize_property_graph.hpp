@@ -10,14 +10,20 @@
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/parser/parsed_data/create_property_graph_info.hpp"
 #include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
 
 namespace duckdb {
 
+//! summarize_property_graph(pg) returns a row of statistics for every vertex and edge table of the graph. With
+//! csr := true the statistics of an edge table whose directed CSR is cached come from one pass over the CSR and its
+//! reverse instead of a scan of the edge table per statistic, the quantiles then from a DegreeSketch. They only count
+//! the edges between existing vertices. Edge tables without a cached CSR are summarized with queries as before.
 class SummarizePropertyGraphFunction : public TableFunction {
 public:
 	SummarizePropertyGraphFunction() {
 		name = "summarize_property_graph";
 		arguments.push_back(LogicalType::VARCHAR);
+		named_parameters["csr"] = LogicalType::BOOLEAN;
 		bind_replace = SummarizePropertyGraphBindReplace;
 	}
 
@@ -49,6 +55,8 @@ public:
 	static unique_ptr<CommonTableExpressionInfo>
 	CreateVertexTableCTE(const shared_ptr<PropertyGraphTable> &vertex_table);
 	static unique_ptr<CommonTableExpressionInfo> CreateEdgeTableCTE(shared_ptr<PropertyGraphTable> &edge_table);
+	static unique_ptr<CommonTableExpressionInfo>
+	CreateEdgeTableCSRCTE(ClientContext &context, const shared_ptr<PropertyGraphTable> &edge_table, CSR &csr);
 
 	static unique_ptr<TableRef> HandleSingleVertexTable(const shared_ptr<PropertyGraphTable> &vertex_table,
 	                                                    const string &stat_table_alias);
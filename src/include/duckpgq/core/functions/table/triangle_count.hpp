@@ -0,0 +1,39 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/functions/table/triangle_count.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+//! triangle_count(pg, vertex_label, edge_label) returns the number of triangles of the undirected graph
+class TriangleCountFunction : public TableFunction {
+public:
+	TriangleCountFunction() {
+		name = "triangle_count";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
+		bind_replace = TriangleCountBindReplace;
+	}
+
+	static unique_ptr<TableRef> TriangleCountBindReplace(ClientContext &context, TableFunctionBindInput &input);
+};
+
+//! global_clustering_coefficient(pg, vertex_label, edge_label) returns the transitivity of the undirected graph
+class GlobalClusteringCoefficientFunction : public TableFunction {
+public:
+	GlobalClusteringCoefficientFunction() {
+		name = "global_clustering_coefficient";
+		arguments = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
+		bind_replace = GlobalClusteringCoefficientBindReplace;
+	}
+
+	static unique_ptr<TableRef> GlobalClusteringCoefficientBindReplace(ClientContext &context,
+	                                                                   TableFunctionBindInput &input);
+};
+
+} // namespace duckdb
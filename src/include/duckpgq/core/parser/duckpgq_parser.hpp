@@ -17,6 +17,23 @@ private:
 struct DuckPGQParserExtensionInfo : ParserExtensionInfo {
 	DuckPGQParserExtensionInfo() : ParserExtensionInfo() {};
 	~DuckPGQParserExtensionInfo() override = default;
+
+	//! The number of query strings whose statements are kept, a repeated query is copied instead of parsed again
+	static constexpr idx_t PARSE_CACHE_CAPACITY = 128;
+
+	//! A copy of the statement parsed from [query], or nullptr if it is not cached
+	unique_ptr<SQLStatement> GetParsedStatement(const string &query);
+	void CacheParsedStatement(const string &query, const SQLStatement &statement);
+
+private:
+	struct ParsedStatement {
+		unique_ptr<SQLStatement> statement;
+		idx_t last_used = 0;
+	};
+	//! Shared by the connections of the database
+	mutex parse_cache_lock;
+	unordered_map<string, ParsedStatement> parse_cache;
+	idx_t parse_cache_clock = 0;
 };
 
 ParserExtensionParseResult duckpgq_parse(ParserExtensionInfo *info, const std::string &query);
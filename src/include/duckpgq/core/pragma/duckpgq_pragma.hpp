@@ -17,11 +17,37 @@ public:
 	static void Register(ExtensionLoader &loader) {
 		RegisterShowPropertyGraphs(loader);
 		RegisterCreateVertexTable(loader);
+		RegisterCSRCacheSize(loader);
+		RegisterCompactCSR(loader);
+		RegisterIncrementalCSR(loader);
+		RegisterMaterializeCSR(loader);
+		RegisterPartitionedCSR(loader);
+		RegisterCSRVertexOrder(loader);
+		RegisterCSRSnapshot(loader);
+		RegisterCyclicMatch(loader);
+		RegisterCSRExpand(loader);
+		RegisterMatchCacheSize(loader);
+		RegisterDistanceIndex(loader);
+		RegisterReachabilityIndex(loader);
+		RegisterTemporalIndex(loader);
 	}
 
 private:
 	static void RegisterShowPropertyGraphs(ExtensionLoader &loader);
 	static void RegisterCreateVertexTable(ExtensionLoader &loader);
+	static void RegisterCSRCacheSize(ExtensionLoader &loader);
+	static void RegisterCompactCSR(ExtensionLoader &loader);
+	static void RegisterIncrementalCSR(ExtensionLoader &loader);
+	static void RegisterMaterializeCSR(ExtensionLoader &loader);
+	static void RegisterPartitionedCSR(ExtensionLoader &loader);
+	static void RegisterCSRVertexOrder(ExtensionLoader &loader);
+	static void RegisterCSRSnapshot(ExtensionLoader &loader);
+	static void RegisterCyclicMatch(ExtensionLoader &loader);
+	static void RegisterCSRExpand(ExtensionLoader &loader);
+	static void RegisterMatchCacheSize(ExtensionLoader &loader);
+	static void RegisterDistanceIndex(ExtensionLoader &loader);
+	static void RegisterReachabilityIndex(ExtensionLoader &loader);
+	static void RegisterTemporalIndex(ExtensionLoader &loader);
 };
 
 } // namespace duckdb
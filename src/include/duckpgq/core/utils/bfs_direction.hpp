@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/bfs_direction.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+enum class BFSDirection : uint8_t {
+	//! Push the frontier along the outgoing edges
+	TOP_DOWN,
+	//! Let every vertex that is not yet seen pull from its incoming edges
+	BOTTOM_UP
+};
+
+//! Size of the frontier produced by one BFS step
+struct BFSFrontier {
+	idx_t vertex_count = 0;
+	//! Sum of the out-degrees of the frontier vertices
+	idx_t edge_count = 0;
+};
+
+//! Direction-optimizing BFS policy (Beamer et al.). Starts top-down, switches to bottom-up once the frontier touches
+//! more than 1/ALPHA of the edges that have not been explored yet, and returns to top-down once the frontier holds
+//! fewer than 1/BETA of the vertices.
+class BFSDirectionPolicy {
+public:
+	static constexpr idx_t ALPHA = 14;
+	static constexpr idx_t BETA = 24;
+
+	BFSDirectionPolicy(idx_t vertex_count, idx_t edge_count)
+	    : vertex_count(vertex_count), unexplored_edges(edge_count) {
+	}
+
+	//! Direction of the next step, given the frontier it starts from
+	BFSDirection Next(const BFSFrontier &frontier) {
+		unexplored_edges -= MinValue<idx_t>(unexplored_edges, frontier.edge_count);
+		if (direction == BFSDirection::TOP_DOWN) {
+			if (frontier.edge_count * ALPHA > unexplored_edges) {
+				direction = BFSDirection::BOTTOM_UP;
+			}
+		} else if (frontier.vertex_count * BETA < vertex_count) {
+			direction = BFSDirection::TOP_DOWN;
+		}
+		return direction;
+	}
+
+private:
+	idx_t vertex_count;
+	idx_t unexplored_edges;
+	BFSDirection direction = BFSDirection::TOP_DOWN;
+};
+
+} // namespace duckdb
@@ -8,6 +8,7 @@
 
 #pragma once
 #include <atomic>
+#include <chrono>
 #include "duckdb/function/function.hpp"
 
 #include "duckdb/parser/expression/cast_expression.hpp"
@@ -20,9 +21,65 @@
 #include "duckdb/parser/query_node/select_node.hpp"
 #include "duckdb/parser/tableref/joinref.hpp"
 #include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/memory_reservation.hpp"
 
 namespace duckdb {
 
+//! Range and mean of the edge weights of a weighted CSR
+struct CSRWeightStatistics {
+	double min = 0;
+	double max = 0;
+	double mean = 0;
+};
+
+//! The adjacency list of vertex i spans [begin[i], end[i]) of the neighbor and edge id arrays
+struct CSRRanges {
+	//! The ranges of a CSR without delta, where every list ends where the next one starts
+	CSRRanges(const int64_t *v) : begin(v), end(v + 1) { // NOLINT: allow implicit conversion from v
+	}
+	CSRRanges(const int64_t *begin, const int64_t *end) : begin(begin), end(end) {
+	}
+
+	const int64_t *begin;
+	const int64_t *end;
+};
+
+class CSRPartitions;
+class CSRBlocks;
+class CSRDistanceIndex;
+class CSRReachabilityIndex;
+class CSRTemporalIndex;
+
+//! Number of edge labels a CSR over several edge tables can distinguish, the label sets of the traversals are
+//! 64-bit masks
+static constexpr idx_t CSR_LABEL_LIMIT = 64;
+//! The csr_id under which the path-finding queries over left-directed edges find the reverse of CSR 0
+static constexpr int32_t REVERSE_CSR_ID = 1;
+
+//! Order in which Finalize renumbers the vertices of a CSR, set with duckpgq_csr_vertex_order
+enum class CSRVertexOrder : uint8_t {
+	//! Vertex ids are the rowids of the vertex table
+	NONE,
+	//! Decreasing out-degree, the hubs of a power-law graph share the first cache lines of every array
+	DEGREE,
+	//! Reverse Cuthill-McKee, a BFS that visits neighbors of low degree first, so that adjacent vertices get close ids
+	RCM
+};
+
+//! Edge insertions and deletions applied to a CSR after it was built, so that writes to the edge table do not
+//! require a rebuild. The adjacency lists of the changed vertices are rewritten to a log at the end of the neighbor
+//! and edge id arrays, past base_edge_count, and begin and end point every vertex at its current list in either the
+//! base arrays or the log. Vertices added since the build have an empty list unless they gained edges.
+struct CSRDelta {
+	idx_t vertex_count = 0;
+	//! Size of the neighbor array when the delta was applied, everything past it belongs to the log
+	idx_t base_edge_count = 0;
+	//! Number of edges in the current lists
+	idx_t edge_count = 0;
+	vector<int64_t> begin;
+	vector<int64_t> end;
+};
+
 class CSR {
 public:
 	CSR() = default;
@@ -31,7 +88,12 @@ public:
 	unique_ptr<atomic<int64_t>[]> v;
 
 	vector<int64_t> e;
+	//! Neighbors stored with 32-bit ids, replaces e once the CSR has been compacted
+	vector<int32_t> e_compact;
 	vector<int64_t> edge_ids;
+	//! The label id of every adjacency entry of a CSR over several edge tables, empty for a CSR over one. The edge
+	//! ids are the rowids within the edge table of their label.
+	vector<uint8_t> edge_labels;
 
 	vector<int64_t> w;
 	vector<double> w_double;
@@ -41,24 +103,211 @@ public:
 	bool initialized_w = false;
 
 	size_t vsize {};
+	//! Number of edges written by create_csr_edge so far
+	atomic<int64_t> inserted_edges {0};
+	//! Every adjacency list is sorted by (neighbor, edge id)
+	bool sorted = false;
+	//! The neighbors are stored in e_compact instead of e
+	bool compact = false;
+	//! Built by create_csr_undirected_edge, every edge is in the adjacency lists of both its endpoints
+	bool symmetric = false;
+	//! Changes since the CSR was built that have not been merged into the arrays yet
+	unique_ptr<CSRDelta> delta;
+	//! The memory of the arrays registered with the BufferManager, the reverse CSR has its own
+	MemoryReservation memory;
+	//! The id of every rowid in v and e if Finalize renumbered the vertices, empty otherwise. external_id is the
+	//! inverse. Kernels translate their vertex arguments with InternalIds and the vertices they return with
+	//! ExternalId, the reverse CSR and all intermediate state use the internal ids.
+	vector<int64_t> internal_id;
+	vector<int64_t> external_id;
+	//! Number of arrays exported through ExportCSRToArrow that a consumer still holds. The arrays must not change
+	//! while there are any, a refresh drops the CSR from the cache instead.
+	atomic<idx_t> arrow_exports {0};
+	//! When create_csr_vertex started to build the CSR, for the build time in the TraversalMetrics
+	std::chrono::steady_clock::time_point build_start;
 
 	string ToString() const;
+	//! Whether all edges have been inserted
+	bool IsComplete() const;
+	//! Approximate number of bytes held by the CSR arrays
+	idx_t GetMemoryUsage() const;
+	//! Adjusts the reservation to the current arrays plus [extra] bytes that are about to be allocated. Throws an
+	//! OutOfMemoryException if that exceeds memory_limit after evicting the cached CSRs.
+	void ReserveMemory(ClientContext &context, idx_t extra = 0);
+	//! Sorts all adjacency lists in parallel
+	void SortAdjacencyLists(ClientContext &context);
+	//! Renumbers the vertices in the order of duckpgq_csr_vertex_order, sorts the adjacency lists and compacts the CSR
+	//! if duckpgq_compact_csr is set, called once all edges are in
+	void Finalize(ClientContext &context);
+	//! Renumbers the vertices in [order] and fills internal_id and external_id. The adjacency lists are unsorted
+	//! afterwards. Only for CSRs without delta or partitions, does nothing once the CSR is compacted or relabeled.
+	void Relabel(ClientContext &context, CSRVertexOrder order);
+	bool IsRelabeled() const {
+		return !external_id.empty();
+	}
+	//! The id of [vertex] in the CSR arrays, ids outside of the graph are returned as they are
+	int64_t InternalId(int64_t vertex) const {
+		if (!IsRelabeled() || vertex < 0 || vertex >= static_cast<int64_t>(internal_id.size())) {
+			return vertex;
+		}
+		return internal_id[vertex];
+	}
+	//! The rowid of the vertex with id [vertex] in the CSR arrays
+	int64_t ExternalId(int64_t vertex) const {
+		if (!IsRelabeled() || vertex < 0 || vertex >= static_cast<int64_t>(external_id.size())) {
+			return vertex;
+		}
+		return external_id[vertex];
+	}
+	//! Translates the vertices at the even positions of an alternating vertex and edge id path back to rowids
+	void ExternalPathIds(vector<int64_t> &path) const {
+		ExternalPathIds(path.data(), path.size());
+	}
+	//! Same for the [length] ids at [path], e.g. a path written into the child vector of a list in place
+	void ExternalPathIds(int64_t *path, idx_t length) const {
+		if (!IsRelabeled()) {
+			return;
+		}
+		for (idx_t i = 0; i < length; i += 2) {
+			path[i] = ExternalId(path[i]);
+		}
+	}
+	//! The internal ids of the BIGINT vertex ids in the first [count] rows of [format], at the same positions as in
+	//! format.data. Returns format.data itself if the CSR was not relabeled, [buffer] holds the ids otherwise.
+	const int64_t *InternalIds(const UnifiedVectorFormat &format, idx_t count, vector<int64_t> &buffer) const;
+	bool IsLabeled() const {
+		return !edge_labels.empty();
+	}
+	//! Number of edges, independent of the neighbor representation
+	idx_t EdgeCount() const;
+	//! Moves the neighbors into e_compact if every vertex id fits into 32 bits, called once all edges are inserted
+	void Compact();
+	//! The neighbor array for id width E, kernels are instantiated for both int32_t and int64_t
+	template <class E>
+	vector<E> &GetNeighbors();
+	//! The CSR of the incoming edges, built on first use and kept alive together with this CSR. The edge ids, labels
+	//! and vertex ids are carried over, weights are not.
+	CSR &GetReverse(ClientContext &context);
+	//! GetReverse as a shared pointer, so the reverse can be installed in the csr_list next to this CSR
+	shared_ptr<CSR> GetReverseCSR(ClientContext &context);
+	//! Statistics of w or w_double, computed on first use
+	const CSRWeightStatistics &GetWeightStatistics();
+	//! w narrowed to 32 bits, built on first use. nullptr unless the weights are integers and every distance of a path
+	//! without cycles fits into an int32_t, so the weighted searches can keep 32-bit distances as well.
+	shared_ptr<const vector<int32_t>> GetNarrowWeights();
+	//! The adjacency lists split into blocks of about [block_edges] edges for the parallel kernels, built on first use
+	//! and rebuilt when a kernel asks for another block size. Kernels keep the returned pointer while they use it.
+	shared_ptr<const CSRBlocks> GetBlocks(idx_t block_edges);
+	//! The index of PRAGMA create_distance_index, nullptr if there is none. It is dropped when a delta changes the
+	//! edges, the kernels fall back to their searches until it is built again.
+	shared_ptr<const CSRDistanceIndex> GetDistanceIndex() const;
+	void SetDistanceIndex(shared_ptr<const CSRDistanceIndex> index);
+	//! The index of PRAGMA create_reachability_index, nullptr if there is none. Dropped like the distance index.
+	shared_ptr<const CSRReachabilityIndex> GetReachabilityIndex() const;
+	void SetReachabilityIndex(shared_ptr<const CSRReachabilityIndex> index);
+	//! The edge validity intervals of PRAGMA create_temporal_index, nullptr if there are none. Dropped like the
+	//! distance index.
+	shared_ptr<const CSRTemporalIndex> GetTemporalIndex() const;
+	void SetTemporalIndex(shared_ptr<const CSRTemporalIndex> index);
+
+	//! Number of vertices including those added by the delta
+	idx_t VertexCount() const {
+		return delta ? delta->vertex_count : vsize - 2;
+	}
+	//! The adjacency list ranges, which read through the delta if there is one
+	CSRRanges GetRanges() const;
+	//! Number of neighbor entries in the log of the delta
+	idx_t DeltaSize() const;
+	//! Replaces the adjacency lists of [vertices], in increasing order, by the lists [list_offsets] delimits in
+	//! [neighbors] and [neighbor_edge_ids]. The lists of all other vertices are those of the base arrays, which the
+	//! log of a previous delta is cut from first. [vertex_count] may exceed the number of vertices of the base.
+	//! Only for unweighted CSRs.
+	void ApplyDelta(ClientContext &context, idx_t vertex_count, const vector<int64_t> &vertices,
+	                const vector<idx_t> &list_offsets, const vector<int64_t> &neighbors,
+	                const vector<int64_t> &neighbor_edge_ids);
+	//! Rewrites the arrays so that v describes the current adjacency lists again and drops the delta. Kernels that
+	//! do not read through GetRanges call this first. The new arrays exist next to the old ones for a while,
+	//! callers reserve MergeMemoryUsage bytes for them beforehand.
+	void MergeDelta();
+	idx_t MergeMemoryUsage() const;
+
+	//! Stores the adjacency lists in CSRPartitions of about [edges_per_partition] edges instead of e and edge_ids.
+	//! Called by create_csr_edge once v holds the list offsets, before any edge is inserted. Only for unweighted CSRs.
+	void Partition(ClientContext &context, idx_t edges_per_partition);
+	//! The partitions of an out-of-core CSR, nullptr if e and edge_ids hold the adjacency lists. Kernels keep the
+	//! returned pointer for as long as they read the partitions.
+	shared_ptr<CSRPartitions> GetPartitions() const;
+	//! Moves the adjacency lists of a partitioned CSR back into e and edge_ids and sorts them, for the kernels that
+	//! index e directly. Thread-safe, does nothing if the CSR is not partitioned.
+	void LoadPartitions(ClientContext &context);
+
+private:
+	//! Size of the neighbor array, including the log of the delta
+	idx_t NeighborArraySize() const {
+		if (partitioned_edges > 0) {
+			return partitioned_edges;
+		}
+		return compact ? e_compact.size() : e.size();
+	}
+	void ResetReverse();
+	void ResetBlocks();
+	//! GetMemoryUsage without the reverse CSR
+	idx_t ArrayMemoryUsage() const;
+
+	mutex delta_lock;
+	shared_ptr<CSRPartitions> partitions;
+	//! Number of edges in the partitions, 0 if the CSR is not partitioned
+	atomic<idx_t> partitioned_edges {0};
+	mutable mutex partitions_lock;
+	shared_ptr<CSR> reverse;
+	mutex reverse_lock;
+	unique_ptr<CSRWeightStatistics> weight_statistics;
+	shared_ptr<const vector<int32_t>> narrow_weights;
+	bool narrow_weights_checked = false;
+	//! Guards weight_statistics and narrow_weights
+	mutable mutex weight_statistics_lock;
+	shared_ptr<const CSRBlocks> blocks;
+	mutex blocks_lock;
+	shared_ptr<const CSRDistanceIndex> distance_index;
+	shared_ptr<const CSRReachabilityIndex> reachability_index;
+	shared_ptr<const CSRTemporalIndex> temporal_index;
+	//! Guards distance_index, reachability_index and temporal_index
+	mutable mutex distance_index_lock;
 };
 
+template <>
+inline vector<int64_t> &CSR::GetNeighbors<int64_t>() {
+	D_ASSERT(!compact);
+	return e;
+}
+
+template <>
+inline vector<int32_t> &CSR::GetNeighbors<int32_t>() {
+	D_ASSERT(compact);
+	return e_compact;
+}
+
 struct CSRFunctionData : FunctionData {
-	CSRFunctionData(ClientContext &context, int32_t id, const LogicalType &weight_type);
+	CSRFunctionData(ClientContext &context, int32_t id, const LogicalType &weight_type, bool labeled = false,
+	                bool symmetric = false);
 	unique_ptr<FunctionData> Copy() const override;
 	bool Equals(const FunctionData &other_p) const override;
 	static unique_ptr<FunctionData> CSRVertexBind(ClientContext &context, ScalarFunction &bound_function,
 	                                              vector<unique_ptr<Expression>> &arguments);
 	static unique_ptr<FunctionData> CSREdgeBind(ClientContext &context, ScalarFunction &bound_function,
 	                                            vector<unique_ptr<Expression>> &arguments);
+	static unique_ptr<FunctionData> CSRUndirectedEdgeBind(ClientContext &context, ScalarFunction &bound_function,
+	                                                      vector<unique_ptr<Expression>> &arguments);
 	static unique_ptr<FunctionData> CSRBind(ClientContext &context, ScalarFunction &bound_function,
 	                                        vector<unique_ptr<Expression>> &arguments);
 
 	ClientContext &context;
 	const int32_t id;
 	const LogicalType weight_type;
+	//! create_csr_edge takes the label id of every edge instead of a weight
+	const bool labeled;
+	//! create_csr_edge inserts every edge in both directions
+	const bool symmetric;
 };
 
 // CSR BindReplace functions
@@ -68,7 +317,28 @@ unique_ptr<CommonTableExpressionInfo> CreateDirectedCSRCTE(const shared_ptr<Prop
                                                            const string &prev_binding, const string &edge_binding,
                                                            const string &next_binding);
 
+//! CSR BindReplace functions that reuse a cached CSR for [pg_name] when possible, in which case the returned CTE
+//! only produces the temp column expected by the queries that depend on it
+unique_ptr<CommonTableExpressionInfo> CreateUndirectedCSRCTE(ClientContext &context, const string &pg_name,
+                                                             const shared_ptr<PropertyGraphTable> &edge_table,
+                                                             const unique_ptr<SelectNode> &select_node);
+unique_ptr<CommonTableExpressionInfo> CreateDirectedCSRCTE(ClientContext &context, const string &pg_name,
+                                                           const shared_ptr<PropertyGraphTable> &edge_table,
+                                                           const string &prev_binding, const string &edge_binding,
+                                                           const string &next_binding);
+//! SELECT create_csr_reverse(0, REVERSE_CSR_ID, count(__forward.temp)) AS temp FROM (<forward>) __forward, the CTE
+//! of [forward] that also installs the CSR of the incoming edges, built from the forward CSR once it is complete
+unique_ptr<CommonTableExpressionInfo> CreateReverseCSRCTE(unique_ptr<CommonTableExpressionInfo> forward);
+//! The CTE that builds one directed CSR over all [edge_tables], which connect [vertex_table] to itself. The label id
+//! of an edge is the position of its table in [edge_tables], so that a traversal can follow any subset of them.
+//! Cached under the labels of all edge tables joined by '|'.
+unique_ptr<CommonTableExpressionInfo> CreateLabeledCSRCTE(ClientContext &context, const string &pg_name,
+                                                          const shared_ptr<PropertyGraphTable> &vertex_table,
+                                                          const vector<shared_ptr<PropertyGraphTable>> &edge_tables,
+                                                          const unique_ptr<SelectNode> &select_node);
+
 // Helper functions
+unique_ptr<CommonTableExpressionInfo> CreateCachedCSRCTE();
 unique_ptr<CommonTableExpressionInfo> MakeEdgesCTE(const shared_ptr<PropertyGraphTable> &edge_table);
 unique_ptr<SubqueryExpression> CreateDirectedCSRVertexSubquery(const shared_ptr<PropertyGraphTable> &edge_table,
                                                                const string &binding);
@@ -80,6 +350,12 @@ unique_ptr<JoinRef> GetJoinRef(const shared_ptr<PropertyGraphTable> &edge_table,
                                const string &prev_binding, const string &next_binding);
 unique_ptr<SubqueryExpression> GetCountTable(const shared_ptr<PropertyGraphTable> &table, const string &table_alias,
                                              const string &primary_key);
+//! (SELECT coalesce(max(<alias>.rowid) + 1, 0) FROM <table> <alias>), the number of vertices of a CSR over [table].
+//! The vertex ids are the rowids, which have gaps once rows are deleted, so the row count can be too small.
+unique_ptr<SubqueryExpression> GetRowidBound(const shared_ptr<PropertyGraphTable> &table, const string &table_alias);
+//! The vertex count argument of the path-finding functions, which take the vertex count from the CSR. A NULL
+//! BIGINT, so the rewritten queries do not scan the vertex table for it.
+unique_ptr<ParsedExpression> CreateVertexCountArgument();
 void SetupSelectNode(unique_ptr<SelectNode> &select_node, const shared_ptr<PropertyGraphTable> &edge_table,
                      bool reverse = false);
 unique_ptr<SubqueryRef> CreateCountCTESubquery();
@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/csr_algebra.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+#include "duckpgq/core/utils/csr_blocks.hpp"
+#include "duckpgq/core/utils/duckpgq_parallel.hpp"
+
+namespace duckdb {
+
+// Sparse linear algebra over the adjacency matrix of a CSR, in the style of GraphBLAS. Entry (i, j) of the matrix
+// is the edge i -> j, so a row is an adjacency list. A semiring names the value type of the kernels, Add, which
+// combines the products of a row and is associative and commutative with identity Zero(), and Multiply, which
+// combines a matrix entry with a vector entry. One() is the entry of an unweighted matrix. PageRank pulls its
+// contributions through MxV over the plus-times semiring, the searches of reachable_targets without an edge predicate
+// push their frontiers through MaskedBooleanVxM.
+
+//! Reachability: an entry of a product is set if any of the entries it combines is
+struct BooleanSemiring {
+	using value_t = uint8_t;
+	static value_t Zero() {
+		return 0;
+	}
+	static value_t One() {
+		return 1;
+	}
+	static value_t Add(value_t a, value_t b) {
+		return a | b;
+	}
+	static value_t Multiply(value_t entry, value_t x) {
+		return entry & x;
+	}
+};
+
+//! Sums of weighted values, like the contributions of PageRank or the path counts of a BFS
+template <class T>
+struct PlusTimesSemiring {
+	using value_t = T;
+	static value_t Zero() {
+		return 0;
+	}
+	static value_t One() {
+		return 1;
+	}
+	static value_t Add(value_t a, value_t b) {
+		return a + b;
+	}
+	static value_t Multiply(value_t entry, value_t x) {
+		return entry * x;
+	}
+};
+
+//! The adjacency matrix of a CSR without delta, with the weights in [values] indexed by CSR offset, or One() for
+//! every edge if [values] is nullptr
+template <class SEMIRING, class ID_T>
+struct CSRMatrix {
+	using value_t = typename SEMIRING::value_t;
+
+	CSRMatrix(CSR &csr, const vector<value_t> *values = nullptr)
+	    : ranges(csr.GetRanges()), columns(csr.GetNeighbors<ID_T>()), values(values ? values->data() : nullptr),
+	      row_count(csr.VertexCount()) {
+	}
+
+	value_t Entry(int64_t offset) const {
+		return values ? values[offset] : SEMIRING::One();
+	}
+
+	CSRRanges ranges;
+	const vector<ID_T> &columns;
+	const value_t *values;
+	idx_t row_count;
+};
+
+//! y = A x: y[i] is the sum over the row of vertex i of the entries times the x of their columns. The rows are split
+//! into [blocks] of about equal numbers of edges that the threads work on, and the rows of hubs into slices whose
+//! sums are added up per hub in slice order, so every entry of y is summed in column order whatever the
+//! scheduling.
+template <class SEMIRING, class ID_T>
+void MxV(ClientContext &context, const CSRMatrix<SEMIRING, ID_T> &matrix, const CSRBlocks &blocks,
+         const vector<typename SEMIRING::value_t> &x, vector<typename SEMIRING::value_t> &y) {
+	using value_t = typename SEMIRING::value_t;
+	auto row_sum = [&](int64_t begin, int64_t end) {
+		auto sum = SEMIRING::Zero();
+		for (auto offset = begin; offset < end; offset++) {
+			sum = SEMIRING::Add(sum, SEMIRING::Multiply(matrix.Entry(offset), x[matrix.columns[offset]]));
+		}
+		return sum;
+	};
+	// The sums of the slices of the hubs, by block
+	vector<value_t> slice_sums(blocks.hubs.empty() ? 0 : blocks.blocks.size(), SEMIRING::Zero());
+	ParallelFor(context, blocks.blocks.size(), 1, [&](idx_t begin, idx_t end) {
+		for (auto b = begin; b < end; b++) {
+			auto &block = blocks.blocks[b];
+			if (block.IsHubSlice()) {
+				slice_sums[b] = row_sum(block.offset_begin, block.offset_end);
+				continue;
+			}
+			for (auto i = block.vertex_begin; i < block.vertex_end; i++) {
+				y[i] = row_sum(matrix.ranges.begin[i], matrix.ranges.end[i]);
+			}
+		}
+	});
+	for (auto &hub : blocks.hubs) {
+		auto sum = SEMIRING::Zero();
+		for (auto b = hub.block_begin; b < hub.block_end; b++) {
+			sum = SEMIRING::Add(sum, slice_sums[b]);
+		}
+		y[hub.vertex] = sum;
+	}
+}
+
+//! y<!mask> = x A over the boolean semiring for a sparse x, given as the indices of its set entries: y gets every
+//! column of the rows of x whose entry of [mask] is not set, once, in the order of the rows in x and of the columns in
+//! a row. The columns added to y are set in [mask], so with the visited vertices of a BFS as [mask] and its frontier
+//! as x, y is the next frontier and [mask] holds the vertices visited after it.
+template <class ID_T>
+void MaskedBooleanVxM(const CSRMatrix<BooleanSemiring, ID_T> &matrix, const vector<int64_t> &x, vector<uint8_t> &mask,
+                      vector<int64_t> &y) {
+	y.clear();
+	for (auto row : x) {
+		for (auto offset = matrix.ranges.begin[row]; offset < matrix.ranges.end[row]; offset++) {
+			auto column = static_cast<int64_t>(matrix.columns[offset]);
+			if (!mask[column]) {
+				mask[column] = 1;
+				y.push_back(column);
+			}
+		}
+	}
+}
+
+//! Breadth-first search from one source as a sequence of MaskedBooleanVxM, each multiplying the frontier with the
+//! adjacency matrix under the mask of the visited vertices. Offers Run, Reached and Depth like a SingleSourceBFS
+//! without edge filter and reaches the vertices in the same order. The arrays are kept across the searches of a
+//! chunk and only the vertices the previous search reached are reset.
+template <class ID_T>
+class BooleanFrontierBFS {
+public:
+	BooleanFrontierBFS(CSR &csr, idx_t vertex_count) : matrix(csr), visited(vertex_count, 0), depth(vertex_count, 0) {
+	}
+
+	//! Reaches the vertices at most [upper] hops from [source], in the order of their distance
+	void Run(int64_t source, int64_t upper) {
+		for (auto vertex : reached) {
+			visited[vertex] = 0;
+		}
+		reached.clear();
+		visited[source] = 1;
+		depth[source] = 0;
+		reached.push_back(source);
+		frontier.assign(1, source);
+		for (int64_t step = 1; step <= upper && !frontier.empty(); step++) {
+			MaskedBooleanVxM(matrix, frontier, visited, next);
+			for (auto vertex : next) {
+				depth[vertex] = step;
+			}
+			reached.insert(reached.end(), next.begin(), next.end());
+			std::swap(frontier, next);
+		}
+	}
+
+	const vector<int64_t> &Reached() const {
+		return reached;
+	}
+	int64_t Depth(int64_t vertex) const {
+		return depth[vertex];
+	}
+
+private:
+	CSRMatrix<BooleanSemiring, ID_T> matrix;
+	vector<uint8_t> visited;
+	vector<int64_t> depth;
+	vector<int64_t> reached;
+	vector<int64_t> frontier;
+	vector<int64_t> next;
+};
+
+} // namespace duckdb
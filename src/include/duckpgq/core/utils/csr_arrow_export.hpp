@@ -0,0 +1,36 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/csr_arrow_export.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+#include "duckdb/common/arrow/arrow.hpp"
+
+namespace duckdb {
+
+//! One array of a CSR that can be exported through the Arrow C data interface
+struct CSRArrowArray {
+	string name;
+	//! Arrow format string of the values
+	const char *format;
+	const void *data;
+	idx_t length;
+};
+
+//! The arrays v, e, edge_ids, w and external_id of [csr] as far as they exist. v holds the vertex count + 1 offsets
+//! of the adjacency lists in e. The delta or the partitions of the CSR are merged first, a CSR with exports that are
+//! still held is never changed in place, see CSR::arrow_exports.
+vector<CSRArrowArray> GetCSRArrowArrays(ClientContext &context, const shared_ptr<CSR> &csr);
+
+//! Exports [array] of [csr] into the ArrowArray and ArrowSchema the consumer allocated, without copying it, like
+//! pyarrow's Array._export_to_c. The consumer owns both structs afterwards and releases them through their release
+//! callbacks. The ArrowArray keeps the CSR alive until it is released, also after the database was closed.
+void ExportCSRArrowArray(const shared_ptr<CSR> &csr, const CSRArrowArray &array, ArrowArray *out_array,
+                         ArrowSchema *out_schema);
+
+} // namespace duckdb
@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/csr_blocks.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+
+namespace duckdb {
+
+//! Blocks never hold fewer edges than this, smaller graphs are not worth splitting by edges
+static constexpr idx_t CSR_BLOCK_MIN_EDGES = 4096;
+
+//! The adjacency lists of the vertices [vertex_begin, vertex_end), or, for a slice of a hub, the part
+//! [offset_begin, offset_end) of the list of the single vertex vertex_begin
+struct CSRBlock {
+	int64_t vertex_begin = 0;
+	int64_t vertex_end = 0;
+	//! -1 unless the block is a slice of a hub
+	int64_t offset_begin = -1;
+	int64_t offset_end = -1;
+
+	bool IsHubSlice() const {
+		return offset_begin >= 0;
+	}
+};
+
+//! A vertex whose adjacency list is split into the blocks [block_begin, block_end)
+struct CSRHub {
+	int64_t vertex;
+	idx_t block_begin;
+	idx_t block_end;
+};
+
+//! Splits the adjacency lists of a CSR into blocks of about [block_edges] edges, the units of work the parallel
+//! kernels hand to the threads. Consecutive vertices share a block until their lists add up to block_edges, so a
+//! thread gets about as many edges as the others however skewed the degrees are. The list of a hub, a vertex with more
+//! than block_edges neighbors, is cut into several slices that different threads can expand, the kernels combine
+//! their results per hub.
+class CSRBlocks {
+public:
+	CSRBlocks(const CSRRanges &ranges, idx_t vertex_count, idx_t block_edges);
+
+	//! Calls [function](vertex, begin, end) for the part [begin, end) of the adjacency list of every vertex of
+	//! [block]
+	template <class FUNC>
+	void ForEachList(const CSRBlock &block, const CSRRanges &ranges, FUNC &&function) const {
+		if (block.IsHubSlice()) {
+			function(block.vertex_begin, block.offset_begin, block.offset_end);
+			return;
+		}
+		for (auto i = block.vertex_begin; i < block.vertex_end; i++) {
+			function(i, ranges.begin[i], ranges.end[i]);
+		}
+	}
+	//! The hub entry of [vertex], nullptr if its list is not split
+	const CSRHub *FindHub(int64_t vertex) const;
+
+	idx_t block_edges;
+	vector<CSRBlock> blocks;
+	//! In vertex order
+	vector<CSRHub> hubs;
+};
+
+//! The block size of the parallel kernels over [edge_count] edges: a few blocks per thread, at least
+//! CSR_BLOCK_MIN_EDGES
+idx_t CSRBlockEdges(ClientContext &context, idx_t edge_count);
+
+} // namespace duckdb
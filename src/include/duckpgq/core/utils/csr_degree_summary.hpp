@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/csr_degree_summary.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+
+namespace duckdb {
+
+//! A mergeable histogram of degrees. Degrees below 128 have a bucket each, larger ones share a bucket with those
+//! that have the same 7 leading bits, so a quantile is at most 1/64 below the exact one whatever the skew, in a few
+//! thousand buckets.
+class DegreeSketch {
+public:
+	DegreeSketch();
+
+	void Add(idx_t degree) {
+		buckets[BucketOf(degree)]++;
+		count++;
+	}
+	void Merge(const DegreeSketch &other);
+	idx_t Count() const {
+		return count;
+	}
+	//! The degree at rank floor((count - 1) * q) in increasing order, the rank quantile_disc takes, rounded down to
+	//! the smallest degree of its bucket
+	idx_t Quantile(double q) const;
+
+private:
+	static idx_t BucketOf(idx_t degree);
+	//! The smallest degree of [bucket]
+	static idx_t LowerBound(idx_t bucket);
+
+	vector<idx_t> buckets;
+	idx_t count = 0;
+};
+
+//! The distribution of the degrees of the vertices with at least one edge in one direction, the degree columns of
+//! summarize_property_graph
+struct CSRDegreeSummary {
+	//! Vertices with at least one edge
+	idx_t vertex_count = 0;
+	idx_t min = 0;
+	idx_t max = 0;
+	double average = 0;
+	idx_t q25 = 0;
+	idx_t q50 = 0;
+	idx_t q75 = 0;
+};
+
+//! Summarizes the out-degrees of [csr] and the in-degrees of its neighbors in one parallel pass over the CSR and one
+//! over its reverse. The neighbors of a CSR over the edges between two vertex tables, [same_vertex_table] false, are
+//! vertices of the other table, which has no reverse CSR; their in-degrees are counted on the calling thread.
+void SummarizeCSRDegrees(ClientContext &context, CSR &csr, bool same_vertex_table, CSRDegreeSummary &out_degrees,
+                         CSRDegreeSummary &in_degrees);
+
+} // namespace duckdb
@@ -0,0 +1,23 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/csr_delta.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+
+namespace duckdb {
+
+//! Brings the directed, unweighted [csr] that was built from [edge_table] up to date with the committed contents of
+//! its tables through CSR::ApplyDelta. The edge table is scanned once for the rowids and key hashes of its rows, the
+//! rows that are new or whose keys changed are looked up in a hash map of the vertex keys rather than joined, and
+//! only the adjacency lists of the vertices they touch are rewritten. Returns false if the CSR has to be rebuilt
+//! instead: the vertex rowids are no longer dense or fewer vertices are left than the CSR was built with, or the
+//! edge table connects two different vertex tables.
+bool RefreshCSRDelta(ClientContext &context, const shared_ptr<PropertyGraphTable> &edge_table, CSR &csr);
+
+} // namespace duckdb
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/csr_distance_index.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+#include "duckpgq/core/utils/memory_reservation.hpp"
+
+namespace duckdb {
+
+//! Number of landmarks of a distance index unless create_distance_index asks for another number
+static constexpr idx_t DISTANCE_INDEX_DEFAULT_LANDMARKS = 16;
+//! Distance of a vertex a landmark does not reach, or that does not reach the landmark
+static constexpr uint32_t DISTANCE_INDEX_UNREACHABLE = NumericLimits<uint32_t>::Maximum();
+
+//! Lower and upper bound of a distance derived from the landmarks, upper is DISTANCE_INDEX_UNREACHABLE if no
+//! landmark lies on a path between the vertices
+struct DistanceBounds {
+	uint32_t lower = 0;
+	uint32_t upper = DISTANCE_INDEX_UNREACHABLE;
+	//! The landmarks prove that there is no path
+	bool unreachable = false;
+};
+
+//! Hop distances between the vertices of a CSR, built by PRAGMA create_distance_index and kept on the CSR until its
+//! edges change. All vertex ids are the internal ids of the CSR.
+//!
+//! The exact part is a pruned landmark labeling: the vertices are ranked by decreasing degree and every vertex gets
+//! an out-label of (rank, distance) pairs for hubs it reaches and an in-label for hubs that reach it, both sorted by
+//! rank. The BFS from the hub of a rank stops at every vertex whose distance the labels of the higher ranks already
+//! answer, so most labels stay short on graphs with hubs. The distance from s to t is the smallest sum over the ranks
+//! in both the out-label of s and the in-label of t. The CSR of a symmetric graph has a single label per vertex.
+//!
+//! The approximate part holds the full distances from and to the highest ranked vertices, the landmarks, which bound
+//! the distance of any pair through the triangle inequality.
+class CSRDistanceIndex {
+public:
+	//! Builds the landmarks of [csr] and, with [exact], the labeling. The BFS over the incoming edges of a directed
+	//! CSR uses its reverse.
+	CSRDistanceIndex(ClientContext &context, CSR &csr, bool exact, idx_t landmark_count);
+
+	bool IsExact() const {
+		return exact;
+	}
+	idx_t VertexCount() const {
+		return vertex_count;
+	}
+	idx_t LandmarkCount() const {
+		return landmarks.size();
+	}
+	//! Number of (rank, distance) pairs in all labels
+	idx_t LabelSize() const {
+		return out_hubs.size() + in_hubs.size();
+	}
+	idx_t GetMemoryUsage() const;
+
+	//! The hop distance from [source] to [target], -1 if there is no path. Only for an exact index, the ids of
+	//! vertices added after the build have no edges in the index.
+	int64_t Distance(int64_t source, int64_t target) const;
+	//! Bounds of the hop distance from [source] to [target] from the landmarks
+	DistanceBounds EstimateDistance(int64_t source, int64_t target) const;
+
+private:
+	template <class ID_T>
+	void BuildLabels(ClientContext &context, CSR &csr, const vector<int64_t> &order);
+	template <class ID_T>
+	void BuildLandmarks(ClientContext &context, CSR &csr);
+
+	//! Whether [vertex] existed when the index was built, the others are isolated
+	bool InGraph(int64_t vertex) const {
+		return vertex >= 0 && static_cast<idx_t>(vertex) < vertex_count;
+	}
+
+	bool exact;
+	bool symmetric;
+	idx_t vertex_count;
+	//! Vertices by decreasing degree, the first ones are the landmarks
+	vector<int64_t> landmarks;
+	//! The labels of vertex i span [offsets[i], offsets[i + 1]) of the hub and distance arrays. A symmetric index
+	//! only fills the out arrays.
+	vector<idx_t> out_offsets;
+	vector<uint32_t> out_hubs;
+	vector<uint32_t> out_distances;
+	vector<idx_t> in_offsets;
+	vector<uint32_t> in_hubs;
+	vector<uint32_t> in_distances;
+	//! Distance of vertex v from landmark l at [l * vertex_count + v], and to it in to_landmark. A symmetric index
+	//! only fills from_landmark.
+	vector<uint32_t> from_landmark;
+	vector<uint32_t> to_landmark;
+	MemoryReservation memory;
+};
+
+//! The path lengths of iterativelength for the first [count] rows from an exact [index], the ids are internal ids at
+//! the positions of the formats. Rows without a path of at most [upper] steps are NULL.
+void IndexedPathLengths(const CSRDistanceIndex &index, idx_t count, const UnifiedVectorFormat &vdata_src,
+                        const int64_t *src_data, const UnifiedVectorFormat &vdata_dst, const int64_t *dst_data,
+                        int64_t upper, int64_t *result_data, ValidityMask &result_validity);
+
+} // namespace duckdb
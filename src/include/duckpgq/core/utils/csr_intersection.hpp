@@ -0,0 +1,21 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/csr_intersection.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+//! Counts the elements of [probe] that also occur in [build]. Both ranges must be sorted ascending, duplicates in
+//! [probe] are counted once per occurrence. Uses a linear merge when the ranges have similar sizes and galloping
+//! search into the larger range otherwise, so the cost is O(min(n, m) * log(max(n, m) / min(n, m))) at worst.
+//! Instantiated for 32-bit and 64-bit vertex ids.
+template <class ID_T>
+idx_t CountSortedIntersection(const ID_T *build, idx_t build_size, const ID_T *probe, idx_t probe_size);
+
+} // namespace duckdb
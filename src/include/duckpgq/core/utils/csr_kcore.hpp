@@ -0,0 +1,29 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/csr_kcore.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+
+namespace duckdb {
+
+//! The core number of every vertex of [csr]: the largest k such that the vertex belongs to a subgraph in which every
+//! vertex has at least k neighbors. The adjacency lists are read as undirected, so the CSR must hold every edge under
+//! both of its endpoints. Self-loops are not counted, parallel edges count once each.
+//!
+//! Vertices are peeled level by level in parallel as in ParK (Dasari et al.): every level k collects the remaining
+//! vertices of degree at most k, and peeling them lowers the degree of their neighbors, which join the level as soon
+//! as it drops to k. Levels without vertices are skipped.
+void KCoreDecomposition(ClientContext &context, CSR &csr, vector<int64_t> &core);
+
+//! A CSR over the vertex ids of [csr] that only keeps the edges between vertices of the [k]-core, i.e. with a core
+//! number of at least [k]. The other vertices keep their ids but lose all their edges. Edge ids, labels, weights and
+//! the vertex relabeling are carried over.
+shared_ptr<CSR> BuildKCoreCSR(ClientContext &context, CSR &csr, const vector<int64_t> &core, int64_t k);
+
+} // namespace duckdb
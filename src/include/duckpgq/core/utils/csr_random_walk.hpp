@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/csr_random_walk.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+#include "duckpgq/core/utils/memory_reservation.hpp"
+
+namespace duckdb {
+
+//! SplitMix64. Every walk gets its own generator, seeded from the walk, so that the walks do not depend on how the
+//! rows are split among the threads.
+class RandomWalkGenerator {
+public:
+	RandomWalkGenerator(uint64_t seed, int64_t source, idx_t walk)
+	    : state(seed ^ (static_cast<uint64_t>(source) * 0xD1B54A32D192ED03ULL) ^
+	            (static_cast<uint64_t>(walk) * 0x8CB92BA72F3D8DD7ULL)) {
+		// The first outputs of nearby states are decorrelated by one mixing round
+		Next();
+	}
+
+	uint64_t Next() {
+		state += 0x9E3779B97F4A7C15ULL;
+		auto z = state;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+	//! Uniform in [0, 1)
+	double_t NextDouble() {
+		return static_cast<double_t>(Next() >> 11) * 0x1.0p-53;
+	}
+	//! Uniform in [0, count)
+	idx_t NextIndex(idx_t count) {
+		return Next() % count;
+	}
+
+private:
+	uint64_t state;
+};
+
+//! Walker's alias tables (Vose's method) over the weights of every adjacency list of a weighted CSR, so that a
+//! neighbor is drawn in constant time with a probability proportional to the weight of its edge. Entry [offset] of
+//! the list of a vertex is kept with probability probability[offset], otherwise entry alias[offset] of the same list
+//! is taken.
+struct CSRAliasTables {
+	CSRAliasTables(ClientContext &context, CSR &csr);
+
+	vector<double_t> probability;
+	//! Index within the adjacency list
+	vector<uint32_t> alias;
+	MemoryReservation memory;
+};
+
+//! The parameters of the walks of random_walks
+struct RandomWalkParameters {
+	//! Number of vertices of a walk, including its start
+	idx_t length;
+	//! node2vec return parameter, the walk goes back to the previous vertex with a weight of 1 / p
+	double_t p;
+	//! node2vec in-out parameter, the walk moves to a vertex that is not a neighbor of the previous one with a weight
+	//! of 1 / q
+	double_t q;
+
+	//! Whether the next step depends on the previous vertex
+	bool SecondOrder() const {
+		return p != 1 || q != 1;
+	}
+};
+
+//! Writes a random walk from [source] over [csr] to [walk], which has room for parameters.length vertices, and
+//! returns the number of vertices written. The walk stops early at a vertex without outgoing edges. Steps follow the
+//! weights of [alias_tables] if not nullptr, uniformly otherwise, biased by the node2vec parameters. Biased steps are
+//! drawn by rejection sampling against the largest bias, which saves the alias tables per pair of vertices.
+idx_t RandomWalk(CSR &csr, const CSRAliasTables *alias_tables, const RandomWalkParameters &parameters,
+                 int64_t source, RandomWalkGenerator &random, int64_t *walk);
+
+} // namespace duckdb
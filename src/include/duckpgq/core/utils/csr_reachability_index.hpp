@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/csr_reachability_index.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+#include "duckpgq/core/utils/memory_reservation.hpp"
+
+namespace duckdb {
+
+//! Number of randomized traversals, and intervals per component, of a reachability index
+static constexpr idx_t REACHABILITY_INDEX_TRAVERSALS = 3;
+
+//! The arrays of the searches of CSRReachabilityIndex::Reachable, reused by the queries of a thread
+struct ReachabilitySearch {
+	//! A component is visited by the current search if its entry equals epoch
+	vector<uint32_t> visited;
+	uint32_t epoch = 0;
+	vector<uint32_t> stack;
+};
+
+//! Reachability between the vertices of a CSR, built by PRAGMA create_reachability_index and kept on the CSR until its
+//! edges change. All vertex ids are the internal ids of the CSR.
+//!
+//! The strongly connected components are condensed into a DAG, numbered so that every edge of the DAG goes from a
+//! higher to a lower component id. Every component gets one GRAIL interval [low, post] per randomized DFS over the
+//! DAG, post being its post-order rank and low the smallest rank below it. A component reaches another only if each
+//! of its intervals contains the interval of the other, so most pairs without a path are answered by the labels. The
+//! remaining pairs are decided by a search over the DAG that skips every component whose intervals do not contain
+//! the target.
+class CSRReachabilityIndex {
+public:
+	CSRReachabilityIndex(ClientContext &context, CSR &csr);
+
+	idx_t VertexCount() const {
+		return component.size();
+	}
+	idx_t ComponentCount() const {
+		return dag_offsets.empty() ? 0 : dag_offsets.size() - 1;
+	}
+	idx_t GetMemoryUsage() const;
+
+	//! Whether there is a path from [source] to [target], every vertex reaches itself. The ids of vertices added
+	//! after the build have no edges in the index.
+	bool Reachable(int64_t source, int64_t target, ReachabilitySearch &search) const;
+
+private:
+	template <class ID_T>
+	void BuildComponents(CSR &csr);
+	template <class ID_T>
+	void BuildDAG(CSR &csr);
+	void BuildIntervals();
+
+	//! Whether the intervals of [ancestor] contain those of [descendant] in every traversal
+	bool Contains(uint32_t ancestor, uint32_t descendant) const {
+		auto a = ancestor * REACHABILITY_INDEX_TRAVERSALS;
+		auto d = descendant * REACHABILITY_INDEX_TRAVERSALS;
+		for (idx_t i = 0; i < REACHABILITY_INDEX_TRAVERSALS; i++) {
+			if (low[a + i] > low[d + i] || post[d + i] > post[a + i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//! The component of every vertex
+	vector<uint32_t> component;
+	//! The successors of component c in the DAG span [dag_offsets[c], dag_offsets[c + 1]) of dag_edges
+	vector<idx_t> dag_offsets;
+	vector<uint32_t> dag_edges;
+	//! The interval of component c in traversal i at [c * REACHABILITY_INDEX_TRAVERSALS + i]
+	vector<uint32_t> low;
+	vector<uint32_t> post;
+	MemoryReservation memory;
+};
+
+} // namespace duckdb
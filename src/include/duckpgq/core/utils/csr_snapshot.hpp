@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/csr_snapshot.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+
+namespace duckdb {
+
+#define CSR_SNAPSHOT_VERSION 2
+
+//! Row counts and content hashes of the tables a CSR was built from. A snapshot is only loaded when the
+//! fingerprint stored in the file matches the current state of the tables.
+struct CSRSnapshotFingerprint {
+	//! The source vertex table
+	int64_t vertex_rows = 0;
+	uint64_t vertex_hash = 0;
+	int64_t destination_rows = 0;
+	uint64_t destination_hash = 0;
+	int64_t edge_rows = 0;
+	uint64_t edge_hash = 0;
+
+	bool operator==(const CSRSnapshotFingerprint &other) const {
+		return vertex_rows == other.vertex_rows && vertex_hash == other.vertex_hash &&
+		       destination_rows == other.destination_rows && destination_hash == other.destination_hash &&
+		       edge_rows == other.edge_rows && edge_hash == other.edge_hash;
+	}
+
+	static CSRSnapshotFingerprint Compute(ClientContext &context, const shared_ptr<PropertyGraphTable> &edge_table);
+};
+
+//! Writes the CSR to [path] in a versioned binary format:
+//! header | v (vsize x int64) | e (esize x int64) | edge_ids (esize x int64) | w or w_double (optional)
+void WriteCSRSnapshot(ClientContext &context, const CSR &csr, const string &path,
+                      const CSRSnapshotFingerprint &fingerprint);
+//! Reads a CSR written by WriteCSRSnapshot, throws if the file is corrupt or was built from different data
+shared_ptr<CSR> ReadCSRSnapshot(ClientContext &context, const string &path,
+                                const CSRSnapshotFingerprint &expected_fingerprint);
+
+} // namespace duckdb
@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/csr_temporal_index.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+#include "duckpgq/core/utils/memory_reservation.hpp"
+
+namespace duckdb {
+
+//! The validity intervals of the edges of a CSR, built by PRAGMA create_temporal_index and kept on the CSR until its
+//! edges change. The traversals as of any point in time share the one CSR instead of building a CSR per snapshot.
+//!
+//! The intervals are stored by offset of the neighbor array, next to the adjacency entries, so a traversal tests the
+//! entries of a list in order without looking up their edge rowids. An edge is valid at t if valid_from <= t <
+//! valid_to, and a NULL bound leaves its side of the interval open. Timestamps and dates are stored as microseconds
+//! since the epoch, integers as they are.
+class CSRTemporalIndex {
+public:
+	//! [from] and [to] hold the bounds of every edge by rowid. Edges of [csr] past their end are never valid.
+	CSRTemporalIndex(ClientContext &context, const CSR &csr, const vector<int64_t> &from, const vector<int64_t> &to,
+	                 bool timestamps);
+
+	//! Whether the bounds are timestamps, which the as-of arguments are compared to as TIMESTAMP, or integers
+	bool IsTimestamp() const {
+		return timestamps;
+	}
+	idx_t EdgeCount() const {
+		return valid_from.size();
+	}
+	idx_t GetMemoryUsage() const;
+
+	//! Whether the adjacency entry at [offset] is valid at [as_of], without branches so that the tests of the entries
+	//! of a list vectorize
+	bool Valid(int64_t offset, int64_t as_of) const {
+		return (valid_from[offset] <= as_of) & (as_of < valid_to[offset]);
+	}
+
+private:
+	bool timestamps;
+	vector<int64_t> valid_from;
+	vector<int64_t> valid_to;
+	MemoryReservation memory;
+};
+
+} // namespace duckdb
@@ -0,0 +1,25 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/csr_triangles.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+
+namespace duckdb {
+
+//! Number of distinct neighbors of every vertex of the undirected [csr], self loops excluded
+void CountSimpleDegrees(ClientContext &context, CSR &csr, vector<int64_t> &degrees);
+
+//! Counts the triangles of the undirected [csr] on the TaskScheduler threads, every triangle once. Edges are oriented
+//! from the endpoint with the smaller degree to the one with the larger degree, ties broken by vertex id, so every
+//! triangle is found exactly once by intersecting the oriented lists of its two lower endpoints and no oriented list
+//! has more than O(sqrt(E)) entries. With [vertex_triangles] the triangles through every vertex are counted as well.
+//! Self loops and parallel edges are ignored.
+idx_t CountTriangles(ClientContext &context, CSR &csr, vector<int64_t> *vertex_triangles = nullptr);
+
+} // namespace duckdb
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/duckpgq_parallel.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+
+namespace duckdb {
+
+//! Splits [0, count) into ranges of [morsel_size] and runs [function] on every range using the threads of DuckDB's
+//! TaskScheduler. The calling thread participates and the call returns once all ranges are done. Exceptions thrown
+//! by [function] are rethrown in the calling thread.
+void ParallelFor(ClientContext &context, idx_t count, idx_t morsel_size,
+                 const std::function<void(idx_t begin, idx_t end)> &function);
+
+struct ParallelOncePass;
+
+//! Computes a result once for all threads of a query that need it, e.g. the value of every vertex that a scalar
+//! function answers its rows from. The first thread to call Run computes, the threads that call Run in the meantime
+//! do not block on a lock: they take morsels of the ParallelFor passes of the computation until it is done.
+class ParallelOnce {
+public:
+	//! Runs [compute] unless it ran already and returns once it is done. An exception thrown by [compute] is rethrown
+	//! by every call of Run.
+	void Run(const std::function<void()> &compute);
+	//! Whether the computation is done, its results are then visible to the calling thread
+	bool IsDone() const {
+		return done.load(std::memory_order_acquire);
+	}
+	//! Marks the computation as done without running it, for a copy of the function data that holds its results
+	void MarkDone() {
+		done.store(true, std::memory_order_release);
+	}
+
+private:
+	friend void ParallelFor(ClientContext &context, idx_t count, idx_t morsel_size,
+	                        const std::function<void(idx_t begin, idx_t end)> &function);
+	//! Runs a ParallelFor of the computation on the TaskScheduler and on the threads waiting in Run
+	void RunPass(ClientContext &context, idx_t count, idx_t morsel_size,
+	             const std::function<void(idx_t begin, idx_t end)> &function);
+
+	mutex lock;
+	//! Signaled when a pass starts, when a waiting thread leaves a pass and when the computation is done
+	std::condition_variable changed;
+	std::atomic<bool> done {false};
+	bool started = false;
+	std::exception_ptr error;
+	//! The running pass of the computation, if any
+	ParallelOncePass *pass = nullptr;
+};
+
+} // namespace duckdb
@@ -12,10 +12,20 @@ CreatePropertyGraphInfo *GetPropertyGraphInfo(const shared_ptr<DuckPGQState> &du
 shared_ptr<PropertyGraphTable> ValidateSourceNodeAndEdgeTable(CreatePropertyGraphInfo *pg_info,
                                                               const std::string &node_table,
                                                               const std::string &edge_table);
+//! [extra_arguments] are passed to [function_name] as constants after the CSR id and the rowid
 unique_ptr<SelectNode> CreateSelectNode(const shared_ptr<PropertyGraphTable> &edge_pg_entry,
-                                        const string &function_name, const string &function_alias);
+                                        const string &function_name, const string &function_alias,
+                                        const vector<Value> &extra_arguments = vector<Value>());
 unique_ptr<BaseTableRef> CreateBaseTableRef(const string &table_name, const string &alias = "");
 unique_ptr<ColumnRefExpression> CreateColumnRefExpression(const string &column_name, const string &table_name = "",
                                                           const string &alias = "");
+//! Sets the [count] rows of the LIST(LIST(BIGINT)) vector [result] to lists of [list_size] ids each. Row i holds the
+//! ids between row_offsets[i] and row_offsets[i + 1] of [ids].
+void SetNestedListResult(Vector &result, idx_t count, const vector<int64_t> &ids, idx_t list_size,
+                         const vector<idx_t> &row_offsets);
+//! Same for lists of different sizes, list j holds the ids between list_offsets[j] and list_offsets[j + 1] of [ids]
+//! and row i the lists between row_offsets[i] and row_offsets[i + 1]
+void SetNestedListResult(Vector &result, idx_t count, const vector<int64_t> &ids, const vector<idx_t> &list_offsets,
+                         const vector<idx_t> &row_offsets);
 
 } // namespace duckdb
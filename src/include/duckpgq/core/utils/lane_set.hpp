@@ -0,0 +1,361 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/lane_set.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/duckpgq_utils.hpp"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace duckdb {
+
+//! The operations of LaneBitset on a register of WORDS consecutive words, specialized for the vector instructions the
+//! extension is built for. Every 64-bit build has the 128-bit registers of SSE2 or NEON, the 256 and 512-bit ones
+//! are used by builds for AVX2 and AVX-512. Other builds use LaneChunk<1>, a single word.
+template <idx_t WORDS>
+struct LaneChunk;
+
+template <>
+struct LaneChunk<1> {
+	static constexpr idx_t WORDS = 1;
+	using register_t = uint64_t;
+	static register_t Load(const uint64_t *words) {
+		return *words;
+	}
+	static void Store(uint64_t *words, register_t value) {
+		*words = value;
+	}
+	static register_t Or(register_t a, register_t b) {
+		return a | b;
+	}
+	//! a & ~b
+	static register_t AndNot(register_t a, register_t b) {
+		return a & ~b;
+	}
+	static bool Any(register_t value) {
+		return value != 0;
+	}
+};
+
+#if defined(__SSE2__) || defined(_M_X64)
+template <>
+struct LaneChunk<2> {
+	static constexpr idx_t WORDS = 2;
+	using register_t = __m128i;
+	static register_t Load(const uint64_t *words) {
+		return _mm_loadu_si128(reinterpret_cast<const __m128i *>(words));
+	}
+	static void Store(uint64_t *words, register_t value) {
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(words), value);
+	}
+	static register_t Or(register_t a, register_t b) {
+		return _mm_or_si128(a, b);
+	}
+	static register_t AndNot(register_t a, register_t b) {
+		return _mm_andnot_si128(b, a);
+	}
+	static bool Any(register_t value) {
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(value, _mm_setzero_si128())) != 0xFFFF;
+	}
+};
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+template <>
+struct LaneChunk<2> {
+	static constexpr idx_t WORDS = 2;
+	using register_t = uint64x2_t;
+	static register_t Load(const uint64_t *words) {
+		return vld1q_u64(words);
+	}
+	static void Store(uint64_t *words, register_t value) {
+		vst1q_u64(words, value);
+	}
+	static register_t Or(register_t a, register_t b) {
+		return vorrq_u64(a, b);
+	}
+	static register_t AndNot(register_t a, register_t b) {
+		return vbicq_u64(a, b);
+	}
+	static bool Any(register_t value) {
+		return (vgetq_lane_u64(value, 0) | vgetq_lane_u64(value, 1)) != 0;
+	}
+};
+#endif
+
+#if defined(__AVX2__)
+template <>
+struct LaneChunk<4> {
+	static constexpr idx_t WORDS = 4;
+	using register_t = __m256i;
+	static register_t Load(const uint64_t *words) {
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words));
+	}
+	static void Store(uint64_t *words, register_t value) {
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(words), value);
+	}
+	static register_t Or(register_t a, register_t b) {
+		return _mm256_or_si256(a, b);
+	}
+	static register_t AndNot(register_t a, register_t b) {
+		return _mm256_andnot_si256(b, a);
+	}
+	static bool Any(register_t value) {
+		return !_mm256_testz_si256(value, value);
+	}
+};
+#endif
+
+#if defined(__AVX512F__)
+template <>
+struct LaneChunk<8> {
+	static constexpr idx_t WORDS = 8;
+	using register_t = __m512i;
+	static register_t Load(const uint64_t *words) {
+		return _mm512_loadu_si512(words);
+	}
+	static void Store(uint64_t *words, register_t value) {
+		_mm512_storeu_si512(words, value);
+	}
+	static register_t Or(register_t a, register_t b) {
+		return _mm512_or_si512(a, b);
+	}
+	static register_t AndNot(register_t a, register_t b) {
+		// (a | b) ^ b, as _mm512_andnot_si512 trips -Wmaybe-uninitialized on GCC 12
+		return _mm512_xor_si512(_mm512_or_si512(a, b), b);
+	}
+	static bool Any(register_t value) {
+		return _mm512_test_epi64_mask(value, value) != 0;
+	}
+};
+#endif
+
+//! The widest LaneChunk of the build
+#if defined(__AVX512F__)
+static constexpr idx_t LANE_CHUNK_WORDS = 8;
+#elif defined(__AVX2__)
+static constexpr idx_t LANE_CHUNK_WORDS = 4;
+#elif defined(__SSE2__) || defined(_M_X64) || defined(__ARM_NEON) || defined(_M_ARM64)
+static constexpr idx_t LANE_CHUNK_WORDS = 2;
+#else
+static constexpr idx_t LANE_CHUNK_WORDS = 1;
+#endif
+
+//! LaneBitset<LANES>::UpdateFrontier over the vertices [begin, end) of two arrays of lane sets of [word_count]
+//! words each, appending the vertices that have a lane left in [next] to [reached]
+typedef void (*lane_update_frontier_range_t)(uint64_t *next, uint64_t *seen, idx_t word_count, idx_t begin,
+                                             idx_t end, vector<int64_t> &reached);
+
+//! The UpdateFrontierRange for vector instructions the CPU has but the extension is not built for: AVX-512 or AVX2
+//! on an x86-64 build that targets neither, chosen once by the features the CPU reports. nullptr if the LaneChunk of
+//! the build is as wide.
+lane_update_frontier_range_t GetLaneUpdateFrontierRange();
+
+//! One bit per concurrent search of a multi-source BFS. Drop-in replacement for std::bitset<LANES> stored as a
+//! plain array of words, processed a LaneChunk at a time with the vector instructions of the build. Also offers the
+//! fused operations the BFS kernels are made of.
+template <idx_t LANES>
+class LaneBitset {
+public:
+	static_assert(LANES % 64 == 0 && LANES <= LANE_LIMIT, "lane count must be a multiple of 64 up to LANE_LIMIT");
+	static constexpr idx_t LANE_COUNT = LANES;
+	static constexpr idx_t WORD_COUNT = LANES / 64;
+	using Chunk = LaneChunk<(WORD_COUNT < LANE_CHUNK_WORDS ? WORD_COUNT : LANE_CHUNK_WORDS)>;
+
+	class reference {
+	public:
+		reference(uint64_t &word, uint64_t mask) : word(word), mask(mask) {
+		}
+		operator bool() const {
+			return (word & mask) != 0;
+		}
+		reference &operator=(bool value) {
+			word = value ? (word | mask) : (word & ~mask);
+			return *this;
+		}
+
+	private:
+		uint64_t &word;
+		uint64_t mask;
+	};
+
+	LaneBitset() : words() {
+	}
+	//! Sets the lanes of the first word, LaneBitset(0) is the empty set
+	LaneBitset(uint64_t value) : words() { // NOLINT: allow implicit conversion like std::bitset
+		words[0] = value;
+	}
+
+	bool operator[](idx_t lane) const {
+		return test(lane);
+	}
+	reference operator[](idx_t lane) {
+		return reference(words[lane / 64], uint64_t(1) << (lane % 64));
+	}
+	bool test(idx_t lane) const {
+		return (words[lane / 64] >> (lane % 64)) & 1;
+	}
+	void set(idx_t lane) {
+		words[lane / 64] |= uint64_t(1) << (lane % 64);
+	}
+	void reset() {
+		for (idx_t i = 0; i < WORD_COUNT; i++) {
+			words[i] = 0;
+		}
+	}
+	bool any() const {
+		auto result = Chunk::Load(words);
+		for (idx_t i = Chunk::WORDS; i < WORD_COUNT; i += Chunk::WORDS) {
+			result = Chunk::Or(result, Chunk::Load(words + i));
+		}
+		return Chunk::Any(result);
+	}
+	bool none() const {
+		return !any();
+	}
+	idx_t count() const {
+		idx_t result = 0;
+		for (idx_t i = 0; i < WORD_COUNT; i++) {
+			result += PopCount(words[i]);
+		}
+		return result;
+	}
+
+	LaneBitset &operator|=(const LaneBitset &other) {
+		for (idx_t i = 0; i < WORD_COUNT; i += Chunk::WORDS) {
+			Chunk::Store(words + i, Chunk::Or(Chunk::Load(words + i), Chunk::Load(other.words + i)));
+		}
+		return *this;
+	}
+	LaneBitset &operator&=(const LaneBitset &other) {
+		for (idx_t i = 0; i < WORD_COUNT; i++) {
+			words[i] &= other.words[i];
+		}
+		return *this;
+	}
+	LaneBitset operator|(const LaneBitset &other) const {
+		LaneBitset result(*this);
+		result |= other;
+		return result;
+	}
+	LaneBitset operator&(const LaneBitset &other) const {
+		LaneBitset result(*this);
+		result &= other;
+		return result;
+	}
+	LaneBitset operator~() const {
+		LaneBitset result;
+		for (idx_t i = 0; i < WORD_COUNT; i++) {
+			result.words[i] = ~words[i];
+		}
+		return result;
+	}
+	bool operator==(const LaneBitset &other) const {
+		uint64_t difference = 0;
+		for (idx_t i = 0; i < WORD_COUNT; i++) {
+			difference |= words[i] ^ other.words[i];
+		}
+		return difference == 0;
+	}
+	bool operator!=(const LaneBitset &other) const {
+		return !(*this == other);
+	}
+
+	//! this &= ~other
+	void AndNot(const LaneBitset &other) {
+		for (idx_t i = 0; i < WORD_COUNT; i += Chunk::WORDS) {
+			Chunk::Store(words + i, Chunk::AndNot(Chunk::Load(words + i), Chunk::Load(other.words + i)));
+		}
+	}
+	//! The fused frontier update of a BFS step: next &= ~seen, seen |= next. Returns whether next has any lane set.
+	static bool UpdateFrontier(LaneBitset &next, LaneBitset &seen) {
+		auto fresh = Chunk::AndNot(Chunk::Load(next.words), Chunk::Load(seen.words));
+		Chunk::Store(next.words, fresh);
+		Chunk::Store(seen.words, Chunk::Or(Chunk::Load(seen.words), fresh));
+		auto result = fresh;
+		for (idx_t i = Chunk::WORDS; i < WORD_COUNT; i += Chunk::WORDS) {
+			fresh = Chunk::AndNot(Chunk::Load(next.words + i), Chunk::Load(seen.words + i));
+			Chunk::Store(next.words + i, fresh);
+			Chunk::Store(seen.words + i, Chunk::Or(Chunk::Load(seen.words + i), fresh));
+			result = Chunk::Or(result, fresh);
+		}
+		return Chunk::Any(result);
+	}
+	//! UpdateFrontier of the vertices [begin, end), appending the ones that have a lane left in [next] to [reached].
+	//! The dense sweep of a BFS step, run with the widest vector instructions of the CPU.
+	static void UpdateFrontierRange(vector<LaneBitset> &next, vector<LaneBitset> &seen, idx_t begin, idx_t end,
+	                                vector<int64_t> &reached) {
+		static_assert(sizeof(LaneBitset) == WORD_COUNT * sizeof(uint64_t), "lane sets are stored as their words");
+		auto kernel = GetLaneUpdateFrontierRange();
+		if (kernel && begin < end) {
+			kernel(next[0].words, seen[0].words, WORD_COUNT, begin, end, reached);
+			return;
+		}
+		for (auto i = begin; i < end; i++) {
+			if (UpdateFrontier(next[i], seen[i])) {
+				reached.push_back(static_cast<int64_t>(i));
+			}
+		}
+	}
+	//! Calls [function] with the index of every lane that is set, in increasing order
+	template <class F>
+	void ForEach(F &&function) const {
+		for (idx_t i = 0; i < WORD_COUNT; i++) {
+			auto word = words[i];
+			while (word) {
+				function(i * 64 + TrailingZeros(word));
+				word &= word - 1;
+			}
+		}
+	}
+
+private:
+	static idx_t PopCount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<idx_t>(__builtin_popcountll(word));
+#else
+		idx_t result = 0;
+		for (; word; word &= word - 1) {
+			result++;
+		}
+		return result;
+#endif
+	}
+	static idx_t TrailingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<idx_t>(__builtin_ctzll(word));
+#else
+		idx_t result = 0;
+		for (; !(word & 1); word >>= 1) {
+			result++;
+		}
+		return result;
+#endif
+	}
+
+	uint64_t words[WORD_COUNT];
+};
+
+//! The widest lane set, used by the searches that always run LANE_LIMIT lanes
+using LaneSet = LaneBitset<LANE_LIMIT>;
+
+//! The narrowest lane count out of 64, 128, 256 and LANE_LIMIT that runs [searches] concurrent searches at once. The
+//! per-vertex BFS state is sized by it, so small batches do not pay for the full LANE_LIMIT lanes.
+inline idx_t SelectLaneCount(idx_t searches) {
+	idx_t lanes = 64;
+	while (lanes < LANE_LIMIT && lanes < searches) {
+		lanes *= 2;
+	}
+	return lanes;
+}
+
+} // namespace duckdb
@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/memory_reservation.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+
+namespace duckdb {
+
+class BufferManager;
+class DatabaseInstance;
+
+//! Memory of a CSR or a path-finding kernel that is allocated outside the buffer pool, registered with the
+//! BufferManager so that it counts against memory_limit. A reservation that does not fit first makes the buffer pool
+//! evict its blocks, then drops the cached CSRs of the connection, and finally throws an OutOfMemoryException. The
+//! memory is released when the reservation is destroyed. A reservation that outlives its database, e.g. of a CSR
+//! whose arrays a consumer still holds through Arrow, releases nothing.
+class MemoryReservation {
+public:
+	MemoryReservation() = default;
+	~MemoryReservation();
+	MemoryReservation(const MemoryReservation &) = delete;
+	MemoryReservation &operator=(const MemoryReservation &) = delete;
+
+	//! Grows or shrinks the reservation to [new_size] bytes, reserve before allocating
+	void Resize(ClientContext &context, idx_t new_size);
+	//! Shrinks the reservation to [new_size] bytes if it is larger, for callers without a ClientContext
+	void Shrink(idx_t new_size);
+	idx_t GetSize() const {
+		return size;
+	}
+
+private:
+	optional_ptr<BufferManager> buffer_manager;
+	//! The database that owns buffer_manager
+	weak_ptr<DatabaseInstance> database;
+	idx_t size = 0;
+	mutex lock;
+};
+
+} // namespace duckdb
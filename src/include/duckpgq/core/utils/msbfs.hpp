@@ -0,0 +1,228 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/msbfs.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/bfs_direction.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+#include "duckpgq/core/utils/duckpgq_utils.hpp"
+#include "duckpgq/core/utils/lane_set.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace duckdb {
+
+//! Tracks the vertices that have a lane set in the two alternating frontier vectors of a multi-source BFS, so that
+//! steps over a small frontier only touch the vertices in it instead of sweeping all v_size entries
+class MSBFSFrontierList {
+public:
+	//! A frontier with fewer than v_size / SPARSE_DIVISOR vertices is processed from the list
+	static constexpr idx_t SPARSE_DIVISOR = 64;
+
+	//! Starts a new batch of searches whose sources are set in [visit], returns the initial frontier
+	template <idx_t LANES>
+	BFSFrontier Initialize(int64_t v_size, const CSRRanges &ranges, const vector<LaneBitset<LANES>> &visit) {
+		BFSFrontier frontier;
+		Reset();
+		SetVisitedLimit(v_size);
+		for (int64_t i = 0; i < v_size; i++) {
+			if (visit[i].any()) {
+				current.push_back(i);
+				frontier.vertex_count++;
+				frontier.edge_count += ranges.end[i] - ranges.begin[i];
+			}
+		}
+		AddVisited(current);
+		return frontier;
+	}
+	//! Starts a new batch of searches from [sources] without sweeping the visit vector. Requires the vector the first
+	//! step writes into to be zeroed, as the arrays handed out by MSBFSScratchBuffers are.
+	BFSFrontier Initialize(int64_t v_size, const CSRRanges &ranges, const vector<int64_t> &sources);
+	//! Whether the current frontier is small enough to be processed from the list
+	bool IsSparse(int64_t v_size) const {
+		return current.size() * SPARSE_DIVISOR < static_cast<idx_t>(v_size);
+	}
+	//! Zeroes the vector the next step writes into
+	template <idx_t LANES>
+	void ClearNext(int64_t v_size, vector<LaneBitset<LANES>> &next) {
+		if (!stale_valid || stale.size() * SPARSE_DIVISOR >= static_cast<idx_t>(v_size)) {
+			for (int64_t i = 0; i < v_size; i++) {
+				next[i] = 0;
+			}
+			return;
+		}
+		for (auto i : stale) {
+			next[i] = 0;
+		}
+	}
+	//! The vertices of the current frontier
+	const vector<int64_t> &Current() const {
+		return current;
+	}
+	//! Records a vertex of the frontier produced by the running step
+	void AddNext(int64_t vertex) {
+		upcoming.push_back(vertex);
+	}
+	//! Records several vertices of the frontier produced by the running step
+	void AddNext(const vector<int64_t> &vertices) {
+		upcoming.insert(upcoming.end(), vertices.begin(), vertices.end());
+	}
+	//! Finishes a step, the frontier it produced becomes the current one
+	void Advance();
+	//! Adds the sources of searches started between two steps to the current frontier and to [frontier]
+	void Extend(const CSRRanges &ranges, const vector<int64_t> &vertices, BFSFrontier &frontier);
+
+	//! The vertices that entered a frontier since the last ClearVisited, a superset of the vertices whose lanes the
+	//! searches set. Only tracked up to v_size / SPARSE_DIVISOR vertices, VisitedAll is set beyond.
+	const vector<int64_t> &Visited() const {
+		return visited;
+	}
+	bool VisitedAll() const {
+		return visited_all;
+	}
+	void ClearVisited() {
+		visited.clear();
+		visited_all = false;
+	}
+
+	//! Scratch space for the vertices touched by a sparse step
+	vector<int64_t> touched;
+
+private:
+	void Reset();
+	void SetVisitedLimit(int64_t v_size) {
+		visited_limit = static_cast<idx_t>(v_size) / SPARSE_DIVISOR;
+	}
+	//! Records the vertices from [begin] on
+	void AddVisited(const vector<int64_t> &vertices, idx_t begin = 0);
+
+	vector<int64_t> current;
+	vector<int64_t> upcoming;
+	//! Superset of the vertices with a lane set in the vector the next step writes into
+	vector<int64_t> stale;
+	bool stale_valid = false;
+	vector<int64_t> visited;
+	bool visited_all = false;
+	idx_t visited_limit = 0;
+};
+
+//! The rows of a chunk grouped by source vertex, so that a single BFS lane answers all rows that share a source
+struct MSBFSSourceGroups {
+	//! Groups the rows in [0, count) that have a valid source, in the order in which the sources first appear
+	void Initialize(idx_t count, const SelectionVector &sel, const ValidityMask &validity, const int64_t *src_data);
+	idx_t GroupCount() const {
+		return sources.size();
+	}
+
+	//! Source vertex of every group
+	vector<int64_t> sources;
+	//! Group g holds the rows rows[offsets[g]] up to rows[offsets[g + 1]]
+	vector<idx_t> offsets;
+	vector<idx_t> rows;
+};
+
+//! BFS depth of the vertices a lane has not reached
+static constexpr uint32_t MSBFS_UNREACHED = std::numeric_limits<uint32_t>::max();
+
+//! The lane width independent part of MSBFSScratchBuffers
+class MSBFSScratchBase {
+public:
+	virtual ~MSBFSScratchBase() = default;
+};
+
+//! The arrays of the multi-source BFS batches with LANES lanes of one thread. They are allocated once and counted
+//! against memory_limit for as long as the query runs, and every batch only clears the entries its predecessor set.
+template <idx_t LANES>
+class MSBFSScratchBuffers : public MSBFSScratchBase {
+public:
+	//! Readies the arrays for a batch over [v_size] vertices: no lane set in seen, visit1 and visit2 and, with
+	//! [track_depth], every depth at MSBFS_UNREACHED. Only the vertices frontier_list visited are reset, or all of
+	//! them after a batch that visited too many vertices or called TouchAll. Returns the number of bytes allocated,
+	//! 0 if the arrays of the previous batch were reused.
+	idx_t Prepare(ClientContext &context, int64_t v_size, bool track_depth) {
+		auto vertex_count = static_cast<idx_t>(v_size);
+		idx_t allocated = 0;
+		if (seen.size() != vertex_count || (track_depth && depth.size() != vertex_count * LANES)) {
+			allocated =
+			    vertex_count * (3 * sizeof(LaneBitset<LANES>) + (track_depth ? LANES * sizeof(uint32_t) : 0));
+			memory.Resize(context, allocated);
+			seen.assign(vertex_count, LaneBitset<LANES>());
+			visit1.assign(vertex_count, LaneBitset<LANES>());
+			visit2.assign(vertex_count, LaneBitset<LANES>());
+			depth.assign(track_depth ? vertex_count * LANES : 0, MSBFS_UNREACHED);
+		} else if (all_touched || frontier_list.VisitedAll()) {
+			std::fill(seen.begin(), seen.end(), LaneBitset<LANES>());
+			std::fill(visit1.begin(), visit1.end(), LaneBitset<LANES>());
+			std::fill(visit2.begin(), visit2.end(), LaneBitset<LANES>());
+			std::fill(depth.begin(), depth.end(), MSBFS_UNREACHED);
+		} else {
+			for (auto i : frontier_list.Visited()) {
+				seen[i] = 0;
+				visit1[i] = 0;
+				visit2[i] = 0;
+				if (!depth.empty()) {
+					std::fill(depth.begin() + i * LANES, depth.begin() + (i + 1) * LANES, MSBFS_UNREACHED);
+				}
+			}
+		}
+		frontier_list.ClearVisited();
+		all_touched = false;
+		return allocated;
+	}
+	//! For searches that do not go through frontier_list, the next Prepare resets all vertices
+	void TouchAll() {
+		all_touched = true;
+	}
+
+	vector<LaneBitset<LANES>> seen;
+	vector<LaneBitset<LANES>> visit1;
+	vector<LaneBitset<LANES>> visit2;
+	//! BFS depth of vertex i in lane l at depth[i * LANES + l]
+	vector<uint32_t> depth;
+	MSBFSFrontierList frontier_list;
+
+private:
+	MemoryReservation memory;
+	bool all_touched = false;
+};
+
+//! The BFS arrays of one thread for every lane width, held by PathFunctionLocalState so that they are reused by all
+//! chunks and batches of a query instead of being allocated for each of them
+class MSBFSScratch {
+public:
+	template <idx_t LANES>
+	MSBFSScratchBuffers<LANES> &Get() {
+		auto &entry = buffers[LANES / 64 - 1];
+		if (!entry) {
+			entry = make_uniq<MSBFSScratchBuffers<LANES>>();
+		}
+		return static_cast<MSBFSScratchBuffers<LANES> &>(*entry);
+	}
+
+private:
+	unique_ptr<MSBFSScratchBase> buffers[LANE_LIMIT / 64];
+};
+
+//! Dense steps over at least this many vertices per partition are split across the TaskScheduler threads
+static constexpr idx_t MSBFS_PARALLEL_MIN_PARTITION = 32768;
+
+//! One BFS step over [csr] in the direction chosen by [policy] for [frontier], which is updated to the new frontier.
+//! Top-down steps push [visit] along the outgoing edges, bottom-up steps let every vertex pull [visit] from its
+//! incoming edges until all of its unseen [active] lanes are reached. Either way [next] receives the vertices seen
+//! for the first time, which are then added to [seen]. The reverse CSR is built the first time a bottom-up step is
+//! taken. Dense steps on large graphs run on vertex partitions in parallel and give the same result. The adjacency
+//! lists are read through the delta of [csr] if it has one. Steps over a partitioned CSR are always top-down and
+//! pin the partitions that hold the frontier. Returns whether any lane reached a new vertex.
+//! Instantiated for 64, 128, 256 and LANE_LIMIT lanes.
+template <idx_t LANES>
+bool MSBFSStep(ClientContext &context, CSR &csr, BFSDirectionPolicy &policy, int64_t v_size,
+               const LaneBitset<LANES> &active, vector<LaneBitset<LANES>> &seen, const vector<LaneBitset<LANES>> &visit,
+               vector<LaneBitset<LANES>> &next, BFSFrontier &frontier, MSBFSFrontierList &frontier_list);
+
+} // namespace duckdb
@@ -0,0 +1,270 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/msbfs_engine.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/msbfs.hpp"
+#include "duckpgq/core/utils/traversal_metrics.hpp"
+
+namespace duckdb {
+
+//! When the searches of an MSBFSBatches batch stop
+enum class MSBFSTermination : uint8_t {
+	//! A lane stops once TargetsSeen of the visitor holds for it, the batch once all of its lanes stopped
+	TARGET_HIT,
+	//! The batch stops after max_depth steps
+	DEPTH_BOUND,
+	//! The batch runs until no lane reaches a new vertex
+	EXHAUST,
+	//! All groups share one batch: a lane stops once LaneFinished of the visitor holds for it and is refilled with
+	//! the next group right away. Depths are not tracked.
+	LANE_REFILL
+};
+
+//! The hooks of MSBFSBatches, all of which do nothing. A kernel derives its visitor from it and hides the ones it
+//! needs, so the calls of the others compile away.
+struct MSBFSVisitor {
+	//! With TARGET_HIT, whether the search of [group] in [lane] can stop
+	template <idx_t LANES>
+	bool TargetsSeen(int64_t group, idx_t lane, const vector<LaneBitset<LANES>> &seen) {
+		return false;
+	}
+	//! With LANE_REFILL, whether [group] needs a search before it is given a lane
+	bool StartGroup(int64_t group) {
+		return true;
+	}
+	//! With LANE_REFILL, whether the search of [group] in [lane] can stop after [depth] steps. [change] is false once
+	//! the step reached no new vertex in any lane, the lane stops then either way.
+	template <idx_t LANES>
+	bool LaneFinished(int64_t group, idx_t lane, int64_t depth, bool change, const vector<LaneBitset<LANES>> &seen) {
+		return true;
+	}
+	//! A step reached [vertex] for the first time in [lanes] after [depth] steps
+	template <idx_t LANES>
+	void Reached(const int64_t *lane_to_group, int64_t vertex, const LaneBitset<LANES> &lanes, int64_t depth) {
+	}
+	//! The searches of a batch are done, lane_to_group holds the group of every lane or -1 for the empty ones
+	template <idx_t LANES>
+	void FinishBatch(MSBFSScratchBuffers<LANES> &buffers, const int64_t *lane_to_group) {
+	}
+};
+
+//! The LANE_REFILL mode of MSBFSBatches: the groups start in the first free lane, and a lane whose search finished
+//! is cleared and refilled with the next group before the following step, so the lanes stay busy until the last
+//! groups have been started. Groups whose source is not in [0, v_size) get no lane.
+template <idx_t LANES, class VISITOR>
+void MSBFSRefillLanes(ClientContext &context, CSR &csr, int64_t v_size, MSBFSScratch &scratch,
+                      const MSBFSSourceGroups &groups, VISITOR &visitor, TraversalCounters *counters) {
+	auto &buffers = scratch.Get<LANES>();
+	auto allocated = buffers.Prepare(context, v_size, false);
+	if (counters) {
+		counters->scratch_bytes += allocated;
+	}
+	auto &seen = buffers.seen;
+	auto &visit1 = buffers.visit1;
+	auto &visit2 = buffers.visit2;
+	auto &frontier_list = buffers.frontier_list;
+	auto ranges = csr.GetRanges();
+	vector<int64_t> new_sources;
+
+	// maps lane to group and the iteration its search started in
+	int64_t lane_to_group[LANES];
+	int64_t lane_start[LANES];
+	for (idx_t lane = 0; lane < LANES; lane++) {
+		lane_to_group[lane] = -1; // inactive
+		lane_start[lane] = 0;
+	}
+
+	// starts the search of the next group that needs one in [lane] with its source set in [frontier_vector], returns
+	// false once all groups have been started
+	idx_t started_groups = 0;
+	idx_t active = 0;
+	auto start_search = [&](idx_t lane, vector<LaneBitset<LANES>> &frontier_vector, int64_t iter) {
+		while (started_groups < groups.GroupCount()) {
+			auto group = started_groups++;
+			auto source = groups.sources[group];
+			if (source < 0 || source >= v_size || !visitor.StartGroup(static_cast<int64_t>(group))) {
+				continue;
+			}
+			frontier_vector[source][lane] = true;
+			seen[source][lane] = true;
+			new_sources.push_back(source);
+			lane_to_group[lane] = static_cast<int64_t>(group);
+			lane_start[lane] = iter;
+			active++;
+			return true;
+		}
+		return false;
+	};
+	for (idx_t lane = 0; lane < LANES && start_search(lane, visit1, 0); lane++) {
+	}
+
+	BFSDirectionPolicy policy(v_size, csr.EdgeCount());
+	auto frontier = frontier_list.Initialize(v_size, ranges, new_sources);
+	for (int64_t iter = 1; active; iter++) {
+		LaneBitset<LANES> active_lanes;
+		for (idx_t lane = 0; lane < LANES; lane++) {
+			active_lanes[lane] = lane_to_group[lane] >= 0;
+		}
+		if (counters) {
+			counters->iterations++;
+			counters->active_lanes += active_lanes.count();
+			counters->edges += frontier.edge_count;
+		}
+		auto &visit = (iter & 1) ? visit1 : visit2;
+		auto &next = (iter & 1) ? visit2 : visit1;
+		bool change = MSBFSStep(context, csr, policy, v_size, active_lanes, seen, visit, next, frontier, frontier_list);
+		LaneBitset<LANES> finished;
+		active_lanes.ForEach([&](idx_t lane) {
+			auto depth = iter - lane_start[lane];
+			if (visitor.template LaneFinished<LANES>(lane_to_group[lane], lane, depth, change, seen) || !change) {
+				lane_to_group[lane] = -1;
+				finished[lane] = true;
+				active--;
+			}
+		});
+		if (finished.none() || started_groups == groups.GroupCount()) {
+			continue;
+		}
+		// clear the finished lanes, the sources of their next groups join the frontier the next step starts from
+		if (frontier_list.VisitedAll()) {
+			for (int64_t i = 0; i < v_size; i++) {
+				seen[i].AndNot(finished);
+				next[i].AndNot(finished);
+			}
+		} else {
+			for (auto i : frontier_list.Visited()) {
+				seen[i].AndNot(finished);
+				next[i].AndNot(finished);
+			}
+		}
+		new_sources.clear();
+		finished.ForEach([&](idx_t lane) { start_search(lane, next, iter); });
+		frontier_list.Extend(ranges, new_sources, frontier);
+	}
+}
+
+//! Runs the searches of [groups] in batches of LANES concurrent searches, one lane per group, over the arrays of the
+//! [scratch] of the thread. The shape of the search is fixed at compile time, so a kernel only pays for what it
+//! uses: TRACK_DEPTH records the depth of every reached vertex and lane in the depth array of the buffers and
+//! TERMINATION decides when the searches stop, see MSBFSRefillLanes for LANE_REFILL. The kernel plugs in through the
+//! hooks of [visitor], see MSBFSVisitor. Groups whose source is not in [0, v_size) get no lane. The steps are counted
+//! in [counters] if it is set.
+template <idx_t LANES, MSBFSTermination TERMINATION, bool TRACK_DEPTH, class VISITOR>
+void MSBFSBatches(ClientContext &context, CSR &csr, int64_t v_size, MSBFSScratch &scratch,
+                  const MSBFSSourceGroups &groups, int64_t max_depth, VISITOR &visitor, TraversalCounters *counters) {
+	if (TERMINATION == MSBFSTermination::LANE_REFILL) {
+		MSBFSRefillLanes<LANES>(context, csr, v_size, scratch, groups, visitor, counters);
+		return;
+	}
+	auto &buffers = scratch.Get<LANES>();
+	auto &seen = buffers.seen;
+	auto &visit1 = buffers.visit1;
+	auto &visit2 = buffers.visit2;
+	auto &depth = buffers.depth;
+	auto &frontier_list = buffers.frontier_list;
+	auto ranges = csr.GetRanges();
+	vector<int64_t> sources;
+	int64_t lane_to_group[LANES];
+
+	idx_t started_groups = 0;
+	while (started_groups < groups.GroupCount()) {
+		// only resets the entries the previous batch set
+		auto allocated = buffers.Prepare(context, v_size, TRACK_DEPTH);
+		if (counters) {
+			counters->scratch_bytes += allocated;
+		}
+
+		LaneBitset<LANES> active_lanes;
+		sources.clear();
+		for (idx_t lane = 0; lane < LANES; lane++) {
+			lane_to_group[lane] = -1;
+			if (started_groups < groups.GroupCount()) {
+				auto group = started_groups++;
+				auto source = groups.sources[group];
+				if (source < 0 || source >= v_size) {
+					continue;
+				}
+				visit1[source][lane] = true;
+				// The source is seen at depth 0, so that cycles back to it do not overwrite its depth
+				seen[source][lane] = true;
+				if (TRACK_DEPTH) {
+					depth[source * LANES + lane] = 0;
+				}
+				sources.push_back(source);
+				lane_to_group[lane] = static_cast<int64_t>(group);
+				active_lanes[lane] = true;
+			}
+		}
+
+		if (active_lanes.any()) {
+			BFSDirectionPolicy policy(v_size, csr.EdgeCount());
+			auto frontier = frontier_list.Initialize(v_size, ranges, sources);
+			for (int64_t iter = 1; TERMINATION != MSBFSTermination::DEPTH_BOUND || iter <= max_depth; iter++) {
+				if (TERMINATION == MSBFSTermination::TARGET_HIT) {
+					// finish the lanes that have reached their targets
+					active_lanes.ForEach([&](idx_t lane) {
+						if (visitor.template TargetsSeen<LANES>(lane_to_group[lane], lane, seen)) {
+							active_lanes[lane] = false;
+						}
+					});
+					if (active_lanes.none()) {
+						break;
+					}
+				}
+				if (counters) {
+					counters->iterations++;
+					counters->active_lanes += active_lanes.count();
+					counters->edges += frontier.edge_count;
+				}
+				auto &visit = (iter & 1) ? visit1 : visit2;
+				auto &next = (iter & 1) ? visit2 : visit1;
+				if (!MSBFSStep(context, csr, policy, v_size, active_lanes, seen, visit, next, frontier,
+				               frontier_list)) {
+					break;
+				}
+				// the vertices reached by this step form the new frontier
+				for (auto n : frontier_list.Current()) {
+					if (TRACK_DEPTH) {
+						auto *vertex_depth = &depth[n * LANES];
+						next[n].ForEach([&](idx_t lane) { vertex_depth[lane] = static_cast<uint32_t>(iter); });
+					}
+					visitor.template Reached<LANES>(lane_to_group, n, next[n], iter);
+				}
+			}
+		}
+		visitor.template FinishBatch<LANES>(buffers, lane_to_group);
+	}
+}
+
+//! Runs MSBFSBatches with batches as wide as the number of groups needs
+template <MSBFSTermination TERMINATION, bool TRACK_DEPTH, class VISITOR>
+void RunMSBFSBatches(ClientContext &context, CSR &csr, int64_t v_size, MSBFSScratch &scratch,
+                     const MSBFSSourceGroups &groups, int64_t max_depth, VISITOR &visitor,
+                     TraversalCounters *counters = nullptr) {
+	switch (SelectLaneCount(groups.GroupCount())) {
+	case 64:
+		MSBFSBatches<64, TERMINATION, TRACK_DEPTH>(context, csr, v_size, scratch, groups, max_depth, visitor,
+		                                           counters);
+		break;
+	case 128:
+		MSBFSBatches<128, TERMINATION, TRACK_DEPTH>(context, csr, v_size, scratch, groups, max_depth, visitor,
+		                                            counters);
+		break;
+	case 256:
+		MSBFSBatches<256, TERMINATION, TRACK_DEPTH>(context, csr, v_size, scratch, groups, max_depth, visitor,
+		                                            counters);
+		break;
+	default:
+		MSBFSBatches<LANE_LIMIT, TERMINATION, TRACK_DEPTH>(context, csr, v_size, scratch, groups, max_depth, visitor,
+		                                                   counters);
+		break;
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/partitioned_csr.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckdb/storage/buffer/buffer_handle.hpp"
+
+#include <atomic>
+
+namespace duckdb {
+
+class BlockHandle;
+class BufferManager;
+
+//! The vertices [vertex_begin, vertex_end) of a partitioned CSR, whose adjacency lists are the edges
+//! [edge_begin, edge_end). Their neighbors and edge ids are stored back to back in one block of the BufferManager.
+struct CSRPartition {
+	idx_t vertex_begin = 0;
+	idx_t vertex_end = 0;
+	int64_t edge_begin = 0;
+	int64_t edge_end = 0;
+	//! nullptr if the partition has no edges
+	shared_ptr<BlockHandle> block;
+
+	idx_t EdgeCount() const {
+		return static_cast<idx_t>(edge_end - edge_begin);
+	}
+};
+
+//! A pinned CSRPartition, its block stays in memory as long as the handle lives. Offsets are CSR offsets, as stored
+//! in v.
+class CSRPartitionHandle {
+public:
+	CSRPartitionHandle(BufferHandle handle, const CSRPartition &partition);
+
+	int64_t Neighbor(int64_t offset) const {
+		return neighbors[offset - edge_begin];
+	}
+	int64_t EdgeId(int64_t offset) const {
+		return edge_ids[offset - edge_begin];
+	}
+	void SetEdge(int64_t offset, int64_t neighbor, int64_t edge_id) {
+		neighbors[offset - edge_begin] = neighbor;
+		edge_ids[offset - edge_begin] = edge_id;
+	}
+
+private:
+	BufferHandle handle;
+	int64_t edge_begin;
+	int64_t *neighbors = nullptr;
+	int64_t *edge_ids = nullptr;
+};
+
+//! The neighbor and edge id arrays of an out-of-core CSR, split into vertex ranges of about [edges_per_partition]
+//! edges that are stored as DuckDB blocks. The BufferManager writes unpinned blocks to the temporary directory when
+//! memory runs short, so the edges of the CSR may exceed memory_limit, while v and the per-vertex state of the
+//! kernels stay in memory. A vertex with more edges than [edges_per_partition] gets a partition of its own.
+class CSRPartitions {
+public:
+	//! [starts][i] is the offset of the adjacency list of vertex i, [starts][vertex_count] the number of edges
+	CSRPartitions(ClientContext &context, const std::atomic<int64_t> *starts, idx_t vertex_count,
+	              idx_t edges_per_partition);
+
+	idx_t Count() const {
+		return partitions.size();
+	}
+	const CSRPartition &Get(idx_t partition) const {
+		return partitions[partition];
+	}
+	idx_t EdgeCount() const {
+		return edge_count;
+	}
+	//! Index of the partition that holds the adjacency list of [vertex]
+	idx_t PartitionOf(int64_t vertex) const;
+	//! Loads [partition] into memory if it was spilled. Thread-safe.
+	CSRPartitionHandle Pin(idx_t partition) const;
+	//! Size of all blocks, which the BufferManager accounts for itself
+	idx_t GetMemoryUsage() const {
+		return edge_count * 2 * sizeof(int64_t);
+	}
+
+private:
+	BufferManager &buffer_manager;
+	vector<CSRPartition> partitions;
+	idx_t edge_count = 0;
+};
+
+} // namespace duckdb
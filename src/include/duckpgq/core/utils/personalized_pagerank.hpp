@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/personalized_pagerank.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+
+namespace duckdb {
+
+//! Approximate personalized PageRank from a single seed by forward push (Andersen, Chung and Lang). A vertex is
+//! pushed while its residual exceeds tolerance times its out-degree, so the work is bounded by
+//! 1 / (tolerance * (1 - damping)) independently of the size of the graph. The rank of dangling vertices returns to
+//! the seed. A push keeps its arrays between calls and only resets the entries the previous seed touched, so one
+//! instance can run the pushes of many seeds.
+class PersonalizedPageRankPush {
+public:
+	PersonalizedPageRankPush(CSR &csr, double damping, double tolerance);
+
+	void Run(int64_t seed);
+	//! [result] receives the [k] vertices with the highest estimates, ordered by estimate and then by vertex
+	void TopK(idx_t k, vector<std::pair<int64_t, double>> &result) const;
+
+private:
+	template <class ID_T>
+	void RunInternal(int64_t seed);
+	void AddResidual(int64_t vertex, double value);
+	int64_t Degree(int64_t vertex) const {
+		return v[vertex + 1] - v[vertex];
+	}
+
+	CSR &csr;
+	const int64_t *v;
+	double damping;
+	double tolerance;
+	vector<double> estimate;
+	vector<double> residual;
+	vector<uint8_t> queued;
+	//! Vertices whose residual was set, reset by the next push
+	vector<int64_t> touched;
+	vector<int64_t> queue;
+};
+
+} // namespace duckdb
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/property_graph_metadata.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckdb/common/case_insensitive_map.hpp"
+#include "duckdb/main/materialized_query_result.hpp"
+#include "duckdb/parser/parsed_data/create_property_graph_info.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
+namespace duckdb {
+
+//! The property graphs of a database, read from __duckpgq_internal once by the first connection that uses DuckPGQ
+//! and shared by all of its connections. The rows of a graph are only parsed once the graph is first used. Every
+//! change increments the version, after which the connections copy the graphs they use again.
+class PropertyGraphMetadata : public ObjectCacheEntry {
+public:
+	static shared_ptr<PropertyGraphMetadata> Get(ClientContext &context);
+	static string ObjectType() {
+		return "duckpgq_property_graph_metadata";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+	//! The graphs are small and must not be evicted
+	optional_idx GetEstimatedCacheMemory() const {
+		return optional_idx();
+	}
+
+	//! Creates __duckpgq_internal and reads its rows, unless a connection of the database did already
+	void EnsureLoaded(ClientContext &context);
+	//! A copy of the property graph [pg_name], or nullptr if there is none
+	unique_ptr<CreateInfo> CopyPropertyGraph(const string &pg_name);
+	//! Adds [info], replacing a property graph of the same name
+	void RegisterPropertyGraph(unique_ptr<CreateInfo> info);
+	void DropPropertyGraph(const string &pg_name);
+	//! Whether [table_name] is a vertex or edge table of a property graph that was used, the graphs that were not
+	//! used yet have no CSRs
+	bool UsesTable(const string &table_name);
+	idx_t Version() const {
+		return version;
+	}
+
+private:
+	//! Parses the rows of [pg_name] into property_graphs, called with lock held
+	void ParsePropertyGraph(const string &pg_name, const vector<idx_t> &rows);
+	void ParseEdgeSpecificFields(idx_t row, PropertyGraphTable &table);
+	static void ExtractListValues(const Value &list_value, vector<string> &output);
+	void RegisterPropertyGraphTable(const shared_ptr<PropertyGraphTable> &table, const string &graph_name,
+	                                bool is_vertex);
+
+	mutex lock;
+	bool loaded = false;
+	case_insensitive_map_t<unique_ptr<CreateInfo>> property_graphs;
+	//! The rows of __duckpgq_internal, kept until the graphs in unparsed_rows are all parsed
+	unique_ptr<MaterializedQueryResult> internal_rows;
+	//! The rows of each graph that was not used yet, vertex tables first
+	case_insensitive_map_t<vector<idx_t>> unparsed_rows;
+	atomic<idx_t> version {0};
+};
+
+} // namespace duckdb
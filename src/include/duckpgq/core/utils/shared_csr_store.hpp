@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/shared_csr_store.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
+#include <condition_variable>
+#include <memory>
+
+namespace duckdb {
+
+//! A CSR in the SharedCSRStore. The CSR is complete and never changes while it is in the store.
+struct SharedCSREntry {
+	string pg_name;
+	string edge_label;
+	bool directed = true;
+	string weight_column;
+	shared_ptr<CSR> csr;
+	//! Logical timestamp of the last lookup, used to evict the least recently used entry
+	atomic<idx_t> last_used {0};
+	atomic<idx_t> hits {0};
+};
+
+//! A CSR to build in the background, see SharedCSRStore::SchedulePrebuild
+struct CSRPrebuildRequest {
+	string pg_name;
+	string edge_label;
+	bool directed;
+};
+
+//! A scheduled prebuild task, shared by the task and the connection that scheduled it
+struct CSRPrebuildTaskState {
+	enum class Status : uint8_t { QUEUED, RUNNING, FINISHED };
+
+	//! Moves a queued task to RUNNING, returns false if the connection withdrew it
+	bool Start();
+	void Finish();
+	bool IsQueued();
+	//! Withdraws the task if it did not start yet, or else waits until it finished
+	void WithdrawOrWait();
+
+	mutex lock;
+	std::condition_variable finished;
+	Status status = Status::QUEUED;
+};
+
+//! The prebuild tasks that a connection scheduled on the TaskScheduler. A task builds on its own connection to the
+//! database, which the scheduling connection keeps alive: when it closes, it withdraws the tasks that did not start
+//! yet and waits for the running one, so a task never holds the last reference to the database.
+class CSRPrebuildTasks {
+public:
+	~CSRPrebuildTasks();
+
+private:
+	friend class SharedCSRStore;
+	unique_ptr<ProducerToken> producer;
+	vector<shared_ptr<CSRPrebuildTaskState>> tasks;
+};
+
+//! The CSRs cached for all connections of a database, enabled with duckpgq_shared_csr_cache. The entries are
+//! published as an immutable map that writers copy and swap, so a lookup only loads the current map and never
+//! blocks on a writer or on another reader. A map that is replaced stays alive for as long as a reader holds it.
+class SharedCSRStore : public ObjectCacheEntry {
+public:
+	using EntryMap = unordered_map<string, shared_ptr<SharedCSREntry>>;
+
+	static shared_ptr<SharedCSRStore> Get(ClientContext &context);
+	static string ObjectType() {
+		return "duckpgq_shared_csr_store";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+	//! The CSRs account for their memory through their MemoryReservation
+	optional_idx GetEstimatedCacheMemory() const {
+		return optional_idx();
+	}
+
+	//! The CSR cached under [key], a key of DuckPGQState::GetCSRCacheKey, or nullptr if there is none
+	shared_ptr<CSR> Lookup(const string &key);
+	//! Adds [entry] under [key] and drops the least recently used entries that no query uses beyond [capacity]. The
+	//! entry is dropped instead if the store was cleared since [built_generation], its CSR may miss the committed
+	//! writes.
+	void Publish(const string &key, shared_ptr<SharedCSREntry> entry, idx_t capacity, idx_t built_generation);
+	//! Drops all entries, called when a transaction that wrote commits
+	void Clear();
+	//! Incremented by every Clear, read when a transaction starts that may build a CSR for the store
+	idx_t Generation() const {
+		return generation;
+	}
+	//! Drops the least recently used entry that no query uses, returns false if there is none
+	bool EvictLeastRecentlyUsed();
+	//! The current entries, for listing them
+	std::shared_ptr<const EntryMap> Entries() const;
+
+	//! Whether duckpgq_csr_prebuild is set, which also enables the store
+	static bool IsPrebuildEnabled(ClientContext &context);
+	//! Queues the CSRs of [requests] to be built into the store of the database of [context] by a task on the
+	//! TaskScheduler, which is added to [tasks] unless a task of [tasks] that did not start yet picks them up. Called
+	//! once the writes are committed, the task reads a snapshot that holds them. Queries keep building a CSR
+	//! themselves until its prebuild is published.
+	static void SchedulePrebuild(ClientContext &context, const vector<CSRPrebuildRequest> &requests,
+	                             CSRPrebuildTasks &tasks);
+	//! Builds the queued CSRs on a connection to [db] until the queue is empty
+	void RunPrebuilds(DatabaseInstance &db);
+
+private:
+	//! A copy of the current map for a writer to modify, called with write_lock held
+	EntryMap CopyEntries() const;
+	//! Publishes [new_entries] as the current map, called with write_lock held
+	void Swap(EntryMap new_entries);
+	//! A std::shared_ptr, which can be loaded and stored atomically
+	std::shared_ptr<const EntryMap> entries = std::make_shared<EntryMap>();
+	//! Serializes the writers, readers never take it
+	mutex write_lock;
+	atomic<idx_t> clock {0};
+	atomic<idx_t> generation {0};
+
+	//! Guards the prebuild queue, a task takes all requests queued when it starts
+	mutex prebuild_lock;
+	vector<CSRPrebuildRequest> prebuild_queue;
+};
+
+} // namespace duckdb
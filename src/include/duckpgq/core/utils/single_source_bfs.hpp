@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/single_source_bfs.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+//! The FILTER of a SingleSourceBFS without an edge predicate, every edge passes and the test compiles away
+struct NoEdgeFilter {
+	bool Allows(int64_t offset, int64_t edge_id) const {
+		return true;
+	}
+};
+
+//! Breadth-first search from one source over the outgoing edges of a CSR, which answers a path-finding pattern whose
+//! targets are not bound for all targets at once. The arrays are kept across the searches of a chunk and only the
+//! vertices the previous search reached are reset. Only the edges whose offset and edge id the Allows of [filter]
+//! passes are followed, a search without an edge predicate is instantiated with NoEdgeFilter. [filter] has to outlive
+//! the search. With TRACK_PATHS the parent of every vertex is recorded for AppendPath, otherwise the inner loop does
+//! not touch the parent arrays.
+template <class ID_T, class FILTER, bool TRACK_PATHS>
+class SingleSourceBFS {
+public:
+	static constexpr int64_t UNREACHED = -1;
+
+	SingleSourceBFS(CSR &csr, idx_t vertex_count, const FILTER &filter)
+	    : ranges(csr.GetRanges()), e(csr.GetNeighbors<ID_T>()), edge_ids(csr.edge_ids), filter(filter),
+	      depth(vertex_count, UNREACHED) {
+		if (TRACK_PATHS) {
+			parent.resize(vertex_count);
+			parent_edge.resize(vertex_count);
+		}
+	}
+
+	//! Reaches the vertices at most [upper] hops from [source], in the order of their distance
+	void Run(int64_t source, int64_t upper) {
+		for (auto vertex : reached) {
+			depth[vertex] = UNREACHED;
+		}
+		reached.clear();
+		depth[source] = 0;
+		reached.push_back(source);
+		for (idx_t head = 0; head < reached.size(); head++) {
+			auto vertex = reached[head];
+			if (depth[vertex] >= upper) {
+				// The vertices after this one are not closer to the source
+				break;
+			}
+			for (auto offset = ranges.begin[vertex]; offset < ranges.end[vertex]; offset++) {
+				auto neighbor = static_cast<int64_t>(e[offset]);
+				if (depth[neighbor] != UNREACHED || !filter.Allows(offset, edge_ids[offset])) {
+					continue;
+				}
+				depth[neighbor] = depth[vertex] + 1;
+				if (TRACK_PATHS) {
+					parent[neighbor] = vertex;
+					parent_edge[neighbor] = edge_ids[offset];
+				}
+				reached.push_back(neighbor);
+			}
+		}
+	}
+
+	const vector<int64_t> &Reached() const {
+		return reached;
+	}
+	int64_t Depth(int64_t vertex) const {
+		return depth[vertex];
+	}
+	//! Appends the alternating vertex and edge ids of the path from the source of the last search to [target] to
+	//! [path]. Requires TRACK_PATHS.
+	void AppendPath(int64_t target, vector<int64_t> &path) const {
+		auto begin = path.size();
+		auto vertex = target;
+		path.push_back(vertex);
+		while (depth[vertex] > 0) {
+			path.push_back(parent_edge[vertex]);
+			vertex = parent[vertex];
+			path.push_back(vertex);
+		}
+		std::reverse(path.begin() + static_cast<std::ptrdiff_t>(begin), path.end());
+	}
+
+private:
+	CSRRanges ranges;
+	const vector<ID_T> &e;
+	const vector<int64_t> &edge_ids;
+	const FILTER &filter;
+	vector<int64_t> depth;
+	vector<int64_t> parent;
+	vector<int64_t> parent_edge;
+	vector<int64_t> reached;
+};
+
+} // namespace duckdb
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/traversal_metrics.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
+#include <chrono>
+
+namespace duckdb {
+
+//! The kernels whose work is counted in the TraversalMetrics
+enum class TraversalKernel : uint8_t { CSR_BUILD, ITERATIVE_LENGTH, SHORTEST_PATH, CHEAPEST_PATH_LENGTH, PAGERANK };
+
+static constexpr idx_t TRAVERSAL_KERNEL_COUNT = 5;
+
+//! The work of one call of a kernel, counted in plain integers while it runs
+struct TraversalCounters {
+	//! Chunks a scalar kernel was called for, or CSRs built
+	idx_t calls = 0;
+	//! BFS steps, Bellman-Ford rounds or PageRank iterations
+	idx_t iterations = 0;
+	//! Adjacency entries scanned: the out-degrees of the BFS frontiers, the edges relaxed or the edges of the CSR per
+	//! PageRank iteration. For CSR_BUILD the edges inserted.
+	idx_t edges = 0;
+	//! The active lanes summed over all BFS steps, divided by the steps it is the average number of busy lanes
+	idx_t active_lanes = 0;
+	//! Bytes of scratch arrays allocated, arrays reused from an earlier chunk are not counted again
+	idx_t scratch_bytes = 0;
+	idx_t microseconds = 0;
+};
+
+//! The counters of the traversal kernels, summed over all queries of the database since it was opened. The kernels
+//! count into a TraversalMetricsScope and add it here once per call, so the atomics are not touched in the inner
+//! loops. Read by duckpgq_metrics().
+class TraversalMetrics : public ObjectCacheEntry {
+public:
+	static shared_ptr<TraversalMetrics> Get(ClientContext &context);
+	static string ObjectType() {
+		return "duckpgq_traversal_metrics";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+	optional_idx GetEstimatedCacheMemory() const {
+		return optional_idx();
+	}
+	//! The name duckpgq_metrics() lists [kernel] under
+	static string KernelName(TraversalKernel kernel);
+
+	void Add(TraversalKernel kernel, const TraversalCounters &counters);
+	TraversalCounters Read(TraversalKernel kernel) const;
+
+private:
+	struct KernelCounters {
+		atomic<idx_t> calls {0};
+		atomic<idx_t> iterations {0};
+		atomic<idx_t> edges {0};
+		atomic<idx_t> active_lanes {0};
+		atomic<idx_t> scratch_bytes {0};
+		atomic<idx_t> microseconds {0};
+	};
+	KernelCounters kernels[TRAVERSAL_KERNEL_COUNT];
+};
+
+//! Counts one call of [kernel] and its time, and adds the counters to [metrics] when it goes out of scope
+class TraversalMetricsScope {
+public:
+	TraversalMetricsScope(TraversalMetrics &metrics, TraversalKernel kernel);
+	~TraversalMetricsScope();
+
+	TraversalCounters counters;
+
+private:
+	TraversalMetrics &metrics;
+	TraversalKernel kernel;
+	std::chrono::steady_clock::time_point start;
+};
+
+} // namespace duckdb
@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//                         DuckPGQ
+//
+// duckpgq/core/utils/weighted_path.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+#include "duckpgq/common.hpp"
+#include "duckpgq/core/utils/compressed_sparse_row.hpp"
+#include "duckpgq/core/utils/msbfs.hpp"
+
+#include <functional>
+#include <limits>
+
+namespace duckdb {
+
+//! Monotone priority queue of vertices with unsigned integer keys (Ahuja et al.). Every pushed key must be at least
+//! the key that was popped last. Vertices are indexed, so that pushing a queued vertex again lowers its key in place.
+class RadixHeap {
+public:
+	explicit RadixHeap(idx_t vertex_count);
+
+	bool Empty() const {
+		return size == 0;
+	}
+	//! Queues [vertex] with [key], or lowers its key if it is already queued with a larger one
+	void Push(int64_t vertex, uint64_t key);
+	//! Removes and returns a vertex with the smallest key
+	int64_t Pop();
+	//! Removes all queued vertices, in time proportional to their number
+	void Clear();
+
+private:
+	//! Bucket 0 holds the keys equal to last, bucket i the keys that differ from it first in bit i - 1
+	static constexpr idx_t BUCKET_COUNT = 65;
+
+	idx_t BucketOf(uint64_t key) const;
+	void Insert(int64_t vertex, uint64_t key);
+	void Remove(int64_t vertex);
+
+	vector<vector<int64_t>> buckets;
+	vector<uint64_t> keys;
+	//! Index of every queued vertex in its bucket, DConstants::INVALID_INDEX if it is not queued
+	vector<idx_t> positions;
+	vector<uint8_t> bucket_of;
+	vector<int64_t> redistribute;
+	uint64_t last = 0;
+	idx_t size = 0;
+};
+
+//! Graphs with fewer vertices than this are searched with Dijkstra only
+static constexpr idx_t DELTA_STEPPING_MIN_VERTICES = 65536;
+//! Delta-stepping relaxes buckets with at least this many vertices on the TaskScheduler threads
+static constexpr idx_t DELTA_STEPPING_PARALLEL_MIN_FRONTIER = 4096;
+
+//! Single-source shortest paths over a CSR with non-negative weights of type T (int32_t, int64_t or double). A search
+//! keeps its distance array between calls and only resets the entries the previous search touched, so one instance
+//! can run the searches of many sources. Searches stop as soon as the distances of all their targets are final. With
+//! [track_paths] every vertex also keeps the CSR offset of the edge it was last reached over, from which the paths
+//! are walked back. int32_t is used for the narrow weights of CSR::GetNarrowWeights, whose distances fit as well.
+template <class T>
+class WeightedPathSearch {
+public:
+	static constexpr T UNREACHED = std::numeric_limits<T>::max();
+
+	WeightedPathSearch(CSR &csr, const vector<T> &weights, const CSRWeightStatistics &statistics,
+	                   bool track_paths = false);
+	//! Bytes of the per-vertex arrays of a search over [vertex_count] vertices, reserve them before the searches run
+	static idx_t MemoryUsage(idx_t vertex_count, bool track_paths, bool delta_stepping);
+
+	//! Dijkstra's algorithm on a radix heap, work-efficient and sequential
+	void Dijkstra(int64_t source, const vector<int64_t> &targets);
+	//! Delta-stepping (Meyer and Sanders), settles the vertices in buckets of width delta. The relaxations of a large
+	//! bucket are split across the TaskScheduler threads and give the same distances as Dijkstra.
+	void DeltaStepping(ClientContext &context, int64_t source, const vector<int64_t> &targets);
+
+	T Distance(int64_t vertex) const {
+		return distance[vertex];
+	}
+	//! [path] receives the alternating vertex and edge rowids of the cheapest path from the source of the last search
+	//! to [target]. Requires track_paths, returns false if [target] is unreachable.
+	bool GetPath(int64_t target, vector<int64_t> &path) const;
+
+private:
+	struct Request {
+		int64_t vertex;
+		T distance;
+		int64_t edge;
+	};
+
+	template <class ID_T>
+	void DijkstraInternal();
+	template <class ID_T>
+	void DeltaSteppingInternal(ClientContext &context);
+	template <class ID_T>
+	void Relax(ClientContext &context, const vector<int64_t> &vertices, bool light);
+	void Reset();
+	void MarkTargets(const vector<int64_t> &targets);
+	idx_t BucketOf(T value) const {
+		return static_cast<idx_t>(value / delta);
+	}
+	void Enqueue(int64_t vertex);
+	void Improve(int64_t vertex, T new_distance, int64_t edge) {
+		distance[vertex] = new_distance;
+		if (track_paths) {
+			parent_edge[vertex] = edge;
+		}
+	}
+
+	CSR &csr;
+	const vector<T> &weights;
+	const int64_t *v;
+	idx_t vertex_count;
+	//! Bucket width of delta-stepping, edges up to delta are light
+	T delta;
+	//! Number of buckets that can hold tentative distances at the same time
+	idx_t bucket_span;
+
+	bool track_paths;
+	int64_t source = -1;
+	vector<T> distance;
+	vector<int64_t> parent_edge;
+	//! Vertices whose distance was set, reset by the next search unless reset_all is set
+	vector<int64_t> touched;
+	bool reset_all = false;
+	vector<uint8_t> is_target;
+	vector<int64_t> targets;
+	idx_t remaining_targets = 0;
+	unique_ptr<RadixHeap> heap;
+
+	// Delta-stepping state
+	vector<vector<int64_t>> buckets;
+	idx_t queued = 0;
+	vector<uint8_t> settled;
+	vector<idx_t> round_of;
+	idx_t round = 0;
+	//! requests[c][p] holds the relaxations found by chunk c for the vertices of partition p
+	vector<vector<vector<Request>>> requests;
+	vector<vector<int64_t>> improved;
+};
+
+//! Finds the cheapest paths of all rows of [groups], whose targets are in [target_data]. Chunks with at least as
+//! many distinct sources as there are threads spread one Dijkstra per source across the threads, otherwise every
+//! search on a large graph runs delta-stepping. [row_done] is called for every row with a valid target once the
+//! search of its source is done, concurrently for different rows. Instantiated for int32_t, int64_t and double.
+template <class T>
+void WeightedPathSearchGroups(ClientContext &context, CSR &csr, const vector<T> &weights, bool track_paths,
+                              const MSBFSSourceGroups &groups, const UnifiedVectorFormat &vdata_target,
+                              const int64_t *target_data,
+                              const std::function<void(const WeightedPathSearch<T> &search, idx_t row,
+                                                       int64_t target)> &row_done);
+
+} // namespace duckdb
@@ -5,10 +5,61 @@
 #include <duckpgq_state.hpp>
 
 namespace duckdb {
-// class DuckpgqExtensionCallback : public ExtensionCallback {
-//   void OnConnectionOpened(ClientContext &context) override {
-//     context.registered_state->Insert(
-//         "duckpgq", make_shared_ptr<DuckPGQState>(context.shared_from_this()));
-//   }
-// };
+
+//! Registered on every connection, also on those that never run a DuckPGQ query, so that each committed write to a
+//! table of a property graph invalidates the CSRs cached by the DuckPGQState of all connections. It also tells which
+//! snapshot the running transaction of the connection reads, a cached CSR is only used by transactions that read the
+//! snapshot it was built from.
+class DuckPGQCommitState : public ClientContextState {
+public:
+	void TransactionBegin(MetaTransaction &transaction, ClientContext &context) override;
+	void TransactionCommit(MetaTransaction &transaction, ClientContext &context) override;
+	//! Invalidates the cached CSRs again once the transaction that wrote committed, see TransactionCommit
+	void QueryEnd(ClientContext &context) override;
+	//! Record the tables the statement writes to
+	RebindQueryInfo OnFinalizePrepare(ClientContext &context, PreparedStatementData &prepared_statement,
+	                                  PreparedStatementMode mode) override;
+	RebindQueryInfo OnExecutePrepared(ClientContext &context, PreparedStatementCallbackInfo &info,
+	                                  RebindQueryInfo current_rebind) override;
+
+	//! Whether no write committed since the running transaction started, so that its snapshot holds all committed
+	//! writes
+	bool SnapshotIsCurrent() const {
+		return transaction_epoch == commit_epoch;
+	}
+
+	//! Incremented by every transaction of the database that commits a write, before the cached CSRs are dropped
+	atomic<idx_t> commit_epoch {0};
+	//! The commit_epoch when the running transaction started, read before the transaction takes its snapshot on
+	//! the first access of a table. INVALID_INDEX if the state was registered after the transaction started.
+	idx_t transaction_epoch = DConstants::INVALID_INDEX;
+	//! The SharedCSRStore::Generation when the running transaction started, 0 if the store did not exist yet
+	idx_t transaction_shared_generation = 0;
+
+private:
+	//! Adds the table that [prepared] writes to to written_tables, or sets writes_unknown_tables
+	void RecordWrittenTable(PreparedStatementData &prepared);
+	//! Whether the running transaction wrote to a table of a property graph, or possibly did
+	bool WritesPropertyGraphTables(ClientContext &context) const;
+
+	//! The tables the running transaction inserted into, updated or deleted from
+	case_insensitive_set_t written_tables;
+	//! Set once the running transaction ran any other statement that writes, e.g. DDL or COPY
+	bool writes_unknown_tables = false;
+	//! Set by TransactionCommit, the cached CSRs are invalidated again at the end of the query
+	bool invalidate_on_query_end = false;
+	//! The shared CSRs that TransactionCommit dropped, prebuilt at the end of the query
+	vector<CSRPrebuildRequest> prebuild_requests;
+
+public:
+	//! The prebuild tasks that the connection scheduled, waited for when it closes
+	CSRPrebuildTasks prebuild_tasks;
+};
+
+class DuckpgqExtensionCallback : public ExtensionCallback {
+	void OnConnectionOpened(ClientContext &context) override {
+		context.registered_state->GetOrCreate<DuckPGQCommitState>("duckpgq_commit");
+	}
+};
+
 } // namespace duckdb
@@ -2,11 +2,64 @@
 
 #include "duckpgq/common.hpp"
 #include "duckdb/common/case_insensitive_map.hpp"
+#include "duckdb/parser/tableref.hpp"
 
 #include <duckpgq/core/utils/compressed_sparse_row.hpp>
+#include <duckpgq/core/utils/property_graph_metadata.hpp>
+#include <duckpgq/core/utils/shared_csr_store.hpp>
 
 namespace duckdb {
 
+class DuckPGQCommitState;
+
+//! A CSR that is kept alive across queries, identified by the property graph and edge table it was built from
+struct CSRCacheEntry {
+	string pg_name;
+	string edge_label;
+	bool directed = true;
+	string weight_column;
+	shared_ptr<CSR> csr;
+	//! Logical timestamp of the last lookup, used to evict the least recently used entry
+	idx_t last_used = 0;
+	idx_t hits = 0;
+	//! Materialized through PRAGMA materialize_csr, exempt from eviction
+	bool pinned = false;
+	//! Kept across writes and refreshed through a CSRDelta, set for directed unweighted CSRs with
+	//! duckpgq_incremental_csr enabled
+	bool incremental = false;
+	//! The tables changed since the CSR was last brought up to date, it is refreshed before its next use
+	bool stale = false;
+	//! Published to the SharedCSRStore at the end of the query instead of the cache of the connection
+	bool shared = false;
+	//! The SharedCSRStore::Generation when the transaction that built the CSR started, set for a shared entry
+	idx_t shared_generation = 0;
+	//! The DuckPGQCommitState::commit_epoch of the snapshot the CSR was built from or last refreshed to. It is only
+	//! cached while no write committed since, and only used by the transactions that started in the same epoch.
+	idx_t epoch = DConstants::INVALID_INDEX;
+};
+
+//! A lookup of the CSR cache made while a MATCH was rewritten, the rewrite depends on its outcome
+struct MatchCSRLookup {
+	enum class Kind : uint8_t { REFRESH, USE, PROBE };
+	Kind kind;
+	string pg_name;
+	string edge_label;
+	bool directed = true;
+	string weight_column;
+	int32_t csr_id = 0;
+	//! The edge table a REFRESH brought up to date
+	shared_ptr<PropertyGraphTable> edge_table;
+	//! Whether a USE installed the cached CSR or a PROBE found it
+	bool found = false;
+};
+
+//! A rewritten MATCH, reused while its CSR cache lookups have the same outcome
+struct MatchRewriteCacheEntry {
+	unique_ptr<TableRef> rewrite;
+	vector<MatchCSRLookup> lookups;
+	idx_t last_used = 0;
+};
+
 class DuckPGQState : public ClientContextState {
 public:
 	explicit DuckPGQState() {};
@@ -15,25 +68,104 @@ public:
 	void QueryEnd() override;
 	CreatePropertyGraphInfo *GetPropertyGraph(const string &pg_name);
 	CSR *GetCSR(int32_t id);
+	//! Folds the delta of CSR [id] into its arrays, for the kernels that do not read through it. A CSR that is
+	//! still being built has no delta and is left alone.
+	void MergeCSRDelta(ClientContext &context, int32_t id);
 
-	void RetrievePropertyGraphs(const shared_ptr<Connection> &context);
-	void ProcessPropertyGraphs(unique_ptr<MaterializedQueryResult> &property_graphs, bool is_vertex);
-	void PopulateEdgeSpecificFields(unique_ptr<DataChunk> &chunk, idx_t row_idx, PropertyGraphTable &table);
-	static void ExtractListValues(const Value &list_value, vector<string> &output);
-	void RegisterPropertyGraph(const shared_ptr<PropertyGraphTable> &table, const string &graph_name, bool is_vertex);
+	//! The property graph [pg_name], copied from the PropertyGraphMetadata of the database on its first use by the
+	//! connection, or nullptr if there is none
+	CreatePropertyGraphInfo *FindPropertyGraph(const string &pg_name);
+
+	static string GetCSRCacheKey(const string &pg_name, const string &edge_label, bool directed,
+	                             const string &weight_column);
+	//! Installs the cached CSR under [csr_id] if a valid entry exists, returns false otherwise
+	bool UseCachedCSR(ClientContext &context, const string &pg_name, const string &edge_label, bool directed,
+	                  const string &weight_column, int32_t csr_id);
+	//! Marks the CSR built under [csr_id] by the current query to be moved into the cache at the end of the query
+	void CacheCSROnQueryEnd(ClientContext &context, const string &pg_name, const string &edge_label, bool directed,
+	                        const string &weight_column, int32_t csr_id);
+	void InvalidateCSRCache();
+	//! Marks the incremental CSRs as stale and drops all others, called when a transaction that wrote commits
+	void MarkCSRCacheStale();
+	//! Applies the committed changes of the tables of [edge_table] to its cached directed CSR if it is stale. A CSR
+	//! that cannot be refreshed is dropped and rebuilt by the query.
+	void RefreshCachedCSR(ClientContext &context, const string &pg_name,
+	                      const shared_ptr<PropertyGraphTable> &edge_table);
+	//! Drops the least recently used cached CSR that is neither pinned nor used by the running query, called when a
+	//! MemoryReservation does not fit. Returns false if there is none.
+	bool EvictCachedCSR();
+	//! Rebuilds the CSR under [csr_id] in the current query and keeps it in the cache until it is unpinned
+	void PinCSR(ClientContext &context, const string &pg_name, const string &edge_label, bool directed,
+	            const string &weight_column, int32_t csr_id);
+	//! Unpins the CSRs of [edge_label], or of all edge tables of the property graph if [edge_label] is empty
+	void UnpinCSRs(const string &pg_name, const string &edge_label);
+	//! Adds a CSR that was not built by the current query, e.g. loaded from a snapshot, as a pinned entry
+	void AddPinnedCSR(const string &pg_name, const string &edge_label, bool directed, const string &weight_column,
+	                  shared_ptr<CSR> csr);
+	//! Returns the cached CSR, of the connection or of the SharedCSRStore, or nullptr if there is none
+	shared_ptr<CSR> GetCachedCSR(const string &pg_name, const string &edge_label, bool directed,
+	                            const string &weight_column);
+
+	//! UseCachedCSR and GetCachedCSR without recording the lookup for a MATCH rewrite
+	bool InstallCachedCSR(ClientContext &context, const string &pg_name, const string &edge_label, bool directed,
+	                      const string &weight_column, int32_t csr_id);
+	shared_ptr<CSR> FindCachedCSR(const string &pg_name, const string &edge_label, bool directed,
+	                              const string &weight_column);
+
+	//! Starts recording the CSR cache lookups of a MATCH rewrite
+	void BeginMatchRewrite();
+	//! A copy of the rewrite cached under [key] once its CSR cache lookups were replayed with the same outcome, or
+	//! nullptr
+	unique_ptr<TableRef> GetCachedMatchRewrite(ClientContext &context, const string &key);
+	//! Stops recording and caches [rewrite] under [key], unless it builds a CSR. The CSR it builds is only cached
+	//! at the end of the query, so the cached rewrite would build it again.
+	void CacheMatchRewrite(ClientContext &context, const string &key, const TableRef &rewrite);
 
 public:
 	unique_ptr<ParserExtensionParseData> parse_data;
 	unordered_map<int32_t, unique_ptr<ParsedExpression>> transform_expression;
 	int32_t match_index = 0;
 
-	//! Property graphs that are registered
+	//! The property graphs of the database, shared by its connections
+	shared_ptr<PropertyGraphMetadata> property_graph_metadata;
+	//! The commit state of the connection, which identifies the snapshot of its running transaction
+	shared_ptr<DuckPGQCommitState> commit_state;
+	//! The property graphs used by the connection, valid while the metadata has registered_version
 	case_insensitive_map_t<unique_ptr<CreateInfo>> registered_property_graphs;
+	idx_t registered_version = 0;
+	vector<unique_ptr<CreateInfo>> retired_property_graphs;
+
+	//! The MATCH rewrites of the connection, keyed by the pattern, the version of the property graphs and the settings
+	//! the rewrite reads
+	unordered_map<string, MatchRewriteCacheEntry> match_rewrite_cache;
+	idx_t match_rewrite_clock = 0;
+	//! The CSR cache lookups of the MATCH that is being rewritten, nullptr while none is
+	unique_ptr<vector<MatchCSRLookup>> match_csr_lookups;
+	//! A MATCH of the statement depends on the CSR cache, so its prepared statement is rebound for every execution
+	bool match_uses_csr = false;
 
 	//! Used to build the CSR data structures required for path-finding queries
-	std::unordered_map<int32_t, unique_ptr<CSR>> csr_list;
+	std::unordered_map<int32_t, shared_ptr<CSR>> csr_list;
 	std::mutex csr_lock;
 	std::unordered_set<int32_t> csr_to_delete;
+
+	//! CSRs reused across queries, keyed by GetCSRCacheKey
+	unordered_map<string, CSRCacheEntry> csr_cache;
+	//! CSRs built by the current query that are added to the cache once the query finishes
+	unordered_map<int32_t, CSRCacheEntry> csr_cache_pending;
+	//! Maximum number of entries in the cache, read from the duckpgq_csr_cache_size setting
+	idx_t csr_cache_capacity = 0;
+	//! Keys of the pinned CSRs, these survive invalidation and are cached again on the next build
+	unordered_set<string> pinned_csr_keys;
+	idx_t csr_cache_clock = 0;
+	std::mutex csr_cache_lock;
+	//! The CSRs shared by all connections of the database, set once duckpgq_shared_csr_cache was used
+	shared_ptr<SharedCSRStore> shared_csr_store;
+
+	//! Converged PageRank vectors keyed by GetCSRCacheKey, the starting point of pagerank with warm_start. They are
+	//! kept when the graph changes, a few iterations then bring them up to date.
+	unordered_map<string, vector<double_t>> pagerank_cache;
+	std::mutex pagerank_cache_lock;
 };
 
 } // namespace duckdb
@@ -27,3 +27,41 @@ def test_property_graph(duckdb_conn):
     duckdb_conn.execute("-FROM GRAPH_TABLE(t MATCH (f:foo))")
     res = duckdb_conn.fetchall()
     assert res[0][0] == 1
+
+
+def test_csr_arrow_export(duckdb_conn):
+    pa = pytest.importorskip("pyarrow")
+    from pyarrow.cffi import ffi
+
+    duckdb_conn.execute("CREATE TABLE Student(id BIGINT)")
+    duckdb_conn.execute("INSERT INTO Student VALUES (0), (1), (2)")
+    duckdb_conn.execute("CREATE TABLE know(src BIGINT, dst BIGINT)")
+    duckdb_conn.execute("INSERT INTO know VALUES (0, 1), (0, 2), (1, 2)")
+    duckdb_conn.execute("""-CREATE PROPERTY GRAPH pg VERTEX TABLES (Student LABEL person)
+        EDGE TABLES (know SOURCE KEY (src) REFERENCES Student (id)
+                          DESTINATION KEY (dst) REFERENCES Student (id) LABEL knows)""")
+    duckdb_conn.execute("PRAGMA materialize_csr('pg', 'knows')")
+    names = [row[0] for row in duckdb_conn.execute("SELECT name FROM get_csr_arrow('pg', 'knows', true)").fetchall()]
+    assert names[:2] == ['v', 'e']
+
+    # The consumer allocates the structs, get_csr_arrow fills them and hands them over
+    exported = {}
+    for name in ['v', 'e']:
+        c_array = ffi.new("struct ArrowArray*")
+        c_schema = ffi.new("struct ArrowSchema*")
+        array_address = int(ffi.cast("uintptr_t", c_array))
+        schema_address = int(ffi.cast("uintptr_t", c_schema))
+        duckdb_conn.execute(
+            f"SELECT * FROM get_csr_arrow('pg', 'knows', true, '{name}', {array_address}::UBIGINT, "
+            f"{schema_address}::UBIGINT)")
+        # Other queries on the connection do not invalidate the exported structs
+        duckdb_conn.execute("SELECT 42").fetchall()
+        exported[name] = pa.Array._import_from_c(array_address, schema_address)
+
+    assert exported['v'].to_pylist() == [0, 2, 3, 3]
+    assert sorted(exported['e'].to_pylist()) == [1, 2, 2]
+
+    # The imported arrays keep the CSR alive after the database is closed and can still be released
+    duckdb_conn.close()
+    assert exported['v'].to_pylist() == [0, 2, 3, 3]
+    del exported